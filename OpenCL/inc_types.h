@@ -22,6 +22,23 @@
 #define SALT_REPEAT         kernel_param->salt_repeat
 #define PWS_POS             kernel_param->pws_pos
 #define GID_CNT             kernel_param->gid_max
+#elif defined SALT_BATCH
+// one launch covers consecutive salts, each one with its own copy of the salt_batch_pws candidates
+#define BITMAP_MASK         kernel_param->bitmap_mask
+#define BITMAP_SHIFT1       kernel_param->bitmap_shift1
+#define BITMAP_SHIFT2       kernel_param->bitmap_shift2
+#define SALT_POS_HOST       (kernel_param->salt_pos_host + (u32) (gid / kernel_param->salt_batch_pws))
+#define SALT_POS_HOST_BID   (kernel_param->salt_pos_host + (u32) (bid / kernel_param->salt_batch_pws))
+#define LOOP_POS            kernel_param->loop_pos
+#define LOOP_CNT            kernel_param->loop_cnt
+#define IL_CNT              kernel_param->il_cnt
+#define DIGESTS_CNT         salt_bufs[SALT_POS_HOST].digests_cnt
+#define DIGESTS_OFFSET_HOST salt_bufs[SALT_POS_HOST].digests_offset
+#define DIGESTS_OFFSET_HOST_BID salt_bufs[SALT_POS_HOST_BID].digests_offset
+#define COMBS_MODE          kernel_param->combs_mode
+#define SALT_REPEAT         kernel_param->salt_repeat
+#define PWS_POS             kernel_param->pws_pos
+#define GID_CNT             kernel_param->gid_max
 #else
 #define BITMAP_MASK         kernel_param->bitmap_mask
 #define BITMAP_SHIFT1       kernel_param->bitmap_shift1
@@ -2000,6 +2017,7 @@ typedef struct kernel_param
   u32 salt_repeat;          // 34
   u64 pws_pos;              // 35
   u64 gid_max;              // 36
+  u32 salt_batch_pws;       // 37
 
 } kernel_param_t;
 
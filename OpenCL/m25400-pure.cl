@@ -317,6 +317,15 @@ KERNEL_FQ KERNEL_FA void m25400_loop (KERN_ATTR_TMPS_ESALT (pdf14_tmp_t, pdf_t))
 
 KERNEL_FQ KERNEL_FA void m25400_comp (KERN_ATTR_TMPS_ESALT (pdf14_tmp_t, pdf_t))
 {
+  /**
+   * modifier
+   */
+  const u64 gid = get_global_id (0);
+
+  if (gid >= GID_CNT) return;
+
+  const u64 lid = get_local_id (0);
+
   const u32 digest[4] =
   {
     esalt_bufs[DIGESTS_OFFSET_HOST].o_buf[0],
@@ -337,15 +346,6 @@ KERNEL_FQ KERNEL_FA void m25400_comp (KERN_ATTR_TMPS_ESALT (pdf14_tmp_t, pdf_t))
     0x7a695364
   };
 
-  /**
-   * modifier
-   */
-  const u64 gid = get_global_id (0);
-
-  if (gid >= GID_CNT) return;
-
-  const u64 lid = get_local_id (0);
-
 
   #define il_pos 0
 
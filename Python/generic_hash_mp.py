@@ -35,6 +35,12 @@ def extract_esalts(esalts_buf):
 def kernel_loop(ctx,passwords,salt_id,is_selftest):
   return hcmp.handle_queue(ctx,passwords,salt_id,is_selftest)
 
+# Optional, hashcat prefers this one if it exists. The passwords arrive back-to-back in one buffer with their offsets,
+# and the results go back-to-back into a preallocated buffer with their lengths, which saves converting them to and
+# from Python lists. The helper handles this for you, it just needs calc_hash() to return a single str or bytes.
+def kernel_loop_buf(ctx,pws_buf,pws_off,out_buf,out_len,salt_id,is_selftest):
+  hcmp.handle_buf(ctx,pws_buf,pws_off,out_buf,out_len,salt_id,is_selftest)
+
 def init(ctx):
   # Uncomment this line below to dump the hashcat ctx for your salted hash
   # hcshared.dump_hashcat_ctx(ctx, source=__name__)
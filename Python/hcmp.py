@@ -1,7 +1,20 @@
 import importlib
 import multiprocessing
+from array import array
 import hcshared
 
+# Per worker process state, set up once by the pool initializer, so that handle_buf() does not have to send it with every batch
+_worker = {}
+
+def _worker_init(module_name, salts, st_salts):
+    user_module = importlib.import_module(module_name)
+    _worker["calc_hash"] = getattr(user_module, "calc_hash")
+    _worker["salts"] = salts
+    _worker["st_salts"] = st_salts
+
+def _worker_packed(pws, pws_off, salt_id, is_selftest):
+    return hcshared._worker_packed(pws, pws_off, salt_id, is_selftest, _worker["calc_hash"], _worker["salts"], _worker["st_salts"])
+
 def _worker_batch(chunk, salt_id, is_selftest, module_name, salts, st_salts):
     user_module = importlib.import_module(module_name)
     calc_hash = getattr(user_module, "calc_hash")
@@ -24,7 +37,7 @@ def init(ctx: dict, extract_esalts):
     ctx["st_salts"] = st_salts
     ctx["module_name"] = ctx.get("module_name", "__main__")
 
-    ctx["pool"] = multiprocessing.Pool(processes=ctx["parallelism"])
+    ctx["pool"] = multiprocessing.Pool(processes=ctx["parallelism"], initializer=_worker_init, initargs=(ctx["module_name"], salts, st_salts))
     return
 
 def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) -> list:
@@ -50,6 +63,34 @@ def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) ->
         hashes.extend(job.get())
     return hashes
 
+def handle_buf(ctx: dict, pws_buf: memoryview, pws_off: memoryview, out_buf: memoryview, out_len: memoryview, salt_id: int, is_selftest: bool):
+    pool = ctx["pool"]
+    parallelism = ctx["parallelism"]
+
+    pws_cnt = len(pws_off) - 1
+
+    if pws_cnt == 0:
+        return
+
+    # Each chunk travels as one bytes object plus its offsets, and comes back the same way
+    chunk_size = (pws_cnt + parallelism - 1) // parallelism
+
+    jobs = []
+    for start in range(0, pws_cnt, chunk_size):
+        end = min(start + chunk_size, pws_cnt)
+        jobs.append((start, end, pool.apply_async(
+            _worker_packed,
+            args=(bytes(pws_buf[pws_off[start]:pws_off[end]]), array("I", pws_off[start:end + 1]), salt_id, is_selftest)
+        )))
+
+    pos = 0
+    for start, end, job in jobs:
+        hashes, lens = job.get()
+        out_buf[pos:pos + len(hashes)] = hashes
+        out_len[start:end] = lens
+        pos += len(hashes)
+    return
+
 def term(ctx: dict):
     if "pool" in ctx:
         ctx["pool"].close()
@@ -1,5 +1,6 @@
 import struct
 import sys
+from array import array
 from pathlib import Path
 import hcsp
 import pickle
@@ -7,6 +8,9 @@ import pickle
 # Global defs
 script_dir = Path(__file__).resolve().parent
 example_ctx = "example.ctx"
+
+# kernel_loop_buf() results are truncated to this size, see src/bridges/bridge_python_generic_hash_*.c
+OUT_SIZE_MAX = 256
 # Extract a blob that is a list of salt_t entries and convert it to a list of dictionaries
 # The salt_t is a fixed data-type so we can handle it here
 def extract_salts(salts_buf) -> list:
@@ -78,6 +82,25 @@ def _worker_batch(passwords, salt_id, is_selftest, user_fn, salts, st_salts):
             hashes.append("invalid-password")
     return hashes
 
+# Same as _worker_batch(), but for kernel_loop_buf(): the passwords are taken from pws, which holds them
+# back-to-back at the offsets in pws_off (relative to pws_off[0]). The results are returned the same way,
+# as one bytes object and an array of their lengths. A result must be str or bytes, lists are not supported here.
+def _worker_packed(pws, pws_off, salt_id, is_selftest, user_fn, salts, st_salts):
+    salt = st_salts[salt_id] if is_selftest else salts[salt_id]
+    base = pws_off[0]
+    hashes = []
+    for i in range(len(pws_off) - 1):
+        pw = pws[pws_off[i] - base:pws_off[i + 1] - base]
+        try:
+            hash = user_fn(pw, salt)
+            if isinstance(hash, str):
+                hash = hash.encode()
+        except Exception as e:
+            print(e, file=sys.stderr)
+            hash = b"invalid-password"
+        hashes.append(hash[:OUT_SIZE_MAX])
+    return b"".join(hashes), array("I", map(len, hashes))
+
 def dump_hashcat_ctx(ctx, source):
   if source == '__main__':
     exit(f"You are trying to dump hashcat ctx by calling the python script directly. This will not work."
@@ -10,6 +10,19 @@ def handle_queue(ctx: dict, passwords: list, salt_id: int, is_selftest: bool) ->
 
     return hcshared._worker_batch(passwords, salt_id, is_selftest, calc_hash, salts, st_salts)
 
+def handle_buf(ctx: dict, pws_buf: memoryview, pws_off: memoryview, out_buf: memoryview, out_len: memoryview, salt_id: int, is_selftest: bool):
+    user_module = importlib.import_module(ctx["module_name"])
+    calc_hash = getattr(user_module, "calc_hash")
+
+    salts = ctx["salts"]
+    st_salts = ctx["st_salts"]
+
+    hashes, lens = hcshared._worker_packed(bytes(pws_buf), pws_off, salt_id, is_selftest, calc_hash, salts, st_salts)
+
+    out_buf[:len(hashes)] = hashes
+    out_len[:] = lens
+    return
+
 def init(ctx: dict, extract_esalts):
     # Extract and merge salts and esalts
     salts = hcshared.extract_salts(ctx["salts_buf"])
@@ -25,4 +25,7 @@
 
 int set_cpu_affinity (hashcat_ctx_t *hashcat_ctx);
 
+int get_cpu_topology        (int *cpu_ids, int *numa_nodes, const int cnt_max);
+int set_thread_cpu_affinity (const int cpu_id);
+
 #endif // HC_AFFINITY_H
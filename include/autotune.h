@@ -6,6 +6,8 @@
 #ifndef HC_AUTOTUNE_H
 #define HC_AUTOTUNE_H
 
+#define AUTOTUNE_CACHE_FILENAME "hashcat.autotune"
+
 int find_tuning_function (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param);
 
 #if defined (_WIN32) || defined (__WIN32__)
@@ -27,4 +27,6 @@ void  bridges_destroy (hashcat_ctx_t *hashcat_ctx);
 bool  bridges_salt_prepare (hashcat_ctx_t *hashcat_ctx);
 void  bridges_salt_destroy (hashcat_ctx_t *hashcat_ctx);
 
+bool  bridges_mark_hash    (hc_device_param_t *device_param, const hashes_t *hashes, const u32 salt_pos, const u32 digest_pos, const u64 gid);
+
 #endif // HC_BRIDGE_H
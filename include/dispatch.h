@@ -22,6 +22,12 @@
 #endif
 #endif
 
+#define STDIN_BLOCK_SIZE  0x100000
+#define STDIN_PARSERS_MAX 16
+
+int  stdin_pipe_init    (hashcat_ctx_t *hashcat_ctx);
+void stdin_pipe_destroy (hashcat_ctx_t *hashcat_ctx);
+
 #if defined (_WIN32) || defined (__WIN32__)
 HC_API_CALL DWORD thread_calc_stdin (void *p);
 HC_API_CALL DWORD thread_calc (void *p);
@@ -24,4 +24,7 @@ void  hc_free_aligned         (void **ptr);
 void *hcmalloc_bridge_aligned (const size_t sz, const int align);
 void  hcfree_bridge_aligned   (void *ptr);
 
+void *hcmalloc_bridge_huge    (const size_t sz, const int numa_node);
+void  hcfree_bridge_huge      (void *ptr);
+
 #endif // HC_MEMORY_H
@@ -20,6 +20,10 @@
 #define SP_MARKOV_CNT (SP_PW_MAX * CHARSIZ * CHARSIZ)
 #define SP_FILESZ     (sizeof (u64) + sizeof (u64) + (sizeof (u64) * SP_ROOT_CNT) + (sizeof (u64) * SP_MARKOV_CNT))
 
+#define SP_CACHE_VERSION (0x6863737463630000 | 0x0001)
+#define SP_CACHE_HDRSZ   (sizeof (u64) * 4)
+#define SP_CACHE_FILESZ  (SP_CACHE_HDRSZ + (sizeof (hcstat_table_t) * SP_ROOT_CNT) + (sizeof (hcstat_table_t) * SP_MARKOV_CNT))
+
 #define INCR_MASKS    1000
 
 u32   mp_get_length (const char *mask, const u32 opts_type);
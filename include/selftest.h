@@ -6,6 +6,9 @@
 #ifndef HC_SELFTEST_H
 #define HC_SELFTEST_H
 
+#define SELFTEST_CACHE_FILENAME  "hashcat.selftest"
+#define SELFTEST_CACHE_MAX_AGE   (7 * 24 * 60 * 60)
+
 #if defined (_WIN32) || defined (__WIN32__)
 HC_API_CALL DWORD thread_selftest (void *p);
 #else
@@ -77,6 +77,7 @@ double      status_get_hashes_msec_dev_benchmark      (const hashcat_ctx_t *hash
 double      status_get_exec_msec_all                  (const hashcat_ctx_t *hashcat_ctx);
 double      status_get_exec_msec_dev                  (const hashcat_ctx_t *hashcat_ctx, const int backend_devices_idx);
 char       *status_get_speed_sec_all                  (const hashcat_ctx_t *hashcat_ctx);
+double      status_get_tail_idle_msec_all             (const hashcat_ctx_t *hashcat_ctx);
 char       *status_get_speed_sec_dev                  (const hashcat_ctx_t *hashcat_ctx, const int backend_devices_idx);
 int         status_get_cpt_cur_min                    (const hashcat_ctx_t *hashcat_ctx);
 int         status_get_cpt_cur_hour                   (const hashcat_ctx_t *hashcat_ctx);
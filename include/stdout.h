@@ -20,6 +20,16 @@
 #include <pwd.h>
 #endif // _POSIX
 
-int process_stdout (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt);
+#if defined (__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#endif
+
+#define STDOUT_BUFSZ 0x100000
+
+int  process_stdout       (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt);
+void process_stdout_close (hashcat_ctx_t *hashcat_ctx);
 
 #endif // HC_STDOUT_H
@@ -34,6 +34,11 @@
 #define hc_thread_mutex_delete(m)   CloseHandle         (m)
 */
 
+#define hc_thread_cond_init(c)      InitializeConditionVariable (&c)
+#define hc_thread_cond_wait(c,m)    SleepConditionVariableCS    (&c, &m, INFINITE)
+#define hc_thread_cond_broadcast(c) WakeAllConditionVariable    (&c)
+#define hc_thread_cond_delete(c)
+
 #define hc_thread_sem_init(s)       s = CreateSemaphore (NULL, 0, INT_MAX, NULL)
 #define hc_thread_sem_post(s)       ReleaseSemaphore    (s, 1, NULL)
 #define hc_thread_sem_wait(s)       WaitForSingleObject (s, INFINITE)
@@ -51,6 +56,11 @@
 #define hc_thread_mutex_unlock(m)   pthread_mutex_unlock   (&m)
 #define hc_thread_mutex_delete(m)   pthread_mutex_destroy  (&m)
 
+#define hc_thread_cond_init(c)      pthread_cond_init      (&c, NULL)
+#define hc_thread_cond_wait(c,m)    pthread_cond_wait      (&c, &m)
+#define hc_thread_cond_broadcast(c) pthread_cond_broadcast (&c)
+#define hc_thread_cond_delete(c)    pthread_cond_destroy   (&c)
+
 #define hc_thread_sem_init(s)       sem_init  (&s, 0, 0)
 #define hc_thread_sem_post(s)       sem_post  (&s)
 #define hc_thread_sem_wait(s)       sem_wait  (&s)
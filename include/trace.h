@@ -0,0 +1,17 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#ifndef HC_TRACE_H
+#define HC_TRACE_H
+
+#include <stdio.h>
+#include <errno.h>
+
+int    trace_init    (hashcat_ctx_t *hashcat_ctx);
+void   trace_destroy (hashcat_ctx_t *hashcat_ctx);
+double trace_begin   (const hashcat_ctx_t *hashcat_ctx);
+void   trace_end     (hashcat_ctx_t *hashcat_ctx, const hc_device_param_t *device_param, const trace_lane_t lane, const char *name, const double ts_begin);
+
+#endif // HC_TRACE_H
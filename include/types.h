@@ -77,13 +77,15 @@ typedef struct timespec   hc_timer_t;
 #endif
 
 #if defined (_WIN)
-typedef HANDLE           hc_thread_t;
-typedef CRITICAL_SECTION hc_thread_mutex_t;
-typedef HANDLE           hc_thread_semaphore_t;
+typedef HANDLE             hc_thread_t;
+typedef CRITICAL_SECTION   hc_thread_mutex_t;
+typedef CONDITION_VARIABLE hc_thread_cond_t;
+typedef HANDLE             hc_thread_semaphore_t;
 #else
-typedef pthread_t        hc_thread_t;
-typedef pthread_mutex_t  hc_thread_mutex_t;
-typedef sem_t            hc_thread_semaphore_t;
+typedef pthread_t          hc_thread_t;
+typedef pthread_mutex_t    hc_thread_mutex_t;
+typedef pthread_cond_t     hc_thread_cond_t;
+typedef sem_t              hc_thread_semaphore_t;
 #endif
 
 // enums
@@ -518,19 +520,19 @@ typedef enum bridge_type
   BRIDGE_TYPE_MATCH_TUNINGS          = (1ULL <<  1), // Disables autotune and adjusts -n, -u and -T for the backend device according to match bridge dimensions
   BRIDGE_TYPE_UPDATE_SELFTEST        = (1ULL <<  2), // updates the selftest configured in the module. Can be useful for generic hash modes such as the python one
 
-  BRIDGE_TYPE_LAUNCH_INIT            = (1ULL << 10), // attention! not yet implemented
+  BRIDGE_TYPE_LAUNCH_INIT            = (1ULL << 10),
   BRIDGE_TYPE_LAUNCH_LOOP            = (1ULL << 11),
   BRIDGE_TYPE_LAUNCH_LOOP2           = (1ULL << 12),
-  BRIDGE_TYPE_LAUNCH_COMP            = (1ULL << 13), // attention! not yet implemented
+  BRIDGE_TYPE_LAUNCH_COMP            = (1ULL << 13),
 
   // BRIDGE_TYPE_REPLACE_* is like
   // BRIDGE_TYPE_LAUNCH_*, but
   // deactivates KERN_RUN INIT/LOOP/COMP
 
-  BRIDGE_TYPE_REPLACE_INIT           = (1ULL << 20), // attention! not yet implemented
+  BRIDGE_TYPE_REPLACE_INIT           = (1ULL << 20),
   BRIDGE_TYPE_REPLACE_LOOP           = (1ULL << 21),
   BRIDGE_TYPE_REPLACE_LOOP2          = (1ULL << 22),
-  BRIDGE_TYPE_REPLACE_COMP           = (1ULL << 23), // attention! not yet implemented
+  BRIDGE_TYPE_REPLACE_COMP           = (1ULL << 23),
 
   BRIDGE_TYPE_FORCE_WORKITEMS_001    = (1ULL << 30), // This override the workitem counts reported from the bridge device
   BRIDGE_TYPE_FORCE_WORKITEMS_002    = (1ULL << 31), // Can be useful if this is not a physical hardware
@@ -707,6 +709,7 @@ typedef enum user_options_defaults
   ADVICE                   = true,
   ATTACK_MODE              = ATTACK_MODE_STRAIGHT,
   AUTODETECT               = false,
+  AUTOTUNE_REFRESH         = false,
   BACKEND_DEVICES_VIRTMULTI = 1,
   BACKEND_DEVICES_VIRTHOST = 1,
   BACKEND_DEVICES_KEEPFREE = 0,
@@ -714,6 +717,7 @@ typedef enum user_options_defaults
   BENCHMARK_MAX            = 99999,
   BENCHMARK_MIN            = 0,
   BENCHMARK                = false,
+  BINARY_CANDIDATES        = false,
   BITMAP_MAX               = 18,
   BITMAP_MIN               = 16,
   #ifdef WITH_BRAIN
@@ -748,6 +752,7 @@ typedef enum user_options_defaults
   INCREMENT_MAX            = PW_MAX,
   INCREMENT_MIN            = 1,
   KEEP_GUESSING            = false,
+  KERNEL_PRECOMPILE        = false,
   KERNEL_ACCEL             = 0,
   KERNEL_LOOPS             = 0,
   KERNEL_THREADS           = 0,
@@ -762,6 +767,7 @@ typedef enum user_options_defaults
   MARKOV                   = true,
   MARKOV_INVERSE           = false,
   MARKOV_THRESHOLD         = 0,
+  MASK_MERGE               = false,
   METAL_COMPILER_RUNTIME   = 120,
   NONCE_ERROR_CORRECTIONS  = 8,
   BACKEND_IGNORE_CUDA      = false,
@@ -794,6 +800,7 @@ typedef enum user_options_defaults
   SCRYPT_TMTO              = 0,
   SEGMENT_SIZE             = 33554432,
   SELF_TEST                = true,
+  SELF_TEST_REFRESH        = false,
   SHOW                     = false,
   SKIP                     = 0,
   SLOW_CANDIDATES          = false,
@@ -818,6 +825,7 @@ typedef enum user_options_map
 {
   IDX_ADVICE_DISABLE            = 0xff00,
   IDX_ATTACK_MODE               = 'a',
+  IDX_AUTOTUNE_REFRESH          = 0xff8b,
   IDX_BACKEND_DEVICES           = 'd',
   IDX_BACKEND_DEVICES_VIRTMULTI = 'Y',
   IDX_BACKEND_DEVICES_VIRTHOST  = 'R',
@@ -832,6 +840,7 @@ typedef enum user_options_map
   IDX_BENCHMARK_MAX             = 0xff56,
   IDX_BENCHMARK_MIN             = 0xff57,
   IDX_BENCHMARK                 = 'b',
+  IDX_BINARY_CANDIDATES         = 0xff87,
   IDX_BITMAP_MAX                = 0xff07,
   IDX_BITMAP_MIN                = 0xff08,
   #ifdef WITH_BRAIN
@@ -887,8 +896,10 @@ typedef enum user_options_map
   IDX_INDUCTION_DIR             = 0xff23,
   IDX_KEEP_GUESSING             = 0xff24,
   IDX_KERNEL_ACCEL              = 'n',
+  IDX_KERNEL_CACHE_DIR          = 0xff89,
   IDX_KERNEL_LOOPS              = 'u',
   IDX_KERNEL_THREADS            = 'T',
+  IDX_KERNEL_PRECOMPILE         = 0xff8a,
   IDX_KEYBOARD_LAYOUT_MAPPING   = 0xff25,
   IDX_KEYSPACE                  = 0xff26,
   IDX_LEFT                      = 0xff27,
@@ -901,6 +912,7 @@ typedef enum user_options_map
   IDX_MARKOV_HCSTAT2            = 0xff2d,
   IDX_MARKOV_INVERSE            = 0xff2e,
   IDX_MARKOV_THRESHOLD          = 't',
+  IDX_MASK_MERGE                = 0xff86,
   IDX_METAL_COMPILER_RUNTIME    = 0xff2f,
   IDX_NONCE_ERROR_CORRECTIONS   = 0xff30,
   IDX_OPENCL_DEVICE_TYPES       = 'D',
@@ -933,6 +945,7 @@ typedef enum user_options_map
   IDX_SCRYPT_TMTO               = 0xff44,
   IDX_SEGMENT_SIZE              = 'c',
   IDX_SELF_TEST_DISABLE         = 0xff45,
+  IDX_SELF_TEST_REFRESH         = 0xff8c,
   IDX_SEPARATOR                 = 'p',
   IDX_SESSION                   = 0xff46,
   IDX_SHOW                      = 0xff47,
@@ -946,6 +959,7 @@ typedef enum user_options_map
   IDX_STDOUT_FLAG               = 0xff4d,
   IDX_STDIN_TIMEOUT_ABORT       = 0xff4e,
   IDX_TOTAL_CANDIDATES          = 0xff58,
+  IDX_TRACE_FILE                = 0xff88,
   IDX_TRUECRYPT_KEYFILES        = 0xff4f,
   IDX_USERNAME                  = 0xff50,
   IDX_VERACRYPT_KEYFILES        = 0xff51,
@@ -1253,6 +1267,23 @@ typedef struct hc_fp
 
 } HCFILE;
 
+// right-hand wordlist of -a 1 and pure -a 7, processed once (-k rule, encoding, uppercase) and replayed for each salt
+// each entry: u32 count of -k rejected lines in front of it, u16 length, the candidate bytes
+// one read-only image is shared by all devices, each device keeps its own position in it
+
+typedef struct combs_cache
+{
+  char *dictfile;  // the wordlist the image was built from, NULL before the first build
+  bool  disabled;  // larger than COMBS_CACHE_MAX, combs_fp is read again for each salt
+
+  u8   *buf;
+  u64   buf_len;
+  u64   buf_size;
+
+  u64   rejected_tail;
+
+} combs_cache_t;
+
 #include "ext_nvrtc.h"
 #include "ext_hiprtc.h"
 
@@ -1421,6 +1452,7 @@ typedef struct hc_device_param
   u32     kernel_loops_max;
   u32     kernel_loops_min_sav; // the _sav are required because each -i iteration
   u32     kernel_loops_max_sav; // needs to recalculate the kernel_loops_min/max based on the current amplifier count
+  u32     kernel_loops_max_prev; // kernel_loops_max the previous autotune ran with, see autotune_reuse()
   u32     kernel_threads;
   u32     kernel_threads_prev;
   u32     kernel_threads_min;
@@ -1479,12 +1511,21 @@ typedef struct hc_device_param
   HCFILE    combs_fp;
   pw_t     *combs_buf;
 
+  u64       combs_cache_pos; // position in combinator_ctx->combs_cache
+  bool      combs_cache_eof;
+
   void     *hooks_buf;
 
   pw_idx_t *pws_idx;
   u32      *pws_comp;
   u64       pws_cnt;
 
+  pw_idx_t *pws_idx_next;  // next batch, filled on the host while the current one runs
+  u32      *pws_comp_next;
+  u64       pws_cnt_next;
+
+  void     *pws_pinned_buf;  // page-locked region backing the four buffers above, NULL if they are pageable
+
   pw_pre_t *pws_pre_buf;  // for slow candidates
   u64       pws_pre_cnt;
 
@@ -1492,6 +1533,11 @@ typedef struct hc_device_param
   u64       pws_base_cnt;
 
   void    *h_tmps; // we need this only for bridges
+  bool     bridge_tmps_on_host; // h_tmps holds a newer tmps[] than the device
+
+  pw_t    *h_pws;        // candidates for BRIDGE_TYPE_LAUNCH_INIT
+  plain_t *h_plain_bufs; // cracks reported by BRIDGE_TYPE_LAUNCH_COMP
+  u32      h_result;
 
   u64     words_off;
   u64     words_done;
@@ -1532,6 +1578,13 @@ typedef struct hc_device_param
 
   hc_timer_t timer_speed;
 
+  // time spent waiting for other devices at the end of a pass
+
+  bool    tail_idle;
+  double  tail_idle_msec;
+
+  hc_timer_t timer_tail_idle;
+
   // Some more attributes
 
   bool    use_opencl11;
@@ -1606,6 +1659,16 @@ typedef struct hc_device_param
 
   kernel_param_t kernel_param;
 
+  // salts covered by the current launch, see SALT_BATCH in OpenCL/inc_types.h
+
+  bool    salt_batch;
+  u32     salt_batch_cnt;
+  u64     salt_batch_pws_cnt;
+
+  // content key of the main kernel, see kernel_cache_key() in backend.c
+
+  char    kernel_key[32];
+
   // API: cuda
 
   bool              is_cuda;
@@ -1948,6 +2011,7 @@ typedef struct hc_device_param
   cl_mem            opencl_d_pws_amp_buf;
   cl_mem            opencl_d_pws_comp_buf;
   cl_mem            opencl_d_pws_idx;
+  cl_mem            opencl_h_pws_pinned;
   cl_mem            opencl_d_rules;
   cl_mem            opencl_d_rules_c;
   cl_mem            opencl_d_combs;
@@ -1984,6 +2048,16 @@ typedef struct hc_device_param
 
 } hc_device_param_t;
 
+typedef struct autotune_cache_entry
+{
+  char key[17];
+
+  u32  kernel_accel;
+  u32  kernel_loops;
+  u32  kernel_threads;
+
+} autotune_cache_entry_t;
+
 typedef struct backend_ctx
 {
   bool                enabled;
@@ -2034,6 +2108,31 @@ typedef struct backend_ctx
 
   hc_device_param_t  *devices_param;
 
+  struct hook_pool   *hook_pool; // host hook12/hook23 workers, shared by all devices
+
+  // backend_session_begin () sets up all devices in parallel, identical devices share the same kernel cache files
+
+  hc_thread_mutex_t   mux_kernel_cache;
+  hc_thread_cond_t    cond_kernel_cache;
+  const char         *kernel_cache_busy[DEVICES_MAX]; // cached_file currently built or loaded by a device
+
+  // warnings which are not specific to one device are printed only once, and never mixed with each other
+
+  hc_thread_mutex_t   mux_session_warning;
+  bool                manual_tuning_warning;
+  bool                free_memory_warning;
+
+  // the self-test threads rewrite the self-test cache file one at a time
+
+  hc_thread_mutex_t   mux_selftest_cache;
+
+  // the autotune cache file is read once per session and shared by the autotune threads
+
+  hc_thread_mutex_t       mux_autotune_cache;
+  autotune_cache_entry_t *autotune_cache_buf;
+  int                     autotune_cache_cnt;
+  bool                    autotune_cache_loaded;
+
   u32                 hardware_power_all;
 
   u64                 kernel_power_all;
@@ -2239,6 +2338,28 @@ typedef struct loopback_ctx
 
 } loopback_ctx_t;
 
+typedef enum trace_lane
+{
+  TRACE_LANE_DEVICE = 0, // the device thread itself
+  TRACE_LANE_PREP   = 1, // host-side batch preparation running next to it
+
+} trace_lane_t;
+
+typedef struct trace_ctx
+{
+  HCFILE  fp;
+
+  bool    enabled;
+  bool    empty;
+
+  char   *filename;
+
+  hc_timer_t timer_origin;
+
+  hc_thread_mutex_t mux_trace;
+
+} trace_ctx_t;
+
 typedef struct mf
 {
   char mf_buf[0x400];
@@ -2257,6 +2378,10 @@ typedef struct outfile_ctx
 
   char   *filename;
 
+  HCFILE  stdout_fp; // --stdout output, kept open for the whole session
+
+  bool    stdout_is_pipe;     // linux only, candidates are handed over with vmsplice()
+
   hc_thread_mutex_t mux_outfile;
 
 } outfile_ctx_t;
@@ -2371,10 +2496,13 @@ typedef struct pidfile_ctx
 
 typedef struct out
 {
-  HCFILE fp;
+  outfile_ctx_t *outfile_ctx;
 
-  char   buf[HCBUFSIZ_SMALL];
-  int    len;
+  char   *buf; // allocates [STDOUT_BUFSZ], private to the calling device thread
+  int     len;
+  bool    buf_mmap; // buf is from mmap() and handed over to the pipe with vmsplice(), false if from hcmalloc()
+  bool    binary;   // --binary-candidates
+  int     err;      // errno of the first failed write, 0 if none, all later writes are skipped
 
 } out_t;
 
@@ -2475,6 +2603,7 @@ typedef struct user_options
   bool         session_chgd;
 
   bool         advice;
+  bool         autotune_refresh;
   bool         benchmark;
   bool         benchmark_all;
   #ifdef WITH_BRAIN
@@ -2491,6 +2620,7 @@ typedef struct user_options
   bool         hex_wordlist;
   increment_t  increment;
   bool         keep_guessing;
+  bool         kernel_precompile;
   bool         keyspace;
   bool         total_candidates;
   bool         left;
@@ -2500,6 +2630,7 @@ typedef struct user_options
   bool         markov_classic;
   bool         markov;
   bool         markov_inverse;
+  bool         mask_merge;
   bool         backend_ignore_cuda;
   bool         backend_ignore_hip;
   bool         backend_ignore_metal;
@@ -2515,12 +2646,14 @@ typedef struct user_options
   bool         restore;
   bool         restore_enable;
   bool         self_test;
+  bool         self_test_refresh;
   bool         show;
   bool         slow_candidates;
   bool         speed_only;
   bool         status;
   bool         status_json;
   bool         stdout_flag;
+  bool         binary_candidates;
   bool         stdin_timeout_abort_chgd;
   bool         username;
   bool         veracrypt_pim_start_chgd;
@@ -2539,6 +2672,7 @@ typedef struct user_options
   char        *cpu_affinity;
   char        *debug_file;
   char        *induction_dir;
+  char        *kernel_cache_dir;
   char        *keyboard_layout_mapping;
   char        *markov_hcstat2;
   char        *backend_devices;
@@ -2550,6 +2684,7 @@ typedef struct user_options
   char       **rp_files;
   char        *rp_gen_func_sel;
   char        *separator;
+  char        *trace_file;
   char        *truecrypt_keyfiles;
   char        *veracrypt_keyfiles;
   const char  *custom_charset_1;
@@ -2678,6 +2813,7 @@ typedef struct folder_config
   char *cache_dir;
   char *session_dir;
   char *shared_dir;
+  char *kernels_dir;
   char *cpath_real;
 
 } folder_config_t;
@@ -2728,6 +2864,11 @@ typedef struct combinator_ctx
   u32 combs_mode;
   u64 combs_cnt;
 
+  // built by the first device which needs it, the others wait for it
+
+  combs_cache_t     combs_cache;
+  hc_thread_mutex_t mux_combs_cache;
+
 } combinator_ctx_t;
 
 typedef struct mask_ctx
@@ -2745,6 +2886,9 @@ typedef struct mask_ctx
   hcstat_table_t *root_table_buf;
   hcstat_table_t *markov_table_buf;
 
+  u8    *hcstat_cache_buf; // mapped hcstat2 cache, root/markov tables point into it
+  size_t hcstat_cache_len;
+
   cs_t  *root_css_buf;
   cs_t  *markov_css_buf;
 
@@ -2942,9 +3086,69 @@ typedef struct hashcat_status
   double  hashes_msec_all;
   double  exec_msec_all;
   char   *speed_sec_all;
+  double  tail_idle_msec_all;
 
 } hashcat_status_t;
 
+typedef enum stdin_block_state
+{
+  STDIN_BLOCK_FREE      = 0,
+  STDIN_BLOCK_READING   = 1, // owned by the reader
+  STDIN_BLOCK_READ      = 2, // raw data, waiting for a parser
+  STDIN_BLOCK_PARSING   = 3, // owned by a parser
+  STDIN_BLOCK_PARSED    = 4, // candidates, waiting for a device
+  STDIN_BLOCK_CONSUMING = 5, // owned by a device
+
+} stdin_block_state_t;
+
+typedef struct stdin_block
+{
+  stdin_block_state_t state;
+
+  u64   seq;
+
+  char *raw_buf; // allocates [STDIN_BLOCK_SIZE + 1]
+  u64   raw_len;
+
+  u8   *pws_buf; // u16 length + candidate records
+  u64   pws_len;
+  u64   pws_pos;
+  u64   pws_sz;
+
+  u64   rejected;
+
+} stdin_block_t;
+
+typedef struct stdin_parser
+{
+  struct hashcat_ctx *hashcat_ctx;
+
+  iconv_t             iconv_ctx; // iconv_t keeps a conversion state, so every parser needs its own
+  char               *iconv_tmp;
+
+} stdin_parser_t;
+
+typedef struct stdin_pipe
+{
+  stdin_block_t     *blocks;
+  int                blocks_cnt;
+
+  u64                seq;
+  bool               reader_done;
+  bool               stop;
+
+  hc_thread_t        reader_thread;
+  hc_thread_t       *parsers_threads;
+  stdin_parser_t    *parsers;
+  int                parsers_cnt;
+
+  // every block state change is broadcast, the reader, the parsers and the devices wait on it
+
+  hc_thread_mutex_t  mux_stdin_pipe;
+  hc_thread_cond_t   cond_stdin_pipe;
+
+} stdin_pipe_t;
+
 typedef struct status_ctx
 {
   /**
@@ -3023,6 +3227,12 @@ typedef struct status_ctx
 
   u32  stdin_read_timeout_cnt;
 
+  /**
+   * stdin mode reader and parsers
+   */
+
+  stdin_pipe_t *stdin_pipe;
+
 } status_ctx_t;
 
 typedef struct hashcat_user
@@ -3121,8 +3331,10 @@ typedef struct bridge_ctx
   bool      (*thread_init)        (void *, hc_device_param_t *, hashconfig_t *, hashes_t *);
   void      (*thread_term)        (void *, hc_device_param_t *, hashconfig_t *, hashes_t *);
 
+  bool      (*launch_init)        (void *, hc_device_param_t *, hashconfig_t *, hashes_t *, const u32, const u64);
   bool      (*launch_loop)        (void *, hc_device_param_t *, hashconfig_t *, hashes_t *, const u32, const u64);
   bool      (*launch_loop2)       (void *, hc_device_param_t *, hashconfig_t *, hashes_t *, const u32, const u64);
+  bool      (*launch_comp)        (void *, hc_device_param_t *, hashconfig_t *, hashes_t *, const u32, const u64);
 
   const char *(*st_update_pass)  (void *);
   const char *(*st_update_hash)  (void *);
@@ -3262,6 +3474,7 @@ typedef struct hashcat_ctx
   restore_ctx_t         *restore_ctx;
   status_ctx_t          *status_ctx;
   straight_ctx_t        *straight_ctx;
+  trace_ctx_t           *trace_ctx;
   tuning_db_t           *tuning_db;
   user_options_extra_t  *user_options_extra;
   user_options_t        *user_options;
@@ -3282,21 +3495,88 @@ typedef struct thread_param
 typedef struct hook_thread_param
 {
   int tid;
-  int tsz;
 
-  bridge_ctx_t *bridge_ctx;
-  module_ctx_t *module_ctx;
-  status_ctx_t *status_ctx;
-
-  hc_device_param_t *device_param;
+  struct hook_pool *hook_pool;
 
   void *hook_extra_param;
-  void *hook_salts_buf;
 
+} hook_thread_param_t;
+
+typedef struct hook_job
+{
+  hc_device_param_t *device_param;
+
+  u64 opts_type;  // OPTS_TYPE_HOOK12 or OPTS_TYPE_HOOK23
   u32 salt_pos;
+
   u64 pws_cnt;
+  u64 pws_pos;    // next password not yet handed to a worker
+  u64 pws_done;
+  u64 chunk;
 
-} hook_thread_param_t;
+} hook_job_t;
+
+typedef struct hook_pool
+{
+  hashcat_ctx_t *hashcat_ctx;
+
+  hc_thread_t         *threads;
+  hook_thread_param_t *threads_param;
+  int                  threads_cnt;
+
+  hook_job_t *jobs[DEVICES_MAX]; // at most one job in flight per device
+  int         jobs_cnt;
+  int         jobs_next;
+
+  bool shutdown;
+
+  hc_thread_mutex_t mux_hook_pool;
+  hc_thread_cond_t  cond_work;
+  hc_thread_cond_t  cond_done;
+
+} hook_pool_t;
+
+typedef struct backend_session_device
+{
+  hashcat_ctx_t *hashcat_ctx;
+
+  int  backend_devices_idx;
+  bool active;
+
+  int  rc;
+
+  int  memory_hit_warnings;
+  int  kernel_build_warnings;
+  int  kernel_create_warnings;
+  int  extra_size_warning;
+
+  u64  size_total_host;
+  u32  hardware_power;
+
+} backend_session_device_t;
+
+typedef struct calc_prep
+{
+  hashcat_ctx_t     *hashcat_ctx;
+  hashcat_ctx_t     *hashcat_ctx_tmp;
+  hc_device_param_t *device_param;
+
+  HCFILE *fp;
+
+  u64 words_cur;
+  u64 words_off;
+  u64 words_fin;
+  u64 words_extra_total;
+
+  // one prep thread per device lives as long as the wordlist, the device thread requests a batch and waits for it
+
+  hc_thread_t       thread;
+  hc_thread_mutex_t mux_prep;
+  hc_thread_cond_t  cond_prep;
+  bool              requested;
+  bool              quit;
+
+} calc_prep_t;
 
 #define MAX_TOKENS     128
 #define MAX_SIGNATURES 16
@@ -13,6 +13,10 @@
 #endif
 #include "affinity.h"
 
+#if defined (__linux__)
+#include <dirent.h>
+#endif
+
 #if defined (__APPLE__)
 static void CPU_ZERO (cpu_set_t *cs)
 {
@@ -202,3 +206,103 @@ int set_cpu_affinity (MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx)
   return 0;
   #endif
 }
+
+/**
+ * CPU topology for bridges which run one unit per CPU
+ *
+ * get_cpu_topology() lists the CPUs this process may run on (so it honors --cpu-affinity)
+ * together with the NUMA node each of them belongs to, or -1 if unknown.
+ * It returns the number of CPUs found, or 0 if the platform does not tell.
+ */
+
+#if defined (__linux__)
+static int get_cpu_numa_node (const int cpu_id)
+{
+  char path[256];
+
+  snprintf (path, sizeof (path), "/sys/devices/system/cpu/cpu%d", cpu_id);
+
+  DIR *dir = opendir (path);
+
+  if (dir == NULL) return -1;
+
+  int numa_node = -1;
+
+  struct dirent *de;
+
+  while ((de = readdir (dir)) != NULL)
+  {
+    if (strncmp (de->d_name, "node", 4) != 0) continue;
+
+    char *end = NULL;
+
+    const long node = strtol (de->d_name + 4, &end, 10);
+
+    if ((end == de->d_name + 4) || (*end != 0)) continue;
+
+    numa_node = (int) node;
+
+    break;
+  }
+
+  closedir (dir);
+
+  return numa_node;
+}
+#endif
+
+int get_cpu_topology (MAYBE_UNUSED int *cpu_ids, MAYBE_UNUSED int *numa_nodes, MAYBE_UNUSED const int cnt_max)
+{
+  #if defined (__linux__)
+
+  cpu_set_t cpuset;
+
+  CPU_ZERO (&cpuset);
+
+  if (sched_getaffinity (0, sizeof (cpu_set_t), &cpuset) != 0) return 0;
+
+  int cnt = 0;
+
+  for (int cpu_id = 0; cpu_id < CPU_SETSIZE; cpu_id++)
+  {
+    if (cnt == cnt_max) break;
+
+    if (CPU_ISSET (cpu_id, &cpuset) == 0) continue;
+
+    cpu_ids[cnt]    = cpu_id;
+    numa_nodes[cnt] = get_cpu_numa_node (cpu_id);
+
+    cnt++;
+  }
+
+  return cnt;
+
+  #else
+
+  return 0;
+
+  #endif
+}
+
+int set_thread_cpu_affinity (MAYBE_UNUSED const int cpu_id)
+{
+  #if defined (__linux__)
+
+  if (cpu_id < 0) return 0;
+
+  cpu_set_t cpuset;
+
+  CPU_ZERO (&cpuset);
+
+  CPU_SET (cpu_id, &cpuset);
+
+  #if defined (__ANDROID__)
+  if (sched_setaffinity (gettid (), sizeof (cpu_set_t), &cpuset) != 0) return -1;
+  #else
+  if (pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &cpuset) != 0) return -1;
+  #endif
+
+  #endif
+
+  return 0;
+}
@@ -8,7 +8,11 @@
 #include "event.h"
 #include "backend.h"
 #include "status.h"
+#include "memory.h"
+#include "thread.h"
 #include "shared.h"
+#include "filehandling.h"
+#include "xxhash.h"
 #include "autotune.h"
 
 int find_tuning_function (hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED hc_device_param_t *device_param)
@@ -97,6 +101,43 @@ static double try_run_times (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
   return exec_msec_best;
 }
 
+static void autotune_reset_timer (hc_device_param_t *device_param)
+{
+  // the exec timings feed the speed and runtime estimates, none of them must survive into the next tuning
+
+  device_param->exec_pos = 0;
+
+  memset (device_param->exec_msec,          0,          EXEC_CACHE * sizeof (double));
+  memset (device_param->exec_us_prev1,      0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev2,      0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev3,      0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev4,      0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_init2, 0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_loop2, 0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_aux1,  0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_aux2,  0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_aux3,  0, EXPECTED_ITERATIONS * sizeof (double));
+  memset (device_param->exec_us_prev_aux4,  0, EXPECTED_ITERATIONS * sizeof (double));
+}
+
+static void autotune_apply (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kernel_accel, const u32 kernel_loops, const u32 kernel_threads)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+
+  device_param->kernel_accel   = kernel_accel;
+  device_param->kernel_loops   = kernel_loops;
+  device_param->kernel_threads = kernel_threads;
+
+  const u32 hardware_power = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors)
+                           * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param->kernel_threads);
+
+  device_param->hardware_power = hardware_power;
+
+  const u32 kernel_power = device_param->hardware_power * device_param->kernel_accel;
+
+  device_param->kernel_power = kernel_power;
+}
+
 static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   const hashes_t       *hashes       = hashcat_ctx->hashes;
@@ -662,38 +703,304 @@ static int autotune (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
 
   // reset timer
 
-  device_param->exec_pos = 0;
-
-  memset (device_param->exec_msec,          0,          EXEC_CACHE * sizeof (double));
-  memset (device_param->exec_us_prev1,      0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev2,      0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev3,      0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev4,      0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_init2, 0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_loop2, 0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_aux1,  0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_aux2,  0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_aux3,  0, EXPECTED_ITERATIONS * sizeof (double));
-  memset (device_param->exec_us_prev_aux4,  0, EXPECTED_ITERATIONS * sizeof (double));
+  autotune_reset_timer (device_param);
 
   // store
 
-  device_param->kernel_accel   = kernel_accel;
-  device_param->kernel_loops   = kernel_loops;
-  device_param->kernel_threads = kernel_threads;
+  autotune_apply (hashcat_ctx, device_param, kernel_accel, kernel_loops, kernel_threads);
 
-  const u32 hardware_power = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors)
-                           * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param->kernel_threads);
+  //printf ("Final: %d %d %d %d %d\n", kernel_accel, kernel_loops, kernel_threads, hardware_power, kernel_power);
 
-  device_param->hardware_power = hardware_power;
+  return 0;
+}
 
-  const u32 kernel_power = device_param->hardware_power * device_param->kernel_accel;
+static bool autotune_reuse (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  const user_options_t *user_options = hashcat_ctx->user_options;
 
-  device_param->kernel_power = kernel_power;
+  /**
+   * with --increment every length runs its own autotune, which for short lengths
+   * takes longer than the length itself and keeps all devices waiting on the slowest one.
+   * the kernel is the same for all lengths, so the previous result is still valid
+   * as long as it fits the new limits and the previous kernel_loops were not capped by a smaller amplifier
+   */
 
-  //printf ("Final: %d %d %d %d %d\n", kernel_accel, kernel_loops, kernel_threads, hardware_power, kernel_power);
+  if (user_options->increment == INCREMENT_NONE) return false;
 
-  return 0;
+  const u32 kernel_accel   = device_param->kernel_accel_prev;
+  const u32 kernel_loops   = device_param->kernel_loops_prev;
+  const u32 kernel_threads = device_param->kernel_threads_prev;
+
+  if ((kernel_accel == 0) || (kernel_loops == 0) || (kernel_threads == 0)) return false;
+
+  if ((kernel_accel   < device_param->kernel_accel_min)   || (kernel_accel   > device_param->kernel_accel_max))   return false;
+  if ((kernel_loops   < device_param->kernel_loops_min)   || (kernel_loops   > device_param->kernel_loops_max))   return false;
+  if ((kernel_threads < device_param->kernel_threads_min) || (kernel_threads > device_param->kernel_threads_max)) return false;
+
+  if ((kernel_loops == device_param->kernel_loops_max_prev) && (kernel_loops < device_param->kernel_loops_max)) return false;
+
+  // the timings are still those of the previous length
+
+  autotune_reset_timer (device_param);
+
+  autotune_apply (hashcat_ctx, device_param, kernel_accel, kernel_loops, kernel_threads);
+
+  return true;
+}
+
+/**
+ * autotune cache
+ *
+ * The chosen tuning is stored in AUTOTUNE_CACHE_FILENAME in the kernel cache folder, one line per setup:
+ * "<key> <kernel_accel> <kernel_loops> <kernel_threads>". The file is read once per session and shared by
+ * all devices, every store rewrites it with one line per key, merged with what other sessions stored meanwhile.
+ * The key covers the main kernel (its content key includes the device and driver identity and the
+ * build options), the hash-mode, the tuning limits, the workload profile and the rough size of the hashlist.
+ */
+
+static u32 autotune_cache_bucket (u32 cnt)
+{
+  u32 bucket = 0;
+
+  while (cnt) { cnt >>= 1; bucket++; }
+
+  return bucket;
+}
+
+static bool autotune_cache_key (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, char *key)
+{
+  const backend_ctx_t        *backend_ctx        = hashcat_ctx->backend_ctx;
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const hashes_t             *hashes             = hashcat_ctx->hashes;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  if (device_param->kernel_key[0] == 0) return false;
+
+  char identity[HCBUFSIZ_TINY] = { 0 };
+
+  const int identity_len = snprintf (identity, sizeof (identity), "%s-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u-%u",
+    device_param->kernel_key,
+    hashconfig->hash_mode,
+    user_options_extra->attack_kern,
+    (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) ? 1 : 0,
+    device_param->device_processors,
+    device_param->kernel_accel_min,
+    device_param->kernel_accel_max,
+    device_param->kernel_loops_min,
+    device_param->kernel_loops_max,
+    device_param->kernel_threads_min,
+    device_param->kernel_threads_max,
+    (u32) backend_ctx->target_msec,
+    autotune_cache_bucket (hashes->salts_cnt),
+    autotune_cache_bucket (hashes->digests_cnt),
+    hashes->salts_buf[0].salt_iter,
+    hashes->salts_buf[0].salt_iter2,
+    hashes->salts_buf[0].salt_repeats);
+
+  snprintf (key, 17, "%016" PRIx64, (u64) XXH64 (identity, identity_len, 0));
+
+  return true;
+}
+
+static void autotune_cache_update (autotune_cache_entry_t **entries_buf, int *entries_cnt, const char *key, const u32 kernel_accel, const u32 kernel_loops, const u32 kernel_threads)
+{
+  autotune_cache_entry_t *entry = NULL;
+
+  for (int i = 0; i < *entries_cnt; i++)
+  {
+    if (strcmp ((*entries_buf)[i].key, key) != 0) continue;
+
+    entry = *entries_buf + i;
+
+    break;
+  }
+
+  if (entry == NULL)
+  {
+    *entries_buf = (autotune_cache_entry_t *) hcrealloc (*entries_buf, *entries_cnt * sizeof (autotune_cache_entry_t), sizeof (autotune_cache_entry_t));
+
+    entry = *entries_buf + *entries_cnt;
+
+    strncpy (entry->key, key, sizeof (entry->key) - 1);
+
+    *entries_cnt += 1;
+  }
+
+  entry->kernel_accel   = kernel_accel;
+  entry->kernel_loops   = kernel_loops;
+  entry->kernel_threads = kernel_threads;
+}
+
+static void autotune_cache_read (const char *cache_file, autotune_cache_entry_t **entries_buf, int *entries_cnt)
+{
+  *entries_buf = NULL;
+  *entries_cnt = 0;
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, cache_file, "rb") == false) return;
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  while (!hc_feof (&fp))
+  {
+    const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_TINY);
+
+    if (line_len == 0) continue;
+
+    char line_key[32] = { 0 };
+
+    u32 accel   = 0;
+    u32 loops   = 0;
+    u32 threads = 0;
+
+    if (sscanf (line_buf, "%16s %u %u %u", line_key, &accel, &loops, &threads) != 4) continue;
+
+    // files written before the rewrite-on-store could hold a key several times, the last one wins
+
+    autotune_cache_update (entries_buf, entries_cnt, line_key, accel, loops, threads);
+  }
+
+  hcfree (line_buf);
+
+  hc_fclose (&fp);
+}
+
+static bool autotune_cache_load (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  backend_ctx_t         *backend_ctx   = hashcat_ctx->backend_ctx;
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+  const user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  if (user_options->autotune_refresh == true) return false;
+
+  char key[32] = { 0 };
+
+  if (autotune_cache_key (hashcat_ctx, device_param, key) == false) return false;
+
+  u32 kernel_accel   = 0;
+  u32 kernel_loops   = 0;
+  u32 kernel_threads = 0;
+
+  hc_thread_mutex_lock (backend_ctx->mux_autotune_cache);
+
+  if (backend_ctx->autotune_cache_loaded == false)
+  {
+    char *cache_file = NULL;
+
+    hc_asprintf (&cache_file, "%s/%s", folder_config->kernels_dir, AUTOTUNE_CACHE_FILENAME);
+
+    autotune_cache_read (cache_file, &backend_ctx->autotune_cache_buf, &backend_ctx->autotune_cache_cnt);
+
+    hcfree (cache_file);
+
+    backend_ctx->autotune_cache_loaded = true;
+  }
+
+  for (int i = 0; i < backend_ctx->autotune_cache_cnt; i++)
+  {
+    const autotune_cache_entry_t *entry = backend_ctx->autotune_cache_buf + i;
+
+    if (strcmp (entry->key, key) != 0) continue;
+
+    kernel_accel   = entry->kernel_accel;
+    kernel_loops   = entry->kernel_loops;
+    kernel_threads = entry->kernel_threads;
+
+    break;
+  }
+
+  hc_thread_mutex_unlock (backend_ctx->mux_autotune_cache);
+
+  // the limits are part of the key, but an edited or damaged file must not get past them
+
+  if ((kernel_accel   < device_param->kernel_accel_min)   || (kernel_accel   > device_param->kernel_accel_max))   return false;
+  if ((kernel_loops   < device_param->kernel_loops_min)   || (kernel_loops   > device_param->kernel_loops_max))   return false;
+  if ((kernel_threads < device_param->kernel_threads_min) || (kernel_threads > device_param->kernel_threads_max)) return false;
+
+  if ((kernel_accel == 0) || (kernel_loops == 0) || (kernel_threads == 0)) return false;
+
+  autotune_reset_timer (device_param);
+
+  autotune_apply (hashcat_ctx, device_param, kernel_accel, kernel_loops, kernel_threads);
+
+  return true;
+}
+
+static void autotune_cache_store (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  backend_ctx_t         *backend_ctx   = hashcat_ctx->backend_ctx;
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  char key[32] = { 0 };
+
+  if (autotune_cache_key (hashcat_ctx, device_param, key) == false) return;
+
+  // the cache is optional, any failure here just means the next session has to tune again
+
+  #if defined (_WIN)
+  const int pid = (int) GetCurrentProcessId ();
+  #else
+  const int pid = (int) getpid ();
+  #endif
+
+  char *cache_file     = NULL;
+  char *cache_file_tmp = NULL;
+
+  hc_asprintf (&cache_file,     "%s/%s", folder_config->kernels_dir, AUTOTUNE_CACHE_FILENAME);
+  hc_asprintf (&cache_file_tmp, "%s.%d.tmp", cache_file, pid);
+
+  hc_thread_mutex_lock (backend_ctx->mux_autotune_cache);
+
+  // start from the file, not from what we loaded, to keep the entries other sessions stored meanwhile
+
+  autotune_cache_entry_t *entries_buf = NULL;
+
+  int entries_cnt = 0;
+
+  autotune_cache_read (cache_file, &entries_buf, &entries_cnt);
+
+  autotune_cache_update (&entries_buf, &entries_cnt, key, device_param->kernel_accel, device_param->kernel_loops, device_param->kernel_threads);
+
+  HCFILE fp;
+
+  if (hc_fopen_raw (&fp, cache_file_tmp, "wb") == true)
+  {
+    bool written = true;
+
+    for (int i = 0; i < entries_cnt; i++)
+    {
+      const autotune_cache_entry_t *entry = entries_buf + i;
+
+      if (hc_fprintf (&fp, "%s %u %u %u\n", entry->key, entry->kernel_accel, entry->kernel_loops, entry->kernel_threads) < 0) written = false;
+    }
+
+    hc_fclose (&fp);
+
+    // rename() makes the rewritten file visible atomically to concurrent sessions
+
+    if (written == true)
+    {
+      if (rename (cache_file_tmp, cache_file) != 0) written = false;
+    }
+
+    if (written == false) unlink (cache_file_tmp);
+  }
+  else
+  {
+    event_log_warning (hashcat_ctx, "%s: %s", cache_file_tmp, strerror (errno));
+  }
+
+  hcfree (backend_ctx->autotune_cache_buf);
+
+  backend_ctx->autotune_cache_buf    = entries_buf;
+  backend_ctx->autotune_cache_cnt    = entries_cnt;
+  backend_ctx->autotune_cache_loaded = true;
+
+  hc_thread_mutex_unlock (backend_ctx->mux_autotune_cache);
+
+  hcfree (cache_file_tmp);
+  hcfree (cache_file);
 }
 
 #if defined (_WIN32) || defined (__WIN32__)
@@ -731,10 +1038,21 @@ HC_API_CALL void *thread_autotune (void *p)
 
   // check for autotune failure
 
-  if (autotune (hashcat_ctx, device_param) == 0)
+  if ((autotune_reuse (hashcat_ctx, device_param) == true) || (autotune_cache_load (hashcat_ctx, device_param) == true))
   {
     device_param->at_status = AT_STATUS_PASSED;
     device_param->at_rc = 0;
+
+    device_param->kernel_loops_max_prev = device_param->kernel_loops_max;
+  }
+  else if (autotune (hashcat_ctx, device_param) == 0)
+  {
+    device_param->at_status = AT_STATUS_PASSED;
+    device_param->at_rc = 0;
+
+    device_param->kernel_loops_max_prev = device_param->kernel_loops_max;
+
+    autotune_cache_store (hashcat_ctx, device_param);
   }
 
   if (device_param->is_cuda == true)
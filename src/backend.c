@@ -19,13 +19,14 @@
 #include "wordlist.h"
 #include "shared.h"
 #include "hashes.h"
-#include "emu_inc_hash_md5.h"
 #include "event.h"
 #include "dynloader.h"
 #include "backend.h"
 #include "terminal.h"
 #include "hwmon.h"
 #include "autotune.h"
+#include "trace.h"
+#include "xxhash.h"
 
 #if defined (__linux__)
 static const char *const  dri_card0_path = "/dev/dri/card0";
@@ -45,6 +46,9 @@ static const u32 bzeros[4] = { 0, 0, 0, 0 };
 
 /* forward declarations */
 static void rebuild_pws_compressed_append (hc_device_param_t *device_param, const u64 pws_cnt, const u8 chr);
+static int  hook_pool_init    (hashcat_ctx_t *hashcat_ctx);
+static void hook_pool_destroy (hashcat_ctx_t *hashcat_ctx);
+static void hook_pool_run     (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 opts_type, const u32 salt_pos, const u64 pws_cnt);
 //
 static bool is_same_device (const hc_device_param_t *src, const hc_device_param_t *dst)
 {
@@ -927,7 +931,7 @@ void generate_source_kernel_filename (const bool slow_candidates, const u32 atta
   }
 }
 
-void generate_cached_kernel_filename (const bool slow_candidates, const u32 attack_exec, const u32 attack_kern, const u32 kern_type, const u32 opti_type, char *cache_dir, const char *device_name_chksum, char *cached_file, bool is_metal)
+void generate_cached_kernel_filename (const bool slow_candidates, const u32 attack_exec, const u32 attack_kern, const u32 kern_type, const u32 opti_type, char *kernels_dir, const char *device_name_chksum, char *cached_file, bool is_metal)
 {
   if (opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
   {
@@ -935,23 +939,23 @@ void generate_cached_kernel_filename (const bool slow_candidates, const u32 atta
     {
       if (slow_candidates == true)
       {
-        snprintf (cached_file, 255, "%s/kernels/m%05d_a0-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+        snprintf (cached_file, 255, "%s/m%05d_a0-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
       }
       else
       {
         if (attack_kern == ATTACK_KERN_STRAIGHT)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a0-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a0-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_COMBI)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a1-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a1-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_BF)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a3-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a3-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_NONE)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a0-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a0-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
       }
     }
     else
     {
-      snprintf (cached_file, 255, "%s/kernels/m%05d-optimized.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+      snprintf (cached_file, 255, "%s/m%05d-optimized.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
     }
   }
   else
@@ -960,23 +964,23 @@ void generate_cached_kernel_filename (const bool slow_candidates, const u32 atta
     {
       if (slow_candidates == true)
       {
-        snprintf (cached_file, 255, "%s/kernels/m%05d_a0-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+        snprintf (cached_file, 255, "%s/m%05d_a0-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
       }
       else
       {
         if (attack_kern == ATTACK_KERN_STRAIGHT)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a0-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a0-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_COMBI)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a1-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a1-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_BF)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a3-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a3-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
         else if (attack_kern == ATTACK_KERN_NONE)
-          snprintf (cached_file, 255, "%s/kernels/m%05d_a0-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+          snprintf (cached_file, 255, "%s/m%05d_a0-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
       }
     }
     else
     {
-      snprintf (cached_file, 255, "%s/kernels/m%05d-pure.%s.%s", cache_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
+      snprintf (cached_file, 255, "%s/m%05d-pure.%s.%s", kernels_dir, (int) kern_type, device_name_chksum, (is_metal == true) ? "metallib" : "kernel");
     }
   }
 }
@@ -986,9 +990,9 @@ void generate_source_kernel_shared_filename (char *shared_dir, char *source_file
   snprintf (source_file, 255, "%s/OpenCL/shared.cl", shared_dir);
 }
 
-void generate_cached_kernel_shared_filename (char *cache_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
+void generate_cached_kernel_shared_filename (char *kernels_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
 {
-  snprintf (cached_file, 255, "%s/kernels/shared.%s.%s", cache_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
+  snprintf (cached_file, 255, "%s/shared.%s.%s", kernels_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
 }
 
 void generate_source_kernel_mp_filename (const u32 opti_type, const u64 opts_type, char *shared_dir, char *source_file)
@@ -1003,15 +1007,15 @@ void generate_source_kernel_mp_filename (const u32 opti_type, const u64 opts_typ
   }
 }
 
-void generate_cached_kernel_mp_filename (const u32 opti_type, const u64 opts_type, char *cache_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
+void generate_cached_kernel_mp_filename (const u32 opti_type, const u64 opts_type, char *kernels_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
 {
   if ((opti_type & OPTI_TYPE_BRUTE_FORCE) && (opts_type & OPTS_TYPE_PT_GENERATE_BE))
   {
-    snprintf (cached_file, 255, "%s/kernels/markov_be.%s.%s", cache_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
+    snprintf (cached_file, 255, "%s/markov_be.%s.%s", kernels_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
   }
   else
   {
-    snprintf (cached_file, 255, "%s/kernels/markov_le.%s.%s", cache_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
+    snprintf (cached_file, 255, "%s/markov_le.%s.%s", kernels_dir, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
   }
 }
 
@@ -1020,9 +1024,166 @@ void generate_source_kernel_amp_filename (const u32 attack_kern, char *shared_di
   snprintf (source_file, 255, "%s/OpenCL/amp_a%u.cl", shared_dir, attack_kern);
 }
 
-void generate_cached_kernel_amp_filename (const u32 attack_kern, char *cache_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
+void generate_cached_kernel_amp_filename (const u32 attack_kern, char *kernels_dir, const char *device_name_chksum_amp_mp, char *cached_file, bool is_metal)
 {
-  snprintf (cached_file, 255, "%s/kernels/amp_a%u.%s.%s", cache_dir, attack_kern, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
+  snprintf (cached_file, 255, "%s/amp_a%u.%s.%s", kernels_dir, attack_kern, device_name_chksum_amp_mp, (is_metal == true) ? "metallib" : "kernel");
+}
+
+/**
+ * kernel cache key
+ *
+ * A cached kernel is addressed by a hash over everything its binary depends on: the runtime and device
+ * identity, the build options and the content of the kernel source including all OpenCL/ files it pulls in.
+ * The folder of the OpenCL/ files is left out, so that a kernel cache can be shared by installations in different places.
+ */
+
+#define KERNEL_CACHE_INCLUDES_MAX 256
+
+static bool kernel_cache_key_update_source (hashcat_ctx_t *hashcat_ctx, XXH64_state_t *state, char **names, int *names_cnt, const char *source_file)
+{
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  size_t kernel_lengths[1] = { 0 };
+  char  *kernel_sources[1] = { NULL };
+
+  if (read_kernel_binary (hashcat_ctx, source_file, kernel_lengths, kernel_sources) == false) return false;
+
+  char *buf = kernel_sources[0];
+
+  XXH64_update (state, buf, kernel_lengths[0]);
+
+  // follow both the kernel style M2S(INCLUDE_PATH/file) and the plain "file" includes, each file is visited once
+
+  bool rc = true;
+
+  for (char *line = buf; line != NULL; line = strchr (line, '\n'))
+  {
+    while ((*line == '\n') || (*line == ' ') || (*line == '\t')) line++;
+
+    if (strncmp (line, "#include ", 9) != 0) continue;
+
+    char *name = line + 9;
+
+    while (*name == ' ') name++;
+
+    char term = 0;
+
+    if (strncmp (name, "M2S(INCLUDE_PATH/", 17) == 0)
+    {
+      name += 17;
+
+      term = ')';
+    }
+    else if (*name == '"')
+    {
+      name += 1;
+
+      term = '"';
+    }
+    else
+    {
+      continue;
+    }
+
+    const size_t name_len = strcspn (name, ")\"\r\n");
+
+    if ((name_len == 0) || (name[name_len] != term)) continue;
+
+    bool seen = false;
+
+    for (int i = 0; i < *names_cnt; i++)
+    {
+      if ((strlen (names[i]) == name_len) && (strncmp (names[i], name, name_len) == 0)) seen = true;
+    }
+
+    if (seen == true) continue;
+
+    if (*names_cnt == KERNEL_CACHE_INCLUDES_MAX)
+    {
+      event_log_error (hashcat_ctx, "%s: Too many includes.", source_file);
+
+      rc = false;
+
+      break;
+    }
+
+    char *include_name = hcstrdup (name);
+
+    include_name[name_len] = 0;
+
+    names[(*names_cnt)++] = include_name;
+
+    char *include_file = NULL;
+
+    hc_asprintf (&include_file, "%s/%s", folder_config->cpath_real, include_name);
+
+    // some includes are host or Metal headers which only exist for other builds, they can't change the result
+
+    if (hc_path_is_file (include_file) == true)
+    {
+      XXH64_update (state, include_name, name_len);
+
+      rc = kernel_cache_key_update_source (hashcat_ctx, state, names, names_cnt, include_file);
+    }
+
+    hcfree (include_file);
+
+    if (rc == false) break;
+  }
+
+  hcfree (buf);
+
+  return rc;
+}
+
+static bool kernel_cache_key (hashcat_ctx_t *hashcat_ctx, const char *device_identity, const char *build_options, const char *source_file, char *key)
+{
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  XXH64_state_t *state = XXH64_createState ();
+
+  XXH64_reset (state, 0);
+
+  XXH64_update (state, device_identity, strlen (device_identity));
+
+  if (build_options != NULL)
+  {
+    // skip the absolute INCLUDE_PATH, the sources are hashed by content instead
+
+    const char  *cpath     = folder_config->cpath_real;
+    const size_t cpath_len = strlen (cpath);
+
+    const char *pos = build_options;
+
+    for (const char *next = strstr (pos, cpath); next != NULL; next = strstr (pos, cpath))
+    {
+      XXH64_update (state, pos, next - pos);
+
+      pos = next + cpath_len;
+    }
+
+    XXH64_update (state, pos, strlen (pos));
+  }
+
+  char **names = (char **) hccalloc (KERNEL_CACHE_INCLUDES_MAX, sizeof (char *));
+
+  int names_cnt = 0;
+
+  const bool rc = kernel_cache_key_update_source (hashcat_ctx, state, names, &names_cnt, source_file);
+
+  for (int i = 0; i < names_cnt; i++) hcfree (names[i]);
+
+  hcfree (names);
+
+  const u64 hash = XXH64_digest (state);
+
+  XXH64_freeState (state);
+
+  if (rc == false) return false;
+
+  snprintf (key, 17, "%016" PRIx64, hash);
+
+  return true;
 }
 
 int gidd_to_pw_t (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 gidd, pw_t *pw)
@@ -1189,574 +1350,605 @@ int copy_pws_comp (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
   return 0;
 }
 
-int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 highest_pw_len, const u64 pws_pos, const u64 pws_cnt, const u32 fast_iteration, const u32 salt_pos, const bool is_autotune)
+/**
+ * Multi-salt batched launches
+ *
+ * With many salts and a small number of candidates a slow hash launch is under-filled.
+ * In that case run_cracker() packs consecutive salts into a single launch: the candidates are
+ * replicated once per salt and the kernels (built with -D SALT_BATCH) select the salt by GID,
+ * the same way ATTACK_MODE_ASSOCIATION does. Everything which calls back into the host per salt
+ * (hooks, bridges, deep-comp) or sizes device memory per salt (scrypt, Argon2) stays on the
+ * regular one-salt-per-launch path.
+ *
+ * Each salt owns a block of salt_batch_pws work-items, rounded up to the work-group size so that
+ * kernels which stage the (e)salt in local memory never see two salts in one work-group.
+ * The padding repeats the candidates from the start of the block, which keeps every work-item
+ * a valid candidate and lets check_cracked() map any GID back with two modulo operations.
+ */
+
+// outside of a multi-salt launch, GID / salt_batch_pws is always 0
+
+#define SALT_BATCH_PWS_NONE 0xffffffff
+
+static bool salt_batch_supported (hashcat_ctx_t *hashcat_ctx)
 {
-  bridge_ctx_t   *bridge_ctx   = hashcat_ctx->bridge_ctx;
-  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  hashes_t       *hashes       = hashcat_ctx->hashes;
-  module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
-  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
-  user_options_t *user_options = hashcat_ctx->user_options;
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const hashes_t       *hashes       = hashcat_ctx->hashes;
+  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  const user_options_t *user_options = hashcat_ctx->user_options;
 
-  if (user_options->stdout_flag == true)
-  {
-    return process_stdout (hashcat_ctx, device_param, pws_cnt);
-  }
+  if (hashconfig->attack_exec != ATTACK_EXEC_OUTSIDE_KERNEL) return false;
 
-  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-  {
-    if (user_options->attack_mode == ATTACK_MODE_BF)
-    {
-      if (user_options->slow_candidates == true)
-      {
-      }
-      else
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          const u32 size_tm = device_param->size_tm;
+  if (hashes->salts_cnt < 2) return false;
 
-          if (device_param->is_cuda == true)
-          {
-            if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tm_c, size_tm) == -1) return -1;
-          }
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION) return false;
 
-          if (device_param->is_hip == true)
-          {
-            if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tm_c, size_tm) == -1) return -1;
-          }
+  if (user_options->stdout_flag == true) return false;
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tm_c, size_tm) == -1) return -1;
-          }
-          #endif
+  if (hashconfig->opts_type & (OPTS_TYPE_HOOK12 | OPTS_TYPE_HOOK23 | OPTS_TYPE_DEEP_COMP_KERNEL)) return false;
 
-          if (device_param->is_opencl == true)
-          {
-            if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tm_c, size_tm) == -1) return -1;
-          }
+  if (hashconfig->bridge_type != BRIDGE_TYPE_NONE) return false;
 
-          if (run_kernel_tm (hashcat_ctx, device_param) == -1) return -1;
+  // scrypt and Argon2 size their per work-item memory by the cost parameters in the esalt,
+  // two salts with different parameters in one launch would overlap each other's memory
 
-          if (device_param->is_cuda == true)
-          {
-            if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_bfs_c, device_param->cuda_d_tm_c, size_tm) == -1) return -1;
-          }
+  if (module_ctx->module_extra_buffer_size != MODULE_DEFAULT) return false;
+  if (module_ctx->module_extra_tmp_size    != MODULE_DEFAULT) return false;
 
-          if (device_param->is_hip == true)
-          {
-            if (hc_hipMemcpyDtoD (hashcat_ctx, device_param->hip_d_bfs_c, device_param->hip_d_tm_c, size_tm) == -1) return -1;
-          }
+  return true;
+}
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            if (hc_mtlMemcpyDtoD (hashcat_ctx, device_param->metal_command_queue, device_param->metal_d_bfs_c, 0, device_param->metal_d_tm_c, 0, size_tm) == -1) return -1;
-          }
-          #endif
+static u32 salt_batch_size (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 salt_pos, const u32 salts_cnt, const u64 pws_cnt)
+{
+  const hashes_t *hashes = hashcat_ctx->hashes;
 
-          if (device_param->is_opencl == true)
-          {
-            if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tm_c, device_param->opencl_d_bfs_c, 0, 0, size_tm, 0, NULL, NULL) == -1) return -1;
+  device_param->salt_batch_pws_cnt = pws_cnt;
 
-            if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
-          }
-        }
-      }
-    }
+  device_param->kernel_param.salt_batch_pws = SALT_BATCH_PWS_NONE;
 
-    if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
-    {
-      // this is not perfectly right, only in case algorithm has to add 0x80 (most of the cases for fast optimized kernels)
+  if (device_param->salt_batch == false) return 1;
 
-      if (highest_pw_len < 16)
-      {
-        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
-      }
-      else if (highest_pw_len < 32)
-      {
-        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
-      }
-      else
-      {
-        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_3, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
-      }
-    }
-    else
-    {
-      if (run_kernel (hashcat_ctx, device_param, KERN_RUN_4, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
-    }
-  }
-  else
-  {
-    // innerloop prediction to get a speed estimation is hard, because we don't know in advance how much
-    // time the different kernels take and if their weightnings are equally distributed.
-    // - for instance, a regular _loop kernel is likely to be the slowest, but _loop2 kernel can also be slow.
-    //   in fact, _loop2 can be even slower (see iTunes backup >= 10.0).
-    // - hooks can have a large influence depending on the OS.
-    //   spawning threads and memory allocations take a lot of time on windows (compared to linux).
-    // - the kernel execution can take shortcuts based on intermediate values
-    //   while these intermediate values depend on input values.
-    // - if we measure runtimes of different kernels to find out about their weightning
-    //   we need to call them with real input values otherwise we miss the shortcuts inside the kernel.
-    // - the problem is that these real input values could crack the hash which makes the chaos perfect.
-    //
-    // so the innerloop prediction is not perfectly accurate, because we:
-    //
-    // 1. completely ignore hooks and the time they take.
-    // 2. assume that the code in _loop and _loop2 is similar,
-    //    but we respect the different iteration counts in _loop and _loop2.
-    // 3. ignore _comp kernel runtimes (probably irrelevant).
-    //
-    // as soon as the first restore checkpoint is reached the prediction is accurate.
-    // also the closer it gets to that point.
+  if (pws_cnt == 0) return 1;
 
-    /* workflow overview:
+  if (hashes->salts_shown[salt_pos] == 1) return 1;
 
-      ATTACK_EXEC_OUTSIDE_KERNEL:
-        COPY_AMPLIFIER_MATERIAL
-        RUN_AMPLIFIER
-        RUN_UTF16_CONVERT
-        RUN_INIT
-        COPY_HOOK_DATA_TO_HOST
-        CALL_HOOK12
-        COPY_HOOK_DATA_TO_DEVICE
-        SALT_REPEATS (default 1):
-          RUN_PREPARE
-          ITER_REPEATS:
-            RUN_LOOP
-            RUN_EXTENTED
-          COPY_BRIDGE_MATERIAL_TO_HOST
-          BRIDGE_LOOP
-          COPY_BRIDGE_MATERIAL_TO_DEVICE
-          COPY_HOOK_DATA_TO_HOST
-          CALL_HOOK23
-          COPY_HOOK_DATA_TO_DEVICE
-        RUN_INIT2
-        SALT_REPEATS (default 1):
-          RUN_PREPARE2
-          ITER2_REPEATS:
-            RUN_LOOP2
-          COPY_BRIDGE_MATERIAL_TO_HOST
-          BRIDGE_LOOP2
-          COPY_BRIDGE_MATERIAL_TO_DEVICE
-        DEEP_COMP_KERNEL:
-          RUN_AUX1/2/3/4
-        RUN_COMP
-        CLEAN_HOOK_DATA
-    */
+  const u64 kernel_threads = MAX (device_param->kernel_threads, 1);
 
-    if (true)
-    {
-      if (device_param->is_cuda == true)
-      {
-        if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_pws_buf, device_param->cuda_d_pws_amp_buf, pws_cnt * sizeof (pw_t)) == -1) return -1;
-      }
+  const u64 salt_batch_pws = CEILDIV (pws_cnt, kernel_threads) * kernel_threads;
 
-      if (device_param->is_hip == true)
-      {
-        if (hc_hipMemcpyDtoD (hashcat_ctx, device_param->hip_d_pws_buf, device_param->hip_d_pws_amp_buf, pws_cnt * sizeof (pw_t)) == -1) return -1;
-      }
+  const u64 salt_batch_max = device_param->kernel_power / salt_batch_pws;
 
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
-      {
-        if (hc_mtlMemcpyDtoD (hashcat_ctx, device_param->metal_command_queue, device_param->metal_d_pws_buf, 0, device_param->metal_d_pws_amp_buf, 0, pws_cnt * sizeof (pw_t)) == -1) return -1;
-      }
-      #endif
+  const salt_t *salt_buf = &hashes->salts_buf[salt_pos];
 
-      if (device_param->is_opencl == true)
-      {
-        if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_amp_buf, device_param->opencl_d_pws_buf, 0, 0, pws_cnt * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
-      }
+  u32 salt_batch = 1;
 
-      if (user_options->slow_candidates == true)
-      {
-      }
-      else
-      {
-        if (run_kernel_amp (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
-      }
+  // all salts of a launch share the same loop structure
 
-      if (hashconfig->opts_type & OPTS_TYPE_POST_AMP_UTF16LE)
-      {
-        if (device_param->is_cuda == true)
-        {
-          if (run_cuda_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->cuda_d_pws_buf, pws_cnt) == -1) return -1;
-        }
+  while ((salt_batch < salt_batch_max) && ((salt_pos + salt_batch) < salts_cnt))
+  {
+    const salt_t *salt_next = &hashes->salts_buf[salt_pos + salt_batch];
 
-        if (device_param->is_hip == true)
-        {
-          if (run_hip_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->hip_d_pws_buf, pws_cnt) == -1) return -1;
-        }
+    if (hashes->salts_shown[salt_pos + salt_batch] == 1) break;
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          if (run_metal_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->metal_d_pws_buf, pws_cnt) == -1) return -1;
-        }
-        #endif
+    if (salt_next->salt_iter    != salt_buf->salt_iter)    break;
+    if (salt_next->salt_iter2   != salt_buf->salt_iter2)   break;
+    if (salt_next->salt_repeats != salt_buf->salt_repeats) break;
 
-        if (device_param->is_opencl == true)
-        {
-          if (run_opencl_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->opencl_d_pws_buf, pws_cnt) == -1) return -1;
-        }
-      }
+    salt_batch++;
+  }
 
-      if (hashconfig->opts_type & OPTS_TYPE_INIT)
-      {
-        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
-      }
+  if (salt_batch > 1) device_param->kernel_param.salt_batch_pws = (u32) salt_batch_pws;
 
-      if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
-      {
-        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_12, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+  return salt_batch;
+}
 
-        if (device_param->is_cuda == true)
-        {
-          if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->cuda_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
+static void salt_batch_rejected (hashcat_ctx_t *hashcat_ctx, const u32 salt_pos, const u32 salt_batch, const u64 rejected)
+{
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
 
-          if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
-        }
+  // combs_fill() accounts the rejected right-hand words to the first salt of the launch only
 
-        if (device_param->is_hip == true)
-        {
-          if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->hip_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
+  for (u32 salt_idx = salt_pos + 1; salt_idx < salt_pos + salt_batch; salt_idx++)
+  {
+    status_ctx->words_progress_rejected[salt_idx] += rejected;
+  }
+}
 
-          if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
-        }
+static int salt_batch_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 dst, const u64 cnt)
+{
+  const u64 offset = dst * sizeof (pw_t);
+  const u64 size   = cnt * sizeof (pw_t);
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->hooks_buf, device_param->metal_d_hooks, 0, pws_cnt * hashconfig->hook_size) == -1) return -1;
-        }
-        #endif
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_pws_buf + offset, device_param->cuda_d_pws_buf, size) == -1) return -1;
+  }
 
-        if (device_param->is_opencl == true)
-        {
-          /* blocking */
-          if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
-        }
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemcpyDtoD (hashcat_ctx, device_param->hip_d_pws_buf + offset, device_param->hip_d_pws_buf, size) == -1) return -1;
+  }
 
-        const int hook_threads = (int) user_options->hook_threads;
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (hc_mtlMemcpyDtoD (hashcat_ctx, device_param->metal_command_queue, device_param->metal_d_pws_buf, offset, device_param->metal_d_pws_buf, 0, size) == -1) return -1;
+  }
+  #endif
 
-        hook_thread_param_t *hook_threads_param = (hook_thread_param_t *) hcmalloc (hook_threads * sizeof (hook_thread_param_t));
-        hc_thread_t         *c_threads          = (hc_thread_t *)         hcmalloc (hook_threads * sizeof (hc_thread_t));
+  if (device_param->is_opencl == true)
+  {
+    if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, device_param->opencl_d_pws_buf, 0, offset, size, 0, NULL, NULL) == -1) return -1;
+  }
 
-        for (int i = 0; i < hook_threads; i++)
-        {
-          hook_thread_param_t *hook_thread_param = hook_threads_param + i;
+  return 0;
+}
 
-          hook_thread_param->tid = i;
-          hook_thread_param->tsz = hook_threads;
+static int salt_batch_replicate (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  const u64 pws_cnt        = device_param->salt_batch_pws_cnt;
+  const u64 salt_batch_pws = device_param->kernel_param.salt_batch_pws;
+  const u64 pws_cnt_batch  = salt_batch_pws * device_param->salt_batch_cnt;
 
-          hook_thread_param->module_ctx = module_ctx;
-          hook_thread_param->status_ctx = status_ctx;
+  // the copies never overlap their source, so both passes double the filled area
 
-          hook_thread_param->device_param = device_param;
+  for (u64 filled = pws_cnt; filled < salt_batch_pws; filled *= 2)
+  {
+    if (salt_batch_copy (hashcat_ctx, device_param, filled, MIN (filled, salt_batch_pws - filled)) == -1) return -1;
+  }
 
-          hook_thread_param->hook_extra_param = module_ctx->hook_extra_params[i];
-          hook_thread_param->hook_salts_buf = hashes->hook_salts_buf;
+  for (u64 filled = salt_batch_pws; filled < pws_cnt_batch; filled *= 2)
+  {
+    if (salt_batch_copy (hashcat_ctx, device_param, filled, MIN (filled, pws_cnt_batch - filled)) == -1) return -1;
+  }
 
-          hook_thread_param->salt_pos = salt_pos;
+  return 0;
+}
 
-          hook_thread_param->pws_cnt = pws_cnt;
+/**
+ * bridge material
+ *
+ * tmps[] lives on the device, bridges work on the host copy in h_tmps.
+ * The copies are done on demand, so a bridge which covers consecutive stages (for instance init, loop and comp)
+ * keeps working on the host copy without a round trip to the device in between.
+ */
 
-          hc_thread_create (c_threads[i], hook12_thread, hook_thread_param);
-        }
+int copy_bridge_material_to_host (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
 
-        hc_thread_wait (hook_threads, c_threads);
+  if (device_param->bridge_tmps_on_host == true) return 0;
 
-        hcfree (c_threads);
-        hcfree (hook_threads_param);
+  const u64 size_tmps = pws_cnt * hashconfig->tmp_size;
 
-        if (device_param->is_cuda == true)
-        {
-          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-        }
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->cuda_d_tmps, size_tmps) == -1) return -1;
 
-        if (device_param->is_hip == true)
-        {
-          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-        }
+    if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+  }
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_hooks, 0, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-        }
-        #endif
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->hip_d_tmps, size_tmps) == -1) return -1;
 
-        if (device_param->is_opencl == true)
-        {
-          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
-        }
-      }
-    }
+    if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
+  }
 
-    if (true)
-    {
-      const u32 salt_repeats = hashes->salts_buf[salt_pos].salt_repeats;
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->h_tmps, device_param->metal_d_tmps, 0, size_tmps) == -1) return -1;
+  }
+  #endif
 
-      for (u32 salt_repeat = 0; salt_repeat <= salt_repeats; salt_repeat++)
-      {
-        device_param->kernel_param.salt_repeat = salt_repeat;
+  if (device_param->is_opencl == true)
+  {
+    /* blocking */
+    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, size_tmps, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
+  }
 
-        if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
-        {
-          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2P, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
-        }
+  device_param->bridge_tmps_on_host = true;
 
-        if (true)
-        {
-          const u32 iter = hashes->salts_buf[salt_pos].salt_iter;
+  return 0;
+}
 
-          const u32 loop_step = device_param->kernel_loops;
+int copy_bridge_material_to_device (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
 
-          for (u32 loop_pos = 0, slow_iteration = 0; loop_pos < iter; loop_pos += loop_step, slow_iteration++)
-          {
-            u32 loop_left = iter - loop_pos;
+  if (device_param->bridge_tmps_on_host == false) return 0;
 
-            loop_left = MIN (loop_left, loop_step);
+  const u64 size_tmps = pws_cnt * hashconfig->tmp_size;
 
-            device_param->kernel_param.loop_pos = loop_pos;
-            device_param->kernel_param.loop_cnt = loop_left;
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_tmps, device_param->h_tmps, size_tmps) == -1) return -1;
 
-            if (hashconfig->opts_type & OPTS_TYPE_LOOP)
-            {
-              if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2, pws_pos, pws_cnt, true, slow_iteration, is_autotune) == -1) return -1;
-            }
+    if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+  }
 
-            if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
-            {
-              if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2E, pws_pos, pws_cnt, true, slow_iteration, is_autotune) == -1) return -1;
-            }
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_tmps, device_param->h_tmps, size_tmps) == -1) return -1;
 
-            //bug?
-            //while (status_ctx->run_thread_level2 == false) break;
-            if (status_ctx->run_thread_level2 == false) break;
+    if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
+  }
 
-            /**
-             * speed
-             */
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_tmps, 0, device_param->h_tmps, size_tmps) == -1) return -1;
+  }
+  #endif
 
-            const u32 iter1r = hashes->salts_buf[salt_pos].salt_iter  * (salt_repeats + 1);
-            const u32 iter2r = hashes->salts_buf[salt_pos].salt_iter2 * (salt_repeats + 1);
+  if (device_param->is_opencl == true)
+  {
+    /* blocking */
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, size_tmps, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
+  }
 
-            const double iter_part = (double) ((iter * salt_repeat) + loop_pos + loop_left) / (double) (iter1r + iter2r);
+  device_param->bridge_tmps_on_host = false;
 
-            const u64 perf_sum_all = (u64) (pws_cnt * iter_part);
+  return 0;
+}
 
-            double speed_msec = hc_timer_get (device_param->timer_speed);
+int copy_bridge_candidates_to_host (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt)
+{
+  // the candidates are final only after the amplifier and the utf16le conversion ran on the device
 
-            const u32 speed_pos = device_param->speed_pos;
+  const u64 size_pws = pws_cnt * sizeof (pw_t);
 
-            device_param->speed_cnt[speed_pos] = perf_sum_all;
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->h_pws, device_param->cuda_d_pws_buf, size_pws) == -1) return -1;
 
-            device_param->speed_msec[speed_pos] = speed_msec;
+    if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+  }
 
-            if (user_options->speed_only == true)
-            {
-              if (speed_msec > 4000)
-              {
-                device_param->outerloop_multi *= 1 / iter_part;
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->h_pws, device_param->hip_d_pws_buf, size_pws) == -1) return -1;
 
-                device_param->speed_pos = 1;
+    if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
+  }
 
-                device_param->speed_only_finish = true;
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->h_pws, device_param->metal_d_pws_buf, 0, size_pws) == -1) return -1;
+  }
+  #endif
 
-                return 0;
-              }
-            }
-          }
+  if (device_param->is_opencl == true)
+  {
+    /* blocking */
+    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_buf, CL_TRUE, 0, size_pws, device_param->h_pws, 0, NULL, NULL) == -1) return -1;
+  }
 
-          if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP)
-          {
-            if (device_param->is_cuda == true)
-            {
-              if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->cuda_d_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+  return 0;
+}
 
-              if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
-            }
+int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 highest_pw_len, const u64 pws_pos, const u64 pws_cnt, const u32 fast_iteration, const u32 salt_pos, const bool is_autotune)
+{
+  bridge_ctx_t   *bridge_ctx   = hashcat_ctx->bridge_ctx;
+  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  hashes_t       *hashes       = hashcat_ctx->hashes;
+  module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
+  user_options_t *user_options = hashcat_ctx->user_options;
 
-            if (device_param->is_hip == true)
-            {
-              if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->hip_d_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+  if (user_options->stdout_flag == true)
+  {
+    return process_stdout (hashcat_ctx, device_param, pws_cnt);
+  }
 
-              if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
-            }
+  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+  {
+    if (user_options->attack_mode == ATTACK_MODE_BF)
+    {
+      if (user_options->slow_candidates == true)
+      {
+      }
+      else
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          const u32 size_tm = device_param->size_tm;
 
-            #if defined (__APPLE__)
-            if (device_param->is_metal == true)
-            {
-              if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->h_tmps, device_param->metal_d_tmps, 0, pws_cnt * hashconfig->tmp_size) == -1) return -1;
-            }
-            #endif
+          if (device_param->is_cuda == true)
+          {
+            if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tm_c, size_tm) == -1) return -1;
+          }
 
-            if (device_param->is_opencl == true)
-            {
-              /* blocking */
-              if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, pws_cnt * hashconfig->tmp_size, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
-            }
+          if (device_param->is_hip == true)
+          {
+            if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tm_c, size_tm) == -1) return -1;
+          }
 
-            if (bridge_ctx->launch_loop (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
+          #if defined (__APPLE__)
+          if (device_param->is_metal == true)
+          {
+            if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tm_c, size_tm) == -1) return -1;
+          }
+          #endif
 
-            if (device_param->is_cuda == true)
-            {
-              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_tmps, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+          if (device_param->is_opencl == true)
+          {
+            if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tm_c, size_tm) == -1) return -1;
+          }
 
-              if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
-            }
+          if (run_kernel_tm (hashcat_ctx, device_param) == -1) return -1;
 
-            if (device_param->is_hip == true)
-            {
-              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_tmps, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+          if (device_param->is_cuda == true)
+          {
+            if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_bfs_c, device_param->cuda_d_tm_c, size_tm) == -1) return -1;
+          }
 
-              if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
-            }
+          if (device_param->is_hip == true)
+          {
+            if (hc_hipMemcpyDtoD (hashcat_ctx, device_param->hip_d_bfs_c, device_param->hip_d_tm_c, size_tm) == -1) return -1;
+          }
 
-            #if defined (__APPLE__)
-            if (device_param->is_metal == true)
-            {
-              if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_tmps, 0, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
-            }
-            #endif
+          #if defined (__APPLE__)
+          if (device_param->is_metal == true)
+          {
+            if (hc_mtlMemcpyDtoD (hashcat_ctx, device_param->metal_command_queue, device_param->metal_d_bfs_c, 0, device_param->metal_d_tm_c, 0, size_tm) == -1) return -1;
+          }
+          #endif
 
-            if (device_param->is_opencl == true)
-            {
-              /* blocking */
-              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, pws_cnt * hashconfig->tmp_size, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
-            }
+          if (device_param->is_opencl == true)
+          {
+            if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tm_c, device_param->opencl_d_bfs_c, 0, 0, size_tm, 0, NULL, NULL) == -1) return -1;
 
-            //bug?
-            //while (status_ctx->run_thread_level2 == false) break;
-            if (status_ctx->run_thread_level2 == false) break;
+            if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
+          }
+        }
+      }
+    }
 
-            /**
-             * speed
-             */
+    if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+    {
+      // this is not perfectly right, only in case algorithm has to add 0x80 (most of the cases for fast optimized kernels)
 
-            const u64 perf_sum_all = (u64) (pws_cnt);
+      if (highest_pw_len < 16)
+      {
+        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
+      }
+      else if (highest_pw_len < 32)
+      {
+        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
+      }
+      else
+      {
+        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_3, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
+      }
+    }
+    else
+    {
+      if (run_kernel (hashcat_ctx, device_param, KERN_RUN_4, pws_pos, pws_cnt, true, fast_iteration, is_autotune) == -1) return -1;
+    }
+  }
+  else
+  {
+    // innerloop prediction to get a speed estimation is hard, because we don't know in advance how much
+    // time the different kernels take and if their weightnings are equally distributed.
+    // - for instance, a regular _loop kernel is likely to be the slowest, but _loop2 kernel can also be slow.
+    //   in fact, _loop2 can be even slower (see iTunes backup >= 10.0).
+    // - hooks can have a large influence depending on the OS.
+    //   spawning threads and memory allocations take a lot of time on windows (compared to linux).
+    // - the kernel execution can take shortcuts based on intermediate values
+    //   while these intermediate values depend on input values.
+    // - if we measure runtimes of different kernels to find out about their weightning
+    //   we need to call them with real input values otherwise we miss the shortcuts inside the kernel.
+    // - the problem is that these real input values could crack the hash which makes the chaos perfect.
+    //
+    // so the innerloop prediction is not perfectly accurate, because we:
+    //
+    // 1. completely ignore hooks and the time they take.
+    // 2. assume that the code in _loop and _loop2 is similar,
+    //    but we respect the different iteration counts in _loop and _loop2.
+    // 3. ignore _comp kernel runtimes (probably irrelevant).
+    //
+    // as soon as the first restore checkpoint is reached the prediction is accurate.
+    // also the closer it gets to that point.
 
-            double speed_msec = hc_timer_get (device_param->timer_speed);
+    /* workflow overview:
 
-            const u32 speed_pos = device_param->speed_pos;
+      ATTACK_EXEC_OUTSIDE_KERNEL:
+        COPY_AMPLIFIER_MATERIAL
+        RUN_AMPLIFIER
+        RUN_UTF16_CONVERT
+        RUN_INIT
+        COPY_BRIDGE_CANDIDATES_TO_HOST
+        BRIDGE_INIT
+        COPY_HOOK_DATA_TO_HOST
+        CALL_HOOK12
+        COPY_HOOK_DATA_TO_DEVICE
+        SALT_REPEATS (default 1):
+          RUN_PREPARE
+          ITER_REPEATS:
+            RUN_LOOP
+            RUN_EXTENTED
+          COPY_BRIDGE_MATERIAL_TO_HOST
+          BRIDGE_LOOP
+          COPY_BRIDGE_MATERIAL_TO_DEVICE
+          COPY_HOOK_DATA_TO_HOST
+          CALL_HOOK23
+          COPY_HOOK_DATA_TO_DEVICE
+        RUN_INIT2
+        SALT_REPEATS (default 1):
+          RUN_PREPARE2
+          ITER2_REPEATS:
+            RUN_LOOP2
+          COPY_BRIDGE_MATERIAL_TO_HOST
+          BRIDGE_LOOP2
+          COPY_BRIDGE_MATERIAL_TO_DEVICE
+        DEEP_COMP_KERNEL:
+          RUN_AUX1/2/3/4
+        RUN_COMP
+        COPY_BRIDGE_MATERIAL_TO_HOST
+        BRIDGE_COMP
+        CLEAN_HOOK_DATA
 
-            device_param->speed_cnt[speed_pos] = perf_sum_all;
+      COPY_BRIDGE_MATERIAL_* copies tmps[] only if the other side holds a newer version,
+      see copy_bridge_material_to_host()
+    */
 
-            device_param->speed_msec[speed_pos] = speed_msec;
+    device_param->bridge_tmps_on_host = false;
 
-            if (user_options->speed_only == true)
-            {
-              if (speed_msec > 4000)
-              {
-                device_param->speed_pos = 1;
+    const u64 pws_cnt_batch = (device_param->salt_batch_cnt > 1) ? device_param->kernel_param.salt_batch_pws * device_param->salt_batch_cnt : pws_cnt;
 
-                device_param->speed_only_finish = true;
+    // the speed counts the real candidates of each salt in the batch, not the padding of the salt blocks
 
-                return 0;
-              }
-            }
-          }
+    const u64 pws_cnt_salts = pws_cnt * device_param->salt_batch_cnt;
 
-          if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
-          {
-            if (run_kernel (hashcat_ctx, device_param, KERN_RUN_23, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+    if (true)
+    {
+      if (device_param->is_cuda == true)
+      {
+        if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_pws_buf, device_param->cuda_d_pws_amp_buf, pws_cnt * sizeof (pw_t)) == -1) return -1;
+      }
 
-            if (device_param->is_cuda == true)
-            {
-              if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->cuda_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
+      if (device_param->is_hip == true)
+      {
+        if (hc_hipMemcpyDtoD (hashcat_ctx, device_param->hip_d_pws_buf, device_param->hip_d_pws_amp_buf, pws_cnt * sizeof (pw_t)) == -1) return -1;
+      }
 
-              if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
-            }
+      #if defined (__APPLE__)
+      if (device_param->is_metal == true)
+      {
+        if (hc_mtlMemcpyDtoD (hashcat_ctx, device_param->metal_command_queue, device_param->metal_d_pws_buf, 0, device_param->metal_d_pws_amp_buf, 0, pws_cnt * sizeof (pw_t)) == -1) return -1;
+      }
+      #endif
 
-            if (device_param->is_hip == true)
-            {
-              if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->hip_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
+      if (device_param->is_opencl == true)
+      {
+        if (hc_clEnqueueCopyBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_amp_buf, device_param->opencl_d_pws_buf, 0, 0, pws_cnt * sizeof (pw_t), 0, NULL, NULL) == -1) return -1;
+      }
 
-              if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
-            }
+      if (user_options->slow_candidates == true)
+      {
+      }
+      else
+      {
+        if (run_kernel_amp (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+      }
 
-            #if defined (__APPLE__)
-            if (device_param->is_metal == true)
-            {
-              if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->hooks_buf, device_param->metal_d_hooks, 0, pws_cnt * hashconfig->hook_size) == -1) return -1;
-            }
-            #endif
+      if (hashconfig->opts_type & OPTS_TYPE_POST_AMP_UTF16LE)
+      {
+        if (device_param->is_cuda == true)
+        {
+          if (run_cuda_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->cuda_d_pws_buf, pws_cnt) == -1) return -1;
+        }
 
-            if (device_param->is_opencl == true)
-            {
-              /* blocking */
-              if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
-            }
+        if (device_param->is_hip == true)
+        {
+          if (run_hip_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->hip_d_pws_buf, pws_cnt) == -1) return -1;
+        }
 
-            const int hook_threads = (int) user_options->hook_threads;
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          if (run_metal_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->metal_d_pws_buf, pws_cnt) == -1) return -1;
+        }
+        #endif
 
-            hook_thread_param_t *hook_threads_param = (hook_thread_param_t *) hcmalloc (hook_threads * sizeof (hook_thread_param_t));
-            hc_thread_t         *c_threads          = (hc_thread_t *)         hcmalloc (hook_threads * sizeof (hc_thread_t));
+        if (device_param->is_opencl == true)
+        {
+          if (run_opencl_kernel_utf8toutf16le (hashcat_ctx, device_param, device_param->opencl_d_pws_buf, pws_cnt) == -1) return -1;
+        }
+      }
 
-            for (int i = 0; i < hook_threads; i++)
-            {
-              hook_thread_param_t *hook_thread_param = hook_threads_param + i;
+      // the candidates of a multi-salt launch are replicated once per salt, see salt_batch_size()
 
-              hook_thread_param->tid = i;
-              hook_thread_param->tsz = hook_threads;
+      if (device_param->salt_batch_cnt > 1)
+      {
+        if (salt_batch_replicate (hashcat_ctx, device_param) == -1) return -1;
+      }
 
-              hook_thread_param->module_ctx = module_ctx;
-              hook_thread_param->status_ctx = status_ctx;
+      if (hashconfig->opts_type & OPTS_TYPE_INIT)
+      {
+        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, pws_pos, pws_cnt_batch, false, 0, is_autotune) == -1) return -1;
+      }
 
-              hook_thread_param->device_param = device_param;
+      if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_INIT)
+      {
+        if (copy_bridge_candidates_to_host (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
 
-              hook_thread_param->hook_extra_param = module_ctx->hook_extra_params[i];
-              hook_thread_param->hook_salts_buf = hashes->hook_salts_buf;
+        // without the init kernel, the bridge creates tmps[] from scratch
 
-              hook_thread_param->salt_pos = salt_pos;
+        if (hashconfig->opts_type & OPTS_TYPE_INIT)
+        {
+          if (copy_bridge_material_to_host (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+        }
 
-              hook_thread_param->pws_cnt = pws_cnt;
+        if (bridge_ctx->launch_init (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
 
-              hc_thread_create (c_threads[i], hook23_thread, hook_thread_param);
-            }
+        device_param->bridge_tmps_on_host = true;
+      }
 
-            hc_thread_wait (hook_threads, c_threads);
+      if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+      {
+        if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
 
-            hcfree (c_threads);
-            hcfree (hook_threads_param);
+        if (run_kernel (hashcat_ctx, device_param, KERN_RUN_12, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
 
-            if (device_param->is_cuda == true)
-            {
-              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-            }
+        if (device_param->is_cuda == true)
+        {
+          if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->cuda_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
 
-            if (device_param->is_hip == true)
-            {
-              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-            }
+          if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+        }
 
-            #if defined (__APPLE__)
-            if (device_param->is_metal == true)
-            {
-              if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_hooks, 0, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
-            }
-            #endif
+        if (device_param->is_hip == true)
+        {
+          if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->hip_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
 
-            if (device_param->is_opencl == true)
-            {
-              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
-            }
-          }
+          if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
         }
-      }
-    }
 
-    // note: they also do not influence the performance screen
-    // in case you want to use this, this cane make sense only if your input data comes out of tmps[]
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->hooks_buf, device_param->metal_d_hooks, 0, pws_cnt * hashconfig->hook_size) == -1) return -1;
+        }
+        #endif
 
-    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
-    {
-      if (run_kernel (hashcat_ctx, device_param, KERN_RUN_INIT2, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+        if (device_param->is_opencl == true)
+        {
+          /* blocking */
+          if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
+        }
+
+        const double trace_ts_hook12 = trace_begin (hashcat_ctx);
+
+        hook_pool_run (hashcat_ctx, device_param, OPTS_TYPE_HOOK12, salt_pos, pws_cnt);
+
+        trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "hook12", trace_ts_hook12);
+
+        if (device_param->is_cuda == true)
+        {
+          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
+        }
+
+        if (device_param->is_hip == true)
+        {
+          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
+        }
+
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_hooks, 0, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
+        }
+        #endif
+
+        if (device_param->is_opencl == true)
+        {
+          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
+        }
+      }
     }
 
     if (true)
@@ -1767,16 +1959,21 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
       {
         device_param->kernel_param.salt_repeat = salt_repeat;
 
-        if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+        if (hashconfig->opts_type & (OPTS_TYPE_LOOP_PREPARE | OPTS_TYPE_LOOP | OPTS_TYPE_LOOP_EXTENDED))
         {
-          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_LOOP2P, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+          if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
         }
 
-        if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
         {
-          u32 iter = hashes->salts_buf[salt_pos].salt_iter2;
+          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2P, pws_pos, pws_cnt_batch, false, 0, is_autotune) == -1) return -1;
+        }
 
-          u32 loop_step = device_param->kernel_loops;
+        if (true)
+        {
+          const u32 iter = hashes->salts_buf[salt_pos].salt_iter;
+
+          const u32 loop_step = device_param->kernel_loops;
 
           for (u32 loop_pos = 0, slow_iteration = 0; loop_pos < iter; loop_pos += loop_step, slow_iteration++)
           {
@@ -1787,7 +1984,15 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             device_param->kernel_param.loop_pos = loop_pos;
             device_param->kernel_param.loop_cnt = loop_left;
 
-            if (run_kernel (hashcat_ctx, device_param, KERN_RUN_LOOP2, pws_pos, pws_cnt, true, slow_iteration, is_autotune) == -1) return -1;
+            if (hashconfig->opts_type & OPTS_TYPE_LOOP)
+            {
+              if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2, pws_pos, pws_cnt_batch, true, slow_iteration, is_autotune) == -1) return -1;
+            }
+
+            if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+            {
+              if (run_kernel (hashcat_ctx, device_param, KERN_RUN_2E, pws_pos, pws_cnt_batch, true, slow_iteration, is_autotune) == -1) return -1;
+            }
 
             //bug?
             //while (status_ctx->run_thread_level2 == false) break;
@@ -1800,9 +2005,9 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             const u32 iter1r = hashes->salts_buf[salt_pos].salt_iter  * (salt_repeats + 1);
             const u32 iter2r = hashes->salts_buf[salt_pos].salt_iter2 * (salt_repeats + 1);
 
-            const double iter_part = (double) (iter1r + (iter * salt_repeat) + loop_pos + loop_left) / (double) (iter1r + iter2r);
+            const double iter_part = (double) ((iter * salt_repeat) + loop_pos + loop_left) / (double) (iter1r + iter2r);
 
-            const u64 perf_sum_all = (u64) (pws_cnt * iter_part);
+            const u64 perf_sum_all = (u64) (pws_cnt_salts * iter_part);
 
             double speed_msec = hc_timer_get (device_param->timer_speed);
 
@@ -1811,20 +2016,75 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             device_param->speed_cnt[speed_pos] = perf_sum_all;
 
             device_param->speed_msec[speed_pos] = speed_msec;
+
+            if (user_options->speed_only == true)
+            {
+              if (speed_msec > 4000)
+              {
+                device_param->outerloop_multi *= 1 / iter_part;
+
+                device_param->speed_pos = 1;
+
+                device_param->speed_only_finish = true;
+
+                return 0;
+              }
+            }
           }
 
-          if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP2)
+          if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP)
+          {
+            if (copy_bridge_material_to_host (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+
+            if (bridge_ctx->launch_loop (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
+
+            //bug?
+            //while (status_ctx->run_thread_level2 == false) break;
+            if (status_ctx->run_thread_level2 == false) break;
+
+            /**
+             * speed
+             */
+
+            const u64 perf_sum_all = (u64) (pws_cnt);
+
+            double speed_msec = hc_timer_get (device_param->timer_speed);
+
+            const u32 speed_pos = device_param->speed_pos;
+
+            device_param->speed_cnt[speed_pos] = perf_sum_all;
+
+            device_param->speed_msec[speed_pos] = speed_msec;
+
+            if (user_options->speed_only == true)
+            {
+              if (speed_msec > 4000)
+              {
+                device_param->speed_pos = 1;
+
+                device_param->speed_only_finish = true;
+
+                return 0;
+              }
+            }
+          }
+
+          if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
           {
+            if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+
+            if (run_kernel (hashcat_ctx, device_param, KERN_RUN_23, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+
             if (device_param->is_cuda == true)
             {
-              if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->cuda_d_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+              if (hc_cuMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->cuda_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
 
               if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
             }
 
             if (device_param->is_hip == true)
             {
-              if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->h_tmps, device_param->hip_d_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+              if (hc_hipMemcpyDtoH (hashcat_ctx, device_param->hooks_buf, device_param->hip_d_hooks, pws_cnt * hashconfig->hook_size) == -1) return -1;
 
               if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
             }
@@ -1832,51 +2092,134 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
             #if defined (__APPLE__)
             if (device_param->is_metal == true)
             {
-              if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->h_tmps, device_param->metal_d_tmps, 0, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+              if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->hooks_buf, device_param->metal_d_hooks, 0, pws_cnt * hashconfig->hook_size) == -1) return -1;
             }
             #endif
 
             if (device_param->is_opencl == true)
             {
               /* blocking */
-              if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, pws_cnt * hashconfig->tmp_size, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
+              if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
             }
 
-            if (bridge_ctx->launch_loop2 (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
+            const double trace_ts_hook23 = trace_begin (hashcat_ctx);
+
+            hook_pool_run (hashcat_ctx, device_param, OPTS_TYPE_HOOK23, salt_pos, pws_cnt);
+
+            trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "hook23", trace_ts_hook23);
 
             if (device_param->is_cuda == true)
             {
-              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_tmps, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
-
-              if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
             }
 
             if (device_param->is_hip == true)
             {
-              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_tmps, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
-
-              if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
+              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_hooks, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
             }
 
             #if defined (__APPLE__)
             if (device_param->is_metal == true)
             {
-              if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_tmps, 0, device_param->h_tmps, pws_cnt * hashconfig->tmp_size) == -1) return -1;
+              if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_hooks, 0, device_param->hooks_buf, pws_cnt * hashconfig->hook_size) == -1) return -1;
             }
             #endif
 
             if (device_param->is_opencl == true)
             {
-              /* blocking */
-              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_tmps, CL_TRUE, 0, pws_cnt * hashconfig->tmp_size, device_param->h_tmps, 0, NULL, NULL) == -1) return -1;
+              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_hooks, CL_TRUE, 0, pws_cnt * hashconfig->hook_size, device_param->hooks_buf, 0, NULL, NULL) == -1) return -1;
             }
           }
         }
       }
     }
 
+    // note: they also do not influence the performance screen
+    // in case you want to use this, this cane make sense only if your input data comes out of tmps[]
+
+    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+    {
+      if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+
+      if (run_kernel (hashcat_ctx, device_param, KERN_RUN_INIT2, pws_pos, pws_cnt_batch, false, 0, is_autotune) == -1) return -1;
+    }
+
+    if (true)
+    {
+      const u32 salt_repeats = hashes->salts_buf[salt_pos].salt_repeats;
+
+      for (u32 salt_repeat = 0; salt_repeat <= salt_repeats; salt_repeat++)
+      {
+        device_param->kernel_param.salt_repeat = salt_repeat;
+
+        if (hashconfig->opts_type & (OPTS_TYPE_LOOP2_PREPARE | OPTS_TYPE_LOOP2))
+        {
+          if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+        }
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+        {
+          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_LOOP2P, pws_pos, pws_cnt_batch, false, 0, is_autotune) == -1) return -1;
+        }
+
+        if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
+        {
+          u32 iter = hashes->salts_buf[salt_pos].salt_iter2;
+
+          u32 loop_step = device_param->kernel_loops;
+
+          for (u32 loop_pos = 0, slow_iteration = 0; loop_pos < iter; loop_pos += loop_step, slow_iteration++)
+          {
+            u32 loop_left = iter - loop_pos;
+
+            loop_left = MIN (loop_left, loop_step);
+
+            device_param->kernel_param.loop_pos = loop_pos;
+            device_param->kernel_param.loop_cnt = loop_left;
+
+            if (run_kernel (hashcat_ctx, device_param, KERN_RUN_LOOP2, pws_pos, pws_cnt_batch, true, slow_iteration, is_autotune) == -1) return -1;
+
+            //bug?
+            //while (status_ctx->run_thread_level2 == false) break;
+            if (status_ctx->run_thread_level2 == false) break;
+
+            /**
+             * speed
+             */
+
+            const u32 iter1r = hashes->salts_buf[salt_pos].salt_iter  * (salt_repeats + 1);
+            const u32 iter2r = hashes->salts_buf[salt_pos].salt_iter2 * (salt_repeats + 1);
+
+            const double iter_part = (double) (iter1r + (iter * salt_repeat) + loop_pos + loop_left) / (double) (iter1r + iter2r);
+
+            const u64 perf_sum_all = (u64) (pws_cnt_salts * iter_part);
+
+            double speed_msec = hc_timer_get (device_param->timer_speed);
+
+            const u32 speed_pos = device_param->speed_pos;
+
+            device_param->speed_cnt[speed_pos] = perf_sum_all;
+
+            device_param->speed_msec[speed_pos] = speed_msec;
+          }
+
+          if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP2)
+          {
+            if (copy_bridge_material_to_host (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+
+            if (bridge_ctx->launch_loop2 (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
+          }
+        }
+      }
+    }
+
     if (true)
     {
+      if (hashconfig->opts_type & (OPTS_TYPE_DEEP_COMP_KERNEL | OPTS_TYPE_COMP))
+      {
+        if (copy_bridge_material_to_device (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+      }
+
       if (hashconfig->opts_type & OPTS_TYPE_DEEP_COMP_KERNEL)
       {
         // module_ctx->module_deep_comp_kernel () would apply only on the first salt so we can't use it in -a 9 mode
@@ -1961,9 +2304,18 @@ int choose_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
       {
         if (hashconfig->opts_type & OPTS_TYPE_COMP)
         {
-          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_3, pws_pos, pws_cnt, false, 0, is_autotune) == -1) return -1;
+          if (run_kernel (hashcat_ctx, device_param, KERN_RUN_3, pws_pos, pws_cnt_batch, false, 0, is_autotune) == -1) return -1;
         }
       }
+
+      // cracks found by the bridge are picked up by check_cracked() from h_plain_bufs, see bridges_mark_hash()
+
+      if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_COMP)
+      {
+        if (copy_bridge_material_to_host (hashcat_ctx, device_param, pws_cnt) == -1) return -1;
+
+        if (bridge_ctx->launch_comp (bridge_ctx->platform_context, device_param, hashconfig, hashes, salt_pos, pws_cnt) == false) return -1;
+      }
     }
 
     /*
@@ -2020,22 +2372,26 @@ static void rebuild_pws_compressed_append (hc_device_param_t *device_param, cons
   // this function is used if we have to modify the compressed pws buffer in order to
   // append some data to each password candidate
 
-  u32      *tmp_pws_comp = (u32 *)      hcmalloc (device_param->size_pws_comp);
-  pw_idx_t *tmp_pws_idx  = (pw_idx_t *) hcmalloc (device_param->size_pws_idx);
+  // the buffers are rebuilt in place: a candidate never moves to a lower offset, so walking
+  // backwards from the new end of the buffer never overwrites a candidate not yet moved
+
+  u32 dst_off = 0;
 
-  for (u32 i = 0; i < pws_cnt; i++)
+  for (u64 i = 0; i < pws_cnt; i++)
   {
-    pw_idx_t *pw_idx_src = device_param->pws_idx + i;
-    pw_idx_t *pw_idx_dst = tmp_pws_idx + i;
+    const u32 dst_len = device_param->pws_idx[i].len + 1;
 
-    const u32 src_off = pw_idx_src->off;
-    const u32 src_len = pw_idx_src->len;
+    dst_off += ((dst_len + 3) & ~3) / 4; // round up to multiple of 4
+  }
 
-    u8 buf[256];
+  device_param->pws_idx[pws_cnt].off = dst_off;
 
-    memcpy (buf, device_param->pws_comp + src_off, src_len);
+  for (u64 i = pws_cnt; i > 0; i--)
+  {
+    pw_idx_t *pw_idx = device_param->pws_idx + i - 1;
 
-    buf[src_len] = chr;
+    const u32 src_off = pw_idx->off;
+    const u32 src_len = pw_idx->len;
 
     const u32 dst_len = src_len + 1;
 
@@ -2043,27 +2399,20 @@ static void rebuild_pws_compressed_append (hc_device_param_t *device_param, cons
 
     const u32 dst_pw_len4_cnt = dst_pw_len4 / 4;
 
-    pw_idx_dst->cnt = dst_pw_len4_cnt;
-    pw_idx_dst->len = src_len; // this is intentionally! src_len can not be dst_len, we dont want the kernel to think 0x80 is part of the password
+    dst_off -= dst_pw_len4_cnt;
 
-    u8 *dst = (u8 *) (tmp_pws_comp + pw_idx_dst->off);
+    u8 *dst = (u8 *) (device_param->pws_comp + dst_off);
 
-    memcpy (dst, buf, dst_len);
+    memmove (dst, device_param->pws_comp + src_off, src_len);
 
-    memset (dst + dst_len, 0, dst_pw_len4 - dst_len);
-
-    // prepare next element
+    dst[src_len] = chr;
 
-    pw_idx_t *pw_idx_dst_next = pw_idx_dst + 1;
+    memset (dst + dst_len, 0, dst_pw_len4 - dst_len);
 
-    pw_idx_dst_next->off = pw_idx_dst->off + pw_idx_dst->cnt;
+    pw_idx->off = dst_off;
+    pw_idx->cnt = dst_pw_len4_cnt;
+    pw_idx->len = src_len; // this is intentionally! src_len can not be dst_len, we dont want the kernel to think 0x80 is part of the password
   }
-
-  hcfree (device_param->pws_comp);
-  hcfree (device_param->pws_idx);
-
-  device_param->pws_comp = tmp_pws_comp;
-  device_param->pws_idx  = tmp_pws_idx;
 }
 
 int run_cuda_kernel_atinit (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, CUdeviceptr buf, const u64 num)
@@ -2516,11 +2865,37 @@ int run_opencl_kernel_bzero (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
   return 0;
 }
 
+static const char *kern_run_trace_name (const u32 kern_run)
+{
+  switch (kern_run)
+  {
+    case KERN_RUN_1:      return "kernel_1";
+    case KERN_RUN_12:     return "kernel_12";
+    case KERN_RUN_2P:     return "kernel_2p";
+    case KERN_RUN_2:      return "kernel_2";
+    case KERN_RUN_2E:     return "kernel_2e";
+    case KERN_RUN_23:     return "kernel_23";
+    case KERN_RUN_3:      return "kernel_3";
+    case KERN_RUN_4:      return "kernel_4";
+    case KERN_RUN_INIT2:  return "kernel_init2";
+    case KERN_RUN_LOOP2P: return "kernel_loop2p";
+    case KERN_RUN_LOOP2:  return "kernel_loop2";
+    case KERN_RUN_AUX1:   return "kernel_aux1";
+    case KERN_RUN_AUX2:   return "kernel_aux2";
+    case KERN_RUN_AUX3:   return "kernel_aux3";
+    case KERN_RUN_AUX4:   return "kernel_aux4";
+  }
+
+  return "kernel";
+}
+
 int run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 kern_run, const u64 pws_pos, const u64 num, const u32 event_update, const u32 iteration, const bool is_autotune)
 {
   const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
   const status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
 
+  const double trace_ts = trace_begin (hashcat_ctx);
+
   u64 kernel_threads = 0;
   u64 dynamic_shared_mem = 0;
 
@@ -3249,6 +3624,8 @@ int run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, con
     if (hc_clReleaseEvent (hashcat_ctx, opencl_event) == -1) return -1;
   }
 
+  trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, kern_run_trace_name (kern_run), trace_ts);
+
   return 0;
 }
 
@@ -3677,6 +4054,8 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
   user_options_t       *user_options        = hashcat_ctx->user_options;
   user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
 
+  const double trace_ts = trace_begin (hashcat_ctx);
+
   // init speed timer
 
   #if defined (_WIN)
@@ -3695,7 +4074,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
   {
     if (device_param->is_cuda == true)
     {
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+      if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->cuda_stream) == -1) return -1;
 
       const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3703,13 +4082,13 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
       if (off)
       {
-        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+        if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->cuda_stream) == -1) return -1;
       }
     }
 
     if (device_param->is_hip == true)
     {
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+      if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->hip_stream) == -1) return -1;
 
       const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3717,7 +4096,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
       if (off)
       {
-        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+        if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->hip_stream) == -1) return -1;
       }
     }
 
@@ -3739,7 +4118,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
     if (device_param->is_opencl == true)
     {
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
+      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_FALSE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
 
       const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3747,7 +4126,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
       if (off)
       {
-        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_TRUE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
+        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_FALSE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
       }
     }
 
@@ -3759,7 +4138,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
     {
       if (device_param->is_cuda == true)
       {
-        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+        if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->cuda_stream) == -1) return -1;
 
         const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3767,13 +4146,13 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
         if (off)
         {
-          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+          if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->cuda_stream) == -1) return -1;
         }
       }
 
       if (device_param->is_hip == true)
       {
-        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+        if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->hip_stream) == -1) return -1;
 
         const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3781,7 +4160,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
         if (off)
         {
-          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+          if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->hip_stream) == -1) return -1;
         }
       }
 
@@ -3803,7 +4182,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
       if (device_param->is_opencl == true)
       {
-        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
+        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_FALSE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
 
         const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3811,7 +4190,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
         if (off)
         {
-          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_TRUE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
+          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_FALSE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
         }
       }
 
@@ -3857,7 +4236,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
         if (device_param->is_cuda == true)
         {
-          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+          if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->cuda_stream) == -1) return -1;
 
           const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3865,13 +4244,13 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
           if (off)
           {
-            if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+            if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->cuda_stream) == -1) return -1;
           }
         }
 
         if (device_param->is_hip == true)
         {
-          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+          if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->hip_stream) == -1) return -1;
 
           const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3879,7 +4258,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
           if (off)
           {
-            if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+            if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->hip_stream) == -1) return -1;
           }
         }
 
@@ -3901,7 +4280,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
         if (device_param->is_opencl == true)
         {
-          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
+          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_FALSE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
 
           const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3909,7 +4288,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
           if (off)
           {
-            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_TRUE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
+            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_FALSE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
           }
         }
 
@@ -3921,7 +4300,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
         {
           if (device_param->is_cuda == true)
           {
-            if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+            if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->cuda_stream) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3929,13 +4308,13 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+              if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->cuda_stream) == -1) return -1;
             }
           }
 
           if (device_param->is_hip == true)
           {
-            if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+            if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->hip_stream) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3943,7 +4322,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+              if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->hip_stream) == -1) return -1;
             }
           }
 
@@ -3965,7 +4344,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
           if (device_param->is_opencl == true)
           {
-            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
+            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_FALSE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3973,7 +4352,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_TRUE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
+              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_FALSE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
             }
           }
 
@@ -3983,7 +4362,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
         {
           if (device_param->is_cuda == true)
           {
-            if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+            if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->cuda_stream) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -3991,13 +4370,13 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+              if (hc_cuMemcpyHtoDAsync (hashcat_ctx, device_param->cuda_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->cuda_stream) == -1) return -1;
             }
           }
 
           if (device_param->is_hip == true)
           {
-            if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t)) == -1) return -1;
+            if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_idx, device_param->pws_idx, pws_cnt * sizeof (pw_idx_t), device_param->hip_stream) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -4005,7 +4384,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32)) == -1) return -1;
+              if (hc_hipMemcpyHtoDAsync (hashcat_ctx, device_param->hip_d_pws_comp_buf, device_param->pws_comp, off * sizeof (u32), device_param->hip_stream) == -1) return -1;
             }
           }
 
@@ -4027,7 +4406,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
           if (device_param->is_opencl == true)
           {
-            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_TRUE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
+            if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_idx, CL_FALSE, 0, pws_cnt * sizeof (pw_idx_t), device_param->pws_idx, 0, NULL, NULL) == -1) return -1;
 
             const pw_idx_t *pw_idx = device_param->pws_idx + pws_cnt;
 
@@ -4035,7 +4414,7 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
             if (off)
             {
-              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_TRUE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
+              if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_pws_comp_buf, CL_FALSE, 0, off * sizeof (u32), device_param->pws_comp, 0, NULL, NULL) == -1) return -1;
             }
           }
 
@@ -4061,6 +4440,8 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
     }
   }
 
+  // the pws copies above are asynchronous, wait for them so the host is free to refill pws_comp and pws_idx once we return
+
   if (device_param->is_cuda == true)
   {
     if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
@@ -4080,12 +4461,307 @@ int run_copy (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const
 
   if (device_param->is_opencl == true)
   {
-    if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
+    if (hc_clFinish (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
   }
 
+  trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "run_copy", trace_ts);
+
   return 0;
 }
 
+/**
+ * right-hand wordlist of -a 1 and of pure -a 7
+ *
+ * Every salt walks through the whole right-hand wordlist again. Instead of reading and processing
+ * the file for each salt, it is processed once into combinator_ctx->combs_cache and replayed from memory.
+ * All devices share that image, only their position in it is per device.
+ * Wordlists which would need more than COMBS_CACHE_MAX are still read from combs_fp for each salt.
+ */
+
+#define COMBS_CACHE_MAX (256 * 1024 * 1024)
+#define COMBS_CACHE_HDR (sizeof (u32) + sizeof (u16))
+
+// returns the length of the processed candidate in *out_buf, -1 for skipped lines and -2 for lines rejected by the -k rule
+
+static int combs_line_process (hashcat_ctx_t *hashcat_ctx, const bool iconv_enabled, iconv_t iconv_ctx, char *iconv_tmp, char *rule_buf_out, char *line_buf, size_t line_len, char **out_buf)
+{
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const user_options_t       *user_options       = hashcat_ctx->user_options;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
+
+  if (line_len > PW_MAX) return -1;
+
+  char *line_buf_new = line_buf;
+
+  if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
+  {
+    if (line_len >= RP_PASSWORD_SIZE) return -1;
+
+    memset (rule_buf_out, 0, RP_PASSWORD_SIZE);
+
+    const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
+
+    if (rule_len_out < 0) return -2;
+
+    line_len = rule_len_out;
+
+    line_buf_new = rule_buf_out;
+  }
+
+  // do the on-the-fly encoding
+
+  if (iconv_enabled == true)
+  {
+    char  *iconv_ptr = iconv_tmp;
+    size_t iconv_sz  = HCBUFSIZ_TINY;
+
+    if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) return -1;
+
+    line_buf_new = iconv_tmp;
+    line_len     = HCBUFSIZ_TINY - iconv_sz;
+  }
+
+  line_len = MIN (line_len, PW_MAX);
+
+  if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
+  {
+    uppercase ((u8 *) line_buf_new, line_len);
+  }
+
+  *out_buf = line_buf_new;
+
+  return (int) line_len;
+}
+
+static void combs_cache_build (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const bool iconv_enabled, iconv_t iconv_ctx, char *iconv_tmp)
+{
+  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+
+  combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  HCFILE *combs_fp = &device_param->combs_fp;
+
+  hcfree (combs_cache->dictfile);
+  hcfree (combs_cache->buf);
+
+  memset (combs_cache, 0, sizeof (combs_cache_t));
+
+  combs_cache->dictfile = hcstrdup (combs_fp->path);
+
+  hc_rewind (combs_fp);
+
+  char rule_buf_out[RP_PASSWORD_SIZE];
+
+  u64 rejected = 0;
+
+  while (!hc_feof (combs_fp))
+  {
+    const size_t line_len = fgetl (combs_fp, device_param->scratch_buf, HCBUFSIZ_LARGE);
+
+    char *out_buf = NULL;
+
+    const int out_len = combs_line_process (hashcat_ctx, iconv_enabled, iconv_ctx, iconv_tmp, rule_buf_out, device_param->scratch_buf, line_len, &out_buf);
+
+    if (out_len == -2)
+    {
+      rejected++;
+
+      continue;
+    }
+
+    if (out_len == -1) continue;
+
+    const u64 entry_len = COMBS_CACHE_HDR + out_len;
+
+    if ((combs_cache->buf_len + entry_len) > COMBS_CACHE_MAX)
+    {
+      combs_cache->disabled = true;
+
+      break;
+    }
+
+    if ((combs_cache->buf_len + entry_len) > combs_cache->buf_size)
+    {
+      const u64 buf_size_new = MIN (MAX (combs_cache->buf_size * 2, 1024 * 1024), COMBS_CACHE_MAX);
+
+      combs_cache->buf = (u8 *) hcrealloc (combs_cache->buf, combs_cache->buf_size, buf_size_new - combs_cache->buf_size);
+
+      combs_cache->buf_size = buf_size_new;
+    }
+
+    const u32 rejected_before = (u32) MIN (rejected, 0xffffffff);
+
+    u8 *entry = combs_cache->buf + combs_cache->buf_len;
+
+    const u16 entry_pw_len = (u16) out_len;
+
+    memcpy (entry,                   &rejected_before, sizeof (u32));
+    memcpy (entry + sizeof (u32),    &entry_pw_len,    sizeof (u16));
+    memcpy (entry + COMBS_CACHE_HDR, out_buf,          out_len);
+
+    combs_cache->buf_len += entry_len;
+
+    rejected = 0;
+  }
+
+  if (combs_cache->disabled == true)
+  {
+    hcfree (combs_cache->buf);
+
+    combs_cache->buf      = NULL;
+    combs_cache->buf_len  = 0;
+    combs_cache->buf_size = 0;
+  }
+
+  combs_cache->rejected_tail = rejected;
+}
+
+static void combs_rewind (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const bool iconv_enabled, iconv_t iconv_ctx, char *iconv_tmp)
+{
+  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+
+  combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  // all devices of a pass use the same wordlist, so the image is only rebuilt between passes
+
+  hc_thread_mutex_lock (combinator_ctx->mux_combs_cache);
+
+  if ((combs_cache->dictfile == NULL) || (strcmp (combs_cache->dictfile, device_param->combs_fp.path) != 0))
+  {
+    combs_cache_build (hashcat_ctx, device_param, iconv_enabled, iconv_ctx, iconv_tmp);
+  }
+
+  hc_thread_mutex_unlock (combinator_ctx->mux_combs_cache);
+
+  if (combs_cache->disabled == true)
+  {
+    hc_rewind (&device_param->combs_fp);
+  }
+  else
+  {
+    device_param->combs_cache_pos = 0;
+    device_param->combs_cache_eof = false;
+  }
+}
+
+// fills combs_buf with the next innerloop_left candidates and returns how many there were left
+
+static u64 combs_fill (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const bool iconv_enabled, iconv_t iconv_ctx, char *iconv_tmp, const u64 innerloop_left, const u32 salt_pos, const u64 pws_cnt, const bool add_marker)
+{
+  const combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+  const hashconfig_t     *hashconfig     = hashcat_ctx->hashconfig;
+  status_ctx_t           *status_ctx     = hashcat_ctx->status_ctx;
+
+  const combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  HCFILE *combs_fp = &device_param->combs_fp;
+
+  char rule_buf_out[RP_PASSWORD_SIZE];
+
+  u64 i = 0;
+
+  while (i < innerloop_left)
+  {
+    char *line_buf = NULL;
+    int   line_len = 0;
+
+    if (combs_cache->disabled == false)
+    {
+      if (device_param->combs_cache_pos == combs_cache->buf_len)
+      {
+        if (device_param->combs_cache_eof == false) status_ctx->words_progress_rejected[salt_pos] += pws_cnt * combs_cache->rejected_tail;
+
+        device_param->combs_cache_eof = true;
+
+        break;
+      }
+
+      const u8 *entry = combs_cache->buf + device_param->combs_cache_pos;
+
+      u32 rejected_before;
+
+      memcpy (&rejected_before, entry, sizeof (u32));
+
+      status_ctx->words_progress_rejected[salt_pos] += pws_cnt * rejected_before;
+
+      u16 entry_pw_len;
+
+      memcpy (&entry_pw_len, entry + sizeof (u32), sizeof (u16));
+
+      line_len = entry_pw_len;
+      line_buf = (char *) entry + COMBS_CACHE_HDR;
+
+      device_param->combs_cache_pos += COMBS_CACHE_HDR + line_len;
+    }
+    else
+    {
+      if (hc_feof (combs_fp)) break;
+
+      const size_t len = fgetl (combs_fp, device_param->scratch_buf, HCBUFSIZ_LARGE);
+
+      line_len = combs_line_process (hashcat_ctx, iconv_enabled, iconv_ctx, iconv_tmp, rule_buf_out, device_param->scratch_buf, len, &line_buf);
+
+      if (line_len == -2)
+      {
+        status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
+
+        continue;
+      }
+
+      if (line_len == -1) continue;
+    }
+
+    u8 *ptr = (u8 *) device_param->combs_buf[i].i;
+
+    memcpy (ptr, line_buf, line_len);
+
+    memset (ptr + line_len, 0, PW_MAX - line_len);
+
+    if (add_marker == true)
+    {
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
+      {
+        ptr[line_len] = 0x80;
+      }
+
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
+      {
+        ptr[line_len] = 0x06;
+      }
+
+      if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
+      {
+        ptr[line_len] = 0x01;
+      }
+    }
+
+    device_param->combs_buf[i].pw_len = (u32) line_len;
+
+    i++;
+  }
+
+  for (u64 j = i; j < innerloop_left; j++)
+  {
+    memset (&device_param->combs_buf[j], 0, sizeof (pw_t));
+  }
+
+  return i;
+}
+
+void combs_cache_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+
+  combs_cache_t *combs_cache = &combinator_ctx->combs_cache;
+
+  hcfree (combs_cache->dictfile);
+  hcfree (combs_cache->buf);
+
+  memset (combs_cache, 0, sizeof (combs_cache_t));
+}
+
 int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_pos, const u64 pws_cnt)
 {
   combinator_ctx_t      *combinator_ctx     = hashcat_ctx->combinator_ctx;
@@ -4162,18 +4838,22 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
     salts_cnt = 1;
   }
 
-  for (u32 salt_pos = 0; salt_pos < salts_cnt; salt_pos++)
+  for (u32 salt_pos = 0, salt_batch = 1; salt_pos < salts_cnt; salt_pos += salt_batch)
   {
     while (status_ctx->devices_status == STATUS_PAUSED) sleep (1);
 
     salt_t *salt_buf = &hashes->salts_buf[salt_pos];
 
+    // the salts [salt_pos, salt_pos + salt_batch) share this launch
+
+    salt_batch = salt_batch_size (hashcat_ctx, device_param, salt_pos, salts_cnt, pws_cnt);
+
+    device_param->salt_batch_cnt = salt_batch;
+
     device_param->kernel_param.salt_pos_host       = salt_pos;
     device_param->kernel_param.digests_cnt         = salt_buf->digests_cnt;
     device_param->kernel_param.digests_offset_host = salt_buf->digests_offset;
 
-    HCFILE *combs_fp = &device_param->combs_fp;
-
     if (user_options->slow_candidates == true)
     {
     }
@@ -4181,7 +4861,7 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
     {
       if ((user_options->attack_mode == ATTACK_MODE_COMBI) || (((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0) && (user_options->attack_mode == ATTACK_MODE_HYBRID2)))
       {
-        hc_rewind (combs_fp);
+        combs_rewind (hashcat_ctx, device_param, iconv_enabled, iconv_ctx, iconv_tmp);
       }
     }
 
@@ -4250,9 +4930,19 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
       }
       else
       {
-        if (hashes->salts_shown[salt_pos] == 1)
+        u32 salts_shown = 0;
+
+        for (u32 salt_idx = salt_pos; salt_idx < salt_pos + salt_batch; salt_idx++)
+        {
+          salts_shown += hashes->salts_shown[salt_idx];
+        }
+
+        if (salts_shown == salt_batch)
         {
-          status_ctx->words_progress_done[salt_pos] += pws_cnt * innerloop_left;
+          for (u32 salt_idx = salt_pos; salt_idx < salt_pos + salt_batch; salt_idx++)
+          {
+            status_ctx->words_progress_done[salt_idx] += pws_cnt * innerloop_left;
+          }
 
           continue;
         }
@@ -4295,107 +4985,13 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
           {
             if (user_options->attack_mode == ATTACK_MODE_COMBI)
             {
-              char *line_buf = device_param->scratch_buf;
-
-              u64 i = 0;
-
-              while (i < innerloop_left)
-              {
-                if (hc_feof (combs_fp)) break;
-
-                size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
-
-                line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
-
-                if (line_len > PW_MAX) continue;
-
-                char *line_buf_new = line_buf;
-
-                char rule_buf_out[RP_PASSWORD_SIZE];
-
-                if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
-                {
-                  if (line_len >= RP_PASSWORD_SIZE) continue;
-
-                  memset (rule_buf_out, 0, sizeof (rule_buf_out));
-
-                  const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
-
-                  if (rule_len_out < 0)
-                  {
-                    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-                    {
-                      for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
-                      {
-                        status_ctx->words_progress_rejected[association_salt_pos] += 1;
-                      }
-                    }
-                    else
-                    {
-                      status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
-                    }
-
-                    continue;
-                  }
+              const bool add_marker = (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT);
 
-                  line_len = rule_len_out;
+              const u64 rejected_prev = status_ctx->words_progress_rejected[salt_pos];
 
-                  line_buf_new = rule_buf_out;
-                }
-
-                // do the on-the-fly encoding
-
-                if (iconv_enabled == true)
-                {
-                  char  *iconv_ptr = iconv_tmp;
-                  size_t iconv_sz  = HCBUFSIZ_TINY;
-
-                  if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
-
-                  line_buf_new = iconv_tmp;
-                  line_len     = HCBUFSIZ_TINY - iconv_sz;
-                }
-
-                line_len = MIN (line_len, PW_MAX);
-
-                u8 *ptr = (u8 *) device_param->combs_buf[i].i;
-
-                memcpy (ptr, line_buf_new, line_len);
-
-                memset (ptr + line_len, 0, PW_MAX - line_len);
-
-                if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
-                {
-                  uppercase (ptr, line_len);
-                }
-
-                if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
-                {
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
-                  {
-                    ptr[line_len] = 0x80;
-                  }
-
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
-                  {
-                    ptr[line_len] = 0x06;
-                  }
-
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
-                  {
-                    ptr[line_len] = 0x01;
-                  }
-                }
-
-                device_param->combs_buf[i].pw_len = (u32) line_len;
-
-                i++;
-              }
+              const u64 i = combs_fill (hashcat_ctx, device_param, iconv_enabled, iconv_ctx, iconv_tmp, innerloop_left, salt_pos, pws_cnt, add_marker);
 
-              for (u64 j = i; j < innerloop_left; j++)
-              {
-                memset (&device_param->combs_buf[j], 0, sizeof (pw_t));
-              }
+              salt_batch_rejected (hashcat_ctx, salt_pos, salt_batch, status_ctx->words_progress_rejected[salt_pos] - rejected_prev);
 
               innerloop_left = i;
 
@@ -4486,146 +5082,48 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
           {
             if ((user_options->attack_mode == ATTACK_MODE_COMBI) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
             {
-              char *line_buf = device_param->scratch_buf;
+              const u64 rejected_prev = status_ctx->words_progress_rejected[salt_pos];
 
-              u64 i = 0;
+              const u64 i = combs_fill (hashcat_ctx, device_param, iconv_enabled, iconv_ctx, iconv_tmp, innerloop_left, salt_pos, pws_cnt, false);
 
-              while (i < innerloop_left)
-              {
-                if (hc_feof (combs_fp)) break;
+              salt_batch_rejected (hashcat_ctx, salt_pos, salt_batch, status_ctx->words_progress_rejected[salt_pos] - rejected_prev);
 
-                size_t line_len = fgetl (combs_fp, line_buf, HCBUFSIZ_LARGE);
+              innerloop_left = i;
 
-                line_len = convert_from_hex (hashcat_ctx, line_buf, line_len);
+              if (device_param->is_cuda == true)
+              {
+                if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
+              }
 
-                if (line_len > PW_MAX) continue;
+              if (device_param->is_hip == true)
+              {
+                if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
+              }
 
-                char *line_buf_new = line_buf;
+              #if defined (__APPLE__)
+              if (device_param->is_metal == true)
+              {
+                if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_combs_c, 0, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
+              }
+              #endif
 
-                char rule_buf_out[RP_PASSWORD_SIZE];
+              if (device_param->is_opencl == true)
+              {
+                if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs_c, CL_TRUE, 0, innerloop_left * sizeof (pw_t), device_param->combs_buf, 0, NULL, NULL) == -1) return -1;
+              }
+            }
+            else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+            {
+              u64 off = innerloop_pos;
 
-                if (run_rule_engine (user_options_extra->rule_len_r, user_options->rule_buf_r))
-                {
-                  if (line_len >= RP_PASSWORD_SIZE) continue;
+              device_param->kernel_params_mp_buf64[3] = off;
 
-                  memset (rule_buf_out, 0, sizeof (rule_buf_out));
+              if (run_kernel_mp (hashcat_ctx, device_param, KERN_RUN_MP, innerloop_left) == -1) return -1;
 
-                  const int rule_len_out = _old_apply_rule (user_options->rule_buf_r, user_options_extra->rule_len_r, line_buf, (u32) line_len, rule_buf_out);
-
-                  if (rule_len_out < 0)
-                  {
-                    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-                    {
-                      for (u32 association_salt_pos = 0; association_salt_pos < pws_cnt; association_salt_pos++)
-                      {
-                        status_ctx->words_progress_rejected[association_salt_pos] += 1;
-                      }
-                    }
-                    else
-                    {
-                      status_ctx->words_progress_rejected[salt_pos] += pws_cnt;
-                    }
-
-                    continue;
-                  }
-
-                  line_len = rule_len_out;
-
-                  line_buf_new = rule_buf_out;
-                }
-
-                // do the on-the-fly encoding
-
-                if (iconv_enabled == true)
-                {
-                  char  *iconv_ptr = iconv_tmp;
-                  size_t iconv_sz  = HCBUFSIZ_TINY;
-
-                  if (iconv (iconv_ctx, &line_buf_new, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
-
-                  line_buf_new = iconv_tmp;
-                  line_len     = HCBUFSIZ_TINY - iconv_sz;
-                }
-
-                line_len = MIN (line_len, PW_MAX);
-
-                u8 *ptr = (u8 *) device_param->combs_buf[i].i;
-
-                memcpy (ptr, line_buf_new, line_len);
-
-                memset (ptr + line_len, 0, PW_MAX - line_len);
-
-                if (hashconfig->opts_type & OPTS_TYPE_PT_UPPER)
-                {
-                  uppercase (ptr, line_len);
-                }
-
-                /*
-                if (combinator_ctx->combs_mode == COMBINATOR_MODE_BASE_LEFT)
-                {
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)
-                  {
-                    ptr[line_len] = 0x80;
-                  }
-
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)
-                  {
-                    ptr[line_len] = 0x06;
-                  }
-
-                  if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)
-                  {
-                    ptr[line_len] = 0x01;
-                  }
-                }
-                */
-
-                device_param->combs_buf[i].pw_len = (u32) line_len;
-
-                i++;
-              }
-
-              for (u64 j = i; j < innerloop_left; j++)
-              {
-                memset (&device_param->combs_buf[j], 0, sizeof (pw_t));
-              }
-
-              innerloop_left = i;
-
-              if (device_param->is_cuda == true)
-              {
-                if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
-              }
-
-              if (device_param->is_hip == true)
-              {
-                if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_combs_c, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
-              }
-
-              #if defined (__APPLE__)
-              if (device_param->is_metal == true)
-              {
-                if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_combs_c, 0, device_param->combs_buf, innerloop_left * sizeof (pw_t)) == -1) return -1;
-              }
-              #endif
-
-              if (device_param->is_opencl == true)
-              {
-                if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_combs_c, CL_TRUE, 0, innerloop_left * sizeof (pw_t), device_param->combs_buf, 0, NULL, NULL) == -1) return -1;
-              }
-            }
-            else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-            {
-              u64 off = innerloop_pos;
-
-              device_param->kernel_params_mp_buf64[3] = off;
-
-              if (run_kernel_mp (hashcat_ctx, device_param, KERN_RUN_MP, innerloop_left) == -1) return -1;
-
-              if (device_param->is_cuda == true)
-              {
-                if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_combs_c, device_param->cuda_d_combs, innerloop_left * sizeof (pw_t)) == -1) return -1;
-              }
+              if (device_param->is_cuda == true)
+              {
+                if (hc_cuMemcpyDtoD (hashcat_ctx, device_param->cuda_d_combs_c, device_param->cuda_d_combs, innerloop_left * sizeof (pw_t)) == -1) return -1;
+              }
 
               if (device_param->is_hip == true)
               {
@@ -4696,7 +5194,7 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
 
         if (status_ctx->run_thread_level2 == true)
         {
-          const u64 perf_sum_all = pws_cnt * innerloop_left;
+          const u64 perf_sum_all = pws_cnt * innerloop_left * salt_batch;
 
           const double speed_msec = hc_timer_get (device_param->timer_speed);
 
@@ -4732,7 +5230,10 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
           }
           else
           {
-            status_ctx->words_progress_done[salt_pos] += perf_sum_all;
+            for (u32 salt_idx = salt_pos; salt_idx < salt_pos + salt_batch; salt_idx++)
+            {
+              status_ctx->words_progress_done[salt_idx] += pws_cnt * innerloop_left;
+            }
           }
 
           hc_thread_mutex_unlock (status_ctx->mux_counter);
@@ -4790,8 +5291,12 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
        * result
        */
 
+      const double trace_ts = trace_begin (hashcat_ctx);
+
       check_cracked (hashcat_ctx, device_param);
 
+      trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "check_cracked", trace_ts);
+
       if (status_ctx->run_thread_level2 == false) break;
     }
 
@@ -4805,6 +5310,11 @@ int run_cracker (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, co
     if (status_ctx->run_thread_level2 == false) break;
   }
 
+  device_param->salt_batch_cnt     = 1;
+  device_param->salt_batch_pws_cnt = 0;
+
+  device_param->kernel_param.salt_batch_pws = SALT_BATCH_PWS_NONE;
+
   //status screen makes use of this, can't reset here
   //device_param->outerloop_msec = 0;
   //device_param->outerloop_pos  = 0;
@@ -8404,96 +8914,629 @@ int backend_ctx_devices_init (hashcat_ctx_t *hashcat_ctx, const int comptime)
 
   int bridge_link_device = 0; // this will only count active device
 
-  int backend_devices_idx = 0; // this will not only count active devices
+  int backend_devices_idx = 0; // this will not only count active devices
+
+  int virthost = -1;
+  int virthost_finder = user_options->backend_devices_virthost;
+
+  // CUDA
+
+  backend_ctx_devices_init_cuda (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+
+  // HIP
+
+  backend_ctx_devices_init_hip (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+
+  // Metal
+
+  backend_ctx_devices_init_metal (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+
+  // OCL
+
+  backend_ctx_devices_init_opencl (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+
+  // all devices combined go into backend_* variables
+
+  backend_ctx->backend_devices_cnt    = backend_ctx->cuda_devices_cnt    + backend_ctx->hip_devices_cnt    + backend_ctx->metal_devices_cnt    + backend_ctx->opencl_devices_cnt;
+  backend_ctx->backend_devices_active = backend_ctx->cuda_devices_active + backend_ctx->hip_devices_active + backend_ctx->metal_devices_active + backend_ctx->opencl_devices_active;
+
+  #if defined (__APPLE__)
+  // disable Metal devices if at least one OpenCL device is enabled
+  if (backend_ctx->opencl_devices_active > 0)
+  {
+    if (backend_ctx->mtl)
+    {
+      for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+      {
+        hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+
+        if (device_param->is_metal == false) continue;
+
+        // Since we can't match OpenCL with Metal devices (missing PCI ID etc.) and at the same time we have better OpenCL support than Metal support,
+        // we disable all Metal devices by default. The user can reactivate them with -d.
+
+        if (device_param->skipped == false)
+        {
+          if (backend_ctx->backend_devices_filter[device_param->device_id] == 1)
+          {
+            if ((user_options->quiet == false) && (user_options->backend_info == 0))
+            {
+              event_log_warning (hashcat_ctx, "The device #%d has been disabled as it most likely also exists as an OpenCL device, but it is not possible to automatically map it.", device_param->device_id + 1);
+              event_log_warning (hashcat_ctx, "You can use -d %d to use Metal API instead of OpenCL API. In some rare cases this is more stable.", device_param->device_id + 1);
+              event_log_warning (hashcat_ctx, NULL);
+            }
+
+            device_param->skipped = true;
+          }
+          else
+          {
+            if (backend_ctx->backend_devices_filter[device_param->device_id])
+            {
+              // ok
+            }
+            else
+            {
+              device_param->skipped = true;
+            }
+          }
+
+          if (device_param->skipped == true)
+          {
+            backend_ctx->metal_devices_active--;
+            backend_ctx->backend_devices_active--;
+          }
+        }
+      }
+    }
+  }
+  #endif
+
+  // find duplicate devices
+
+  //if ((cuda_devices_cnt > 0) && (hip_devices_cnt > 0) && (opencl_devices_cnt > 0))
+  //{
+    // using force here enables both devices, which is the worst possible outcome
+    // many users force by default, so this is not a good idea
+
+    //if (user_options->force == false)
+    //{
+    backend_ctx_find_alias_devices (hashcat_ctx);
+    //{
+  //}
+
+  if (backend_ctx->backend_devices_active == 0)
+  {
+    event_log_error (hashcat_ctx, "No devices found/left.");
+
+    return -1;
+  }
+
+  // now we can calculate the number of parallel running hook threads based on
+  // the number cpu cores and the number of active compute devices
+  // unless overwritten by the user
+
+  if (user_options->hook_threads == HOOK_THREADS)
+  {
+    const u32 processor_count = hc_get_processor_count ();
+
+    const u32 processor_count_cu = CEILDIV (processor_count, backend_ctx->backend_devices_active); // should never reach 0
+
+    user_options->hook_threads = processor_count_cu;
+  }
+
+  // additional check to see if the user has chosen a device that is not within the range of available devices (i.e. larger than devices_cnt)
+
+  if (backend_ctx->backend_devices_cnt >= DEVICES_MAX)
+  {
+    event_log_error (hashcat_ctx, "Illegal use of the --backend-devices parameter because too many backend devices were found (%u).", backend_ctx->backend_devices_cnt);
+    event_log_error (hashcat_ctx, "If possible, disable one of your backends to reduce the number of backend devices. For example \"--backend-ignore-cuda\" or \"--backend-ignore-opencl\" .");
+
+    return -1;
+  }
+
+  // time or resource intensive operations which we do not run if the corresponding device was skipped by the user
+
+  if (backend_ctx->cuda)
+  {
+    // instruction test for cuda devices was replaced with fixed values (see above)
+
+    /*
+    CUcontext cuda_context;
+
+    if (hc_cuCtxCreate (hashcat_ctx, &cuda_context, CU_CTX_SCHED_BLOCKING_SYNC, device_param->cuda_device) == -1) return -1;
+
+    if (hc_cuCtxSetCurrent (hashcat_ctx, cuda_context) == -1) return -1;
+
+    #define RUN_INSTRUCTION_CHECKS()                                                                                                                                                                                                                      \
+      device_param->has_add   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"add.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                              \
+      device_param->has_addc  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"addc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                             \
+      device_param->has_sub   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"sub.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                              \
+      device_param->has_subc  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"subc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                             \
+      device_param->has_bfe   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"bfe.u32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                              \
+      device_param->has_lop3  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"lop3.b32 %0, 0, 0, 0, 0;\" : \"=r\"(r)); }");                                                          \
+      device_param->has_mov64 = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned long long r; unsigned int a; unsigned int b; asm volatile (\"mov.b64 %0, {%1, %2};\" : \"=l\"(r) : \"r\"(a), \"r\"(b)); }");  \
+      device_param->has_prmt  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"prmt.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                             \
+      device_param->has_shfw  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"shf.l.wrap.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                       \
+
+    if (backend_devices_idx > 0)
+    {
+      hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
+
+      if (is_same_device_type (device_param, device_param_prev) == true)
+      {
+        device_param->has_add   = device_param_prev->has_add;
+        device_param->has_addc  = device_param_prev->has_addc;
+        device_param->has_sub   = device_param_prev->has_sub;
+        device_param->has_subc  = device_param_prev->has_subc;
+        device_param->has_bfe   = device_param_prev->has_bfe;
+        device_param->has_lop3  = device_param_prev->has_lop3;
+        device_param->has_mov64 = device_param_prev->has_mov64;
+        device_param->has_prmt  = device_param_prev->has_prmt;
+        device_param->has_shfw  = device_param_prev->has_shfw;
+      }
+      else
+      {
+        RUN_INSTRUCTION_CHECKS();
+      }
+    }
+    else
+    {
+      RUN_INSTRUCTION_CHECKS();
+    }
+
+    #undef RUN_INSTRUCTION_CHECKS
+
+    if (hc_cuCtxDestroy (hashcat_ctx, cuda_context) == -1) return -1;
+
+    */
+  }
+
+  if (backend_ctx->hip)
+  {
+    // TODO HIP?
+    // Maybe all devices supported by hip have these instructions guaranteed?
+
+    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+    {
+      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+
+      if (device_param->is_hip == false) continue;
+
+      device_param->has_vadd     = true;
+      device_param->has_vaddc    = true;
+      device_param->has_vadd_co  = true;
+      device_param->has_vaddc_co = true;
+      device_param->has_vsub     = true;
+      device_param->has_vsubb    = true;
+      device_param->has_vsub_co  = true;
+      device_param->has_vsubb_co = true;
+      device_param->has_vadd3    = true;
+      device_param->has_vbfe     = true;
+      device_param->has_vperm    = true;
+    }
+  }
+
+  #if defined (__APPLE__)
+  if (backend_ctx->mtl)
+  {
+    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+    {
+      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+
+      if (device_param->is_metal == false) continue;
+
+      if (user_options->backend_info == 0)
+      {
+        // do not ignore in case -I because user expects a value also for skipped devices
+
+        if (device_param->skipped == true) continue;
+      }
+
+      // one-time init metal command-queue
+
+      if (hc_mtlCreateCommandQueue (hashcat_ctx, device_param->metal_device, &device_param->metal_command_queue) == -1)
+      {
+        device_param->skipped = true;
+
+        backend_ctx->metal_devices_active--;
+        backend_ctx->backend_devices_active--;
+
+        continue;
+      }
+
+      // available device memory
+      // This test causes an GPU memory usage spike.
+      // In case there are multiple hashcat instances starting at the same time this will cause GPU out of memory errors which otherwise would not exist.
+      // We will simply not run it if that device was skipped by the user.
+
+      #define MAX_ALLOC_CHECKS_CNT  8192
+      #define MAX_ALLOC_CHECKS_SIZE (64 * 1024 * 1024)
+
+      device_param->device_available_mem = device_param->device_global_mem - MAX_ALLOC_CHECKS_SIZE;
+
+      if (user_options->backend_devices_keepfree < 100)
+      {
+        device_param->device_available_mem = (device_param->device_global_mem * (100 - user_options->backend_devices_keepfree)) / 100;
+      }
+      // this section is creating more problems than it solves, so lets use a fixed multiplier instead
+      // users can override with --backend-devices-keepfree=100
+      else if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->device_host_unified_memory == 0))
+      {
+        // following the same logic as for OpenCL, explained later
+
+        mtl_mem_t *tmp_device = (mtl_mem_t *) hccalloc (MAX_ALLOC_CHECKS_CNT, sizeof (mtl_mem_t));
+
+        u64 c;
+
+        for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
+        {
+          if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+
+          // using SHARED by default here, no performance requirements
+          if (hc_mtlCreateBuffer (hashcat_ctx, device_param->metal_device, MAX_ALLOC_CHECKS_SIZE, NULL, &tmp_device[c], metal_shared_storageMode) == -1)
+          {
+            c--;
+
+            break;
+          }
+
+          // transfer only a few byte should be enough to force the runtime to actually allocate the memory
+
+          u8 tmp_host[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_device[c], 0, tmp_host, sizeof (tmp_host)) == -1) break;
+          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_host, tmp_device[c], 0, sizeof (tmp_host)) == -1) break;
+
+          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_device[c], MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), tmp_host, sizeof (tmp_host)) == -1) break;
+          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_host, tmp_device[c], MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host)) == -1) break;
+        }
+
+        device_param->device_available_mem = MAX_ALLOC_CHECKS_SIZE;
+
+        if (c > 0)
+        {
+          device_param->device_available_mem *= c;
+        }
+
+        // clean up
+
+        for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
+        {
+          if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+
+          if (tmp_device[c].buf_ptr != NULL)
+          {
+            if (hc_mtlReleaseMemObject (hashcat_ctx, &tmp_device[c]) == -1) return -1;
+          }
+        }
+
+        hcfree (tmp_device);
+      }
+
+      if (device_param->device_host_unified_memory == 1)
+      {
+        // so, we actually have only half the memory because we need the same buffers on host side
+
+        device_param->device_available_mem /= 2;
+      }
+    }
+  }
+  #endif // __APPLE__
+
+  if (backend_ctx->ocl)
+  {
+    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+    {
+      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+
+      if (device_param->is_opencl == false) continue;
+
+      if (user_options->backend_info == 0)
+      {
+        // do not ignore in case -I because user expects a value also for skipped devices
+
+        if (device_param->skipped == true) continue;
+      }
+
+      // one-time init opencl context
+
+      /*
+      cl_context_properties properties[3];
+
+      properties[0] = CL_CONTEXT_PLATFORM;
+      properties[1] = (cl_context_properties) device_param->opencl_platform;
+      properties[2] = 0;
+
+      CL_rc = hc_clCreateContext (hashcat_ctx, properties, 1, &device_param->opencl_device, NULL, NULL, &device_param->opencl_context);
+      */
+
+      if (hc_clCreateContext (hashcat_ctx, NULL, 1, &device_param->opencl_device, NULL, NULL, &device_param->opencl_context) == -1)
+      {
+        device_param->skipped = true;
+
+        backend_ctx->opencl_devices_active--;
+        backend_ctx->backend_devices_active--;
+
+        continue;
+      }
+
+      // one-time init open command-queue
+
+      if (hc_clCreateCommandQueue (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, CL_QUEUE_PROFILING_ENABLE, &device_param->opencl_command_queue) == -1)
+      {
+        device_param->skipped = true;
+
+        backend_ctx->opencl_devices_active--;
+        backend_ctx->backend_devices_active--;
+
+        continue;
+      }
+
+      // instruction set
+
+      if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD))
+      {
+        #define RUN_INSTRUCTION_CHECKS() \
+          device_param->has_vadd     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD_U32     %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vaddc    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADDC_U32    %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
+          device_param->has_vadd_co  = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD_CO_U32  %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vaddc_co = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADDC_CO_U32 %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
+          device_param->has_vsub     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUB_U32     %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vsubb    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUBB_U32    %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
+          device_param->has_vsub_co  = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUB_CO_U32  %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vsubb_co = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUBB_CO_U32 %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
+          device_param->has_vadd3    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD3_U32    %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vbfe     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_BFE_U32     %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
+          device_param->has_vperm    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_PERM_B32    %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
+
+        if (backend_devices_idx > 0)
+        {
+          hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
+
+          if (is_same_device_type (device_param, device_param_prev) == true)
+          {
+            device_param->has_vadd     = device_param_prev->has_vadd;
+            device_param->has_vaddc    = device_param_prev->has_vaddc;
+            device_param->has_vadd_co  = device_param_prev->has_vadd_co;
+            device_param->has_vaddc_co = device_param_prev->has_vaddc_co;
+            device_param->has_vsub     = device_param_prev->has_vsub;
+            device_param->has_vsubb    = device_param_prev->has_vsubb;
+            device_param->has_vsub_co  = device_param_prev->has_vsub_co;
+            device_param->has_vsubb_co = device_param_prev->has_vsubb_co;
+            device_param->has_vadd3    = device_param_prev->has_vadd3;
+            device_param->has_vbfe     = device_param_prev->has_vbfe;
+            device_param->has_vperm    = device_param_prev->has_vperm;
+          }
+          else
+          {
+            RUN_INSTRUCTION_CHECKS();
+          }
+        }
+        else
+        {
+          RUN_INSTRUCTION_CHECKS();
+        }
+
+        #undef RUN_INSTRUCTION_CHECKS
+      }
+
+      if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->opencl_platform_vendor_id == VENDOR_ID_NV))
+      {
+        // replaced with fixed values see non time intensive section above
+
+        /*
+        #define RUN_INSTRUCTION_CHECKS()                                                                                                                                                                                                          \
+          device_param->has_add   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"add.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                        \
+          device_param->has_addc  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"addc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                       \
+          device_param->has_sub   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"sub.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                        \
+          device_param->has_subc  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"subc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                       \
+          device_param->has_bfe   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"bfe.u32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                        \
+          device_param->has_lop3  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"lop3.b32 %0, 0, 0, 0, 0;\" : \"=r\"(r)); }");                                    \
+          device_param->has_mov64 = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { ulong r; uint a; uint b; asm volatile (\"mov.b64 %0, {%1, %2};\" : \"=l\"(r) : \"r\"(a), \"r\"(b)); }"); \
+          device_param->has_prmt  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"prmt.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                       \
+          device_param->has_shfw  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"shf.l.wrap.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                 \
+
+        if (backend_devices_idx > 0)
+        {
+          hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
+
+          if (is_same_device_type (device_param, device_param_prev) == true)
+          {
+            device_param->has_add   = device_param_prev->has_add;
+            device_param->has_addc  = device_param_prev->has_addc;
+            device_param->has_sub   = device_param_prev->has_sub;
+            device_param->has_subc  = device_param_prev->has_subc;
+            device_param->has_bfe   = device_param_prev->has_bfe;
+            device_param->has_lop3  = device_param_prev->has_lop3;
+            device_param->has_mov64 = device_param_prev->has_mov64;
+            device_param->has_prmt  = device_param_prev->has_prmt;
+            device_param->has_shfw  = device_param_prev->has_shfw;
+          }
+          else
+          {
+            RUN_INSTRUCTION_CHECKS();
+          }
+        }
+        else
+        {
+          RUN_INSTRUCTION_CHECKS();
+        }
+
+        #undef RUN_INSTRUCTION_CHECKS
+        */
+      }
+
+      // available device memory
+      // first trying to check if we can get device_available_mem from cuda/hip alias device
+
+      bool updated_device_available_mem = false;
+
+      if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
+      {
+        if (device_param->opencl_platform_vendor_id == VENDOR_ID_NV)
+        {
+          if (backend_ctx->cuda_devices_cnt > 0 && backend_ctx->cuda_devices_active > 0)
+          {
+            for (int cuda_devices_idx = 0; cuda_devices_idx < backend_ctx->cuda_devices_cnt; cuda_devices_idx++)
+            {
+              const int tmp_backend_devices_idx = backend_ctx->backend_device_from_cuda[cuda_devices_idx];
+
+              hc_device_param_t *tmp_device_param = backend_ctx->devices_param + tmp_backend_devices_idx;
+
+              if (is_same_device (device_param, tmp_device_param))
+              {
+                device_param->device_available_mem = tmp_device_param->device_available_mem;
+                updated_device_available_mem       = true;
+                break;
+              }
+            }
+          }
+        }
+        else if (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD)
+        {
+          if (backend_ctx->hip_devices_cnt > 0 && backend_ctx->hip_devices_active > 0)
+          {
+            for (int hip_devices_idx = 0; hip_devices_idx < backend_ctx->hip_devices_cnt; hip_devices_idx++)
+            {
+              const int tmp_backend_devices_idx = backend_ctx->backend_device_from_hip[hip_devices_idx];
+
+              hc_device_param_t *tmp_device_param = backend_ctx->devices_param + tmp_backend_devices_idx;
+
+              if (is_same_device (device_param, tmp_device_param))
+              {
+                device_param->device_available_mem = tmp_device_param->device_available_mem;
+                updated_device_available_mem       = true;
+                break;
+              }
+            }
+          }
+        }
+      }
+
+      // if not found ... use old strategy
+
+      if (updated_device_available_mem == false)
+      {
+        // This test causes an GPU memory usage spike.
+        // In case there are multiple hashcat instances starting at the same time this will cause GPU out of memory errors which otherwise would not exist.
+        // We will simply not run it if that device was skipped by the user.
+
+        if (device_param->device_global_mem)
+        {
+          #define MAX_ALLOC_CHECKS_CNT  8192
+          #define MAX_ALLOC_CHECKS_SIZE (64 * 1024 * 1024)
+
+          device_param->device_available_mem = device_param->device_global_mem - MAX_ALLOC_CHECKS_SIZE;
+
+          if (user_options->backend_devices_keepfree < 100)
+          {
+            device_param->device_available_mem = (device_param->device_global_mem * (100 - user_options->backend_devices_keepfree)) / 100;
+          }
+          // this section is creating more problems than it solves, so lets use a fixed multiplier instead
+          // users can override with --backend-devices-keepfree=100
+          else if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->device_host_unified_memory == 0))
+          {
+            // OK, so the problem here is the following:
+            // There's just CL_DEVICE_GLOBAL_MEM_SIZE to ask OpenCL about the total memory on the device,
+            // but there's no way to ask for available memory on the device.
+            // In combination, most OpenCL runtimes implementation of clCreateBuffer()
+            // are doing so called lazy memory allocation on the device.
+            // Now, if the user has X11 (or a game or anything that takes a lot of GPU memory)
+            // running on the host we end up with an error type of this:
+            // clEnqueueNDRangeKernel(): CL_MEM_OBJECT_ALLOCATION_FAILURE
+            // The clEnqueueNDRangeKernel() is because of the lazy allocation
+            // The best way to workaround this problem is if we would be able to ask for available memory,
+            // The idea here is to try to evaluate available memory by allocating it till it errors
+
+            cl_mem *tmp_device = (cl_mem *) hccalloc (MAX_ALLOC_CHECKS_CNT, sizeof (cl_mem));
+
+            u64 c;
+
+            for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
+            {
+              if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+
+              // work around, for some reason apple opencl can't have buffers larger 2^31
+              // typically runs into trap 6
+              // maybe 32/64 bit problem affecting size_t?
+              // this seems to affect global memory as well no just single allocations
+              // this is really ugly, and still in place 2025/06/09
+              //  Version.: OpenCL 1.2 (Apr 18 2025 21:45:30)
+              //  Driver.Version.: 1.2 (Apr 22 2025 20:11:41)
+
+              if ((device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE) && (device_param->is_metal == false))
+              {
+                const size_t undocumented_single_allocation_apple = 0x7fffffff;
 
-  int virthost = -1;
-  int virthost_finder = user_options->backend_devices_virthost;
+                if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= undocumented_single_allocation_apple) break;
+              }
 
-  // CUDA
+              cl_int CL_err;
 
-  backend_ctx_devices_init_cuda (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+              OCL_PTR *ocl = (OCL_PTR *) backend_ctx->ocl;
 
-  // HIP
+              tmp_device[c] = ocl->clCreateBuffer (device_param->opencl_context, CL_MEM_READ_WRITE, MAX_ALLOC_CHECKS_SIZE, NULL, &CL_err);
 
-  backend_ctx_devices_init_hip (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+              if (CL_err != CL_SUCCESS)
+              {
+                c--;
 
-  // Metal
+                break;
+              }
 
-  backend_ctx_devices_init_metal (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+              // transfer only a few byte should be enough to force the runtime to actually allocate the memory
 
-  // OCL
+              u8 tmp_host[8];
 
-  backend_ctx_devices_init_opencl (hashcat_ctx, &virthost, &virthost_finder, &backend_devices_idx, &bridge_link_device);
+              if (ocl->clEnqueueReadBuffer  (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, 0, sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
+              if (ocl->clEnqueueWriteBuffer (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, 0, sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
 
-  // all devices combined go into backend_* variables
+              if (ocl->clEnqueueReadBuffer  (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
+              if (ocl->clEnqueueWriteBuffer (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
+            }
 
-  backend_ctx->backend_devices_cnt    = backend_ctx->cuda_devices_cnt    + backend_ctx->hip_devices_cnt    + backend_ctx->metal_devices_cnt    + backend_ctx->opencl_devices_cnt;
-  backend_ctx->backend_devices_active = backend_ctx->cuda_devices_active + backend_ctx->hip_devices_active + backend_ctx->metal_devices_active + backend_ctx->opencl_devices_active;
+            device_param->device_available_mem = MAX_ALLOC_CHECKS_SIZE;
 
-  #if defined (__APPLE__)
-  // disable Metal devices if at least one OpenCL device is enabled
-  if (backend_ctx->opencl_devices_active > 0)
-  {
-    if (backend_ctx->mtl)
-    {
-      for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
-      {
-        hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+            if (c > 0)
+            {
+              device_param->device_available_mem *= c;
+            }
 
-        if (device_param->is_metal == false) continue;
+            // clean up
 
-        // Since we can't match OpenCL with Metal devices (missing PCI ID etc.) and at the same time we have better OpenCL support than Metal support,
-        // we disable all Metal devices by default. The user can reactivate them with -d.
+            int r = 0;
 
-        if (device_param->skipped == false)
-        {
-          if (backend_ctx->backend_devices_filter[device_param->device_id] == 1)
-          {
-            if ((user_options->quiet == false) && (user_options->backend_info == 0))
+            for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
             {
-              event_log_warning (hashcat_ctx, "The device #%d has been disabled as it most likely also exists as an OpenCL device, but it is not possible to automatically map it.", device_param->device_id + 1);
-              event_log_warning (hashcat_ctx, "You can use -d %d to use Metal API instead of OpenCL API. In some rare cases this is more stable.", device_param->device_id + 1);
-              event_log_warning (hashcat_ctx, NULL);
-            }
+              if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
 
-            device_param->skipped = true;
-          }
-          else
-          {
-            if (backend_ctx->backend_devices_filter[device_param->device_id])
-            {
-              // ok
+              if (tmp_device[c] != NULL)
+              {
+                if (hc_clReleaseMemObjectPtr (hashcat_ctx, &tmp_device[c]) == -1) r = -1;
+              }
             }
-            else
+
+            hcfree (tmp_device);
+
+            if (r == -1)
             {
-              device_param->skipped = true;
+              // return -1 here is blocking, to be better evaluated
+              //return -1;
             }
           }
+        }
 
-          if (device_param->skipped == true)
-          {
-            backend_ctx->metal_devices_active--;
-            backend_ctx->backend_devices_active--;
-          }
+        if (device_param->device_host_unified_memory == 1)
+        {
+          // so, we actually have only half the memory because we need the same buffers on host side
+
+          device_param->device_available_mem /= 2;
         }
       }
     }
   }
-  #endif
-
-  // find duplicate devices
-
-  //if ((cuda_devices_cnt > 0) && (hip_devices_cnt > 0) && (opencl_devices_cnt > 0))
-  //{
-    // using force here enables both devices, which is the worst possible outcome
-    // many users force by default, so this is not a good idea
-
-    //if (user_options->force == false)
-    //{
-    backend_ctx_find_alias_devices (hashcat_ctx);
-    //{
-  //}
 
+  // check again to catch error on OpenCL/Metal
   if (backend_ctx->backend_devices_active == 0)
   {
     event_log_error (hashcat_ctx, "No devices found/left.");
@@ -8501,1089 +9544,977 @@ int backend_ctx_devices_init (hashcat_ctx_t *hashcat_ctx, const int comptime)
     return -1;
   }
 
-  // now we can calculate the number of parallel running hook threads based on
-  // the number cpu cores and the number of active compute devices
-  // unless overwritten by the user
+  backend_ctx->target_msec  = TARGET_MSEC_PROFILE[user_options->workload_profile - 1];
 
-  if (user_options->hook_threads == HOOK_THREADS)
-  {
-    const u32 processor_count = hc_get_processor_count ();
+  backend_ctx->comptime = comptime;
 
-    const u32 processor_count_cu = CEILDIV (processor_count, backend_ctx->backend_devices_active); // should never reach 0
+  return 0;
+}
 
-    user_options->hook_threads = processor_count_cu;
-  }
+void backend_ctx_devices_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
 
-  // additional check to see if the user has chosen a device that is not within the range of available devices (i.e. larger than devices_cnt)
+  if (backend_ctx->enabled == false) return;
 
-  if (backend_ctx->backend_devices_cnt >= DEVICES_MAX)
+  for (u32 opencl_platforms_idx = 0; opencl_platforms_idx < backend_ctx->opencl_platforms_cnt; opencl_platforms_idx++)
   {
-    event_log_error (hashcat_ctx, "Illegal use of the --backend-devices parameter because too many backend devices were found (%u).", backend_ctx->backend_devices_cnt);
-    event_log_error (hashcat_ctx, "If possible, disable one of your backends to reduce the number of backend devices. For example \"--backend-ignore-cuda\" or \"--backend-ignore-opencl\" .");
-
-    return -1;
+    hcfree (backend_ctx->opencl_platforms_devices[opencl_platforms_idx]);
+    hcfree (backend_ctx->opencl_platforms_name[opencl_platforms_idx]);
+    hcfree (backend_ctx->opencl_platforms_vendor[opencl_platforms_idx]);
+    hcfree (backend_ctx->opencl_platforms_version[opencl_platforms_idx]);
   }
 
-  // time or resource intensive operations which we do not run if the corresponding device was skipped by the user
+  // one-time release context/command-queue from all runtimes
 
-  if (backend_ctx->cuda)
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
   {
-    // instruction test for cuda devices was replaced with fixed values (see above)
-
-    /*
-    CUcontext cuda_context;
-
-    if (hc_cuCtxCreate (hashcat_ctx, &cuda_context, CU_CTX_SCHED_BLOCKING_SYNC, device_param->cuda_device) == -1) return -1;
-
-    if (hc_cuCtxSetCurrent (hashcat_ctx, cuda_context) == -1) return -1;
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-    #define RUN_INSTRUCTION_CHECKS()                                                                                                                                                                                                                      \
-      device_param->has_add   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"add.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                              \
-      device_param->has_addc  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"addc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                             \
-      device_param->has_sub   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"sub.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                              \
-      device_param->has_subc  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"subc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                                             \
-      device_param->has_bfe   = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"bfe.u32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                              \
-      device_param->has_lop3  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"lop3.b32 %0, 0, 0, 0, 0;\" : \"=r\"(r)); }");                                                          \
-      device_param->has_mov64 = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned long long r; unsigned int a; unsigned int b; asm volatile (\"mov.b64 %0, {%1, %2};\" : \"=l\"(r) : \"r\"(a), \"r\"(b)); }");  \
-      device_param->has_prmt  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"prmt.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                             \
-      device_param->has_shfw  = cuda_test_instruction (hashcat_ctx, sm_major, sm_minor, "__global__ void test () { unsigned int r; asm volatile (\"shf.l.wrap.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                                       \
+    hcfree (device_param->device_name);
 
-    if (backend_devices_idx > 0)
+    if (device_param->is_cuda == true)
     {
-      hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
-
-      if (is_same_device_type (device_param, device_param_prev) == true)
-      {
-        device_param->has_add   = device_param_prev->has_add;
-        device_param->has_addc  = device_param_prev->has_addc;
-        device_param->has_sub   = device_param_prev->has_sub;
-        device_param->has_subc  = device_param_prev->has_subc;
-        device_param->has_bfe   = device_param_prev->has_bfe;
-        device_param->has_lop3  = device_param_prev->has_lop3;
-        device_param->has_mov64 = device_param_prev->has_mov64;
-        device_param->has_prmt  = device_param_prev->has_prmt;
-        device_param->has_shfw  = device_param_prev->has_shfw;
-      }
-      else
+      if (device_param->cuda_context)
       {
-        RUN_INSTRUCTION_CHECKS();
+        hc_cuCtxDestroy (hashcat_ctx, device_param->cuda_context);
+
+        device_param->cuda_context = NULL;
       }
     }
-    else
-    {
-      RUN_INSTRUCTION_CHECKS();
-    }
-
-    #undef RUN_INSTRUCTION_CHECKS
-
-    if (hc_cuCtxDestroy (hashcat_ctx, cuda_context) == -1) return -1;
 
-    */
-  }
-
-  if (backend_ctx->hip)
-  {
-    // TODO HIP?
-    // Maybe all devices supported by hip have these instructions guaranteed?
-
-    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+    if (device_param->is_hip == true)
     {
-      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
-
-      if (device_param->is_hip == false) continue;
-
-      device_param->has_vadd     = true;
-      device_param->has_vaddc    = true;
-      device_param->has_vadd_co  = true;
-      device_param->has_vaddc_co = true;
-      device_param->has_vsub     = true;
-      device_param->has_vsubb    = true;
-      device_param->has_vsub_co  = true;
-      device_param->has_vsubb_co = true;
-      device_param->has_vadd3    = true;
-      device_param->has_vbfe     = true;
-      device_param->has_vperm    = true;
+      hcfree (device_param->gcnArchName);
     }
-  }
 
-  #if defined (__APPLE__)
-  if (backend_ctx->mtl)
-  {
-    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
     {
-      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
-
-      if (device_param->is_metal == false) continue;
-
-      if (user_options->backend_info == 0)
-      {
-        // do not ignore in case -I because user expects a value also for skipped devices
-
-        if (device_param->skipped == true) continue;
-      }
-
-      // one-time init metal command-queue
-
-      if (hc_mtlCreateCommandQueue (hashcat_ctx, device_param->metal_device, &device_param->metal_command_queue) == -1)
+      if (device_param->metal_command_queue)
       {
-        device_param->skipped = true;
-
-        backend_ctx->metal_devices_active--;
-        backend_ctx->backend_devices_active--;
+        hc_mtlReleaseCommandQueue (hashcat_ctx, &device_param->metal_command_queue);
 
-        continue;
+        device_param->metal_command_queue = NULL;
       }
+    }
+    #endif
 
-      // available device memory
-      // This test causes an GPU memory usage spike.
-      // In case there are multiple hashcat instances starting at the same time this will cause GPU out of memory errors which otherwise would not exist.
-      // We will simply not run it if that device was skipped by the user.
-
-      #define MAX_ALLOC_CHECKS_CNT  8192
-      #define MAX_ALLOC_CHECKS_SIZE (64 * 1024 * 1024)
-
-      device_param->device_available_mem = device_param->device_global_mem - MAX_ALLOC_CHECKS_SIZE;
+    if (device_param->is_opencl == true)
+    {
+      hcfree (device_param->opencl_driver_version);
+      hcfree (device_param->opencl_device_version);
+      hcfree (device_param->opencl_device_c_version);
+      hcfree (device_param->opencl_device_vendor);
 
-      if (user_options->backend_devices_keepfree < 100)
-      {
-        device_param->device_available_mem = (device_param->device_global_mem * (100 - user_options->backend_devices_keepfree)) / 100;
-      }
-      // this section is creating more problems than it solves, so lets use a fixed multiplier instead
-      // users can override with --backend-devices-keepfree=100
-      else if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->device_host_unified_memory == 0))
+      if (device_param->opencl_command_queue)
       {
-        // following the same logic as for OpenCL, explained later
+        hc_clReleaseCommandQueue (hashcat_ctx, device_param->opencl_command_queue);
 
-        mtl_mem_t *tmp_device = (mtl_mem_t *) hccalloc (MAX_ALLOC_CHECKS_CNT, sizeof (mtl_mem_t));
+        device_param->opencl_command_queue = NULL;
+      }
 
-        u64 c;
+      if (device_param->opencl_context)
+      {
+        hc_clReleaseContext (hashcat_ctx, device_param->opencl_context);
 
-        for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
-        {
-          if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+        device_param->opencl_context = NULL;
+      }
+    }
+  }
 
-          // using SHARED by default here, no performance requirements
-          if (hc_mtlCreateBuffer (hashcat_ctx, device_param->metal_device, MAX_ALLOC_CHECKS_SIZE, NULL, &tmp_device[c], metal_shared_storageMode) == -1)
-          {
-            c--;
+  backend_ctx->backend_devices_cnt    = 0;
+  backend_ctx->backend_devices_active = 0;
+  backend_ctx->cuda_devices_cnt       = 0;
+  backend_ctx->cuda_devices_active    = 0;
+  backend_ctx->hip_devices_cnt        = 0;
+  backend_ctx->hip_devices_active     = 0;
+  backend_ctx->metal_devices_cnt      = 0;
+  backend_ctx->metal_devices_active   = 0;
+  backend_ctx->opencl_devices_cnt     = 0;
+  backend_ctx->opencl_devices_active  = 0;
 
-            break;
-          }
+  backend_ctx->need_adl             = false;
+  backend_ctx->need_nvml            = false;
+  backend_ctx->need_nvapi           = false;
+  backend_ctx->need_sysfs_amdgpu    = false;
+  backend_ctx->need_sysfs_intelgpu  = false;
+  backend_ctx->need_sysfs_cpu       = false;
+  backend_ctx->need_iokit           = false;
+}
 
-          // transfer only a few byte should be enough to force the runtime to actually allocate the memory
+void backend_ctx_devices_sync_tuning (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t   *backend_ctx  = hashcat_ctx->backend_ctx;
+  bridge_ctx_t    *bridge_ctx   = hashcat_ctx->bridge_ctx;
+  hashconfig_t    *hashconfig   = hashcat_ctx->hashconfig;
+  user_options_t  *user_options = hashcat_ctx->user_options;
 
-          u8 tmp_host[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+  if (backend_ctx->enabled == false) return;
 
-          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_device[c], 0, tmp_host, sizeof (tmp_host)) == -1) break;
-          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_host, tmp_device[c], 0, sizeof (tmp_host)) == -1) break;
+  for (int backend_devices_cnt_src = 0; backend_devices_cnt_src < backend_ctx->backend_devices_cnt; backend_devices_cnt_src++)
+  {
+    hc_device_param_t *device_param_src = &backend_ctx->devices_param[backend_devices_cnt_src];
 
-          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_device[c], MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), tmp_host, sizeof (tmp_host)) == -1) break;
-          if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, tmp_host, tmp_device[c], MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host)) == -1) break;
-        }
+    if (device_param_src->skipped == true) continue;
+    if (device_param_src->skipped_warning == true) continue;
 
-        device_param->device_available_mem = MAX_ALLOC_CHECKS_SIZE;
+    for (int backend_devices_cnt_dst = backend_devices_cnt_src + 1; backend_devices_cnt_dst < backend_ctx->backend_devices_cnt; backend_devices_cnt_dst++)
+    {
+      hc_device_param_t *device_param_dst = &backend_ctx->devices_param[backend_devices_cnt_dst];
 
-        if (c > 0)
-        {
-          device_param->device_available_mem *= c;
-        }
+      if (device_param_dst->skipped == true) continue;
+      if (device_param_dst->skipped_warning == true) continue;
 
-        // clean up
+      if (is_same_device_type (device_param_src, device_param_dst) == false) continue;
 
-        for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
-        {
-          if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+      device_param_dst->kernel_accel   = device_param_src->kernel_accel;
+      device_param_dst->kernel_loops   = device_param_src->kernel_loops;
+      device_param_dst->kernel_threads = device_param_src->kernel_threads;
 
-          if (tmp_device[c].buf_ptr != NULL)
-          {
-            if (hc_mtlReleaseMemObject (hashcat_ctx, &tmp_device[c]) == -1) return -1;
-          }
-        }
+      const u32 hardware_power = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param_dst->device_processors)
+                               * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param_dst->kernel_threads);
 
-        hcfree (tmp_device);
-      }
+      device_param_dst->hardware_power = hardware_power;
 
-      if (device_param->device_host_unified_memory == 1)
-      {
-        // so, we actually have only half the memory because we need the same buffers on host side
+      const u32 kernel_power = device_param_dst->hardware_power * device_param_dst->kernel_accel;
 
-        device_param->device_available_mem /= 2;
-      }
+      device_param_dst->kernel_power = kernel_power;
     }
   }
-  #endif // __APPLE__
 
-  if (backend_ctx->ocl)
+  // bridge overrides everything
+
+  if (hashconfig->bridge_type)
   {
     for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
     {
       hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
 
-      if (device_param->is_opencl == false) continue;
+      if (device_param->skipped == true) continue;
+      if (device_param->skipped_warning == true) continue;
 
-      if (user_options->backend_info == 0)
-      {
-        // do not ignore in case -I because user expects a value also for skipped devices
+      int workitem_count = bridge_ctx->get_workitem_count (bridge_ctx->platform_context, device_param->bridge_link_device);
 
-        if (device_param->skipped == true) continue;
+           if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_001) workitem_count = 1;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_002) workitem_count = 2;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_004) workitem_count = 4;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_008) workitem_count = 8;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_016) workitem_count = 16;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_032) workitem_count = 32;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_064) workitem_count = 64;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_128) workitem_count = 128;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_256) workitem_count = 256;
+
+      if ((int) device_param->kernel_power < workitem_count)
+      {
+        if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u/Bridge #%u: kernel_power:%" PRIu64 " < workitem_count:%d", device_param->device_id + 1, device_param->bridge_link_device + 1, device_param->kernel_power, workitem_count);
       }
 
-      // one-time init opencl context
+      device_param->kernel_power = workitem_count;
+    }
+  }
+}
 
-      /*
-      cl_context_properties properties[3];
+void backend_ctx_devices_update_power (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
+  status_ctx_t         *status_ctx          = hashcat_ctx->status_ctx;
+  user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
+  user_options_t       *user_options        = hashcat_ctx->user_options;
 
-      properties[0] = CL_CONTEXT_PLATFORM;
-      properties[1] = (cl_context_properties) device_param->opencl_platform;
-      properties[2] = 0;
+  if (backend_ctx->enabled == false) return;
 
-      CL_rc = hc_clCreateContext (hashcat_ctx, properties, 1, &device_param->opencl_device, NULL, NULL, &device_param->opencl_context);
-      */
+  u32 kernel_power_all = 0;
 
-      if (hc_clCreateContext (hashcat_ctx, NULL, 1, &device_param->opencl_device, NULL, NULL, &device_param->opencl_context) == -1)
-      {
-        device_param->skipped = true;
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-        backend_ctx->opencl_devices_active--;
-        backend_ctx->backend_devices_active--;
+    if (device_param->skipped == true) continue;
+    if (device_param->skipped_warning == true) continue;
 
-        continue;
-      }
+    kernel_power_all += device_param->kernel_power;
+  }
 
-      // one-time init open command-queue
+  backend_ctx->kernel_power_all = kernel_power_all;
 
-      if (hc_clCreateCommandQueue (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, CL_QUEUE_PROFILING_ENABLE, &device_param->opencl_command_queue) == -1)
-      {
-        device_param->skipped = true;
+  /*
+   * Inform user about possible slow speeds
+   */
 
-        backend_ctx->opencl_devices_active--;
-        backend_ctx->backend_devices_active--;
+  if ((user_options_extra->wordlist_mode == WL_MODE_FILE) || (user_options_extra->wordlist_mode == WL_MODE_MASK))
+  {
+    if (status_ctx->words_base < kernel_power_all)
+    {
+      if (user_options->quiet == false)
+      {
+        clear_prompt (hashcat_ctx);
 
-        continue;
+        event_log_advice (hashcat_ctx, "The wordlist or mask that you are using is too small.");
+        event_log_advice (hashcat_ctx, "This means that hashcat cannot use the full parallel power of your device(s).");
+        event_log_advice (hashcat_ctx, "Hashcat is expecting at least %" PRIu64 " base words but only got %.1f%% of that.", backend_ctx->kernel_power_all, (100.f * status_ctx->words_base) / backend_ctx->kernel_power_all);
+        event_log_advice (hashcat_ctx, "Unless you supply more work, your cracking speed will drop.");
+        event_log_advice (hashcat_ctx, "For tips on supplying more work, see: https://hashcat.net/faq/morework");
+        event_log_advice (hashcat_ctx, NULL);
       }
+    }
+  }
+}
 
-      // instruction set
-
-      if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD))
-      {
-        #define RUN_INSTRUCTION_CHECKS() \
-          device_param->has_vadd     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD_U32     %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vaddc    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADDC_U32    %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
-          device_param->has_vadd_co  = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD_CO_U32  %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vaddc_co = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADDC_CO_U32 %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
-          device_param->has_vsub     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUB_U32     %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vsubb    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUBB_U32    %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
-          device_param->has_vsub_co  = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUB_CO_U32  %0, vcc, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vsubb_co = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_SUBB_CO_U32 %0, vcc, 0, 0, vcc;\" : \"=v\"(r1)); }"); \
-          device_param->has_vadd3    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_ADD3_U32    %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vbfe     = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_BFE_U32     %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
-          device_param->has_vperm    = opencl_test_instruction (hashcat_ctx, device_param->opencl_context, device_param->opencl_device, "__kernel void test () { uint r1; __asm__ __volatile__ (\"V_PERM_B32    %0,   0, 0, 0;\"      : \"=v\"(r1)); }"); \
-
-        if (backend_devices_idx > 0)
-        {
-          hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
+void backend_ctx_devices_kernel_loops (hashcat_ctx_t *hashcat_ctx)
+{
+  combinator_ctx_t     *combinator_ctx      = hashcat_ctx->combinator_ctx;
+  hashconfig_t         *hashconfig          = hashcat_ctx->hashconfig;
+  hashes_t             *hashes              = hashcat_ctx->hashes;
+  mask_ctx_t           *mask_ctx            = hashcat_ctx->mask_ctx;
+  backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
+  straight_ctx_t       *straight_ctx        = hashcat_ctx->straight_ctx;
+  user_options_t       *user_options        = hashcat_ctx->user_options;
+  user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
 
-          if (is_same_device_type (device_param, device_param_prev) == true)
-          {
-            device_param->has_vadd     = device_param_prev->has_vadd;
-            device_param->has_vaddc    = device_param_prev->has_vaddc;
-            device_param->has_vadd_co  = device_param_prev->has_vadd_co;
-            device_param->has_vaddc_co = device_param_prev->has_vaddc_co;
-            device_param->has_vsub     = device_param_prev->has_vsub;
-            device_param->has_vsubb    = device_param_prev->has_vsubb;
-            device_param->has_vsub_co  = device_param_prev->has_vsub_co;
-            device_param->has_vsubb_co = device_param_prev->has_vsubb_co;
-            device_param->has_vadd3    = device_param_prev->has_vadd3;
-            device_param->has_vbfe     = device_param_prev->has_vbfe;
-            device_param->has_vperm    = device_param_prev->has_vperm;
-          }
-          else
-          {
-            RUN_INSTRUCTION_CHECKS();
-          }
-        }
-        else
-        {
-          RUN_INSTRUCTION_CHECKS();
-        }
+  if (backend_ctx->enabled == false) return;
 
-        #undef RUN_INSTRUCTION_CHECKS
-      }
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-      if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->opencl_platform_vendor_id == VENDOR_ID_NV))
-      {
-        // replaced with fixed values see non time intensive section above
+    if (device_param->skipped == true) continue;
+    if (device_param->skipped_warning == true) continue;
 
-        /*
-        #define RUN_INSTRUCTION_CHECKS()                                                                                                                                                                                                          \
-          device_param->has_add   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"add.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                        \
-          device_param->has_addc  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"addc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                       \
-          device_param->has_sub   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"sub.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                        \
-          device_param->has_subc  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"subc.cc.u32 %0, 0, 0;\" : \"=r\"(r)); }");                                       \
-          device_param->has_bfe   = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"bfe.u32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                        \
-          device_param->has_lop3  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"lop3.b32 %0, 0, 0, 0, 0;\" : \"=r\"(r)); }");                                    \
-          device_param->has_mov64 = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { ulong r; uint a; uint b; asm volatile (\"mov.b64 %0, {%1, %2};\" : \"=l\"(r) : \"r\"(a), \"r\"(b)); }"); \
-          device_param->has_prmt  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"prmt.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                       \
-          device_param->has_shfw  = opencl_test_instruction (hashcat_ctx, context, device_param->opencl_device, "__kernel void test () { uint r; asm volatile (\"shf.l.wrap.b32 %0, 0, 0, 0;\" : \"=r\"(r)); }");                                 \
+    device_param->kernel_loops_min = device_param->kernel_loops_min_sav;
+    device_param->kernel_loops_max = device_param->kernel_loops_max_sav;
 
-        if (backend_devices_idx > 0)
-        {
-          hc_device_param_t *device_param_prev = &devices_param[backend_devices_idx - 1];
+    if (device_param->kernel_loops_min < device_param->kernel_loops_max)
+    {
+      u64 innerloop_cnt = 0;
 
-          if (is_same_device_type (device_param, device_param_prev) == true)
-          {
-            device_param->has_add   = device_param_prev->has_add;
-            device_param->has_addc  = device_param_prev->has_addc;
-            device_param->has_sub   = device_param_prev->has_sub;
-            device_param->has_subc  = device_param_prev->has_subc;
-            device_param->has_bfe   = device_param_prev->has_bfe;
-            device_param->has_lop3  = device_param_prev->has_lop3;
-            device_param->has_mov64 = device_param_prev->has_mov64;
-            device_param->has_prmt  = device_param_prev->has_prmt;
-            device_param->has_shfw  = device_param_prev->has_shfw;
-          }
-          else
-          {
-            RUN_INSTRUCTION_CHECKS();
-          }
+      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+      {
+        if (user_options->slow_candidates == true)
+        {
+          innerloop_cnt = 1;
         }
         else
         {
-          RUN_INSTRUCTION_CHECKS();
+          if      (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)  innerloop_cnt = MIN (KERNEL_RULES, straight_ctx->kernel_rules_cnt);
+          else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)     innerloop_cnt = MIN (KERNEL_COMBS, combinator_ctx->combs_cnt);
+          else if (user_options_extra->attack_kern == ATTACK_KERN_BF)        innerloop_cnt = MIN (KERNEL_BFS,   mask_ctx->bfs_cnt);
         }
+      }
+      else
+      {
+        innerloop_cnt = hashes->salts_buf[0].salt_iter;
+      }
 
-        #undef RUN_INSTRUCTION_CHECKS
-        */
+      if ((innerloop_cnt >= device_param->kernel_loops_min) &&
+          (innerloop_cnt <= device_param->kernel_loops_max))
+      {
+        device_param->kernel_loops_max = innerloop_cnt;
       }
+    }
+  }
+}
 
-      // available device memory
-      // first trying to check if we can get device_available_mem from cuda/hip alias device
+static int get_cuda_kernel_wgs (hashcat_ctx_t *hashcat_ctx, CUfunction function, u32 *result)
+{
+  int max_threads_per_block;
 
-      bool updated_device_available_mem = false;
+  if (hc_cuFuncGetAttribute (hashcat_ctx, &max_threads_per_block, CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, function) == -1) return -1;
 
-      if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
-      {
-        if (device_param->opencl_platform_vendor_id == VENDOR_ID_NV)
-        {
-          if (backend_ctx->cuda_devices_cnt > 0 && backend_ctx->cuda_devices_active > 0)
-          {
-            for (int cuda_devices_idx = 0; cuda_devices_idx < backend_ctx->cuda_devices_cnt; cuda_devices_idx++)
-            {
-              const int tmp_backend_devices_idx = backend_ctx->backend_device_from_cuda[cuda_devices_idx];
+  *result = (u32) max_threads_per_block;
 
-              hc_device_param_t *tmp_device_param = backend_ctx->devices_param + tmp_backend_devices_idx;
+  return 0;
+}
 
-              if (is_same_device (device_param, tmp_device_param))
-              {
-                device_param->device_available_mem = tmp_device_param->device_available_mem;
-                updated_device_available_mem       = true;
-                break;
-              }
-            }
-          }
-        }
-        else if (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD)
-        {
-          if (backend_ctx->hip_devices_cnt > 0 && backend_ctx->hip_devices_active > 0)
-          {
-            for (int hip_devices_idx = 0; hip_devices_idx < backend_ctx->hip_devices_cnt; hip_devices_idx++)
-            {
-              const int tmp_backend_devices_idx = backend_ctx->backend_device_from_hip[hip_devices_idx];
+static int get_cuda_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, CUfunction function, u64 *result)
+{
+  int shared_size_bytes;
 
-              hc_device_param_t *tmp_device_param = backend_ctx->devices_param + tmp_backend_devices_idx;
+  if (hc_cuFuncGetAttribute (hashcat_ctx, &shared_size_bytes, CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, function) == -1) return -1;
 
-              if (is_same_device (device_param, tmp_device_param))
-              {
-                device_param->device_available_mem = tmp_device_param->device_available_mem;
-                updated_device_available_mem       = true;
-                break;
-              }
-            }
-          }
-        }
-      }
+  *result = (u64) shared_size_bytes;
 
-      // if not found ... use old strategy
+  return 0;
+}
 
-      if (updated_device_available_mem == false)
-      {
-        // This test causes an GPU memory usage spike.
-        // In case there are multiple hashcat instances starting at the same time this will cause GPU out of memory errors which otherwise would not exist.
-        // We will simply not run it if that device was skipped by the user.
+static int get_hip_kernel_wgs (hashcat_ctx_t *hashcat_ctx, hipFunction_t function, u32 *result)
+{
+  int max_threads_per_block;
 
-        if (device_param->device_global_mem)
-        {
-          #define MAX_ALLOC_CHECKS_CNT  8192
-          #define MAX_ALLOC_CHECKS_SIZE (64 * 1024 * 1024)
+  if (hc_hipFuncGetAttribute (hashcat_ctx, &max_threads_per_block, HIP_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, function) == -1) return -1;
 
-          device_param->device_available_mem = device_param->device_global_mem - MAX_ALLOC_CHECKS_SIZE;
+  *result = (u32) max_threads_per_block;
 
-          if (user_options->backend_devices_keepfree < 100)
-          {
-            device_param->device_available_mem = (device_param->device_global_mem * (100 - user_options->backend_devices_keepfree)) / 100;
-          }
-          // this section is creating more problems than it solves, so lets use a fixed multiplier instead
-          // users can override with --backend-devices-keepfree=100
-          else if ((device_param->opencl_device_type & CL_DEVICE_TYPE_GPU) && (device_param->device_host_unified_memory == 0))
-          {
-            // OK, so the problem here is the following:
-            // There's just CL_DEVICE_GLOBAL_MEM_SIZE to ask OpenCL about the total memory on the device,
-            // but there's no way to ask for available memory on the device.
-            // In combination, most OpenCL runtimes implementation of clCreateBuffer()
-            // are doing so called lazy memory allocation on the device.
-            // Now, if the user has X11 (or a game or anything that takes a lot of GPU memory)
-            // running on the host we end up with an error type of this:
-            // clEnqueueNDRangeKernel(): CL_MEM_OBJECT_ALLOCATION_FAILURE
-            // The clEnqueueNDRangeKernel() is because of the lazy allocation
-            // The best way to workaround this problem is if we would be able to ask for available memory,
-            // The idea here is to try to evaluate available memory by allocating it till it errors
+  return 0;
+}
 
-            cl_mem *tmp_device = (cl_mem *) hccalloc (MAX_ALLOC_CHECKS_CNT, sizeof (cl_mem));
+static int get_hip_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, hipFunction_t function, u64 *result)
+{
+  int shared_size_bytes;
 
-            u64 c;
+  if (hc_hipFuncGetAttribute (hashcat_ctx, &shared_size_bytes, HIP_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, function) == -1) return -1;
 
-            for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
-            {
-              if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+  *result = (u64) shared_size_bytes;
 
-              // work around, for some reason apple opencl can't have buffers larger 2^31
-              // typically runs into trap 6
-              // maybe 32/64 bit problem affecting size_t?
-              // this seems to affect global memory as well no just single allocations
-              // this is really ugly, and still in place 2025/06/09
-              //  Version.: OpenCL 1.2 (Apr 18 2025 21:45:30)
-              //  Driver.Version.: 1.2 (Apr 22 2025 20:11:41)
+  return 0;
+}
 
-              if ((device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE) && (device_param->is_metal == false))
-              {
-                const size_t undocumented_single_allocation_apple = 0x7fffffff;
+#if defined (__APPLE__)
+static int get_metal_kernel_wgs (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u32 *result)
+{
+  return hc_mtlGetMaxTotalThreadsPerThreadgroup (hashcat_ctx, pipeline, result);
+}
 
-                if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= undocumented_single_allocation_apple) break;
-              }
+static int get_metal_kernel_preferred_wgs_multiple (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u32 *result)
+{
+  return hc_mtlGetThreadExecutionWidth (hashcat_ctx, pipeline, result);
+}
 
-              cl_int CL_err;
+static int get_metal_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u64 *result)
+{
+  return hc_mtlGetStaticThreadgroupMemoryLength (hashcat_ctx, pipeline, (unsigned int *) result);
+}
+#endif
 
-              OCL_PTR *ocl = (OCL_PTR *) backend_ctx->ocl;
+static int get_opencl_kernel_wgs (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u32 *result)
+{
+  user_options_t *user_options = hashcat_ctx->user_options;
 
-              tmp_device[c] = ocl->clCreateBuffer (device_param->opencl_context, CL_MEM_READ_WRITE, MAX_ALLOC_CHECKS_SIZE, NULL, &CL_err);
+  size_t work_group_size = 0;
 
-              if (CL_err != CL_SUCCESS)
-              {
-                c--;
+  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_WORK_GROUP_SIZE, sizeof (work_group_size), &work_group_size, NULL) == -1) return -1;
 
-                break;
-              }
+  u32 kernel_threads = (u32) work_group_size;
 
-              // transfer only a few byte should be enough to force the runtime to actually allocate the memory
+  size_t compile_work_group_size[3] = { 0, 0, 0 };
 
-              u8 tmp_host[8];
+  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_COMPILE_WORK_GROUP_SIZE, sizeof (compile_work_group_size), &compile_work_group_size, NULL) == -1) return -1;
 
-              if (ocl->clEnqueueReadBuffer  (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, 0, sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
-              if (ocl->clEnqueueWriteBuffer (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, 0, sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
+  const size_t cwgs_total = compile_work_group_size[0] * compile_work_group_size[1] * compile_work_group_size[2];
 
-              if (ocl->clEnqueueReadBuffer  (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
-              if (ocl->clEnqueueWriteBuffer (device_param->opencl_command_queue, tmp_device[c], CL_TRUE, MAX_ALLOC_CHECKS_SIZE - sizeof (tmp_host), sizeof (tmp_host), tmp_host, 0, NULL, NULL) != CL_SUCCESS) break;
-            }
+  if (cwgs_total > 0)
+  {
+    if (kernel_threads < cwgs_total)
+    {
+      // Very likely some bug, because the runtime was unable to follow our requirement to run N threads guaranteed on this kernel
+      if (user_options->machine_readable == false)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Runtime returned CL_KERNEL_WORK_GROUP_SIZE=%d, but CL_KERNEL_COMPILE_WORK_GROUP_SIZE=%d. Use -T%d if you run into problems.", device_param->device_id + 1, (int) kernel_threads, (int) cwgs_total, (int) kernel_threads);
+      }
+    }
 
-            device_param->device_available_mem = MAX_ALLOC_CHECKS_SIZE;
+    kernel_threads = cwgs_total;
+  }
 
-            if (c > 0)
-            {
-              device_param->device_available_mem *= c;
-            }
+  *result = kernel_threads;
 
-            // clean up
+  return 0;
+}
 
-            int r = 0;
+static int get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u32 *result)
+{
+  size_t preferred_work_group_size_multiple = 0;
 
-            for (c = 0; c < MAX_ALLOC_CHECKS_CNT; c++)
-            {
-              if (((c + 1 + 1) * MAX_ALLOC_CHECKS_SIZE) >= device_param->device_global_mem) break;
+  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof (preferred_work_group_size_multiple), &preferred_work_group_size_multiple, NULL) == -1) return -1;
 
-              if (tmp_device[c] != NULL)
-              {
-                if (hc_clReleaseMemObjectPtr (hashcat_ctx, &tmp_device[c]) == -1) r = -1;
-              }
-            }
+  *result = (u32) preferred_work_group_size_multiple;
+
+  return 0;
+}
+
+static int get_opencl_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u64 *result)
+{
+  cl_ulong local_mem_size = 0;
 
-            hcfree (tmp_device);
+  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof (local_mem_size), &local_mem_size, NULL) == -1) return -1;
 
-            if (r == -1)
-            {
-              // return -1 here is blocking, to be better evaluated
-              //return -1;
-            }
-          }
-        }
+  *result = local_mem_size;
 
-        if (device_param->device_host_unified_memory == 1)
-        {
-          // so, we actually have only half the memory because we need the same buffers on host side
+  return 0;
+}
 
-          device_param->device_available_mem /= 2;
-        }
-      }
-    }
-  }
+static int get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u64 *result)
+{
+  cl_ulong dynamic_local_mem_size = 0;
 
-  // check again to catch error on OpenCL/Metal
-  if (backend_ctx->backend_devices_active == 0)
-  {
-    event_log_error (hashcat_ctx, "No devices found/left.");
+  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof (dynamic_local_mem_size), &dynamic_local_mem_size, NULL) == -1) return -1;
 
-    return -1;
-  }
+  // unknown how to query this information in OpenCL
+  // we therefore reset to zero
+  // the above call to hc_clGetKernelWorkGroupInfo() is just to avoid compiler warnings
 
-  backend_ctx->target_msec  = TARGET_MSEC_PROFILE[user_options->workload_profile - 1];
+  dynamic_local_mem_size = 0;
 
-  backend_ctx->comptime = comptime;
+  *result = dynamic_local_mem_size;
 
   return 0;
 }
 
-void backend_ctx_devices_destroy (hashcat_ctx_t *hashcat_ctx)
+#if defined (__APPLE__)
+static bool load_kernel_locked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, mtl_library *metal_library)
+#else
+static bool load_kernel_locked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, MAYBE_UNUSED void *metal_library)
+#endif
 {
-  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+  const backend_ctx_t   *backend_ctx   = hashcat_ctx->backend_ctx;
+  const hashconfig_t    *hashconfig    = hashcat_ctx->hashconfig;
+  const user_options_t  *user_options  = hashcat_ctx->user_options;
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
 
-  if (backend_ctx->enabled == false) return;
+  bool cached = true;
 
-  for (u32 opencl_platforms_idx = 0; opencl_platforms_idx < backend_ctx->opencl_platforms_cnt; opencl_platforms_idx++)
+  if (cache_disable == true)
   {
-    hcfree (backend_ctx->opencl_platforms_devices[opencl_platforms_idx]);
-    hcfree (backend_ctx->opencl_platforms_name[opencl_platforms_idx]);
-    hcfree (backend_ctx->opencl_platforms_vendor[opencl_platforms_idx]);
-    hcfree (backend_ctx->opencl_platforms_version[opencl_platforms_idx]);
+    cached = false;
   }
 
-  // one-time release context/command-queue from all runtimes
+  if (hc_path_read (cached_file) == false)
+  {
+    cached = false;
+  }
 
-  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  if (hc_path_is_empty (cached_file) == true)
   {
-    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+    cached = false;
+  }
 
-    hcfree (device_param->device_name);
+  /**
+   * kernel compile or load
+   */
+
+  size_t kernel_lengths_buf = 0;
+
+  size_t *kernel_lengths = &kernel_lengths_buf;
+
+  char *kernel_sources_buf = NULL;
+
+  char **kernel_sources = &kernel_sources_buf;
+
+  if (cached == false)
+  {
+    #if defined (DEBUG)
+    if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s not found in cache. Please be patient...", device_param->device_id + 1, filename_from_filepath (cached_file));
+    #endif
+
+    if (read_kernel_binary (hashcat_ctx, source_file, kernel_lengths, kernel_sources) == false) return false;
 
     if (device_param->is_cuda == true)
     {
-      if (device_param->cuda_context)
-      {
-        hc_cuCtxDestroy (hashcat_ctx, device_param->cuda_context);
+      nvrtcProgram program;
 
-        device_param->cuda_context = NULL;
-      }
-    }
+      if (hc_nvrtcCreateProgram (hashcat_ctx, &program, kernel_sources[0], kernel_name, 0, NULL, NULL) == -1) return false;
 
-    if (device_param->is_hip == true)
-    {
-      hcfree (device_param->gcnArchName);
-    }
+      char **nvrtc_options = (char **) hccalloc (16 + strlen (build_options_buf) + 1, sizeof (char *)); // ...
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      if (device_param->metal_command_queue)
-      {
-        hc_mtlReleaseCommandQueue (hashcat_ctx, &device_param->metal_command_queue);
+      int nvrtc_options_idx = 0;
 
-        device_param->metal_command_queue = NULL;
+      if (backend_ctx->nvrtc_driver_version >= 12000)
+      {
+        nvrtc_options[nvrtc_options_idx++] = "--std=c++14";
       }
-    }
-    #endif
 
-    if (device_param->is_opencl == true)
-    {
-      hcfree (device_param->opencl_driver_version);
-      hcfree (device_param->opencl_device_version);
-      hcfree (device_param->opencl_device_c_version);
-      hcfree (device_param->opencl_device_vendor);
+      //nvrtc_options[nvrtc_options_idx++] = "--restrict";
+      nvrtc_options[nvrtc_options_idx++] = "--gpu-architecture";
 
-      if (device_param->opencl_command_queue)
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "compute_%d", (device_param->sm_major * 10) + device_param->sm_minor);
+
+      if (backend_ctx->nvrtc_driver_version >= 12010)
       {
-        hc_clReleaseCommandQueue (hashcat_ctx, device_param->opencl_command_queue);
+        nvrtc_options[nvrtc_options_idx++] = "--split-compile";
 
-        device_param->opencl_command_queue = NULL;
+        hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "%d", 0);
       }
 
-      if (device_param->opencl_context)
+      if (backend_ctx->nvrtc_driver_version >= 12040)
       {
-        hc_clReleaseContext (hashcat_ctx, device_param->opencl_context);
-
-        device_param->opencl_context = NULL;
+        nvrtc_options[nvrtc_options_idx++] = "--minimal";
       }
-    }
-  }
 
-  backend_ctx->backend_devices_cnt    = 0;
-  backend_ctx->backend_devices_active = 0;
-  backend_ctx->cuda_devices_cnt       = 0;
-  backend_ctx->cuda_devices_active    = 0;
-  backend_ctx->hip_devices_cnt        = 0;
-  backend_ctx->hip_devices_active     = 0;
-  backend_ctx->metal_devices_cnt      = 0;
-  backend_ctx->metal_devices_active   = 0;
-  backend_ctx->opencl_devices_cnt     = 0;
-  backend_ctx->opencl_devices_active  = 0;
+      // untested on windows, but it should work
+      #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D INCLUDE_PATH=%s", "OpenCL");
+      #else
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D INCLUDE_PATH=%s", folder_config->cpath_real);
+      #endif
 
-  backend_ctx->need_adl             = false;
-  backend_ctx->need_nvml            = false;
-  backend_ctx->need_nvapi           = false;
-  backend_ctx->need_sysfs_amdgpu    = false;
-  backend_ctx->need_sysfs_intelgpu  = false;
-  backend_ctx->need_sysfs_cpu       = false;
-  backend_ctx->need_iokit           = false;
-}
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D XM2S(x)=#x");
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D M2S(x)=XM2S(x)");
+      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D MAX_THREADS_PER_BLOCK=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
 
-void backend_ctx_devices_sync_tuning (hashcat_ctx_t *hashcat_ctx)
-{
-  backend_ctx_t   *backend_ctx  = hashcat_ctx->backend_ctx;
-  bridge_ctx_t    *bridge_ctx   = hashcat_ctx->bridge_ctx;
-  hashconfig_t    *hashconfig   = hashcat_ctx->hashconfig;
-  user_options_t  *user_options = hashcat_ctx->user_options;
+      char *nvrtc_options_string = hcstrdup (build_options_buf);
 
-  if (backend_ctx->enabled == false) return;
+      const int num_options = nvrtc_options_idx + nvrtc_make_options_array_from_string (nvrtc_options_string, nvrtc_options + nvrtc_options_idx);
 
-  for (int backend_devices_cnt_src = 0; backend_devices_cnt_src < backend_ctx->backend_devices_cnt; backend_devices_cnt_src++)
-  {
-    hc_device_param_t *device_param_src = &backend_ctx->devices_param[backend_devices_cnt_src];
+      const int rc_nvrtcCompileProgram = hc_nvrtcCompileProgram (hashcat_ctx, program, num_options, (const char * const *) nvrtc_options);
 
-    if (device_param_src->skipped == true) continue;
-    if (device_param_src->skipped_warning == true) continue;
+      hcfree (nvrtc_options_string);
+      hcfree (nvrtc_options);
 
-    for (int backend_devices_cnt_dst = backend_devices_cnt_src + 1; backend_devices_cnt_dst < backend_ctx->backend_devices_cnt; backend_devices_cnt_dst++)
-    {
-      hc_device_param_t *device_param_dst = &backend_ctx->devices_param[backend_devices_cnt_dst];
+      size_t build_log_size = 0;
 
-      if (device_param_dst->skipped == true) continue;
-      if (device_param_dst->skipped_warning == true) continue;
+      hc_nvrtcGetProgramLogSize (hashcat_ctx, program, &build_log_size);
 
-      if (is_same_device_type (device_param_src, device_param_dst) == false) continue;
+      #if defined (DEBUG)
+      if ((build_log_size > 1) || (rc_nvrtcCompileProgram == -1))
+      #else
+      if (rc_nvrtcCompileProgram == -1)
+      #endif
+      {
+        char *build_log = (char *) hcmalloc (build_log_size + 1);
 
-      device_param_dst->kernel_accel   = device_param_src->kernel_accel;
-      device_param_dst->kernel_loops   = device_param_src->kernel_loops;
-      device_param_dst->kernel_threads = device_param_src->kernel_threads;
+        if (hc_nvrtcGetProgramLog (hashcat_ctx, program, build_log) == -1)
+        {
+          hcfree (build_log);
 
-      const u32 hardware_power = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param_dst->device_processors)
-                               * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param_dst->kernel_threads);
+          return false;
+        }
 
-      device_param_dst->hardware_power = hardware_power;
+        build_log[build_log_size] = 0;
 
-      const u32 kernel_power = device_param_dst->hardware_power * device_param_dst->kernel_accel;
+        puts (build_log);
 
-      device_param_dst->kernel_power = kernel_power;
-    }
-  }
+        hcfree (build_log);
+      }
 
-  // bridge overrides everything
+      if (rc_nvrtcCompileProgram == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-  if (hashconfig->bridge_type)
-  {
-    for (int backend_devices_cnt = 0; backend_devices_cnt < backend_ctx->backend_devices_cnt; backend_devices_cnt++)
-    {
-      hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_cnt];
+        return false;
+      }
 
-      if (device_param->skipped == true) continue;
-      if (device_param->skipped_warning == true) continue;
+      size_t binary_size = 0;
 
-      int workitem_count = bridge_ctx->get_workitem_count (bridge_ctx->platform_context, device_param->bridge_link_device);
+      if (hc_nvrtcGetPTXSize (hashcat_ctx, program, &binary_size) == -1) return false;
 
-           if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_001) workitem_count = 1;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_002) workitem_count = 2;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_004) workitem_count = 4;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_008) workitem_count = 8;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_016) workitem_count = 16;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_032) workitem_count = 32;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_064) workitem_count = 64;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_128) workitem_count = 128;
-      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_256) workitem_count = 256;
+      char *binary = (char *) hcmalloc (binary_size);
 
-      if ((int) device_param->kernel_power < workitem_count)
-      {
-        if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u/Bridge #%u: kernel_power:%" PRIu64 " < workitem_count:%d", device_param->device_id + 1, device_param->bridge_link_device + 1, device_param->kernel_power, workitem_count);
-      }
+      if (hc_nvrtcGetPTX (hashcat_ctx, program, binary) == -1) return false;
 
-      device_param->kernel_power = workitem_count;
-    }
-  }
-}
+      if (hc_nvrtcDestroyProgram (hashcat_ctx, &program) == -1) return false;
+
+      #define LOG_SIZE 8192
+
+      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
+      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
 
-void backend_ctx_devices_update_power (hashcat_ctx_t *hashcat_ctx)
-{
-  backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
-  status_ctx_t         *status_ctx          = hashcat_ctx->status_ctx;
-  user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
-  user_options_t       *user_options        = hashcat_ctx->user_options;
+      int mod_cnt = 6;
 
-  if (backend_ctx->enabled == false) return;
+      CUjit_option mod_opts[7];
+      void *mod_vals[7];
 
-  u32 kernel_power_all = 0;
+      mod_opts[0] = CU_JIT_TARGET_FROM_CUCONTEXT;
+      mod_vals[0] = (void *) 0;
 
-  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
-  {
-    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+      mod_opts[1] = CU_JIT_LOG_VERBOSE;
+      mod_vals[1] = (void *) 1;
 
-    if (device_param->skipped == true) continue;
-    if (device_param->skipped_warning == true) continue;
+      mod_opts[2] = CU_JIT_INFO_LOG_BUFFER;
+      mod_vals[2] = (void *) mod_info_log;
 
-    kernel_power_all += device_param->kernel_power;
-  }
+      mod_opts[3] = CU_JIT_INFO_LOG_BUFFER_SIZE_BYTES;
+      mod_vals[3] = (void *) LOG_SIZE;
 
-  backend_ctx->kernel_power_all = kernel_power_all;
+      mod_opts[4] = CU_JIT_ERROR_LOG_BUFFER;
+      mod_vals[4] = (void *) mod_error_log;
 
-  /*
-   * Inform user about possible slow speeds
-   */
+      mod_opts[5] = CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES;
+      mod_vals[5] = (void *) LOG_SIZE;
 
-  if ((user_options_extra->wordlist_mode == WL_MODE_FILE) || (user_options_extra->wordlist_mode == WL_MODE_MASK))
-  {
-    if (status_ctx->words_base < kernel_power_all)
-    {
-      if (user_options->quiet == false)
+      if (hashconfig->opti_type & OPTI_TYPE_REGISTER_LIMIT)
       {
-        clear_prompt (hashcat_ctx);
+        mod_opts[6] = CU_JIT_MAX_REGISTERS;
+        mod_vals[6] = (void *) 128;
 
-        event_log_advice (hashcat_ctx, "The wordlist or mask that you are using is too small.");
-        event_log_advice (hashcat_ctx, "This means that hashcat cannot use the full parallel power of your device(s).");
-        event_log_advice (hashcat_ctx, "Hashcat is expecting at least %" PRIu64 " base words but only got %.1f%% of that.", backend_ctx->kernel_power_all, (100.f * status_ctx->words_base) / backend_ctx->kernel_power_all);
-        event_log_advice (hashcat_ctx, "Unless you supply more work, your cracking speed will drop.");
-        event_log_advice (hashcat_ctx, "For tips on supplying more work, see: https://hashcat.net/faq/morework");
-        event_log_advice (hashcat_ctx, NULL);
+        mod_cnt++;
       }
-    }
-  }
-}
 
-void backend_ctx_devices_kernel_loops (hashcat_ctx_t *hashcat_ctx)
-{
-  combinator_ctx_t     *combinator_ctx      = hashcat_ctx->combinator_ctx;
-  hashconfig_t         *hashconfig          = hashcat_ctx->hashconfig;
-  hashes_t             *hashes              = hashcat_ctx->hashes;
-  mask_ctx_t           *mask_ctx            = hashcat_ctx->mask_ctx;
-  backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
-  straight_ctx_t       *straight_ctx        = hashcat_ctx->straight_ctx;
-  user_options_t       *user_options        = hashcat_ctx->user_options;
-  user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
+      #if defined (WITH_CUBIN)
 
-  if (backend_ctx->enabled == false) return;
+      char *jit_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
+      char *jit_error_log = (char *) hcmalloc (LOG_SIZE + 1);
 
-  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
-  {
-    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+      int jit_cnt = 6;
 
-    if (device_param->skipped == true) continue;
-    if (device_param->skipped_warning == true) continue;
+      CUjit_option jit_opts[7];
+      void *jit_vals[7];
 
-    device_param->kernel_loops_min = device_param->kernel_loops_min_sav;
-    device_param->kernel_loops_max = device_param->kernel_loops_max_sav;
+      jit_opts[0] = CU_JIT_TARGET_FROM_CUCONTEXT;
+      jit_vals[0] = (void *) 0;
 
-    if (device_param->kernel_loops_min < device_param->kernel_loops_max)
-    {
-      u64 innerloop_cnt = 0;
+      jit_opts[1] = CU_JIT_LOG_VERBOSE;
+      jit_vals[1] = (void *) 1;
 
-      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-      {
-        if (user_options->slow_candidates == true)
-        {
-          innerloop_cnt = 1;
-        }
-        else
-        {
-          if      (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)  innerloop_cnt = MIN (KERNEL_RULES, straight_ctx->kernel_rules_cnt);
-          else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)     innerloop_cnt = MIN (KERNEL_COMBS, combinator_ctx->combs_cnt);
-          else if (user_options_extra->attack_kern == ATTACK_KERN_BF)        innerloop_cnt = MIN (KERNEL_BFS,   mask_ctx->bfs_cnt);
-        }
-      }
-      else
+      jit_opts[2] = CU_JIT_INFO_LOG_BUFFER;
+      jit_vals[2] = (void *) jit_info_log;
+
+      jit_opts[3] = CU_JIT_INFO_LOG_BUFFER_SIZE_BYTES;
+      jit_vals[3] = (void *) LOG_SIZE;
+
+      jit_opts[4] = CU_JIT_ERROR_LOG_BUFFER;
+      jit_vals[4] = (void *) jit_error_log;
+
+      jit_opts[5] = CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES;
+      jit_vals[5] = (void *) LOG_SIZE;
+
+      if (hashconfig->opti_type & OPTI_TYPE_REGISTER_LIMIT)
       {
-        innerloop_cnt = hashes->salts_buf[0].salt_iter;
+        jit_opts[6] = CU_JIT_MAX_REGISTERS;
+        jit_vals[6] = (void *) 128;
+
+        jit_cnt++;
       }
 
-      if ((innerloop_cnt >= device_param->kernel_loops_min) &&
-          (innerloop_cnt <= device_param->kernel_loops_max))
+      CUlinkState state;
+
+      if (hc_cuLinkCreate (hashcat_ctx, jit_cnt, jit_opts, jit_vals, &state) == -1)
       {
-        device_param->kernel_loops_max = innerloop_cnt;
-      }
-    }
-  }
-}
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", jit_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-static int get_cuda_kernel_wgs (hashcat_ctx_t *hashcat_ctx, CUfunction function, u32 *result)
-{
-  int max_threads_per_block;
+        return false;
+      }
 
-  if (hc_cuFuncGetAttribute (hashcat_ctx, &max_threads_per_block, CU_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, function) == -1) return -1;
+      if (hc_cuLinkAddData (hashcat_ctx, state, CU_JIT_INPUT_PTX, binary, binary_size, kernel_name, 0, NULL, NULL) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", jit_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-  *result = (u32) max_threads_per_block;
+        return false;
+      }
 
-  return 0;
-}
+      void *cubin = NULL;
 
-static int get_cuda_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, CUfunction function, u64 *result)
-{
-  int shared_size_bytes;
+      size_t cubin_size = 0;
 
-  if (hc_cuFuncGetAttribute (hashcat_ctx, &shared_size_bytes, CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, function) == -1) return -1;
+      if (hc_cuLinkComplete (hashcat_ctx, state, &cubin, &cubin_size) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", jit_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-  *result = (u64) shared_size_bytes;
+        return false;
+      }
 
-  return 0;
-}
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s link successful. Info Log:", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, "%s", jit_info_log);
+      event_log_info (hashcat_ctx, NULL);
+      #endif
 
-static int get_hip_kernel_wgs (hashcat_ctx_t *hashcat_ctx, hipFunction_t function, u32 *result)
-{
-  int max_threads_per_block;
+      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, cubin, mod_cnt, mod_opts, mod_vals) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", mod_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-  if (hc_hipFuncGetAttribute (hashcat_ctx, &max_threads_per_block, HIP_FUNC_ATTRIBUTE_MAX_THREADS_PER_BLOCK, function) == -1) return -1;
+        return false;
+      }
 
-  *result = (u32) max_threads_per_block;
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, "%s", mod_info_log);
+      event_log_info (hashcat_ctx, NULL);
+      #endif
 
-  return 0;
-}
+      if (cache_disable == false)
+      {
+        if (write_kernel_binary (hashcat_ctx, cached_file, cubin, cubin_size) == false) return false;
+      }
 
-static int get_hip_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, hipFunction_t function, u64 *result)
-{
-  int shared_size_bytes;
+      if (hc_cuLinkDestroy (hashcat_ctx, state) == -1) return false;
 
-  if (hc_hipFuncGetAttribute (hashcat_ctx, &shared_size_bytes, HIP_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, function) == -1) return -1;
+      hcfree (jit_info_log);
+      hcfree (jit_error_log);
 
-  *result = (u64) shared_size_bytes;
+      #else
 
-  return 0;
-}
+      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, binary, mod_cnt, mod_opts, mod_vals) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", mod_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-#if defined (__APPLE__)
-static int get_metal_kernel_wgs (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u32 *result)
-{
-  return hc_mtlGetMaxTotalThreadsPerThreadgroup (hashcat_ctx, pipeline, result);
-}
+        return false;
+      }
 
-static int get_metal_kernel_preferred_wgs_multiple (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u32 *result)
-{
-  return hc_mtlGetThreadExecutionWidth (hashcat_ctx, pipeline, result);
-}
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, "%s", mod_info_log);
+      event_log_info (hashcat_ctx, NULL);
+      #endif
 
-static int get_metal_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, mtl_pipeline pipeline, u64 *result)
-{
-  return hc_mtlGetStaticThreadgroupMemoryLength (hashcat_ctx, pipeline, (unsigned int *) result);
-}
-#endif
+      if (cache_disable == false)
+      {
+        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
+      }
 
-static int get_opencl_kernel_wgs (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u32 *result)
-{
-  user_options_t *user_options = hashcat_ctx->user_options;
+      #endif
 
-  size_t work_group_size = 0;
+      hcfree (mod_info_log);
+      hcfree (mod_error_log);
 
-  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_WORK_GROUP_SIZE, sizeof (work_group_size), &work_group_size, NULL) == -1) return -1;
+      hcfree (binary);
+    }
 
-  u32 kernel_threads = (u32) work_group_size;
+    if (device_param->is_hip == true)
+    {
+      hiprtcProgram program;
 
-  size_t compile_work_group_size[3] = { 0, 0, 0 };
+      if (hc_hiprtcCreateProgram (hashcat_ctx, &program, kernel_sources[0], kernel_name, 0, NULL, NULL) == -1) return false;
 
-  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_COMPILE_WORK_GROUP_SIZE, sizeof (compile_work_group_size), &compile_work_group_size, NULL) == -1) return -1;
+      char **hiprtc_options = (char **) hccalloc (16 + strlen (build_options_buf) + 1, sizeof (char *)); // ...
 
-  const size_t cwgs_total = compile_work_group_size[0] * compile_work_group_size[1] * compile_work_group_size[2];
+      int hiprtc_options_idx = 0;
 
-  if (cwgs_total > 0)
-  {
-    if (kernel_threads < cwgs_total)
-    {
-      // Very likely some bug, because the runtime was unable to follow our requirement to run N threads guaranteed on this kernel
-      if (user_options->machine_readable == false)
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D MAX_THREADS_PER_BLOCK=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "--gpu-architecture=%s", device_param->gcnArchName);
+
+      if ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) == 0)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Runtime returned CL_KERNEL_WORK_GROUP_SIZE=%d, but CL_KERNEL_COMPILE_WORK_GROUP_SIZE=%d. Use -T%d if you run into problems.", device_param->device_id + 1, (int) kernel_threads, (int) cwgs_total, (int) kernel_threads);
+        hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "--gpu-max-threads-per-block=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
       }
-    }
 
-    kernel_threads = cwgs_total;
-  }
+      // untested but it should work
+      #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D INCLUDE_PATH=%s/OpenCL/", folder_config->cwd);
+      // ugly, but required since HIPRTC is changing the current working folder to the temporary compile folder
+      #else
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D INCLUDE_PATH=%s", folder_config->cpath_real);
+      #endif
 
-  *result = kernel_threads;
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D XM2S(x)=#x");
+      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D M2S(x)=XM2S(x)");
 
-  return 0;
-}
+      char *hiprtc_options_string = hcstrdup (build_options_buf);
 
-static int get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u32 *result)
-{
-  size_t preferred_work_group_size_multiple = 0;
+      const int num_options = hiprtc_options_idx + hiprtc_make_options_array_from_string (hiprtc_options_string, hiprtc_options + hiprtc_options_idx);
 
-  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_PREFERRED_WORK_GROUP_SIZE_MULTIPLE, sizeof (preferred_work_group_size_multiple), &preferred_work_group_size_multiple, NULL) == -1) return -1;
+      const int rc_hiprtcCompileProgram = hc_hiprtcCompileProgram (hashcat_ctx, program, num_options, (const char * const *) hiprtc_options);
 
-  *result = (u32) preferred_work_group_size_multiple;
+      hcfree (hiprtc_options_string);
+      hcfree (hiprtc_options);
 
-  return 0;
-}
+      size_t build_log_size = 0;
 
-static int get_opencl_kernel_local_mem_size (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u64 *result)
-{
-  cl_ulong local_mem_size = 0;
+      hc_hiprtcGetProgramLogSize (hashcat_ctx, program, &build_log_size);
 
-  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof (local_mem_size), &local_mem_size, NULL) == -1) return -1;
+      #if defined (DEBUG)
+      if ((build_log_size > 1) || (rc_hiprtcCompileProgram == -1))
+      #else
+      if (rc_hiprtcCompileProgram == -1)
+      #endif
+      {
+        char *build_log = (char *) hcmalloc (build_log_size + 1);
 
-  *result = local_mem_size;
+        if (hc_hiprtcGetProgramLog (hashcat_ctx, program, build_log) == -1)
+        {
+          hcfree (build_log);
 
-  return 0;
-}
+          return false;
+        }
 
-static int get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, cl_kernel kernel, u64 *result)
-{
-  cl_ulong dynamic_local_mem_size = 0;
+        build_log[build_log_size] = 0;
 
-  if (hc_clGetKernelWorkGroupInfo (hashcat_ctx, kernel, device_param->opencl_device, CL_KERNEL_LOCAL_MEM_SIZE, sizeof (dynamic_local_mem_size), &dynamic_local_mem_size, NULL) == -1) return -1;
+        puts (build_log);
 
-  // unknown how to query this information in OpenCL
-  // we therefore reset to zero
-  // the above call to hc_clGetKernelWorkGroupInfo() is just to avoid compiler warnings
+        hcfree (build_log);
+      }
 
-  dynamic_local_mem_size = 0;
+      if (rc_hiprtcCompileProgram == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-  *result = dynamic_local_mem_size;
+        return false;
+      }
 
-  return 0;
-}
+      size_t binary_size = 0;
 
-#if defined (__APPLE__)
-static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, mtl_library *metal_library)
-#else
-static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, MAYBE_UNUSED void *metal_library)
-#endif
-{
-  const backend_ctx_t   *backend_ctx   = hashcat_ctx->backend_ctx;
-  const hashconfig_t    *hashconfig    = hashcat_ctx->hashconfig;
-  const user_options_t  *user_options  = hashcat_ctx->user_options;
-  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+      if (hc_hiprtcGetCodeSize (hashcat_ctx, program, &binary_size) == -1) return false;
 
-  bool cached = true;
+      char *binary = (char *) hcmalloc (binary_size);
 
-  if (cache_disable == true)
-  {
-    cached = false;
-  }
+      if (hc_hiprtcGetCode (hashcat_ctx, program, binary) == -1) return false;
 
-  if (hc_path_read (cached_file) == false)
-  {
-    cached = false;
-  }
+      if (hc_hiprtcDestroyProgram (hashcat_ctx, &program) == -1) return false;
 
-  if (hc_path_is_empty (cached_file) == true)
-  {
-    cached = false;
-  }
+      #define LOG_SIZE 8192
 
-  /**
-   * kernel compile or load
-   */
+      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
+      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
 
-  size_t kernel_lengths_buf = 0;
+      int mod_cnt = 6;
 
-  size_t *kernel_lengths = &kernel_lengths_buf;
+      hipJitOption mod_opts[6];
+      void *mod_vals[6];
 
-  char *kernel_sources_buf = NULL;
+      mod_opts[0] = hipJitOptionTargetFromContext;
+      mod_vals[0] = (void *) 0;
 
-  char **kernel_sources = &kernel_sources_buf;
+      mod_opts[1] = hipJitOptionLogVerbose;
+      mod_vals[1] = (void *) 1;
 
-  if (cached == false)
-  {
-    #if defined (DEBUG)
-    if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s not found in cache. Please be patient...", device_param->device_id + 1, filename_from_filepath (cached_file));
-    #endif
+      mod_opts[2] = hipJitOptionInfoLogBuffer;
+      mod_vals[2] = (void *) mod_info_log;
 
-    if (read_kernel_binary (hashcat_ctx, source_file, kernel_lengths, kernel_sources) == false) return false;
+      mod_opts[3] = hipJitOptionInfoLogBufferSizeBytes;
+      mod_vals[3] = (void *) LOG_SIZE;
 
-    if (device_param->is_cuda == true)
-    {
-      nvrtcProgram program;
+      mod_opts[4] = hipJitOptionErrorLogBuffer;
+      mod_vals[4] = (void *) mod_error_log;
 
-      if (hc_nvrtcCreateProgram (hashcat_ctx, &program, kernel_sources[0], kernel_name, 0, NULL, NULL) == -1) return false;
+      mod_opts[5] = hipJitOptionErrorLogBufferSizeBytes;
+      mod_vals[5] = (void *) LOG_SIZE;
 
-      char **nvrtc_options = (char **) hccalloc (16 + strlen (build_options_buf) + 1, sizeof (char *)); // ...
+      if (hc_hipModuleLoadDataEx (hashcat_ctx, hip_module, binary, mod_cnt, mod_opts, mod_vals) == -1)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
+        event_log_error (hashcat_ctx, "%s", mod_error_log);
+        event_log_error (hashcat_ctx, NULL);
 
-      int nvrtc_options_idx = 0;
+        return false;
+      }
 
-      if (backend_ctx->nvrtc_driver_version >= 12000)
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, "%s", mod_info_log);
+      event_log_info (hashcat_ctx, NULL);
+      #endif
+
+      if (cache_disable == false)
       {
-        nvrtc_options[nvrtc_options_idx++] = "--std=c++14";
+        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
       }
 
-      //nvrtc_options[nvrtc_options_idx++] = "--restrict";
-      nvrtc_options[nvrtc_options_idx++] = "--gpu-architecture";
+      hcfree (mod_info_log);
+      hcfree (mod_error_log);
 
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "compute_%d", (device_param->sm_major * 10) + device_param->sm_minor);
+      hcfree (binary);
+    }
 
-      if (backend_ctx->nvrtc_driver_version >= 12010)
-      {
-        nvrtc_options[nvrtc_options_idx++] = "--split-compile";
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      mtl_library metal_lib = NULL;
 
-        hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "%d", 0);
-      }
+      if (hc_mtlCreateLibraryWithSource (hashcat_ctx, device_param->metal_device, kernel_sources[0], build_options_buf, folder_config->cpath_real, &metal_lib) == -1) return false;
 
-      if (backend_ctx->nvrtc_driver_version >= 12040)
-      {
-        nvrtc_options[nvrtc_options_idx++] = "--minimal";
-      }
+      *metal_library = metal_lib;
 
-      // untested on windows, but it should work
-      #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D INCLUDE_PATH=%s", "OpenCL");
-      #else
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D INCLUDE_PATH=%s", folder_config->cpath_real);
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful.", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, NULL);
       #endif
+    }
+    #endif // __APPLE__
 
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D XM2S(x)=#x");
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D M2S(x)=XM2S(x)");
-      hc_asprintf (&nvrtc_options[nvrtc_options_idx++], "-D MAX_THREADS_PER_BLOCK=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
+    if (device_param->is_opencl == true)
+    {
+      size_t build_log_size = 0;
 
-      char *nvrtc_options_string = hcstrdup (build_options_buf);
+      int CL_rc;
 
-      const int num_options = nvrtc_options_idx + nvrtc_make_options_array_from_string (nvrtc_options_string, nvrtc_options + nvrtc_options_idx);
+      cl_program p1 = NULL;
 
-      const int rc_nvrtcCompileProgram = hc_nvrtcCompileProgram (hashcat_ctx, program, num_options, (const char * const *) nvrtc_options);
+      // workaround opencl issue with Apple Silicon
 
-      hcfree (nvrtc_options_string);
-      hcfree (nvrtc_options);
+      if (strncmp (device_param->device_name, "Apple M", 7) == 0)
+      {
+        if (hc_clCreateProgramWithSource (hashcat_ctx, device_param->opencl_context, 1, (const char **) kernel_sources, NULL, opencl_program) == -1) return false;
 
-      size_t build_log_size = 0;
+        CL_rc = hc_clBuildProgram (hashcat_ctx, *opencl_program, 1, &device_param->opencl_device, build_options_buf, NULL, NULL);
 
-      hc_nvrtcGetProgramLogSize (hashcat_ctx, program, &build_log_size);
+        hc_clGetProgramBuildInfo (hashcat_ctx, *opencl_program, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &build_log_size);
+      }
+      else
+      {
+        if (hc_clCreateProgramWithSource (hashcat_ctx, device_param->opencl_context, 1, (const char **) kernel_sources, NULL, &p1) == -1) return false;
+
+        CL_rc = hc_clCompileProgram (hashcat_ctx, p1, 1, &device_param->opencl_device, build_options_buf, 0, NULL, NULL, NULL, NULL);
+
+        hc_clGetProgramBuildInfo (hashcat_ctx, p1, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &build_log_size);
+      }
 
       #if defined (DEBUG)
-      if ((build_log_size > 1) || (rc_nvrtcCompileProgram == -1))
+      if ((build_log_size > 1) || (CL_rc == -1))
       #else
-      if (rc_nvrtcCompileProgram == -1)
+      if (CL_rc == -1)
       #endif
       {
         char *build_log = (char *) hcmalloc (build_log_size + 1);
 
-        if (hc_nvrtcGetProgramLog (hashcat_ctx, program, build_log) == -1)
+        int rc_clGetProgramBuildInfo;
+
+        if (strncmp (device_param->device_name, "Apple M", 7) == 0)
+        {
+          rc_clGetProgramBuildInfo = hc_clGetProgramBuildInfo (hashcat_ctx, *opencl_program, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, build_log_size, build_log, NULL);
+        }
+        else
+        {
+          rc_clGetProgramBuildInfo = hc_clGetProgramBuildInfo (hashcat_ctx, p1, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, build_log_size, build_log, NULL);
+        }
+
+        if (rc_clGetProgramBuildInfo == -1)
         {
           hcfree (build_log);
 
           return false;
         }
 
-        build_log[build_log_size] = 0;
+        build_log[build_log_size] = 0;
+
+        puts (build_log);
+
+        hcfree (build_log);
+      }
+
+      if (CL_rc == -1) return false;
+
+      // workaround opencl issue with Apple Silicon
+
+      if (strncmp (device_param->device_name, "Apple M", 7) != 0)
+      {
+        cl_program t2[1];
+
+        t2[0] = p1;
+
+        cl_program fin;
+
+        if (hc_clLinkProgram (hashcat_ctx, device_param->opencl_context, 1, &device_param->opencl_device, NULL, 1, t2, NULL, NULL, &fin) == -1) return false;
+
+        // it seems errors caused by clLinkProgram() do not go into CL_PROGRAM_BUILD
+        // I couldn't find any information on the web explaining how else to retrieve the error messages from the linker
 
-        puts (build_log);
+        *opencl_program = fin;
 
-        hcfree (build_log);
+        hc_clReleaseProgramPtr (hashcat_ctx, &p1);
       }
 
-      if (rc_nvrtcCompileProgram == -1)
+      if (cache_disable == false)
       {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
-
-        return false;
-      }
+        size_t binary_size;
 
-      size_t binary_size = 0;
+        if (hc_clGetProgramInfo (hashcat_ctx, *opencl_program, CL_PROGRAM_BINARY_SIZES, sizeof (size_t), &binary_size, NULL) == -1) return false;
 
-      if (hc_nvrtcGetPTXSize (hashcat_ctx, program, &binary_size) == -1) return false;
+        char *binary = (char *) hcmalloc (binary_size);
 
-      char *binary = (char *) hcmalloc (binary_size);
+        if (hc_clGetProgramInfo (hashcat_ctx, *opencl_program, CL_PROGRAM_BINARIES, sizeof (char *), &binary, NULL) == -1) return false;
 
-      if (hc_nvrtcGetPTX (hashcat_ctx, program, binary) == -1) return false;
+        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
 
-      if (hc_nvrtcDestroyProgram (hashcat_ctx, &program) == -1) return false;
+        hcfree (binary);
+      }
+    }
+  }
+  else
+  {
+    if (read_kernel_binary (hashcat_ctx, cached_file, kernel_lengths, kernel_sources) == false) return false;
 
+    if (device_param->is_cuda == true)
+    {
       #define LOG_SIZE 8192
 
       char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
@@ -9620,82 +10551,7 @@ static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_p
         mod_cnt++;
       }
 
-      #if defined (WITH_CUBIN)
-
-      char *jit_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
-      char *jit_error_log = (char *) hcmalloc (LOG_SIZE + 1);
-
-      int jit_cnt = 6;
-
-      CUjit_option jit_opts[7];
-      void *jit_vals[7];
-
-      jit_opts[0] = CU_JIT_TARGET_FROM_CUCONTEXT;
-      jit_vals[0] = (void *) 0;
-
-      jit_opts[1] = CU_JIT_LOG_VERBOSE;
-      jit_vals[1] = (void *) 1;
-
-      jit_opts[2] = CU_JIT_INFO_LOG_BUFFER;
-      jit_vals[2] = (void *) jit_info_log;
-
-      jit_opts[3] = CU_JIT_INFO_LOG_BUFFER_SIZE_BYTES;
-      jit_vals[3] = (void *) LOG_SIZE;
-
-      jit_opts[4] = CU_JIT_ERROR_LOG_BUFFER;
-      jit_vals[4] = (void *) jit_error_log;
-
-      jit_opts[5] = CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES;
-      jit_vals[5] = (void *) LOG_SIZE;
-
-      if (hashconfig->opti_type & OPTI_TYPE_REGISTER_LIMIT)
-      {
-        jit_opts[6] = CU_JIT_MAX_REGISTERS;
-        jit_vals[6] = (void *) 128;
-
-        jit_cnt++;
-      }
-
-      CUlinkState state;
-
-      if (hc_cuLinkCreate (hashcat_ctx, jit_cnt, jit_opts, jit_vals, &state) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", jit_error_log);
-        event_log_error (hashcat_ctx, NULL);
-
-        return false;
-      }
-
-      if (hc_cuLinkAddData (hashcat_ctx, state, CU_JIT_INPUT_PTX, binary, binary_size, kernel_name, 0, NULL, NULL) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", jit_error_log);
-        event_log_error (hashcat_ctx, NULL);
-
-        return false;
-      }
-
-      void *cubin = NULL;
-
-      size_t cubin_size = 0;
-
-      if (hc_cuLinkComplete (hashcat_ctx, state, &cubin, &cubin_size) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s link failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", jit_error_log);
-        event_log_error (hashcat_ctx, NULL);
-
-        return false;
-      }
-
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s link successful. Info Log:", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, "%s", jit_info_log);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
-
-      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, cubin, mod_cnt, mod_opts, mod_vals) == -1)
+      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, kernel_sources[0], mod_cnt, mod_opts, mod_vals) == -1)
       {
         event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
         event_log_error (hashcat_ctx, "%s", mod_error_log);
@@ -9710,19 +10566,41 @@ static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_p
       event_log_info (hashcat_ctx, NULL);
       #endif
 
-      if (cache_disable == false)
-      {
-        if (write_kernel_binary (hashcat_ctx, cached_file, cubin, cubin_size) == false) return false;
-      }
+      hcfree (mod_info_log);
+      hcfree (mod_error_log);
+    }
 
-      if (hc_cuLinkDestroy (hashcat_ctx, state) == -1) return false;
+    if (device_param->is_hip == true)
+    {
+      #define LOG_SIZE 8192
 
-      hcfree (jit_info_log);
-      hcfree (jit_error_log);
+      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
+      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
 
-      #else
+      int mod_cnt = 6;
 
-      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, binary, mod_cnt, mod_opts, mod_vals) == -1)
+      hipJitOption mod_opts[6];
+      void *mod_vals[6];
+
+      mod_opts[0] = hipJitOptionTargetFromContext;
+      mod_vals[0] = (void *) 0;
+
+      mod_opts[1] = hipJitOptionLogVerbose;
+      mod_vals[1] = (void *) 1;
+
+      mod_opts[2] = hipJitOptionInfoLogBuffer;
+      mod_vals[2] = (void *) mod_info_log;
+
+      mod_opts[3] = hipJitOptionInfoLogBufferSizeBytes;
+      mod_vals[3] = (void *) LOG_SIZE;
+
+      mod_opts[4] = hipJitOptionErrorLogBuffer;
+      mod_vals[4] = (void *) mod_error_log;
+
+      mod_opts[5] = hipJitOptionErrorLogBufferSizeBytes;
+      mod_vals[5] = (void *) LOG_SIZE;
+
+      if (hc_hipModuleLoadDataEx (hashcat_ctx, hip_module, kernel_sources[0], mod_cnt, mod_opts, mod_vals) == -1)
       {
         event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
         event_log_error (hashcat_ctx, "%s", mod_error_log);
@@ -9737,412 +10615,335 @@ static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_p
       event_log_info (hashcat_ctx, NULL);
       #endif
 
-      if (cache_disable == false)
-      {
-        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
-      }
-
-      #endif
-
       hcfree (mod_info_log);
       hcfree (mod_error_log);
-
-      hcfree (binary);
     }
 
-    if (device_param->is_hip == true)
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
     {
-      hiprtcProgram program;
-
-      if (hc_hiprtcCreateProgram (hashcat_ctx, &program, kernel_sources[0], kernel_name, 0, NULL, NULL) == -1) return false;
+      mtl_library metal_lib = NULL;
 
-      char **hiprtc_options = (char **) hccalloc (16 + strlen (build_options_buf) + 1, sizeof (char *)); // ...
+      if (hc_mtlCreateLibraryWithFile (hashcat_ctx, device_param->metal_device, cached_file, &metal_lib) == -1) return false;
 
-      int hiprtc_options_idx = 0;
+      *metal_library = metal_lib;
 
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D MAX_THREADS_PER_BLOCK=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "--gpu-architecture=%s", device_param->gcnArchName);
+      #if defined (DEBUG)
+      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful.", device_param->device_id + 1, source_file);
+      event_log_info (hashcat_ctx, NULL);
+      #endif
+    }
+    #endif
 
-      if ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) == 0)
-      {
-        hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "--gpu-max-threads-per-block=%d", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
-      }
+    if (device_param->is_opencl == true)
+    {
+      if (hc_clCreateProgramWithBinary (hashcat_ctx, device_param->opencl_context, 1, &device_param->opencl_device, kernel_lengths, (const unsigned char **) kernel_sources, NULL, opencl_program) == -1) return false;
 
-      // untested but it should work
-      #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D INCLUDE_PATH=%s/OpenCL/", folder_config->cwd);
-      // ugly, but required since HIPRTC is changing the current working folder to the temporary compile folder
-      #else
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D INCLUDE_PATH=%s", folder_config->cpath_real);
-      #endif
+      if (hc_clBuildProgram (hashcat_ctx, *opencl_program, 1, &device_param->opencl_device, build_options_buf, NULL, NULL) == -1) return false;
+    }
+  }
 
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D XM2S(x)=#x");
-      hc_asprintf (&hiprtc_options[hiprtc_options_idx++], "-D M2S(x)=XM2S(x)");
+  hcfree (kernel_sources[0]);
 
-      char *hiprtc_options_string = hcstrdup (build_options_buf);
+  return true;
+}
 
-      const int num_options = hiprtc_options_idx + hiprtc_make_options_array_from_string (hiprtc_options_string, hiprtc_options + hiprtc_options_idx);
+/**
+ * devices are set up in parallel and identical devices share the same cached_file (same device_name_chksum)
+ * only one of them builds and writes the kernel, the others wait for it and then load it from the cache
+ */
 
-      const int rc_hiprtcCompileProgram = hc_hiprtcCompileProgram (hashcat_ctx, program, num_options, (const char * const *) hiprtc_options);
+static void kernel_cache_lock (backend_ctx_t *backend_ctx, const char *cached_file)
+{
+  hc_thread_mutex_lock (backend_ctx->mux_kernel_cache);
 
-      hcfree (hiprtc_options_string);
-      hcfree (hiprtc_options);
+  while (true)
+  {
+    int slot_free = -1;
 
-      size_t build_log_size = 0;
+    bool busy = false;
 
-      hc_hiprtcGetProgramLogSize (hashcat_ctx, program, &build_log_size);
+    for (int slot = 0; slot < DEVICES_MAX; slot++)
+    {
+      const char *cached_file_busy = backend_ctx->kernel_cache_busy[slot];
 
-      #if defined (DEBUG)
-      if ((build_log_size > 1) || (rc_hiprtcCompileProgram == -1))
-      #else
-      if (rc_hiprtcCompileProgram == -1)
-      #endif
+      if (cached_file_busy == NULL)
       {
-        char *build_log = (char *) hcmalloc (build_log_size + 1);
-
-        if (hc_hiprtcGetProgramLog (hashcat_ctx, program, build_log) == -1)
-        {
-          hcfree (build_log);
+        if (slot_free == -1) slot_free = slot;
 
-          return false;
-        }
+        continue;
+      }
 
-        build_log[build_log_size] = 0;
+      if (strcmp (cached_file_busy, cached_file) == 0) busy = true;
+    }
 
-        puts (build_log);
+    if ((busy == false) && (slot_free != -1))
+    {
+      backend_ctx->kernel_cache_busy[slot_free] = cached_file;
 
-        hcfree (build_log);
-      }
+      break;
+    }
 
-      if (rc_hiprtcCompileProgram == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+    hc_thread_cond_wait (backend_ctx->cond_kernel_cache, backend_ctx->mux_kernel_cache);
+  }
 
-        return false;
-      }
+  hc_thread_mutex_unlock (backend_ctx->mux_kernel_cache);
+}
 
-      size_t binary_size = 0;
+static void kernel_cache_unlock (backend_ctx_t *backend_ctx, const char *cached_file)
+{
+  hc_thread_mutex_lock (backend_ctx->mux_kernel_cache);
 
-      if (hc_hiprtcGetCodeSize (hashcat_ctx, program, &binary_size) == -1) return false;
+  for (int slot = 0; slot < DEVICES_MAX; slot++)
+  {
+    if (backend_ctx->kernel_cache_busy[slot] != cached_file) continue;
 
-      char *binary = (char *) hcmalloc (binary_size);
+    backend_ctx->kernel_cache_busy[slot] = NULL;
 
-      if (hc_hiprtcGetCode (hashcat_ctx, program, binary) == -1) return false;
+    break;
+  }
 
-      if (hc_hiprtcDestroyProgram (hashcat_ctx, &program) == -1) return false;
+  hc_thread_cond_broadcast (backend_ctx->cond_kernel_cache);
 
-      #define LOG_SIZE 8192
+  hc_thread_mutex_unlock (backend_ctx->mux_kernel_cache);
+}
 
-      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
-      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
+#if defined (__APPLE__)
+static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, mtl_library *metal_library)
+#else
+static bool load_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const char *kernel_name, char *source_file, char *cached_file, const char *build_options_buf, const bool cache_disable, cl_program *opencl_program, CUmodule *cuda_module, hipModule_t *hip_module, MAYBE_UNUSED void *metal_library)
+#endif
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
 
-      int mod_cnt = 6;
+  // without the cache every device builds its own kernel, there's nothing to share or wait for
 
-      hipJitOption mod_opts[6];
-      void *mod_vals[6];
+  if (cache_disable == true)
+  {
+    return load_kernel_locked (hashcat_ctx, device_param, kernel_name, source_file, cached_file, build_options_buf, cache_disable, opencl_program, cuda_module, hip_module, metal_library);
+  }
 
-      mod_opts[0] = hipJitOptionTargetFromContext;
-      mod_vals[0] = (void *) 0;
+  kernel_cache_lock (backend_ctx, cached_file);
 
-      mod_opts[1] = hipJitOptionLogVerbose;
-      mod_vals[1] = (void *) 1;
+  const bool rc = load_kernel_locked (hashcat_ctx, device_param, kernel_name, source_file, cached_file, build_options_buf, cache_disable, opencl_program, cuda_module, hip_module, metal_library);
 
-      mod_opts[2] = hipJitOptionInfoLogBuffer;
-      mod_vals[2] = (void *) mod_info_log;
+  kernel_cache_unlock (backend_ctx, cached_file);
 
-      mod_opts[3] = hipJitOptionInfoLogBufferSizeBytes;
-      mod_vals[3] = (void *) LOG_SIZE;
+  return rc;
+}
 
-      mod_opts[4] = hipJitOptionErrorLogBuffer;
-      mod_vals[4] = (void *) mod_error_log;
+static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  // GPU memset
 
-      mod_opts[5] = hipJitOptionErrorLogBufferSizeBytes;
-      mod_vals[5] = (void *) LOG_SIZE;
+  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_memset, device_param->cuda_module_shared, "gpu_memset") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
 
-      if (hc_hipModuleLoadDataEx (hashcat_ctx, hip_module, binary, mod_cnt, mod_opts, mod_vals) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", mod_error_log);
-        event_log_error (hashcat_ctx, NULL);
+    device_param->skipped_warning = true;
 
-        return false;
-      }
+    return -2; //continue;
+  }
 
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, "%s", mod_info_log);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
+  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_memset, &device_param->kernel_wgs_memset) == -1) return -1;
 
-      if (cache_disable == false)
-      {
-        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
-      }
+  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
 
-      hcfree (mod_info_log);
-      hcfree (mod_error_log);
+  device_param->kernel_dynamic_local_mem_size_memset = device_param->device_local_mem_size - device_param->kernel_local_mem_size_memset;
 
-      hcfree (binary);
-    }
+  device_param->kernel_preferred_wgs_multiple_memset = device_param->cuda_warp_size;
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      mtl_library metal_lib = NULL;
+  // GPU bzero
 
-      if (hc_mtlCreateLibraryWithSource (hashcat_ctx, device_param->metal_device, kernel_sources[0], build_options_buf, folder_config->cpath_real, &metal_lib) == -1) return false;
+  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_bzero, device_param->cuda_module_shared, "gpu_bzero") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
 
-      *metal_library = metal_lib;
+    device_param->skipped_warning = true;
 
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful.", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
-    }
-    #endif // __APPLE__
+    return -2; //continue;
+  }
 
-    if (device_param->is_opencl == true)
-    {
-      size_t build_log_size = 0;
+  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
 
-      int CL_rc;
+  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
 
-      cl_program p1 = NULL;
+  device_param->kernel_dynamic_local_mem_size_bzero = device_param->device_local_mem_size - device_param->kernel_local_mem_size_bzero;
 
-      // workaround opencl issue with Apple Silicon
+  device_param->kernel_preferred_wgs_multiple_bzero = device_param->cuda_warp_size;
 
-      if (strncmp (device_param->device_name, "Apple M", 7) == 0)
-      {
-        if (hc_clCreateProgramWithSource (hashcat_ctx, device_param->opencl_context, 1, (const char **) kernel_sources, NULL, opencl_program) == -1) return false;
+  // GPU autotune init
 
-        CL_rc = hc_clBuildProgram (hashcat_ctx, *opencl_program, 1, &device_param->opencl_device, build_options_buf, NULL, NULL);
+  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_atinit, device_param->cuda_module_shared, "gpu_atinit") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
 
-        hc_clGetProgramBuildInfo (hashcat_ctx, *opencl_program, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &build_log_size);
-      }
-      else
-      {
-        if (hc_clCreateProgramWithSource (hashcat_ctx, device_param->opencl_context, 1, (const char **) kernel_sources, NULL, &p1) == -1) return false;
+    device_param->skipped_warning = true;
 
-        CL_rc = hc_clCompileProgram (hashcat_ctx, p1, 1, &device_param->opencl_device, build_options_buf, 0, NULL, NULL, NULL, NULL);
+    return -2; //continue;
+  }
 
-        hc_clGetProgramBuildInfo (hashcat_ctx, p1, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, 0, NULL, &build_log_size);
-      }
+  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
 
-      #if defined (DEBUG)
-      if ((build_log_size > 1) || (CL_rc == -1))
-      #else
-      if (CL_rc == -1)
-      #endif
-      {
-        char *build_log = (char *) hcmalloc (build_log_size + 1);
+  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
 
-        int rc_clGetProgramBuildInfo;
+  device_param->kernel_dynamic_local_mem_size_atinit = device_param->device_local_mem_size - device_param->kernel_local_mem_size_atinit;
 
-        if (strncmp (device_param->device_name, "Apple M", 7) == 0)
-        {
-          rc_clGetProgramBuildInfo = hc_clGetProgramBuildInfo (hashcat_ctx, *opencl_program, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, build_log_size, build_log, NULL);
-        }
-        else
-        {
-          rc_clGetProgramBuildInfo = hc_clGetProgramBuildInfo (hashcat_ctx, p1, device_param->opencl_device, CL_PROGRAM_BUILD_LOG, build_log_size, build_log, NULL);
-        }
+  device_param->kernel_preferred_wgs_multiple_atinit = device_param->cuda_warp_size;
 
-        if (rc_clGetProgramBuildInfo == -1)
-        {
-          hcfree (build_log);
+  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]); if (CL_rc == -1) return -1;
+  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]); if (CL_rc == -1) return -1;
 
-          return false;
-        }
+  // GPU decompress
 
-        build_log[build_log_size] = 0;
+  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_decompress, device_param->cuda_module_shared, "gpu_decompress") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
 
-        puts (build_log);
+    device_param->skipped_warning = true;
 
-        hcfree (build_log);
-      }
+    return -2; //continue;
+  }
 
-      if (CL_rc == -1) return false;
+  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
 
-      // workaround opencl issue with Apple Silicon
+  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
 
-      if (strncmp (device_param->device_name, "Apple M", 7) != 0)
-      {
-        cl_program t2[1];
+  device_param->kernel_dynamic_local_mem_size_decompress = device_param->device_local_mem_size - device_param->kernel_local_mem_size_decompress;
 
-        t2[0] = p1;
+  device_param->kernel_preferred_wgs_multiple_decompress = device_param->cuda_warp_size;
 
-        cl_program fin;
+  // GPU utf8 to utf16le conversion
 
-        if (hc_clLinkProgram (hashcat_ctx, device_param->opencl_context, 1, &device_param->opencl_device, NULL, 1, t2, NULL, NULL, &fin) == -1) return false;
+  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_utf8toutf16le, device_param->cuda_module_shared, "gpu_utf8_to_utf16") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
 
-        // it seems errors caused by clLinkProgram() do not go into CL_PROGRAM_BUILD
-        // I couldn't find any information on the web explaining how else to retrieve the error messages from the linker
+    device_param->skipped_warning = true;
 
-        *opencl_program = fin;
+    return -2; //continue;
+  }
 
-        hc_clReleaseProgramPtr (hashcat_ctx, &p1);
-      }
+  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
 
-      if (cache_disable == false)
-      {
-        size_t binary_size;
+  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
 
-        if (hc_clGetProgramInfo (hashcat_ctx, *opencl_program, CL_PROGRAM_BINARY_SIZES, sizeof (size_t), &binary_size, NULL) == -1) return false;
+  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = device_param->device_local_mem_size - device_param->kernel_local_mem_size_utf8toutf16le;
 
-        char *binary = (char *) hcmalloc (binary_size);
+  device_param->kernel_preferred_wgs_multiple_utf8toutf16le = device_param->cuda_warp_size;
 
-        if (hc_clGetProgramInfo (hashcat_ctx, *opencl_program, CL_PROGRAM_BINARIES, sizeof (char *), &binary, NULL) == -1) return false;
+  return 0;
+}
 
-        if (write_kernel_binary (hashcat_ctx, cached_file, binary, binary_size) == false) return false;
+static int backend_session_setup_hip_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  // GPU memset
 
-        hcfree (binary);
-      }
-    }
-  }
-  else
+  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_memset, device_param->hip_module_shared, "gpu_memset") == -1)
   {
-    if (read_kernel_binary (hashcat_ctx, cached_file, kernel_lengths, kernel_sources) == false) return false;
-
-    if (device_param->is_cuda == true)
-    {
-      #define LOG_SIZE 8192
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
 
-      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
-      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
+    device_param->skipped_warning = true;
 
-      int mod_cnt = 6;
+    return -2; //continue;
+  }
 
-      CUjit_option mod_opts[7];
-      void *mod_vals[7];
+  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_memset, &device_param->kernel_wgs_memset) == -1) return -1;
 
-      mod_opts[0] = CU_JIT_TARGET_FROM_CUCONTEXT;
-      mod_vals[0] = (void *) 0;
+  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
 
-      mod_opts[1] = CU_JIT_LOG_VERBOSE;
-      mod_vals[1] = (void *) 1;
+  device_param->kernel_dynamic_local_mem_size_memset = device_param->device_local_mem_size - device_param->kernel_local_mem_size_memset;
 
-      mod_opts[2] = CU_JIT_INFO_LOG_BUFFER;
-      mod_vals[2] = (void *) mod_info_log;
+  device_param->kernel_preferred_wgs_multiple_memset = device_param->hip_warp_size;
 
-      mod_opts[3] = CU_JIT_INFO_LOG_BUFFER_SIZE_BYTES;
-      mod_vals[3] = (void *) LOG_SIZE;
+  // GPU bzero
 
-      mod_opts[4] = CU_JIT_ERROR_LOG_BUFFER;
-      mod_vals[4] = (void *) mod_error_log;
+  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_bzero, device_param->hip_module_shared, "gpu_bzero") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
 
-      mod_opts[5] = CU_JIT_ERROR_LOG_BUFFER_SIZE_BYTES;
-      mod_vals[5] = (void *) LOG_SIZE;
+    device_param->skipped_warning = true;
 
-      if (hashconfig->opti_type & OPTI_TYPE_REGISTER_LIMIT)
-      {
-        mod_opts[6] = CU_JIT_MAX_REGISTERS;
-        mod_vals[6] = (void *) 128;
+    return -2; //continue;
+  }
 
-        mod_cnt++;
-      }
+  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
 
-      if (hc_cuModuleLoadDataEx (hashcat_ctx, cuda_module, kernel_sources[0], mod_cnt, mod_opts, mod_vals) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", mod_error_log);
-        event_log_error (hashcat_ctx, NULL);
+  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
 
-        return false;
-      }
+  device_param->kernel_dynamic_local_mem_size_bzero = device_param->device_local_mem_size - device_param->kernel_local_mem_size_bzero;
 
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, "%s", mod_info_log);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
+  device_param->kernel_preferred_wgs_multiple_bzero = device_param->hip_warp_size;
 
-      hcfree (mod_info_log);
-      hcfree (mod_error_log);
-    }
+  // GPU autotune init
 
-    if (device_param->is_hip == true)
-    {
-      #define LOG_SIZE 8192
+  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_atinit, device_param->hip_module_shared, "gpu_atinit") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
 
-      char *mod_info_log  = (char *) hcmalloc (LOG_SIZE + 1);
-      char *mod_error_log = (char *) hcmalloc (LOG_SIZE + 1);
+    device_param->skipped_warning = true;
 
-      int mod_cnt = 6;
+    return -2; //continue;
+  }
 
-      hipJitOption mod_opts[6];
-      void *mod_vals[6];
+  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
 
-      mod_opts[0] = hipJitOptionTargetFromContext;
-      mod_vals[0] = (void *) 0;
+  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
 
-      mod_opts[1] = hipJitOptionLogVerbose;
-      mod_vals[1] = (void *) 1;
+  device_param->kernel_dynamic_local_mem_size_atinit = device_param->device_local_mem_size - device_param->kernel_local_mem_size_atinit;
 
-      mod_opts[2] = hipJitOptionInfoLogBuffer;
-      mod_vals[2] = (void *) mod_info_log;
+  device_param->kernel_preferred_wgs_multiple_atinit = device_param->hip_warp_size;
 
-      mod_opts[3] = hipJitOptionInfoLogBufferSizeBytes;
-      mod_vals[3] = (void *) LOG_SIZE;
+  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]); if (CL_rc == -1) return -1;
+  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]); if (CL_rc == -1) return -1;
 
-      mod_opts[4] = hipJitOptionErrorLogBuffer;
-      mod_vals[4] = (void *) mod_error_log;
+  // GPU decompress
 
-      mod_opts[5] = hipJitOptionErrorLogBufferSizeBytes;
-      mod_vals[5] = (void *) LOG_SIZE;
+  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_decompress, device_param->hip_module_shared, "gpu_decompress") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
 
-      if (hc_hipModuleLoadDataEx (hashcat_ctx, hip_module, kernel_sources[0], mod_cnt, mod_opts, mod_vals) == -1)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s load failed. Error Log:", device_param->device_id + 1, source_file);
-        event_log_error (hashcat_ctx, "%s", mod_error_log);
-        event_log_error (hashcat_ctx, NULL);
+    device_param->skipped_warning = true;
 
-        return false;
-      }
+    return -2; //continue;
+  }
 
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful. Info Log:", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, "%s", mod_info_log);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
+  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
 
-      hcfree (mod_info_log);
-      hcfree (mod_error_log);
-    }
+  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      mtl_library metal_lib = NULL;
+  device_param->kernel_dynamic_local_mem_size_decompress = device_param->device_local_mem_size - device_param->kernel_local_mem_size_decompress;
 
-      if (hc_mtlCreateLibraryWithFile (hashcat_ctx, device_param->metal_device, cached_file, &metal_lib) == -1) return false;
+  device_param->kernel_preferred_wgs_multiple_decompress = device_param->hip_warp_size;
 
-      *metal_library = metal_lib;
+  // GPU utf8 to utf16le conversion
 
-      #if defined (DEBUG)
-      event_log_info (hashcat_ctx, "* Device #%u: Kernel %s load successful.", device_param->device_id + 1, source_file);
-      event_log_info (hashcat_ctx, NULL);
-      #endif
-    }
-    #endif
+  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_utf8toutf16le, device_param->hip_module_shared, "gpu_utf8_to_utf16") == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
 
-    if (device_param->is_opencl == true)
-    {
-      if (hc_clCreateProgramWithBinary (hashcat_ctx, device_param->opencl_context, 1, &device_param->opencl_device, kernel_lengths, (const unsigned char **) kernel_sources, NULL, opencl_program) == -1) return false;
+    device_param->skipped_warning = true;
 
-      if (hc_clBuildProgram (hashcat_ctx, *opencl_program, 1, &device_param->opencl_device, build_options_buf, NULL, NULL) == -1) return false;
-    }
+    return -2; //continue;
   }
 
-  hcfree (kernel_sources[0]);
+  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
 
-  return true;
+  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+
+  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = device_param->device_local_mem_size - device_param->kernel_local_mem_size_utf8toutf16le;
+
+  device_param->kernel_preferred_wgs_multiple_utf8toutf16le = device_param->hip_warp_size;
+
+  return 0;
 }
 
-static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+#if defined (__APPLE__)
+static int backend_session_setup_metal_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   // GPU memset
 
-  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_memset, device_param->cuda_module_shared, "gpu_memset") == -1)
+  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_memset", &device_param->metal_function_memset, &device_param->metal_pipeline_memset) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
 
@@ -10151,17 +10952,17 @@ static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_memset, &device_param->kernel_wgs_memset) == -1) return -1;
+  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_wgs_memset) == -1) return -1;
 
-  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
+  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_memset = device_param->device_local_mem_size - device_param->kernel_local_mem_size_memset;
+  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_preferred_wgs_multiple_memset) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_memset = device_param->cuda_warp_size;
+  device_param->kernel_dynamic_local_mem_size_memset = 0;
 
   // GPU bzero
 
-  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_bzero, device_param->cuda_module_shared, "gpu_bzero") == -1)
+  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_bzero", &device_param->metal_function_bzero, &device_param->metal_pipeline_bzero) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
 
@@ -10170,17 +10971,17 @@ static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
+  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
 
-  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
+  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_bzero = device_param->device_local_mem_size - device_param->kernel_local_mem_size_bzero;
+  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_preferred_wgs_multiple_bzero) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_bzero = device_param->cuda_warp_size;
+  device_param->kernel_dynamic_local_mem_size_bzero = 0;
 
   // GPU autotune init
 
-  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_atinit, device_param->cuda_module_shared, "gpu_atinit") == -1)
+  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_atinit", &device_param->metal_function_atinit, &device_param->metal_pipeline_atinit) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
 
@@ -10189,20 +10990,17 @@ static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
-
-  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_atinit = device_param->device_local_mem_size - device_param->kernel_local_mem_size_atinit;
+  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_atinit = device_param->cuda_warp_size;
+  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_preferred_wgs_multiple_atinit) == -1) return -1;
 
-  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]); if (CL_rc == -1) return -1;
-  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]); if (CL_rc == -1) return -1;
+  device_param->kernel_dynamic_local_mem_size_atinit = 0;
 
   // GPU decompress
 
-  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_decompress, device_param->cuda_module_shared, "gpu_decompress") == -1)
+  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_decompress", &device_param->metal_function_decompress, &device_param->metal_pipeline_decompress) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
 
@@ -10211,17 +11009,17 @@ static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
 
-  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_decompress = device_param->device_local_mem_size - device_param->kernel_local_mem_size_decompress;
+  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_preferred_wgs_multiple_decompress) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_decompress = device_param->cuda_warp_size;
+  device_param->kernel_dynamic_local_mem_size_decompress = 0;
 
   // GPU utf8 to utf16le conversion
 
-  if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_utf8toutf16le, device_param->cuda_module_shared, "gpu_utf8_to_utf16") == -1)
+  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_utf8_to_utf16", &device_param->metal_function_utf8toutf16le, &device_param->metal_pipeline_utf8toutf16le) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
 
@@ -10230,22 +11028,23 @@ static int backend_session_setup_cuda_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
 
-  if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = device_param->device_local_mem_size - device_param->kernel_local_mem_size_utf8toutf16le;
+  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_preferred_wgs_multiple_utf8toutf16le) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_utf8toutf16le = device_param->cuda_warp_size;
+  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = 0;
 
   return 0;
 }
+#endif // __APPLE__
 
-static int backend_session_setup_hip_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+static int backend_session_setup_opencl_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   // GPU memset
 
-  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_memset, device_param->hip_module_shared, "gpu_memset") == -1)
+  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_memset", &device_param->opencl_kernel_memset) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
 
@@ -10254,17 +11053,17 @@ static int backend_session_setup_hip_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_memset, &device_param->kernel_wgs_memset) == -1) return -1;
+  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_wgs_memset) == -1) return -1;
 
-  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
+  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_memset = device_param->device_local_mem_size - device_param->kernel_local_mem_size_memset;
+  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_dynamic_local_mem_size_memset) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_memset = device_param->hip_warp_size;
+  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_preferred_wgs_multiple_memset) == -1) return -1;
 
   // GPU bzero
 
-  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_bzero, device_param->hip_module_shared, "gpu_bzero") == -1)
+  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_bzero", &device_param->opencl_kernel_bzero) == -1)
   {
     event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
 
@@ -10273,3047 +11072,3397 @@ static int backend_session_setup_hip_kernel_shared (hashcat_ctx_t *hashcat_ctx,
     return -2; //continue;
   }
 
-  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
+  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
 
-  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
+  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_bzero = device_param->device_local_mem_size - device_param->kernel_local_mem_size_bzero;
+  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_dynamic_local_mem_size_bzero) == -1) return -1;
 
-  device_param->kernel_preferred_wgs_multiple_bzero = device_param->hip_warp_size;
+  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_preferred_wgs_multiple_bzero) == -1) return -1;
+
+  // apple hack, but perhaps also an alternative for other vendors
+
+  if (device_param->kernel_preferred_wgs_multiple == 0) device_param->kernel_preferred_wgs_multiple = device_param->kernel_preferred_wgs_multiple_bzero;
+
+  // GPU autotune init
+
+  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_atinit", &device_param->opencl_kernel_atinit) == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
+
+    device_param->skipped_warning = true;
+
+    return -2; //continue;
+  }
+
+  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
+
+  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+
+  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_dynamic_local_mem_size_atinit) == -1) return -1;
+
+  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_preferred_wgs_multiple_atinit) == -1) return -1;
+
+  // GPU decompress
+
+  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_decompress", &device_param->opencl_kernel_decompress) == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
+
+    device_param->skipped_warning = true;
+
+    return -2; //continue;
+  }
+
+  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+
+  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+
+  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_dynamic_local_mem_size_decompress) == -1) return -1;
+
+  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_preferred_wgs_multiple_decompress) == -1) return -1;
+
+  // GPU utf8 to utf16le conversion
+
+  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_utf8_to_utf16", &device_param->opencl_kernel_utf8toutf16le) == -1)
+  {
+    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
+
+    device_param->skipped_warning = true;
+
+    return -2; //continue;
+  }
+
+  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+
+  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+
+  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_dynamic_local_mem_size_utf8toutf16le) == -1) return -1;
+
+  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_preferred_wgs_multiple_utf8toutf16le) == -1) return -1;
+
+  return 0;
+}
+
+static int backend_session_setup_cuda_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  char kernel_name[64] = { 0 };
+
+  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+  {
+    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      {
+        // kernel1
+
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+
+          device_param->skipped_warning = true;
+
+          return -2; // continue;
+        }
+
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-  // GPU autotune init
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_atinit, device_param->hip_module_shared, "gpu_atinit") == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
+        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
 
-    return -2; //continue;
-  }
+        // kernel2
 
-  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
 
-  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  device_param->kernel_dynamic_local_mem_size_atinit = device_param->device_local_mem_size - device_param->kernel_local_mem_size_atinit;
+          device_param->skipped_warning = true;
 
-  device_param->kernel_preferred_wgs_multiple_atinit = device_param->hip_warp_size;
+          return -2; // continue;
+        }
 
-  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]); if (CL_rc == -1) return -1;
-  // CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]); if (CL_rc == -1) return -1;
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-  // GPU decompress
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_decompress, device_param->hip_module_shared, "gpu_decompress") == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
+        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
 
-    return -2; //continue;
-  }
+        // kernel3
 
-  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
 
-  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  device_param->kernel_dynamic_local_mem_size_decompress = device_param->device_local_mem_size - device_param->kernel_local_mem_size_decompress;
+          device_param->skipped_warning = true;
 
-  device_param->kernel_preferred_wgs_multiple_decompress = device_param->hip_warp_size;
+          return -2; // continue;
+        }
 
-  // GPU utf8 to utf16le conversion
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-  if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_utf8toutf16le, device_param->hip_module_shared, "gpu_utf8_to_utf16") == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-    return -2; //continue;
-  }
+        device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
+      }
+      else
+      {
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
 
-  if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function4, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+          device_param->skipped_warning = true;
 
-  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = device_param->device_local_mem_size - device_param->kernel_local_mem_size_utf8toutf16le;
+          return -2; // continue;
+        }
 
-  device_param->kernel_preferred_wgs_multiple_utf8toutf16le = device_param->hip_warp_size;
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_wgs4) == -1) return -1;
 
-  return 0;
-}
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-#if defined (__APPLE__)
-static int backend_session_setup_metal_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
-{
-  // GPU memset
+        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
 
-  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_memset", &device_param->metal_function_memset, &device_param->metal_pipeline_memset) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
+        device_param->kernel_preferred_wgs_multiple4 = device_param->cuda_warp_size;
+      }
+    }
+    else
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      {
+        // kernel1
 
-    device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
 
-    return -2; //continue;
-  }
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_wgs_memset) == -1) return -1;
+          device_param->skipped_warning = true;
 
-  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
+          return -2; // continue;
+        }
 
-  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_memset, &device_param->kernel_preferred_wgs_multiple_memset) == -1) return -1;
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-  device_param->kernel_dynamic_local_mem_size_memset = 0;
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-  // GPU bzero
+        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_bzero", &device_param->metal_function_bzero, &device_param->metal_pipeline_bzero) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
+        device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
 
-    device_param->skipped_warning = true;
+        // kernel2
 
-    return -2; //continue;
-  }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
 
-  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
+          device_param->skipped_warning = true;
 
-  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_bzero, &device_param->kernel_preferred_wgs_multiple_bzero) == -1) return -1;
+          return -2; // continue;
+        }
 
-  device_param->kernel_dynamic_local_mem_size_bzero = 0;
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-  // GPU autotune init
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_atinit", &device_param->metal_function_atinit, &device_param->metal_pipeline_atinit) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
+        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
 
-    return -2; //continue;
-  }
+        // kernel3
 
-  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
 
-  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_atinit, &device_param->kernel_preferred_wgs_multiple_atinit) == -1) return -1;
+          device_param->skipped_warning = true;
 
-  device_param->kernel_dynamic_local_mem_size_atinit = 0;
+          return -2; // continue;
+        }
 
-  // GPU decompress
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_decompress", &device_param->metal_function_decompress, &device_param->metal_pipeline_decompress) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-    return -2; //continue;
-  }
+        device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
+      }
+      else
+      {
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
 
-  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function4, device_param->cuda_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+          device_param->skipped_warning = true;
 
-  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_decompress, &device_param->kernel_preferred_wgs_multiple_decompress) == -1) return -1;
+          return -2; // continue;
+        }
 
-  device_param->kernel_dynamic_local_mem_size_decompress = 0;
+        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_wgs4) == -1) return -1;
 
-  // GPU utf8 to utf16le conversion
+        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-  if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_shared, "gpu_utf8_to_utf16", &device_param->metal_function_utf8toutf16le, &device_param->metal_pipeline_utf8toutf16le) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
+        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
 
-    device_param->skipped_warning = true;
+        device_param->kernel_preferred_wgs_multiple4 = device_param->cuda_warp_size;
+      }
+    }
 
-    return -2; //continue;
-  }
+    if (user_options->slow_candidates == true)
+    {
+    }
+    else
+    {
+      if (user_options->attack_mode == ATTACK_MODE_BF)
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
 
-  if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+          if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_tm, device_param->cuda_module, kernel_name) == -1)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+            device_param->skipped_warning = true;
 
-  if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_utf8toutf16le, &device_param->kernel_preferred_wgs_multiple_utf8toutf16le) == -1) return -1;
+            return -2; // continue;
+          }
 
-  device_param->kernel_dynamic_local_mem_size_utf8toutf16le = 0;
+          if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_tm, &device_param->kernel_wgs_tm) == -1) return -1;
 
-  return 0;
-}
-#endif // __APPLE__
+          if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
 
-static int backend_session_setup_opencl_kernel_shared (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
-{
-  // GPU memset
+          device_param->kernel_dynamic_local_mem_size_tm = device_param->device_local_mem_size - device_param->kernel_local_mem_size_tm;
 
-  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_memset", &device_param->opencl_kernel_memset) == -1)
+          device_param->kernel_preferred_wgs_multiple_tm = device_param->cuda_warp_size;
+        }
+      }
+    }
+  }
+  else
   {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_memset");
+    // kernel1
 
-    device_param->skipped_warning = true;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
 
-    return -2; //continue;
-  }
+    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_wgs_memset) == -1) return -1;
+      device_param->skipped_warning = true;
 
-  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_local_mem_size_memset) == -1) return -1;
+      return -2; // continue;
+    }
 
-  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_dynamic_local_mem_size_memset) == -1) return -1;
+    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_memset, &device_param->kernel_preferred_wgs_multiple_memset) == -1) return -1;
+    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-  // GPU bzero
+    device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_bzero", &device_param->opencl_kernel_bzero) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_bzero");
+    device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
 
-    device_param->skipped_warning = true;
+    // kernel2
+
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+
+    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-    return -2; //continue;
-  }
+      device_param->skipped_warning = true;
 
-  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_wgs_bzero) == -1) return -1;
+      return -2; // continue;
+    }
 
-  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_local_mem_size_bzero) == -1) return -1;
+    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_dynamic_local_mem_size_bzero) == -1) return -1;
+    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_bzero, &device_param->kernel_preferred_wgs_multiple_bzero) == -1) return -1;
+    device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-  // apple hack, but perhaps also an alternative for other vendors
+    device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
 
-  if (device_param->kernel_preferred_wgs_multiple == 0) device_param->kernel_preferred_wgs_multiple = device_param->kernel_preferred_wgs_multiple_bzero;
+    // kernel3
 
-  // GPU autotune init
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
 
-  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_atinit", &device_param->opencl_kernel_atinit) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_atinit");
+    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-    device_param->skipped_warning = true;
+      device_param->skipped_warning = true;
 
-    return -2; //continue;
-  }
+      return -2; // continue;
+    }
 
-  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_wgs_atinit) == -1) return -1;
+    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_local_mem_size_atinit) == -1) return -1;
+    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_dynamic_local_mem_size_atinit) == -1) return -1;
+    device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_atinit, &device_param->kernel_preferred_wgs_multiple_atinit) == -1) return -1;
+    device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
 
-  // GPU decompress
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
+    {
+      // kernel2p
 
-  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_decompress", &device_param->opencl_kernel_decompress) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_decompress");
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
 
-    device_param->skipped_warning = true;
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2p, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-    return -2; //continue;
-  }
+        device_param->skipped_warning = true;
 
-  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_wgs_decompress) == -1) return -1;
+        return -2; // continue;
+      }
 
-  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_local_mem_size_decompress) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2p, &device_param->kernel_wgs2p) == -1) return -1;
 
-  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_dynamic_local_mem_size_decompress) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
 
-  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_decompress, &device_param->kernel_preferred_wgs_multiple_decompress) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size2p;
 
-  // GPU utf8 to utf16le conversion
+      device_param->kernel_preferred_wgs_multiple2p = device_param->cuda_warp_size;
+    }
 
-  if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_shared, "gpu_utf8_to_utf16", &device_param->opencl_kernel_utf8toutf16le) == -1)
-  {
-    event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "gpu_utf8_to_utf16");
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+    {
+      // kernel2e
 
-    device_param->skipped_warning = true;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
 
-    return -2; //continue;
-  }
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2e, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_wgs_utf8toutf16le) == -1) return -1;
+        device_param->skipped_warning = true;
 
-  if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_local_mem_size_utf8toutf16le) == -1) return -1;
+        return -2; // continue;
+      }
 
-  if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_dynamic_local_mem_size_utf8toutf16le) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2e, &device_param->kernel_wgs2e) == -1) return -1;
 
-  if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_utf8toutf16le, &device_param->kernel_preferred_wgs_multiple_utf8toutf16le) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
 
-  return 0;
-}
+      device_param->kernel_dynamic_local_mem_size2e = device_param->device_local_mem_size - device_param->kernel_local_mem_size2e;
 
-static int backend_session_setup_cuda_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
-{
-  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  const user_options_t *user_options = hashcat_ctx->user_options;
+      device_param->kernel_preferred_wgs_multiple2e = device_param->cuda_warp_size;
+    }
 
-  char kernel_name[64] = { 0 };
+    // kernel12
 
-  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-  {
-    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
     {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
+
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function12, device_param->cuda_module, kernel_name) == -1)
       {
-        // kernel1
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+        device_param->skipped_warning = true;
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; // continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function12, &device_param->kernel_wgs12) == -1) return -1;
 
-          return -2; // continue;
-        }
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function12, &device_param->kernel_local_mem_size12) == -1) return -1;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size12 = device_param->device_local_mem_size - device_param->kernel_local_mem_size12;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple12 = device_param->cuda_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+    // kernel23
 
-        device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
 
-        // kernel2
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function23, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
+        device_param->skipped_warning = true;
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; // continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function23, &device_param->kernel_wgs23) == -1) return -1;
 
-          return -2; // continue;
-        }
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function23, &device_param->kernel_local_mem_size23) == -1) return -1;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size23 = device_param->device_local_mem_size - device_param->kernel_local_mem_size23;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple23 = device_param->cuda_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+    // init2
 
-        device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
 
-        // kernel3
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_init2, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
+        device_param->skipped_warning = true;
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; // continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_init2, &device_param->kernel_wgs_init2) == -1) return -1;
 
-          return -2; // continue;
-        }
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_init2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_init2;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_init2 = device_param->cuda_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+    // loop2 prepare
 
-        device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
-      }
-      else
-      {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function4, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_loop2p, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; // continue;
-        }
+        return -2; // continue;
+      }
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
 
-        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
+      device_param->kernel_dynamic_local_mem_size_loop2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2p;
 
-        device_param->kernel_preferred_wgs_multiple4 = device_param->cuda_warp_size;
-      }
+      device_param->kernel_preferred_wgs_multiple_loop2p = device_param->cuda_warp_size;
     }
-    else
+
+    // loop2
+
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
     {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_loop2, device_param->cuda_module, kernel_name) == -1)
       {
-        // kernel1
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
+        device_param->skipped_warning = true;
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; // continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
 
-          return -2; // continue;
-        }
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_loop2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_loop2 = device_param->cuda_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+    // aux1
 
-        device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
 
-        // kernel2
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux1, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
+        device_param->skipped_warning = true;
+
+        return -2; // continue;
+      }
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
 
-          return -2; // continue;
-        }
+      device_param->kernel_dynamic_local_mem_size_aux1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux1;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_aux1 = device_param->cuda_warp_size;
+    }
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+    // aux2
 
-        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
 
-        device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux2, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        // kernel3
+        device_param->skipped_warning = true;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
+        return -2; // continue;
+      }
 
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
 
-          return -2; // continue;
-        }
+      device_param->kernel_dynamic_local_mem_size_aux2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux2;
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_aux2 = device_param->cuda_warp_size;
+    }
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+    // aux3
 
-        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
 
-        device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
-      }
-      else
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux3, device_param->cuda_module, kernel_name) == -1)
       {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
-
-        if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function4, device_param->cuda_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; // continue;
-        }
+        return -2; // continue;
+      }
 
-        if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
 
-        if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
 
-        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
+      device_param->kernel_dynamic_local_mem_size_aux3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux3;
 
-        device_param->kernel_preferred_wgs_multiple4 = device_param->cuda_warp_size;
-      }
+      device_param->kernel_preferred_wgs_multiple_aux3 = device_param->cuda_warp_size;
     }
 
-    if (user_options->slow_candidates == true)
-    {
-    }
-    else
+    // aux4
+
+    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
     {
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
 
-          if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_tm, device_param->cuda_module, kernel_name) == -1)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux4, device_param->cuda_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-            device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-            return -2; // continue;
-          }
+        return -2; // continue;
+      }
 
-          if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_tm, &device_param->kernel_wgs_tm) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
 
-          if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
 
-          device_param->kernel_dynamic_local_mem_size_tm = device_param->device_local_mem_size - device_param->kernel_local_mem_size_tm;
+      device_param->kernel_dynamic_local_mem_size_aux4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux4;
 
-          device_param->kernel_preferred_wgs_multiple_tm = device_param->cuda_warp_size;
-        }
-      }
+      device_param->kernel_preferred_wgs_multiple_aux4 = device_param->cuda_warp_size;
     }
   }
+
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]); if (CL_rc == -1) return -1;
+
+  // MP start
+
+  if (user_options->slow_candidates == true)
+  {
+  }
   else
   {
-    // kernel1
+    if (user_options->attack_mode == ATTACK_MODE_BF)
+    {
+      // mp_l
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp_l, device_param->cuda_module_mp, "l_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
 
-    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function1, device_param->cuda_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->skipped_warning = true;
 
-      device_param->skipped_warning = true;
+        return -2; // continue;
+      }
 
-      return -2; // continue;
-    }
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
 
-    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_wgs1) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
 
-    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_mp_l = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_l;
 
-    device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+      device_param->kernel_preferred_wgs_multiple_mp_l = device_param->cuda_warp_size;
 
-    device_param->kernel_preferred_wgs_multiple1 = device_param->cuda_warp_size;
+      // mp_r
 
-    // kernel2
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp_r, device_param->cuda_module_mp, "r_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+        device_param->skipped_warning = true;
 
-    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2, device_param->cuda_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; // continue;
+      }
 
-      device_param->skipped_warning = true;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
 
-      return -2; // continue;
-    }
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
 
-    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_wgs2) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_mp_r = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_r;
 
-    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_mp_r = device_param->cuda_warp_size;
 
-    device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+      if (user_options->attack_mode == ATTACK_MODE_BF)
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]); if (CL_rc == -1) return -1;
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]); if (CL_rc == -1) return -1;
+        }
+      }
+    }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+    {
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp, device_param->cuda_module_mp, "C_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-    device_param->kernel_preferred_wgs_multiple2 = device_param->cuda_warp_size;
+        device_param->skipped_warning = true;
 
-    // kernel3
+        return -2; // continue;
+      }
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-    if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function3, device_param->cuda_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      device_param->skipped_warning = true;
+      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
 
-      return -2; // continue;
+      device_param->kernel_preferred_wgs_multiple_mp = device_param->cuda_warp_size;
     }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+    {
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp, device_param->cuda_module_mp, "C_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-    if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_wgs3) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+        return -2; // continue;
+      }
 
-    device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-    device_param->kernel_preferred_wgs_multiple3 = device_param->cuda_warp_size;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
-    {
-      // kernel2p
+      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
+      device_param->kernel_preferred_wgs_multiple_mp = device_param->cuda_warp_size;
+    }
+  }
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2p, device_param->cuda_module, kernel_name) == -1)
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+    {
+      // nothing to do
+    }
+    else
+    {
+      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_amp, device_param->cuda_module_amp, "amp") == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
 
         device_param->skipped_warning = true;
 
         return -2; // continue;
       }
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2p, &device_param->kernel_wgs2p) == -1) return -1;
+      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_amp, &device_param->kernel_wgs_amp) == -1) return -1;
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
+      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size2p;
+      device_param->kernel_dynamic_local_mem_size_amp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_amp;
 
-      device_param->kernel_preferred_wgs_multiple2p = device_param->cuda_warp_size;
+      device_param->kernel_preferred_wgs_multiple_amp = device_param->cuda_warp_size;
     }
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+    /*
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      // kernel2e
+      // nothing to do
+    }
+    else
+    {
+      for (u32 i = 0; i < 5; i++)
+      {
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]);
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
+        //if (CL_rc == -1) return -1;
+      }
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function2e, device_param->cuda_module, kernel_name) == -1)
+      for (u32 i = 5; i < 6; i++)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]);
 
-        return -2; // continue;
+        //if (CL_rc == -1) return -1;
       }
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function2e, &device_param->kernel_wgs2e) == -1) return -1;
+      for (u32 i = 6; i < 7; i++)
+      {
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
+        //if (CL_rc == -1) return -1;
+      }
+    }
+    */
+  }
 
-      device_param->kernel_dynamic_local_mem_size2e = device_param->device_local_mem_size - device_param->kernel_local_mem_size2e;
+  return 0;
+}
 
-      device_param->kernel_preferred_wgs_multiple2e = device_param->cuda_warp_size;
-    }
+static int backend_session_setup_hip_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const user_options_t *user_options = hashcat_ctx->user_options;
 
-    // kernel12
+  char kernel_name[64] = { 0 };
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+  {
+    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
-
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function12, device_param->cuda_module, kernel_name) == -1)
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        // kernel1
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function12, &device_param->kernel_wgs12) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function12, &device_param->kernel_local_mem_size12) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size12 = device_param->device_local_mem_size - device_param->kernel_local_mem_size12;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple12 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-    // kernel23
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
+        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function23, device_param->cuda_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
 
-        device_param->skipped_warning = true;
+        // kernel2
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function23, &device_param->kernel_wgs23) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function23, &device_param->kernel_local_mem_size23) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size23 = device_param->device_local_mem_size - device_param->kernel_local_mem_size23;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple23 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-    // init2
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
+        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_init2, device_param->cuda_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
 
-        device_param->skipped_warning = true;
+        // kernel3
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_init2, &device_param->kernel_wgs_init2) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_init2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_init2;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_init2 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-    // loop2 prepare
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
+        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_loop2p, device_param->cuda_module, kernel_name) == -1)
+        device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
+      }
+      else
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
 
-        return -2; // continue;
-      }
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function4, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_loop2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2p;
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function4, &device_param->kernel_wgs4) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_loop2p = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-    // loop2
+        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
+        device_param->kernel_preferred_wgs_multiple4 = device_param->hip_warp_size;
+      }
+    }
+    else
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
-
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_loop2, device_param->cuda_module, kernel_name) == -1)
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        // kernel1
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_loop2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_loop2 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-    // aux1
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
+        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux1, device_param->cuda_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
 
-        device_param->skipped_warning = true;
+        // kernel2
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_aux1 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-    // aux2
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
+        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux2, device_param->cuda_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
 
-        device_param->skipped_warning = true;
+        // kernel3
 
-        return -2; // continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux2;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_aux2 = device_param->cuda_warp_size;
-    }
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-    // aux3
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
+        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux3, device_param->cuda_module, kernel_name) == -1)
+        device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
+      }
+      else
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
 
-        device_param->skipped_warning = true;
+        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function4, device_param->hip_module, kernel_name) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        return -2; // continue;
-      }
+          device_param->skipped_warning = true;
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
+          return -2; //continue;
+        }
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
+        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function4, &device_param->kernel_wgs4) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_aux3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux3;
+        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_aux3 = device_param->cuda_warp_size;
-    }
+        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
 
-    // aux4
+        device_param->kernel_preferred_wgs_multiple4 = device_param->hip_warp_size;
+      }
+    }
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
+    if (user_options->slow_candidates == true)
+    {
+    }
+    else
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
-
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_aux4, device_param->cuda_module, kernel_name) == -1)
+      if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
-
-        return -2; // continue;
-      }
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
+          if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_tm, device_param->hip_module, kernel_name) == -1)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
+            device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux4;
+            return -2; //continue;
+          }
 
-      device_param->kernel_preferred_wgs_multiple_aux4 = device_param->cuda_warp_size;
-    }
-  }
+          if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_tm, &device_param->kernel_wgs_tm) == -1) return -1;
 
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]); if (CL_rc == -1) return -1;
+          if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
 
-  // MP start
+          device_param->kernel_dynamic_local_mem_size_tm = device_param->device_local_mem_size - device_param->kernel_local_mem_size_tm;
 
-  if (user_options->slow_candidates == true)
-  {
+          device_param->kernel_preferred_wgs_multiple_tm = device_param->hip_warp_size;
+        }
+      }
+    }
   }
   else
   {
-    if (user_options->attack_mode == ATTACK_MODE_BF)
-    {
-      // mp_l
+    // kernel1
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp_l, device_param->cuda_module_mp, "l_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
 
-        device_param->skipped_warning = true;
+    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        return -2; // continue;
-      }
+      device_param->skipped_warning = true;
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
+      return -2; //continue;
+    }
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
+    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_mp_l = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_l;
+    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_mp_l = device_param->cuda_warp_size;
+    device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
 
-      // mp_r
+    device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
 
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp_r, device_param->cuda_module_mp, "r_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
+    // kernel2
 
-        device_param->skipped_warning = true;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
 
-        return -2; // continue;
-      }
+    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
+      device_param->skipped_warning = true;
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
+      return -2; //continue;
+    }
 
-      device_param->kernel_dynamic_local_mem_size_mp_r = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_r;
+    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_mp_r = device_param->cuda_warp_size;
+    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]); if (CL_rc == -1) return -1;
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]); if (CL_rc == -1) return -1;
-        }
-      }
-    }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-    {
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp, device_param->cuda_module_mp, "C_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+    device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
 
-        device_param->skipped_warning = true;
+    device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
 
-        return -2; // continue;
-      }
+    // kernel3
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
+      device_param->skipped_warning = true;
 
-      device_param->kernel_preferred_wgs_multiple_mp = device_param->cuda_warp_size;
+      return -2; //continue;
     }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-    {
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_mp, device_param->cuda_module_mp, "C_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-        device_param->skipped_warning = true;
+    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
 
-        return -2; // continue;
-      }
+    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+    device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+    device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
 
-      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
+    {
+      // kernel2p
 
-      device_param->kernel_preferred_wgs_multiple_mp = device_param->cuda_warp_size;
-    }
-  }
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
 
-  if (user_options->slow_candidates == true)
-  {
-  }
-  else
-  {
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
-    {
-      if (hc_cuModuleGetFunction (hashcat_ctx, &device_param->cuda_function_amp, device_param->cuda_module_amp, "amp") == -1)
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2p, device_param->hip_module, kernel_name) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
         device_param->skipped_warning = true;
 
-        return -2; // continue;
+        return -2; //continue;
       }
 
-      if (get_cuda_kernel_wgs (hashcat_ctx, device_param->cuda_function_amp, &device_param->kernel_wgs_amp) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2p, &device_param->kernel_wgs2p) == -1) return -1;
 
-      if (get_cuda_kernel_local_mem_size (hashcat_ctx, device_param->cuda_function_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_amp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_amp;
+      device_param->kernel_dynamic_local_mem_size2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size2p;
 
-      device_param->kernel_preferred_wgs_multiple_amp = device_param->cuda_warp_size;
+      device_param->kernel_preferred_wgs_multiple2p = device_param->hip_warp_size;
     }
 
-    /*
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
     {
-      for (u32 i = 0; i < 5; i++)
-      {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]);
+      // kernel2e
 
-        //if (CL_rc == -1) return -1;
-      }
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
 
-      for (u32 i = 5; i < 6; i++)
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2e, device_param->hip_module, kernel_name) == -1)
       {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        //if (CL_rc == -1) return -1;
+        device_param->skipped_warning = true;
+
+        return -2; //continue;
       }
 
-      for (u32 i = 6; i < 7; i++)
-      {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]);
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2e, &device_param->kernel_wgs2e) == -1) return -1;
 
-        //if (CL_rc == -1) return -1;
-      }
-    }
-    */
-  }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
 
-  return 0;
-}
+      device_param->kernel_dynamic_local_mem_size2e = device_param->device_local_mem_size - device_param->kernel_local_mem_size2e;
 
-static int backend_session_setup_hip_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
-{
-  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  const user_options_t *user_options = hashcat_ctx->user_options;
+      device_param->kernel_preferred_wgs_multiple2e = device_param->hip_warp_size;
+    }
 
-  char kernel_name[64] = { 0 };
+    // kernel12
 
-  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-  {
-    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
     {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
+
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function12, device_param->hip_module, kernel_name) == -1)
       {
-        // kernel1
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+        device_param->skipped_warning = true;
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; //continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function12, &device_param->kernel_wgs12) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function12, &device_param->kernel_local_mem_size12) == -1) return -1;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size12 = device_param->device_local_mem_size - device_param->kernel_local_mem_size12;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple12 = device_param->hip_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+    // kernel23
 
-        device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
 
-        // kernel2
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function23, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
+        device_param->skipped_warning = true;
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; //continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function23, &device_param->kernel_wgs23) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function23, &device_param->kernel_local_mem_size23) == -1) return -1;
+
+      device_param->kernel_dynamic_local_mem_size23 = device_param->device_local_mem_size - device_param->kernel_local_mem_size23;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple23 = device_param->hip_warp_size;
+    }
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+    // init2
 
-        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
 
-        device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_init2, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        // kernel3
+        device_param->skipped_warning = true;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
+        return -2; //continue;
+      }
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_init2, &device_param->kernel_wgs_init2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      device_param->kernel_dynamic_local_mem_size_init2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_init2;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_init2 = device_param->hip_warp_size;
+    }
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+    // loop2 prepare
 
-        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
 
-        device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
-      }
-      else
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_loop2p, device_param->hip_module, kernel_name) == -1)
       {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
-
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function4, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; //continue;
-        }
+        return -2; //continue;
+      }
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
 
-        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
+      device_param->kernel_dynamic_local_mem_size_loop2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2p;
 
-        device_param->kernel_preferred_wgs_multiple4 = device_param->hip_warp_size;
-      }
+      device_param->kernel_preferred_wgs_multiple_loop2p = device_param->hip_warp_size;
     }
-    else
+
+    // loop2
+
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
     {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_loop2, device_param->hip_module, kernel_name) == -1)
       {
-        // kernel1
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
+        device_param->skipped_warning = true;
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; //continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_loop2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_loop2 = device_param->hip_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+    // aux1
 
-        device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
 
-        // kernel2
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux1, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
+        device_param->skipped_warning = true;
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; //continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_aux1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux1;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_aux1 = device_param->hip_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+    // aux2
 
-        device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
 
-        // kernel3
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux2, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
+        device_param->skipped_warning = true;
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        return -2; //continue;
+      }
 
-          device_param->skipped_warning = true;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_aux2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux2;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      device_param->kernel_preferred_wgs_multiple_aux2 = device_param->hip_warp_size;
+    }
 
-        device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+    // aux3
 
-        device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
-      }
-      else
-      {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
+    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
 
-        if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function4, device_param->hip_module, kernel_name) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux3, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; //continue;
-        }
+        return -2; //continue;
+      }
 
-        if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
 
-        if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
 
-        device_param->kernel_dynamic_local_mem_size4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size4;
+      device_param->kernel_dynamic_local_mem_size_aux3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux3;
 
-        device_param->kernel_preferred_wgs_multiple4 = device_param->hip_warp_size;
-      }
+      device_param->kernel_preferred_wgs_multiple_aux3 = device_param->hip_warp_size;
     }
 
-    if (user_options->slow_candidates == true)
-    {
-    }
-    else
+    // aux4
+
+    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
     {
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
 
-          if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_tm, device_param->hip_module, kernel_name) == -1)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux4, device_param->hip_module, kernel_name) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-            device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-            return -2; //continue;
-          }
+        return -2; //continue;
+      }
 
-          if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_tm, &device_param->kernel_wgs_tm) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
 
-          if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
 
-          device_param->kernel_dynamic_local_mem_size_tm = device_param->device_local_mem_size - device_param->kernel_local_mem_size_tm;
+      device_param->kernel_dynamic_local_mem_size_aux4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux4;
 
-          device_param->kernel_preferred_wgs_multiple_tm = device_param->hip_warp_size;
-        }
-      }
+      device_param->kernel_preferred_wgs_multiple_aux4 = device_param->hip_warp_size;
     }
   }
-  else
-  {
-    // kernel1
-
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
-
-    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function1, device_param->hip_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-      device_param->skipped_warning = true;
 
-      return -2; //continue;
-    }
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
+  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]); if (CL_rc == -1) return -1;
 
-    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function1, &device_param->kernel_wgs1) == -1) return -1;
+  // MP start
 
-    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function1, &device_param->kernel_local_mem_size1) == -1) return -1;
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (user_options->attack_mode == ATTACK_MODE_BF)
+    {
+      // mp_l
 
-    device_param->kernel_dynamic_local_mem_size1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size1;
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp_l, device_param->hip_module_mp, "l_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
 
-    device_param->kernel_preferred_wgs_multiple1 = device_param->hip_warp_size;
+        device_param->skipped_warning = true;
 
-    // kernel2
+        return -2; //continue;
+      }
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
 
-    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2, device_param->hip_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
 
-      device_param->skipped_warning = true;
+      device_param->kernel_dynamic_local_mem_size_mp_l = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_l;
 
-      return -2; //continue;
-    }
+      device_param->kernel_preferred_wgs_multiple_mp_l = device_param->hip_warp_size;
 
-    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2, &device_param->kernel_wgs2) == -1) return -1;
+      // mp_r
 
-    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp_r, device_param->hip_module_mp, "r_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
 
-    device_param->kernel_dynamic_local_mem_size2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size2;
+        device_param->skipped_warning = true;
 
-    device_param->kernel_preferred_wgs_multiple2 = device_param->hip_warp_size;
+        return -2; //continue;
+      }
 
-    // kernel3
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
 
-    if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function3, device_param->hip_module, kernel_name) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      device_param->kernel_dynamic_local_mem_size_mp_r = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_r;
 
-      device_param->skipped_warning = true;
+      device_param->kernel_preferred_wgs_multiple_mp_r = device_param->hip_warp_size;
 
-      return -2; //continue;
+      if (user_options->attack_mode == ATTACK_MODE_BF)
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]); if (CL_rc == -1) return -1;
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]); if (CL_rc == -1) return -1;
+        }
+      }
     }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+    {
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp, device_param->hip_module_mp, "C_markov") == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-    if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function3, &device_param->kernel_wgs3) == -1) return -1;
-
-    if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function3, &device_param->kernel_local_mem_size3) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    device_param->kernel_dynamic_local_mem_size3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size3;
+        return -2; //continue;
+      }
 
-    device_param->kernel_preferred_wgs_multiple3 = device_param->hip_warp_size;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
-    {
-      // kernel2p
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
+      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2p, device_param->hip_module, kernel_name) == -1)
+      device_param->kernel_preferred_wgs_multiple_mp = device_param->hip_warp_size;
+    }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+    {
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp, device_param->hip_module_mp, "C_markov") == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2p, &device_param->kernel_wgs2p) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size2p;
+      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
 
-      device_param->kernel_preferred_wgs_multiple2p = device_param->hip_warp_size;
+      device_param->kernel_preferred_wgs_multiple_mp = device_param->hip_warp_size;
     }
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      // kernel2e
-
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
-
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function2e, device_param->hip_module, kernel_name) == -1)
+      // nothing to do
+    }
+    else
+    {
+      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_amp, device_param->hip_module_amp, "amp") == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function2e, &device_param->kernel_wgs2e) == -1) return -1;
+      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_amp, &device_param->kernel_wgs_amp) == -1) return -1;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
+      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size2e = device_param->device_local_mem_size - device_param->kernel_local_mem_size2e;
+      device_param->kernel_dynamic_local_mem_size_amp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_amp;
 
-      device_param->kernel_preferred_wgs_multiple2e = device_param->hip_warp_size;
+      device_param->kernel_preferred_wgs_multiple_amp = device_param->hip_warp_size;
     }
 
-    // kernel12
-
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+    /*
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
-
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function12, device_param->hip_module, kernel_name) == -1)
+      // nothing to do
+    }
+    else
+    {
+      for (u32 i = 0; i < 5; i++)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]);
 
-        return -2; //continue;
+        //if (CL_rc == -1) return -1;
       }
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function12, &device_param->kernel_wgs12) == -1) return -1;
+      for (u32 i = 5; i < 6; i++)
+      {
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function12, &device_param->kernel_local_mem_size12) == -1) return -1;
+        //if (CL_rc == -1) return -1;
+      }
 
-      device_param->kernel_dynamic_local_mem_size12 = device_param->device_local_mem_size - device_param->kernel_local_mem_size12;
+      for (u32 i = 6; i < 7; i++)
+      {
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]);
 
-      device_param->kernel_preferred_wgs_multiple12 = device_param->hip_warp_size;
+        //if (CL_rc == -1) return -1;
+      }
     }
+    */
+  }
 
-    // kernel23
+  return 0;
+}
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
+#if defined (__APPLE__)
+static int backend_session_setup_metal_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const user_options_t *user_options = hashcat_ctx->user_options;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function23, device_param->hip_module, kernel_name) == -1)
+  char kernel_name[64] = { 0 };
+
+  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+  {
+    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        // kernel1: m%05u_s%02d
 
-        device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
 
-        return -2; //continue;
-      }
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function23, &device_param->kernel_wgs23) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function23, &device_param->kernel_local_mem_size23) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size23 = device_param->device_local_mem_size - device_param->kernel_local_mem_size23;
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple23 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-    // init2
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
+        device_param->kernel_dynamic_local_mem_size1 = 0;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_init2, device_param->hip_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        // kernel2: m%05u_s%02d
 
-        device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
 
-        return -2; //continue;
-      }
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_init2, &device_param->kernel_wgs_init2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_init2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_init2;
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_init2 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-    // loop2 prepare
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
+        device_param->kernel_dynamic_local_mem_size2 = 0;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_loop2p, device_param->hip_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        // kernel3: m%05u_s%02d
 
-        device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
 
-        return -2; //continue;
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+
+          device_param->skipped_warning = true;
+
+          return -2; //continue;
+        }
+
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
+
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
+
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+
+        device_param->kernel_dynamic_local_mem_size3 = 0;
       }
+      else
+      {
+        // kernel4: m%05u_sxx
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function4, &device_param->metal_pipeline4) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size_loop2p = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2p;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_preferred_wgs_multiple_loop2p = device_param->hip_warp_size;
-    }
+          return -2; //continue;
+        }
 
-    // loop2
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_wgs4) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_loop2, device_param->hip_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        device_param->kernel_dynamic_local_mem_size4 = 0;
+      }
+    }
+    else // multi
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      {
+        // kernel1
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_loop2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_loop2;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_loop2 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
 
-    // aux1
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux1, device_param->hip_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_dynamic_local_mem_size1 = 0;
 
-        device_param->skipped_warning = true;
+        // kernel2
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux1 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_aux1 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
 
-    // aux2
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux2, device_param->hip_module, kernel_name) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->kernel_dynamic_local_mem_size2 = 0;
 
-        device_param->skipped_warning = true;
+        // kernel3
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux2 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux2;
+          return -2; //continue;
+        }
 
-      device_param->kernel_preferred_wgs_multiple_aux2 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
 
-    // aux3
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux3, device_param->hip_module, kernel_name) == -1)
+        device_param->kernel_dynamic_local_mem_size3 = 0;
+      }
+      else
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        // kernel4
 
-        device_param->skipped_warning = true;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
 
-        return -2; //continue;
-      }
+        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function4, &device_param->metal_pipeline4) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_aux3 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux3;
+        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_wgs4) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_aux3 = device_param->hip_warp_size;
-    }
+        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-    // aux4
+        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
+        device_param->kernel_dynamic_local_mem_size4 = 0;
+      }
+    }
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_aux4, device_param->hip_module, kernel_name) == -1)
+    if (user_options->slow_candidates == true)
+    {
+    }
+    else
+    {
+      if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
-
-        return -2; //continue;
-      }
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
+          if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_tm, &device_param->metal_pipeline_tm) == -1)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
+            device_param->skipped_warning = true;
 
-      device_param->kernel_dynamic_local_mem_size_aux4 = device_param->device_local_mem_size - device_param->kernel_local_mem_size_aux4;
+            return -2; //continue;
+          }
 
-      device_param->kernel_preferred_wgs_multiple_aux4 = device_param->hip_warp_size;
-    }
-  }
+          if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_wgs_tm) == -1) return -1;
 
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
-  //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]); if (CL_rc == -1) return -1;
+          if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
 
-  // MP start
+          if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_preferred_wgs_multiple_tm) == -1) return -1;
 
-  if (user_options->slow_candidates == true)
-  {
+          device_param->kernel_dynamic_local_mem_size_tm = 0;
+        }
+      }
+    }
   }
   else
   {
-    if (user_options->attack_mode == ATTACK_MODE_BF)
-    {
-      // mp_l
-
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp_l, device_param->hip_module_mp, "l_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
-
-        device_param->skipped_warning = true;
-
-        return -2; //continue;
-      }
+    // kernel1: m%05u_init
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
+    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size_mp_l = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_l;
+      device_param->skipped_warning = true;
 
-      device_param->kernel_preferred_wgs_multiple_mp_l = device_param->hip_warp_size;
+      return -2; //continue;
+    }
 
-      // mp_r
+    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
 
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp_r, device_param->hip_module_mp, "r_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
+    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-        device_param->skipped_warning = true;
+    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-        return -2; //continue;
-      }
+    device_param->kernel_dynamic_local_mem_size1 = 0;
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
+    // kernel2: m%05u_loop
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
 
-      device_param->kernel_dynamic_local_mem_size_mp_r = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp_r;
+    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_preferred_wgs_multiple_mp_r = device_param->hip_warp_size;
+      device_param->skipped_warning = true;
 
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]); if (CL_rc == -1) return -1;
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]); if (CL_rc == -1) return -1;
-        }
-      }
+      return -2; //continue;
     }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-    {
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp, device_param->hip_module_mp, "C_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-        device_param->skipped_warning = true;
+    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
 
-        return -2; //continue;
-      }
+    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+    device_param->kernel_dynamic_local_mem_size2 = 0;
 
-      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
+    // kernel3: m%05u_comp
 
-      device_param->kernel_preferred_wgs_multiple_mp = device_param->hip_warp_size;
-    }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+
+    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
     {
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_mp, device_param->hip_module_mp, "C_markov") == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        device_param->skipped_warning = true;
+      device_param->skipped_warning = true;
 
-        return -2; //continue;
-      }
+      return -2; //continue;
+    }
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_mp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_mp;
+    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_mp = device_param->hip_warp_size;
-    }
-  }
+    device_param->kernel_dynamic_local_mem_size3 = 0;
 
-  if (user_options->slow_candidates == true)
-  {
-  }
-  else
-  {
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
     {
-      if (hc_hipModuleGetFunction (hashcat_ctx, &device_param->hip_function_amp, device_param->hip_module_amp, "amp") == -1)
+      // kernel2p: m%05u_loop_prepare
+
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
+
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2p, &device_param->metal_pipeline2p) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_hip_kernel_wgs (hashcat_ctx, device_param->hip_function_amp, &device_param->kernel_wgs_amp) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_wgs2p) == -1) return -1;
 
-      if (get_hip_kernel_local_mem_size (hashcat_ctx, device_param->hip_function_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_amp = device_param->device_local_mem_size - device_param->kernel_local_mem_size_amp;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_preferred_wgs_multiple2p) == -1) return -1;
 
-      device_param->kernel_preferred_wgs_multiple_amp = device_param->hip_warp_size;
+      device_param->kernel_dynamic_local_mem_size2p = 0;
     }
 
-    /*
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
     {
-      for (u32 i = 0; i < 5; i++)
-      {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]);
+      // kernel2e: m%05u_loop_extended
 
-        //if (CL_rc == -1) return -1;
-      }
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
 
-      for (u32 i = 5; i < 6; i++)
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2e, &device_param->metal_pipeline2e) == -1)
       {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]);
-
-        //if (CL_rc == -1) return -1;
-      }
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      for (u32 i = 6; i < 7; i++)
-      {
-        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]);
+        device_param->skipped_warning = true;
 
-        //if (CL_rc == -1) return -1;
+        return -2; //continue;
       }
-    }
-    */
-  }
-
-  return 0;
-}
-
-#if defined (__APPLE__)
-static int backend_session_setup_metal_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
-{
-  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  const user_options_t *user_options = hashcat_ctx->user_options;
 
-  char kernel_name[64] = { 0 };
-
-  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-  {
-    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
-    {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
-      {
-        // kernel1: m%05u_s%02d
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_wgs2e) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_preferred_wgs_multiple2e) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      device_param->kernel_dynamic_local_mem_size2e = 0;
+    }
 
-          return -2; //continue;
-        }
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+    {
+      // kernel12: m%05u_hook12
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function12, &device_param->metal_pipeline12) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        device_param->kernel_dynamic_local_mem_size1 = 0;
+        return -2; //continue;
+      }
 
-        // kernel2: m%05u_s%02d
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_wgs12) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_local_mem_size12) == -1) return -1;
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_preferred_wgs_multiple12) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      device_param->kernel_dynamic_local_mem_size12 = 0;
+    }
 
-          return -2; //continue;
-        }
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+    {
+      // kernel23: m%05u_hook23
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function23, &device_param->metal_pipeline23) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        device_param->kernel_dynamic_local_mem_size2 = 0;
+        return -2; //continue;
+      }
 
-        // kernel3: m%05u_s%02d
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_wgs23) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_local_mem_size23) == -1) return -1;
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_preferred_wgs_multiple23) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      device_param->kernel_dynamic_local_mem_size23 = 0;
+    }
 
-          return -2; //continue;
-        }
+    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+    {
+      // init2: m%05u_init2
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_init2, &device_param->metal_pipeline_init2) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        device_param->kernel_dynamic_local_mem_size3 = 0;
+        return -2; //continue;
       }
-      else
-      {
-        // kernel4: m%05u_sxx
-
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function4, &device_param->metal_pipeline4) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_wgs_init2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_preferred_wgs_multiple_init2) == -1) return -1;
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_wgs4) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_init2 = 0;
+    }
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_local_mem_size4) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+    {
+      // loop2 prepare: m%05u_loop2_prepare
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
 
-        device_param->kernel_dynamic_local_mem_size4 = 0;
-      }
-    }
-    else // multi
-    {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_loop2p, &device_param->metal_pipeline_loop2p) == -1)
       {
-        // kernel1
-
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->skipped_warning = true;
 
-          device_param->skipped_warning = true;
+        return -2; //continue;
+      }
 
-          return -2; //continue;
-        }
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_preferred_wgs_multiple_loop2p) == -1) return -1;
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_loop2p = 0;
+    }
 
-        device_param->kernel_dynamic_local_mem_size1 = 0;
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
+    {
+      // loop2: m%05u_loop2
 
-        // kernel2
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_loop2, &device_param->metal_pipeline_loop2) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->skipped_warning = true;
 
-          device_param->skipped_warning = true;
+        return -2; //continue;
+      }
 
-          return -2; //continue;
-        }
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_preferred_wgs_multiple_loop2) == -1) return -1;
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_loop2 = 0;
+    }
 
-        device_param->kernel_dynamic_local_mem_size2 = 0;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+    {
+      // aux1: m%05u_aux1
 
-        // kernel3
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux1, &device_param->metal_pipeline_aux1) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        device_param->skipped_warning = true;
 
-          device_param->skipped_warning = true;
+        return -2; //continue;
+      }
 
-          return -2; //continue;
-        }
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_preferred_wgs_multiple_aux1) == -1) return -1;
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+      device_param->kernel_dynamic_local_mem_size_aux1 = 0;
+    }
 
-        device_param->kernel_dynamic_local_mem_size3 = 0;
-      }
-      else
-      {
-        // kernel4
+    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
+    {
+      // aux2: m%05u_aux2
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
 
-        if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function4, &device_param->metal_pipeline4) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux2, &device_param->metal_pipeline_aux2) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; //continue;
-        }
+        return -2; //continue;
+      }
 
-        if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
 
-        if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
 
-        if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_preferred_wgs_multiple_aux2) == -1) return -1;
 
-        device_param->kernel_dynamic_local_mem_size4 = 0;
-      }
+      device_param->kernel_dynamic_local_mem_size_aux2 = 0;
     }
 
-    if (user_options->slow_candidates == true)
-    {
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
     {
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
+      // aux3: m%05u_aux3
 
-          if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_tm, &device_param->metal_pipeline_tm) == -1)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
 
-            device_param->skipped_warning = true;
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux3, &device_param->metal_pipeline_aux3) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-            return -2; //continue;
-          }
+        device_param->skipped_warning = true;
 
-          if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_wgs_tm) == -1) return -1;
+        return -2; //continue;
+      }
 
-          if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
 
-          if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_tm, &device_param->kernel_preferred_wgs_multiple_tm) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
 
-          device_param->kernel_dynamic_local_mem_size_tm = 0;
-        }
-      }
-    }
-  }
-  else
-  {
-    // kernel1: m%05u_init
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_preferred_wgs_multiple_aux3) == -1) return -1;
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
+      device_param->kernel_dynamic_local_mem_size_aux3 = 0;
+    }
 
-    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function1, &device_param->metal_pipeline1) == -1)
+    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
     {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      // aux4: m%05u_aux4
 
-      device_param->skipped_warning = true;
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
 
-      return -2; //continue;
-    }
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux4, &device_param->metal_pipeline_aux4) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_wgs1) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_local_mem_size1) == -1) return -1;
+        return -2; //continue;
+      }
 
-    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
 
-    device_param->kernel_dynamic_local_mem_size1 = 0;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
 
-    // kernel2: m%05u_loop
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_preferred_wgs_multiple_aux4) == -1) return -1;
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+      device_param->kernel_dynamic_local_mem_size_aux4 = 0;
+    }
+  }
 
-    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2, &device_param->metal_pipeline2) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+  // MP start
 
-      device_param->skipped_warning = true;
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (user_options->attack_mode == ATTACK_MODE_BF)
+    {
+      // mp_l: l_markov
 
-      return -2; //continue;
-    }
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "l_markov", &device_param->metal_function_mp_l, &device_param->metal_pipeline_mp_l) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
 
-    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_wgs2) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_local_mem_size2) == -1) return -1;
+        return -2; //continue;
+      }
 
-    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
 
-    device_param->kernel_dynamic_local_mem_size2 = 0;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
 
-    // kernel3: m%05u_comp
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_preferred_wgs_multiple_mp_l) == -1) return -1;
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+      device_param->kernel_dynamic_local_mem_size_mp_l = 0;
 
-    if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function3, &device_param->metal_pipeline3) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      // mp_r: r_markov
 
-      device_param->skipped_warning = true;
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "r_markov", &device_param->metal_function_mp_r, &device_param->metal_pipeline_mp_r) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
 
-      return -2; //continue;
-    }
+        device_param->skipped_warning = true;
 
-    if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_wgs3) == -1) return -1;
+        return -2; //continue;
+      }
 
-    if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
 
-    if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
 
-    device_param->kernel_dynamic_local_mem_size3 = 0;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_preferred_wgs_multiple_mp_r) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
+      device_param->kernel_dynamic_local_mem_size_mp_r = 0;
+    }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
     {
-      // kernel2p: m%05u_loop_prepare
-
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
+      // mp_c: C_markov
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2p, &device_param->metal_pipeline2p) == -1)
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "C_markov", &device_param->metal_function_mp, &device_param->metal_pipeline_mp) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_wgs2p) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2p, &device_param->kernel_preferred_wgs_multiple2p) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size2p = 0;
+      device_param->kernel_dynamic_local_mem_size_mp = 0;
     }
-
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
     {
-      // kernel2e: m%05u_loop_extended
-
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
+      // mp_c: C_markov
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function2e, &device_param->metal_pipeline2e) == -1)
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "C_markov", &device_param->metal_function_mp, &device_param->metal_pipeline_mp) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_wgs2e) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline2e, &device_param->kernel_preferred_wgs_multiple2e) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size2e = 0;
+      device_param->kernel_dynamic_local_mem_size_mp = 0;
     }
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      // kernel12: m%05u_hook12
-
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
+      // nothing to do
+    }
+    else
+    {
+      // amp
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function12, &device_param->metal_pipeline12) == -1)
+      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_amp, "amp", &device_param->metal_function_amp, &device_param->metal_pipeline_amp) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_wgs12) == -1) return -1;
+      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_wgs_amp) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_local_mem_size12) == -1) return -1;
+      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline12, &device_param->kernel_preferred_wgs_multiple12) == -1) return -1;
+      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_preferred_wgs_multiple_amp) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size12 = 0;
+      device_param->kernel_dynamic_local_mem_size_amp = 0;
     }
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+  return 0;
+}
+#endif // __APPLE__
+
+static int backend_session_setup_opencl_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
+{
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  // GPU autotune init
+
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]) == -1) return -1;
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]) == -1) return -1;
+
+  // GPU utf8 to utf16le init
+
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_utf8toutf16le, 0, sizeof (cl_mem),   device_param->kernel_params_utf8toutf16le[0]) == -1) return -1;
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_utf8toutf16le, 1, sizeof (cl_ulong), device_param->kernel_params_utf8toutf16le[1]) == -1) return -1;
+
+  // GPU decompress
+
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]) == -1) return -1;
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]) == -1) return -1;
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]) == -1) return -1;
+  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]) == -1) return -1;
+
+  char kernel_name[64] = { 0 };
+
+  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+  {
+    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
     {
-      // kernel23: m%05u_hook23
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      {
+        // kernel1
+
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+
+          device_param->skipped_warning = true;
+
+          return -2; //continue;
+        }
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function23, &device_param->metal_pipeline23) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
 
-        return -2; //continue;
-      }
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_wgs23) == -1) return -1;
+        // kernel2
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_local_mem_size23) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline23, &device_param->kernel_preferred_wgs_multiple23) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size23 = 0;
-    }
+          device_param->skipped_warning = true;
 
-    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
-    {
-      // init2: m%05u_init2
+          return -2; //continue;
+        }
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_init2, &device_param->metal_pipeline_init2) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
 
-        return -2; //continue;
-      }
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_wgs_init2) == -1) return -1;
+        // kernel3
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_init2, &device_param->kernel_preferred_wgs_multiple_init2) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size_init2 = 0;
-    }
+          device_param->skipped_warning = true;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
-    {
-      // loop2 prepare: m%05u_loop2_prepare
+          return -2; //continue;
+        }
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_loop2p, &device_param->metal_pipeline_loop2p) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
 
-        return -2; //continue;
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
       }
+      else
+      {
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel4) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_loop2p, &device_param->kernel_preferred_wgs_multiple_loop2p) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_loop2p = 0;
-    }
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_wgs4) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
-    {
-      // loop2: m%05u_loop2
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_loop2, &device_param->metal_pipeline_loop2) == -1)
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
+      }
+    }
+    else
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        // kernel1
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_loop2, &device_param->kernel_preferred_wgs_multiple_loop2) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_loop2 = 0;
-    }
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
-    {
-      // aux1: m%05u_aux1
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux1, &device_param->metal_pipeline_aux1) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        // kernel2
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux1, &device_param->kernel_preferred_wgs_multiple_aux1) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_aux1 = 0;
-    }
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
-    {
-      // aux2: m%05u_aux2
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux2, &device_param->metal_pipeline_aux2) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-        device_param->skipped_warning = true;
+        // kernel3
 
-        return -2; //continue;
-      }
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
+          device_param->skipped_warning = true;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux2, &device_param->kernel_preferred_wgs_multiple_aux2) == -1) return -1;
+          return -2; //continue;
+        }
 
-      device_param->kernel_dynamic_local_mem_size_aux2 = 0;
-    }
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
-    {
-      // aux3: m%05u_aux3
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux3, &device_param->metal_pipeline_aux3) == -1)
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+      }
+      else
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
 
-        device_param->skipped_warning = true;
+        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel4) == -1)
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        return -2; //continue;
-      }
+          device_param->skipped_warning = true;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
+          return -2; //continue;
+        }
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
+        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_wgs4) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux3, &device_param->kernel_preferred_wgs_multiple_aux3) == -1) return -1;
+        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_local_mem_size4) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_aux3 = 0;
+        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
+
+        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
+      }
     }
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
+    if (user_options->slow_candidates == true)
     {
-      // aux4: m%05u_aux4
-
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
-
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library, kernel_name, &device_param->metal_function_aux4, &device_param->metal_pipeline_aux4) == -1)
+    }
+    else
+    {
+      if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
 
-        return -2; //continue;
-      }
+          if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_tm) == -1)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
+            device_param->skipped_warning = true;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
+            return -2; //continue;
+          }
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_aux4, &device_param->kernel_preferred_wgs_multiple_aux4) == -1) return -1;
+          if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_wgs_tm) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_aux4 = 0;
-    }
-  }
+          if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
 
-  // MP start
+          if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_dynamic_local_mem_size_tm) == -1) return -1;
 
-  if (user_options->slow_candidates == true)
-  {
+          if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_preferred_wgs_multiple_tm) == -1) return -1;
+        }
+      }
+    }
   }
   else
   {
-    if (user_options->attack_mode == ATTACK_MODE_BF)
+    // kernel1
+
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
+
+    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
     {
-      // mp_l: l_markov
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "l_markov", &device_param->metal_function_mp_l, &device_param->metal_pipeline_mp_l) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
+      device_param->skipped_warning = true;
+
+      return -2; //continue;
+    }
+
+    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
+
+    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
 
-        device_param->skipped_warning = true;
+    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
 
-        return -2; //continue;
-      }
+    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
+    // kernel2
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp_l, &device_param->kernel_preferred_wgs_multiple_mp_l) == -1) return -1;
+    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      device_param->kernel_dynamic_local_mem_size_mp_l = 0;
+      device_param->skipped_warning = true;
 
-      // mp_r: r_markov
+      return -2; //continue;
+    }
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "r_markov", &device_param->metal_function_mp_r, &device_param->metal_pipeline_mp_r) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
+    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
 
-        device_param->skipped_warning = true;
+    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
 
-        return -2; //continue;
-      }
+    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
+    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
+    // kernel3
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp_r, &device_param->kernel_preferred_wgs_multiple_mp_r) == -1) return -1;
+    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
 
-      device_param->kernel_dynamic_local_mem_size_mp_r = 0;
-    }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
     {
-      // mp_c: C_markov
+      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "C_markov", &device_param->metal_function_mp, &device_param->metal_pipeline_mp) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+      device_param->skipped_warning = true;
 
-        device_param->skipped_warning = true;
+      return -2; //continue;
+    }
 
-        return -2; //continue;
-      }
+    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
+    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_mp = 0;
-    }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+    // aux1
+
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
     {
-      // mp_c: C_markov
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_mp, "C_markov", &device_param->metal_function_mp, &device_param->metal_pipeline_mp) == -1)
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2p) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_wgs2p) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_dynamic_local_mem_size2p) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_mp = 0;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_preferred_wgs_multiple2p) == -1) return -1;
     }
-  }
 
-  if (user_options->slow_candidates == true)
-  {
-  }
-  else
-  {
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
     {
-      // amp
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
 
-      if (hc_mtlCreateKernel (hashcat_ctx, device_param->metal_device, device_param->metal_library_amp, "amp", &device_param->metal_function_amp, &device_param->metal_pipeline_amp) == -1)
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2e) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_metal_kernel_wgs (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_wgs_amp) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_wgs2e) == -1) return -1;
 
-      if (get_metal_kernel_local_mem_size (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
 
-      if (get_metal_kernel_preferred_wgs_multiple (hashcat_ctx, device_param->metal_pipeline_amp, &device_param->kernel_preferred_wgs_multiple_amp) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_dynamic_local_mem_size2e) == -1) return -1;
 
-      device_param->kernel_dynamic_local_mem_size_amp = 0;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_preferred_wgs_multiple2e) == -1) return -1;
     }
-  }
-
-  return 0;
-}
-#endif // __APPLE__
-
-static int backend_session_setup_opencl_kernel_types (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, int kern_type)
-{
-  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  const user_options_t *user_options = hashcat_ctx->user_options;
 
-  // GPU autotune init
-
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 0, sizeof (cl_mem),   device_param->kernel_params_atinit[0]) == -1) return -1;
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_atinit, 1, sizeof (cl_ulong), device_param->kernel_params_atinit[1]) == -1) return -1;
-
-  // GPU utf8 to utf16le init
+    // kernel12
 
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_utf8toutf16le, 0, sizeof (cl_mem),   device_param->kernel_params_utf8toutf16le[0]) == -1) return -1;
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_utf8toutf16le, 1, sizeof (cl_ulong), device_param->kernel_params_utf8toutf16le[1]) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
 
-  // GPU decompress
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel12) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem),   device_param->kernel_params_decompress[0]) == -1) return -1;
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem),   device_param->kernel_params_decompress[1]) == -1) return -1;
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem),   device_param->kernel_params_decompress[2]) == -1) return -1;
-  if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 3, sizeof (cl_ulong), device_param->kernel_params_decompress[3]) == -1) return -1;
+        device_param->skipped_warning = true;
 
-  char kernel_name[64] = { 0 };
+        return -2; //continue;
+      }
 
-  if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-  {
-    if (hashconfig->opti_type & OPTI_TYPE_SINGLE_HASH)
-    {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
-      {
-        // kernel1
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_wgs12) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 4);
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_local_mem_size12) == -1) return -1;
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_dynamic_local_mem_size12) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_preferred_wgs_multiple12) == -1) return -1;
+    }
 
-          return -2; //continue;
-        }
+    // kernel23
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel23) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+        return -2; //continue;
+      }
 
-        // kernel2
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_wgs23) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 8);
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_local_mem_size23) == -1) return -1;
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_dynamic_local_mem_size23) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_preferred_wgs_multiple23) == -1) return -1;
+    }
 
-          return -2; //continue;
-        }
+    // init2
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_init2) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+        return -2; //continue;
+      }
 
-        // kernel3
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_wgs_init2) == -1) return -1;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_s%02d", kern_type, 16);
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_dynamic_local_mem_size_init2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_preferred_wgs_multiple_init2) == -1) return -1;
+    }
 
-          return -2; //continue;
-        }
+    // loop2 prepare
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_loop2p) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+        device_param->skipped_warning = true;
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+        return -2; //continue;
       }
-      else
-      {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_sxx", kern_type);
-
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel4) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_dynamic_local_mem_size_loop2p) == -1) return -1;
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_preferred_wgs_multiple_loop2p) == -1) return -1;
+    }
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
+    // loop2
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
-      }
-    }
-    else
+    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
     {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_loop2) == -1)
       {
-        // kernel1
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 4);
+        device_param->skipped_warning = true;
+
+        return -2; //continue;
+      }
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_dynamic_local_mem_size_loop2) == -1) return -1;
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_preferred_wgs_multiple_loop2) == -1) return -1;
+    }
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
+    // aux1
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux1) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        // kernel2
+        device_param->skipped_warning = true;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 8);
+        return -2; //continue;
+      }
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_dynamic_local_mem_size_aux1) == -1) return -1;
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_preferred_wgs_multiple_aux1) == -1) return -1;
+    }
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
+    // aux2
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux2) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-        // kernel3
+        device_param->skipped_warning = true;
 
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_m%02d", kern_type, 16);
+        return -2; //continue;
+      }
 
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
 
-          device_param->skipped_warning = true;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
 
-          return -2; //continue;
-        }
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_dynamic_local_mem_size_aux2) == -1) return -1;
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_preferred_wgs_multiple_aux2) == -1) return -1;
+    }
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
+    // aux3
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
+    {
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
-      }
-      else
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux3) == -1)
       {
-        snprintf (kernel_name, sizeof (kernel_name), "m%05u_mxx", kern_type);
-
-        if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel4) == -1)
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-          device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-          return -2; //continue;
-        }
+        return -2; //continue;
+      }
 
-        if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_wgs4) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
 
-        if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_local_mem_size4) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
 
-        if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_dynamic_local_mem_size4) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_dynamic_local_mem_size_aux3) == -1) return -1;
 
-        if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel4, &device_param->kernel_preferred_wgs_multiple4) == -1) return -1;
-      }
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_preferred_wgs_multiple_aux3) == -1) return -1;
     }
 
-    if (user_options->slow_candidates == true)
-    {
-    }
-    else
+    // aux4
+
+    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
     {
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
-        {
-          snprintf (kernel_name, sizeof (kernel_name), "m%05u_tm", kern_type);
+      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
 
-          if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_tm) == -1)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux4) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
 
-            device_param->skipped_warning = true;
+        device_param->skipped_warning = true;
 
-            return -2; //continue;
-          }
+        return -2; //continue;
+      }
 
-          if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_wgs_tm) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
 
-          if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_local_mem_size_tm) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
 
-          if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_dynamic_local_mem_size_tm) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_dynamic_local_mem_size_aux4) == -1) return -1;
 
-          if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_tm, &device_param->kernel_preferred_wgs_multiple_tm) == -1) return -1;
-        }
-      }
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_preferred_wgs_multiple_aux4) == -1) return -1;
     }
   }
-  else
-  {
-    // kernel1
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_init", kern_type);
+  // MP start
 
-    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel1) == -1)
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (user_options->attack_mode == ATTACK_MODE_BF)
     {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-      device_param->skipped_warning = true;
-
-      return -2; //continue;
-    }
-
-    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_wgs1) == -1) return -1;
-
-    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_local_mem_size1) == -1) return -1;
+      // mp_l
 
-    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_dynamic_local_mem_size1) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "l_markov", &device_param->opencl_kernel_mp_l) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
 
-    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel1, &device_param->kernel_preferred_wgs_multiple1) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    // kernel2
+        return -2; //continue;
+      }
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop", kern_type);
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
 
-    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
 
-      device_param->skipped_warning = true;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_dynamic_local_mem_size_mp_l) == -1) return -1;
 
-      return -2; //continue;
-    }
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_preferred_wgs_multiple_mp_l) == -1) return -1;
 
-    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_wgs2) == -1) return -1;
+      // mp_r
 
-    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_local_mem_size2) == -1) return -1;
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "r_markov", &device_param->opencl_kernel_mp_r) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
 
-    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_dynamic_local_mem_size2) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2, &device_param->kernel_preferred_wgs_multiple2) == -1) return -1;
+        return -2; //continue;
+      }
 
-    // kernel3
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
 
-    snprintf (kernel_name, sizeof (kernel_name), "m%05u_comp", kern_type);
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
 
-    if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel3) == -1)
-    {
-      event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_dynamic_local_mem_size_mp_r) == -1) return -1;
 
-      device_param->skipped_warning = true;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_preferred_wgs_multiple_mp_r) == -1) return -1;
 
-      return -2; //continue;
+      if (user_options->attack_mode == ATTACK_MODE_BF)
+      {
+        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        {
+          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]) == -1) return -1;
+          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]) == -1) return -1;
+        }
+      }
     }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+    {
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "C_markov", &device_param->opencl_kernel_mp) == -1)
+      {
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
-    if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_wgs3) == -1) return -1;
+        device_param->skipped_warning = true;
 
-    if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_local_mem_size3) == -1) return -1;
+        return -2; //continue;
+      }
 
-    if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_dynamic_local_mem_size3) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-    if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel3, &device_param->kernel_preferred_wgs_multiple3) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-    // aux1
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_PREPARE)
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
+    }
+    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_prepare", kern_type);
-
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2p) == -1)
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "C_markov", &device_param->opencl_kernel_mp) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_wgs2p) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_wgs_mp) == -1) return -1;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_local_mem_size2p) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_dynamic_local_mem_size2p) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2p, &device_param->kernel_preferred_wgs_multiple2p) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
     }
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP_EXTENDED)
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop_extended", kern_type);
-
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel2e) == -1)
+      // nothing to do
+    }
+    else
+    {
+      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_amp, "amp", &device_param->opencl_kernel_amp) == -1)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
 
         device_param->skipped_warning = true;
 
         return -2; //continue;
       }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_wgs2e) == -1) return -1;
+      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_wgs_amp) == -1) return -1;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_local_mem_size2e) == -1) return -1;
+      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_dynamic_local_mem_size2e) == -1) return -1;
+      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_dynamic_local_mem_size_amp) == -1) return -1;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel2e, &device_param->kernel_preferred_wgs_multiple2e) == -1) return -1;
+      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_preferred_wgs_multiple_amp) == -1) return -1;
     }
 
-    // kernel12
-
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook12", kern_type);
-
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel12) == -1)
+      // nothing to do
+    }
+    else
+    {
+      for (u32 i = 0; i < 5; i++)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]) == -1) return -1;
+      }
 
-        device_param->skipped_warning = true;
+      for (u32 i = 5; i < 6; i++)
+      {
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]) == -1) return -1;
+      }
 
-        return -2; //continue;
+      for (u32 i = 6; i < 7; i++)
+      {
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]) == -1) return -1;
       }
+    }
+  }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_wgs12) == -1) return -1;
+  return 0;
+}
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_local_mem_size12) == -1) return -1;
+void backend_session_context_reset (hashcat_ctx_t *hashcat_ctx)
+{
+  // workaround for context bug (CUDA)
+  // unclear if needded for other runtimes too
+  // can be reproduced by setting src/benchmark.c to only: 17200, 15700, -1 and then -b
+  // reason is that the spilling buffer is not free'd by the runtime after use and we have no control over this buffer
+  // dropping the context seem to release it
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_dynamic_local_mem_size12) == -1) return -1;
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel12, &device_param->kernel_preferred_wgs_multiple12) == -1) return -1;
-    }
+  if (backend_ctx->enabled == false) return;
 
-    // kernel23
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-    if (hashconfig->opts_type & OPTS_TYPE_HOOK23)
+    if (device_param->skipped == true) continue;
+
+    if (device_param->is_cuda == true)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_hook23", kern_type);
+      hc_cuCtxDestroy (hashcat_ctx, device_param->cuda_context);
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel23) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+      hc_cuCtxCreate (hashcat_ctx, &device_param->cuda_context, CU_CTX_SCHED_BLOCKING_SYNC, device_param->cuda_device);
+    }
+  }
+}
 
-        device_param->skipped_warning = true;
+/**
+ * pws_comp, pws_idx and their _next twins are staged in one page-locked region where the runtime
+ * offers one, so the asynchronous copies in run_copy () can DMA straight from it.
+ * The combs_buf of the combinator and hybrid attacks shares that region.
+ * Failing to get pinned memory is not fatal, we fall back to pageable buffers.
+ */
 
-        return -2; //continue;
-      }
+static void pws_pinned_carve (hc_device_param_t *device_param, u8 *buf)
+{
+  const u64 size_pws_comp = round_up_multiple_64 (device_param->size_pws_comp, 64);
+  const u64 size_pws_idx  = round_up_multiple_64 (device_param->size_pws_idx,  64);
+
+  device_param->pws_comp      = (u32 *)      (buf);
+  device_param->pws_idx       = (pw_idx_t *) (buf + size_pws_comp);
+  device_param->pws_comp_next = (u32 *)      (buf + size_pws_comp + size_pws_idx);
+  device_param->pws_idx_next  = (pw_idx_t *) (buf + size_pws_comp + size_pws_idx + size_pws_comp);
+  device_param->combs_buf     = (pw_t *)     (buf + size_pws_comp + size_pws_idx + size_pws_comp + size_pws_idx);
+}
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_wgs23) == -1) return -1;
+static void pws_host_alloc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_local_mem_size23) == -1) return -1;
+  const u64 size_pinned = 2 * (round_up_multiple_64 (device_param->size_pws_comp, 64) + round_up_multiple_64 (device_param->size_pws_idx, 64)) + (KERNEL_COMBS * sizeof (pw_t));
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_dynamic_local_mem_size23) == -1) return -1;
+  void *buf = NULL;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel23, &device_param->kernel_preferred_wgs_multiple23) == -1) return -1;
-    }
+  if (device_param->is_cuda == true)
+  {
+    CUDA_PTR *cuda = (CUDA_PTR *) backend_ctx->cuda;
 
-    // init2
+    if (cuda->cuMemAllocHost (&buf, size_pinned) != CUDA_SUCCESS) buf = NULL;
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_INIT2)
+  if (device_param->is_opencl == true)
+  {
+    OCL_PTR *ocl = (OCL_PTR *) backend_ctx->ocl;
+
+    cl_int CL_err;
+
+    cl_mem opencl_h_pws_pinned = ocl->clCreateBuffer (device_param->opencl_context, CL_MEM_READ_ONLY | CL_MEM_ALLOC_HOST_PTR, size_pinned, NULL, &CL_err);
+
+    if (CL_err == CL_SUCCESS)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_init2", kern_type);
+      buf = ocl->clEnqueueMapBuffer (device_param->opencl_command_queue, opencl_h_pws_pinned, CL_TRUE, CL_MAP_WRITE, 0, size_pinned, 0, NULL, NULL, &CL_err);
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_init2) == -1)
+      if (CL_err == CL_SUCCESS)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
+        device_param->opencl_h_pws_pinned = opencl_h_pws_pinned;
+      }
+      else
+      {
+        buf = NULL;
 
-        return -2; //continue;
+        ocl->clReleaseMemObject (opencl_h_pws_pinned);
       }
+    }
+  }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_wgs_init2) == -1) return -1;
+  // no pinned allocator is loaded for HIP, and Metal buffers are shared with the host anyway
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_local_mem_size_init2) == -1) return -1;
+  if (buf != NULL)
+  {
+    memset (buf, 0, size_pinned);
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_dynamic_local_mem_size_init2) == -1) return -1;
+    device_param->pws_pinned_buf = buf;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_init2, &device_param->kernel_preferred_wgs_multiple_init2) == -1) return -1;
-    }
+    pws_pinned_carve (device_param, (u8 *) buf);
 
-    // loop2 prepare
+    return;
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2_PREPARE)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2_prepare", kern_type);
+  device_param->pws_comp      = (u32 *)      hcmalloc (device_param->size_pws_comp);
+  device_param->pws_idx       = (pw_idx_t *) hcmalloc (device_param->size_pws_idx);
+  device_param->pws_comp_next = (u32 *)      hcmalloc (device_param->size_pws_comp);
+  device_param->pws_idx_next  = (pw_idx_t *) hcmalloc (device_param->size_pws_idx);
+  device_param->combs_buf     = (pw_t *)     hccalloc (KERNEL_COMBS, sizeof (pw_t));
+}
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_loop2p) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+static void pws_host_free (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  if (device_param->pws_pinned_buf == NULL)
+  {
+    hcfree (device_param->pws_comp);
+    hcfree (device_param->pws_idx);
+    hcfree (device_param->pws_comp_next);
+    hcfree (device_param->pws_idx_next);
+    hcfree (device_param->combs_buf);
 
-        device_param->skipped_warning = true;
+    return;
+  }
 
-        return -2; //continue;
-      }
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuCtxPushCurrent (hashcat_ctx, device_param->cuda_context) == 0)
+    {
+      hc_cuMemFreeHost (hashcat_ctx, device_param->pws_pinned_buf);
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_wgs_loop2p) == -1) return -1;
+      hc_cuCtxPopCurrent (hashcat_ctx, &device_param->cuda_context);
+    }
+  }
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_local_mem_size_loop2p) == -1) return -1;
+  if (device_param->is_opencl == true)
+  {
+    hc_clEnqueueUnmapMemObject (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_h_pws_pinned, device_param->pws_pinned_buf, 0, NULL, NULL);
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_dynamic_local_mem_size_loop2p) == -1) return -1;
+    hc_clFinish (hashcat_ctx, device_param->opencl_command_queue);
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_loop2p, &device_param->kernel_preferred_wgs_multiple_loop2p) == -1) return -1;
-    }
+    hc_clReleaseMemObject (hashcat_ctx, device_param->opencl_h_pws_pinned);
 
-    // loop2
+    device_param->opencl_h_pws_pinned = NULL;
+  }
 
-    if (hashconfig->opts_type & OPTS_TYPE_LOOP2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_loop2", kern_type);
+  device_param->pws_pinned_buf = NULL;
+}
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_loop2) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+/**
+ * per-device part of backend_session_begin (), runs on its own thread for each active device
+ * returns -1 on fatal errors, devices which can not be used are skipped and counted in session_device
+ */
 
-        device_param->skipped_warning = true;
+static int backend_session_begin_device (backend_session_device_t *session_device)
+{
+  hashcat_ctx_t *hashcat_ctx = session_device->hashcat_ctx;
 
-        return -2; //continue;
-      }
+  const bitmap_ctx_t         *bitmap_ctx          = hashcat_ctx->bitmap_ctx;
+  const bridge_ctx_t         *bridge_ctx          = hashcat_ctx->bridge_ctx;
+  const folder_config_t      *folder_config       = hashcat_ctx->folder_config;
+  const hashconfig_t         *hashconfig          = hashcat_ctx->hashconfig;
+  const hashes_t             *hashes              = hashcat_ctx->hashes;
+  const module_ctx_t         *module_ctx          = hashcat_ctx->module_ctx;
+        backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
+  const straight_ctx_t       *straight_ctx        = hashcat_ctx->straight_ctx;
+  const user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
+  const user_options_t       *user_options        = hashcat_ctx->user_options;
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_wgs_loop2) == -1) return -1;
+  int backend_devices_idx = session_device->backend_devices_idx;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_local_mem_size_loop2) == -1) return -1;
+  hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_dynamic_local_mem_size_loop2) == -1) return -1;
+  const int device_id = device_param->device_id;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_loop2, &device_param->kernel_preferred_wgs_multiple_loop2) == -1) return -1;
-    }
+  // vector_width
 
-    // aux1
+  int vector_width = 0;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX1)
+  if (user_options->backend_vector_width_chgd == false)
+  {
+    // tuning db
+
+    tuning_db_entry_t *tuningdb_entry;
+
+    if (user_options->slow_candidates == true)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux1", kern_type);
+      tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, 0, hashconfig->hash_mode);
+    }
+    else
+    {
+      tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
+    }
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux1) == -1)
+    if (tuningdb_entry == NULL || tuningdb_entry->vector_width == -1)
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_USES_BITS_64)
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (device_param->is_cuda == true)
+        {
+          // cuda does not support this query
 
-        device_param->skipped_warning = true;
+          vector_width = 1;
+        }
 
-        return -2; //continue;
-      }
+        if (device_param->is_hip == true)
+        {
+          // hip does not support this query
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_wgs_aux1) == -1) return -1;
+          vector_width = 1;
+        }
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_local_mem_size_aux1) == -1) return -1;
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          // Metal does not support this query
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_dynamic_local_mem_size_aux1) == -1) return -1;
+          vector_width = 1;
+        }
+        #endif
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux1, &device_param->kernel_preferred_wgs_multiple_aux1) == -1) return -1;
-    }
+        if (device_param->is_opencl == true)
+        {
+          // For CPU we can ask the runtime
+          // For GPUs we want to be more selective and we will use the tuning db
 
-    // aux2
+          vector_width = 1;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX2)
-    {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux2", kern_type);
+          if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+          {
+            if (hc_clGetDeviceInfo (hashcat_ctx, device_param->opencl_device, CL_DEVICE_NATIVE_VECTOR_WIDTH_LONG, sizeof (vector_width), &vector_width, NULL) == -1)
+            {
+              device_param->skipped = true;
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux2) == -1)
+              return 0;
+            }
+          }
+        }
+      }
+      else
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+        if (device_param->is_cuda == true)
+        {
+          // cuda does not support this query
 
-        device_param->skipped_warning = true;
+          vector_width = 1;
+        }
 
-        return -2; //continue;
-      }
+        if (device_param->is_hip == true)
+        {
+          // hip does not support this query
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_wgs_aux2) == -1) return -1;
+          vector_width = 1;
+        }
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_local_mem_size_aux2) == -1) return -1;
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          // Metal does not support this query
+
+          vector_width = 1;
+        }
+        #endif
+
+        if (device_param->is_opencl == true)
+        {
+          // For CPU we can ask the runtime
+          // For GPUs we want to be more selective and we will use the tuning db
+
+          vector_width = 1;
+
+          if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+          {
+            if (hc_clGetDeviceInfo (hashcat_ctx, device_param->opencl_device, CL_DEVICE_NATIVE_VECTOR_WIDTH_INT,  sizeof (vector_width), &vector_width, NULL) == -1)
+            {
+              device_param->skipped = true;
+
+              return 0;
+            }
+          }
+        }
+      }
+    }
+    else
+    {
+      vector_width = (cl_uint) tuningdb_entry->vector_width;
+    }
+  }
+  else
+  {
+    vector_width = user_options->backend_vector_width;
+  }
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_dynamic_local_mem_size_aux2) == -1) return -1;
+  // Metal supports vectors up to 4
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux2, &device_param->kernel_preferred_wgs_multiple_aux2) == -1) return -1;
-    }
+  if (device_param->is_metal == true && vector_width > 4)
+  {
+    vector_width = 4;
+  }
 
-    // aux3
+  // We can't have SIMD in kernels where we have an unknown final password length
+  // It also turns out that pure kernels (that have a higher register pressure)
+  // actually run faster on scalar GPU (like 1080) without SIMD
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX3)
+  if ((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0)
+  {
+    if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux3", kern_type);
+      vector_width = 1;
+    }
+  }
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux3) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+  {
+    // not working in this mode because the GID does not align with password candidate count
+    // and if it cracks, it will crack the same hash twice, running into segfaults
 
-        device_param->skipped_warning = true;
+    vector_width = 1;
+  }
 
-        return -2; //continue;
-      }
+  if (vector_width > 16) vector_width = 16;
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_wgs_aux3) == -1) return -1;
+  device_param->vector_width = vector_width;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_local_mem_size_aux3) == -1) return -1;
+  /**
+   * kernel accel and loops tuning db adjustment
+   */
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_dynamic_local_mem_size_aux3) == -1) return -1;
+  device_param->kernel_accel_min   = hashconfig->kernel_accel_min;
+  device_param->kernel_accel_max   = hashconfig->kernel_accel_max;
+  device_param->kernel_loops_min   = hashconfig->kernel_loops_min;
+  device_param->kernel_loops_max   = hashconfig->kernel_loops_max;
+  device_param->kernel_threads_min = hashconfig->kernel_threads_min;
+  device_param->kernel_threads_max = hashconfig->kernel_threads_max;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux3, &device_param->kernel_preferred_wgs_multiple_aux3) == -1) return -1;
-    }
+  tuning_db_entry_t *tuningdb_entry = NULL;
 
-    // aux4
+  for (int i = 0; i < 2; i++)
+  {
+    char *search_name = NULL;
 
-    if (hashconfig->opts_type & OPTS_TYPE_AUX4)
+    if (i == 0)
     {
-      snprintf (kernel_name, sizeof (kernel_name), "m%05u_aux4", kern_type);
-
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program, kernel_name, &device_param->opencl_kernel_aux4) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, kernel_name);
-
-        device_param->skipped_warning = true;
-
-        return -2; //continue;
-      }
-
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_wgs_aux4) == -1) return -1;
+      hc_asprintf (&search_name, "MODULE_%02d_%s", device_param->device_id, device_param->device_name);
+    }
+    else
+    {
+      search_name = device_param->device_name;
+    }
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_local_mem_size_aux4) == -1) return -1;
+    if (user_options->slow_candidates == true)
+    {
+      tuningdb_entry = tuning_db_search (hashcat_ctx, search_name, device_param->opencl_device_type, 0, hashconfig->hash_mode);
+    }
+    else
+    {
+      tuningdb_entry = tuning_db_search (hashcat_ctx, search_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
+    }
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_dynamic_local_mem_size_aux4) == -1) return -1;
+    if (i == 0) hcfree (search_name);
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_aux4, &device_param->kernel_preferred_wgs_multiple_aux4) == -1) return -1;
-    }
+    if (tuningdb_entry != NULL) break;
   }
 
-  // MP start
+  // user commandline option override tuning db
+  // but both have to stay inside the boundaries of the module
 
-  if (user_options->slow_candidates == true)
+  if (user_options->kernel_accel_chgd == true)
   {
+    const u32 _kernel_accel = user_options->kernel_accel;
+
+    if ((_kernel_accel >= device_param->kernel_accel_min) && (_kernel_accel <= device_param->kernel_accel_max))
+    {
+      device_param->kernel_accel_min = _kernel_accel;
+      device_param->kernel_accel_max = _kernel_accel;
+    }
   }
   else
   {
-    if (user_options->attack_mode == ATTACK_MODE_BF)
+    if (tuningdb_entry != NULL)
     {
-      // mp_l
+      const u32 _kernel_accel = tuningdb_entry->kernel_accel;
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "l_markov", &device_param->opencl_kernel_mp_l) == -1)
+      if (_kernel_accel == (u32) -1) // native, makes sense if OPTS_TYPE_MP_MULTI_DISABLE is used
       {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "l_markov");
-
-        device_param->skipped_warning = true;
-
-        return -2; //continue;
-      }
-
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_wgs_mp_l) == -1) return -1;
-
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_local_mem_size_mp_l) == -1) return -1;
-
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_dynamic_local_mem_size_mp_l) == -1) return -1;
-
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp_l, &device_param->kernel_preferred_wgs_multiple_mp_l) == -1) return -1;
+        if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
+        {
+          hc_thread_mutex_lock (backend_ctx->mux_session_warning);
 
-      // mp_r
+          if ((module_ctx->module_extra_tuningdb_block != MODULE_DEFAULT) && (backend_ctx->manual_tuning_warning == false))
+          {
+            backend_ctx->manual_tuning_warning = true;
 
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "r_markov", &device_param->opencl_kernel_mp_r) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "r_markov");
+            event_log_warning (hashcat_ctx, "ATTENTION! This hash-mode requires manual tuning to achieve full performance.");
+            event_log_warning (hashcat_ctx, "The loss of performance can be greater than 100%% without manual tuning.");
+            event_log_warning (hashcat_ctx, NULL);
+            event_log_warning (hashcat_ctx, "This warning message disappears after a definition for the installed");
+            event_log_warning (hashcat_ctx, "compute-device in this computer has been added to either list:");
+            event_log_warning (hashcat_ctx, "- src/modules/module_%05d.c", hashconfig->hash_mode);
+            event_log_warning (hashcat_ctx, "- hashcat.hctune");
+            event_log_warning (hashcat_ctx, NULL);
+            event_log_warning (hashcat_ctx, "For instructions on tuning, see src/modules/module_%05d.c", hashconfig->hash_mode);
+            event_log_warning (hashcat_ctx, "Also, consider sending a PR to Hashcat Master so that other users can benefit from your work.");
+            event_log_warning (hashcat_ctx, NULL);
+          }
 
-        device_param->skipped_warning = true;
+          hc_thread_mutex_unlock (backend_ctx->mux_session_warning);
+        }
 
-        return -2; //continue;
+        device_param->kernel_accel_min = device_param->device_processors;
+        device_param->kernel_accel_max = device_param->device_processors;
       }
-
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_wgs_mp_r) == -1) return -1;
-
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_local_mem_size_mp_r) == -1) return -1;
-
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_dynamic_local_mem_size_mp_r) == -1) return -1;
-
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp_r, &device_param->kernel_preferred_wgs_multiple_mp_r) == -1) return -1;
-
-      if (user_options->attack_mode == ATTACK_MODE_BF)
+      else
       {
-        if (hashconfig->opts_type & OPTS_TYPE_TM_KERNEL)
+        if (_kernel_accel)
         {
-          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 0, sizeof (cl_mem), device_param->kernel_params_tm[0]) == -1) return -1;
-          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_tm, 1, sizeof (cl_mem), device_param->kernel_params_tm[1]) == -1) return -1;
+          if ((_kernel_accel >= device_param->kernel_accel_min) && (_kernel_accel <= device_param->kernel_accel_max))
+          {
+            device_param->kernel_accel_min = _kernel_accel;
+            device_param->kernel_accel_max = _kernel_accel;
+          }
         }
       }
     }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+
+    if (hashconfig->bridge_type & BRIDGE_TYPE_MATCH_TUNINGS)
     {
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "C_markov", &device_param->opencl_kernel_mp) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+      u32 workitem_count = bridge_ctx->get_workitem_count (bridge_ctx->platform_context, device_param->bridge_link_device);
 
-        device_param->skipped_warning = true;
+           if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_001) workitem_count = 1;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_002) workitem_count = 2;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_004) workitem_count = 4;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_008) workitem_count = 8;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_016) workitem_count = 16;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_032) workitem_count = 32;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_064) workitem_count = 64;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_128) workitem_count = 128;
+      else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_256) workitem_count = 256;
 
-        return -2; //continue;
+      u32 native_threads = 0;
+
+      if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+      {
+        native_threads = 1;
+      }
+      else if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
+      {
+        native_threads = device_param->kernel_preferred_wgs_multiple;
       }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_wgs_mp) == -1) return -1;
+      const u32 _kernel_accel = ((workitem_count + native_threads - 1) / native_threads) * native_threads;
 
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+      device_param->kernel_accel_min = _kernel_accel;
+      device_param->kernel_accel_max = _kernel_accel;
+    }
+  }
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
+  if (user_options->kernel_loops_chgd == true)
+  {
+    const u32 _kernel_loops = user_options->kernel_loops;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
+    if ((_kernel_loops >= device_param->kernel_loops_min) && (_kernel_loops <= device_param->kernel_loops_max))
+    {
+      device_param->kernel_loops_min = _kernel_loops;
+      device_param->kernel_loops_max = _kernel_loops;
     }
-    else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+  }
+  else
+  {
+    if (tuningdb_entry != NULL)
     {
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_mp, "C_markov", &device_param->opencl_kernel_mp) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "C_markov");
+      u32 _kernel_loops = tuningdb_entry->kernel_loops;
 
-        device_param->skipped_warning = true;
+      if (_kernel_loops)
+      {
+        if (user_options->workload_profile == 1)
+        {
+          _kernel_loops = (_kernel_loops > 8) ? _kernel_loops / 8 : 1;
+        }
+        else if (user_options->workload_profile == 2)
+        {
+          _kernel_loops = (_kernel_loops > 4) ? _kernel_loops / 4 : 1;
+        }
 
-        return -2; //continue;
+        if ((_kernel_loops >= device_param->kernel_loops_min) && (_kernel_loops <= device_param->kernel_loops_max))
+        {
+          device_param->kernel_loops_min = _kernel_loops;
+          device_param->kernel_loops_max = _kernel_loops;
+        }
       }
+    }
+  }
 
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_wgs_mp) == -1) return -1;
-
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_local_mem_size_mp) == -1) return -1;
+  // there's no thread column in tuning db, stick to commandline if defined
 
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_dynamic_local_mem_size_mp) == -1) return -1;
+  if (user_options->kernel_threads_chgd == true)
+  {
+    const u32 _kernel_threads = user_options->kernel_threads;
 
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_mp, &device_param->kernel_preferred_wgs_multiple_mp) == -1) return -1;
+    if ((_kernel_threads >= device_param->kernel_threads_min) && (_kernel_threads <= device_param->kernel_threads_max))
+    {
+      device_param->kernel_threads_min = _kernel_threads;
+      device_param->kernel_threads_max = _kernel_threads;
     }
   }
 
@@ -13322,2076 +14471,2129 @@ static int backend_session_setup_opencl_kernel_types (hashcat_ctx_t *hashcat_ctx
   }
   else
   {
-    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-    {
-      // nothing to do
-    }
-    else
-    {
-      if (hc_clCreateKernel (hashcat_ctx, device_param->opencl_program_amp, "amp", &device_param->opencl_kernel_amp) == -1)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: Kernel %s create failed.", device_param->device_id + 1, "amp");
-
-        device_param->skipped_warning = true;
-
-        return -2; //continue;
-      }
-
-      if (get_opencl_kernel_wgs (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_wgs_amp) == -1) return -1;
-
-      if (get_opencl_kernel_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_local_mem_size_amp) == -1) return -1;
-
-      if (get_opencl_kernel_dynamic_local_mem_size (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_dynamic_local_mem_size_amp) == -1) return -1;
-
-      if (get_opencl_kernel_preferred_wgs_multiple (hashcat_ctx, device_param, device_param->opencl_kernel_amp, &device_param->kernel_preferred_wgs_multiple_amp) == -1) return -1;
-    }
+    // we have some absolute limits for fast hashes (because of limit constant memory), make sure not to overstep
 
     if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      // nothing to do
-    }
-    else
-    {
-      for (u32 i = 0; i < 5; i++)
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
       {
-        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_mem), device_param->kernel_params_amp[i]) == -1) return -1;
+        device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_RULES);
+        device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_RULES);
       }
-
-      for (u32 i = 5; i < 6; i++)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
-        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_uint), device_param->kernel_params_amp[i]) == -1) return -1;
+        device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_COMBS);
+        device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_COMBS);
       }
-
-      for (u32 i = 6; i < 7; i++)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, i, sizeof (cl_ulong), device_param->kernel_params_amp[i]) == -1) return -1;
+        device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_BFS);
+        device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_BFS);
       }
     }
   }
 
-  return 0;
-}
+  device_param->kernel_loops_min_sav = device_param->kernel_loops_min;
+  device_param->kernel_loops_max_sav = device_param->kernel_loops_max;
 
-void backend_session_context_reset (hashcat_ctx_t *hashcat_ctx)
-{
-  // workaround for context bug (CUDA)
-  // unclear if needded for other runtimes too
-  // can be reproduced by setting src/benchmark.c to only: 17200, 15700, -1 and then -b
-  // reason is that the spilling buffer is not free'd by the runtime after use and we have no control over this buffer
-  // dropping the context seem to release it
+  /**
+   * device properties
+   */
 
-  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+  //const u32 device_processors = device_param->device_processors;
 
-  if (backend_ctx->enabled == false) return;
+  /**
+   * device threads
+   */
 
-  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  if (hashconfig->opts_type & OPTS_TYPE_MAXIMUM_THREADS)
   {
-    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
-
-    if (device_param->skipped == true) continue;
+    // default for all, because the else branch is doing the same (nothing), but is actually used as a way to
+    // disable the default native thread configuration for HIP
+    // this can have negative performance if not tested on multiple different gpu architectures
+  }
+  else if (hashconfig->opts_type & OPTS_TYPE_NATIVE_THREADS)
+  {
+    u32 native_threads = 0;
 
-    if (device_param->is_cuda == true)
+    if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
     {
-      hc_cuCtxDestroy (hashcat_ctx, device_param->cuda_context);
-
-      hc_cuCtxCreate (hashcat_ctx, &device_param->cuda_context, CU_CTX_SCHED_BLOCKING_SYNC, device_param->cuda_device);
+      native_threads = 1;
+    }
+    else if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
+    {
+      native_threads = device_param->kernel_preferred_wgs_multiple;
+    }
+    else
+    {
+      // abort?
     }
-  }
-}
-
-int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
-{
-  const bitmap_ctx_t         *bitmap_ctx          = hashcat_ctx->bitmap_ctx;
-  const bridge_ctx_t         *bridge_ctx          = hashcat_ctx->bridge_ctx;
-  const folder_config_t      *folder_config       = hashcat_ctx->folder_config;
-  const hashconfig_t         *hashconfig          = hashcat_ctx->hashconfig;
-  const hashes_t             *hashes              = hashcat_ctx->hashes;
-  const module_ctx_t         *module_ctx          = hashcat_ctx->module_ctx;
-        backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
-  const straight_ctx_t       *straight_ctx        = hashcat_ctx->straight_ctx;
-  const user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
-  const user_options_t       *user_options        = hashcat_ctx->user_options;
 
-  if (backend_ctx->enabled == false) return 0;
+    if ((native_threads >= device_param->kernel_threads_min) && (native_threads <= device_param->kernel_threads_max))
+    {
+      device_param->kernel_threads_min = native_threads;
+      device_param->kernel_threads_max = native_threads;
+    }
+    else
+    {
+      // abort?
+    }
+  }
+  else
+  {
+    // v7 test, needs some larger test, but I think we will need to stick to this
 
-  u64 size_total_host_all = 0;
+    if (device_param->is_cuda == true)
+    {
+      // we will find this after loading the kernel with suppport of runtime api
+    }
+    else if (device_param->is_hip == true)
+    {
+      // we will find this after loading the kernel with suppport of runtime api
+    }
+    else if (device_param->is_opencl == true)
+    {
+      // we will find this after loading the kernel with suppport of runtime api
+    }
+    else if (device_param->is_metal == true)
+    {
+      // we will find this after loading the kernel with suppport of runtime api
+    }
+  }
 
-  u32 hardware_power_all = 0;
+  // this seems to work always
 
-  int backend_memory_hit_warnings    = 0;
-  int backend_runtime_skip_warnings  = 0;
-  int backend_kernel_build_warnings  = 0;
-  int backend_kernel_create_warnings = 0;
-  int backend_kernel_accel_warnings  = 0;
-  int backend_extra_size_warning     = 0;
+  if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+  {
+    u32 native_threads = 1;
 
-  backend_ctx->memory_hit_warning    = false;
-  backend_ctx->runtime_skip_warning  = false;
-  backend_ctx->kernel_build_warning  = false;
-  backend_ctx->kernel_create_warning = false;
-  backend_ctx->kernel_accel_warnings = false;
-  backend_ctx->extra_size_warning    = false;
-  backend_ctx->mixed_warnings        = false;
+    if ((native_threads >= device_param->kernel_threads_min) && (native_threads <= device_param->kernel_threads_max))
+    {
+      device_param->kernel_threads_min = native_threads;
+      device_param->kernel_threads_max = native_threads;
+    }
+  }
 
-  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
   {
-    /**
-     * host buffer
-     */
-
-    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+    // set some limits with Metal
 
-    if (device_param->skipped == true) continue;
+    device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
+    device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, device_param->kernel_threads_max);
 
-    EVENT_DATA (EVENT_BACKEND_DEVICE_INIT_PRE, &backend_devices_idx, sizeof (int));
+    device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, 1024);  // autotune go over ...
+    device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, device_param->kernel_loops_max);
 
-    const int device_id = device_param->device_id;
+    device_param->overtune_unfriendly = true;
+  }
+  #endif
 
-    /**
-     * Query used memory from the device using low-level API and update device_available_mem
-     * If there's no low-level API available we will silently ignore
-     */
+  // re-using context/command-queue, there is no need to re-initialize them
 
-    const u64 used_bytes = hm_get_memoryused_with_devices_idx (hashcat_ctx, device_id);
+  /**
+   * create stream for CUDA devices
+   */
 
-    if (used_bytes)
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuCtxPushCurrent (hashcat_ctx, device_param->cuda_context) == -1)
     {
-      device_param->device_available_mem = MIN (device_param->device_available_mem, device_param->device_global_mem - used_bytes);
-    }
-
-    /**
-     * module depending checks
-     */
+      device_param->skipped = true;
 
-    device_param->skipped_warning = false;
+      return 0;
+    }
 
-    if (module_ctx->module_unstable_warning != MODULE_DEFAULT)
+    if (hc_cuStreamCreate (hashcat_ctx, &device_param->cuda_stream, CU_STREAM_DEFAULT) == -1)
     {
-      const bool unstable_warning = module_ctx->module_unstable_warning (hashconfig, user_options, user_options_extra, device_param);
+      device_param->skipped = true;
 
-      if ((unstable_warning == true) && (user_options->force == false))
-      {
-        char runtime_name[7];
+      return 0;
+    }
+  }
 
-        memset (runtime_name, 0, sizeof (runtime_name));
+  /**
+   * create stream for HIP devices
+   */
 
-        if (device_param->is_cuda   == true) memcpy (runtime_name, "CUDA", 4);
-        if (device_param->is_hip    == true) memcpy (runtime_name, "HIP", 3);
-        #if defined (__APPLE__)
-        if (device_param->is_metal  == true) memcpy (runtime_name, "Metal", 5);
-        #endif
-        if (device_param->is_opencl == true) memcpy (runtime_name, "OpenCL", 6);
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipSetDevice (hashcat_ctx, device_param->hip_device) == -1)
+    {
+      device_param->skipped = true;
 
-        event_log_warning (hashcat_ctx, "* Device #%u: Skipping (hash-mode %u)", device_id + 1, hashconfig->hash_mode);
-        event_log_warning (hashcat_ctx, "             This is due to a known %s runtime and/or device driver issue (not a hashcat issue)", runtime_name);
-        event_log_warning (hashcat_ctx, "             You can use --force to override, but do not report related errors.");
-        event_log_warning (hashcat_ctx, NULL);
+      return 0;
+    }
 
-        backend_runtime_skip_warnings++;
+    if (hc_hipStreamCreateWithFlags (hashcat_ctx, &device_param->hip_stream, hipStreamDefault) == -1)
+    {
+      device_param->skipped = true;
 
-        device_param->skipped_warning = true;
-        continue;
-      }
+      return 0;
     }
+  }
 
-    /**
-     * tuning db
-     */
+  /**
+   * create events for CUDA devices
+   */
 
-    if (module_ctx->module_extra_tuningdb_block != MODULE_DEFAULT)
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event1, CU_EVENT_BLOCKING_SYNC) == -1)
     {
-      // We need this because we can't trust CUDA/HIP to give us the real free device memory
-      // The only way to do so is through low level APIs
+      device_param->skipped = true;
 
-      const u64 used_bytes = hm_get_memoryused_with_devices_idx (hashcat_ctx, device_id);
+      return 0;
+    }
 
-      if (used_bytes)
-      {
-        const u64 new_left = device_param->device_global_mem - used_bytes;
+    if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event2, CU_EVENT_BLOCKING_SYNC) == -1)
+    {
+      device_param->skipped = true;
 
-        if (used_bytes > (device_param->device_global_mem * 0.15))
-        {
-          event_log_warning (hashcat_ctx, "* Device #%u: High memory usage by desktop or other apps detected: %" PRIu64 "/%" PRIu64, device_id + 1, used_bytes, device_param->device_global_mem);
-          event_log_warning (hashcat_ctx, "             Performance is capped at %.2f%%", ((double) new_left / device_param->device_global_mem) * 100);
-        }
+      return 0;
+    }
 
-        device_param->device_available_mem = MIN (device_param->device_available_mem, new_left);
-      }
-      else
-      {
-        if (user_options->hwmon == false)
-        {
-          if (user_options->machine_readable == false)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: The hardware monitor was disabled, but it is the only reliable method to query actual free memory.", device_id + 1);
-            event_log_warning (hashcat_ctx, "             Falling back to --backend-devices-keepfree method.");
-            event_log_warning (hashcat_ctx, NULL);
-          }
-        }
+    if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event3, CU_EVENT_DISABLE_TIMING) == -1)
+    {
+      device_param->skipped = true;
 
-        if (user_options->backend_devices_keepfree == 0)
-        {
-          const u64 device_available_mem_sav = device_param->device_available_mem;
+      return 0;
+    }
+  }
 
-          const u64 device_available_mem_new = device_available_mem_sav - (device_available_mem_sav * 0.34);
+  /**
+   * create events for HIP devices
+   */
 
-          if (user_options->machine_readable == false)
-          {
-            event_log_warning (hashcat_ctx, "* Device #%u: This system does not offer any reliable method to query actual free memory. Estimated base: %" PRIu64, device_id + 1, device_available_mem_sav);
-            event_log_warning (hashcat_ctx, "             Assuming normal desktop activity, reducing estimate by 34%%: %" PRIu64, device_available_mem_new);
-            event_log_warning (hashcat_ctx, "             This can hurt performance drastically, especially on memory-heavy algorithms.");
-            event_log_warning (hashcat_ctx, "             You can adjust this percentage using --backend-devices-keepfree");
-            event_log_warning (hashcat_ctx, NULL);
-          }
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event1, hipEventBlockingSync) == -1)
+    {
+      device_param->skipped = true;
 
-          device_param->device_available_mem = device_available_mem_new;
-        }
-      }
+      return 0;
+    }
 
-      u32 _kernel_accel = 0;
+    if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event2, hipEventBlockingSync) == -1)
+    {
+      device_param->skipped = true;
 
-      if (user_options->kernel_accel_chgd == true)
-      {
-        _kernel_accel = user_options->kernel_accel;
-      }
-      else
-      {
-        tuning_db_entry_t *tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
+      return 0;
+    }
 
-        if (tuningdb_entry != NULL) _kernel_accel = tuningdb_entry->kernel_accel;
-      }
+    if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event3, hipEventDisableTiming) == -1)
+    {
+      device_param->skipped = true;
 
-      const char *extra_tuningdb_block = module_ctx->module_extra_tuningdb_block (hashconfig, user_options, user_options_extra, backend_ctx, hashes, device_id, _kernel_accel);
+      return 0;
+    }
+  }
 
-      char *lines_buf = hcstrdup (extra_tuningdb_block);
+  /**
+   * create input buffers on device : calculate size of fixed memory buffers
+   */
 
-      char *saveptr = NULL;
+  u64 size_root_css   = SP_PW_MAX *           sizeof (cs_t);
+  u64 size_markov_css = SP_PW_MAX * CHARSIZ * sizeof (cs_t);
 
-      char *next = strtok_r (lines_buf, "\n", &saveptr);
+  device_param->size_root_css   = size_root_css;
+  device_param->size_markov_css = size_markov_css;
 
-      int line_num = 0;
+  u64 size_results = sizeof (u32);
 
-      do
-      {
-        line_num++;
+  device_param->size_results = size_results;
 
-        const size_t line_len = strlen (next);
+  u32 aligned_rules_cnt = MAX (MAX (straight_ctx->kernel_rules_cnt, device_param->kernel_loops_min), KERNEL_RULES);
 
-        if (line_len == 0) continue;
+  u64 size_rules     = (u64) aligned_rules_cnt * sizeof (kernel_rule_t);
+  u64 size_rules_src = (u64) straight_ctx->kernel_rules_cnt * sizeof (kernel_rule_t);  // size of source rules buffer can be less than aligned_rules_cnt
+  u64 size_rules_c   = (u64) KERNEL_RULES      * sizeof (kernel_rule_t);
 
-        if (next[0] == '#') continue;
+  device_param->size_rules    = size_rules;
+  device_param->size_rules_c  = size_rules_c;
 
-        char *search_name = NULL;
+  u64 size_plains  = (u64) hashes->digests_cnt * sizeof (plain_t);
+  u64 size_salts   = (u64) hashes->salts_cnt   * sizeof (salt_t);
+  u64 size_esalts  = (u64) hashes->digests_cnt * hashconfig->esalt_size;
+  u64 size_shown   = (u64) hashes->digests_cnt * sizeof (u32);
+  u64 size_digests = (u64) hashes->digests_cnt * (u64) hashconfig->dgst_size;
 
-        hc_asprintf (&search_name, "MODULE_%02d_%s", device_param->device_id, next);
+  device_param->size_plains   = size_plains;
+  device_param->size_digests  = size_digests;
+  device_param->size_shown    = size_shown;
+  device_param->size_salts    = size_salts;
+  device_param->size_esalts   = size_esalts;
 
-        tuning_db_process_line (hashcat_ctx, search_name, line_num);
+  u64 size_combs          = KERNEL_COMBS * sizeof (pw_t);
+  u64 size_bfs            = KERNEL_BFS   * sizeof (bf_t);
+  u64 size_tm             = 32           * sizeof (bs_word_t);
+  u64 size_kernel_params  = 1            * sizeof (kernel_param_t);
 
-        hcfree (search_name);
+  device_param->size_bfs           = size_bfs;
+  device_param->size_combs         = size_combs;
+  device_param->size_tm            = size_tm;
+  device_param->size_kernel_params = size_kernel_params;
 
-      } while ((next = strtok_r ((char *) NULL, "\n", &saveptr)) != NULL);
+  u64 size_st_digests = 1 * hashconfig->dgst_size;
+  u64 size_st_salts   = 1 * sizeof (salt_t);
+  u64 size_st_esalts  = 1 * hashconfig->esalt_size;
 
-      hcfree (lines_buf);
+  device_param->size_st_digests = size_st_digests;
+  device_param->size_st_salts   = size_st_salts;
+  device_param->size_st_esalts  = size_st_esalts;
 
-      // todo: print loaded 'cnt' message
+  // extra buffer
 
-      // sort the database
+  u64 size_extra_buffer1 = 4096;
+  u64 size_extra_buffer2 = 4096;
+  u64 size_extra_buffer3 = 4096;
+  u64 size_extra_buffer4 = 4096;
 
-      tuning_db_t *tuning_db = hashcat_ctx->tuning_db;
+  if (module_ctx->module_extra_buffer_size != MODULE_DEFAULT)
+  {
+    const u64 extra_buffer_size = module_ctx->module_extra_buffer_size (hashconfig, user_options, user_options_extra, hashes, device_param);
 
-      qsort (tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
-      qsort (tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
-    }
+    if (extra_buffer_size == (u64) -1)
+    {
+      event_log_error (hashcat_ctx, "Invalid extra buffer size.");
 
-    // vector_width
+      session_device->extra_size_warning++;
 
-    int vector_width = 0;
+      device_param->skipped_warning = true;
+      return 0;
+    }
 
-    if (user_options->backend_vector_width_chgd == false)
-    {
-      // tuning db
+    device_param->extra_buffer_size = extra_buffer_size;
 
-      tuning_db_entry_t *tuningdb_entry;
+    /**
+     * We use a "4-buffer" strategy for certain hash types (like scrypt)
+     * that require large scratch buffers per work-item.
+     *
+     * The kernel assigns each work-item to one of 4 sub-buffers using:
+     *   buffer index = workitem_id % 4
+     *
+     * This means that each of the 4 sub-buffers must be large enough to hold
+     * all work-items that map to it. However, the total number of work-items
+     * is not always a multiple of 4. If we naively split the total buffer size
+     * evenly into 4 parts, the last chunk may be too small and cause buffer
+     * overflows for configurations where work-items spill into a partially sized chunk.
+     *
+     * Previous versions worked around this by over-allocating a full extra buffer,
+     * but this wasted gpu memory for large hashes like scrypt with high N.
+     *
+     * This improved logic computes the exact number of work-items assigned to
+     * each of the 4 chunks and sizes each chunk precisely:
+     *
+     * - The first 'leftover' chunks get one extra work-item to cover any remainder.
+     * - This guarantees each chunk is large enough for its assigned work-items.
+     */
 
-      if (user_options->slow_candidates == true)
-      {
-        tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, 0, hashconfig->hash_mode);
-      }
-      else
-      {
-        tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
-      }
+    const u64 kernel_power_max = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE) ? 1 : device_param->device_processors) * device_param->kernel_accel_max;
 
-      if (tuningdb_entry == NULL || tuningdb_entry->vector_width == -1)
-      {
-        if (hashconfig->opti_type & OPTI_TYPE_USES_BITS_64)
-        {
-          if (device_param->is_cuda == true)
-          {
-            // cuda does not support this query
+    const u64 extra_buffer_size_threads = extra_buffer_size / kernel_power_max;
 
-            vector_width = 1;
-          }
+    const u64 workitems_per_chunk = kernel_power_max / 4;
 
-          if (device_param->is_hip == true)
-          {
-            // hip does not support this query
+    const u64 base_chunk_size = workitems_per_chunk * extra_buffer_size_threads;
 
-            vector_width = 1;
-          }
+    size_extra_buffer1 += base_chunk_size;
+    size_extra_buffer2 += base_chunk_size;
+    size_extra_buffer3 += base_chunk_size;
+    size_extra_buffer4 += base_chunk_size;
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            // Metal does not support this query
+    const u64 leftover = kernel_power_max % 4;
 
-            vector_width = 1;
-          }
-          #endif
+    switch (leftover)
+    {
+      case 3: size_extra_buffer3 += extra_buffer_size_threads; // fall-through
+      case 2: size_extra_buffer2 += extra_buffer_size_threads; // fall-through
+      case 1: size_extra_buffer1 += extra_buffer_size_threads; // fall-through
+      case 0: break;
+    }
+  }
 
-          if (device_param->is_opencl == true)
-          {
-            // For CPU we can ask the runtime
-            // For GPUs we want to be more selective and we will use the tuning db
+  // kern type
 
-            vector_width = 1;
+  u32 kern_type = hashconfig->kern_type;
 
-            if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
-            {
-              if (hc_clGetDeviceInfo (hashcat_ctx, device_param->opencl_device, CL_DEVICE_NATIVE_VECTOR_WIDTH_LONG, sizeof (vector_width), &vector_width, NULL) == -1)
-              {
-                device_param->skipped = true;
+  if (module_ctx->module_kern_type_dynamic != MODULE_DEFAULT)
+  {
+    if (user_options->benchmark == true)
+    {
+    }
+    else
+    {
+      void        *digests_buf    = hashes->digests_buf;
+      salt_t      *salts_buf      = hashes->salts_buf;
+      void        *esalts_buf     = hashes->esalts_buf;
+      void        *hook_salts_buf = hashes->hook_salts_buf;
+      hashinfo_t **hash_info      = hashes->hash_info;
 
-                continue;
-              }
-            }
-          }
-        }
-        else
-        {
-          if (device_param->is_cuda == true)
-          {
-            // cuda does not support this query
+      hashinfo_t *hash_info_ptr = NULL;
 
-            vector_width = 1;
-          }
+      if (hash_info) hash_info_ptr = hash_info[0];
 
-          if (device_param->is_hip == true)
-          {
-            // hip does not support this query
+      kern_type = (u32) module_ctx->module_kern_type_dynamic (hashconfig, digests_buf, salts_buf, esalts_buf, hook_salts_buf, hash_info_ptr);
+    }
+  }
 
-            vector_width = 1;
-          }
+  if ((int) kern_type == -1)
+  {
+    event_log_error (hashcat_ctx, "Invalid hash-mode selected: -1");
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            // Metal does not support this query
+    return -1;
+  }
 
-            vector_width = 1;
-          }
-          #endif
+  // built options
 
-          if (device_param->is_opencl == true)
-          {
-            // For CPU we can ask the runtime
-            // For GPUs we want to be more selective and we will use the tuning db
+  const size_t build_options_sz = 4096;
 
-            vector_width = 1;
+  char *build_options_buf = (char *) hcmalloc (build_options_sz);
 
-            if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
-            {
-              if (hc_clGetDeviceInfo (hashcat_ctx, device_param->opencl_device, CL_DEVICE_NATIVE_VECTOR_WIDTH_INT,  sizeof (vector_width), &vector_width, NULL) == -1)
-              {
-                device_param->skipped = true;
+  int build_options_len = snprintf(build_options_buf, build_options_sz, "-D KERNEL_STATIC ");
 
-                continue;
-              }
-            }
-          }
-        }
-      }
-      else
-      {
-        vector_width = (cl_uint) tuningdb_entry->vector_width;
-      }
-    }
-    else
+  #if defined (DEBUG) && (DEBUG >= 1)
+  // only HIP and OpenCL have '-g'
+  if (device_param->is_hip == true || device_param->is_opencl == true)
+  {
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-g ");
+  }
+  #endif
+
+  if ((device_param->is_cuda == true) || (device_param->is_hip == true))
+  {
+    // using a path with a space will break nvrtc_make_options_array_from_string()
+    // we add it to options array in a clean way later
+  }
+  else
+  {
+    #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
+    // workaround for AMD
+    if (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD && device_param->opencl_device_vendor_id == VENDOR_ID_AMD)
     {
-      vector_width = user_options->backend_vector_width;
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-I . ");
     }
 
-    // Metal supports vectors up to 4
+    // when built with cygwin or msys, cpath_real doesn't work
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D INCLUDE_PATH=%s ", "OpenCL");
+    #else
+    const char *build_options_include_fmt = (strchr (folder_config->cpath_real, ' ') != NULL) ? "-D INCLUDE_PATH=\"%s\" " : "-D INCLUDE_PATH=%s ";
+
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, build_options_include_fmt, folder_config->cpath_real);
+    #endif
+
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D XM2S(x)=#x ");
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D M2S(x)=XM2S(x) ");
+    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D MAX_THREADS_PER_BLOCK=%d ", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
 
-    if (device_param->is_metal == true && vector_width > 4)
+    #if defined (__APPLE__)
+    if (is_apple_silicon () == true)
     {
-      vector_width = 4;
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D IS_APPLE_SILICON ");
     }
+    #endif
+  }
 
-    // We can't have SIMD in kernels where we have an unknown final password length
-    // It also turns out that pure kernels (that have a higher register pressure)
-    // actually run faster on scalar GPU (like 1080) without SIMD
+  /* currently disabled, hangs NEO drivers since 20.09.
+     was required for NEO driver 20.08 to workaround the same issue!
+     we go with the latest version
+     v7 re-enabled
+    */
 
-    if ((hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) == 0)
+  if (device_param->is_opencl == true)
+  {
+    if (device_param->use_opencl11 == true)
     {
-      if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
-      {
-        vector_width = 1;
-      }
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL1.1 ");
     }
-
-    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+    else if (device_param->use_opencl12 == true)
+    {
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL1.2 ");
+    }
+    else if (device_param->use_opencl20 == true)
+    {
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL2.0 ");
+    }
+    else if (device_param->use_opencl30 == true)
     {
-      // not working in this mode because the GID does not align with password candidate count
-      // and if it cracks, it will crack the same hash twice, running into segfaults
+      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL3.0 ");
+    }
+  }
 
-      vector_width = 1;
+  // we don't have sm_* on vendors not NV but it doesn't matter
+
+  #if defined (DEBUG)
+  build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D LOCAL_MEM_TYPE=%d -D VENDOR_ID=%u -D CUDA_ARCH=%u -D HAS_ADD=%u -D HAS_ADDC=%u -D HAS_SUB=%u -D HAS_SUBC=%u -D HAS_VADD=%u -D HAS_VADDC=%u -D HAS_VADD_CO=%u -D HAS_VADDC_CO=%u -D HAS_VSUB=%u -D HAS_VSUBB=%u -D HAS_VSUB_CO=%u -D HAS_VSUBB_CO=%u -D HAS_VPERM=%u -D HAS_VADD3=%u -D HAS_VBFE=%u -D HAS_BFE=%u -D HAS_LOP3=%u -D HAS_MOV64=%u -D HAS_PRMT=%u -D HAS_SHFW=%u -D VECT_SIZE=%d -D DEVICE_TYPE=%u -D DGST_R0=%u -D DGST_R1=%u -D DGST_R2=%u -D DGST_R3=%u -D DGST_ELEM=%u -D KERN_TYPE=%u -D ATTACK_EXEC=%u -D ATTACK_KERN=%u -D ATTACK_MODE=%u ", device_param->device_local_mem_type, device_param->opencl_platform_vendor_id, (device_param->sm_major * 100) + (device_param->sm_minor * 10), device_param->has_add, device_param->has_addc, device_param->has_sub, device_param->has_subc, device_param->has_vadd, device_param->has_vaddc, device_param->has_vadd_co, device_param->has_vaddc_co, device_param->has_vsub, device_param->has_vsubb, device_param->has_vsub_co, device_param->has_vsubb_co, device_param->has_vperm, device_param->has_vadd3, device_param->has_vbfe, device_param->has_bfe, device_param->has_lop3, device_param->has_mov64, device_param->has_prmt, device_param->has_shfw, device_param->vector_width, (u32) device_param->opencl_device_type, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, hashconfig->dgst_size / 4, kern_type, hashconfig->attack_exec, user_options_extra->attack_kern, user_options->attack_mode);
+  #else
+  build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D LOCAL_MEM_TYPE=%d -D VENDOR_ID=%u -D CUDA_ARCH=%u -D HAS_ADD=%u -D HAS_ADDC=%u -D HAS_SUB=%u -D HAS_SUBC=%u -D HAS_VADD=%u -D HAS_VADDC=%u -D HAS_VADD_CO=%u -D HAS_VADDC_CO=%u -D HAS_VSUB=%u -D HAS_VSUBB=%u -D HAS_VSUB_CO=%u -D HAS_VSUBB_CO=%u -D HAS_VPERM=%u -D HAS_VADD3=%u -D HAS_VBFE=%u -D HAS_BFE=%u -D HAS_LOP3=%u -D HAS_MOV64=%u -D HAS_PRMT=%u -D HAS_SHFW=%u -D VECT_SIZE=%d -D DEVICE_TYPE=%u -D DGST_R0=%u -D DGST_R1=%u -D DGST_R2=%u -D DGST_R3=%u -D DGST_ELEM=%u -D KERN_TYPE=%u -D ATTACK_EXEC=%u -D ATTACK_KERN=%u -D ATTACK_MODE=%u -w ", device_param->device_local_mem_type, device_param->opencl_platform_vendor_id, (device_param->sm_major * 100) + (device_param->sm_minor * 10), device_param->has_add, device_param->has_addc, device_param->has_sub, device_param->has_subc, device_param->has_vadd, device_param->has_vaddc, device_param->has_vadd_co, device_param->has_vaddc_co, device_param->has_vsub, device_param->has_vsubb, device_param->has_vsub_co, device_param->has_vsubb_co, device_param->has_vperm, device_param->has_vadd3, device_param->has_vbfe, device_param->has_bfe, device_param->has_lop3, device_param->has_mov64, device_param->has_prmt, device_param->has_shfw, device_param->vector_width, (u32) device_param->opencl_device_type, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, hashconfig->dgst_size / 4, kern_type, hashconfig->attack_exec, user_options_extra->attack_kern, user_options->attack_mode);
+  #endif
+
+  build_options_buf[build_options_len] = 0;
+
+  /*
+  if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+  {
+    if (device_param->opencl_platform_vendor_id == VENDOR_ID_INTEL_SDK)
+    {
+      strncat (build_options_buf, " -cl-opt-disable", 16);
     }
+  }
+  */
+
+  #if defined (DEBUG)
+  if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: build_options '%s'", device_id + 1, build_options_buf);
+  #endif
 
-    if (vector_width > 16) vector_width = 16;
+  /**
+   * device_name_chksum_amp_mp
+   * the shared, amp and mp kernels are compiled with build_options_buf, so their cache key hashes it as well
+   */
 
-    device_param->vector_width = vector_width;
+  char device_name_chksum_amp_mp[HCBUFSIZ_TINY] = { 0 };
+
+  snprintf (device_name_chksum_amp_mp, HCBUFSIZ_TINY, "%d-%d-%d-%u-%u-%u-%s-%d-%u-%s-%s-%s-%u-%u",
+    backend_ctx->comptime,
+    backend_ctx->cuda_driver_version,
+    backend_ctx->hip_runtimeVersion,
+    backend_ctx->metal_runtimeVersion,
+    device_param->sm_major,
+    device_param->sm_minor,
+    (device_param->is_hip == true) ? device_param->gcnArchName : "",
+    device_param->is_opencl,
+    device_param->opencl_platform_vendor_id,
+    device_param->device_name,
+    device_param->opencl_device_version,
+    device_param->opencl_driver_version,
+    (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max,
+    get_current_arch());
 
-    /**
-     * kernel accel and loops tuning db adjustment
-     */
+  /**
+   * kernel cache
+   */
 
-    device_param->kernel_accel_min   = hashconfig->kernel_accel_min;
-    device_param->kernel_accel_max   = hashconfig->kernel_accel_max;
-    device_param->kernel_loops_min   = hashconfig->kernel_loops_min;
-    device_param->kernel_loops_max   = hashconfig->kernel_loops_max;
-    device_param->kernel_threads_min = hashconfig->kernel_threads_min;
-    device_param->kernel_threads_max = hashconfig->kernel_threads_max;
+  bool cache_disable = false;
 
-    tuning_db_entry_t *tuningdb_entry = NULL;
+  // Seems to be completely broken on Apple + (Intel?) CPU
+  // To reproduce set cache_disable to false and run benchmark -b
 
-    for (int i = 0; i < 2; i++)
+  if (device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE)
+  {
+    if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
     {
-      char *search_name = NULL;
+      cache_disable = true;
+    }
+  }
 
-      if (i == 0)
-      {
-        hc_asprintf (&search_name, "MODULE_%02d_%s", device_param->device_id, device_param->device_name);
-      }
-      else
-      {
-        search_name = device_param->device_name;
-      }
+  if (module_ctx->module_jit_cache_disable != MODULE_DEFAULT)
+  {
+    cache_disable = module_ctx->module_jit_cache_disable (hashconfig, user_options, user_options_extra, hashes, device_param);
+  }
 
-      if (user_options->slow_candidates == true)
-      {
-        tuningdb_entry = tuning_db_search (hashcat_ctx, search_name, device_param->opencl_device_type, 0, hashconfig->hash_mode);
-      }
-      else
-      {
-        tuningdb_entry = tuning_db_search (hashcat_ctx, search_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
-      }
+  #if defined (DEBUG)
+  // https://github.com/hashcat/hashcat/issues/2750
+  cache_disable = true;
+  #endif
 
-      if (i == 0) hcfree (search_name);
+  /**
+   * shared kernel with no hashconfig dependencies
+   */
 
-      if (tuningdb_entry != NULL) break;
-    }
+  {
+    /**
+     * kernel shared source filename
+     */
 
-    // user commandline option override tuning db
-    // but both have to stay inside the boundaries of the module
+    char source_file[256] = { 0 };
 
-    if (user_options->kernel_accel_chgd == true)
-    {
-      const u32 _kernel_accel = user_options->kernel_accel;
+    generate_source_kernel_shared_filename (folder_config->shared_dir, source_file);
 
-      if ((_kernel_accel >= device_param->kernel_accel_min) && (_kernel_accel <= device_param->kernel_accel_max))
-      {
-        device_param->kernel_accel_min = _kernel_accel;
-        device_param->kernel_accel_max = _kernel_accel;
-      }
-    }
-    else
+    if (hc_path_read (source_file) == false)
     {
-      if (tuningdb_entry != NULL)
-      {
-        const u32 _kernel_accel = tuningdb_entry->kernel_accel;
-
-        if (_kernel_accel == (u32) -1) // native, makes sense if OPTS_TYPE_MP_MULTI_DISABLE is used
-        {
-          if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
-          {
-            if (module_ctx->module_extra_tuningdb_block != MODULE_DEFAULT)
-            {
-              event_log_warning (hashcat_ctx, "ATTENTION! This hash-mode requires manual tuning to achieve full performance.");
-              event_log_warning (hashcat_ctx, "The loss of performance can be greater than 100%% without manual tuning.");
-              event_log_warning (hashcat_ctx, NULL);
-              event_log_warning (hashcat_ctx, "This warning message disappears after a definition for the installed");
-              event_log_warning (hashcat_ctx, "compute-device in this computer has been added to either list:");
-              event_log_warning (hashcat_ctx, "- src/modules/module_%05d.c", hashconfig->hash_mode);
-              event_log_warning (hashcat_ctx, "- hashcat.hctune");
-              event_log_warning (hashcat_ctx, NULL);
-              event_log_warning (hashcat_ctx, "For instructions on tuning, see src/modules/module_%05d.c", hashconfig->hash_mode);
-              event_log_warning (hashcat_ctx, "Also, consider sending a PR to Hashcat Master so that other users can benefit from your work.");
-              event_log_warning (hashcat_ctx, NULL);
-            }
-          }
+      event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
 
-          device_param->kernel_accel_min = device_param->device_processors;
-          device_param->kernel_accel_max = device_param->device_processors;
-        }
-        else
-        {
-          if (_kernel_accel)
-          {
-            if ((_kernel_accel >= device_param->kernel_accel_min) && (_kernel_accel <= device_param->kernel_accel_max))
-            {
-              device_param->kernel_accel_min = _kernel_accel;
-              device_param->kernel_accel_max = _kernel_accel;
-            }
-          }
-        }
-      }
+      return -1;
+    }
 
-      if (hashconfig->bridge_type & BRIDGE_TYPE_MATCH_TUNINGS)
-      {
-        u32 workitem_count = bridge_ctx->get_workitem_count (bridge_ctx->platform_context, device_param->bridge_link_device);
+    /**
+     * kernel shared cached filename
+     */
 
-             if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_001) workitem_count = 1;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_002) workitem_count = 2;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_004) workitem_count = 4;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_008) workitem_count = 8;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_016) workitem_count = 16;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_032) workitem_count = 32;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_064) workitem_count = 64;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_128) workitem_count = 128;
-        else if (hashconfig->bridge_type & BRIDGE_TYPE_FORCE_WORKITEMS_256) workitem_count = 256;
+    char cached_file[256] = { 0 };
 
-        u32 native_threads = 0;
+    char kernel_key[32] = { 0 };
 
-        if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
-        {
-          native_threads = 1;
-        }
-        else if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
-        {
-          native_threads = device_param->kernel_preferred_wgs_multiple;
-        }
+    if (kernel_cache_key (hashcat_ctx, device_name_chksum_amp_mp, build_options_buf, source_file, kernel_key) == false) return -1;
 
-        const u32 _kernel_accel = ((workitem_count + native_threads - 1) / native_threads) * native_threads;
+    generate_cached_kernel_shared_filename (folder_config->kernels_dir, kernel_key, cached_file, device_param->is_metal);
 
-        device_param->kernel_accel_min = _kernel_accel;
-        device_param->kernel_accel_max = _kernel_accel;
-      }
-    }
+    #if defined (__APPLE__)
+    const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared, &device_param->hip_module_shared, &device_param->metal_library_shared);
+    #else
+    const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared, &device_param->hip_module_shared, NULL);
+    #endif
 
-    if (user_options->kernel_loops_chgd == true)
+    if (rc_load_kernel == false)
     {
-      const u32 _kernel_loops = user_options->kernel_loops;
+      event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-      if ((_kernel_loops >= device_param->kernel_loops_min) && (_kernel_loops <= device_param->kernel_loops_max))
-      {
-        device_param->kernel_loops_min = _kernel_loops;
-        device_param->kernel_loops_max = _kernel_loops;
-      }
+      return -1;
     }
-    else
-    {
-      if (tuningdb_entry != NULL)
-      {
-        u32 _kernel_loops = tuningdb_entry->kernel_loops;
 
-        if (_kernel_loops)
-        {
-          if (user_options->workload_profile == 1)
-          {
-            _kernel_loops = (_kernel_loops > 8) ? _kernel_loops / 8 : 1;
-          }
-          else if (user_options->workload_profile == 2)
-          {
-            _kernel_loops = (_kernel_loops > 4) ? _kernel_loops / 4 : 1;
-          }
+    int rc = -1;
 
-          if ((_kernel_loops >= device_param->kernel_loops_min) && (_kernel_loops <= device_param->kernel_loops_max))
-          {
-            device_param->kernel_loops_min = _kernel_loops;
-            device_param->kernel_loops_max = _kernel_loops;
-          }
-        }
-      }
+    if (device_param->is_cuda == true)
+    {
+      rc = backend_session_setup_cuda_kernel_shared (hashcat_ctx, device_param);
     }
 
-    // there's no thread column in tuning db, stick to commandline if defined
-
-    if (user_options->kernel_threads_chgd == true)
+    if (device_param->is_hip == true)
     {
-      const u32 _kernel_threads = user_options->kernel_threads;
+      rc = backend_session_setup_hip_kernel_shared (hashcat_ctx, device_param);
+    }
 
-      if ((_kernel_threads >= device_param->kernel_threads_min) && (_kernel_threads <= device_param->kernel_threads_max))
-      {
-        device_param->kernel_threads_min = _kernel_threads;
-        device_param->kernel_threads_max = _kernel_threads;
-      }
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      rc = backend_session_setup_metal_kernel_shared (hashcat_ctx, device_param);
     }
+    #endif
 
-    if (user_options->slow_candidates == true)
+    if (device_param->is_opencl == true)
     {
+      rc = backend_session_setup_opencl_kernel_shared (hashcat_ctx, device_param);
     }
-    else
+
+    if (rc == -2)
     {
-      // we have some absolute limits for fast hashes (because of limit constant memory), make sure not to overstep
+      session_device->kernel_create_warnings++;
 
-      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-      {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_RULES);
-          device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_RULES);
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_COMBS);
-          device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_COMBS);
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, KERNEL_BFS);
-          device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, KERNEL_BFS);
-        }
-      }
+      return 0;
     }
 
-    device_param->kernel_loops_min_sav = device_param->kernel_loops_min;
-    device_param->kernel_loops_max_sav = device_param->kernel_loops_max;
+    if (rc == -1) return -1;
 
-    /**
-     * device properties
-     */
+  }
 
-    //const u32 device_processors = device_param->device_processors;
+  /**
+   * main kernel
+   */
 
-    /**
-     * device threads
-     */
+  {
+    char *build_options_module_buf = (char *) hcmalloc (build_options_sz);
+
+    int build_options_module_len = 0;
+
+    build_options_module_len += snprintf (build_options_module_buf + build_options_module_len, build_options_sz - build_options_module_len, "%s ", build_options_buf);
 
-    if (hashconfig->opts_type & OPTS_TYPE_MAXIMUM_THREADS)
+    if (salt_batch_supported (hashcat_ctx) == true)
     {
-      // default for all, because the else branch is doing the same (nothing), but is actually used as a way to
-      // disable the default native thread configuration for HIP
-      // this can have negative performance if not tested on multiple different gpu architectures
+      build_options_module_len += snprintf (build_options_module_buf + build_options_module_len, build_options_sz - build_options_module_len, "-D SALT_BATCH ");
+
+      device_param->salt_batch = true;
     }
-    else if (hashconfig->opts_type & OPTS_TYPE_NATIVE_THREADS)
+
+    if (module_ctx->module_jit_build_options != MODULE_DEFAULT)
     {
-      u32 native_threads = 0;
+      char *jit_build_options = module_ctx->module_jit_build_options (hashconfig, user_options, user_options_extra, hashes, device_param);
 
-      if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
-      {
-        native_threads = 1;
-      }
-      else if (device_param->opencl_device_type & CL_DEVICE_TYPE_GPU)
-      {
-        native_threads = device_param->kernel_preferred_wgs_multiple;
-      }
-      else
+      if (jit_build_options != NULL)
       {
-        // abort?
-      }
+        build_options_module_len += snprintf (build_options_module_buf + build_options_module_len, build_options_sz - build_options_module_len, "%s", jit_build_options);
 
-      if ((native_threads >= device_param->kernel_threads_min) && (native_threads <= device_param->kernel_threads_max))
-      {
-        device_param->kernel_threads_min = native_threads;
-        device_param->kernel_threads_max = native_threads;
-      }
-      else
-      {
-        // abort?
-      }
-    }
-    else
-    {
-      // v7 test, needs some larger test, but I think we will need to stick to this
+        // this is a bit ugly
+        // would be better to have the module return the value as value
 
-      if (device_param->is_cuda == true)
-      {
-        // we will find this after loading the kernel with suppport of runtime api
-      }
-      else if (device_param->is_hip == true)
-      {
-        // we will find this after loading the kernel with suppport of runtime api
-      }
-      else if (device_param->is_opencl == true)
-      {
-        // we will find this after loading the kernel with suppport of runtime api
-      }
-      else if (device_param->is_metal == true)
-      {
-        // we will find this after loading the kernel with suppport of runtime api
-      }
-    }
+        u32 fixed_local_size = 0;
 
-    // this seems to work always
+        if (sscanf (jit_build_options, "-D FIXED_LOCAL_SIZE=%u", &fixed_local_size) == 1)
+        {
+          device_param->kernel_threads_min = fixed_local_size;
+          device_param->kernel_threads_max = fixed_local_size;
+        }
+        else if (sscanf (jit_build_options, "-D FORCED_THREAD_COUNT=%u", &fixed_local_size) == 1)
+        {
+          // FORCED_THREAD_COUNT is the same as FIXED_LOCAL_SIZE, but has no impact on the kernel jit
 
-    if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
-    {
-      u32 native_threads = 1;
+          device_param->kernel_threads_min = fixed_local_size;
+          device_param->kernel_threads_max = fixed_local_size;
+        }
+        else
+        {
+          // kernels specific minimum needs to be set so that self-test wont fail
 
-      if ((native_threads >= device_param->kernel_threads_min) && (native_threads <= device_param->kernel_threads_max))
-      {
-        device_param->kernel_threads_min = native_threads;
-        device_param->kernel_threads_max = native_threads;
+          if (sscanf (jit_build_options, "-D FIXED_LOCAL_SIZE_COMP=%u", &fixed_local_size) == 1)
+          {
+            device_param->kernel_threads_min = fixed_local_size;
+            // device_param->kernel_threads_max = fixed_local_size;
+
+            device_param->overtune_unfriendly = true;
+          }
+        }
       }
     }
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      // set some limits with Metal
+    build_options_module_buf[build_options_module_len] = 0;
+
+    #if defined (DEBUG)
+    if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: build_options_module '%s'", device_id + 1, build_options_module_buf);
+    #endif
+
+    /**
+     * device_name_chksum
+     */
 
-      device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
-      device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, device_param->kernel_threads_max);
+    char device_name_chksum[HCBUFSIZ_TINY] = { 0 };
 
-      device_param->kernel_loops_max = MIN (device_param->kernel_loops_max, 1024);  // autotune go over ...
-      device_param->kernel_loops_min = MIN (device_param->kernel_loops_min, device_param->kernel_loops_max);
+    // The kernel source can depend on some JiT compiler macros which themself depend on the attack_modes.
+    // ATM this is relevant only for ATTACK_MODE_ASSOCIATION which slightly modifies ATTACK_MODE_STRAIGHT kernels.
 
-      device_param->overtune_unfriendly = true;
-    }
-    #endif
+    const u32 extra_value = (user_options->attack_mode == ATTACK_MODE_ASSOCIATION) ? ATTACK_MODE_ASSOCIATION : ATTACK_MODE_NONE;
 
-    // re-using context/command-queue, there is no need to re-initialize them
+    snprintf (device_name_chksum, HCBUFSIZ_TINY, "%d-%d-%d-%u-%u-%u-%s-%d-%u-%s-%s-%s-%d-%u-%u-%u-%u",
+      backend_ctx->comptime,
+      backend_ctx->cuda_driver_version,
+      backend_ctx->hip_runtimeVersion,
+      backend_ctx->metal_runtimeVersion,
+      device_param->sm_major,
+      device_param->sm_minor,
+      (device_param->is_hip == true) ? device_param->gcnArchName : "",
+      device_param->is_opencl,
+      device_param->opencl_platform_vendor_id,
+      device_param->device_name,
+      device_param->opencl_device_version,
+      device_param->opencl_driver_version,
+      device_param->vector_width,
+      hashconfig->kern_type,
+      extra_value,
+      (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max,
+      get_current_arch());
 
     /**
-     * create stream for CUDA devices
+     * kernel source filename
      */
 
-    if (device_param->is_cuda == true)
-    {
-      if (hc_cuCtxPushCurrent (hashcat_ctx, device_param->cuda_context) == -1)
-      {
-        device_param->skipped = true;
-
-        continue;
-      }
+    char source_file[256] = { 0 };
 
-      if (hc_cuStreamCreate (hashcat_ctx, &device_param->cuda_stream, CU_STREAM_DEFAULT) == -1)
-      {
-        device_param->skipped = true;
+    generate_source_kernel_filename (user_options->slow_candidates, hashconfig->attack_exec, user_options_extra->attack_kern, kern_type, hashconfig->opti_type, folder_config->shared_dir, source_file);
 
-        continue;
-      }
+    if (hc_path_read (source_file) == false)
+    {
+      event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
+
+      return -1;
     }
 
     /**
-     * create stream for HIP devices
+     * kernel cached filename
      */
 
-    if (device_param->is_hip == true)
-    {
-      if (hc_hipSetDevice (hashcat_ctx, device_param->hip_device) == -1)
-      {
-        device_param->skipped = true;
+    char kernel_key[32] = { 0 };
 
-        continue;
-      }
+    if (kernel_cache_key (hashcat_ctx, device_name_chksum, build_options_module_buf, source_file, kernel_key) == false) return -1;
 
-      if (hc_hipStreamCreateWithFlags (hashcat_ctx, &device_param->hip_stream, hipStreamDefault) == -1)
-      {
-        device_param->skipped = true;
+    memcpy (device_param->kernel_key, kernel_key, sizeof (device_param->kernel_key));
 
-        continue;
-      }
-    }
+    char cached_file[256] = { 0 };
+
+    generate_cached_kernel_filename (user_options->slow_candidates, hashconfig->attack_exec, user_options_extra->attack_kern, kern_type, hashconfig->opti_type, folder_config->kernels_dir, kernel_key, cached_file, device_param->is_metal);
 
     /**
-     * create events for CUDA devices
+     * load kernel
      */
 
-    if (device_param->is_cuda == true)
+    #if defined (__APPLE__)
+    const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module, &device_param->hip_module, &device_param->metal_library);
+    #else
+    const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module, &device_param->hip_module, NULL);
+    #endif
+
+    if (rc_load_kernel == false)
     {
-      if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event1, CU_EVENT_BLOCKING_SYNC) == -1)
-      {
-        device_param->skipped = true;
+      event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-        continue;
-      }
+      session_device->kernel_build_warnings++;
 
-      if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event2, CU_EVENT_BLOCKING_SYNC) == -1)
-      {
-        device_param->skipped = true;
+      device_param->skipped_warning = true;
+      return 0;
+    }
 
-        continue;
-      }
+    hcfree (build_options_module_buf);
+  }
 
-      if (hc_cuEventCreate (hashcat_ctx, &device_param->cuda_event3, CU_EVENT_DISABLE_TIMING) == -1)
-      {
-        device_param->skipped = true;
+  /**
+   * word generator kernel
+   */
 
-        continue;
-      }
-    }
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if ((user_options->attack_mode != ATTACK_MODE_STRAIGHT) && (user_options->attack_mode != ATTACK_MODE_GENERIC) && (user_options->attack_mode != ATTACK_MODE_ASSOCIATION))
+    {
+      /**
+       * kernel mp source filename
+       */
 
-    /**
-     * create events for HIP devices
-     */
+      char source_file[256] = { 0 };
 
-    if (device_param->is_hip == true)
-    {
-      if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event1, hipEventBlockingSync) == -1)
+      generate_source_kernel_mp_filename (hashconfig->opti_type, hashconfig->opts_type, folder_config->shared_dir, source_file);
+
+      if (hc_path_read (source_file) == false)
       {
-        device_param->skipped = true;
+        event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
 
-        continue;
+        return -1;
       }
 
-      if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event2, hipEventBlockingSync) == -1)
-      {
-        device_param->skipped = true;
+      /**
+       * kernel mp cached filename
+       */
 
-        continue;
-      }
+      char cached_file[256] = { 0 };
 
-      if (hc_hipEventCreateWithFlags (hashcat_ctx, &device_param->hip_event3, hipEventDisableTiming) == -1)
-      {
-        device_param->skipped = true;
+      char kernel_key[32] = { 0 };
 
-        continue;
-      }
-    }
+      if (kernel_cache_key (hashcat_ctx, device_name_chksum_amp_mp, build_options_buf, source_file, kernel_key) == false) return -1;
 
-    /**
-     * create input buffers on device : calculate size of fixed memory buffers
-     */
+      generate_cached_kernel_mp_filename (hashconfig->opti_type, hashconfig->opts_type, folder_config->kernels_dir, kernel_key, cached_file, device_param->is_metal);
 
-    u64 size_root_css   = SP_PW_MAX *           sizeof (cs_t);
-    u64 size_markov_css = SP_PW_MAX * CHARSIZ * sizeof (cs_t);
+      #if defined (__APPLE__)
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp, &device_param->hip_module_mp, &device_param->metal_library_mp);
+      #else
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp, &device_param->hip_module_mp, NULL);
+      #endif
 
-    device_param->size_root_css   = size_root_css;
-    device_param->size_markov_css = size_markov_css;
+      if (rc_load_kernel == false)
+      {
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-    u64 size_results = sizeof (u32);
+        return -1;
+      }
+    }
+  }
 
-    device_param->size_results = size_results;
+  /**
+   * amplifier kernel
+   */
 
-    u32 aligned_rules_cnt = MAX (MAX (straight_ctx->kernel_rules_cnt, device_param->kernel_loops_min), KERNEL_RULES);
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+    {
 
-    u64 size_rules     = (u64) aligned_rules_cnt * sizeof (kernel_rule_t);
-    u64 size_rules_src = (u64) straight_ctx->kernel_rules_cnt * sizeof (kernel_rule_t);  // size of source rules buffer can be less than aligned_rules_cnt
-    u64 size_rules_c   = (u64) KERNEL_RULES      * sizeof (kernel_rule_t);
+    }
+    else
+    {
+      /**
+       * kernel amp source filename
+       */
 
-    device_param->size_rules    = size_rules;
-    device_param->size_rules_c  = size_rules_c;
+      char source_file[256] = { 0 };
 
-    u64 size_plains  = (u64) hashes->digests_cnt * sizeof (plain_t);
-    u64 size_salts   = (u64) hashes->salts_cnt   * sizeof (salt_t);
-    u64 size_esalts  = (u64) hashes->digests_cnt * hashconfig->esalt_size;
-    u64 size_shown   = (u64) hashes->digests_cnt * sizeof (u32);
-    u64 size_digests = (u64) hashes->digests_cnt * (u64) hashconfig->dgst_size;
+      generate_source_kernel_amp_filename (user_options_extra->attack_kern, folder_config->shared_dir, source_file);
 
-    device_param->size_plains   = size_plains;
-    device_param->size_digests  = size_digests;
-    device_param->size_shown    = size_shown;
-    device_param->size_salts    = size_salts;
-    device_param->size_esalts   = size_esalts;
+      if (hc_path_read (source_file) == false)
+      {
+        event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
 
-    u64 size_combs          = KERNEL_COMBS * sizeof (pw_t);
-    u64 size_bfs            = KERNEL_BFS   * sizeof (bf_t);
-    u64 size_tm             = 32           * sizeof (bs_word_t);
-    u64 size_kernel_params  = 1            * sizeof (kernel_param_t);
+        return -1;
+      }
 
-    device_param->size_bfs           = size_bfs;
-    device_param->size_combs         = size_combs;
-    device_param->size_tm            = size_tm;
-    device_param->size_kernel_params = size_kernel_params;
+      /**
+       * kernel amp cached filename
+       */
 
-    u64 size_st_digests = 1 * hashconfig->dgst_size;
-    u64 size_st_salts   = 1 * sizeof (salt_t);
-    u64 size_st_esalts  = 1 * hashconfig->esalt_size;
+      char cached_file[256] = { 0 };
 
-    device_param->size_st_digests = size_st_digests;
-    device_param->size_st_salts   = size_st_salts;
-    device_param->size_st_esalts  = size_st_esalts;
+      char kernel_key[32] = { 0 };
 
-    // extra buffer
+      if (kernel_cache_key (hashcat_ctx, device_name_chksum_amp_mp, build_options_buf, source_file, kernel_key) == false) return -1;
 
-    u64 size_extra_buffer1 = 4096;
-    u64 size_extra_buffer2 = 4096;
-    u64 size_extra_buffer3 = 4096;
-    u64 size_extra_buffer4 = 4096;
+      generate_cached_kernel_amp_filename (user_options_extra->attack_kern, folder_config->kernels_dir, kernel_key, cached_file, device_param->is_metal);
 
-    if (module_ctx->module_extra_buffer_size != MODULE_DEFAULT)
-    {
-      const u64 extra_buffer_size = module_ctx->module_extra_buffer_size (hashconfig, user_options, user_options_extra, hashes, device_param);
+      #if defined (__APPLE__)
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp, &device_param->hip_module_amp, &device_param->metal_library_amp);
+      #else
+      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp, &device_param->hip_module_amp, NULL);
+      #endif
 
-      if (extra_buffer_size == (u64) -1)
+      if (rc_load_kernel == false)
       {
-        event_log_error (hashcat_ctx, "Invalid extra buffer size.");
-
-        backend_extra_size_warning++;
+        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
 
-        device_param->skipped_warning = true;
-        continue;
+        return -1;
       }
 
-      device_param->extra_buffer_size = extra_buffer_size;
+      hcfree (build_options_buf);
+    }
+  }
 
-      /**
-       * We use a "4-buffer" strategy for certain hash types (like scrypt)
-       * that require large scratch buffers per work-item.
-       *
-       * The kernel assigns each work-item to one of 4 sub-buffers using:
-       *   buffer index = workitem_id % 4
-       *
-       * This means that each of the 4 sub-buffers must be large enough to hold
-       * all work-items that map to it. However, the total number of work-items
-       * is not always a multiple of 4. If we naively split the total buffer size
-       * evenly into 4 parts, the last chunk may be too small and cause buffer
-       * overflows for configurations where work-items spill into a partially sized chunk.
-       *
-       * Previous versions worked around this by over-allocating a full extra buffer,
-       * but this wasted gpu memory for large hashes like scrypt with high N.
-       *
-       * This improved logic computes the exact number of work-items assigned to
-       * each of the 4 chunks and sizes each chunk precisely:
-       *
-       * - The first 'leftover' chunks get one extra work-item to cover any remainder.
-       * - This guarantees each chunk is large enough for its assigned work-items.
-       */
+  /**
+   * no more need for the compiler. cuda doesn't offer this function.
+   * from opencl specs:
+   * Calls to clBuildProgram, clCompileProgram or clLinkProgram after clUnloadPlatformCompiler will reload the compiler, if necessary, to build the appropriate program executable.
+   */
+  // Disabled after user reporting weird errors like CL_OUT_OF_HOST_MEMORY after calling
+  /*
+  if (device_param->is_opencl == true)
+  {
+    cl_platform_id platform_id = backend_ctx->opencl_platforms[device_param->opencl_platform_id];
+
+    if (hc_clUnloadPlatformCompiler (hashcat_ctx, platform_id) == -1) return -1;
+  }
+  */
 
-      const u64 kernel_power_max = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE) ? 1 : device_param->device_processors) * device_param->kernel_accel_max;
+  /**
+   * global buffers
+   */
 
-      const u64 extra_buffer_size_threads = extra_buffer_size / kernel_power_max;
+  const u64 size_total_fixed
+    = bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + bitmap_ctx->bitmap_size
+    + size_plains
+    + size_digests
+    + size_shown
+    + size_salts
+    + size_results
+    + size_extra_buffer1
+    + size_extra_buffer2
+    + size_extra_buffer3
+    + size_extra_buffer4
+    + size_st_digests
+    + size_st_salts
+    + size_st_esalts
+    + size_esalts
+    + size_markov_css
+    + size_root_css
+    + size_rules
+    + size_rules_c
+    + size_tm
+    + size_kernel_params;
+
+  if (size_total_fixed > device_param->device_available_mem)
+  {
+    event_log_error (hashcat_ctx, "* Device #%u: Not enough allocatable device memory for this hashlist/ruleset.", device_id + 1);
 
-      const u64 workitems_per_chunk = kernel_power_max / 4;
+    session_device->memory_hit_warnings++;
 
-      const u64 base_chunk_size = workitems_per_chunk * extra_buffer_size_threads;
+    device_param->skipped_warning = true;
+    return 0;
+  }
 
-      size_extra_buffer1 += base_chunk_size;
-      size_extra_buffer2 += base_chunk_size;
-      size_extra_buffer3 += base_chunk_size;
-      size_extra_buffer4 += base_chunk_size;
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_plain_bufs,     size_plains)             == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_buf,    size_digests)            == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_shown,  size_shown)              == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_salt_bufs,      size_salts)              == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_result,         size_results)            == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra0_buf,     size_extra_buffer1)      == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra1_buf,     size_extra_buffer2)      == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra2_buf,     size_extra_buffer3)      == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra3_buf,     size_extra_buffer4)      == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_digests_buf, size_st_digests)         == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_salts_buf,   size_st_salts)           == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_kernel_param,   size_kernel_params)      == -1) return -1;
+
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_a, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_b, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_c, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_d, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_a, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_b, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_c, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_d, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
+    if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
 
-      const u64 leftover = kernel_power_max % 4;
+    /**
+     * special buffers
+     */
 
-      switch (leftover)
-      {
-        case 3: size_extra_buffer3 += extra_buffer_size_threads; // fall-through
-        case 2: size_extra_buffer2 += extra_buffer_size_threads; // fall-through
-        case 1: size_extra_buffer1 += extra_buffer_size_threads; // fall-through
-        case 0: break;
-      }
+    if (user_options->slow_candidates == true)
+    {
+      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
     }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules,   size_rules) == -1) return -1;
 
-    // kern type
+        if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+        {
+          size_t dummy = 0;
 
-    u32 kern_type = hashconfig->kern_type;
+          if (hc_cuModuleGetGlobal (hashcat_ctx, &device_param->cuda_d_rules_c, &dummy, device_param->cuda_module, "generic_constant") == -1) return -1;
+        }
+        else
+        {
+          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
+        }
 
-    if (module_ctx->module_kern_type_dynamic != MODULE_DEFAULT)
-    {
-      if (user_options->benchmark == true)
+        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_rules, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_combs,          size_combs)      == -1) return -1;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_combs_c,        size_combs)      == -1) return -1;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_markov_css_buf, size_markov_css) == -1) return -1;
       }
-      else
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        void        *digests_buf    = hashes->digests_buf;
-        salt_t      *salts_buf      = hashes->salts_buf;
-        void        *esalts_buf     = hashes->esalts_buf;
-        void        *hook_salts_buf = hashes->hook_salts_buf;
-        hashinfo_t **hash_info      = hashes->hash_info;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bfs,            size_bfs)        == -1) return -1;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_markov_css_buf, size_markov_css) == -1) return -1;
 
-        hashinfo_t *hash_info_ptr = NULL;
+        if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+        {
+          size_t dummy = 0;
 
-        if (hash_info) hash_info_ptr = hash_info[0];
+          if (hc_cuModuleGetGlobal (hashcat_ctx, &device_param->cuda_d_bfs_c, &dummy, device_param->cuda_module, "generic_constant") == -1) return -1;
 
-        kern_type = (u32) module_ctx->module_kern_type_dynamic (hashconfig, digests_buf, salts_buf, esalts_buf, hook_salts_buf, hash_info_ptr);
+          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tm_c,           size_tm)       == -1) return -1;
+        }
+        else
+        {
+          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bfs_c,          size_bfs)      == -1) return -1;
+          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tm_c,           size_tm)       == -1) return -1;
+        }
       }
     }
 
-    if ((int) kern_type == -1)
+    if (size_esalts)
     {
-      event_log_error (hashcat_ctx, "Invalid hash-mode selected: -1");
+      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_esalt_bufs, size_esalts) == -1) return -1;
 
-      return -1;
+      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_esalt_bufs, hashes->esalts_buf, size_esalts) == -1) return -1;
     }
 
-    // built options
+    if (hashconfig->st_hash != NULL)
+    {
+      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_digests_buf, hashes->st_digests_buf, size_st_digests) == -1) return -1;
+      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_salts_buf,   hashes->st_salts_buf,   size_st_salts)   == -1) return -1;
 
-    const size_t build_options_sz = 4096;
+      if (size_esalts)
+      {
+        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_esalts_buf, size_st_esalts) == -1) return -1;
 
-    char *build_options_buf = (char *) hcmalloc (build_options_sz);
+        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_esalts_buf, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
+      }
+    }
+  }
 
-    int build_options_len = snprintf(build_options_buf, build_options_sz, "-D KERNEL_STATIC ");
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_a,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_b,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_plain_bufs,     size_plains)             == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_buf,    size_digests)            == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_shown,  size_shown)              == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_salt_bufs,      size_salts)              == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_result,         size_results)            == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra0_buf,     size_extra_buffer1)      == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra1_buf,     size_extra_buffer2)      == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra2_buf,     size_extra_buffer3)      == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra3_buf,     size_extra_buffer4)      == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_digests_buf, size_st_digests)         == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_salts_buf,   size_st_salts)           == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_kernel_param,   size_kernel_params)      == -1) return -1;
+
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_a, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_b, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_c, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_d, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_a, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_b, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_c, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_d, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
+    if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
 
-    #if defined (DEBUG) && (DEBUG >= 1)
-    // only HIP and OpenCL have '-g'
-    if (device_param->is_hip == true || device_param->is_opencl == true)
-    {
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-g ");
-    }
-    #endif
+    /**
+     * special buffers
+     */
 
-    if ((device_param->is_cuda == true) || (device_param->is_hip == true))
+    if (user_options->slow_candidates == true)
     {
-      // using a path with a space will break nvrtc_make_options_array_from_string()
-      // we add it to options array in a clean way later
+      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
     }
     else
     {
-      #if defined (_WIN) || defined (__CYGWIN__) || defined (__MSYS__)
-      // workaround for AMD
-      if (device_param->opencl_platform_vendor_id == VENDOR_ID_AMD && device_param->opencl_device_vendor_id == VENDOR_ID_AMD)
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
       {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-I . ");
-      }
-
-      // when built with cygwin or msys, cpath_real doesn't work
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D INCLUDE_PATH=%s ", "OpenCL");
-      #else
-      const char *build_options_include_fmt = (strchr (folder_config->cpath_real, ' ') != NULL) ? "-D INCLUDE_PATH=\"%s\" " : "-D INCLUDE_PATH=%s ";
-
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, build_options_include_fmt, folder_config->cpath_real);
-      #endif
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules,   size_rules) == -1) return -1;
 
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D XM2S(x)=#x ");
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D M2S(x)=XM2S(x) ");
-      build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D MAX_THREADS_PER_BLOCK=%d ", (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max);
-
-      #if defined (__APPLE__)
-      if (is_apple_silicon () == true)
-      {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D IS_APPLE_SILICON ");
-      }
-      #endif
-    }
+        if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+        {
+          size_t dummy = 0;
 
-    /* currently disabled, hangs NEO drivers since 20.09.
-       was required for NEO driver 20.08 to workaround the same issue!
-       we go with the latest version
-       v7 re-enabled
-      */
+          if (hc_hipModuleGetGlobal (hashcat_ctx, &device_param->hip_d_rules_c, &dummy, device_param->hip_module, "generic_constant") == -1) return -1;
+        }
+        else
+        {
+          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
+        }
 
-    if (device_param->is_opencl == true)
-    {
-      if (device_param->use_opencl11 == true)
-      {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL1.1 ");
-      }
-      else if (device_param->use_opencl12 == true)
-      {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL1.2 ");
+        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_rules, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
       }
-      else if (device_param->use_opencl20 == true)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL2.0 ");
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_combs,          size_combs)      == -1) return -1;
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_combs_c,        size_combs)      == -1) return -1;
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_markov_css_buf, size_markov_css) == -1) return -1;
       }
-      else if (device_param->use_opencl30 == true)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-cl-std=CL3.0 ");
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bfs,            size_bfs)        == -1) return -1;
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_markov_css_buf, size_markov_css) == -1) return -1;
+
+        if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+        {
+          size_t dummy = 0;
+
+          if (hc_hipModuleGetGlobal (hashcat_ctx, &device_param->hip_d_bfs_c, &dummy, device_param->hip_module, "generic_constant") == -1) return -1;
+
+          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tm_c,           size_tm)       == -1) return -1;
+        }
+        else
+        {
+          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bfs_c,          size_bfs)      == -1) return -1;
+          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tm_c,           size_tm)       == -1) return -1;
+        }
       }
     }
 
-    // we don't have sm_* on vendors not NV but it doesn't matter
-
-    #if defined (DEBUG)
-    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D LOCAL_MEM_TYPE=%d -D VENDOR_ID=%u -D CUDA_ARCH=%u -D HAS_ADD=%u -D HAS_ADDC=%u -D HAS_SUB=%u -D HAS_SUBC=%u -D HAS_VADD=%u -D HAS_VADDC=%u -D HAS_VADD_CO=%u -D HAS_VADDC_CO=%u -D HAS_VSUB=%u -D HAS_VSUBB=%u -D HAS_VSUB_CO=%u -D HAS_VSUBB_CO=%u -D HAS_VPERM=%u -D HAS_VADD3=%u -D HAS_VBFE=%u -D HAS_BFE=%u -D HAS_LOP3=%u -D HAS_MOV64=%u -D HAS_PRMT=%u -D HAS_SHFW=%u -D VECT_SIZE=%d -D DEVICE_TYPE=%u -D DGST_R0=%u -D DGST_R1=%u -D DGST_R2=%u -D DGST_R3=%u -D DGST_ELEM=%u -D KERN_TYPE=%u -D ATTACK_EXEC=%u -D ATTACK_KERN=%u -D ATTACK_MODE=%u ", device_param->device_local_mem_type, device_param->opencl_platform_vendor_id, (device_param->sm_major * 100) + (device_param->sm_minor * 10), device_param->has_add, device_param->has_addc, device_param->has_sub, device_param->has_subc, device_param->has_vadd, device_param->has_vaddc, device_param->has_vadd_co, device_param->has_vaddc_co, device_param->has_vsub, device_param->has_vsubb, device_param->has_vsub_co, device_param->has_vsubb_co, device_param->has_vperm, device_param->has_vadd3, device_param->has_vbfe, device_param->has_bfe, device_param->has_lop3, device_param->has_mov64, device_param->has_prmt, device_param->has_shfw, device_param->vector_width, (u32) device_param->opencl_device_type, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, hashconfig->dgst_size / 4, kern_type, hashconfig->attack_exec, user_options_extra->attack_kern, user_options->attack_mode);
-    #else
-    build_options_len += snprintf (build_options_buf + build_options_len, build_options_sz - build_options_len, "-D LOCAL_MEM_TYPE=%d -D VENDOR_ID=%u -D CUDA_ARCH=%u -D HAS_ADD=%u -D HAS_ADDC=%u -D HAS_SUB=%u -D HAS_SUBC=%u -D HAS_VADD=%u -D HAS_VADDC=%u -D HAS_VADD_CO=%u -D HAS_VADDC_CO=%u -D HAS_VSUB=%u -D HAS_VSUBB=%u -D HAS_VSUB_CO=%u -D HAS_VSUBB_CO=%u -D HAS_VPERM=%u -D HAS_VADD3=%u -D HAS_VBFE=%u -D HAS_BFE=%u -D HAS_LOP3=%u -D HAS_MOV64=%u -D HAS_PRMT=%u -D HAS_SHFW=%u -D VECT_SIZE=%d -D DEVICE_TYPE=%u -D DGST_R0=%u -D DGST_R1=%u -D DGST_R2=%u -D DGST_R3=%u -D DGST_ELEM=%u -D KERN_TYPE=%u -D ATTACK_EXEC=%u -D ATTACK_KERN=%u -D ATTACK_MODE=%u -w ", device_param->device_local_mem_type, device_param->opencl_platform_vendor_id, (device_param->sm_major * 100) + (device_param->sm_minor * 10), device_param->has_add, device_param->has_addc, device_param->has_sub, device_param->has_subc, device_param->has_vadd, device_param->has_vaddc, device_param->has_vadd_co, device_param->has_vaddc_co, device_param->has_vsub, device_param->has_vsubb, device_param->has_vsub_co, device_param->has_vsubb_co, device_param->has_vperm, device_param->has_vadd3, device_param->has_vbfe, device_param->has_bfe, device_param->has_lop3, device_param->has_mov64, device_param->has_prmt, device_param->has_shfw, device_param->vector_width, (u32) device_param->opencl_device_type, hashconfig->dgst_pos0, hashconfig->dgst_pos1, hashconfig->dgst_pos2, hashconfig->dgst_pos3, hashconfig->dgst_size / 4, kern_type, hashconfig->attack_exec, user_options_extra->attack_kern, user_options->attack_mode);
-    #endif
+    if (size_esalts)
+    {
+      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_esalt_bufs, size_esalts) == -1) return -1;
 
-    build_options_buf[build_options_len] = 0;
+      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_esalt_bufs, hashes->esalts_buf, size_esalts) == -1) return -1;
+    }
 
-    /*
-    if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+    if (hashconfig->st_hash != NULL)
     {
-      if (device_param->opencl_platform_vendor_id == VENDOR_ID_INTEL_SDK)
+      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_digests_buf, hashes->st_digests_buf, size_st_digests) == -1) return -1;
+      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_salts_buf,   hashes->st_salts_buf,   size_st_salts) == -1) return -1;
+
+      if (size_esalts)
       {
-        strncat (build_options_buf, " -cl-opt-disable", 16);
+        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_esalts_buf, size_st_esalts) == -1) return -1;
+
+        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_esalts_buf, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
       }
     }
-    */
+  }
 
-    #if defined (DEBUG)
-    if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: build_options '%s'", device_id + 1, build_options_buf);
-    #endif
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_a);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_b);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_c);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_d);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_a);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_b);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer1,      NULL, extra0_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer2,      NULL, extra1_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer3,      NULL, extra2_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer4,      NULL, extra3_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_digests,         NULL, st_digests_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_salts,           NULL, st_salts_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_kernel_params,      NULL, kernel_param);
+
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_a, 0, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_b, 0, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_c, 0, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_d, 0, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_a, 0, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_b, 0, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_c, 0, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_d, 0, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_digests_buf, 0, hashes->digests_buf,     size_digests)            == -1) return -1;
+    if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_salt_bufs,   0, hashes->salts_buf,       size_salts)              == -1) return -1;
 
     /**
-     * device_name_chksum_amp_mp
+     * special buffers
      */
 
-    char device_name_chksum_amp_mp[HCBUFSIZ_TINY] = { 0 };
+    if (user_options->slow_candidates == true)
+    {
+      HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules_c,          NULL, rules_c);
+    }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules,          NULL, rules);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules_c,        NULL, rules_c);
 
-    const size_t dnclen_amp_mp = snprintf (device_name_chksum_amp_mp, HCBUFSIZ_TINY, "%d-%d-%d-%u-%u-%u-%s-%d-%u-%s-%s-%s-%u-%u",
-      backend_ctx->comptime,
-      backend_ctx->cuda_driver_version,
-      backend_ctx->hip_runtimeVersion,
-      backend_ctx->metal_runtimeVersion,
-      device_param->sm_major,
-      device_param->sm_minor,
-      (device_param->is_hip == true) ? device_param->gcnArchName : "",
-      device_param->is_opencl,
-      device_param->opencl_platform_vendor_id,
-      device_param->device_name,
-      device_param->opencl_device_version,
-      device_param->opencl_driver_version,
-      (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max,
-      get_current_arch());
+        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_rules, 0, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+      {
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs_c);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+      {
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs_c);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_tm,             NULL, tm_c);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
+      }
+    }
+
+    if (size_esalts)
+    {
+      HC_MTL_CREATEBUFFER(hashcat_ctx, size_esalts,           NULL, esalt_bufs);
 
-    md5_ctx_t md5_ctx;
+      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_esalt_bufs, 0, hashes->esalts_buf, size_esalts) == -1) return -1;
+    }
 
-    md5_init   (&md5_ctx);
-    md5_update (&md5_ctx, (u32 *) device_name_chksum_amp_mp, dnclen_amp_mp);
-    md5_final  (&md5_ctx);
+    if (hashconfig->st_hash != NULL)
+    {
+      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_digests_buf, 0, hashes->st_digests_buf, size_st_digests) == -1) return -1;
+      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_salts_buf, 0, hashes->st_salts_buf, size_st_salts) == -1) return -1;
 
-    snprintf (device_name_chksum_amp_mp, HCBUFSIZ_TINY, "%08x", md5_ctx.h[0]);
+      if (size_esalts)
+      {
+        HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_esalts,      NULL, st_esalts_buf);
 
-    /**
-     * kernel cache
-     */
+        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_esalts_buf, 0, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
+      }
+    }
+  }
+  #endif // __APPLE__
 
-    bool cache_disable = false;
+  if (device_param->is_opencl == true)
+  {
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_a);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_b);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_c);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_d);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_a);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_b);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer1,      NULL, extra0_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer2,      NULL, extra1_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer3,      NULL, extra2_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer4,      NULL, extra3_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_digests,         NULL, st_digests_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_salts,           NULL, st_salts_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_kernel_params,      NULL, kernel_param);
+
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_a, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_a, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_b, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_b, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_c, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_c, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_d, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_d, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_a, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_a, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_b, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_b, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_c, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_c, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_d, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_d, 0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_digests_buf, CL_TRUE, 0, size_digests,            hashes->digests_buf,     0, NULL, NULL) == -1) return -1;
+    if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_salt_bufs,   CL_TRUE, 0, size_salts,              hashes->salts_buf,       0, NULL, NULL) == -1) return -1;
 
-    // Seems to be completely broken on Apple + (Intel?) CPU
-    // To reproduce set cache_disable to false and run benchmark -b
+    /**
+     * special buffers
+     */
 
-    if (device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE)
+    if (user_options->slow_candidates == true)
     {
-      if (device_param->opencl_device_type & CL_DEVICE_TYPE_CPU)
+      HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules_c,          NULL, rules_c);
+    }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules,          NULL, rules);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules_c,        NULL, rules_c);
+
+        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_rules,   CL_TRUE, 0, size_rules_src, straight_ctx->kernel_rules_buf, 0, NULL, NULL) == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+      {
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs_c);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        cache_disable = true;
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs_c);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_tm,             NULL, tm_c);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
       }
     }
 
-    if (module_ctx->module_jit_cache_disable != MODULE_DEFAULT)
+    if (size_esalts)
     {
-      cache_disable = module_ctx->module_jit_cache_disable (hashconfig, user_options, user_options_extra, hashes, device_param);
-    }
-
-    #if defined (DEBUG)
-    // https://github.com/hashcat/hashcat/issues/2750
-    cache_disable = true;
-    #endif
+      HC_OCL_CREATEBUFFER(hashcat_ctx, size_esalts,           NULL, esalt_bufs);
 
-    /**
-     * shared kernel with no hashconfig dependencies
-     */
+      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_esalt_bufs,      CL_TRUE, 0, size_esalts,     hashes->esalts_buf,      0, NULL, NULL) == -1) return -1;
+    }
 
+    if (hashconfig->st_hash != NULL)
     {
-      /**
-       * kernel shared source filename
-       */
-
-      char source_file[256] = { 0 };
-
-      generate_source_kernel_shared_filename (folder_config->shared_dir, source_file);
+      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_digests_buf,  CL_TRUE, 0, size_st_digests, hashes->st_digests_buf,  0, NULL, NULL) == -1) return -1;
+      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_salts_buf,    CL_TRUE, 0, size_st_salts,   hashes->st_salts_buf,    0, NULL, NULL) == -1) return -1;
 
-      if (hc_path_read (source_file) == false)
+      if (size_esalts)
       {
-        event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
+        HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_esalts,      NULL, st_esalts_buf);
 
-        return -1;
+        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_esalts_buf, CL_TRUE, 0, size_st_esalts,  hashes->st_esalts_buf,   0, NULL, NULL) == -1) return -1;
       }
+    }
 
-      /**
-       * kernel shared cached filename
-       */
+    if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
+  }
 
-      char cached_file[256] = { 0 };
+  /**
+   * kernel args
+   */
 
-      generate_cached_kernel_shared_filename (folder_config->cache_dir, device_name_chksum_amp_mp, cached_file, device_param->is_metal);
+  device_param->kernel_param.bitmap_mask         = bitmap_ctx->bitmap_mask;
+  device_param->kernel_param.bitmap_shift1       = bitmap_ctx->bitmap_shift1;
+  device_param->kernel_param.bitmap_shift2       = bitmap_ctx->bitmap_shift2;
+  device_param->kernel_param.salt_pos_host       = 0;
+  device_param->kernel_param.loop_pos            = 0;
+  device_param->kernel_param.loop_cnt            = 0;
+  device_param->kernel_param.il_cnt              = 0;
+  device_param->kernel_param.digests_cnt         = 0;
+  device_param->kernel_param.digests_offset_host = 0;
+  device_param->kernel_param.combs_mode          = 0;
+  device_param->kernel_param.salt_repeat         = 0;
+  device_param->kernel_param.combs_mode          = 0;
+  device_param->kernel_param.salt_repeat         = 0;
+  device_param->kernel_param.pws_pos             = 0;
+  device_param->kernel_param.gid_max             = 0;
+  device_param->kernel_param.salt_batch_pws      = SALT_BATCH_PWS_NONE;
+
+  device_param->salt_batch_cnt     = 1;
+  device_param->salt_batch_pws_cnt = 0;
 
-      #if defined (__APPLE__)
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared, &device_param->hip_module_shared, &device_param->metal_library_shared);
-      #else
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "shared_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_shared, &device_param->cuda_module_shared, &device_param->hip_module_shared, NULL);
-      #endif
+  if (device_param->is_cuda == true)
+  {
+    device_param->kernel_params[ 0] = NULL; // &device_param->cuda_d_pws_buf;
+    device_param->kernel_params[ 1] = &device_param->cuda_d_rules_c;
+    device_param->kernel_params[ 2] = &device_param->cuda_d_combs_c;
+    device_param->kernel_params[ 3] = &device_param->cuda_d_bfs_c;
+    device_param->kernel_params[ 4] = NULL; // &device_param->cuda_d_tmps;
+    device_param->kernel_params[ 5] = NULL; // &device_param->cuda_d_hooks;
+    device_param->kernel_params[ 6] = &device_param->cuda_d_bitmap_s1_a;
+    device_param->kernel_params[ 7] = &device_param->cuda_d_bitmap_s1_b;
+    device_param->kernel_params[ 8] = &device_param->cuda_d_bitmap_s1_c;
+    device_param->kernel_params[ 9] = &device_param->cuda_d_bitmap_s1_d;
+    device_param->kernel_params[10] = &device_param->cuda_d_bitmap_s2_a;
+    device_param->kernel_params[11] = &device_param->cuda_d_bitmap_s2_b;
+    device_param->kernel_params[12] = &device_param->cuda_d_bitmap_s2_c;
+    device_param->kernel_params[13] = &device_param->cuda_d_bitmap_s2_d;
+    device_param->kernel_params[14] = &device_param->cuda_d_plain_bufs;
+    device_param->kernel_params[15] = &device_param->cuda_d_digests_buf;
+    device_param->kernel_params[16] = &device_param->cuda_d_digests_shown;
+    device_param->kernel_params[17] = &device_param->cuda_d_salt_bufs;
+    device_param->kernel_params[18] = &device_param->cuda_d_esalt_bufs;
+    device_param->kernel_params[19] = &device_param->cuda_d_result;
+    device_param->kernel_params[20] = &device_param->cuda_d_extra0_buf;
+    device_param->kernel_params[21] = &device_param->cuda_d_extra1_buf;
+    device_param->kernel_params[22] = &device_param->cuda_d_extra2_buf;
+    device_param->kernel_params[23] = &device_param->cuda_d_extra3_buf;
+    device_param->kernel_params[24] = &device_param->cuda_d_kernel_param;
+  }
 
-      if (rc_load_kernel == false)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+  if (device_param->is_hip == true)
+  {
+    device_param->kernel_params[ 0] = NULL; // &device_param->hip_d_pws_buf;
+    device_param->kernel_params[ 1] = &device_param->hip_d_rules_c;
+    device_param->kernel_params[ 2] = &device_param->hip_d_combs_c;
+    device_param->kernel_params[ 3] = &device_param->hip_d_bfs_c;
+    device_param->kernel_params[ 4] = NULL; // &device_param->hip_d_tmps;
+    device_param->kernel_params[ 5] = NULL; // &device_param->hip_d_hooks;
+    device_param->kernel_params[ 6] = &device_param->hip_d_bitmap_s1_a;
+    device_param->kernel_params[ 7] = &device_param->hip_d_bitmap_s1_b;
+    device_param->kernel_params[ 8] = &device_param->hip_d_bitmap_s1_c;
+    device_param->kernel_params[ 9] = &device_param->hip_d_bitmap_s1_d;
+    device_param->kernel_params[10] = &device_param->hip_d_bitmap_s2_a;
+    device_param->kernel_params[11] = &device_param->hip_d_bitmap_s2_b;
+    device_param->kernel_params[12] = &device_param->hip_d_bitmap_s2_c;
+    device_param->kernel_params[13] = &device_param->hip_d_bitmap_s2_d;
+    device_param->kernel_params[14] = &device_param->hip_d_plain_bufs;
+    device_param->kernel_params[15] = &device_param->hip_d_digests_buf;
+    device_param->kernel_params[16] = &device_param->hip_d_digests_shown;
+    device_param->kernel_params[17] = &device_param->hip_d_salt_bufs;
+    device_param->kernel_params[18] = &device_param->hip_d_esalt_bufs;
+    device_param->kernel_params[19] = &device_param->hip_d_result;
+    device_param->kernel_params[20] = &device_param->hip_d_extra0_buf;
+    device_param->kernel_params[21] = &device_param->hip_d_extra1_buf;
+    device_param->kernel_params[22] = &device_param->hip_d_extra2_buf;
+    device_param->kernel_params[23] = &device_param->hip_d_extra3_buf;
+    device_param->kernel_params[24] = &device_param->hip_d_kernel_param;
+  }
 
-        return -1;
-      }
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    device_param->kernel_params[ 0] = NULL; // device_param->metal_d_pws_buf;
+    device_param->kernel_params[ 1] = device_param->metal_d_rules_c.buf_ptr;
+    device_param->kernel_params[ 2] = device_param->metal_d_combs_c.buf_ptr;
+    device_param->kernel_params[ 3] = device_param->metal_d_bfs_c.buf_ptr;
+    device_param->kernel_params[ 4] = NULL; // device_param->metal_d_tmps;
+    device_param->kernel_params[ 5] = NULL; // device_param->metal_d_hooks;
+    device_param->kernel_params[ 6] = device_param->metal_d_bitmap_s1_a.buf_ptr;
+    device_param->kernel_params[ 7] = device_param->metal_d_bitmap_s1_b.buf_ptr;
+    device_param->kernel_params[ 8] = device_param->metal_d_bitmap_s1_c.buf_ptr;
+    device_param->kernel_params[ 9] = device_param->metal_d_bitmap_s1_d.buf_ptr;
+    device_param->kernel_params[10] = device_param->metal_d_bitmap_s2_a.buf_ptr;
+    device_param->kernel_params[11] = device_param->metal_d_bitmap_s2_b.buf_ptr;
+    device_param->kernel_params[12] = device_param->metal_d_bitmap_s2_c.buf_ptr;
+    device_param->kernel_params[13] = device_param->metal_d_bitmap_s2_d.buf_ptr;
+    device_param->kernel_params[14] = device_param->metal_d_plain_bufs.buf_ptr;
+    device_param->kernel_params[15] = device_param->metal_d_digests_buf.buf_ptr;
+    device_param->kernel_params[16] = device_param->metal_d_digests_shown.buf_ptr;
+    device_param->kernel_params[17] = device_param->metal_d_salt_bufs.buf_ptr;
+    device_param->kernel_params[18] = device_param->metal_d_esalt_bufs.buf_ptr;
+    device_param->kernel_params[19] = device_param->metal_d_result.buf_ptr;
+    device_param->kernel_params[20] = device_param->metal_d_extra0_buf.buf_ptr;
+    device_param->kernel_params[21] = device_param->metal_d_extra1_buf.buf_ptr;
+    device_param->kernel_params[22] = device_param->metal_d_extra2_buf.buf_ptr;
+    device_param->kernel_params[23] = device_param->metal_d_extra3_buf.buf_ptr;
+    device_param->kernel_params[24] = device_param->metal_d_kernel_param.buf_ptr;
+  }
+  #endif // __APPLE__
+
+  if (device_param->is_opencl == true)
+  {
+    device_param->kernel_params[ 0] = NULL; // &device_param->opencl_d_pws_buf;
+    device_param->kernel_params[ 1] = &device_param->opencl_d_rules_c;
+    device_param->kernel_params[ 2] = &device_param->opencl_d_combs_c;
+    device_param->kernel_params[ 3] = &device_param->opencl_d_bfs_c;
+    device_param->kernel_params[ 4] = NULL; // &device_param->opencl_d_tmps;
+    device_param->kernel_params[ 5] = NULL; // &device_param->opencl_d_hooks;
+    device_param->kernel_params[ 6] = &device_param->opencl_d_bitmap_s1_a;
+    device_param->kernel_params[ 7] = &device_param->opencl_d_bitmap_s1_b;
+    device_param->kernel_params[ 8] = &device_param->opencl_d_bitmap_s1_c;
+    device_param->kernel_params[ 9] = &device_param->opencl_d_bitmap_s1_d;
+    device_param->kernel_params[10] = &device_param->opencl_d_bitmap_s2_a;
+    device_param->kernel_params[11] = &device_param->opencl_d_bitmap_s2_b;
+    device_param->kernel_params[12] = &device_param->opencl_d_bitmap_s2_c;
+    device_param->kernel_params[13] = &device_param->opencl_d_bitmap_s2_d;
+    device_param->kernel_params[14] = &device_param->opencl_d_plain_bufs;
+    device_param->kernel_params[15] = &device_param->opencl_d_digests_buf;
+    device_param->kernel_params[16] = &device_param->opencl_d_digests_shown;
+    device_param->kernel_params[17] = &device_param->opencl_d_salt_bufs;
+    device_param->kernel_params[18] = &device_param->opencl_d_esalt_bufs;
+    device_param->kernel_params[19] = &device_param->opencl_d_result;
+    device_param->kernel_params[20] = &device_param->opencl_d_extra0_buf;
+    device_param->kernel_params[21] = &device_param->opencl_d_extra1_buf;
+    device_param->kernel_params[22] = &device_param->opencl_d_extra2_buf;
+    device_param->kernel_params[23] = &device_param->opencl_d_extra3_buf;
+    device_param->kernel_params[24] = &device_param->opencl_d_kernel_param;
+  }
 
-      int rc = -1;
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    device_param->kernel_params_mp_buf64[3] = 0;
+    device_param->kernel_params_mp_buf32[4] = 0;
+    device_param->kernel_params_mp_buf32[5] = 0;
+    device_param->kernel_params_mp_buf32[6] = 0;
+    device_param->kernel_params_mp_buf32[7] = 0;
+    device_param->kernel_params_mp_buf64[8] = 0;
 
+    if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+    {
       if (device_param->is_cuda == true)
       {
-        rc = backend_session_setup_cuda_kernel_shared (hashcat_ctx, device_param);
+        device_param->kernel_params_mp[0] = &device_param->cuda_d_combs;
       }
 
       if (device_param->is_hip == true)
       {
-        rc = backend_session_setup_hip_kernel_shared (hashcat_ctx, device_param);
+        device_param->kernel_params_mp[0] = &device_param->hip_d_combs;
       }
 
       #if defined (__APPLE__)
       if (device_param->is_metal == true)
       {
-        rc = backend_session_setup_metal_kernel_shared (hashcat_ctx, device_param);
+        device_param->kernel_params_mp[0] = device_param->metal_d_combs.buf_ptr;
       }
       #endif
 
       if (device_param->is_opencl == true)
       {
-        rc = backend_session_setup_opencl_kernel_shared (hashcat_ctx, device_param);
-      }
-
-      if (rc == -2)
-      {
-        backend_kernel_create_warnings++;
-
-        continue;
+        device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
       }
-
-      if (rc == -1) return -1;
-
     }
-
-    /**
-     * main kernel
-     */
-
+    else
     {
-      char *build_options_module_buf = (char *) hcmalloc (build_options_sz);
-
-      int build_options_module_len = 0;
-
-      build_options_module_len += snprintf (build_options_module_buf + build_options_module_len, build_options_sz - build_options_module_len, "%s ", build_options_buf);
-
-      if (module_ctx->module_jit_build_options != MODULE_DEFAULT)
+      if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
       {
-        char *jit_build_options = module_ctx->module_jit_build_options (hashconfig, user_options, user_options_extra, hashes, device_param);
-
-        if (jit_build_options != NULL)
+        if (device_param->is_cuda == true)
         {
-          build_options_module_len += snprintf (build_options_module_buf + build_options_module_len, build_options_sz - build_options_module_len, "%s", jit_build_options);
-
-          // this is a bit ugly
-          // would be better to have the module return the value as value
-
-          u32 fixed_local_size = 0;
-
-          if (sscanf (jit_build_options, "-D FIXED_LOCAL_SIZE=%u", &fixed_local_size) == 1)
-          {
-            device_param->kernel_threads_min = fixed_local_size;
-            device_param->kernel_threads_max = fixed_local_size;
-          }
-          else if (sscanf (jit_build_options, "-D FORCED_THREAD_COUNT=%u", &fixed_local_size) == 1)
-          {
-            // FORCED_THREAD_COUNT is the same as FIXED_LOCAL_SIZE, but has no impact on the kernel jit
+          device_param->kernel_params_mp[0] = &device_param->cuda_d_combs;
+        }
 
-            device_param->kernel_threads_min = fixed_local_size;
-            device_param->kernel_threads_max = fixed_local_size;
-          }
-          else
-          {
-            // kernels specific minimum needs to be set so that self-test wont fail
+        if (device_param->is_hip == true)
+        {
+          device_param->kernel_params_mp[0] = &device_param->hip_d_combs;
+        }
 
-            if (sscanf (jit_build_options, "-D FIXED_LOCAL_SIZE_COMP=%u", &fixed_local_size) == 1)
-            {
-              device_param->kernel_threads_min = fixed_local_size;
-              // device_param->kernel_threads_max = fixed_local_size;
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          device_param->kernel_params_mp[0] = device_param->metal_d_combs.buf_ptr;
+        }
+        #endif
 
-              device_param->overtune_unfriendly = true;
-            }
-          }
+        if (device_param->is_opencl == true)
+        {
+          device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
         }
       }
-
-      build_options_module_buf[build_options_module_len] = 0;
-
-      #if defined (DEBUG)
-      if (user_options->quiet == false) event_log_warning (hashcat_ctx, "* Device #%u: build_options_module '%s'", device_id + 1, build_options_module_buf);
-      #endif
-
-      /**
-       * device_name_chksum
-       */
-
-      char device_name_chksum[HCBUFSIZ_TINY] = { 0 };
-
-      // The kernel source can depend on some JiT compiler macros which themself depend on the attack_modes.
-      // ATM this is relevant only for ATTACK_MODE_ASSOCIATION which slightly modifies ATTACK_MODE_STRAIGHT kernels.
-
-      const u32 extra_value = (user_options->attack_mode == ATTACK_MODE_ASSOCIATION) ? ATTACK_MODE_ASSOCIATION : ATTACK_MODE_NONE;
-
-      const size_t dnclen = snprintf (device_name_chksum, HCBUFSIZ_TINY, "%d-%d-%d-%u-%u-%u-%s-%d-%u-%s-%s-%s-%d-%u-%u-%u-%u-%s",
-        backend_ctx->comptime,
-        backend_ctx->cuda_driver_version,
-        backend_ctx->hip_runtimeVersion,
-        backend_ctx->metal_runtimeVersion,
-        device_param->sm_major,
-        device_param->sm_minor,
-        (device_param->is_hip == true) ? device_param->gcnArchName : "",
-        device_param->is_opencl,
-        device_param->opencl_platform_vendor_id,
-        device_param->device_name,
-        device_param->opencl_device_version,
-        device_param->opencl_driver_version,
-        device_param->vector_width,
-        hashconfig->kern_type,
-        extra_value,
-        (user_options->kernel_threads_chgd == true) ? user_options->kernel_threads : device_param->kernel_threads_max,
-        get_current_arch(),
-        build_options_module_buf);
-
-      memset     (&md5_ctx, 0, sizeof (md5_ctx_t));
-      md5_init   (&md5_ctx);
-      md5_update (&md5_ctx, (u32 *) device_name_chksum, dnclen);
-      md5_final  (&md5_ctx);
-
-      snprintf (device_name_chksum, HCBUFSIZ_TINY, "%08x", md5_ctx.h[0]);
-
-      /**
-       * kernel source filename
-       */
-
-      char source_file[256] = { 0 };
-
-      generate_source_kernel_filename (user_options->slow_candidates, hashconfig->attack_exec, user_options_extra->attack_kern, kern_type, hashconfig->opti_type, folder_config->shared_dir, source_file);
-
-      if (hc_path_read (source_file) == false)
+      else
       {
-        event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
-
-        return -1;
+        device_param->kernel_params_mp[0] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                  // ? &device_param->opencl_d_pws_buf
+                                                  // : &device_param->opencl_d_pws_amp_buf;
       }
+    }
 
-      /**
-       * kernel cached filename
-       */
-
-      char cached_file[256] = { 0 };
+    if (device_param->is_cuda == true)
+    {
+      device_param->kernel_params_mp[1] = &device_param->cuda_d_root_css_buf;
+      device_param->kernel_params_mp[2] = &device_param->cuda_d_markov_css_buf;
+    }
 
-      generate_cached_kernel_filename (user_options->slow_candidates, hashconfig->attack_exec, user_options_extra->attack_kern, kern_type, hashconfig->opti_type, folder_config->cache_dir, device_name_chksum, cached_file, device_param->is_metal);
+    if (device_param->is_hip == true)
+    {
+      device_param->kernel_params_mp[1] = &device_param->hip_d_root_css_buf;
+      device_param->kernel_params_mp[2] = &device_param->hip_d_markov_css_buf;
+    }
 
-      /**
-       * load kernel
-       */
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      device_param->kernel_params_mp[1] = device_param->metal_d_root_css_buf.buf_ptr;
+      device_param->kernel_params_mp[2] = device_param->metal_d_markov_css_buf.buf_ptr;
+    }
+    #endif
 
-      #if defined (__APPLE__)
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module, &device_param->hip_module, &device_param->metal_library);
-      #else
-      const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "main_kernel", source_file, cached_file, build_options_module_buf, cache_disable, &device_param->opencl_program, &device_param->cuda_module, &device_param->hip_module, NULL);
-      #endif
+    if (device_param->is_opencl == true)
+    {
+      device_param->kernel_params_mp[1] = &device_param->opencl_d_root_css_buf;
+      device_param->kernel_params_mp[2] = &device_param->opencl_d_markov_css_buf;
+    }
 
-      if (rc_load_kernel == false)
-      {
-        event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+    device_param->kernel_params_mp[3] = &device_param->kernel_params_mp_buf64[3];
+    device_param->kernel_params_mp[4] = &device_param->kernel_params_mp_buf32[4];
+    device_param->kernel_params_mp[5] = &device_param->kernel_params_mp_buf32[5];
+    device_param->kernel_params_mp[6] = &device_param->kernel_params_mp_buf32[6];
+    device_param->kernel_params_mp[7] = &device_param->kernel_params_mp_buf32[7];
+    device_param->kernel_params_mp[8] = &device_param->kernel_params_mp_buf64[8];
 
-        backend_kernel_build_warnings++;
+    device_param->kernel_params_mp_l_buf64[3] = 0;
+    device_param->kernel_params_mp_l_buf32[4] = 0;
+    device_param->kernel_params_mp_l_buf32[5] = 0;
+    device_param->kernel_params_mp_l_buf32[6] = 0;
+    device_param->kernel_params_mp_l_buf32[7] = 0;
+    device_param->kernel_params_mp_l_buf32[8] = 0;
+    device_param->kernel_params_mp_l_buf64[9] = 0;
 
-        device_param->skipped_warning = true;
-        continue;
-      }
+    device_param->kernel_params_mp_l[0] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                // ? &device_param->opencl_d_pws_buf
+                                                // : &device_param->opencl_d_pws_amp_buf;
 
-      hcfree (build_options_module_buf);
+    if (device_param->is_cuda == true)
+    {
+      device_param->kernel_params_mp_l[1] = &device_param->cuda_d_root_css_buf;
+      device_param->kernel_params_mp_l[2] = &device_param->cuda_d_markov_css_buf;
     }
 
-    /**
-     * word generator kernel
-     */
+    if (device_param->is_hip == true)
+    {
+      device_param->kernel_params_mp_l[1] = &device_param->hip_d_root_css_buf;
+      device_param->kernel_params_mp_l[2] = &device_param->hip_d_markov_css_buf;
+    }
 
-    if (user_options->slow_candidates == true)
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
     {
+      device_param->kernel_params_mp_l[1] = device_param->metal_d_root_css_buf.buf_ptr;
+      device_param->kernel_params_mp_l[2] = device_param->metal_d_markov_css_buf.buf_ptr;
     }
-    else
+    #endif
+
+    if (device_param->is_opencl == true)
     {
-      if ((user_options->attack_mode != ATTACK_MODE_STRAIGHT) && (user_options->attack_mode != ATTACK_MODE_GENERIC) && (user_options->attack_mode != ATTACK_MODE_ASSOCIATION))
-      {
-        /**
-         * kernel mp source filename
-         */
+      device_param->kernel_params_mp_l[1] = &device_param->opencl_d_root_css_buf;
+      device_param->kernel_params_mp_l[2] = &device_param->opencl_d_markov_css_buf;
+    }
 
-        char source_file[256] = { 0 };
+    device_param->kernel_params_mp_l[3] = &device_param->kernel_params_mp_l_buf64[3];
+    device_param->kernel_params_mp_l[4] = &device_param->kernel_params_mp_l_buf32[4];
+    device_param->kernel_params_mp_l[5] = &device_param->kernel_params_mp_l_buf32[5];
+    device_param->kernel_params_mp_l[6] = &device_param->kernel_params_mp_l_buf32[6];
+    device_param->kernel_params_mp_l[7] = &device_param->kernel_params_mp_l_buf32[7];
+    device_param->kernel_params_mp_l[8] = &device_param->kernel_params_mp_l_buf32[8];
+    device_param->kernel_params_mp_l[9] = &device_param->kernel_params_mp_l_buf64[9];
 
-        generate_source_kernel_mp_filename (hashconfig->opti_type, hashconfig->opts_type, folder_config->shared_dir, source_file);
+    device_param->kernel_params_mp_r_buf64[3] = 0;
+    device_param->kernel_params_mp_r_buf32[4] = 0;
+    device_param->kernel_params_mp_r_buf32[5] = 0;
+    device_param->kernel_params_mp_r_buf32[6] = 0;
+    device_param->kernel_params_mp_r_buf32[7] = 0;
+    device_param->kernel_params_mp_r_buf64[8] = 0;
 
-        if (hc_path_read (source_file) == false)
-        {
-          event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
+    if (device_param->is_cuda == true)
+    {
+      device_param->kernel_params_mp_r[0] = &device_param->cuda_d_bfs;
+      device_param->kernel_params_mp_r[1] = &device_param->cuda_d_root_css_buf;
+      device_param->kernel_params_mp_r[2] = &device_param->cuda_d_markov_css_buf;
+    }
 
-          return -1;
-        }
+    if (device_param->is_hip == true)
+    {
+      device_param->kernel_params_mp_r[0] = &device_param->hip_d_bfs;
+      device_param->kernel_params_mp_r[1] = &device_param->hip_d_root_css_buf;
+      device_param->kernel_params_mp_r[2] = &device_param->hip_d_markov_css_buf;
+    }
 
-        /**
-         * kernel mp cached filename
-         */
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      device_param->kernel_params_mp_r[0] = device_param->metal_d_bfs.buf_ptr;
+      device_param->kernel_params_mp_r[1] = device_param->metal_d_root_css_buf.buf_ptr;
+      device_param->kernel_params_mp_r[2] = device_param->metal_d_markov_css_buf.buf_ptr;
+    }
+    #endif
 
-        char cached_file[256] = { 0 };
+    if (device_param->is_opencl == true)
+    {
+      device_param->kernel_params_mp_r[0] = &device_param->opencl_d_bfs;
+      device_param->kernel_params_mp_r[1] = &device_param->opencl_d_root_css_buf;
+      device_param->kernel_params_mp_r[2] = &device_param->opencl_d_markov_css_buf;
+    }
 
-        generate_cached_kernel_mp_filename (hashconfig->opti_type, hashconfig->opts_type, folder_config->cache_dir, device_name_chksum_amp_mp, cached_file, device_param->is_metal);
+    device_param->kernel_params_mp_r[3] = &device_param->kernel_params_mp_r_buf64[3];
+    device_param->kernel_params_mp_r[4] = &device_param->kernel_params_mp_r_buf32[4];
+    device_param->kernel_params_mp_r[5] = &device_param->kernel_params_mp_r_buf32[5];
+    device_param->kernel_params_mp_r[6] = &device_param->kernel_params_mp_r_buf32[6];
+    device_param->kernel_params_mp_r[7] = &device_param->kernel_params_mp_r_buf32[7];
+    device_param->kernel_params_mp_r[8] = &device_param->kernel_params_mp_r_buf64[8];
 
-        #if defined (__APPLE__)
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp, &device_param->hip_module_mp, &device_param->metal_library_mp);
-        #else
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "mp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_mp, &device_param->cuda_module_mp, &device_param->hip_module_mp, NULL);
-        #endif
+    device_param->kernel_params_amp_buf32[5] = 0; // combs_mode
+    device_param->kernel_params_amp_buf64[6] = 0; // gid_max
 
-        if (rc_load_kernel == false)
-        {
-          event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+    if (device_param->is_cuda == true)
+    {
+      device_param->kernel_params_amp[0] = NULL; // &device_param->cuda_d_pws_buf;
+      device_param->kernel_params_amp[1] = NULL; // &device_param->cuda_d_pws_amp_buf;
+      device_param->kernel_params_amp[2] = &device_param->cuda_d_rules_c;
+      device_param->kernel_params_amp[3] = &device_param->cuda_d_combs_c;
+      device_param->kernel_params_amp[4] = &device_param->cuda_d_bfs_c;
+    }
 
-          return -1;
-        }
-      }
+    if (device_param->is_hip == true)
+    {
+      device_param->kernel_params_amp[0] = NULL; // &device_param->hip_d_pws_buf;
+      device_param->kernel_params_amp[1] = NULL; // &device_param->hip_d_pws_amp_buf;
+      device_param->kernel_params_amp[2] = &device_param->hip_d_rules_c;
+      device_param->kernel_params_amp[3] = &device_param->hip_d_combs_c;
+      device_param->kernel_params_amp[4] = &device_param->hip_d_bfs_c;
     }
 
-    /**
-     * amplifier kernel
-     */
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      device_param->kernel_params_amp[0] = NULL; // device_param->metal_d_pws_buf;
+      device_param->kernel_params_amp[1] = NULL; // device_param->metal_d_pws_amp_buf;
+      device_param->kernel_params_amp[2] = device_param->metal_d_rules_c.buf_ptr;
+      device_param->kernel_params_amp[3] = device_param->metal_d_combs_c.buf_ptr;
+      device_param->kernel_params_amp[4] = device_param->metal_d_bfs_c.buf_ptr;
+    }
+    #endif
 
-    if (user_options->slow_candidates == true)
+    if (device_param->is_opencl == true)
     {
+      device_param->kernel_params_amp[0] = NULL; // &device_param->opencl_d_pws_buf;
+      device_param->kernel_params_amp[1] = NULL; // &device_param->opencl_d_pws_amp_buf;
+      device_param->kernel_params_amp[2] = &device_param->opencl_d_rules_c;
+      device_param->kernel_params_amp[3] = &device_param->opencl_d_combs_c;
+      device_param->kernel_params_amp[4] = &device_param->opencl_d_bfs_c;
     }
-    else
+
+    device_param->kernel_params_amp[5] = &device_param->kernel_params_amp_buf32[5];
+    device_param->kernel_params_amp[6] = &device_param->kernel_params_amp_buf64[6];
+
+    if (device_param->is_cuda == true)
     {
-      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-      {
+      device_param->kernel_params_tm[0] = &device_param->cuda_d_bfs_c;
+      device_param->kernel_params_tm[1] = &device_param->cuda_d_tm_c;
+    }
 
-      }
-      else
-      {
-        /**
-         * kernel amp source filename
-         */
+    if (device_param->is_hip == true)
+    {
+      device_param->kernel_params_tm[0] = &device_param->hip_d_bfs_c;
+      device_param->kernel_params_tm[1] = &device_param->hip_d_tm_c;
+    }
 
-        char source_file[256] = { 0 };
+    #if defined (__APPLE__)
+    if (device_param->is_metal == true)
+    {
+      device_param->kernel_params_tm[0] = device_param->metal_d_bfs_c.buf_ptr;
+      device_param->kernel_params_tm[1] = device_param->metal_d_tm_c.buf_ptr;
+    }
+    #endif
 
-        generate_source_kernel_amp_filename (user_options_extra->attack_kern, folder_config->shared_dir, source_file);
+    if (device_param->is_opencl == true)
+    {
+      device_param->kernel_params_tm[0] = &device_param->opencl_d_bfs_c;
+      device_param->kernel_params_tm[1] = &device_param->opencl_d_tm_c;
+    }
+  }
 
-        if (hc_path_read (source_file) == false)
-        {
-          event_log_error (hashcat_ctx, "%s: %s", source_file, strerror (errno));
+  device_param->kernel_params_memset_buf32[1] = 0; // value
+  device_param->kernel_params_memset_buf64[2] = 0; // gid_max
 
-          return -1;
-        }
+  device_param->kernel_params_memset[0] = NULL;
+  device_param->kernel_params_memset[1] = &device_param->kernel_params_memset_buf32[1];
+  device_param->kernel_params_memset[2] = &device_param->kernel_params_memset_buf64[2];
 
-        /**
-         * kernel amp cached filename
-         */
+  device_param->kernel_params_bzero_buf64[1] = 0; // gid_max
 
-        char cached_file[256] = { 0 };
+  device_param->kernel_params_bzero[0] = NULL;
+  device_param->kernel_params_bzero[1] = &device_param->kernel_params_bzero_buf64[1];
 
-        generate_cached_kernel_amp_filename (user_options_extra->attack_kern, folder_config->cache_dir, device_name_chksum_amp_mp, cached_file, device_param->is_metal);
+  device_param->kernel_params_atinit_buf64[1] = 0; // gid_max
 
-        #if defined (__APPLE__)
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp, &device_param->hip_module_amp, &device_param->metal_library_amp);
-        #else
-        const bool rc_load_kernel = load_kernel (hashcat_ctx, device_param, "amp_kernel", source_file, cached_file, build_options_buf, cache_disable, &device_param->opencl_program_amp, &device_param->cuda_module_amp, &device_param->hip_module_amp, NULL);
-        #endif
+  device_param->kernel_params_atinit[0] = NULL;
+  device_param->kernel_params_atinit[1] = &device_param->kernel_params_atinit_buf64[1];
 
-        if (rc_load_kernel == false)
-        {
-          event_log_error (hashcat_ctx, "* Device #%u: Kernel %s build failed.", device_param->device_id + 1, source_file);
+  device_param->kernel_params_utf8toutf16le_buf64[1] = 0; // gid_max
 
-          return -1;
-        }
+  device_param->kernel_params_utf8toutf16le[0] = NULL;
+  device_param->kernel_params_utf8toutf16le[1] = &device_param->kernel_params_utf8toutf16le_buf64[1];
 
-        hcfree (build_options_buf);
-      }
-    }
+  device_param->kernel_params_decompress_buf64[3] = 0; // gid_max
 
-    /**
-     * no more need for the compiler. cuda doesn't offer this function.
-     * from opencl specs:
-     * Calls to clBuildProgram, clCompileProgram or clLinkProgram after clUnloadPlatformCompiler will reload the compiler, if necessary, to build the appropriate program executable.
-     */
-    // Disabled after user reporting weird errors like CL_OUT_OF_HOST_MEMORY after calling
-    /*
-    if (device_param->is_opencl == true)
-    {
-      cl_platform_id platform_id = backend_ctx->opencl_platforms[device_param->opencl_platform_id];
+  if (device_param->is_cuda == true)
+  {
+    device_param->kernel_params_decompress[0] = NULL; // &device_param->cuda_d_pws_idx;
+    device_param->kernel_params_decompress[1] = NULL; // &device_param->cuda_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                      // ? &device_param->cuda_d_pws_buf
+                                                      // : &device_param->cuda_d_pws_amp_buf;
+  }
 
-      if (hc_clUnloadPlatformCompiler (hashcat_ctx, platform_id) == -1) return -1;
-    }
-    */
+  if (device_param->is_hip == true)
+  {
+    device_param->kernel_params_decompress[0] = NULL; // &device_param->hip_d_pws_idx;
+    device_param->kernel_params_decompress[1] = NULL; // &device_param->hip_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                      // ? &device_param->hip_d_pws_buf
+                                                      // : &device_param->hip_d_pws_amp_buf;
+  }
 
-    // some algorithm collide too fast, make that impossible
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    device_param->kernel_params_decompress[0] = NULL; // device_param->metal_d_pws_idx;
+    device_param->kernel_params_decompress[1] = NULL; // device_param->metal_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                      // ? device_param->metal_d_pws_buf
+                                                      // : device_param->metal_d_pws_amp_buf;
+  }
+  #endif
 
-    if (user_options->benchmark == true)
-    {
-      ((u32 *) hashes->digests_buf)[0] = -1U;
-      ((u32 *) hashes->digests_buf)[1] = -1U;
-      ((u32 *) hashes->digests_buf)[2] = -1U;
-      ((u32 *) hashes->digests_buf)[3] = -1U;
-    }
+  if (device_param->is_opencl == true)
+  {
+    device_param->kernel_params_decompress[0] = NULL; // &device_param->opencl_d_pws_idx;
+    device_param->kernel_params_decompress[1] = NULL; // &device_param->opencl_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                                      // ? &device_param->opencl_d_pws_buf
+                                                      // : &device_param->opencl_d_pws_amp_buf;
+  }
 
-    /**
-     * global buffers
-     */
+  device_param->kernel_params_decompress[3] = &device_param->kernel_params_decompress_buf64[3];
 
-    const u64 size_total_fixed
-      = bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + bitmap_ctx->bitmap_size
-      + size_plains
-      + size_digests
-      + size_shown
-      + size_salts
-      + size_results
-      + size_extra_buffer1
-      + size_extra_buffer2
-      + size_extra_buffer3
-      + size_extra_buffer4
-      + size_st_digests
-      + size_st_salts
-      + size_st_esalts
-      + size_esalts
-      + size_markov_css
-      + size_root_css
-      + size_rules
-      + size_rules_c
-      + size_tm
-      + size_kernel_params;
+  /**
+   * kernel name
+   */
 
-    if (size_total_fixed > device_param->device_available_mem)
-    {
-      event_log_error (hashcat_ctx, "* Device #%u: Not enough allocatable device memory for this hashlist/ruleset.", device_id + 1);
+  int rc = -1;
 
-      backend_memory_hit_warnings++;
+  if (device_param->is_cuda == true)
+  {
+    rc = backend_session_setup_cuda_kernel_types (hashcat_ctx, device_param, kern_type);
+  }
 
-      device_param->skipped_warning = true;
-      continue;
-    }
+  if (device_param->is_hip == true)
+  {
+    rc = backend_session_setup_hip_kernel_types (hashcat_ctx, device_param, kern_type);
+  }
 
-    if (device_param->is_cuda == true)
-    {
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_a,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_b,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_c,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s1_d,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_a,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_b,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_plain_bufs,     size_plains)             == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_buf,    size_digests)            == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_digests_shown,  size_shown)              == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_salt_bufs,      size_salts)              == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_result,         size_results)            == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra0_buf,     size_extra_buffer1)      == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra1_buf,     size_extra_buffer2)      == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra2_buf,     size_extra_buffer3)      == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_extra3_buf,     size_extra_buffer4)      == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_digests_buf, size_st_digests)         == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_salts_buf,   size_st_salts)           == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_kernel_param,   size_kernel_params)      == -1) return -1;
-
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_a, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_b, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_c, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s1_d, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_a, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_b, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_c, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_bitmap_s2_d, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
-      if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    rc = backend_session_setup_metal_kernel_types (hashcat_ctx, device_param, kern_type);
+  }
+  #endif
 
-      /**
-       * special buffers
-       */
+  if (device_param->is_opencl == true)
+  {
+    rc = backend_session_setup_opencl_kernel_types (hashcat_ctx, device_param, kern_type);
+  }
 
-      if (user_options->slow_candidates == true)
-      {
-        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
-      {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules,   size_rules) == -1) return -1;
+  if (rc == -2)
+  {
+    session_device->kernel_create_warnings++;
 
-          if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-          {
-            size_t dummy = 0;
+    return 0;
+  }
 
-            if (hc_cuModuleGetGlobal (hashcat_ctx, &device_param->cuda_d_rules_c, &dummy, device_param->cuda_module, "generic_constant") == -1) return -1;
-          }
-          else
-          {
-            if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
-          }
+  if (rc == -1) return -1;
 
-          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_rules, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_combs,          size_combs)      == -1) return -1;
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_combs_c,        size_combs)      == -1) return -1;
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_markov_css_buf, size_markov_css) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bfs,            size_bfs)        == -1) return -1;
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_markov_css_buf, size_markov_css) == -1) return -1;
+  if (device_param->is_cuda == true)
+  {
+    // zero some data buffers
 
-          if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-          {
-            size_t dummy = 0;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_digests_shown, device_param->size_shown)   == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_result,        device_param->size_results) == -1) return -1;
 
-            if (hc_cuModuleGetGlobal (hashcat_ctx, &device_param->cuda_d_bfs_c, &dummy, device_param->cuda_module, "generic_constant") == -1) return -1;
+    // special buffers
 
-            if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tm_c,           size_tm)       == -1) return -1;
-          }
-          else
-          {
-            if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_bfs_c,          size_bfs)      == -1) return -1;
-            if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tm_c,           size_tm)       == -1) return -1;
-          }
-        }
+    if (user_options->slow_candidates == true)
+    {
+      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
+    }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
       }
-
-      if (size_esalts)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
-        if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_esalt_bufs, size_esalts) == -1) return -1;
-
-        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_esalt_bufs, hashes->esalts_buf, size_esalts) == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_combs,          size_combs)       == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_combs_c,        size_combs)       == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_markov_css_buf, size_markov_css)  == -1) return -1;
       }
-
-      if (hashconfig->st_hash != NULL)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_digests_buf, hashes->st_digests_buf, size_st_digests) == -1) return -1;
-        if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_salts_buf,   hashes->st_salts_buf,   size_st_salts)   == -1) return -1;
-
-        if (size_esalts)
-        {
-          if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_st_esalts_buf, size_st_esalts) == -1) return -1;
-
-          if (hc_cuMemcpyHtoD (hashcat_ctx, device_param->cuda_d_st_esalts_buf, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
-        }
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_bfs,            size_bfs)         == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_bfs_c,          size_bfs)         == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tm_c,           size_tm)          == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_markov_css_buf, size_markov_css)  == -1) return -1;
       }
     }
 
-    if (device_param->is_hip == true)
+    if (user_options->slow_candidates == true)
     {
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_a,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_b,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_c,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s1_d,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_a,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_b,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_c,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bitmap_s2_d,    bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_plain_bufs,     size_plains)             == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_buf,    size_digests)            == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_digests_shown,  size_shown)              == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_salt_bufs,      size_salts)              == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_result,         size_results)            == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra0_buf,     size_extra_buffer1)      == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra1_buf,     size_extra_buffer2)      == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra2_buf,     size_extra_buffer3)      == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_extra3_buf,     size_extra_buffer4)      == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_digests_buf, size_st_digests)         == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_salts_buf,   size_st_salts)           == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_kernel_param,   size_kernel_params)      == -1) return -1;
-
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_a, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_b, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_c, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s1_d, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_a, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_b, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_c, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_bitmap_s2_d, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_digests_buf, hashes->digests_buf,     size_digests)            == -1) return -1;
-      if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_salt_bufs,   hashes->salts_buf,       size_salts)              == -1) return -1;
-
-      /**
-       * special buffers
-       */
-
-      if (user_options->slow_candidates == true)
-      {
-        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
+    }
+    else
+    {
+      if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
       {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules,   size_rules) == -1) return -1;
-
-          if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-          {
-            size_t dummy = 0;
+        // prepare mp
 
-            if (hc_hipModuleGetGlobal (hashcat_ctx, &device_param->hip_d_rules_c, &dummy, device_param->hip_module, "generic_constant") == -1) return -1;
-          }
-          else
-          {
-            if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
-          }
+        if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
+        {
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
 
-          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_rules, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
         }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
         {
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_combs,          size_combs)      == -1) return -1;
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_combs_c,        size_combs)      == -1) return -1;
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_markov_css_buf, size_markov_css) == -1) return -1;
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
         }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bfs,            size_bfs)        == -1) return -1;
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_markov_css_buf, size_markov_css) == -1) return -1;
-
-          if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-          {
-            size_t dummy = 0;
 
-            if (hc_hipModuleGetGlobal (hashcat_ctx, &device_param->hip_d_bfs_c, &dummy, device_param->hip_module, "generic_constant") == -1) return -1;
-
-            if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tm_c,           size_tm)       == -1) return -1;
-          }
-          else
-          {
-            if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_bfs_c,          size_bfs)      == -1) return -1;
-            if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tm_c,           size_tm)       == -1) return -1;
-          }
-        }
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]); if (CL_rc == -1) return -1; }
       }
-
-      if (size_esalts)
+      else if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_esalt_bufs, size_esalts) == -1) return -1;
+        // prepare mp_r and mp_l
 
-        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_esalt_bufs, hashes->esalts_buf, size_esalts) == -1) return -1;
-      }
-
-      if (hashconfig->st_hash != NULL)
-      {
-        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_digests_buf, hashes->st_digests_buf, size_st_digests) == -1) return -1;
-        if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_salts_buf,   hashes->st_salts_buf,   size_st_salts) == -1) return -1;
+        device_param->kernel_params_mp_l_buf32[6] = 0;
+        device_param->kernel_params_mp_l_buf32[7] = 0;
+        device_param->kernel_params_mp_l_buf32[8] = 0;
 
-        if (size_esalts)
-        {
-          if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_st_esalts_buf, size_st_esalts) == -1) return -1;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
 
-          if (hc_hipMemcpyHtoD (hashcat_ctx, device_param->hip_d_st_esalts_buf, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
-        }
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]); if (CL_rc == -1) return -1; }
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]); if (CL_rc == -1) return -1; }
       }
     }
+  }
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_a);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_b);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_c);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_d);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_a);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_b);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer1,      NULL, extra0_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer2,      NULL, extra1_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer3,      NULL, extra2_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_extra_buffer4,      NULL, extra3_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_digests,         NULL, st_digests_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_salts,           NULL, st_salts_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_kernel_params,      NULL, kernel_param);
-
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_a, 0, bitmap_ctx->bitmap_s1_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_b, 0, bitmap_ctx->bitmap_s1_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_c, 0, bitmap_ctx->bitmap_s1_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s1_d, 0, bitmap_ctx->bitmap_s1_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_a, 0, bitmap_ctx->bitmap_s2_a, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_b, 0, bitmap_ctx->bitmap_s2_b, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_c, 0, bitmap_ctx->bitmap_s2_c, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_bitmap_s2_d, 0, bitmap_ctx->bitmap_s2_d, bitmap_ctx->bitmap_size) == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_digests_buf, 0, hashes->digests_buf,     size_digests)            == -1) return -1;
-      if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_salt_bufs,   0, hashes->salts_buf,       size_salts)              == -1) return -1;
+  if (device_param->is_hip == true)
+  {
+    // zero some data buffers
 
-      /**
-       * special buffers
-       */
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_digests_shown, device_param->size_shown)   == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_result,        device_param->size_results) == -1) return -1;
 
-      if (user_options->slow_candidates == true)
+    // special buffers
+
+    if (user_options->slow_candidates == true)
+    {
+      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
+    }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
       {
-        HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules_c,          NULL, rules_c);
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
       }
-      else
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules,          NULL, rules);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_rules_c,        NULL, rules_c);
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_combs,          size_combs)       == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_combs_c,        size_combs)       == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_markov_css_buf, size_markov_css)  == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+      {
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_bfs,            size_bfs)         == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_bfs_c,          size_bfs)         == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tm_c,           size_tm)          == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_markov_css_buf, size_markov_css)  == -1) return -1;
+      }
+    }
 
-          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_rules, 0, straight_ctx->kernel_rules_buf, size_rules_src) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+    if (user_options->slow_candidates == true)
+    {
+    }
+    else
+    {
+      if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
+      {
+        // prepare mp
+
+        if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
         {
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs_c);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
+
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
         }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
         {
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs_c);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_tm,             NULL, tm_c);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
         }
-      }
-
-      if (size_esalts)
-      {
-        HC_MTL_CREATEBUFFER(hashcat_ctx, size_esalts,           NULL, esalt_bufs);
 
-        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_esalt_bufs, 0, hashes->esalts_buf, size_esalts) == -1) return -1;
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]); if (CL_rc == -1) return -1; }
       }
-
-      if (hashconfig->st_hash != NULL)
+      else if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_digests_buf, 0, hashes->st_digests_buf, size_st_digests) == -1) return -1;
-        if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_salts_buf, 0, hashes->st_salts_buf, size_st_salts) == -1) return -1;
+        // prepare mp_r and mp_l
 
-        if (size_esalts)
-        {
-          HC_MTL_CREATEBUFFER(hashcat_ctx, size_st_esalts,      NULL, st_esalts_buf);
+        device_param->kernel_params_mp_l_buf32[6] = 0;
+        device_param->kernel_params_mp_l_buf32[7] = 0;
+        device_param->kernel_params_mp_l_buf32[8] = 0;
 
-          if (hc_mtlMemcpyHtoD (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, device_param->metal_d_st_esalts_buf, 0, hashes->st_esalts_buf, size_st_esalts) == -1) return -1;
-        }
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]); if (CL_rc == -1) return -1; }
+        //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]); if (CL_rc == -1) return -1; }
       }
     }
-    #endif // __APPLE__
+  }
 
-    if (device_param->is_opencl == true)
-    {
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_a);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_b);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_c);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s1_d);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_a);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_b);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_c);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, bitmap_ctx->bitmap_size, NULL, bitmap_s2_d);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_plains,             NULL, plain_bufs);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_digests,            NULL, digests_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_shown,              NULL, digests_shown);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_salts,              NULL, salt_bufs);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_results,            NULL, result);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer1,      NULL, extra0_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer2,      NULL, extra1_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer3,      NULL, extra2_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_extra_buffer4,      NULL, extra3_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_digests,         NULL, st_digests_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_salts,           NULL, st_salts_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_kernel_params,      NULL, kernel_param);
-
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_a, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_a, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_b, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_b, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_c, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_c, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s1_d, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s1_d, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_a, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_a, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_b, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_b, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_c, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_c, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_bitmap_s2_d, CL_TRUE, 0, bitmap_ctx->bitmap_size, bitmap_ctx->bitmap_s2_d, 0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_digests_buf, CL_TRUE, 0, size_digests,            hashes->digests_buf,     0, NULL, NULL) == -1) return -1;
-      if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_salt_bufs,   CL_TRUE, 0, size_salts,              hashes->salts_buf,       0, NULL, NULL) == -1) return -1;
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    // zero some data buffers
 
-      /**
-       * special buffers
-       */
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_digests_shown, device_param->size_shown)   == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_result,        device_param->size_results) == -1) return -1;
 
-      if (user_options->slow_candidates == true)
+    // special buffers
+
+    if (user_options->slow_candidates == true)
+    {
+      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_rules_c, size_rules_c) == -1) return -1;
+    }
+    else
+    {
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
       {
-        HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules_c,          NULL, rules_c);
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_rules_c, size_rules_c) == -1) return -1;
       }
-      else
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
       {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules,          NULL, rules);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_rules_c,        NULL, rules_c);
-
-          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_rules,   CL_TRUE, 0, size_rules_src, straight_ctx->kernel_rules_buf, 0, NULL, NULL) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_combs,          NULL, combs_c);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_bfs,            NULL, bfs_c);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_tm,             NULL, tm_c);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_root_css,       NULL, root_css_buf);
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_markov_css,     NULL, markov_css_buf);
-        }
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_combs,          size_combs)       == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_combs_c,        size_combs)       == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_markov_css_buf, size_markov_css)  == -1) return -1;
       }
-
-      if (size_esalts)
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
       {
-        HC_OCL_CREATEBUFFER(hashcat_ctx, size_esalts,           NULL, esalt_bufs);
-
-        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_esalt_bufs,      CL_TRUE, 0, size_esalts,     hashes->esalts_buf,      0, NULL, NULL) == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_bfs,            size_bfs)         == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_bfs_c,          size_bfs)         == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tm_c,           size_tm)          == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_root_css_buf,   size_root_css)    == -1) return -1;
+        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_markov_css_buf, size_markov_css)  == -1) return -1;
       }
+    }
 
-      if (hashconfig->st_hash != NULL)
+    if (user_options->slow_candidates == true)
+    {
+    }
+    else
+    {
+      if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
       {
-        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_digests_buf,  CL_TRUE, 0, size_st_digests, hashes->st_digests_buf,  0, NULL, NULL) == -1) return -1;
-        if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_salts_buf,    CL_TRUE, 0, size_st_salts,   hashes->st_salts_buf,    0, NULL, NULL) == -1) return -1;
+        // prepare mp
 
-        if (size_esalts)
+        if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
         {
-          HC_OCL_CREATEBUFFER(hashcat_ctx, size_st_esalts,      NULL, st_esalts_buf);
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
 
-          if (hc_clEnqueueWriteBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_st_esalts_buf, CL_TRUE, 0, size_st_esalts,  hashes->st_esalts_buf,   0, NULL, NULL) == -1) return -1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
+        }
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+        {
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
         }
       }
+      else if (user_options->attack_mode == ATTACK_MODE_BF)
+      {
+        // prepare mp_r and mp_l
 
-      if (hc_clFlush (hashcat_ctx, device_param->opencl_command_queue) == -1) return -1;
-    }
+        device_param->kernel_params_mp_l_buf32[6] = 0;
+        device_param->kernel_params_mp_l_buf32[7] = 0;
+        device_param->kernel_params_mp_l_buf32[8] = 0;
 
-    /**
-     * kernel args
-     */
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+      }
+    }
+  }
+  #endif
 
-    device_param->kernel_param.bitmap_mask         = bitmap_ctx->bitmap_mask;
-    device_param->kernel_param.bitmap_shift1       = bitmap_ctx->bitmap_shift1;
-    device_param->kernel_param.bitmap_shift2       = bitmap_ctx->bitmap_shift2;
-    device_param->kernel_param.salt_pos_host       = 0;
-    device_param->kernel_param.loop_pos            = 0;
-    device_param->kernel_param.loop_cnt            = 0;
-    device_param->kernel_param.il_cnt              = 0;
-    device_param->kernel_param.digests_cnt         = 0;
-    device_param->kernel_param.digests_offset_host = 0;
-    device_param->kernel_param.combs_mode          = 0;
-    device_param->kernel_param.salt_repeat         = 0;
-    device_param->kernel_param.combs_mode          = 0;
-    device_param->kernel_param.salt_repeat         = 0;
-    device_param->kernel_param.pws_pos             = 0;
-    device_param->kernel_param.gid_max             = 0;
+  if (device_param->is_opencl == true)
+  {
+    // zero some data buffers
 
-    if (device_param->is_cuda == true)
-    {
-      device_param->kernel_params[ 0] = NULL; // &device_param->cuda_d_pws_buf;
-      device_param->kernel_params[ 1] = &device_param->cuda_d_rules_c;
-      device_param->kernel_params[ 2] = &device_param->cuda_d_combs_c;
-      device_param->kernel_params[ 3] = &device_param->cuda_d_bfs_c;
-      device_param->kernel_params[ 4] = NULL; // &device_param->cuda_d_tmps;
-      device_param->kernel_params[ 5] = NULL; // &device_param->cuda_d_hooks;
-      device_param->kernel_params[ 6] = &device_param->cuda_d_bitmap_s1_a;
-      device_param->kernel_params[ 7] = &device_param->cuda_d_bitmap_s1_b;
-      device_param->kernel_params[ 8] = &device_param->cuda_d_bitmap_s1_c;
-      device_param->kernel_params[ 9] = &device_param->cuda_d_bitmap_s1_d;
-      device_param->kernel_params[10] = &device_param->cuda_d_bitmap_s2_a;
-      device_param->kernel_params[11] = &device_param->cuda_d_bitmap_s2_b;
-      device_param->kernel_params[12] = &device_param->cuda_d_bitmap_s2_c;
-      device_param->kernel_params[13] = &device_param->cuda_d_bitmap_s2_d;
-      device_param->kernel_params[14] = &device_param->cuda_d_plain_bufs;
-      device_param->kernel_params[15] = &device_param->cuda_d_digests_buf;
-      device_param->kernel_params[16] = &device_param->cuda_d_digests_shown;
-      device_param->kernel_params[17] = &device_param->cuda_d_salt_bufs;
-      device_param->kernel_params[18] = &device_param->cuda_d_esalt_bufs;
-      device_param->kernel_params[19] = &device_param->cuda_d_result;
-      device_param->kernel_params[20] = &device_param->cuda_d_extra0_buf;
-      device_param->kernel_params[21] = &device_param->cuda_d_extra1_buf;
-      device_param->kernel_params[22] = &device_param->cuda_d_extra2_buf;
-      device_param->kernel_params[23] = &device_param->cuda_d_extra3_buf;
-      device_param->kernel_params[24] = &device_param->cuda_d_kernel_param;
-    }
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_plain_bufs,    device_param->size_plains)   == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_digests_shown, device_param->size_shown)    == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_result,        device_param->size_results)  == -1) return -1;
 
-    if (device_param->is_hip == true)
-    {
-      device_param->kernel_params[ 0] = NULL; // &device_param->hip_d_pws_buf;
-      device_param->kernel_params[ 1] = &device_param->hip_d_rules_c;
-      device_param->kernel_params[ 2] = &device_param->hip_d_combs_c;
-      device_param->kernel_params[ 3] = &device_param->hip_d_bfs_c;
-      device_param->kernel_params[ 4] = NULL; // &device_param->hip_d_tmps;
-      device_param->kernel_params[ 5] = NULL; // &device_param->hip_d_hooks;
-      device_param->kernel_params[ 6] = &device_param->hip_d_bitmap_s1_a;
-      device_param->kernel_params[ 7] = &device_param->hip_d_bitmap_s1_b;
-      device_param->kernel_params[ 8] = &device_param->hip_d_bitmap_s1_c;
-      device_param->kernel_params[ 9] = &device_param->hip_d_bitmap_s1_d;
-      device_param->kernel_params[10] = &device_param->hip_d_bitmap_s2_a;
-      device_param->kernel_params[11] = &device_param->hip_d_bitmap_s2_b;
-      device_param->kernel_params[12] = &device_param->hip_d_bitmap_s2_c;
-      device_param->kernel_params[13] = &device_param->hip_d_bitmap_s2_d;
-      device_param->kernel_params[14] = &device_param->hip_d_plain_bufs;
-      device_param->kernel_params[15] = &device_param->hip_d_digests_buf;
-      device_param->kernel_params[16] = &device_param->hip_d_digests_shown;
-      device_param->kernel_params[17] = &device_param->hip_d_salt_bufs;
-      device_param->kernel_params[18] = &device_param->hip_d_esalt_bufs;
-      device_param->kernel_params[19] = &device_param->hip_d_result;
-      device_param->kernel_params[20] = &device_param->hip_d_extra0_buf;
-      device_param->kernel_params[21] = &device_param->hip_d_extra1_buf;
-      device_param->kernel_params[22] = &device_param->hip_d_extra2_buf;
-      device_param->kernel_params[23] = &device_param->hip_d_extra3_buf;
-      device_param->kernel_params[24] = &device_param->hip_d_kernel_param;
-    }
+    // special buffers
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
+    if (user_options->slow_candidates == true)
     {
-      device_param->kernel_params[ 0] = NULL; // device_param->metal_d_pws_buf;
-      device_param->kernel_params[ 1] = device_param->metal_d_rules_c.buf_ptr;
-      device_param->kernel_params[ 2] = device_param->metal_d_combs_c.buf_ptr;
-      device_param->kernel_params[ 3] = device_param->metal_d_bfs_c.buf_ptr;
-      device_param->kernel_params[ 4] = NULL; // device_param->metal_d_tmps;
-      device_param->kernel_params[ 5] = NULL; // device_param->metal_d_hooks;
-      device_param->kernel_params[ 6] = device_param->metal_d_bitmap_s1_a.buf_ptr;
-      device_param->kernel_params[ 7] = device_param->metal_d_bitmap_s1_b.buf_ptr;
-      device_param->kernel_params[ 8] = device_param->metal_d_bitmap_s1_c.buf_ptr;
-      device_param->kernel_params[ 9] = device_param->metal_d_bitmap_s1_d.buf_ptr;
-      device_param->kernel_params[10] = device_param->metal_d_bitmap_s2_a.buf_ptr;
-      device_param->kernel_params[11] = device_param->metal_d_bitmap_s2_b.buf_ptr;
-      device_param->kernel_params[12] = device_param->metal_d_bitmap_s2_c.buf_ptr;
-      device_param->kernel_params[13] = device_param->metal_d_bitmap_s2_d.buf_ptr;
-      device_param->kernel_params[14] = device_param->metal_d_plain_bufs.buf_ptr;
-      device_param->kernel_params[15] = device_param->metal_d_digests_buf.buf_ptr;
-      device_param->kernel_params[16] = device_param->metal_d_digests_shown.buf_ptr;
-      device_param->kernel_params[17] = device_param->metal_d_salt_bufs.buf_ptr;
-      device_param->kernel_params[18] = device_param->metal_d_esalt_bufs.buf_ptr;
-      device_param->kernel_params[19] = device_param->metal_d_result.buf_ptr;
-      device_param->kernel_params[20] = device_param->metal_d_extra0_buf.buf_ptr;
-      device_param->kernel_params[21] = device_param->metal_d_extra1_buf.buf_ptr;
-      device_param->kernel_params[22] = device_param->metal_d_extra2_buf.buf_ptr;
-      device_param->kernel_params[23] = device_param->metal_d_extra3_buf.buf_ptr;
-      device_param->kernel_params[24] = device_param->metal_d_kernel_param.buf_ptr;
+      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, size_rules_c) == -1) return -1;
     }
-    #endif // __APPLE__
-
-    if (device_param->is_opencl == true)
+    else
     {
-      device_param->kernel_params[ 0] = NULL; // &device_param->opencl_d_pws_buf;
-      device_param->kernel_params[ 1] = &device_param->opencl_d_rules_c;
-      device_param->kernel_params[ 2] = &device_param->opencl_d_combs_c;
-      device_param->kernel_params[ 3] = &device_param->opencl_d_bfs_c;
-      device_param->kernel_params[ 4] = NULL; // &device_param->opencl_d_tmps;
-      device_param->kernel_params[ 5] = NULL; // &device_param->opencl_d_hooks;
-      device_param->kernel_params[ 6] = &device_param->opencl_d_bitmap_s1_a;
-      device_param->kernel_params[ 7] = &device_param->opencl_d_bitmap_s1_b;
-      device_param->kernel_params[ 8] = &device_param->opencl_d_bitmap_s1_c;
-      device_param->kernel_params[ 9] = &device_param->opencl_d_bitmap_s1_d;
-      device_param->kernel_params[10] = &device_param->opencl_d_bitmap_s2_a;
-      device_param->kernel_params[11] = &device_param->opencl_d_bitmap_s2_b;
-      device_param->kernel_params[12] = &device_param->opencl_d_bitmap_s2_c;
-      device_param->kernel_params[13] = &device_param->opencl_d_bitmap_s2_d;
-      device_param->kernel_params[14] = &device_param->opencl_d_plain_bufs;
-      device_param->kernel_params[15] = &device_param->opencl_d_digests_buf;
-      device_param->kernel_params[16] = &device_param->opencl_d_digests_shown;
-      device_param->kernel_params[17] = &device_param->opencl_d_salt_bufs;
-      device_param->kernel_params[18] = &device_param->opencl_d_esalt_bufs;
-      device_param->kernel_params[19] = &device_param->opencl_d_result;
-      device_param->kernel_params[20] = &device_param->opencl_d_extra0_buf;
-      device_param->kernel_params[21] = &device_param->opencl_d_extra1_buf;
-      device_param->kernel_params[22] = &device_param->opencl_d_extra2_buf;
-      device_param->kernel_params[23] = &device_param->opencl_d_extra3_buf;
-      device_param->kernel_params[24] = &device_param->opencl_d_kernel_param;
+      if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, size_rules_c) == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+      {
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_combs,          size_combs)      == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_combs_c,        size_combs)      == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_markov_css_buf, size_markov_css) == -1) return -1;
+      }
+      else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+      {
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_bfs,            size_bfs)        == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_bfs_c,          size_bfs)        == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tm_c,           size_tm)         == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_root_css_buf,   size_root_css)   == -1) return -1;
+        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_markov_css_buf, size_markov_css) == -1) return -1;
+      }
     }
 
     if (user_options->slow_candidates == true)
@@ -15399,1521 +16601,1181 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
     }
     else
     {
-      device_param->kernel_params_mp_buf64[3] = 0;
-      device_param->kernel_params_mp_buf32[4] = 0;
-      device_param->kernel_params_mp_buf32[5] = 0;
-      device_param->kernel_params_mp_buf32[6] = 0;
-      device_param->kernel_params_mp_buf32[7] = 0;
-      device_param->kernel_params_mp_buf64[8] = 0;
-
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+      if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
       {
-        if (device_param->is_cuda == true)
-        {
-          device_param->kernel_params_mp[0] = &device_param->cuda_d_combs;
-        }
+        // prepare mp
 
-        if (device_param->is_hip == true)
+        if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
         {
-          device_param->kernel_params_mp[0] = &device_param->hip_d_combs;
-        }
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          device_param->kernel_params_mp[0] = device_param->metal_d_combs.buf_ptr;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
+          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
         }
-        #endif
-
-        if (device_param->is_opencl == true)
+        else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
         {
-          device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
+          device_param->kernel_params_mp_buf32[5] = 0;
+          device_param->kernel_params_mp_buf32[6] = 0;
+          device_param->kernel_params_mp_buf32[7] = 0;
         }
+
+        for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]) == -1) return -1; }
       }
-      else
+      else if (user_options->attack_mode == ATTACK_MODE_BF)
       {
-        if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-        {
-          if (device_param->is_cuda == true)
-          {
-            device_param->kernel_params_mp[0] = &device_param->cuda_d_combs;
-          }
-
-          if (device_param->is_hip == true)
-          {
-            device_param->kernel_params_mp[0] = &device_param->hip_d_combs;
-          }
+        // prepare mp_r and mp_l
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            device_param->kernel_params_mp[0] = device_param->metal_d_combs.buf_ptr;
-          }
-          #endif
+        device_param->kernel_params_mp_l_buf32[6] = 0;
+        device_param->kernel_params_mp_l_buf32[7] = 0;
+        device_param->kernel_params_mp_l_buf32[8] = 0;
 
-          if (device_param->is_opencl == true)
-          {
-            device_param->kernel_params_mp[0] = &device_param->opencl_d_combs;
-          }
-        }
-        else
-        {
-          device_param->kernel_params_mp[0] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                    // ? &device_param->opencl_d_pws_buf
-                                                    // : &device_param->opencl_d_pws_amp_buf;
-        }
-      }
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
+        if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
 
-      if (device_param->is_cuda == true)
-      {
-        device_param->kernel_params_mp[1] = &device_param->cuda_d_root_css_buf;
-        device_param->kernel_params_mp[2] = &device_param->cuda_d_markov_css_buf;
+        for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]) == -1) return -1; }
+        for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]) == -1) return -1; }
       }
+    }
+  }
 
-      if (device_param->is_hip == true)
-      {
-        device_param->kernel_params_mp[1] = &device_param->hip_d_root_css_buf;
-        device_param->kernel_params_mp[2] = &device_param->hip_d_markov_css_buf;
-      }
+  u32 threads_per_block = 32;
 
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
-      {
-        device_param->kernel_params_mp[1] = device_param->metal_d_root_css_buf.buf_ptr;
-        device_param->kernel_params_mp[2] = device_param->metal_d_markov_css_buf.buf_ptr;
-      }
-      #endif
+  if (device_param->is_cuda == true)
+  {
+    const int kern_run = find_tuning_function (hashcat_ctx, device_param);
 
-      if (device_param->is_opencl == true)
-      {
-        device_param->kernel_params_mp[1] = &device_param->opencl_d_root_css_buf;
-        device_param->kernel_params_mp[2] = &device_param->opencl_d_markov_css_buf;
-      }
+    CUfunction func = cuda_function_with_id (device_param, kern_run);
 
-      device_param->kernel_params_mp[3] = &device_param->kernel_params_mp_buf64[3];
-      device_param->kernel_params_mp[4] = &device_param->kernel_params_mp_buf32[4];
-      device_param->kernel_params_mp[5] = &device_param->kernel_params_mp_buf32[5];
-      device_param->kernel_params_mp[6] = &device_param->kernel_params_mp_buf32[6];
-      device_param->kernel_params_mp[7] = &device_param->kernel_params_mp_buf32[7];
-      device_param->kernel_params_mp[8] = &device_param->kernel_params_mp_buf64[8];
+    threads_per_block = cuda_query_threads_per_block (hashcat_ctx, func);
 
-      device_param->kernel_params_mp_l_buf64[3] = 0;
-      device_param->kernel_params_mp_l_buf32[4] = 0;
-      device_param->kernel_params_mp_l_buf32[5] = 0;
-      device_param->kernel_params_mp_l_buf32[6] = 0;
-      device_param->kernel_params_mp_l_buf32[7] = 0;
-      device_param->kernel_params_mp_l_buf32[8] = 0;
-      device_param->kernel_params_mp_l_buf64[9] = 0;
+    const u32 num_regs = cuda_query_num_regs (hashcat_ctx, func);
 
-      device_param->kernel_params_mp_l[0] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                  // ? &device_param->opencl_d_pws_buf
-                                                  // : &device_param->opencl_d_pws_amp_buf;
+    if (num_regs)
+    {
+      u32 threads_per_block_with_regs = (floor) ((float) device_param->regsPerBlock / num_regs);
 
-      if (device_param->is_cuda == true)
+      if (threads_per_block_with_regs == 0)
       {
-        device_param->kernel_params_mp_l[1] = &device_param->cuda_d_root_css_buf;
-        device_param->kernel_params_mp_l[2] = &device_param->cuda_d_markov_css_buf;
+        // prevent threads_per_block from resulting in 0 due to a bug on the runtime
+        threads_per_block_with_regs = threads_per_block;
       }
 
-      if (device_param->is_hip == true)
-      {
-        device_param->kernel_params_mp_l[1] = &device_param->hip_d_root_css_buf;
-        device_param->kernel_params_mp_l[2] = &device_param->hip_d_markov_css_buf;
-      }
+      if (threads_per_block_with_regs > device_param->kernel_preferred_wgs_multiple) threads_per_block_with_regs -= threads_per_block_with_regs % device_param->kernel_preferred_wgs_multiple;
 
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
-      {
-        device_param->kernel_params_mp_l[1] = device_param->metal_d_root_css_buf.buf_ptr;
-        device_param->kernel_params_mp_l[2] = device_param->metal_d_markov_css_buf.buf_ptr;
-      }
-      #endif
+      threads_per_block = MIN (threads_per_block, threads_per_block_with_regs);
+    }
+  }
+  else if (device_param->is_hip == true)
+  {
+    const int kern_run = find_tuning_function (hashcat_ctx, device_param);
 
-      if (device_param->is_opencl == true)
-      {
-        device_param->kernel_params_mp_l[1] = &device_param->opencl_d_root_css_buf;
-        device_param->kernel_params_mp_l[2] = &device_param->opencl_d_markov_css_buf;
-      }
+    hipFunction_t func = hip_function_with_id (device_param, kern_run);
 
-      device_param->kernel_params_mp_l[3] = &device_param->kernel_params_mp_l_buf64[3];
-      device_param->kernel_params_mp_l[4] = &device_param->kernel_params_mp_l_buf32[4];
-      device_param->kernel_params_mp_l[5] = &device_param->kernel_params_mp_l_buf32[5];
-      device_param->kernel_params_mp_l[6] = &device_param->kernel_params_mp_l_buf32[6];
-      device_param->kernel_params_mp_l[7] = &device_param->kernel_params_mp_l_buf32[7];
-      device_param->kernel_params_mp_l[8] = &device_param->kernel_params_mp_l_buf32[8];
-      device_param->kernel_params_mp_l[9] = &device_param->kernel_params_mp_l_buf64[9];
+    threads_per_block = hip_query_threads_per_block (hashcat_ctx, func);
 
-      device_param->kernel_params_mp_r_buf64[3] = 0;
-      device_param->kernel_params_mp_r_buf32[4] = 0;
-      device_param->kernel_params_mp_r_buf32[5] = 0;
-      device_param->kernel_params_mp_r_buf32[6] = 0;
-      device_param->kernel_params_mp_r_buf32[7] = 0;
-      device_param->kernel_params_mp_r_buf64[8] = 0;
+    const u32 num_regs = hip_query_num_regs (hashcat_ctx, func);
 
-      if (device_param->is_cuda == true)
-      {
-        device_param->kernel_params_mp_r[0] = &device_param->cuda_d_bfs;
-        device_param->kernel_params_mp_r[1] = &device_param->cuda_d_root_css_buf;
-        device_param->kernel_params_mp_r[2] = &device_param->cuda_d_markov_css_buf;
-      }
+    if (num_regs)
+    {
+      u32 threads_per_block_with_regs = (floor) ((float) device_param->regsPerBlock / num_regs);
 
-      if (device_param->is_hip == true)
+      if (threads_per_block_with_regs == 0)
       {
-        device_param->kernel_params_mp_r[0] = &device_param->hip_d_bfs;
-        device_param->kernel_params_mp_r[1] = &device_param->hip_d_root_css_buf;
-        device_param->kernel_params_mp_r[2] = &device_param->hip_d_markov_css_buf;
+        // https://rocm.docs.amd.com/projects/HIP/en/docs-develop/doxygen/html/bug.html
+        // HIP-Clang always returns 0 for regsPerBlock due to a known bug
+        // prevent threads_per_block from resulting in 0, otherwise hashcat crashes
+        threads_per_block_with_regs = threads_per_block;
       }
 
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
-      {
-        device_param->kernel_params_mp_r[0] = device_param->metal_d_bfs.buf_ptr;
-        device_param->kernel_params_mp_r[1] = device_param->metal_d_root_css_buf.buf_ptr;
-        device_param->kernel_params_mp_r[2] = device_param->metal_d_markov_css_buf.buf_ptr;
-      }
-      #endif
+      if (threads_per_block_with_regs > device_param->kernel_preferred_wgs_multiple) threads_per_block_with_regs -= threads_per_block_with_regs % device_param->kernel_preferred_wgs_multiple;
 
-      if (device_param->is_opencl == true)
-      {
-        device_param->kernel_params_mp_r[0] = &device_param->opencl_d_bfs;
-        device_param->kernel_params_mp_r[1] = &device_param->opencl_d_root_css_buf;
-        device_param->kernel_params_mp_r[2] = &device_param->opencl_d_markov_css_buf;
-      }
+      threads_per_block = MIN (threads_per_block, threads_per_block_with_regs);
+    }
+  }
+  else if (device_param->is_opencl == true)
+  {
+    const int kern_run = find_tuning_function (hashcat_ctx, device_param);
 
-      device_param->kernel_params_mp_r[3] = &device_param->kernel_params_mp_r_buf64[3];
-      device_param->kernel_params_mp_r[4] = &device_param->kernel_params_mp_r_buf32[4];
-      device_param->kernel_params_mp_r[5] = &device_param->kernel_params_mp_r_buf32[5];
-      device_param->kernel_params_mp_r[6] = &device_param->kernel_params_mp_r_buf32[6];
-      device_param->kernel_params_mp_r[7] = &device_param->kernel_params_mp_r_buf32[7];
-      device_param->kernel_params_mp_r[8] = &device_param->kernel_params_mp_r_buf64[8];
+    cl_kernel kernel = opencl_kernel_with_id (device_param, kern_run);
 
-      device_param->kernel_params_amp_buf32[5] = 0; // combs_mode
-      device_param->kernel_params_amp_buf64[6] = 0; // gid_max
+    threads_per_block = opencl_query_threads_per_block (hashcat_ctx, device_param, kernel);
 
-      if (device_param->is_cuda == true)
-      {
-        device_param->kernel_params_amp[0] = NULL; // &device_param->cuda_d_pws_buf;
-        device_param->kernel_params_amp[1] = NULL; // &device_param->cuda_d_pws_amp_buf;
-        device_param->kernel_params_amp[2] = &device_param->cuda_d_rules_c;
-        device_param->kernel_params_amp[3] = &device_param->cuda_d_combs_c;
-        device_param->kernel_params_amp[4] = &device_param->cuda_d_bfs_c;
-      }
+    // num_regs check should be included in opencl's CL_KERNEL_WORK_GROUP_SIZE
+  }
+  else if (device_param->is_metal == true)
+  {
+    threads_per_block = device_param->kernel_preferred_wgs_multiple;
+  }
 
-      if (device_param->is_hip == true)
-      {
-        device_param->kernel_params_amp[0] = NULL; // &device_param->hip_d_pws_buf;
-        device_param->kernel_params_amp[1] = NULL; // &device_param->hip_d_pws_amp_buf;
-        device_param->kernel_params_amp[2] = &device_param->hip_d_rules_c;
-        device_param->kernel_params_amp[3] = &device_param->hip_d_combs_c;
-        device_param->kernel_params_amp[4] = &device_param->hip_d_bfs_c;
-      }
+  if (user_options->kernel_threads_chgd == true)
+  {
+    if (threads_per_block < user_options->kernel_threads)
+    {
+      event_log_warning (hashcat_ctx, "* Device #%u: The requested thread size '%d' exceeds the recommended limit of the backend runtime '%d'.", device_id + 1, user_options->kernel_threads, threads_per_block);
+    }
+  }
 
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
-      {
-        device_param->kernel_params_amp[0] = NULL; // device_param->metal_d_pws_buf;
-        device_param->kernel_params_amp[1] = NULL; // device_param->metal_d_pws_amp_buf;
-        device_param->kernel_params_amp[2] = device_param->metal_d_rules_c.buf_ptr;
-        device_param->kernel_params_amp[3] = device_param->metal_d_combs_c.buf_ptr;
-        device_param->kernel_params_amp[4] = device_param->metal_d_bfs_c.buf_ptr;
-      }
-      #endif
+  if ((threads_per_block >= device_param->kernel_threads_min) && (threads_per_block <= device_param->kernel_threads_max))
+  {
+    //printf ("auto thread max: %d\n", threads_per_block);
+    device_param->kernel_threads_max = threads_per_block;
+  }
 
-      if (device_param->is_opencl == true)
-      {
-        device_param->kernel_params_amp[0] = NULL; // &device_param->opencl_d_pws_buf;
-        device_param->kernel_params_amp[1] = NULL; // &device_param->opencl_d_pws_amp_buf;
-        device_param->kernel_params_amp[2] = &device_param->opencl_d_rules_c;
-        device_param->kernel_params_amp[3] = &device_param->opencl_d_combs_c;
-        device_param->kernel_params_amp[4] = &device_param->opencl_d_bfs_c;
-      }
+  const u32 threads_per_block_p2f = threads_per_block / (threads_per_block & -threads_per_block);
 
-      device_param->kernel_params_amp[5] = &device_param->kernel_params_amp_buf32[5];
-      device_param->kernel_params_amp[6] = &device_param->kernel_params_amp_buf64[6];
+  if ((threads_per_block_p2f >= device_param->kernel_threads_min) && (threads_per_block_p2f <= device_param->kernel_threads_max))
+  {
+    //printf ("auto thread min: %d\n", threads_per_block_p2f);
+    device_param->kernel_threads_min = threads_per_block_p2f;
+  }
 
-      if (device_param->is_cuda == true)
-      {
-        device_param->kernel_params_tm[0] = &device_param->cuda_d_bfs_c;
-        device_param->kernel_params_tm[1] = &device_param->cuda_d_tm_c;
-      }
+  // this is required because inside the kernels there is this:
+  // __local pw_t s_pws[64];
 
-      if (device_param->is_hip == true)
+  if ((user_options->attack_mode == ATTACK_MODE_STRAIGHT)
+   || (user_options->attack_mode == ATTACK_MODE_GENERIC)
+   || (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+   || (user_options->slow_candidates == true))
+  {
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+    {
+      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
       {
-        device_param->kernel_params_tm[0] = &device_param->hip_d_bfs_c;
-        device_param->kernel_params_tm[1] = &device_param->hip_d_tm_c;
+        // not required
       }
-
-      #if defined (__APPLE__)
-      if (device_param->is_metal == true)
+      else
       {
-        device_param->kernel_params_tm[0] = device_param->metal_d_bfs_c.buf_ptr;
-        device_param->kernel_params_tm[1] = device_param->metal_d_tm_c.buf_ptr;
-      }
-      #endif
+        device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, 64);
+        device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
 
-      if (device_param->is_opencl == true)
-      {
-        device_param->kernel_params_tm[0] = &device_param->opencl_d_bfs_c;
-        device_param->kernel_params_tm[1] = &device_param->opencl_d_tm_c;
+        device_param->overtune_unfriendly = true;
       }
     }
+  }
+
+  /**
+   * now everything that depends on threads and accel, basically dynamic workload
+   */
+
+  //    u32 kernel_threads = get_kernel_threads (device_param);
 
-    device_param->kernel_params_memset_buf32[1] = 0; // value
-    device_param->kernel_params_memset_buf64[2] = 0; // gid_max
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+  {
+    // the smaller the kernel_threads the more accurate we can set kernel_accel
+    // in autotune. in this attack mode kernel_power is limited by salts_cnt so we
+    // do not have a lot of options left.
 
-    device_param->kernel_params_memset[0] = NULL;
-    device_param->kernel_params_memset[1] = &device_param->kernel_params_memset_buf32[1];
-    device_param->kernel_params_memset[2] = &device_param->kernel_params_memset_buf64[2];
+    device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, 64);
+    device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
 
-    device_param->kernel_params_bzero_buf64[1] = 0; // gid_max
+    device_param->overtune_unfriendly = true;
+  }
 
-    device_param->kernel_params_bzero[0] = NULL;
-    device_param->kernel_params_bzero[1] = &device_param->kernel_params_bzero_buf64[1];
+  device_param->kernel_threads = 0;
+  device_param->kernel_accel = 0;
 
-    device_param->kernel_params_atinit_buf64[1] = 0; // gid_max
+  u32 kernel_threads_min = device_param->kernel_threads_min;
+  u32 kernel_threads_max = device_param->kernel_threads_max;
 
-    device_param->kernel_params_atinit[0] = NULL;
-    device_param->kernel_params_atinit[1] = &device_param->kernel_params_atinit_buf64[1];
+  u32 kernel_accel_min = device_param->kernel_accel_min;
+  u32 kernel_accel_max = device_param->kernel_accel_max;
 
-    device_param->kernel_params_utf8toutf16le_buf64[1] = 0; // gid_max
+  // check if there's enough host memory left for upcoming allocations, otherwise reduce skip device and present user an option to deal with
 
-    device_param->kernel_params_utf8toutf16le[0] = NULL;
-    device_param->kernel_params_utf8toutf16le[1] = &device_param->kernel_params_utf8toutf16le_buf64[1];
+  u64 accel_limit_host = 0;
 
-    device_param->kernel_params_decompress_buf64[3] = 0; // gid_max
+  if (get_free_memory (&accel_limit_host) == false)
+  {
+    const u64 GiB4 = 4ULL * 1024 * 1024 * 1024;
 
-    if (device_param->is_cuda == true)
-    {
-      device_param->kernel_params_decompress[0] = NULL; // &device_param->cuda_d_pws_idx;
-      device_param->kernel_params_decompress[1] = NULL; // &device_param->cuda_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                        // ? &device_param->cuda_d_pws_buf
-                                                        // : &device_param->cuda_d_pws_amp_buf;
-    }
+    hc_thread_mutex_lock (backend_ctx->mux_session_warning);
 
-    if (device_param->is_hip == true)
+    if (backend_ctx->free_memory_warning == false)
     {
-      device_param->kernel_params_decompress[0] = NULL; // &device_param->hip_d_pws_idx;
-      device_param->kernel_params_decompress[1] = NULL; // &device_param->hip_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                        // ? &device_param->hip_d_pws_buf
-                                                        // : &device_param->hip_d_pws_amp_buf;
+      backend_ctx->free_memory_warning = true;
+
+      event_log_warning (hashcat_ctx, "Couldn't query the OS for free memory, assuming 4GiB is available per compute device");
     }
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
+    hc_thread_mutex_unlock (backend_ctx->mux_session_warning);
+
+    accel_limit_host = GiB4;
+  }
+  else
+  {
+    if (user_options->backend_devices_keepfree)
     {
-      device_param->kernel_params_decompress[0] = NULL; // device_param->metal_d_pws_idx;
-      device_param->kernel_params_decompress[1] = NULL; // device_param->metal_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                        // ? device_param->metal_d_pws_buf
-                                                        // : device_param->metal_d_pws_amp_buf;
+      accel_limit_host = ((u64) accel_limit_host * (100 - user_options->backend_devices_keepfree)) / 100;
     }
-    #endif
-
-    if (device_param->is_opencl == true)
+    else
     {
-      device_param->kernel_params_decompress[0] = NULL; // &device_param->opencl_d_pws_idx;
-      device_param->kernel_params_decompress[1] = NULL; // &device_param->opencl_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = NULL; // (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                        // ? &device_param->opencl_d_pws_buf
-                                                        // : &device_param->opencl_d_pws_amp_buf;
+      accel_limit_host = accel_limit_host - (accel_limit_host * 0.34);
     }
 
-    device_param->kernel_params_decompress[3] = &device_param->kernel_params_decompress_buf64[3];
+    accel_limit_host /= backend_ctx->backend_devices_active;
 
-    /**
-     * kernel name
-     */
+    // even tho let's not be greedy
 
-    int rc = -1;
+    const u64 GiB8 = 8ULL * 1024 * 1024 * 1024;
 
-    if (device_param->is_cuda == true)
-    {
-      rc = backend_session_setup_cuda_kernel_types (hashcat_ctx, device_param, kern_type);
-    }
+    accel_limit_host = MIN (accel_limit_host, GiB8);
+  }
 
-    if (device_param->is_hip == true)
-    {
-      rc = backend_session_setup_hip_kernel_types (hashcat_ctx, device_param, kern_type);
-    }
+  // Opposite direction check: find out if we would request too much memory on memory blocks which are based on kernel_accel
+
+  u64 size_pws      = 4;
+  u64 size_pws_amp  = 4;
+  u64 size_pws_comp = 4;
+  u64 size_pws_idx  = 4;
+  u64 size_pws_pre  = 4;
+  u64 size_pws_base = 4;
+  u64 size_tmps     = 4;
+  u64 size_hooks    = 4;
+  #ifdef WITH_BRAIN
+  u64 size_brain_link_in  = 4;
+  u64 size_brain_link_out = 4;
+  #endif
+
+  u32 local_size_bytes = 0;
 
+  if ((device_param->is_cuda == true) || (device_param->is_hip == true) || (device_param->is_opencl == true))
+  {
+    if (device_param->is_cuda   == true) local_size_bytes = cuda_query_max_local_size_bytes   (hashcat_ctx, device_param);
+    if (device_param->is_hip    == true) local_size_bytes = hip_query_max_local_size_bytes    (hashcat_ctx, device_param);
+    if (device_param->is_opencl == true) local_size_bytes = opencl_query_max_local_size_bytes (hashcat_ctx, device_param);
     #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      rc = backend_session_setup_metal_kernel_types (hashcat_ctx, device_param, kern_type);
-    }
+    if (device_param->is_metal  == true) local_size_bytes = metal_query_max_local_size_bytes  (hashcat_ctx, device_param);
     #endif
+  }
 
-    if (device_param->is_opencl == true)
-    {
-      rc = backend_session_setup_opencl_kernel_types (hashcat_ctx, device_param, kern_type);
-    }
-
-    if (rc == -2)
-    {
-      backend_kernel_create_warnings++;
+  const u64 size_device_extra1234 = size_extra_buffer1 + size_extra_buffer2 + size_extra_buffer3 + size_extra_buffer4;
 
-      continue;
-    }
+  // Still not 100% sure about the 64MiB here
 
-    if (rc == -1) return -1;
+  const u64 size_device_extra = MAX ((64ULL * 1024 * 1024), size_device_extra1234);
 
-    if (device_param->is_cuda == true)
-    {
-      // zero some data buffers
+  // we will first decrease accel and when reached that limit, we will decrease threads
+  // when we decrease limit this will restore accel_max
 
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_digests_shown, device_param->size_shown)   == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_result,        device_param->size_results) == -1) return -1;
+  int memory_limit_hit = 0;
 
-      // special buffers
+  const u32 kernel_accel_max_sav = kernel_accel_max;
 
-      if (user_options->slow_candidates == true)
-      {
-        if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
-      {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_rules_c, size_rules_c) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_combs,          size_combs)       == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_combs_c,        size_combs)       == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_markov_css_buf, size_markov_css)  == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_bfs,            size_bfs)         == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_bfs_c,          size_bfs)         == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tm_c,           size_tm)          == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_markov_css_buf, size_markov_css)  == -1) return -1;
-        }
-      }
+  while ((kernel_accel_max >= kernel_accel_min) || (kernel_threads_max >= kernel_threads_min))
+  {
+    const u64 device_processors = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors);
+    const u64 kernel_threads    = ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : kernel_threads_max);
 
-      if (user_options->slow_candidates == true)
-      {
-      }
-      else
-      {
-        if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          // prepare mp
+    const u64 kernel_power_max = device_processors * kernel_threads * kernel_accel_max;
 
-          if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
-          }
-          else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-          }
+    // size_spilling
 
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]); if (CL_rc == -1) return -1; }
-        }
-        else if (user_options->attack_mode == ATTACK_MODE_BF)
-        {
-          // prepare mp_r and mp_l
+    const u64 size_spilling = kernel_power_max * local_size_bytes;
 
-          device_param->kernel_params_mp_l_buf32[6] = 0;
-          device_param->kernel_params_mp_l_buf32[7] = 0;
-          device_param->kernel_params_mp_l_buf32[8] = 0;
+    // size_pws
 
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+    size_pws = kernel_power_max * sizeof (pw_t);
 
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]); if (CL_rc == -1) return -1; }
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]); if (CL_rc == -1) return -1; }
-        }
-      }
-    }
+    size_pws_amp = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL) ? 1 : size_pws;
 
-    if (device_param->is_hip == true)
-    {
-      // zero some data buffers
+    // size_pws_comp
 
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_digests_shown, device_param->size_shown)   == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_result,        device_param->size_results) == -1) return -1;
+    size_pws_comp = kernel_power_max * (sizeof (u32) * 64);
 
-      // special buffers
+    // size_pws_idx
 
-      if (user_options->slow_candidates == true)
-      {
-        if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
-      {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_rules_c, size_rules_c) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_combs,          size_combs)       == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_combs_c,        size_combs)       == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_markov_css_buf, size_markov_css)  == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_bfs,            size_bfs)         == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_bfs_c,          size_bfs)         == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tm_c,           size_tm)          == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_markov_css_buf, size_markov_css)  == -1) return -1;
-        }
-      }
+    size_pws_idx = (kernel_power_max + 1) * sizeof (pw_idx_t);
 
-      if (user_options->slow_candidates == true)
-      {
-      }
-      else
-      {
-        if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          // prepare mp
+    // size_tmps
 
-          if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
-          }
-          else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-          }
+    size_tmps = kernel_power_max * hashconfig->tmp_size;
 
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]); if (CL_rc == -1) return -1; }
-        }
-        else if (user_options->attack_mode == ATTACK_MODE_BF)
-        {
-          // prepare mp_r and mp_l
+    // size_hooks
 
-          device_param->kernel_params_mp_l_buf32[6] = 0;
-          device_param->kernel_params_mp_l_buf32[7] = 0;
-          device_param->kernel_params_mp_l_buf32[8] = 0;
+    size_hooks = kernel_power_max * hashconfig->hook_size;
 
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+    #ifdef WITH_BRAIN
+    // size_brains
 
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]); if (CL_rc == -1) return -1; }
-          //for (u32 i = 0; i < 3; i++) { CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]); if (CL_rc == -1) return -1; }
-        }
-      }
-    }
+    size_brain_link_in  = kernel_power_max * 1;
+    size_brain_link_out = kernel_power_max * 8;
+    #endif
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
+    if (user_options->slow_candidates == true)
     {
-      // zero some data buffers
+      // size_pws_pre
+
+      size_pws_pre = kernel_power_max * sizeof (pw_pre_t);
+
+      // size_pws_base
+
+      size_pws_base = kernel_power_max * sizeof (pw_pre_t);
+    }
+
+    // now check if all device-memory sizes which depend on the kernel_accel_max amplifier are within its boundaries
+    // if not, decrease amplifier and try again
+
+    memory_limit_hit = 0;
+
+    // sometimes device_available_mem and device_maxmem_alloc reported back from the opencl runtime are a bit inaccurate.
+    // let's add some extra space just to be sure.
+    // now depends on the kernel-accel value (where scrypt and similar benefits), but also hard minimum 64mb and maximum 1024mb limit
+    // let's see if we still need this now that we have low-level API to report free memory
+    // we don't want these get too big. if a plugin requires really a lot of memory, the extra buffer should be used instead.
+
+    if (size_pws   > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
+    if (size_tmps  > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
+    if (size_hooks > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
+
+    // work around, for some reason apple opencl can't have buffers larger 2^31
+    // typically runs into trap 6
+    // maybe 32/64 bit problem affecting size_t?
+    // this is really ugly, and still in place 2025/06/09
+    //  Version.: OpenCL 1.2 (Apr 18 2025 21:45:30)
+    //  Driver.Version.: 1.2 (Apr 22 2025 20:11:41)
+
+    if ((device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE) && (device_param->is_metal == false))
+    {
+      const size_t undocumented_single_allocation_apple = 0x7fffffff;
+
+      if (bitmap_ctx->bitmap_size > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_bfs                > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_combs              > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_digests            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_esalts             > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_hooks              > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_markov_css         > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_plains             > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_pws                > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_pws_amp            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_pws_comp           > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_pws_idx            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_results            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_root_css           > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_rules              > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_rules_c            > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_salts              > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_extra_buffer1      > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_extra_buffer2      > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_extra_buffer3      > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_extra_buffer4      > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_shown              > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_tm                 > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_tmps               > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_st_digests         > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_st_salts           > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_st_esalts          > undocumented_single_allocation_apple) memory_limit_hit = 1;
+      if (size_kernel_params      > undocumented_single_allocation_apple) memory_limit_hit = 1;
+    }
+
+    const u64 size_total
+      = bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + bitmap_ctx->bitmap_size
+      + size_bfs
+      + size_combs
+      + size_digests
+      + size_esalts
+      + size_hooks
+      + size_markov_css
+      + size_plains
+      + size_pws
+      + size_pws_amp
+      + size_pws_comp
+      + size_pws_idx
+      + size_results
+      + size_root_css
+      + size_rules
+      + size_rules_c
+      + size_salts
+      + size_device_extra
+      + size_shown
+      + size_tm
+      + size_tmps
+      + size_st_digests
+      + size_st_salts
+      + size_st_esalts
+      + size_kernel_params
+      + size_spilling;
 
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_plain_bufs,    device_param->size_plains)  == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_digests_shown, device_param->size_shown)   == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_result,        device_param->size_results) == -1) return -1;
+    if (size_total > device_param->device_available_mem) memory_limit_hit = 1;
 
-      // special buffers
+    const u64 size_host_extra = (512 * 1024 * 1024) / backend_ctx->backend_devices_active;
 
-      if (user_options->slow_candidates == true)
-      {
-        if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
+    const u64 size_total_host
+      = size_pws_comp
+      + size_pws_idx
+      + size_hooks
+      #ifdef WITH_BRAIN
+      + size_brain_link_in
+      + size_brain_link_out
+      #endif
+      + size_pws_pre
+      + size_pws_base
+      + size_host_extra;
+
+    if (size_total_host > accel_limit_host) memory_limit_hit = 1;
+
+    //printf ("%zu %zu %d %d\n", size_total, device_param->device_available_mem, kernel_accel_max, kernel_threads_max);
+
+    if (memory_limit_hit == 1)
+    {
+      if (kernel_accel_max == kernel_accel_min)
       {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_rules_c, size_rules_c) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
+        if ((kernel_threads_max > kernel_threads_min) && (kernel_threads_max >= (device_param->kernel_preferred_wgs_multiple * 2)))
         {
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_combs,          size_combs)       == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_combs_c,        size_combs)       == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_markov_css_buf, size_markov_css)  == -1) return -1;
+          kernel_threads_max -= device_param->kernel_preferred_wgs_multiple;
+
+          kernel_accel_max = kernel_accel_max_sav;
         }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
+        else
         {
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_bfs,            size_bfs)         == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_bfs_c,          size_bfs)         == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tm_c,           size_tm)          == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_root_css_buf,   size_root_css)    == -1) return -1;
-          if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_markov_css_buf, size_markov_css)  == -1) return -1;
+          break;
         }
       }
-
-      if (user_options->slow_candidates == true)
-      {
-      }
       else
       {
-        if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          // prepare mp
-
-          if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
-          }
-          else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-          }
-        }
-        else if (user_options->attack_mode == ATTACK_MODE_BF)
-        {
-          // prepare mp_r and mp_l
-
-          device_param->kernel_params_mp_l_buf32[6] = 0;
-          device_param->kernel_params_mp_l_buf32[7] = 0;
-          device_param->kernel_params_mp_l_buf32[8] = 0;
-
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
-        }
+        kernel_accel_max--;
       }
+
+      continue;
     }
-    #endif
 
-    if (device_param->is_opencl == true)
-    {
-      // zero some data buffers
+    session_device->size_total_host += size_total_host;
 
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_plain_bufs,    device_param->size_plains)   == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_digests_shown, device_param->size_shown)    == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_result,        device_param->size_results)  == -1) return -1;
+    break;
+  }
 
-      // special buffers
+  if (memory_limit_hit == 1)
+  {
+    event_log_error (hashcat_ctx, "* Device #%u: Not enough allocatable device memory or free host memory for mapping.", device_id + 1);
 
-      if (user_options->slow_candidates == true)
-      {
-        if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, size_rules_c) == -1) return -1;
-      }
-      else
-      {
-        if (user_options_extra->attack_kern == ATTACK_KERN_STRAIGHT)
-        {
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_rules_c, size_rules_c) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_COMBI)
-        {
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_combs,          size_combs)      == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_combs_c,        size_combs)      == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_markov_css_buf, size_markov_css) == -1) return -1;
-        }
-        else if (user_options_extra->attack_kern == ATTACK_KERN_BF)
-        {
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_bfs,            size_bfs)        == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_bfs_c,          size_bfs)        == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tm_c,           size_tm)         == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_root_css_buf,   size_root_css)   == -1) return -1;
-          if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_markov_css_buf, size_markov_css) == -1) return -1;
-        }
-      }
+    session_device->memory_hit_warnings++;
 
-      if (user_options->slow_candidates == true)
-      {
-      }
-      else
-      {
-        if ((user_options->attack_mode == ATTACK_MODE_HYBRID1) || (user_options->attack_mode == ATTACK_MODE_HYBRID2))
-        {
-          // prepare mp
+    device_param->skipped_warning = true;
 
-          if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_buf32[5] = full01;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_buf32[5] = full06;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_buf32[5] = full80;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_buf32[6] = 1;
-            if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_buf32[7] = 1;
-          }
-          else if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-          {
-            device_param->kernel_params_mp_buf32[5] = 0;
-            device_param->kernel_params_mp_buf32[6] = 0;
-            device_param->kernel_params_mp_buf32[7] = 0;
-          }
+    return 0;
+  }
 
-          for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, i, sizeof (cl_mem), device_param->kernel_params_mp[i]) == -1) return -1; }
-        }
-        else if (user_options->attack_mode == ATTACK_MODE_BF)
-        {
-          // prepare mp_r and mp_l
+  // similar process for association attack
+  // there's no need to have a device_power > salts_cnt since salt_pos is set to GID in kernel
 
-          device_param->kernel_params_mp_l_buf32[6] = 0;
-          device_param->kernel_params_mp_l_buf32[7] = 0;
-          device_param->kernel_params_mp_l_buf32[8] = 0;
+  if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+  {
+    while (kernel_accel_max > kernel_accel_min)
+    {
+      const u64 kernel_power_max = device_param->device_processors * kernel_accel_max;
 
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD01)     device_param->kernel_params_mp_l_buf32[6] = full01;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD06)     device_param->kernel_params_mp_l_buf32[6] = full06;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADD80)     device_param->kernel_params_mp_l_buf32[6] = full80;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS14) device_param->kernel_params_mp_l_buf32[7] = 1;
-          if (hashconfig->opts_type & OPTS_TYPE_PT_ADDBITS15) device_param->kernel_params_mp_l_buf32[8] = 1;
+      if (kernel_power_max > hashes->salts_cnt)
+      {
+        kernel_accel_max--;
 
-          for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, i, sizeof (cl_mem), device_param->kernel_params_mp_l[i]) == -1) return -1; }
-          for (u32 i = 0; i < 3; i++) { if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_r, i, sizeof (cl_mem), device_param->kernel_params_mp_r[i]) == -1) return -1; }
-        }
+        continue;
       }
+
+      break;
     }
+  }
 
-    u32 threads_per_block = 32;
+  device_param->kernel_threads_min = kernel_threads_min;
+  device_param->kernel_threads_max = kernel_threads_max;
+
+  const u32 hardware_power_max = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors)
+                               * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param->kernel_threads_max);
+
+  device_param->kernel_accel_min = kernel_accel_min;
+  device_param->kernel_accel_max = kernel_accel_max;
+
+  device_param->size_pws      = size_pws;
+  device_param->size_pws_amp  = size_pws_amp;
+  device_param->size_pws_comp = size_pws_comp;
+  device_param->size_pws_idx  = size_pws_idx;
+  device_param->size_pws_pre  = size_pws_pre;
+  device_param->size_pws_base = size_pws_base;
+  device_param->size_tmps     = size_tmps;
+  device_param->size_hooks    = size_hooks;
+  #ifdef WITH_BRAIN
+  device_param->size_brain_link_in  = size_brain_link_in;
+  device_param->size_brain_link_out = size_brain_link_out;
+  #endif
 
-    if (device_param->is_cuda == true)
-    {
-      const int kern_run = find_tuning_function (hashcat_ctx, device_param);
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_buf,      size_pws)      == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_amp_buf,  size_pws_amp)  == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_comp_buf, size_pws_comp) == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_idx,      size_pws_idx)  == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tmps,         size_tmps)     == -1) return -1;
+    if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_hooks,        size_hooks)    == -1) return -1;
+
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_buf,       device_param->size_pws)      == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tmps,          device_param->size_tmps)     == -1) return -1;
+    if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_hooks,         device_param->size_hooks)    == -1) return -1;
+  }
 
-      CUfunction func = cuda_function_with_id (device_param, kern_run);
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_buf,      size_pws)      == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_amp_buf,  size_pws_amp)  == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_comp_buf, size_pws_comp) == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_idx,      size_pws_idx)  == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tmps,         size_tmps)     == -1) return -1;
+    if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_hooks,        size_hooks)    == -1) return -1;
+
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_buf,       device_param->size_pws)      == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tmps,          device_param->size_tmps)     == -1) return -1;
+    if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_hooks,         device_param->size_hooks)    == -1) return -1;
+  }
 
-      threads_per_block = cuda_query_threads_per_block (hashcat_ctx, func);
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws,      NULL, pws_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_amp,  NULL, pws_amp_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_comp, NULL, pws_comp_buf);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_idx,  NULL, pws_idx);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_tmps,     NULL, tmps);
+    HC_MTL_CREATEBUFFER(hashcat_ctx, size_hooks,    NULL, hooks);
+
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_buf,       device_param->size_pws)      == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tmps,          device_param->size_tmps)     == -1) return -1;
+    if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_hooks,         device_param->size_hooks)    == -1) return -1;
+  }
+  #endif
 
-      const u32 num_regs = cuda_query_num_regs (hashcat_ctx, func);
+  if (device_param->is_opencl == true)
+  {
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws,      NULL, pws_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_amp,  NULL, pws_amp_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_comp, NULL, pws_comp_buf);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_idx,  NULL, pws_idx);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_tmps,     NULL, tmps);
+    HC_OCL_CREATEBUFFER(hashcat_ctx, size_hooks,    NULL, hooks);
+
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_buf,       device_param->size_pws)      == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tmps,          device_param->size_tmps)     == -1) return -1;
+    if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_hooks,         device_param->size_hooks)    == -1) return -1;
+  }
 
-      if (num_regs)
-      {
-        u32 threads_per_block_with_regs = (floor) ((float) device_param->regsPerBlock / num_regs);
+  /**
+   * main host data
+   */
 
-        if (threads_per_block_with_regs == 0)
-        {
-          // prevent threads_per_block from resulting in 0 due to a bug on the runtime
-          threads_per_block_with_regs = threads_per_block;
-        }
+  if (hashconfig->bridge_type)
+  {
+    void *h_tmps = hcmalloc_bridge_aligned (device_param->size_tmps, 64);
 
-        if (threads_per_block_with_regs > device_param->kernel_preferred_wgs_multiple) threads_per_block_with_regs -= threads_per_block_with_regs % device_param->kernel_preferred_wgs_multiple;
+    device_param->h_tmps = h_tmps;
+  }
 
-        threads_per_block = MIN (threads_per_block, threads_per_block_with_regs);
-      }
-    }
-    else if (device_param->is_hip == true)
-    {
-      const int kern_run = find_tuning_function (hashcat_ctx, device_param);
+  if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_INIT)
+  {
+    pw_t *h_pws = (pw_t *) hcmalloc_bridge_aligned (device_param->size_pws, 64);
 
-      hipFunction_t func = hip_function_with_id (device_param, kern_run);
+    device_param->h_pws = h_pws;
+  }
 
-      threads_per_block = hip_query_threads_per_block (hashcat_ctx, func);
+  if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_COMP)
+  {
+    plain_t *h_plain_bufs = (plain_t *) hcmalloc (device_param->size_plains);
 
-      const u32 num_regs = hip_query_num_regs (hashcat_ctx, func);
+    device_param->h_plain_bufs = h_plain_bufs;
+    device_param->h_result     = 0;
+  }
 
-      if (num_regs)
-      {
-        u32 threads_per_block_with_regs = (floor) ((float) device_param->regsPerBlock / num_regs);
+  pws_host_alloc (hashcat_ctx, device_param);
 
-        if (threads_per_block_with_regs == 0)
-        {
-          // https://rocm.docs.amd.com/projects/HIP/en/docs-develop/doxygen/html/bug.html
-          // HIP-Clang always returns 0 for regsPerBlock due to a known bug
-          // prevent threads_per_block from resulting in 0, otherwise hashcat crashes
-          threads_per_block_with_regs = threads_per_block;
-        }
+  // 64-byte aligned, the hook pool hands out chunks on cache line boundaries
 
-        if (threads_per_block_with_regs > device_param->kernel_preferred_wgs_multiple) threads_per_block_with_regs -= threads_per_block_with_regs % device_param->kernel_preferred_wgs_multiple;
+  void *hooks_buf = hcmalloc_bridge_aligned (size_hooks, 64);
 
-        threads_per_block = MIN (threads_per_block, threads_per_block_with_regs);
-      }
-    }
-    else if (device_param->is_opencl == true)
-    {
-      const int kern_run = find_tuning_function (hashcat_ctx, device_param);
+  memset (hooks_buf, 0, size_hooks);
 
-      cl_kernel kernel = opencl_kernel_with_id (device_param, kern_run);
+  device_param->hooks_buf = hooks_buf;
 
-      threads_per_block = opencl_query_threads_per_block (hashcat_ctx, device_param, kernel);
+  char *scratch_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
 
-      // num_regs check should be included in opencl's CL_KERNEL_WORK_GROUP_SIZE
-    }
-    else if (device_param->is_metal == true)
-    {
-      threads_per_block = device_param->kernel_preferred_wgs_multiple;
-    }
+  device_param->scratch_buf = scratch_buf;
 
-    if (user_options->kernel_threads_chgd == true)
-    {
-      if (threads_per_block < user_options->kernel_threads)
-      {
-        event_log_warning (hashcat_ctx, "* Device #%u: The requested thread size '%d' exceeds the recommended limit of the backend runtime '%d'.", device_id + 1, user_options->kernel_threads, threads_per_block);
-      }
-    }
+  #ifdef WITH_BRAIN
+  u8 *brain_link_in_buf = (u8 *) hcmalloc (size_brain_link_in);
 
-    if ((threads_per_block >= device_param->kernel_threads_min) && (threads_per_block <= device_param->kernel_threads_max))
-    {
-      //printf ("auto thread max: %d\n", threads_per_block);
-      device_param->kernel_threads_max = threads_per_block;
-    }
+  device_param->brain_link_in_buf = brain_link_in_buf;
 
-    const u32 threads_per_block_p2f = threads_per_block / (threads_per_block & -threads_per_block);
+  u32 *brain_link_out_buf = (u32 *) hcmalloc (size_brain_link_out);
 
-    if ((threads_per_block_p2f >= device_param->kernel_threads_min) && (threads_per_block_p2f <= device_param->kernel_threads_max))
-    {
-      //printf ("auto thread min: %d\n", threads_per_block_p2f);
-      device_param->kernel_threads_min = threads_per_block_p2f;
-    }
+  device_param->brain_link_out_buf = brain_link_out_buf;
+  #endif
 
-    // this is required because inside the kernels there is this:
-    // __local pw_t s_pws[64];
+  pw_pre_t *pws_pre_buf = (pw_pre_t *) hcmalloc (size_pws_pre);
 
-    if ((user_options->attack_mode == ATTACK_MODE_STRAIGHT)
-     || (user_options->attack_mode == ATTACK_MODE_GENERIC)
-     || (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-     || (user_options->slow_candidates == true))
-    {
-      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-      {
-        if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
-        {
-          // not required
-        }
-        else
-        {
-          device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, 64);
-          device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
+  device_param->pws_pre_buf = pws_pre_buf;
 
-          device_param->overtune_unfriendly = true;
-        }
-      }
-    }
+  pw_pre_t *pws_base_buf = (pw_pre_t *) hcmalloc (size_pws_base);
 
-    /**
-     * now everything that depends on threads and accel, basically dynamic workload
-     */
+  device_param->pws_base_buf = pws_base_buf;
 
-    //    u32 kernel_threads = get_kernel_threads (device_param);
+  /**
+   * kernel args
+   */
 
-    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
-    {
-      // the smaller the kernel_threads the more accurate we can set kernel_accel
-      // in autotune. in this attack mode kernel_power is limited by salts_cnt so we
-      // do not have a lot of options left.
+  if (device_param->is_cuda == true)
+  {
+    device_param->kernel_params[ 0] = &device_param->cuda_d_pws_buf;
+    device_param->kernel_params[ 4] = &device_param->cuda_d_tmps;
+    device_param->kernel_params[ 5] = &device_param->cuda_d_hooks;
+  }
 
-      device_param->kernel_threads_min = MIN (device_param->kernel_threads_min, 64);
-      device_param->kernel_threads_max = MIN (device_param->kernel_threads_max, 64);
+  if (device_param->is_hip == true)
+  {
+    device_param->kernel_params[ 0] = &device_param->hip_d_pws_buf;
+    device_param->kernel_params[ 4] = &device_param->hip_d_tmps;
+    device_param->kernel_params[ 5] = &device_param->hip_d_hooks;
+  }
 
-      device_param->overtune_unfriendly = true;
-    }
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    device_param->kernel_params[ 0] = device_param->metal_d_pws_buf.buf_ptr;
+    device_param->kernel_params[ 4] = device_param->metal_d_tmps.buf_ptr;
+    device_param->kernel_params[ 5] = device_param->metal_d_hooks.buf_ptr;
+  }
+  #endif
 
-    device_param->kernel_threads = 0;
-    device_param->kernel_accel = 0;
+  if (device_param->is_opencl == true)
+  {
+    device_param->kernel_params[ 0] = &device_param->opencl_d_pws_buf;
+    device_param->kernel_params[ 4] = &device_param->opencl_d_tmps;
+    device_param->kernel_params[ 5] = &device_param->opencl_d_hooks;
+  }
 
-    u32 kernel_threads_min = device_param->kernel_threads_min;
-    u32 kernel_threads_max = device_param->kernel_threads_max;
+  if (user_options->slow_candidates == true)
+  {
+  }
+  else
+  {
+    if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
+    {
+      // nothing to do
+    }
+    else
+    {
+      if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
+      {
+        if (device_param->is_cuda == true)
+        {
+          device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->cuda_d_pws_buf
+                                            : &device_param->cuda_d_pws_amp_buf;
 
-    u32 kernel_accel_min = device_param->kernel_accel_min;
-    u32 kernel_accel_max = device_param->kernel_accel_max;
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]); if (CL_rc == -1) return -1;
+        }
 
-    // check if there's enough host memory left for upcoming allocations, otherwise reduce skip device and present user an option to deal with
+        if (device_param->is_hip == true)
+        {
+          device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->hip_d_pws_buf
+                                            : &device_param->hip_d_pws_amp_buf;
 
-    u64 accel_limit_host = 0;
+          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]); if (CL_rc == -1) return -1;
+        }
 
-    if (get_free_memory (&accel_limit_host) == false)
-    {
-      const u64 GiB4 = 4ULL * 1024 * 1024 * 1024;
+        #if defined (__APPLE__)
+        if (device_param->is_metal == true)
+        {
+          device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? device_param->metal_d_pws_buf.buf_ptr
+                                            : device_param->metal_d_pws_amp_buf.buf_ptr;
+        }
+        #endif
 
-      event_log_warning (hashcat_ctx, "Couldn't query the OS for free memory, assuming 4GiB is available per compute device");
+        if (device_param->is_opencl == true)
+        {
+          device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->opencl_d_pws_buf
+                                            : &device_param->opencl_d_pws_amp_buf;
 
-      accel_limit_host = GiB4;
+          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]) == -1) return -1;
+        }
+      }
     }
-    else
+
+    if (user_options->attack_mode == ATTACK_MODE_BF)
     {
-      if (user_options->backend_devices_keepfree)
+      if (device_param->is_cuda == true)
       {
-        accel_limit_host = ((u64) accel_limit_host * (100 - user_options->backend_devices_keepfree)) / 100;
+        device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->cuda_d_pws_buf
+                                            : &device_param->cuda_d_pws_amp_buf;
+
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]); if (CL_rc == -1) return -1;
       }
-      else
+
+      if (device_param->is_hip == true)
       {
-        accel_limit_host = accel_limit_host - (accel_limit_host * 0.34);
-      }
+        device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->hip_d_pws_buf
+                                            : &device_param->hip_d_pws_amp_buf;
 
-      accel_limit_host /= backend_ctx->backend_devices_active;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]); if (CL_rc == -1) return -1;
+      }
 
-      // even tho let's not be greedy
+      #if defined (__APPLE__)
+      if (device_param->is_metal == true)
+      {
+        device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? device_param->metal_d_pws_buf.buf_ptr
+                                            : device_param->metal_d_pws_amp_buf.buf_ptr;
+      }
+      #endif
 
-      const u64 GiB8 = 8ULL * 1024 * 1024 * 1024;
+      if (device_param->is_opencl == true)
+      {
+        device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                            ? &device_param->opencl_d_pws_buf
+                                            : &device_param->opencl_d_pws_amp_buf;
 
-      accel_limit_host = MIN (accel_limit_host, GiB8);
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]) == -1) return -1;
+      }
     }
 
-    // Opposite direction check: find out if we would request too much memory on memory blocks which are based on kernel_accel
-
-    u64 size_pws      = 4;
-    u64 size_pws_amp  = 4;
-    u64 size_pws_comp = 4;
-    u64 size_pws_idx  = 4;
-    u64 size_pws_pre  = 4;
-    u64 size_pws_base = 4;
-    u64 size_tmps     = 4;
-    u64 size_hooks    = 4;
-    #ifdef WITH_BRAIN
-    u64 size_brain_link_in  = 4;
-    u64 size_brain_link_out = 4;
-    #endif
-
-    u32 local_size_bytes = 0;
-
-    if ((device_param->is_cuda == true) || (device_param->is_hip == true) || (device_param->is_opencl == true))
+    if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
     {
-      if (device_param->is_cuda   == true) local_size_bytes = cuda_query_max_local_size_bytes   (hashcat_ctx, device_param);
-      if (device_param->is_hip    == true) local_size_bytes = hip_query_max_local_size_bytes    (hashcat_ctx, device_param);
-      if (device_param->is_opencl == true) local_size_bytes = opencl_query_max_local_size_bytes (hashcat_ctx, device_param);
-      #if defined (__APPLE__)
-      if (device_param->is_metal  == true) local_size_bytes = metal_query_max_local_size_bytes  (hashcat_ctx, device_param);
-      #endif
+      // nothing to do
     }
+    else
+    {
+      if (device_param->is_cuda == true)
+      {
+        device_param->kernel_params_amp[0] = &device_param->cuda_d_pws_buf;
+        device_param->kernel_params_amp[1] = &device_param->cuda_d_pws_amp_buf;
 
-    const u64 size_device_extra1234 = size_extra_buffer1 + size_extra_buffer2 + size_extra_buffer3 + size_extra_buffer4;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]); if (CL_rc == -1) return -1;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]); if (CL_rc == -1) return -1;
+      }
 
-    // Still not 100% sure about the 64MiB here
+      if (device_param->is_hip == true)
+      {
+        device_param->kernel_params_amp[0] = &device_param->hip_d_pws_buf;
+        device_param->kernel_params_amp[1] = &device_param->hip_d_pws_amp_buf;
 
-    const u64 size_device_extra = MAX ((64ULL * 1024 * 1024), size_device_extra1234);
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]); if (CL_rc == -1) return -1;
+        //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]); if (CL_rc == -1) return -1;
+      }
 
-    // we will first decrease accel and when reached that limit, we will decrease threads
-    // when we decrease limit this will restore accel_max
+      #if defined (__APPLE__)
+      if (device_param->is_metal == true)
+      {
+        device_param->kernel_params_amp[0] = device_param->metal_d_pws_buf.buf_ptr;
+        device_param->kernel_params_amp[1] = device_param->metal_d_pws_amp_buf.buf_ptr;
+      }
+      #endif
 
-    int memory_limit_hit = 0;
+      if (device_param->is_opencl == true)
+      {
+        device_param->kernel_params_amp[0] = &device_param->opencl_d_pws_buf;
+        device_param->kernel_params_amp[1] = &device_param->opencl_d_pws_amp_buf;
 
-    const u32 kernel_accel_max_sav = kernel_accel_max;
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]) == -1) return -1;
+        if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]) == -1) return -1;
+      }
+    }
+  }
 
-    while ((kernel_accel_max >= kernel_accel_min) || (kernel_threads_max >= kernel_threads_min))
-    {
-      const u64 device_processors = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors);
-      const u64 kernel_threads    = ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : kernel_threads_max);
+  if (device_param->is_cuda == true)
+  {
+    device_param->kernel_params_decompress[0] = &device_param->cuda_d_pws_idx;
+    device_param->kernel_params_decompress[1] = &device_param->cuda_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? &device_param->cuda_d_pws_buf
+                                              : &device_param->cuda_d_pws_amp_buf;
 
-      const u64 kernel_power_max = device_processors * kernel_threads * kernel_accel_max;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
+  }
 
-      // size_spilling
+  if (device_param->is_hip == true)
+  {
+    device_param->kernel_params_decompress[0] = &device_param->hip_d_pws_idx;
+    device_param->kernel_params_decompress[1] = &device_param->hip_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? &device_param->hip_d_pws_buf
+                                              : &device_param->hip_d_pws_amp_buf;
 
-      const u64 size_spilling = kernel_power_max * local_size_bytes;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
+    //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
+  }
 
-      // size_pws
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    device_param->kernel_params_decompress[0] = device_param->metal_d_pws_idx.buf_ptr;
+    device_param->kernel_params_decompress[1] = device_param->metal_d_pws_comp_buf.buf_ptr;
+    device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? device_param->metal_d_pws_buf.buf_ptr
+                                              : device_param->metal_d_pws_amp_buf.buf_ptr;
+  }
+  #endif
 
-      size_pws = kernel_power_max * sizeof (pw_t);
+  if (device_param->is_opencl == true)
+  {
+    device_param->kernel_params_decompress[0] = &device_param->opencl_d_pws_idx;
+    device_param->kernel_params_decompress[1] = &device_param->opencl_d_pws_comp_buf;
+    device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
+                                              ? &device_param->opencl_d_pws_buf
+                                              : &device_param->opencl_d_pws_amp_buf;
 
-      size_pws_amp = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL) ? 1 : size_pws;
+    if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]) == -1) return -1;
+    if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]) == -1) return -1;
+    if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]) == -1) return -1;
+  }
 
-      // size_pws_comp
+  // context
 
-      size_pws_comp = kernel_power_max * (sizeof (u32) * 64);
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuCtxPopCurrent (hashcat_ctx, &device_param->cuda_context) == -1)
+    {
+      device_param->skipped = true;
 
-      // size_pws_idx
+      return 0;
+    }
+  }
 
-      size_pws_idx = (kernel_power_max + 1) * sizeof (pw_idx_t);
+  session_device->hardware_power = hardware_power_max;
 
-      // size_tmps
+  EVENT_DATA (EVENT_BACKEND_DEVICE_INIT_POST, &backend_devices_idx, sizeof (int));
 
-      size_tmps = kernel_power_max * hashconfig->tmp_size;
+  return 0;
+}
 
-      // size_hooks
+#if defined (_WIN) || defined (__WIN32__)
+static HC_API_CALL DWORD backend_session_begin_thread (void *p)
+#else
+static HC_API_CALL void *backend_session_begin_thread (void *p)
+#endif
+{
+  backend_session_device_t *session_device = (backend_session_device_t *) p;
 
-      size_hooks = kernel_power_max * hashconfig->hook_size;
+  session_device->rc = backend_session_begin_device (session_device);
 
-      #ifdef WITH_BRAIN
-      // size_brains
+  #if defined (_WIN) || defined (__WIN32__)
+  return 0;
+  #else
+  return NULL;
+  #endif
+}
 
-      size_brain_link_in  = kernel_power_max * 1;
-      size_brain_link_out = kernel_power_max * 8;
-      #endif
+int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
+{
+  const hashconfig_t         *hashconfig          = hashcat_ctx->hashconfig;
+  const hashes_t             *hashes              = hashcat_ctx->hashes;
+  const module_ctx_t         *module_ctx          = hashcat_ctx->module_ctx;
+        backend_ctx_t        *backend_ctx         = hashcat_ctx->backend_ctx;
+  const user_options_extra_t *user_options_extra  = hashcat_ctx->user_options_extra;
+  const user_options_t       *user_options        = hashcat_ctx->user_options;
 
-      if (user_options->slow_candidates == true)
-      {
-        // size_pws_pre
-
-        size_pws_pre = kernel_power_max * sizeof (pw_pre_t);
-
-        // size_pws_base
-
-        size_pws_base = kernel_power_max * sizeof (pw_pre_t);
-      }
-
-      // now check if all device-memory sizes which depend on the kernel_accel_max amplifier are within its boundaries
-      // if not, decrease amplifier and try again
-
-      memory_limit_hit = 0;
-
-      // sometimes device_available_mem and device_maxmem_alloc reported back from the opencl runtime are a bit inaccurate.
-      // let's add some extra space just to be sure.
-      // now depends on the kernel-accel value (where scrypt and similar benefits), but also hard minimum 64mb and maximum 1024mb limit
-      // let's see if we still need this now that we have low-level API to report free memory
-      // we don't want these get too big. if a plugin requires really a lot of memory, the extra buffer should be used instead.
-
-      if (size_pws   > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
-      if (size_tmps  > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
-      if (size_hooks > device_param->device_maxmem_alloc / 4) memory_limit_hit = 1;
-
-      // work around, for some reason apple opencl can't have buffers larger 2^31
-      // typically runs into trap 6
-      // maybe 32/64 bit problem affecting size_t?
-      // this is really ugly, and still in place 2025/06/09
-      //  Version.: OpenCL 1.2 (Apr 18 2025 21:45:30)
-      //  Driver.Version.: 1.2 (Apr 22 2025 20:11:41)
-
-      if ((device_param->opencl_platform_vendor_id == VENDOR_ID_APPLE) && (device_param->is_metal == false))
-      {
-        const size_t undocumented_single_allocation_apple = 0x7fffffff;
-
-        if (bitmap_ctx->bitmap_size > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_bfs                > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_combs              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_digests            > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_esalts             > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_hooks              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_markov_css         > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_plains             > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_pws                > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_pws_amp            > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_pws_comp           > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_pws_idx            > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_results            > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_root_css           > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_rules              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_rules_c            > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_salts              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_extra_buffer1      > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_extra_buffer2      > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_extra_buffer3      > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_extra_buffer4      > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_shown              > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_tm                 > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_tmps               > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_st_digests         > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_st_salts           > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_st_esalts          > undocumented_single_allocation_apple) memory_limit_hit = 1;
-        if (size_kernel_params      > undocumented_single_allocation_apple) memory_limit_hit = 1;
-      }
-
-      const u64 size_total
-        = bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + bitmap_ctx->bitmap_size
-        + size_bfs
-        + size_combs
-        + size_digests
-        + size_esalts
-        + size_hooks
-        + size_markov_css
-        + size_plains
-        + size_pws
-        + size_pws_amp
-        + size_pws_comp
-        + size_pws_idx
-        + size_results
-        + size_root_css
-        + size_rules
-        + size_rules_c
-        + size_salts
-        + size_device_extra
-        + size_shown
-        + size_tm
-        + size_tmps
-        + size_st_digests
-        + size_st_salts
-        + size_st_esalts
-        + size_kernel_params
-        + size_spilling;
-
-      if (size_total > device_param->device_available_mem) memory_limit_hit = 1;
-
-      const u64 size_host_extra = (512 * 1024 * 1024) / backend_ctx->backend_devices_active;
-
-      const u64 size_total_host
-        = size_pws_comp
-        + size_pws_idx
-        + size_hooks
-        #ifdef WITH_BRAIN
-        + size_brain_link_in
-        + size_brain_link_out
-        #endif
-        + size_pws_pre
-        + size_pws_base
-        + size_host_extra;
+  if (backend_ctx->enabled == false) return 0;
 
-      if (size_total_host > accel_limit_host) memory_limit_hit = 1;
+  u64 size_total_host_all = 0;
 
-      //printf ("%zu %zu %d %d\n", size_total, device_param->device_available_mem, kernel_accel_max, kernel_threads_max);
+  u32 hardware_power_all = 0;
 
-      if (memory_limit_hit == 1)
-      {
-        if (kernel_accel_max == kernel_accel_min)
-        {
-          if ((kernel_threads_max > kernel_threads_min) && (kernel_threads_max >= (device_param->kernel_preferred_wgs_multiple * 2)))
-          {
-            kernel_threads_max -= device_param->kernel_preferred_wgs_multiple;
+  int backend_memory_hit_warnings    = 0;
+  int backend_runtime_skip_warnings  = 0;
+  int backend_kernel_build_warnings  = 0;
+  int backend_kernel_create_warnings = 0;
+  int backend_kernel_accel_warnings  = 0;
+  int backend_extra_size_warning     = 0;
 
-            kernel_accel_max = kernel_accel_max_sav;
-          }
-          else
-          {
-            break;
-          }
-        }
-        else
-        {
-          kernel_accel_max--;
-        }
+  backend_ctx->memory_hit_warning    = false;
+  backend_ctx->runtime_skip_warning  = false;
+  backend_ctx->kernel_build_warning  = false;
+  backend_ctx->kernel_create_warning = false;
+  backend_ctx->kernel_accel_warnings = false;
+  backend_ctx->extra_size_warning    = false;
+  backend_ctx->mixed_warnings        = false;
 
-        continue;
-      }
+  backend_session_device_t *session_devices = (backend_session_device_t *) hccalloc (backend_ctx->backend_devices_cnt, sizeof (backend_session_device_t));
 
-      size_total_host_all += size_total_host;
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    /**
+     * host buffer
+     */
 
-      break;
-    }
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
 
-    if (memory_limit_hit == 1)
-    {
-      event_log_error (hashcat_ctx, "* Device #%u: Not enough allocatable device memory or free host memory for mapping.", device_id + 1);
+    if (device_param->skipped == true) continue;
 
-      backend_memory_hit_warnings++;
+    EVENT_DATA (EVENT_BACKEND_DEVICE_INIT_PRE, &backend_devices_idx, sizeof (int));
 
-      device_param->skipped_warning = true;
+    const int device_id = device_param->device_id;
 
-      continue;
-    }
+    /**
+     * Query used memory from the device using low-level API and update device_available_mem
+     * If there's no low-level API available we will silently ignore
+     */
 
-    // similar process for association attack
-    // there's no need to have a device_power > salts_cnt since salt_pos is set to GID in kernel
+    const u64 used_bytes = hm_get_memoryused_with_devices_idx (hashcat_ctx, device_id);
 
-    if (user_options->attack_mode == ATTACK_MODE_ASSOCIATION)
+    if (used_bytes)
     {
-      while (kernel_accel_max > kernel_accel_min)
-      {
-        const u64 kernel_power_max = device_param->device_processors * kernel_accel_max;
-
-        if (kernel_power_max > hashes->salts_cnt)
-        {
-          kernel_accel_max--;
-
-          continue;
-        }
-
-        break;
-      }
+      device_param->device_available_mem = MIN (device_param->device_available_mem, device_param->device_global_mem - used_bytes);
     }
 
-    device_param->kernel_threads_min = kernel_threads_min;
-    device_param->kernel_threads_max = kernel_threads_max;
-
-    const u32 hardware_power_max = ((hashconfig->opts_type & OPTS_TYPE_MP_MULTI_DISABLE)     ? 1 : device_param->device_processors)
-                                 * ((hashconfig->opts_type & OPTS_TYPE_THREAD_MULTI_DISABLE) ? 1 : device_param->kernel_threads_max);
-
-    device_param->kernel_accel_min = kernel_accel_min;
-    device_param->kernel_accel_max = kernel_accel_max;
+    /**
+     * module depending checks
+     */
 
-    device_param->size_pws      = size_pws;
-    device_param->size_pws_amp  = size_pws_amp;
-    device_param->size_pws_comp = size_pws_comp;
-    device_param->size_pws_idx  = size_pws_idx;
-    device_param->size_pws_pre  = size_pws_pre;
-    device_param->size_pws_base = size_pws_base;
-    device_param->size_tmps     = size_tmps;
-    device_param->size_hooks    = size_hooks;
-    #ifdef WITH_BRAIN
-    device_param->size_brain_link_in  = size_brain_link_in;
-    device_param->size_brain_link_out = size_brain_link_out;
-    #endif
+    device_param->skipped_warning = false;
 
-    if (device_param->is_cuda == true)
+    if (module_ctx->module_unstable_warning != MODULE_DEFAULT)
     {
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_buf,      size_pws)      == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_amp_buf,  size_pws_amp)  == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_comp_buf, size_pws_comp) == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_pws_idx,      size_pws_idx)  == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_tmps,         size_tmps)     == -1) return -1;
-      if (hc_cuMemAlloc (hashcat_ctx, &device_param->cuda_d_hooks,        size_hooks)    == -1) return -1;
-
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_buf,       device_param->size_pws)      == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_tmps,          device_param->size_tmps)     == -1) return -1;
-      if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_hooks,         device_param->size_hooks)    == -1) return -1;
-    }
+      const bool unstable_warning = module_ctx->module_unstable_warning (hashconfig, user_options, user_options_extra, device_param);
 
-    if (device_param->is_hip == true)
-    {
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_buf,      size_pws)      == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_amp_buf,  size_pws_amp)  == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_comp_buf, size_pws_comp) == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_pws_idx,      size_pws_idx)  == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_tmps,         size_tmps)     == -1) return -1;
-      if (hc_hipMemAlloc (hashcat_ctx, &device_param->hip_d_hooks,        size_hooks)    == -1) return -1;
+      if ((unstable_warning == true) && (user_options->force == false))
+      {
+        char runtime_name[7];
 
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_buf,       device_param->size_pws)      == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_tmps,          device_param->size_tmps)     == -1) return -1;
-      if (run_hip_kernel_bzero (hashcat_ctx, device_param, device_param->hip_d_hooks,         device_param->size_hooks)    == -1) return -1;
-    }
+        memset (runtime_name, 0, sizeof (runtime_name));
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws,      NULL, pws_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_amp,  NULL, pws_amp_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_comp, NULL, pws_comp_buf);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_pws_idx,  NULL, pws_idx);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_tmps,     NULL, tmps);
-      HC_MTL_CREATEBUFFER(hashcat_ctx, size_hooks,    NULL, hooks);
+        if (device_param->is_cuda   == true) memcpy (runtime_name, "CUDA", 4);
+        if (device_param->is_hip    == true) memcpy (runtime_name, "HIP", 3);
+        #if defined (__APPLE__)
+        if (device_param->is_metal  == true) memcpy (runtime_name, "Metal", 5);
+        #endif
+        if (device_param->is_opencl == true) memcpy (runtime_name, "OpenCL", 6);
 
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_buf,       device_param->size_pws)      == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_tmps,          device_param->size_tmps)     == -1) return -1;
-      if (run_metal_kernel_bzero (hashcat_ctx, device_param, device_param->metal_d_hooks,         device_param->size_hooks)    == -1) return -1;
-    }
-    #endif
+        event_log_warning (hashcat_ctx, "* Device #%u: Skipping (hash-mode %u)", device_id + 1, hashconfig->hash_mode);
+        event_log_warning (hashcat_ctx, "             This is due to a known %s runtime and/or device driver issue (not a hashcat issue)", runtime_name);
+        event_log_warning (hashcat_ctx, "             You can use --force to override, but do not report related errors.");
+        event_log_warning (hashcat_ctx, NULL);
 
-    if (device_param->is_opencl == true)
-    {
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws,      NULL, pws_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_amp,  NULL, pws_amp_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_comp, NULL, pws_comp_buf);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_pws_idx,  NULL, pws_idx);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_tmps,     NULL, tmps);
-      HC_OCL_CREATEBUFFER(hashcat_ctx, size_hooks,    NULL, hooks);
+        backend_runtime_skip_warnings++;
 
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_buf,       device_param->size_pws)      == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_amp_buf,   device_param->size_pws_amp)  == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_comp_buf,  device_param->size_pws_comp) == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_pws_idx,       device_param->size_pws_idx)  == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_tmps,          device_param->size_tmps)     == -1) return -1;
-      if (run_opencl_kernel_bzero (hashcat_ctx, device_param, device_param->opencl_d_hooks,         device_param->size_hooks)    == -1) return -1;
+        device_param->skipped_warning = true;
+        continue;
+      }
     }
 
     /**
-     * main host data
+     * tuning db
      */
 
-    if (hashconfig->bridge_type)
+    if (module_ctx->module_extra_tuningdb_block != MODULE_DEFAULT)
     {
-      void *h_tmps = hcmalloc_bridge_aligned (device_param->size_tmps, 64);
-
-      device_param->h_tmps = h_tmps;
-    }
+      // We need this because we can't trust CUDA/HIP to give us the real free device memory
+      // The only way to do so is through low level APIs
 
-    u32 *pws_comp = (u32 *) hcmalloc (size_pws_comp);
+      const u64 used_bytes = hm_get_memoryused_with_devices_idx (hashcat_ctx, device_id);
 
-    device_param->pws_comp = pws_comp;
+      if (used_bytes)
+      {
+        const u64 new_left = device_param->device_global_mem - used_bytes;
 
-    pw_idx_t *pws_idx = (pw_idx_t *) hcmalloc (size_pws_idx);
+        if (used_bytes > (device_param->device_global_mem * 0.15))
+        {
+          event_log_warning (hashcat_ctx, "* Device #%u: High memory usage by desktop or other apps detected: %" PRIu64 "/%" PRIu64, device_id + 1, used_bytes, device_param->device_global_mem);
+          event_log_warning (hashcat_ctx, "             Performance is capped at %.2f%%", ((double) new_left / device_param->device_global_mem) * 100);
+        }
 
-    device_param->pws_idx = pws_idx;
+        device_param->device_available_mem = MIN (device_param->device_available_mem, new_left);
+      }
+      else
+      {
+        if (user_options->hwmon == false)
+        {
+          if (user_options->machine_readable == false)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: The hardware monitor was disabled, but it is the only reliable method to query actual free memory.", device_id + 1);
+            event_log_warning (hashcat_ctx, "             Falling back to --backend-devices-keepfree method.");
+            event_log_warning (hashcat_ctx, NULL);
+          }
+        }
 
-    pw_t *combs_buf = (pw_t *) hccalloc (KERNEL_COMBS, sizeof (pw_t));
+        if (user_options->backend_devices_keepfree == 0)
+        {
+          const u64 device_available_mem_sav = device_param->device_available_mem;
 
-    device_param->combs_buf = combs_buf;
+          const u64 device_available_mem_new = device_available_mem_sav - (device_available_mem_sav * 0.34);
 
-    void *hooks_buf = hcmalloc (size_hooks);
+          if (user_options->machine_readable == false)
+          {
+            event_log_warning (hashcat_ctx, "* Device #%u: This system does not offer any reliable method to query actual free memory. Estimated base: %" PRIu64, device_id + 1, device_available_mem_sav);
+            event_log_warning (hashcat_ctx, "             Assuming normal desktop activity, reducing estimate by 34%%: %" PRIu64, device_available_mem_new);
+            event_log_warning (hashcat_ctx, "             This can hurt performance drastically, especially on memory-heavy algorithms.");
+            event_log_warning (hashcat_ctx, "             You can adjust this percentage using --backend-devices-keepfree");
+            event_log_warning (hashcat_ctx, NULL);
+          }
 
-    device_param->hooks_buf = hooks_buf;
+          device_param->device_available_mem = device_available_mem_new;
+        }
+      }
 
-    char *scratch_buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+      u32 _kernel_accel = 0;
 
-    device_param->scratch_buf = scratch_buf;
+      if (user_options->kernel_accel_chgd == true)
+      {
+        _kernel_accel = user_options->kernel_accel;
+      }
+      else
+      {
+        tuning_db_entry_t *tuningdb_entry = tuning_db_search (hashcat_ctx, device_param->device_name, device_param->opencl_device_type, user_options->attack_mode, hashconfig->hash_mode);
 
-    #ifdef WITH_BRAIN
-    u8 *brain_link_in_buf = (u8 *) hcmalloc (size_brain_link_in);
+        if (tuningdb_entry != NULL) _kernel_accel = tuningdb_entry->kernel_accel;
+      }
 
-    device_param->brain_link_in_buf = brain_link_in_buf;
+      const char *extra_tuningdb_block = module_ctx->module_extra_tuningdb_block (hashconfig, user_options, user_options_extra, backend_ctx, hashes, device_id, _kernel_accel);
 
-    u32 *brain_link_out_buf = (u32 *) hcmalloc (size_brain_link_out);
+      char *lines_buf = hcstrdup (extra_tuningdb_block);
 
-    device_param->brain_link_out_buf = brain_link_out_buf;
-    #endif
+      char *saveptr = NULL;
 
-    pw_pre_t *pws_pre_buf = (pw_pre_t *) hcmalloc (size_pws_pre);
+      char *next = strtok_r (lines_buf, "\n", &saveptr);
 
-    device_param->pws_pre_buf = pws_pre_buf;
+      int line_num = 0;
 
-    pw_pre_t *pws_base_buf = (pw_pre_t *) hcmalloc (size_pws_base);
+      do
+      {
+        line_num++;
 
-    device_param->pws_base_buf = pws_base_buf;
+        const size_t line_len = strlen (next);
 
-    /**
-     * kernel args
-     */
+        if (line_len == 0) continue;
 
-    if (device_param->is_cuda == true)
-    {
-      device_param->kernel_params[ 0] = &device_param->cuda_d_pws_buf;
-      device_param->kernel_params[ 4] = &device_param->cuda_d_tmps;
-      device_param->kernel_params[ 5] = &device_param->cuda_d_hooks;
-    }
+        if (next[0] == '#') continue;
 
-    if (device_param->is_hip == true)
-    {
-      device_param->kernel_params[ 0] = &device_param->hip_d_pws_buf;
-      device_param->kernel_params[ 4] = &device_param->hip_d_tmps;
-      device_param->kernel_params[ 5] = &device_param->hip_d_hooks;
-    }
+        char *search_name = NULL;
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      device_param->kernel_params[ 0] = device_param->metal_d_pws_buf.buf_ptr;
-      device_param->kernel_params[ 4] = device_param->metal_d_tmps.buf_ptr;
-      device_param->kernel_params[ 5] = device_param->metal_d_hooks.buf_ptr;
-    }
-    #endif
+        hc_asprintf (&search_name, "MODULE_%02d_%s", device_param->device_id, next);
 
-    if (device_param->is_opencl == true)
-    {
-      device_param->kernel_params[ 0] = &device_param->opencl_d_pws_buf;
-      device_param->kernel_params[ 4] = &device_param->opencl_d_tmps;
-      device_param->kernel_params[ 5] = &device_param->opencl_d_hooks;
-    }
+        tuning_db_process_line (hashcat_ctx, search_name, line_num);
 
-    if (user_options->slow_candidates == true)
-    {
-    }
-    else
-    {
-      if (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL)
-      {
-        // nothing to do
-      }
-      else
-      {
-        if (user_options->attack_mode == ATTACK_MODE_HYBRID2)
-        {
-          if (device_param->is_cuda == true)
-          {
-            device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->cuda_d_pws_buf
-                                              : &device_param->cuda_d_pws_amp_buf;
+        hcfree (search_name);
 
-            //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]); if (CL_rc == -1) return -1;
-          }
+      } while ((next = strtok_r ((char *) NULL, "\n", &saveptr)) != NULL);
 
-          if (device_param->is_hip == true)
-          {
-            device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->hip_d_pws_buf
-                                              : &device_param->hip_d_pws_amp_buf;
+      hcfree (lines_buf);
 
-            //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]); if (CL_rc == -1) return -1;
-          }
+      // todo: print loaded 'cnt' message
 
-          #if defined (__APPLE__)
-          if (device_param->is_metal == true)
-          {
-            device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? device_param->metal_d_pws_buf.buf_ptr
-                                              : device_param->metal_d_pws_amp_buf.buf_ptr;
-          }
-          #endif
+      // sort the database
 
-          if (device_param->is_opencl == true)
-          {
-            device_param->kernel_params_mp[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->opencl_d_pws_buf
-                                              : &device_param->opencl_d_pws_amp_buf;
+      tuning_db_t *tuning_db = hashcat_ctx->tuning_db;
 
-            if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp, 0, sizeof (cl_mem), device_param->kernel_params_mp[0]) == -1) return -1;
-          }
-        }
-      }
+      qsort (tuning_db->alias_buf, tuning_db->alias_cnt, sizeof (tuning_db_alias_t), sort_by_tuning_db_alias);
+      qsort (tuning_db->entry_buf, tuning_db->entry_cnt, sizeof (tuning_db_entry_t), sort_by_tuning_db_entry);
+    }
 
-      if (user_options->attack_mode == ATTACK_MODE_BF)
-      {
-        if (device_param->is_cuda == true)
-        {
-          device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->cuda_d_pws_buf
-                                              : &device_param->cuda_d_pws_amp_buf;
+    session_devices[backend_devices_idx].active = true;
+  }
 
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]); if (CL_rc == -1) return -1;
-        }
+  // some algorithm collide too fast, make that impossible
 
-        if (device_param->is_hip == true)
-        {
-          device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->hip_d_pws_buf
-                                              : &device_param->hip_d_pws_amp_buf;
+  if (user_options->benchmark == true)
+  {
+    ((u32 *) hashes->digests_buf)[0] = -1U;
+    ((u32 *) hashes->digests_buf)[1] = -1U;
+    ((u32 *) hashes->digests_buf)[2] = -1U;
+    ((u32 *) hashes->digests_buf)[3] = -1U;
+  }
 
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]); if (CL_rc == -1) return -1;
-        }
+  /**
+   * kernel builds and memory allocations are independent per device, run them in parallel
+   */
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? device_param->metal_d_pws_buf.buf_ptr
-                                              : device_param->metal_d_pws_amp_buf.buf_ptr;
-        }
-        #endif
+  hc_thread_mutex_init (backend_ctx->mux_kernel_cache);
+  hc_thread_cond_init  (backend_ctx->cond_kernel_cache);
 
-        if (device_param->is_opencl == true)
-        {
-          device_param->kernel_params_mp_l[0] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                              ? &device_param->opencl_d_pws_buf
-                                              : &device_param->opencl_d_pws_amp_buf;
+  memset (backend_ctx->kernel_cache_busy, 0, sizeof (backend_ctx->kernel_cache_busy));
 
-          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_mp_l, 0, sizeof (cl_mem), device_param->kernel_params_mp_l[0]) == -1) return -1;
-        }
-      }
+  hc_thread_mutex_init (backend_ctx->mux_session_warning);
 
-      if (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-      {
-        // nothing to do
-      }
-      else
-      {
-        if (device_param->is_cuda == true)
-        {
-          device_param->kernel_params_amp[0] = &device_param->cuda_d_pws_buf;
-          device_param->kernel_params_amp[1] = &device_param->cuda_d_pws_amp_buf;
+  backend_ctx->manual_tuning_warning = false;
+  backend_ctx->free_memory_warning   = false;
 
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]); if (CL_rc == -1) return -1;
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]); if (CL_rc == -1) return -1;
-        }
+  backend_ctx->autotune_cache_buf    = NULL;
+  backend_ctx->autotune_cache_cnt    = 0;
+  backend_ctx->autotune_cache_loaded = false;
 
-        if (device_param->is_hip == true)
-        {
-          device_param->kernel_params_amp[0] = &device_param->hip_d_pws_buf;
-          device_param->kernel_params_amp[1] = &device_param->hip_d_pws_amp_buf;
+  hc_thread_t *threads = (hc_thread_t *) hccalloc (backend_ctx->backend_devices_cnt, sizeof (hc_thread_t));
 
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]); if (CL_rc == -1) return -1;
-          //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]); if (CL_rc == -1) return -1;
-        }
+  int threads_cnt = 0;
 
-        #if defined (__APPLE__)
-        if (device_param->is_metal == true)
-        {
-          device_param->kernel_params_amp[0] = device_param->metal_d_pws_buf.buf_ptr;
-          device_param->kernel_params_amp[1] = device_param->metal_d_pws_amp_buf.buf_ptr;
-        }
-        #endif
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    backend_session_device_t *session_device = &session_devices[backend_devices_idx];
 
-        if (device_param->is_opencl == true)
-        {
-          device_param->kernel_params_amp[0] = &device_param->opencl_d_pws_buf;
-          device_param->kernel_params_amp[1] = &device_param->opencl_d_pws_amp_buf;
+    if (session_device->active == false) continue;
 
-          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 0, sizeof (cl_mem), device_param->kernel_params_amp[0]) == -1) return -1;
-          if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_amp, 1, sizeof (cl_mem), device_param->kernel_params_amp[1]) == -1) return -1;
-        }
-      }
-    }
+    session_device->hashcat_ctx         = hashcat_ctx;
+    session_device->backend_devices_idx = backend_devices_idx;
 
-    if (device_param->is_cuda == true)
-    {
-      device_param->kernel_params_decompress[0] = &device_param->cuda_d_pws_idx;
-      device_param->kernel_params_decompress[1] = &device_param->cuda_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                ? &device_param->cuda_d_pws_buf
-                                                : &device_param->cuda_d_pws_amp_buf;
+    hc_thread_create (threads[threads_cnt], backend_session_begin_thread, session_device);
 
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
-    }
+    threads_cnt++;
+  }
 
-    if (device_param->is_hip == true)
-    {
-      device_param->kernel_params_decompress[0] = &device_param->hip_d_pws_idx;
-      device_param->kernel_params_decompress[1] = &device_param->hip_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                ? &device_param->hip_d_pws_buf
-                                                : &device_param->hip_d_pws_amp_buf;
+  hc_thread_wait (threads_cnt, threads);
 
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]); if (CL_rc == -1) return -1;
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]); if (CL_rc == -1) return -1;
-      //CL_rc = hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]); if (CL_rc == -1) return -1;
-    }
+  hcfree (threads);
 
-    #if defined (__APPLE__)
-    if (device_param->is_metal == true)
-    {
-      device_param->kernel_params_decompress[0] = device_param->metal_d_pws_idx.buf_ptr;
-      device_param->kernel_params_decompress[1] = device_param->metal_d_pws_comp_buf.buf_ptr;
-      device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                ? device_param->metal_d_pws_buf.buf_ptr
-                                                : device_param->metal_d_pws_amp_buf.buf_ptr;
-    }
-    #endif
+  hc_thread_cond_delete  (backend_ctx->cond_kernel_cache);
+  hc_thread_mutex_delete (backend_ctx->mux_kernel_cache);
 
-    if (device_param->is_opencl == true)
-    {
-      device_param->kernel_params_decompress[0] = &device_param->opencl_d_pws_idx;
-      device_param->kernel_params_decompress[1] = &device_param->opencl_d_pws_comp_buf;
-      device_param->kernel_params_decompress[2] = (hashconfig->attack_exec == ATTACK_EXEC_INSIDE_KERNEL)
-                                                ? &device_param->opencl_d_pws_buf
-                                                : &device_param->opencl_d_pws_amp_buf;
+  hc_thread_mutex_delete (backend_ctx->mux_session_warning);
 
-      if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 0, sizeof (cl_mem), device_param->kernel_params_decompress[0]) == -1) return -1;
-      if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 1, sizeof (cl_mem), device_param->kernel_params_decompress[1]) == -1) return -1;
-      if (hc_clSetKernelArg (hashcat_ctx, device_param->opencl_kernel_decompress, 2, sizeof (cl_mem), device_param->kernel_params_decompress[2]) == -1) return -1;
-    }
+  int rc_devices = 0;
 
-    // context
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    const backend_session_device_t *session_device = &session_devices[backend_devices_idx];
 
-    if (device_param->is_cuda == true)
-    {
-      if (hc_cuCtxPopCurrent (hashcat_ctx, &device_param->cuda_context) == -1)
-      {
-        device_param->skipped = true;
+    if (session_device->active == false) continue;
 
-        continue;
-      }
-    }
+    if (session_device->rc == -1) rc_devices = -1;
 
-    hardware_power_all += hardware_power_max;
+    backend_memory_hit_warnings    += session_device->memory_hit_warnings;
+    backend_kernel_build_warnings  += session_device->kernel_build_warnings;
+    backend_kernel_create_warnings += session_device->kernel_create_warnings;
+    backend_extra_size_warning     += session_device->extra_size_warning;
 
-    EVENT_DATA (EVENT_BACKEND_DEVICE_INIT_POST, &backend_devices_idx, sizeof (int));
+    size_total_host_all += session_device->size_total_host;
+    hardware_power_all  += session_device->hardware_power;
   }
 
+  hcfree (session_devices);
+
+  if (rc_devices == -1) return -1;
+
   int rc = 0;
 
   backend_ctx->memory_hit_warning    = (backend_memory_hit_warnings    == backend_ctx->backend_devices_active);
@@ -16949,6 +17811,8 @@ int backend_session_begin (hashcat_ctx_t *hashcat_ctx)
 
   backend_ctx->hardware_power_all = hardware_power_all;
 
+  if (hook_pool_init (hashcat_ctx) == -1) return -1;
+
   EVENT_DATA (EVENT_BACKEND_SESSION_HOSTMEM, &size_total_host_all, sizeof (u64));
 
   return rc;
@@ -16960,6 +17824,16 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
 
   if (backend_ctx->enabled == false) return;
 
+  hook_pool_destroy (hashcat_ctx);
+
+  combs_cache_destroy (hashcat_ctx);
+
+  hcfree (backend_ctx->autotune_cache_buf);
+
+  backend_ctx->autotune_cache_buf    = NULL;
+  backend_ctx->autotune_cache_cnt    = 0;
+  backend_ctx->autotune_cache_loaded = false;
+
   for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
   {
     hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
@@ -16967,12 +17841,12 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
     if (device_param->skipped == true) continue;
 
     hcfree_bridge_aligned (device_param->h_tmps);
-    hcfree (device_param->pws_comp);
-    hcfree (device_param->pws_idx);
+    hcfree_bridge_aligned (device_param->h_pws);
+    hcfree (device_param->h_plain_bufs);
+    pws_host_free (hashcat_ctx, device_param);
     hcfree (device_param->pws_pre_buf);
     hcfree (device_param->pws_base_buf);
-    hcfree (device_param->combs_buf);
-    hcfree (device_param->hooks_buf);
+    hcfree_bridge_aligned (device_param->hooks_buf);
     hcfree (device_param->scratch_buf);
     #ifdef WITH_BRAIN
     hcfree (device_param->brain_link_in_buf);
@@ -17305,6 +18179,8 @@ void backend_session_destroy (hashcat_ctx_t *hashcat_ctx)
     device_param->h_tmps              = NULL;
     device_param->pws_comp            = NULL;
     device_param->pws_idx             = NULL;
+    device_param->pws_comp_next       = NULL;
+    device_param->pws_idx_next        = NULL;
     device_param->pws_pre_buf         = NULL;
     device_param->pws_base_buf        = NULL;
     device_param->combs_buf           = NULL;
@@ -17523,57 +18399,222 @@ int backend_session_update_mp_rl (hashcat_ctx_t *hashcat_ctx, const u32 css_cnt_
 }
 
 #if defined (_WIN32) || defined (__WIN32__)
-HC_API_CALL DWORD hook12_thread (void *p)
+HC_API_CALL DWORD hook_pool_thread (void *p)
 #else
-HC_API_CALL void *hook12_thread (void *p)
+HC_API_CALL void *hook_pool_thread (void *p)
 #endif
 {
   hook_thread_param_t *hook_thread_param = (hook_thread_param_t *) p;
 
-  module_ctx_t *module_ctx = hook_thread_param->module_ctx;
-  status_ctx_t *status_ctx = hook_thread_param->status_ctx;
+  hook_pool_t *hook_pool = hook_thread_param->hook_pool;
 
-  const u64 tid     = hook_thread_param->tid;
-  const u64 tsz     = hook_thread_param->tsz;
-  const u64 pws_cnt = hook_thread_param->pws_cnt;
+  const hashes_t     *hashes     = hook_pool->hashcat_ctx->hashes;
+  const module_ctx_t *module_ctx = hook_pool->hashcat_ctx->module_ctx;
+  const status_ctx_t *status_ctx = hook_pool->hashcat_ctx->status_ctx;
 
-  for (u64 pw_pos = tid; pw_pos < pws_cnt; pw_pos += tsz)
+  hc_thread_mutex_lock (hook_pool->mux_hook_pool);
+
+  while (hook_pool->shutdown == false)
   {
-    while (status_ctx->devices_status == STATUS_PAUSED) sleep (1);
+    // start after the job served last, so a device with a large batch can't starve the others
 
-    if (status_ctx->devices_status == STATUS_RUNNING)
+    hook_job_t *hook_job = NULL;
+
+    for (int i = 0; i < hook_pool->jobs_cnt; i++)
+    {
+      const int jobs_idx = (hook_pool->jobs_next + i) % hook_pool->jobs_cnt;
+
+      if (hook_pool->jobs[jobs_idx]->pws_pos == hook_pool->jobs[jobs_idx]->pws_cnt) continue;
+
+      hook_job = hook_pool->jobs[jobs_idx];
+
+      hook_pool->jobs_next = jobs_idx + 1;
+
+      break;
+    }
+
+    if (hook_job == NULL)
+    {
+      hc_thread_cond_wait (hook_pool->cond_work, hook_pool->mux_hook_pool);
+
+      continue;
+    }
+
+    const u64 pw_pos_start = hook_job->pws_pos;
+    const u64 pw_pos_stop  = MIN (pw_pos_start + hook_job->chunk, hook_job->pws_cnt);
+
+    hook_job->pws_pos = pw_pos_stop;
+
+    hc_thread_mutex_unlock (hook_pool->mux_hook_pool);
+
+    for (u64 pw_pos = pw_pos_start; pw_pos < pw_pos_stop; pw_pos++)
     {
-      module_ctx->module_hook12 (hook_thread_param->device_param, hook_thread_param->hook_extra_param, hook_thread_param->hook_salts_buf, hook_thread_param->salt_pos, pw_pos);
+      while (status_ctx->devices_status == STATUS_PAUSED) sleep (1);
+
+      if (status_ctx->devices_status != STATUS_RUNNING) continue;
+
+      if (hook_job->opts_type == OPTS_TYPE_HOOK12)
+      {
+        module_ctx->module_hook12 (hook_job->device_param, hook_thread_param->hook_extra_param, hashes->hook_salts_buf, hook_job->salt_pos, pw_pos);
+      }
+      else
+      {
+        module_ctx->module_hook23 (hook_job->device_param, hook_thread_param->hook_extra_param, hashes->hook_salts_buf, hook_job->salt_pos, pw_pos);
+      }
     }
+
+    hc_thread_mutex_lock (hook_pool->mux_hook_pool);
+
+    hook_job->pws_done += pw_pos_stop - pw_pos_start;
+
+    if (hook_job->pws_done == hook_job->pws_cnt) hc_thread_cond_broadcast (hook_pool->cond_done);
   }
 
+  hc_thread_mutex_unlock (hook_pool->mux_hook_pool);
+
   return 0;
 }
 
-#if defined (_WIN32) || defined (__WIN32__)
-HC_API_CALL DWORD hook23_thread (void *p)
-#else
-HC_API_CALL void *hook23_thread (void *p)
-#endif
+static void hook_pool_run (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 opts_type, const u32 salt_pos, const u64 pws_cnt)
 {
-  hook_thread_param_t *hook_thread_param = (hook_thread_param_t *) p;
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+  const hashconfig_t  *hashconfig  = hashcat_ctx->hashconfig;
+
+  hook_pool_t *hook_pool = backend_ctx->hook_pool;
+
+  if (pws_cnt == 0) return;
 
-  module_ctx_t *module_ctx = hook_thread_param->module_ctx;
-  status_ctx_t *status_ctx = hook_thread_param->status_ctx;
+  /**
+   * contiguous chunks instead of a stride, so two workers never write into the same
+   * cache line of hooks_buf, and a few chunks per worker so uneven hook runtimes
+   * still balance out
+   */
 
-  const u64 tid     = hook_thread_param->tid;
-  const u64 tsz     = hook_thread_param->tsz;
-  const u64 pws_cnt = hook_thread_param->pws_cnt;
+  u64 chunk_align = 1;
 
-  for (u64 pw_pos = tid; pw_pos < pws_cnt; pw_pos += tsz)
+  if (hashconfig->hook_size > 0)
   {
-    while (status_ctx->devices_status == STATUS_PAUSED) sleep (1);
+    while (((chunk_align * hashconfig->hook_size) % 64) != 0) chunk_align++;
+  }
 
-    if (status_ctx->devices_status == STATUS_RUNNING)
-    {
-      module_ctx->module_hook23 (hook_thread_param->device_param, hook_thread_param->hook_extra_param, hook_thread_param->hook_salts_buf, hook_thread_param->salt_pos, pw_pos);
-    }
+  u64 chunk = CEILDIV (pws_cnt, (u64) hook_pool->threads_cnt * 4);
+
+  chunk = CEILDIV (chunk, chunk_align) * chunk_align;
+
+  hook_job_t hook_job;
+
+  hook_job.device_param = device_param;
+  hook_job.opts_type    = opts_type;
+  hook_job.salt_pos     = salt_pos;
+  hook_job.pws_cnt      = pws_cnt;
+  hook_job.pws_pos      = 0;
+  hook_job.pws_done     = 0;
+  hook_job.chunk        = chunk;
+
+  hc_thread_mutex_lock (hook_pool->mux_hook_pool);
+
+  hook_pool->jobs[hook_pool->jobs_cnt] = &hook_job;
+
+  hook_pool->jobs_cnt++;
+
+  hc_thread_cond_broadcast (hook_pool->cond_work);
+
+  while (hook_job.pws_done < hook_job.pws_cnt)
+  {
+    hc_thread_cond_wait (hook_pool->cond_done, hook_pool->mux_hook_pool);
+  }
+
+  for (int jobs_idx = 0; jobs_idx < hook_pool->jobs_cnt; jobs_idx++)
+  {
+    if (hook_pool->jobs[jobs_idx] != &hook_job) continue;
+
+    hook_pool->jobs_cnt--;
+
+    hook_pool->jobs[jobs_idx] = hook_pool->jobs[hook_pool->jobs_cnt];
+
+    break;
+  }
+
+  hc_thread_mutex_unlock (hook_pool->mux_hook_pool);
+}
+
+static int hook_pool_init (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t        *backend_ctx  = hashcat_ctx->backend_ctx;
+  const hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
+  const module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  const user_options_t *user_options = hashcat_ctx->user_options;
+
+  backend_ctx->hook_pool = NULL;
+
+  if ((hashconfig->opts_type & (OPTS_TYPE_HOOK12 | OPTS_TYPE_HOOK23)) == 0) return 0;
+
+  /**
+   * one pool for the whole process instead of hook_threads new threads per device and launch
+   * each worker owns one hook_extra_params slot, so the modules' per-thread state is never shared
+   */
+
+  hook_pool_t *hook_pool = (hook_pool_t *) hcmalloc (sizeof (hook_pool_t));
+
+  hook_pool->hashcat_ctx = hashcat_ctx;
+  hook_pool->threads_cnt = (int) user_options->hook_threads;
+  hook_pool->jobs_cnt    = 0;
+  hook_pool->jobs_next   = 0;
+  hook_pool->shutdown    = false;
+
+  hc_thread_mutex_init (hook_pool->mux_hook_pool);
+
+  hc_thread_cond_init (hook_pool->cond_work);
+  hc_thread_cond_init (hook_pool->cond_done);
+
+  hook_pool->threads       = (hc_thread_t *)         hccalloc (hook_pool->threads_cnt, sizeof (hc_thread_t));
+  hook_pool->threads_param = (hook_thread_param_t *) hccalloc (hook_pool->threads_cnt, sizeof (hook_thread_param_t));
+
+  for (int i = 0; i < hook_pool->threads_cnt; i++)
+  {
+    hook_thread_param_t *hook_thread_param = hook_pool->threads_param + i;
+
+    hook_thread_param->tid       = i;
+    hook_thread_param->hook_pool = hook_pool;
+
+    // without a module-defined size there's only a single dummy slot
+
+    hook_thread_param->hook_extra_param = (hashconfig->hook_extra_param_size) ? module_ctx->hook_extra_params[i] : module_ctx->hook_extra_params[0];
+
+    hc_thread_create (hook_pool->threads[i], hook_pool_thread, hook_thread_param);
   }
 
+  backend_ctx->hook_pool = hook_pool;
+
   return 0;
 }
+
+static void hook_pool_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  hook_pool_t *hook_pool = backend_ctx->hook_pool;
+
+  if (hook_pool == NULL) return;
+
+  hc_thread_mutex_lock (hook_pool->mux_hook_pool);
+
+  hook_pool->shutdown = true;
+
+  hc_thread_cond_broadcast (hook_pool->cond_work);
+
+  hc_thread_mutex_unlock (hook_pool->mux_hook_pool);
+
+  hc_thread_wait (hook_pool->threads_cnt, hook_pool->threads);
+
+  hc_thread_cond_delete (hook_pool->cond_work);
+  hc_thread_cond_delete (hook_pool->cond_done);
+
+  hc_thread_mutex_delete (hook_pool->mux_hook_pool);
+
+  hcfree (hook_pool->threads);
+  hcfree (hook_pool->threads_param);
+  hcfree (hook_pool);
+
+  backend_ctx->hook_pool = NULL;
+}
@@ -158,8 +158,10 @@ bool bridges_init (hashcat_ctx_t *hashcat_ctx)
   CHECK_DEFINED (bridge_ctx->thread_term);
   CHECK_DEFINED (bridge_ctx->salt_prepare);
   CHECK_DEFINED (bridge_ctx->salt_destroy);
+  CHECK_DEFINED (bridge_ctx->launch_init);
   CHECK_DEFINED (bridge_ctx->launch_loop);
   CHECK_DEFINED (bridge_ctx->launch_loop2);
+  CHECK_DEFINED (bridge_ctx->launch_comp);
   CHECK_DEFINED (bridge_ctx->st_update_hash);
   CHECK_DEFINED (bridge_ctx->st_update_pass);
 
@@ -181,10 +183,14 @@ bool bridges_init (hashcat_ctx_t *hashcat_ctx)
   CHECK_MANDATORY (bridge_ctx->get_unit_info);
   CHECK_MANDATORY (bridge_ctx->get_workitem_count);
 
+  if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_INIT)  CHECK_MANDATORY (bridge_ctx->launch_init);
   if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_LOOP)  CHECK_MANDATORY (bridge_ctx->launch_loop);
   if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_LOOP2) CHECK_MANDATORY (bridge_ctx->launch_loop2);
+  if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_COMP)  CHECK_MANDATORY (bridge_ctx->launch_comp);
+  if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_INIT)   CHECK_MANDATORY (bridge_ctx->launch_init);
   if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP)   CHECK_MANDATORY (bridge_ctx->launch_loop);
   if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_LOOP2)  CHECK_MANDATORY (bridge_ctx->launch_loop2);
+  if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_COMP)   CHECK_MANDATORY (bridge_ctx->launch_comp);
 
   #undef CHECK_MANDATORY
 
@@ -274,3 +280,35 @@ void bridges_salt_destroy (hashcat_ctx_t *hashcat_ctx)
 
   bridge_ctx->salt_destroy (bridge_ctx->platform_context, hashconfig, hashes);
 }
+
+bool bridges_mark_hash (hc_device_param_t *device_param, const hashes_t *hashes, const u32 salt_pos, const u32 digest_pos, const u64 gid)
+{
+  // host side of mark_hash() in OpenCL/inc_common.cl
+
+  const salt_t *salt_buf = &hashes->salts_buf[salt_pos];
+
+  const u32 hash_pos = salt_buf->digests_offset + digest_pos;
+
+  if (hashes->digests_shown[hash_pos] == 1) return false;
+
+  const u32 idx = __atomic_fetch_add (&device_param->h_result, 1, __ATOMIC_SEQ_CST);
+
+  if (idx >= (device_param->size_plains / sizeof (plain_t)))
+  {
+    __atomic_fetch_sub (&device_param->h_result, 1, __ATOMIC_SEQ_CST);
+
+    return false;
+  }
+
+  plain_t *plain = &device_param->h_plain_bufs[idx];
+
+  plain->salt_pos   = salt_pos;
+  plain->digest_pos = digest_pos;
+  plain->hash_pos   = hash_pos;
+  plain->gidvid     = gid;
+  plain->il_pos     = 0;
+  plain->extra1     = 0;
+  plain->extra2     = 0;
+
+  return true;
+}
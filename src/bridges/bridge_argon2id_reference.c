@@ -7,6 +7,7 @@
 #include "types.h"
 #include "bridges.h"
 #include "memory.h"
+#include "affinity.h"
 #include "shared.h"
 #include "cpu_features.h"
 
@@ -20,10 +21,29 @@
 
 #if defined (__x86_64__) || defined (_M_X64) || defined (__i386__) || defined (_M_IX86) || defined (__aarch64__) || defined (__arm64__)
 #include "opt.c"
+#define ARGON2_INTERLEAVE
 #else
 #include "ref.c"
 #endif
 
+// opt.c picks its BlaMka compression at compile time, cpu_chipset_test () makes sure the CPU can run it
+
+#if defined (__AVX512F__)
+typedef __m512i argon2_simd_t;
+#define ARGON2_SIMD_WORDS ARGON2_512BIT_WORDS_IN_BLOCK
+#define ARGON2_SIMD_NAME  "AVX-512"
+#elif defined (__AVX2__)
+typedef __m256i argon2_simd_t;
+#define ARGON2_SIMD_WORDS ARGON2_HWORDS_IN_BLOCK
+#define ARGON2_SIMD_NAME  "AVX2"
+#elif defined (ARGON2_INTERLEAVE)
+typedef __m128i argon2_simd_t;
+#define ARGON2_SIMD_WORDS ARGON2_OWORDS_IN_BLOCK
+#define ARGON2_SIMD_NAME  "SSE"
+#else
+#define ARGON2_SIMD_NAME  "portable"
+#endif
+
 // good: we can use this multiplier do reduce copy overhead to increase the guessing speed,
 // bad: but we also increase the password candidate batch size.
 // slow hashes which make use of this bridge probably are used with smaller wordlists,
@@ -32,6 +52,16 @@
 
 #define N_ACCEL 32
 
+// the reference block of the next Argon2 block is only known once the current block is done, and it is
+// a cache miss for any realistic m. interleaving several independent segments (other lanes of the same
+// password, or other passwords) lets the prefetch of one stream run while the others are computing.
+// interleaving passwords multiplies the memory of every unit, so it is only done if all units together
+// stay within 1/ARGON2_INTERLEAVE_MEM_DIV of the free host memory.
+
+#define ARGON2_STREAMS_MAX        4
+#define ARGON2_INTERLEAVE_PWS     2
+#define ARGON2_INTERLEAVE_MEM_DIV 2
+
 typedef struct
 {
   // input
@@ -69,9 +99,14 @@ typedef struct
   u64     workitem_count;
   size_t  workitem_size;
 
+  int     cpu_id;     // -1 if unknown
+  int     numa_node;  // -1 if unknown
+
   // implementation specific
 
   void   *memory;
+  size_t  memory_size; // per interleaved password
+  u32     pws_interleave;
 
 } unit_t;
 
@@ -82,6 +117,248 @@ typedef struct
 
 } bridge_argon2id_t;
 
+// same memory layout as argon2_ctx ()
+
+static u32 argon2_memory_blocks (const u32 m_cost, const u32 lanes)
+{
+  u32 memory_blocks = MAX (m_cost, 2 * ARGON2_SYNC_POINTS * lanes);
+
+  const u32 segment_length = memory_blocks / (lanes * ARGON2_SYNC_POINTS);
+
+  memory_blocks = segment_length * (lanes * ARGON2_SYNC_POINTS);
+
+  return memory_blocks;
+}
+
+#if defined (ARGON2_INTERLEAVE)
+
+static void argon2_instance_init (argon2_instance_t *instance, argon2_context *context, const argon2_type type)
+{
+  const u32 memory_blocks = argon2_memory_blocks (context->m_cost, context->lanes);
+
+  const u32 segment_length = memory_blocks / (context->lanes * ARGON2_SYNC_POINTS);
+
+  instance->version         = context->version;
+  instance->memory          = NULL;
+  instance->passes          = context->t_cost;
+  instance->memory_blocks   = memory_blocks;
+  instance->segment_length  = segment_length;
+  instance->lane_length     = segment_length * ARGON2_SYNC_POINTS;
+  instance->lanes           = context->lanes;
+  instance->threads         = 1;
+  instance->type            = type;
+  instance->print_internals = 0;
+  instance->context_ptr     = context;
+}
+
+/**
+ * One stream is one segment of one password, this is fill_segment () from opt.c cut into single steps,
+ * so that the steps of several streams can be interleaved.
+ */
+
+typedef struct
+{
+  argon2_simd_t            state[ARGON2_SIMD_WORDS];
+
+  block                    address_block;
+  block                    input_block;
+
+  const argon2_instance_t *instance;
+  argon2_position_t        position;
+
+  u32                      curr_offset;
+  u32                      prev_offset;
+
+  int                      data_independent_addressing;
+
+} argon2_stream_t;
+
+static u32 argon2_stream_start (argon2_stream_t *stream, const argon2_instance_t *instance, const argon2_position_t position)
+{
+  stream->instance = instance;
+  stream->position = position;
+
+  stream->data_independent_addressing = (instance->type == Argon2_i)
+                                     || ((instance->type == Argon2_id) && (position.pass == 0) && (position.slice < ARGON2_SYNC_POINTS / 2));
+
+  if (stream->data_independent_addressing)
+  {
+    init_block_value (&stream->input_block, 0);
+
+    stream->input_block.v[0] = position.pass;
+    stream->input_block.v[1] = position.lane;
+    stream->input_block.v[2] = position.slice;
+    stream->input_block.v[3] = instance->memory_blocks;
+    stream->input_block.v[4] = instance->passes;
+    stream->input_block.v[5] = instance->type;
+  }
+
+  u32 starting_index = 0;
+
+  if ((position.pass == 0) && (position.slice == 0))
+  {
+    starting_index = 2; // the first two blocks are generated by fill_first_blocks ()
+
+    if (stream->data_independent_addressing) next_addresses (&stream->address_block, &stream->input_block);
+  }
+
+  stream->curr_offset = (position.lane * instance->lane_length) + (position.slice * instance->segment_length) + starting_index;
+
+  if ((stream->curr_offset % instance->lane_length) == 0)
+  {
+    stream->prev_offset = stream->curr_offset + instance->lane_length - 1;
+  }
+  else
+  {
+    stream->prev_offset = stream->curr_offset - 1;
+  }
+
+  memcpy (stream->state, instance->memory[stream->prev_offset].v, ARGON2_BLOCK_SIZE);
+
+  return starting_index;
+}
+
+static block *argon2_stream_ref_block (argon2_stream_t *stream, const u32 index, const u64 pseudo_rand)
+{
+  const argon2_instance_t *instance = stream->instance;
+
+  u64 ref_lane = (pseudo_rand >> 32) % instance->lanes;
+
+  // can not reference other lanes yet
+
+  if ((stream->position.pass == 0) && (stream->position.slice == 0)) ref_lane = stream->position.lane;
+
+  stream->position.index = index;
+
+  const u64 ref_index = index_alpha (instance, &stream->position, pseudo_rand & 0xffffffff, ref_lane == stream->position.lane);
+
+  return instance->memory + (instance->lane_length * ref_lane) + ref_index;
+}
+
+static void argon2_stream_step (argon2_stream_t *stream, const u32 index)
+{
+  const argon2_instance_t *instance = stream->instance;
+
+  if ((stream->curr_offset % instance->lane_length) == 1) stream->prev_offset = stream->curr_offset - 1;
+
+  u64 pseudo_rand;
+
+  if (stream->data_independent_addressing)
+  {
+    if ((index % ARGON2_ADDRESSES_IN_BLOCK) == 0) next_addresses (&stream->address_block, &stream->input_block);
+
+    pseudo_rand = stream->address_block.v[index % ARGON2_ADDRESSES_IN_BLOCK];
+  }
+  else
+  {
+    pseudo_rand = instance->memory[stream->prev_offset].v[0];
+  }
+
+  const block *ref_block = argon2_stream_ref_block (stream, index, pseudo_rand);
+
+  block *curr_block = instance->memory + stream->curr_offset;
+
+  // version 1.2.1 and earlier overwrite instead of XOR
+
+  const int with_xor = (instance->version != ARGON2_VERSION_10) && (stream->position.pass != 0);
+
+  fill_block (stream->state, ref_block, curr_block, with_xor);
+
+  stream->curr_offset++;
+  stream->prev_offset++;
+
+  // the block just written decides the next reference block, start fetching it while the other streams compute
+
+  const u32 index_next = index + 1;
+
+  if (index_next == instance->segment_length) return;
+
+  if (stream->data_independent_addressing)
+  {
+    if ((index_next % ARGON2_ADDRESSES_IN_BLOCK) == 0) return;
+
+    pseudo_rand = stream->address_block.v[index_next % ARGON2_ADDRESSES_IN_BLOCK];
+  }
+  else
+  {
+    pseudo_rand = curr_block->v[0];
+  }
+
+  const u8 *ref_next = (const u8 *) argon2_stream_ref_block (stream, index_next, pseudo_rand);
+
+  for (u32 off = 0; off < ARGON2_BLOCK_SIZE; off += 64)
+  {
+    __builtin_prefetch (ref_next + off, 0, 0);
+  }
+}
+
+static void fill_segments_interleaved (argon2_stream_t *streams, const u32 streams_cnt, const argon2_instance_t **instances, const argon2_position_t *positions)
+{
+  u32 starting_index = 0;
+
+  for (u32 j = 0; j < streams_cnt; j++)
+  {
+    starting_index = argon2_stream_start (&streams[j], instances[j], positions[j]);
+  }
+
+  // all streams share the cost parameters, so they also share starting_index and segment_length
+
+  const u32 segment_length = instances[0]->segment_length;
+
+  for (u32 index = starting_index; index < segment_length; index++)
+  {
+    for (u32 j = 0; j < streams_cnt; j++)
+    {
+      argon2_stream_step (&streams[j], index);
+    }
+  }
+}
+
+// fill_memory_blocks () for several passwords of the same salt: within one slice, all lanes of all passwords are independent
+
+static void fill_memory_blocks_interleaved (argon2_instance_t *instances, const u32 instances_cnt)
+{
+  argon2_stream_t streams[ARGON2_STREAMS_MAX];
+
+  const argon2_instance_t *streams_instance[ARGON2_STREAMS_MAX];
+  argon2_position_t        streams_position[ARGON2_STREAMS_MAX];
+
+  const u32 passes = instances[0].passes;
+  const u32 lanes  = instances[0].lanes;
+
+  for (u32 r = 0; r < passes; r++)
+  {
+    for (u32 s = 0; s < ARGON2_SYNC_POINTS; s++)
+    {
+      u32 streams_cnt = 0;
+
+      for (u32 k = 0; k < instances_cnt; k++)
+      {
+        for (u32 l = 0; l < lanes; l++)
+        {
+          const argon2_position_t position = { r, l, (uint8_t) s, 0 };
+
+          streams_instance[streams_cnt] = &instances[k];
+          streams_position[streams_cnt] = position;
+
+          streams_cnt++;
+
+          if (streams_cnt == ARGON2_STREAMS_MAX)
+          {
+            fill_segments_interleaved (streams, streams_cnt, streams_instance, streams_position);
+
+            streams_cnt = 0;
+          }
+        }
+      }
+
+      if (streams_cnt) fill_segments_interleaved (streams, streams_cnt, streams_instance, streams_position);
+    }
+  }
+}
+
+#endif // ARGON2_INTERLEAVE
+
 static bool units_init (bridge_argon2id_t *bridge_argon2id)
 {
   #if defined (_WIN)
@@ -98,7 +375,17 @@ static bool units_init (bridge_argon2id_t *bridge_argon2id)
 
   #endif
 
+  // one unit per CPU we are allowed to run on, each one keeps its thread and its memory on the NUMA node of that CPU
+
+  int *cpu_ids    = (int *) hccalloc (num_devices, sizeof (int));
+  int *numa_nodes = (int *) hccalloc (num_devices, sizeof (int));
+
+  const int cpus_cnt = get_cpu_topology (cpu_ids, numa_nodes, num_devices);
+
+  if (cpus_cnt > 0) num_devices = cpus_cnt;
+
   // this works really good for me, I think is because of register pressure on SIMD enabled code
+  // with the usual CPU numbering on Linux, the first half of the list has one thread per core on all sockets
   num_devices /= 2;
 
   // this is just a wild guess, but memory bus will probably bottleneck if we
@@ -114,8 +401,26 @@ static bool units_init (bridge_argon2id_t *bridge_argon2id)
     unit_t *unit_buf = &units_buf[i];
 
     unit_buf->unit_info_len = snprintf (unit_buf->unit_info_buf, sizeof (unit_buf->unit_info_buf) - 1,
-      "%s",
-      "Argon2 reference implementation + tunings");
+      "%s (%s)",
+      "Argon2 reference implementation + tunings",
+      ARGON2_SIMD_NAME);
+
+    unit_buf->cpu_id    = (cpus_cnt > 0) ? cpu_ids[i]    : -1;
+    unit_buf->numa_node = (cpus_cnt > 0) ? numa_nodes[i] : -1;
+
+    if (unit_buf->numa_node >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d, NUMA node %d]",
+        unit_buf->cpu_id,
+        unit_buf->numa_node);
+    }
+    else if (unit_buf->cpu_id >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d]",
+        unit_buf->cpu_id);
+    }
 
     unit_buf->unit_info_buf[unit_buf->unit_info_len] = 0;
 
@@ -124,6 +429,9 @@ static bool units_init (bridge_argon2id_t *bridge_argon2id)
     units_cnt++;
   }
 
+  hcfree (cpu_ids);
+  hcfree (numa_nodes);
+
   bridge_argon2id->units_buf = units_buf;
   bridge_argon2id->units_cnt = units_cnt;
 
@@ -197,13 +505,28 @@ char *get_unit_info (void *platform_context, const int unit_idx)
   return unit_buf->unit_info_buf;
 }
 
+bool thread_init (void *platform_context, hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
+{
+  bridge_argon2id_t *bridge_argon2id = platform_context;
+
+  const int unit_idx = device_param->bridge_link_device;
+
+  unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
+
+  // keep the thread next to its memory, not being able to do so only costs speed
+
+  set_thread_cpu_affinity (unit_buf->cpu_id);
+
+  return true;
+}
+
 bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
 {
   // we can use self-test hash as base
 
   argon2_t *argon2_st = (argon2_t *) hashes->st_esalts_buf;
 
-  size_t largest_m = argon2_st->m;
+  size_t largest_m = argon2_memory_blocks (argon2_st->m, argon2_st->p);
 
   // from here regular hashes
 
@@ -211,16 +534,41 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
 
   for (u32 salt_idx = 0; salt_idx < hashes->salts_cnt; salt_idx++, argon2++)
   {
-    if (argon2->m > largest_m) largest_m = argon2->m;
+    const size_t m = argon2_memory_blocks (argon2->m, argon2->p);
+
+    if (m > largest_m) largest_m = m;
   }
 
   bridge_argon2id_t *bridge_argon2id = platform_context;
 
+  u32 pws_interleave = 1;
+
+  #if defined (ARGON2_INTERLEAVE)
+  u64 free_mem = 0;
+
+  if (get_free_memory (&free_mem) == true)
+  {
+    const u64 interleave_mem = (u64) bridge_argon2id->units_cnt * largest_m * ARGON2_BLOCK_SIZE * ARGON2_INTERLEAVE_PWS;
+
+    if (interleave_mem <= (free_mem / ARGON2_INTERLEAVE_MEM_DIV)) pws_interleave = ARGON2_INTERLEAVE_PWS;
+  }
+  #endif
+
   for (int unit_idx = 0; unit_idx < bridge_argon2id->units_cnt; unit_idx++)
   {
     unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
 
-    unit_buf->memory = hcmalloc_bridge_aligned ((largest_m * 1024), 32); // because AVX2
+    unit_buf->memory_size    = largest_m * ARGON2_BLOCK_SIZE;
+    unit_buf->pws_interleave = pws_interleave;
+
+    unit_buf->memory = hcmalloc_bridge_huge (unit_buf->memory_size * pws_interleave, unit_buf->numa_node); // 64 byte aligned, because AVX-512
+
+    if (unit_buf->memory == NULL)
+    {
+      fprintf (stderr, "Unable to allocate %" PRIu64 " bytes of Argon2 memory for unit %d\n", (u64) (unit_buf->memory_size * pws_interleave), unit_idx);
+
+      return false;
+    }
   }
 
   return true;
@@ -234,7 +582,7 @@ void salt_destroy (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
   {
     unit_t *unit_buf = &bridge_argon2id->units_buf[unit_idx];
 
-    hcfree_bridge_aligned (unit_buf->memory);
+    hcfree_bridge_huge (unit_buf->memory);
   }
 }
 
@@ -274,6 +622,42 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
   context.version       = ARGON2_VERSION_NUMBER;
   context.memory        = unit_buf->memory;
 
+  #if defined (ARGON2_INTERLEAVE)
+
+  argon2_instance_t instances[ARGON2_INTERLEAVE_PWS];
+  argon2_context    contexts[ARGON2_INTERLEAVE_PWS];
+
+  for (u64 i = 0; i < pws_cnt; i += unit_buf->pws_interleave)
+  {
+    const u32 instances_cnt = (u32) MIN (pws_cnt - i, unit_buf->pws_interleave);
+
+    for (u32 k = 0; k < instances_cnt; k++)
+    {
+      contexts[k] = context;
+
+      contexts[k].out    = (uint8_t *) argon2_reference_tmp[k].h;
+      contexts[k].outlen = (uint32_t)  argon2id->digest_len;
+      contexts[k].pwd    = (uint8_t *) argon2_reference_tmp[k].pw_buf;
+      contexts[k].pwdlen = (uint32_t)  argon2_reference_tmp[k].pw_len;
+      contexts[k].memory = (u8 *) unit_buf->memory + (k * unit_buf->memory_size);
+
+      argon2_instance_init (&instances[k], &contexts[k], Argon2_id);
+
+      initialize (&instances[k], &contexts[k]);
+    }
+
+    fill_memory_blocks_interleaved (instances, instances_cnt);
+
+    for (u32 k = 0; k < instances_cnt; k++)
+    {
+      finalize (&contexts[k], &instances[k]);
+    }
+
+    argon2_reference_tmp += instances_cnt;
+  }
+
+  #else
+
   for (u64 i = 0; i < pws_cnt; i++)
   {
     context.out    = (uint8_t *) argon2_reference_tmp->h;
@@ -286,6 +670,8 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
     argon2_reference_tmp++;
   }
 
+  #endif
+
   return true;
 }
 
@@ -299,12 +685,14 @@ void bridge_init (bridge_ctx_t *bridge_ctx)
   bridge_ctx->get_unit_count      = get_unit_count;
   bridge_ctx->get_unit_info       = get_unit_info;
   bridge_ctx->get_workitem_count  = get_workitem_count;
-  bridge_ctx->thread_init         = BRIDGE_DEFAULT;
+  bridge_ctx->thread_init         = thread_init;
   bridge_ctx->thread_term         = BRIDGE_DEFAULT;
   bridge_ctx->salt_prepare        = salt_prepare;
   bridge_ctx->salt_destroy        = salt_destroy;
+  bridge_ctx->launch_init         = BRIDGE_DEFAULT;
   bridge_ctx->launch_loop         = launch_loop;
   bridge_ctx->launch_loop2        = BRIDGE_DEFAULT;
+  bridge_ctx->launch_comp         = BRIDGE_DEFAULT;
   bridge_ctx->st_update_hash      = BRIDGE_DEFAULT;
   bridge_ctx->st_update_pass      = BRIDGE_DEFAULT;
 }
@@ -27,6 +27,7 @@
 typedef void                (PYTHON_API_CALL *PY_INITIALIZE)                    ();
 typedef void                (PYTHON_API_CALL *PY_FINALIZE)                      ();
 typedef void                (PYTHON_API_CALL *PY_DECREF)                        (PyObject *);
+typedef void                (PYTHON_API_CALL *PY_INCREF)                        (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYBOOL_FROMLONG)                  (long);
 typedef PyObject           *(PYTHON_API_CALL *PYBYTES_FROMSTRINGANDSIZE)        (const char *, Py_ssize_t);
 typedef int                 (PYTHON_API_CALL *PYDICT_DELITEMSTRING)             (PyObject *, const char *);
@@ -42,6 +43,7 @@ typedef PyObject           *(PYTHON_API_CALL *PYLIST_NEW)
 typedef int                 (PYTHON_API_CALL *PYLIST_SETITEM)                   (PyObject *, Py_ssize_t, PyObject *);
 typedef Py_ssize_t          (PYTHON_API_CALL *PYLIST_SIZE)                      (PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYLONG_FROMLONG)                  (long);
+typedef PyObject           *(PYTHON_API_CALL *PYMEMORYVIEW_FROMMEMORY)          (char *, Py_ssize_t, int);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_CALLOBJECT)              (PyObject *, PyObject *);
 typedef PyObject           *(PYTHON_API_CALL *PYOBJECT_GETATTRSTRING)           (PyObject *, const char *);
 typedef PyObject           *(PYTHON_API_CALL *PYTUPLE_NEW)                      (Py_ssize_t);
@@ -83,6 +85,7 @@ typedef struct hc_python_lib
   PY_INITIALIZE                     Py_Initialize;
   PY_FINALIZE                       Py_Finalize;
   PY_DECREF                         Py_DecRef;
+  PY_INCREF                         Py_IncRef;
   PYBOOL_FROMLONG                   PyBool_FromLong;
   PYBYTES_FROMSTRINGANDSIZE         PyBytes_FromStringAndSize;
   PYDICT_DELITEMSTRING              PyDict_DelItemString;
@@ -98,6 +101,7 @@ typedef struct hc_python_lib
   PYLIST_SETITEM                    PyList_SetItem;
   PYLIST_SIZE                       PyList_Size;
   PYLONG_FROMLONG                   PyLong_FromLong;
+  PYMEMORYVIEW_FROMMEMORY           PyMemoryView_FromMemory;
   PYOBJECT_CALLOBJECT               PyObject_CallObject;
   PYOBJECT_GETATTRSTRING            PyObject_GetAttrString;
   PYTUPLE_NEW                       PyTuple_New;
@@ -142,6 +146,10 @@ typedef struct hc_python_lib
 
 #define N_ACCEL 8
 
+// kernel_loop_buf() results are truncated to this size, same as OUT_SIZE_MAX in Python/hcshared.py
+
+#define PYTHON_OUT_SIZE_MAX 256
+
 typedef struct
 {
   // input
@@ -179,6 +187,15 @@ typedef struct
   PyObject *pFunc_Init;
   PyObject *pFunc_Term;
   PyObject *pFunc_kernel_loop;
+  PyObject *pFunc_kernel_loop_buf; // optional
+
+  // kernel_loop_buf() buffers
+
+  u8     *pws_buf;
+  u32    *pws_off;
+  u8     *out_buf;
+  u32    *out_len;
+  u64     packed_cnt;
 
 } unit_t;
 
@@ -577,6 +594,7 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, Py_Initialize,                     Py_Initialize,                      PY_INITIALIZE,                    PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_Finalize,                       Py_Finalize,                        PY_FINALIZE,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, Py_DecRef,                         Py_DecRef,                          PY_DECREF,                        PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, Py_IncRef,                         Py_IncRef,                          PY_INCREF,                        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBool_FromLong,                   PyBool_FromLong,                    PYBOOL_FROMLONG,                  PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyBytes_FromStringAndSize,         PyBytes_FromStringAndSize,          PYBYTES_FROMSTRINGANDSIZE,        PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyDict_DelItemString,              PyDict_DelItemString,               PYDICT_DELITEMSTRING,             PYTHON, 1);
@@ -592,6 +610,7 @@ static bool init_python (hc_python_lib_t *python, user_options_t *user_options)
   HC_LOAD_FUNC_PYTHON (python, PyList_SetItem,                    PyList_SetItem,                     PYLIST_SETITEM,                   PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyList_Size,                       PyList_Size,                        PYLIST_SIZE,                      PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyLong_FromLong,                   PyLong_FromLong,                    PYLONG_FROMLONG,                  PYTHON, 1);
+  HC_LOAD_FUNC_PYTHON (python, PyMemoryView_FromMemory,           PyMemoryView_FromMemory,            PYMEMORYVIEW_FROMMEMORY,          PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_CallObject,               PyObject_CallObject,                PYOBJECT_CALLOBJECT,              PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyObject_GetAttrString,            PyObject_GetAttrString,             PYOBJECT_GETATTRSTRING,           PYTHON, 1);
   HC_LOAD_FUNC_PYTHON (python, PyTuple_New,                       PyTuple_New,                        PYTUPLE_NEW,                      PYTHON, 1);
@@ -677,12 +696,58 @@ static bool units_init (python_interpreter_t *python_interpreter)
   return true;
 }
 
+static void packed_free (unit_t *unit_buf)
+{
+  hcfree (unit_buf->pws_buf);
+  hcfree (unit_buf->pws_off);
+  hcfree (unit_buf->out_buf);
+  hcfree (unit_buf->out_len);
+
+  unit_buf->pws_buf = NULL;
+  unit_buf->pws_off = NULL;
+  unit_buf->out_buf = NULL;
+  unit_buf->out_len = NULL;
+
+  unit_buf->packed_cnt = 0;
+}
+
+static bool packed_alloc (unit_t *unit_buf, const u64 pws_cnt)
+{
+  if (pws_cnt <= unit_buf->packed_cnt) return true;
+
+  hcfree (unit_buf->pws_buf);
+  hcfree (unit_buf->pws_off);
+  hcfree (unit_buf->out_buf);
+  hcfree (unit_buf->out_len);
+
+  unit_buf->pws_buf = (u8 *)  hcmalloc (pws_cnt * sizeof (((generic_io_tmp_t *) NULL)->pw_buf));
+  unit_buf->pws_off = (u32 *) hcmalloc ((pws_cnt + 1) * sizeof (u32));
+  unit_buf->out_buf = (u8 *)  hcmalloc (pws_cnt * PYTHON_OUT_SIZE_MAX);
+  unit_buf->out_len = (u32 *) hcmalloc (pws_cnt * sizeof (u32));
+
+  if ((unit_buf->pws_buf == NULL) || (unit_buf->pws_off == NULL) || (unit_buf->out_buf == NULL) || (unit_buf->out_len == NULL))
+  {
+    packed_free (unit_buf);
+
+    return false;
+  }
+
+  unit_buf->packed_cnt = pws_cnt;
+
+  return true;
+}
+
 static void units_term (python_interpreter_t *python_interpreter)
 {
   unit_t *units_buf = python_interpreter->units_buf;
 
   if (units_buf)
   {
+    for (int unit_idx = 0; unit_idx < python_interpreter->units_cnt; unit_idx++)
+    {
+      packed_free (&units_buf[unit_idx]);
+    }
+
     hcfree (python_interpreter->units_buf);
   }
 }
@@ -796,6 +861,10 @@ void *platform_init (user_options_t *user_options)
     return false;
   }
 
+  // optional, older plugins only have kernel_loop()
+
+  unit_buf->pFunc_kernel_loop_buf = python->PyDict_GetItemString (unit_buf->pGlobals, "kernel_loop_buf");
+
   // Initialize Context (which also means copy salts because they are part of the context)
 
   unit_buf->pContext = python->PyDict_New ();
@@ -986,6 +1055,165 @@ char *get_unit_info (void *platform_context, const int unit_idx)
   return unit_buf->unit_info_buf;
 }
 
+static PyObject *memoryview_cast_u32 (hc_python_lib_t *python, PyObject *view)
+{
+  PyObject *pCast = python->PyObject_GetAttrString (view, "cast");
+
+  if (pCast == NULL) return NULL;
+
+  PyObject *pArgs = python->PyTuple_New (1);
+
+  PyObject *pReturn = NULL;
+
+  if (pArgs)
+  {
+    python->PyTuple_SetItem (pArgs, 0, python->PyUnicode_FromString ("I"));
+
+    pReturn = python->PyObject_CallObject (pCast, pArgs);
+
+    python->Py_DecRef (pArgs);
+  }
+
+  python->Py_DecRef (pCast);
+
+  return pReturn;
+}
+
+static void memoryview_release (hc_python_lib_t *python, PyObject *view)
+{
+  // this only invalidates the view itself, views the plugin derived from it (slices, casts) still point to our buffers
+
+  if (view == NULL) return;
+
+  PyObject *pRelease = python->PyObject_GetAttrString (view, "release");
+
+  PyObject *pReturn = (pRelease == NULL) ? NULL : python->PyObject_CallObject (pRelease, NULL);
+
+  if (pReturn == NULL) python->PyErr_Print ();
+
+  if (pReturn)  python->Py_DecRef (pReturn);
+  if (pRelease) python->Py_DecRef (pRelease);
+
+  python->Py_DecRef (view);
+}
+
+/**
+ * kernel_loop_buf (ctx, pws_buf, pws_off, out_buf, out_len, salt_id, is_selftest)
+ *
+ * All buffers are memoryviews of our own memory, so nothing is converted per candidate:
+ * - pws_buf: bytes, the candidates back-to-back, pws_off: format 'I', pws_cnt + 1 offsets into pws_buf
+ * - out_buf: writable bytes, pws_cnt * PYTHON_OUT_SIZE_MAX, the plugin writes the results back-to-back
+ * - out_len: writable, format 'I', pws_cnt lengths, one per result
+ *
+ * The views are only valid during the call, the plugin must not keep them or views derived from them.
+ */
+
+static bool launch_loop_buf (hc_python_lib_t *python, unit_t *unit_buf, hc_device_param_t *device_param, hashes_t *hashes, const u32 salt_pos, const u64 pws_cnt)
+{
+  if (packed_alloc (unit_buf, pws_cnt) == false) return false;
+
+  generic_io_tmp_t *generic_io_tmp = (generic_io_tmp_t *) device_param->h_tmps;
+
+  u32 pws_pos = 0;
+
+  for (u64 i = 0; i < pws_cnt; i++)
+  {
+    const u32 pw_len = MIN (generic_io_tmp[i].pw_len, sizeof (generic_io_tmp[i].pw_buf));
+
+    memcpy (unit_buf->pws_buf + pws_pos, generic_io_tmp[i].pw_buf, pw_len);
+
+    unit_buf->pws_off[i] = pws_pos;
+
+    pws_pos += pw_len;
+  }
+
+  unit_buf->pws_off[pws_cnt] = pws_pos;
+
+  memset (unit_buf->out_len, 0, pws_cnt * sizeof (u32));
+
+  // views[4] and views[5] are the u32 casts of views[1] and views[3], those are what the plugin gets
+
+  PyObject *views[6];
+
+  views[0] = python->PyMemoryView_FromMemory ((char *) unit_buf->pws_buf, pws_pos,                      PyBUF_READ);
+  views[1] = python->PyMemoryView_FromMemory ((char *) unit_buf->pws_off, (pws_cnt + 1) * sizeof (u32),  PyBUF_READ);
+  views[2] = python->PyMemoryView_FromMemory ((char *) unit_buf->out_buf, pws_cnt * PYTHON_OUT_SIZE_MAX, PyBUF_WRITE);
+  views[3] = python->PyMemoryView_FromMemory ((char *) unit_buf->out_len, pws_cnt * sizeof (u32),        PyBUF_WRITE);
+
+  views[4] = (views[1] == NULL) ? NULL : memoryview_cast_u32 (python, views[1]);
+  views[5] = (views[3] == NULL) ? NULL : memoryview_cast_u32 (python, views[3]);
+
+  PyObject *pArgs = python->PyTuple_New (7);
+
+  if ((views[0] == NULL) || (views[1] == NULL) || (views[2] == NULL) || (views[3] == NULL) || (views[4] == NULL) || (views[5] == NULL) || (pArgs == NULL))
+  {
+    python->PyErr_Print ();
+
+    for (int i = 5; i >= 0; i--) memoryview_release (python, views[i]);
+
+    if (pArgs) python->Py_DecRef (pArgs);
+
+    return false;
+  }
+
+  // PyTuple_SetItem() steals the references, but we keep using them
+
+  python->Py_IncRef (unit_buf->pContext);
+
+  python->PyTuple_SetItem (pArgs, 0, unit_buf->pContext);
+
+  PyObject *args_views[4] = { views[0], views[4], views[2], views[5] };
+
+  for (int i = 0; i < 4; i++)
+  {
+    python->Py_IncRef (args_views[i]);
+
+    python->PyTuple_SetItem (pArgs, 1 + i, args_views[i]);
+  }
+
+  python->PyTuple_SetItem (pArgs, 5, python->PyLong_FromLong (salt_pos));
+  python->PyTuple_SetItem (pArgs, 6, python->PyBool_FromLong (hashes->salts_buf == hashes->st_salts_buf));
+
+  PyObject *pReturn = python->PyObject_CallObject (unit_buf->pFunc_kernel_loop_buf, pArgs);
+
+  if (pReturn == NULL) python->PyErr_Print ();
+
+  python->Py_DecRef (pArgs);
+
+  // the casts first, then the views they were made from
+
+  for (int i = 5; i >= 0; i--) memoryview_release (python, views[i]);
+
+  if (pReturn == NULL) return false;
+
+  python->Py_DecRef (pReturn);
+
+  // scatter the results, out_len[] comes from the plugin so it is not trusted
+
+  u64 out_pos = 0;
+
+  for (u64 i = 0; i < pws_cnt; i++)
+  {
+    const u32 out_len = unit_buf->out_len[i];
+
+    if ((out_len > PYTHON_OUT_SIZE_MAX) || (out_pos + out_len > pws_cnt * PYTHON_OUT_SIZE_MAX))
+    {
+      fprintf (stderr, "Invalid out_len[%" PRIu64 "] = %u returned by kernel_loop_buf(), must be at most %d and fit the %" PRIu64 " bytes of out_buf.\n", i, out_len, PYTHON_OUT_SIZE_MAX, pws_cnt * PYTHON_OUT_SIZE_MAX);
+
+      return false;
+    }
+
+    memcpy (generic_io_tmp[i].out_buf[0], unit_buf->out_buf + out_pos, out_len);
+
+    generic_io_tmp[i].out_len[0] = out_len;
+    generic_io_tmp[i].out_cnt    = 1;
+
+    out_pos += out_len;
+  }
+
+  return true;
+}
+
 bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
 {
   python_interpreter_t *python_interpreter = platform_context;
@@ -998,6 +1226,15 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   unit_buf->gstate = python->PyGILState_Ensure ();
 
+  if (unit_buf->pFunc_kernel_loop_buf != NULL)
+  {
+    const bool rc = launch_loop_buf (python, unit_buf, device_param, hashes, salt_pos, pws_cnt);
+
+    python->PyGILState_Release (unit_buf->gstate);
+
+    return rc;
+  }
+
   generic_io_tmp_t *generic_io_tmp = (generic_io_tmp_t *) device_param->h_tmps;
 
   PyObject *pws = python->PyList_New (pws_cnt);
@@ -1166,8 +1403,10 @@ void bridge_init (bridge_ctx_t *bridge_ctx)
   bridge_ctx->thread_term         = thread_term;
   bridge_ctx->salt_prepare        = BRIDGE_DEFAULT;
   bridge_ctx->salt_destroy        = BRIDGE_DEFAULT;
+  bridge_ctx->launch_init         = BRIDGE_DEFAULT;
   bridge_ctx->launch_loop         = launch_loop;
   bridge_ctx->launch_loop2        = BRIDGE_DEFAULT;
+  bridge_ctx->launch_comp         = BRIDGE_DEFAULT;
   bridge_ctx->st_update_hash      = st_update_hash;
   bridge_ctx->st_update_pass      = st_update_pass;
 }
@@ -434,8 +434,10 @@ void bridge_init (bridge_ctx_t *bridge_ctx)
   bridge_ctx->thread_term = thread_term;
   bridge_ctx->salt_prepare = BRIDGE_DEFAULT;
   bridge_ctx->salt_destroy = BRIDGE_DEFAULT;
+  bridge_ctx->launch_init = BRIDGE_DEFAULT;
   bridge_ctx->launch_loop = launch_loop;
   bridge_ctx->launch_loop2 = BRIDGE_DEFAULT;
+  bridge_ctx->launch_comp = BRIDGE_DEFAULT;
   bridge_ctx->st_update_hash = st_update_hash;
   bridge_ctx->st_update_pass = st_update_pass;
 }
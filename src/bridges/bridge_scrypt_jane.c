@@ -7,6 +7,7 @@
 #include "types.h"
 #include "bridges.h"
 #include "memory.h"
+#include "affinity.h"
 #include "shared.h"
 #include "cpu_features.h"
 
@@ -28,6 +29,145 @@
 #define SCRYPT_TMP_SIZE (128ULL * SCRYPT_R_MAX * SCRYPT_P_MAX)
 #define SCRYPT_TMP_SIZE4 (SCRYPT_TMP_SIZE / 4)
 
+/**
+ * Multi-lane ROMix: SCRYPT_LANES independent ROMix instances, one per 32-bit vector lane.
+ * Every vector holds the same Salsa20/8 state word of all lanes, so the rounds need no shuffles at all,
+ * and the random V[j] reads of the lanes are independent loads the CPU can have in flight together.
+ * The vector width follows the instruction set the bridge is compiled for.
+ */
+
+#if defined (__AVX2__) || defined (__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#if defined (__AVX512F__)
+#define SCRYPT_LANES      16
+#define SCRYPT_LANES_NAME "AVX-512"
+#elif defined (__AVX2__)
+#define SCRYPT_LANES      8
+#define SCRYPT_LANES_NAME "AVX2"
+#else
+#define SCRYPT_LANES      4
+#define SCRYPT_LANES_NAME "128 bit"
+#endif
+
+// V grows by factor SCRYPT_LANES, so the multi-lane path is only used up to this size of V per unit,
+// and only if all units together stay within 1/SCRYPT_LANES_MEM_DIV of the free host memory
+
+#define SCRYPT_LANES_MAX_V   (128ULL * 1024 * 1024)
+#define SCRYPT_LANES_MEM_DIV 2
+
+typedef u32 scrypt_lanes_t __attribute__ ((vector_size (SCRYPT_LANES * sizeof (u32))));
+
+#define SCRYPT_LANES_ROTL(a,n) (((a) << (n)) | ((a) >> (32 - (n))))
+
+#define SCRYPT_LANES_QR(a,b,c,d)             \
+{                                            \
+  x[b] ^= SCRYPT_LANES_ROTL (x[a] + x[d],  7); \
+  x[c] ^= SCRYPT_LANES_ROTL (x[b] + x[a],  9); \
+  x[d] ^= SCRYPT_LANES_ROTL (x[c] + x[b], 13); \
+  x[a] ^= SCRYPT_LANES_ROTL (x[d] + x[c], 18); \
+}
+
+static inline void salsa20_8_lanes (scrypt_lanes_t *B)
+{
+  scrypt_lanes_t x[16];
+
+  for (int i = 0; i < 16; i++) x[i] = B[i];
+
+  for (int i = 0; i < 8; i += 2)
+  {
+    SCRYPT_LANES_QR ( 0,  4,  8, 12);
+    SCRYPT_LANES_QR ( 5,  9, 13,  1);
+    SCRYPT_LANES_QR (10, 14,  2,  6);
+    SCRYPT_LANES_QR (15,  3,  7, 11);
+
+    SCRYPT_LANES_QR ( 0,  1,  2,  3);
+    SCRYPT_LANES_QR ( 5,  6,  7,  4);
+    SCRYPT_LANES_QR (10, 11,  8,  9);
+    SCRYPT_LANES_QR (15, 12, 13, 14);
+  }
+
+  for (int i = 0; i < 16; i++) B[i] += x[i];
+}
+
+// BlockMix of B into Bo, B and Bo are 2 * r blocks of 16 words
+
+static inline void blockmix_lanes (scrypt_lanes_t *Bo, const scrypt_lanes_t *B, const u32 r)
+{
+  scrypt_lanes_t X[16];
+
+  memcpy (X, B + ((2 * r - 1) * 16), sizeof (X));
+
+  for (u32 i = 0; i < 2 * r; i++)
+  {
+    for (int k = 0; k < 16; k++) X[k] ^= B[i * 16 + k];
+
+    salsa20_8_lanes (X);
+
+    // even blocks go to the first half, odd blocks to the second half
+
+    memcpy (Bo + (((i & 1) * r + (i / 2)) * 16), X, sizeof (X));
+  }
+}
+
+// X ^= V[j], with j taken from X itself, each lane reads its own V[j] from the same word column of the vectors
+
+static inline void xor_V_lanes (scrypt_lanes_t *X, const scrypt_lanes_t *V, const u32 N, const u32 r)
+{
+  const u32 chunk_vecs = 32 * r;
+
+  // index of the first word of V[j] of each lane, counted in u32
+
+  scrypt_lanes_t idx;
+
+  for (int l = 0; l < SCRYPT_LANES; l++) idx[l] = ((X[chunk_vecs - 16][l] & (N - 1)) * chunk_vecs * SCRYPT_LANES) + l;
+
+  const int *V32 = (const int *) V;
+
+  for (u32 w = 0; w < chunk_vecs; w++, idx += SCRYPT_LANES)
+  {
+    #if defined (__AVX512F__)
+    X[w] ^= (scrypt_lanes_t) _mm512_i32gather_epi32 ((__m512i) idx, V32, 4);
+    #elif defined (__AVX2__)
+    X[w] ^= (scrypt_lanes_t) _mm256_i32gather_epi32 (V32, (__m256i) idx, 4);
+    #else
+    scrypt_lanes_t t;
+
+    for (int l = 0; l < SCRYPT_LANES; l++) t[l] = V32[idx[l]];
+
+    X[w] ^= t;
+    #endif
+  }
+}
+
+// X and Y are 32 * r vectors, V is N * 32 * r vectors, N is a power of 2, same structure as scrypt-jane's ROMix
+
+static void scrypt_ROMix_lanes (scrypt_lanes_t *X, scrypt_lanes_t *Y, scrypt_lanes_t *V, const u32 N, const u32 r)
+{
+  const u32 chunk_vecs = 32 * r;
+
+  memcpy (V, X, chunk_vecs * sizeof (scrypt_lanes_t));
+
+  for (u32 i = 0; i < N - 1; i++)
+  {
+    blockmix_lanes (V + ((i + 1) * chunk_vecs), V + (i * chunk_vecs), r);
+  }
+
+  blockmix_lanes (X, V + ((N - 1) * chunk_vecs), r);
+
+  for (u32 i = 0; i < N; i += 2)
+  {
+    xor_V_lanes (X, V, N, r);
+
+    blockmix_lanes (Y, X, r);
+
+    xor_V_lanes (Y, V, N, r);
+
+    blockmix_lanes (X, Y, r);
+  }
+}
+
 typedef struct
 {
   u32 P[SCRYPT_TMP_SIZE4];
@@ -40,6 +180,9 @@ typedef struct
   //void *X;
   void *Y;
 
+  void *X_lanes;
+  bool  use_lanes;
+
   // implementation specific
 
   char    unit_info_buf[1024];
@@ -48,6 +191,9 @@ typedef struct
   u64     workitem_count;
   size_t  workitem_size;
 
+  int     cpu_id;     // -1 if unknown
+  int     numa_node;  // -1 if unknown
+
 } unit_t;
 
 typedef struct
@@ -73,6 +219,15 @@ static bool units_init (bridge_scrypt_jane_t *bridge_scrypt_jane)
 
   #endif
 
+  // one unit per CPU we are allowed to run on, each one keeps its thread and its memory on the NUMA node of that CPU
+
+  int *cpu_ids    = (int *) hccalloc (num_devices, sizeof (int));
+  int *numa_nodes = (int *) hccalloc (num_devices, sizeof (int));
+
+  const int cpus_cnt = get_cpu_topology (cpu_ids, numa_nodes, num_devices);
+
+  if (cpus_cnt > 0) num_devices = cpus_cnt;
+
   unit_t *units_buf = (unit_t *) hccalloc (num_devices, sizeof (unit_t));
 
   int units_cnt = 0;
@@ -82,16 +237,40 @@ static bool units_init (bridge_scrypt_jane_t *bridge_scrypt_jane)
     unit_t *unit_buf = &units_buf[i];
 
     unit_buf->unit_info_len = snprintf (unit_buf->unit_info_buf, sizeof (unit_buf->unit_info_buf) - 1,
-      "%s",
-      "Scrypt-Jane ROMix");
+      "%s + %d x %s lanes",
+      "Scrypt-Jane ROMix",
+      SCRYPT_LANES,
+      SCRYPT_LANES_NAME);
+
+    unit_buf->cpu_id    = (cpus_cnt > 0) ? cpu_ids[i]    : -1;
+    unit_buf->numa_node = (cpus_cnt > 0) ? numa_nodes[i] : -1;
+
+    if (unit_buf->numa_node >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d, NUMA node %d]",
+        unit_buf->cpu_id,
+        unit_buf->numa_node);
+    }
+    else if (unit_buf->cpu_id >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d]",
+        unit_buf->cpu_id);
+    }
 
     unit_buf->unit_info_buf[unit_buf->unit_info_len] = 0;
 
-    unit_buf->workitem_count = N_ACCEL;
+    // one launch should fill all lanes at least once
+
+    unit_buf->workitem_count = MAX (N_ACCEL, SCRYPT_LANES);
 
     units_cnt++;
   }
 
+  hcfree (cpu_ids);
+  hcfree (numa_nodes);
+
   bridge_scrypt_jane->units_buf = units_buf;
   bridge_scrypt_jane->units_cnt = units_cnt;
 
@@ -165,6 +344,21 @@ char *get_unit_info (void *platform_context, const int unit_idx)
   return unit_buf->unit_info_buf;
 }
 
+bool thread_init (void *platform_context, hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
+{
+  bridge_scrypt_jane_t *bridge_scrypt_jane = platform_context;
+
+  const int unit_idx = device_param->bridge_link_device;
+
+  unit_t *unit_buf = &bridge_scrypt_jane->units_buf[unit_idx];
+
+  // keep the thread next to its memory, not being able to do so only costs speed
+
+  set_thread_cpu_affinity (unit_buf->cpu_id);
+
+  return true;
+}
+
 bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
 {
   // selftest hash
@@ -194,15 +388,43 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
     if (sz_Y > largest_Y) largest_Y = sz_Y;
   }
 
+  // the multi-lane ROMix needs all buffers SCRYPT_LANES times
+
   bridge_scrypt_jane_t *bridge_scrypt_jane = platform_context;
 
+  bool use_lanes = false;
+
+  if ((largest_V * SCRYPT_LANES) <= SCRYPT_LANES_MAX_V)
+  {
+    u64 free_mem = 0;
+
+    if (get_free_memory (&free_mem) == true)
+    {
+      const u64 lanes_mem = (u64) bridge_scrypt_jane->units_cnt * (largest_V + (2 * largest_Y)) * SCRYPT_LANES;
+
+      if (lanes_mem <= (free_mem / SCRYPT_LANES_MEM_DIV)) use_lanes = true;
+    }
+  }
+
+  const size_t lanes_mul = (use_lanes == true) ? SCRYPT_LANES : 1;
+
   for (int unit_idx = 0; unit_idx < bridge_scrypt_jane->units_cnt; unit_idx++)
   {
     unit_t *unit_buf = &bridge_scrypt_jane->units_buf[unit_idx];
 
-    unit_buf->V = hcmalloc_bridge_aligned (largest_V, 64);
+    unit_buf->V = hcmalloc_bridge_huge (largest_V * lanes_mul, unit_buf->numa_node);
     //unit_buf->X = hcmalloc_bridge_aligned (largest_X, 64);
-    unit_buf->Y = hcmalloc_bridge_aligned (largest_Y, 64);
+    unit_buf->Y = hcmalloc_bridge_aligned (largest_Y * lanes_mul, 64);
+
+    unit_buf->X_lanes   = (use_lanes == true) ? hcmalloc_bridge_aligned (largest_Y * lanes_mul, 64) : NULL;
+    unit_buf->use_lanes = use_lanes;
+
+    if ((unit_buf->V == NULL) || (unit_buf->Y == NULL) || ((use_lanes == true) && (unit_buf->X_lanes == NULL)))
+    {
+      fprintf (stderr, "Unable to allocate %" PRIu64 " bytes of ROMix memory for unit %d\n", (u64) ((largest_V + (2 * largest_Y)) * lanes_mul), unit_idx);
+
+      return false;
+    }
   }
 
   return true;
@@ -216,12 +438,35 @@ void salt_destroy (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
   {
     unit_t *unit_buf = &bridge_scrypt_jane->units_buf[unit_idx];
 
-    hcfree_bridge_aligned (unit_buf->V);
+    hcfree_bridge_huge (unit_buf->V);
     //hcfree_bridge_aligned (unit_buf->X);
     hcfree_bridge_aligned (unit_buf->Y);
+    hcfree_bridge_aligned (unit_buf->X_lanes);
   }
 }
 
+bool launch_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  // 1st pbkdf2, same as m70100_init (), creates B from the password and the salt
+
+  salt_t *salts_buf = (salt_t *) hashes->salts_buf;
+
+  salt_t *salt_buf = &salts_buf[salt_pos];
+
+  const size_t x_bytes = 128 * salt_buf->scrypt_r * salt_buf->scrypt_p;
+
+  scrypt_tmp_t *scrypt_tmp = (scrypt_tmp_t *) device_param->h_tmps;
+
+  pw_t *pws = device_param->h_pws;
+
+  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  {
+    scrypt_pbkdf2 ((const u8 *) pws[pw_cnt].i, pws[pw_cnt].pw_len, (const u8 *) salt_buf->salt_buf, salt_buf->salt_len, 1, (u8 *) scrypt_tmp[pw_cnt].P, x_bytes);
+  }
+
+  return true;
+}
+
 bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
 {
   bridge_scrypt_jane_t *bridge_scrypt_jane = platform_context;
@@ -246,6 +491,47 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
 
   const size_t chunk_bytes = 64 * 2 * r;
 
+  if (unit_buf->use_lanes == true)
+  {
+    // every p-block of every password is an independent ROMix, they are spread across the lanes
+
+    scrypt_lanes_t *X_lanes = (scrypt_lanes_t *) unit_buf->X_lanes;
+    scrypt_lanes_t *Y_lanes = (scrypt_lanes_t *) unit_buf->Y;
+    scrypt_lanes_t *V_lanes = (scrypt_lanes_t *) unit_buf->V;
+
+    const u32 chunk_words = (u32) (chunk_bytes / 4);
+
+    const u64 items_cnt = pws_cnt * p;
+
+    for (u64 item_base = 0; item_base < items_cnt; item_base += SCRYPT_LANES)
+    {
+      u32 *items[SCRYPT_LANES];
+
+      for (int l = 0; l < SCRYPT_LANES; l++)
+      {
+        // unused lanes of the last round just repeat the first item
+
+        const u64 item = ((item_base + l) < items_cnt) ? (item_base + l) : item_base;
+
+        items[l] = (u32 *) ((u8 *) scrypt_tmp[item / p].P + (chunk_bytes * (item % p)));
+      }
+
+      for (u32 w = 0; w < chunk_words; w++)
+      {
+        for (int l = 0; l < SCRYPT_LANES; l++) X_lanes[w][l] = items[l][w];
+      }
+
+      scrypt_ROMix_lanes (X_lanes, Y_lanes, V_lanes, N, r);
+
+      for (u32 w = 0; w < chunk_words; w++)
+      {
+        for (int l = 0; l < SCRYPT_LANES; l++) items[l][w] = X_lanes[w][l];
+      }
+    }
+
+    return true;
+  }
+
   // hashcat guarantees h_tmps[] is 64 byte aligned
 
   for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
@@ -263,6 +549,39 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
   return true;
 }
 
+bool launch_comp (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  // 2nd pbkdf2, same as m70100_comp (), the kernel compares the first 16 bytes of the digest and so do we
+
+  salt_t *salts_buf = (salt_t *) hashes->salts_buf;
+
+  salt_t *salt_buf = &salts_buf[salt_pos];
+
+  const size_t x_bytes = 128 * salt_buf->scrypt_r * salt_buf->scrypt_p;
+
+  const u8 *digests_buf = (const u8 *) hashes->digests_buf + ((size_t) salt_buf->digests_offset * hashconfig->dgst_size);
+
+  scrypt_tmp_t *scrypt_tmp = (scrypt_tmp_t *) device_param->h_tmps;
+
+  pw_t *pws = device_param->h_pws;
+
+  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  {
+    u8 out[32];
+
+    scrypt_pbkdf2 ((const u8 *) pws[pw_cnt].i, pws[pw_cnt].pw_len, (const u8 *) scrypt_tmp[pw_cnt].P, x_bytes, 1, out, sizeof (out));
+
+    for (u32 digest_pos = 0; digest_pos < salt_buf->digests_cnt; digest_pos++)
+    {
+      if (memcmp (out, digests_buf + ((size_t) digest_pos * hashconfig->dgst_size), 16) != 0) continue;
+
+      bridges_mark_hash (device_param, hashes, salt_pos, digest_pos, pw_cnt);
+    }
+  }
+
+  return true;
+}
+
 void bridge_init (bridge_ctx_t *bridge_ctx)
 {
   bridge_ctx->bridge_context_size       = BRIDGE_CONTEXT_SIZE_CURRENT;
@@ -273,12 +592,14 @@ void bridge_init (bridge_ctx_t *bridge_ctx)
   bridge_ctx->get_unit_count      = get_unit_count;
   bridge_ctx->get_unit_info       = get_unit_info;
   bridge_ctx->get_workitem_count  = get_workitem_count;
-  bridge_ctx->thread_init         = BRIDGE_DEFAULT;
+  bridge_ctx->thread_init         = thread_init;
   bridge_ctx->thread_term         = BRIDGE_DEFAULT;
   bridge_ctx->salt_prepare        = salt_prepare;
   bridge_ctx->salt_destroy        = salt_destroy;
+  bridge_ctx->launch_init         = launch_init;
   bridge_ctx->launch_loop         = launch_loop;
   bridge_ctx->launch_loop2        = BRIDGE_DEFAULT;
+  bridge_ctx->launch_comp         = launch_comp;
   bridge_ctx->st_update_hash      = BRIDGE_DEFAULT;
   bridge_ctx->st_update_pass      = BRIDGE_DEFAULT;
 }
@@ -7,10 +7,12 @@
 #include "types.h"
 #include "bridges.h"
 #include "memory.h"
+#include "affinity.h"
 #include "shared.h"
 #include "cpu_features.h"
 
 #include "yescrypt.h"
+#include "sha256.h"
 
 void smix(uint8_t *B, size_t r, uint32_t N, uint32_t p, uint32_t t,
           yescrypt_flags_t flags,
@@ -50,6 +52,9 @@ typedef struct
   u64     workitem_count;
   size_t  workitem_size;
 
+  int     cpu_id;     // -1 if unknown
+  int     numa_node;  // -1 if unknown
+
 } unit_t;
 
 typedef struct
@@ -75,6 +80,15 @@ static bool units_init (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
 
   #endif
 
+  // one unit per CPU we are allowed to run on, each one keeps its thread and its memory on the NUMA node of that CPU
+
+  int *cpu_ids    = (int *) hccalloc (num_devices, sizeof (int));
+  int *numa_nodes = (int *) hccalloc (num_devices, sizeof (int));
+
+  const int cpus_cnt = get_cpu_topology (cpu_ids, numa_nodes, num_devices);
+
+  if (cpus_cnt > 0) num_devices = cpus_cnt;
+
   unit_t *units_buf = (unit_t *) hccalloc (num_devices, sizeof (unit_t));
 
   int units_cnt = 0;
@@ -87,6 +101,23 @@ static bool units_init (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
       "%s",
       "Scrypt-Yescrypt");
 
+    unit_buf->cpu_id    = (cpus_cnt > 0) ? cpu_ids[i]    : -1;
+    unit_buf->numa_node = (cpus_cnt > 0) ? numa_nodes[i] : -1;
+
+    if (unit_buf->numa_node >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d, NUMA node %d]",
+        unit_buf->cpu_id,
+        unit_buf->numa_node);
+    }
+    else if (unit_buf->cpu_id >= 0)
+    {
+      unit_buf->unit_info_len += snprintf (unit_buf->unit_info_buf + unit_buf->unit_info_len, sizeof (unit_buf->unit_info_buf) - 1 - unit_buf->unit_info_len,
+        " [CPU %d]",
+        unit_buf->cpu_id);
+    }
+
     unit_buf->unit_info_buf[unit_buf->unit_info_len] = 0;
 
     unit_buf->workitem_count = N_ACCEL;
@@ -94,6 +125,9 @@ static bool units_init (bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt)
     units_cnt++;
   }
 
+  hcfree (cpu_ids);
+  hcfree (numa_nodes);
+
   bridge_scrypt_yescrypt->units_buf = units_buf;
   bridge_scrypt_yescrypt->units_cnt = units_cnt;
 
@@ -167,6 +201,21 @@ char *get_unit_info (void *platform_context, const int unit_idx)
   return unit_buf->unit_info_buf;
 }
 
+bool thread_init (void *platform_context, hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
+{
+  bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt = platform_context;
+
+  const int unit_idx = device_param->bridge_link_device;
+
+  unit_t *unit_buf = &bridge_scrypt_yescrypt->units_buf[unit_idx];
+
+  // keep the thread next to its memory, not being able to do so only costs speed
+
+  set_thread_cpu_affinity (unit_buf->cpu_id);
+
+  return true;
+}
+
 bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes)
 {
   // selftest hash
@@ -195,8 +244,15 @@ bool salt_prepare (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
   {
     unit_t *unit_buf = &bridge_scrypt_yescrypt->units_buf[unit_idx];
 
-    unit_buf->V  = hcmalloc_bridge_aligned (largest_V,  64);
+    unit_buf->V  = hcmalloc_bridge_huge    (largest_V, unit_buf->numa_node);
     unit_buf->XY = hcmalloc_bridge_aligned (largest_XY, 64);
+
+    if ((unit_buf->V == NULL) || (unit_buf->XY == NULL))
+    {
+      fprintf (stderr, "Unable to allocate %" PRIu64 " bytes of smix memory for unit %d\n", (u64) (largest_V + largest_XY), unit_idx);
+
+      return false;
+    }
   }
 
   return true;
@@ -210,11 +266,33 @@ void salt_destroy (void *platform_context, MAYBE_UNUSED hashconfig_t *hashconfig
   {
     unit_t *unit_buf = &bridge_scrypt_yescrypt->units_buf[unit_idx];
 
-    hcfree_bridge_aligned (unit_buf->V);
+    hcfree_bridge_huge    (unit_buf->V);
     hcfree_bridge_aligned (unit_buf->XY);
   }
 }
 
+bool launch_init (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  // 1st pbkdf2, same as m70100_init (), creates B from the password and the salt
+
+  salt_t *salts_buf = (salt_t *) hashes->salts_buf;
+
+  salt_t *salt_buf = &salts_buf[salt_pos];
+
+  const size_t x_bytes = 128 * salt_buf->scrypt_r * salt_buf->scrypt_p;
+
+  scrypt_tmp_t *scrypt_tmp = (scrypt_tmp_t *) device_param->h_tmps;
+
+  pw_t *pws = device_param->h_pws;
+
+  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  {
+    PBKDF2_SHA256 ((const u8 *) pws[pw_cnt].i, pws[pw_cnt].pw_len, (const u8 *) salt_buf->salt_buf, salt_buf->salt_len, 1, (u8 *) scrypt_tmp[pw_cnt].B, x_bytes);
+  }
+
+  return true;
+}
+
 bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
 {
   bridge_scrypt_yescrypt_t *bridge_scrypt_yescrypt = platform_context;
@@ -256,6 +334,39 @@ bool launch_loop (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_pa
   return true;
 }
 
+bool launch_comp (MAYBE_UNUSED void *platform_context, MAYBE_UNUSED hc_device_param_t *device_param, MAYBE_UNUSED hashconfig_t *hashconfig, MAYBE_UNUSED hashes_t *hashes, MAYBE_UNUSED const u32 salt_pos, MAYBE_UNUSED const u64 pws_cnt)
+{
+  // 2nd pbkdf2, same as m70100_comp (), the kernel compares the first 16 bytes of the digest and so do we
+
+  salt_t *salts_buf = (salt_t *) hashes->salts_buf;
+
+  salt_t *salt_buf = &salts_buf[salt_pos];
+
+  const size_t x_bytes = 128 * salt_buf->scrypt_r * salt_buf->scrypt_p;
+
+  const u8 *digests_buf = (const u8 *) hashes->digests_buf + ((size_t) salt_buf->digests_offset * hashconfig->dgst_size);
+
+  scrypt_tmp_t *scrypt_tmp = (scrypt_tmp_t *) device_param->h_tmps;
+
+  pw_t *pws = device_param->h_pws;
+
+  for (u64 pw_cnt = 0; pw_cnt < pws_cnt; pw_cnt++)
+  {
+    u8 out[32];
+
+    PBKDF2_SHA256 ((const u8 *) pws[pw_cnt].i, pws[pw_cnt].pw_len, (const u8 *) scrypt_tmp[pw_cnt].B, x_bytes, 1, out, sizeof (out));
+
+    for (u32 digest_pos = 0; digest_pos < salt_buf->digests_cnt; digest_pos++)
+    {
+      if (memcmp (out, digests_buf + ((size_t) digest_pos * hashconfig->dgst_size), 16) != 0) continue;
+
+      bridges_mark_hash (device_param, hashes, salt_pos, digest_pos, pw_cnt);
+    }
+  }
+
+  return true;
+}
+
 void bridge_init (bridge_ctx_t *bridge_ctx)
 {
   bridge_ctx->bridge_context_size       = BRIDGE_CONTEXT_SIZE_CURRENT;
@@ -266,12 +377,14 @@ void bridge_init (bridge_ctx_t *bridge_ctx)
   bridge_ctx->get_unit_count      = get_unit_count;
   bridge_ctx->get_unit_info       = get_unit_info;
   bridge_ctx->get_workitem_count  = get_workitem_count;
-  bridge_ctx->thread_init         = BRIDGE_DEFAULT;
+  bridge_ctx->thread_init         = thread_init;
   bridge_ctx->thread_term         = BRIDGE_DEFAULT;
   bridge_ctx->salt_prepare        = salt_prepare;
   bridge_ctx->salt_destroy        = salt_destroy;
+  bridge_ctx->launch_init         = launch_init;
   bridge_ctx->launch_loop         = launch_loop;
   bridge_ctx->launch_loop2        = BRIDGE_DEFAULT;
+  bridge_ctx->launch_comp         = launch_comp;
   bridge_ctx->st_update_hash      = BRIDGE_DEFAULT;
   bridge_ctx->st_update_pass      = BRIDGE_DEFAULT;
 }
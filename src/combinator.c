@@ -33,6 +33,10 @@ int combinator_ctx_init (hashcat_ctx_t *hashcat_ctx)
 
   combinator_ctx->enabled = true;
 
+  // precompile has no wordlists, the kernels do not depend on them
+
+  if (user_options->kernel_precompile == true) return 0;
+
   if (user_options->slow_candidates == true)
   {
     // this is always need to be COMBINATOR_MODE_BASE_LEFT
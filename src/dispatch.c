@@ -18,6 +18,9 @@
 #include "dispatch.h"
 #include "generic.h"
 #include "convert.h"
+#include "status.h"
+#include "timer.h"
+#include "trace.h"
 
 #ifdef WITH_BRAIN
 #include "brain.h"
@@ -83,15 +86,53 @@ static int set_kernel_power_final (hashcat_ctx_t *hashcat_ctx, const u64 kernel_
   return 0;
 }
 
-static u64 get_power (backend_ctx_t *backend_ctx, hc_device_param_t *device_param)
+static double get_device_factor (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  // prefer the measured speed, hardware_power does not know how fast a device actually is
+  // and a slow device with a high hardware_power would get a final chunk all others have to wait for
+
+  double speed_all = 0;
+
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param_dev = &backend_ctx->devices_param[backend_devices_idx];
+
+    if (device_param_dev->skipped == true) continue;
+    if (device_param_dev->skipped_warning == true) continue;
+
+    const double speed_dev = status_get_hashes_msec_dev (hashcat_ctx, backend_devices_idx);
+
+    // no speed yet for one of the devices, so we can not compare them
+
+    if (speed_dev <= 0) return (double) device_param->hardware_power / backend_ctx->hardware_power_all;
+
+    speed_all += speed_dev;
+  }
+
+  const double speed_dev = status_get_hashes_msec_dev (hashcat_ctx, device_param->device_id);
+
+  if ((speed_all <= 0) || (speed_dev <= 0)) return (double) device_param->hardware_power / backend_ctx->hardware_power_all;
+
+  return speed_dev / speed_all;
+}
+
+static u64 get_power (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 words_left)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
   const u64 kernel_power_final = backend_ctx->kernel_power_final;
 
   if (kernel_power_final)
   {
-    const double device_factor = (double) device_param->hardware_power / backend_ctx->hardware_power_all;
+    // the share is taken from what is left at the time of the request, not from kernel_power_final.
+    // chunks get smaller towards the end and a device which finished early comes back for the rest,
+    // instead of a single large final chunk per device
 
-    const u64 words_left_device = (u64) CEIL (kernel_power_final * device_factor);
+    const double device_factor = get_device_factor (hashcat_ctx, device_param);
+
+    const u64 words_left_device = (u64) CEIL (words_left * device_factor);
 
     // work should be at least the hardware power available without any accelerator
 
@@ -107,18 +148,22 @@ static u64 get_power (backend_ctx_t *backend_ctx, hc_device_param_t *device_para
   return device_param->kernel_power;
 }
 
-static u64 get_work (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 max)
+static u64 get_work_at (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 max, u64 *words_off_out, const trace_lane_t trace_lane)
 {
   backend_ctx_t  *backend_ctx  = hashcat_ctx->backend_ctx;
   status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
   user_options_t *user_options = hashcat_ctx->user_options;
 
+  const double trace_ts = trace_begin (hashcat_ctx);
+
   hc_thread_mutex_lock (status_ctx->mux_dispatcher);
 
+  trace_end (hashcat_ctx, device_param, trace_lane, "dispatcher_wait", trace_ts);
+
   const u64 words_off  = status_ctx->words_off;
   const u64 words_base = (user_options->limit == 0) ? status_ctx->words_base : MIN (user_options->limit, status_ctx->words_base);
 
-  device_param->words_off = words_off;
+  *words_off_out = words_off;
 
   const u64 kernel_power_all = backend_ctx->kernel_power_all;
 
@@ -132,7 +177,7 @@ static u64 get_work (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
     }
   }
 
-  const u64 kernel_power = get_power (backend_ctx, device_param);
+  const u64 kernel_power = get_power (hashcat_ctx, device_param, words_left);
 
   u64 work = MIN (words_left, kernel_power);
 
@@ -145,152 +190,590 @@ static u64 get_work (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param
   return work;
 }
 
-static int calc_stdin (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+static u64 get_work (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 max)
 {
-  user_options_t       *user_options       = hashcat_ctx->user_options;
-  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
-  hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
-  hashes_t             *hashes             = hashcat_ctx->hashes;
-  straight_ctx_t       *straight_ctx       = hashcat_ctx->straight_ctx;
-  status_ctx_t         *status_ctx         = hashcat_ctx->status_ctx;
+  u64 words_off = 0;
 
-  const u32 attack_mode = user_options->attack_mode;
-  const u32 attack_kern = user_options_extra->attack_kern;
+  const u64 work = get_work_at (hashcat_ctx, device_param, max, &words_off, TRACE_LANE_DEVICE);
 
-  char *buf = (char *) hcmalloc (HCBUFSIZ_LARGE);
+  device_param->words_off = words_off;
 
-  bool iconv_enabled = false;
+  return work;
+}
 
-  iconv_t iconv_ctx = NULL;
+static stdin_block_t *stdin_block_wait (status_ctx_t *status_ctx, const stdin_block_state_t state_from, const stdin_block_state_t state_to, const stdin_block_state_t state_last)
+{
+  stdin_pipe_t *stdin_pipe = status_ctx->stdin_pipe;
 
-  char *iconv_tmp = NULL;
+  // oldest block first, so candidates reach the devices roughly in the order they were read.
+  // returns NULL once the pipe is stopped, or the reader has finished and no block in a state up to state_last is left
 
-  if (strcmp (user_options->encoding_from, user_options->encoding_to) != 0)
-  {
-    iconv_enabled = true;
+  stdin_block_t *block = NULL;
 
-    iconv_ctx = iconv_open (user_options->encoding_to, user_options->encoding_from);
+  hc_thread_mutex_lock (stdin_pipe->mux_stdin_pipe);
 
-    if (iconv_ctx == (iconv_t) -1)
+  while ((stdin_pipe->stop == false) && (status_ctx->run_thread_level1 == true))
+  {
+    bool done = stdin_pipe->reader_done;
+
+    for (int blocks_idx = 0; blocks_idx < stdin_pipe->blocks_cnt; blocks_idx++)
     {
-      hcfree (buf);
+      stdin_block_t *block_cur = stdin_pipe->blocks + blocks_idx;
 
-      return -1;
+      if ((block_cur->state >= STDIN_BLOCK_READ) && (block_cur->state <= state_last)) done = false;
+
+      if (block_cur->state != state_from) continue;
+
+      if ((block == NULL) || (block_cur->seq < block->seq)) block = block_cur;
     }
 
-    iconv_tmp = (char *) hcmalloc (HCBUFSIZ_TINY);
+    if (block) break;
+
+    if (done == true) break;
+
+    hc_thread_cond_wait (stdin_pipe->cond_stdin_pipe, stdin_pipe->mux_stdin_pipe);
   }
 
-  while (status_ctx->run_thread_level1 == true)
+  if (block) block->state = state_to;
+
+  hc_thread_mutex_unlock (stdin_pipe->mux_stdin_pipe);
+
+  return block;
+}
+
+static void stdin_block_set (stdin_pipe_t *stdin_pipe, stdin_block_t *block, const stdin_block_state_t state)
+{
+  hc_thread_mutex_lock (stdin_pipe->mux_stdin_pipe);
+
+  block->state = state;
+
+  hc_thread_cond_broadcast (stdin_pipe->cond_stdin_pipe);
+
+  hc_thread_mutex_unlock (stdin_pipe->mux_stdin_pipe);
+}
+
+static void stdin_pipe_wakeup (stdin_pipe_t *stdin_pipe)
+{
+  hc_thread_mutex_lock (stdin_pipe->mux_stdin_pipe);
+
+  hc_thread_cond_broadcast (stdin_pipe->cond_stdin_pipe);
+
+  hc_thread_mutex_unlock (stdin_pipe->mux_stdin_pipe);
+}
+
+#if defined (_WIN32) || defined (__WIN32__)
+static HC_API_CALL DWORD thread_stdin_reader (void *p)
+#else
+static HC_API_CALL void *thread_stdin_reader (void *p)
+#endif
+{
+  hashcat_ctx_t *hashcat_ctx = (hashcat_ctx_t *) p;
+
+  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  stdin_pipe_t *stdin_pipe = status_ctx->stdin_pipe;
+
+  const int fd = fileno (stdin);
+
+  // incomplete line (or record) at the end of a block, moved to the start of the next one
+
+  char *carry_buf = (char *) hcmalloc (STDIN_BLOCK_SIZE);
+  u64   carry_len = 0;
+
+  bool eof = false;
+
+  while (eof == false)
   {
-    hc_thread_mutex_lock (status_ctx->mux_dispatcher);
+    stdin_block_t *block = stdin_block_wait (status_ctx, STDIN_BLOCK_FREE, STDIN_BLOCK_READING, STDIN_BLOCK_READ);
 
-    if (feof (stdin) != 0)
-    {
-      hc_thread_mutex_unlock (status_ctx->mux_dispatcher);
+    if (block == NULL) break;
 
-      break;
-    }
+    memcpy (block->raw_buf, carry_buf, carry_len);
 
-    u64 words_extra_total = 0;
+    u64 len = carry_len;
 
-    memset (device_param->pws_comp, 0, device_param->size_pws_comp);
-    memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+    carry_len = 0;
 
-    #define DISABLE_READ_TIMEOUT_AFTER 1000
+    // wait for new data, the carry alone can not make a complete line (or record).
+    // once there is some, hand over whatever is available without blocking
 
-    int selects_returned = 0;
+    u64 len_read = 0;
 
-    while (device_param->pws_cnt < device_param->kernel_power)
+    while (len < STDIN_BLOCK_SIZE)
     {
-      if (selects_returned < DISABLE_READ_TIMEOUT_AFTER)
+      const int rc_select = select_read_timeout_console ((len_read == 0) ? 1 : 0);
+
+      if (rc_select == -1)
       {
-        const int rc_select = select_read_timeout_console (1);
+        eof = true;
 
-        if (rc_select == -1) break;
+        break;
+      }
 
-        if (rc_select == 0)
+      if (rc_select == 0)
+      {
+        if (stdin_pipe->stop == true)
         {
-          if (status_ctx->run_thread_level1 == false) break;
-
-          status_ctx->stdin_read_timeout_cnt++;
+          eof = true;
 
-          continue;
+          break;
         }
 
-        status_ctx->stdin_read_timeout_cnt = 0;
+        if (len_read > 0) break;
+
+        status_ctx->stdin_read_timeout_cnt++;
+
+        // give the devices a chance to notice an abort while stdin is idle
 
-        selects_returned++;
+        stdin_pipe_wakeup (stdin_pipe);
+
+        continue;
       }
 
-      char *line_buf = fgets (buf, HCBUFSIZ_LARGE - 1, stdin);
+      status_ctx->stdin_read_timeout_cnt = 0;
 
-      if (line_buf == NULL) break;
+      const ssize_t nread = read (fd, block->raw_buf + len, STDIN_BLOCK_SIZE - len);
 
-      size_t line_len = in_superchop (line_buf);
+      if (nread == -1)
+      {
+        if (errno == EINTR) continue;
 
-      line_len = convert_from_hex (hashcat_ctx, line_buf, (u32) line_len);
+        eof = true;
 
-      // do the on-the-fly encoding
+        break;
+      }
 
-      if (iconv_enabled == true)
+      if (nread == 0)
+      {
+        eof = true;
+
+        break;
+      }
+
+      len      += nread;
+      len_read += nread;
+    }
+
+    // only complete lines (or records) go to the parsers, the rest waits for the next read
+
+    u64 raw_len = len;
+
+    if (eof == false)
+    {
+      if (user_options->binary_candidates == true)
       {
-        char  *iconv_ptr = iconv_tmp;
-        size_t iconv_sz  = HCBUFSIZ_TINY;
+        raw_len = 0;
+
+        while ((raw_len + 2) <= len)
+        {
+          const u64 record_len = 2 + ((u64) (u8) block->raw_buf[raw_len + 0] | ((u64) (u8) block->raw_buf[raw_len + 1] << 8));
 
-        if (iconv (iconv_ctx, &line_buf, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
+          if ((raw_len + record_len) > len) break;
 
-        line_buf = iconv_tmp;
-        line_len = HCBUFSIZ_TINY - iconv_sz;
+          raw_len += record_len;
+        }
       }
+      else
+      {
+        u64 nl_pos = len;
 
-      // post-process rule engine
+        while ((nl_pos > 0) && (block->raw_buf[nl_pos - 1] != '\n')) nl_pos--;
 
-      char rule_buf_out[RP_PASSWORD_SIZE];
+        if (nl_pos > 0)
+        {
+          raw_len = nl_pos;
+        }
+        else if (len < STDIN_BLOCK_SIZE)
+        {
+          raw_len = 0;
+        }
 
-      int   rule_jk_len = (int)    user_options_extra->rule_len_l;
-      const char *rule_jk_buf = user_options->rule_buf_l;
+        // a line longer than a block is handed over in pieces, like fgets () did
+      }
+    }
+    else if (user_options->binary_candidates == true)
+    {
+      // an incomplete record at the end of the stream is ignored
 
-      if (attack_mode == ATTACK_MODE_HYBRID2)
+      u64 pos = 0;
+
+      while ((pos + 2) <= len)
       {
-        rule_jk_len = (int)    user_options_extra->rule_len_r;
-        rule_jk_buf = user_options->rule_buf_r;
+        const u64 record_len = 2 + ((u64) (u8) block->raw_buf[pos + 0] | ((u64) (u8) block->raw_buf[pos + 1] << 8));
+
+        if ((pos + record_len) > len) break;
+
+        pos += record_len;
       }
 
-      if (run_rule_engine (rule_jk_len, rule_jk_buf))
+      raw_len = pos;
+    }
+
+    carry_len = len - raw_len;
+
+    memcpy (carry_buf, block->raw_buf + raw_len, carry_len);
+
+    if (raw_len == 0)
+    {
+      stdin_block_set (stdin_pipe, block, STDIN_BLOCK_FREE);
+
+      continue;
+    }
+
+    block->raw_len = raw_len;
+    block->seq     = stdin_pipe->seq++;
+
+    stdin_block_set (stdin_pipe, block, STDIN_BLOCK_READ);
+  }
+
+  hcfree (carry_buf);
+
+  hc_thread_mutex_lock (stdin_pipe->mux_stdin_pipe);
+
+  stdin_pipe->reader_done = true;
+
+  hc_thread_cond_broadcast (stdin_pipe->cond_stdin_pipe);
+
+  hc_thread_mutex_unlock (stdin_pipe->mux_stdin_pipe);
+
+  return 0;
+}
+
+static void stdin_block_push (stdin_block_t *block, const char *line_buf, const size_t line_len)
+{
+  if ((block->pws_len + 2 + line_len) > block->pws_sz)
+  {
+    block->pws_buf = (u8 *) hcrealloc (block->pws_buf, block->pws_sz, STDIN_BLOCK_SIZE);
+
+    block->pws_sz += STDIN_BLOCK_SIZE;
+  }
+
+  u8 *ptr = block->pws_buf + block->pws_len;
+
+  ptr[0] = (u8) (line_len >> 0);
+  ptr[1] = (u8) (line_len >> 8);
+
+  memcpy (ptr + 2, line_buf, line_len);
+
+  block->pws_len += 2 + line_len;
+}
+
+static void stdin_block_parse (hashcat_ctx_t *hashcat_ctx, stdin_block_t *block, iconv_t iconv_ctx, char *iconv_tmp)
+{
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const user_options_t       *user_options       = hashcat_ctx->user_options;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  const u32 attack_mode = user_options->attack_mode;
+  const u32 attack_kern = user_options_extra->attack_kern;
+
+  block->pws_len  = 0;
+  block->pws_pos  = 0;
+  block->rejected = 0;
+
+  char *ptr = block->raw_buf;
+  char *end = block->raw_buf + block->raw_len;
+
+  while (ptr < end)
+  {
+    char  *line_buf = ptr;
+    size_t line_len = 0;
+
+    if (user_options->binary_candidates == true)
+    {
+      // u16 little-endian length followed by the candidate, no delimiter and no $HEX[] decoding
+
+      line_len = (size_t) (u8) ptr[0] | ((size_t) (u8) ptr[1] << 8);
+
+      line_buf = ptr + 2;
+
+      ptr += 2 + line_len;
+    }
+    else
+    {
+      char *line_end = (char *) memchr (ptr, '\n', end - ptr);
+
+      if (line_end == NULL) line_end = end; // raw_buf has room for the terminator
+
+      *line_end = 0;
+
+      ptr = line_end + 1;
+
+      line_len = in_superchop (line_buf);
+
+      line_len = convert_from_hex (hashcat_ctx, line_buf, (u32) line_len);
+    }
+
+    // do the on-the-fly encoding
+
+    if (iconv_tmp != NULL)
+    {
+      char  *iconv_ptr = iconv_tmp;
+      size_t iconv_sz  = HCBUFSIZ_TINY;
+
+      if (iconv (iconv_ctx, &line_buf, &line_len, &iconv_ptr, &iconv_sz) == (size_t) -1) continue;
+
+      line_buf = iconv_tmp;
+      line_len = HCBUFSIZ_TINY - iconv_sz;
+    }
+
+    // post-process rule engine
+
+    char rule_buf_out[RP_PASSWORD_SIZE];
+
+    int   rule_jk_len = (int)    user_options_extra->rule_len_l;
+    const char *rule_jk_buf = user_options->rule_buf_l;
+
+    if (attack_mode == ATTACK_MODE_HYBRID2)
+    {
+      rule_jk_len = (int)    user_options_extra->rule_len_r;
+      rule_jk_buf = user_options->rule_buf_r;
+    }
+
+    if (run_rule_engine (rule_jk_len, rule_jk_buf))
+    {
+      if (line_len >= RP_PASSWORD_SIZE) continue;
+
+      memset (rule_buf_out, 0, sizeof (rule_buf_out));
+
+      const int rule_len_out = _old_apply_rule (rule_jk_buf, rule_jk_len, line_buf, (int) line_len, rule_buf_out);
+
+      if (rule_len_out < 0) continue;
+
+      line_buf = rule_buf_out;
+      line_len = (size_t) rule_len_out;
+    }
+
+    if (line_len > PW_MAX) continue;
+
+    // hmm that's always the case, or?
+
+    if (attack_kern == ATTACK_KERN_STRAIGHT)
+    {
+      if ((line_len < hashconfig->pw_min) || (line_len > hashconfig->pw_max))
       {
-        if (line_len >= RP_PASSWORD_SIZE) continue;
+        block->rejected++;
 
-        memset (rule_buf_out, 0, sizeof (rule_buf_out));
+        continue;
+      }
+    }
 
-        const int rule_len_out = _old_apply_rule (rule_jk_buf, rule_jk_len, line_buf, (int) line_len, rule_buf_out);
+    stdin_block_push (block, line_buf, line_len);
+  }
+}
 
-        if (rule_len_out < 0) continue;
+#if defined (_WIN32) || defined (__WIN32__)
+static HC_API_CALL DWORD thread_stdin_parser (void *p)
+#else
+static HC_API_CALL void *thread_stdin_parser (void *p)
+#endif
+{
+  stdin_parser_t *stdin_parser = (stdin_parser_t *) p;
 
-        line_buf = rule_buf_out;
-        line_len = (size_t) rule_len_out;
+  hashcat_ctx_t *hashcat_ctx = stdin_parser->hashcat_ctx;
+
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
+
+  stdin_pipe_t *stdin_pipe = status_ctx->stdin_pipe;
+
+  while (true)
+  {
+    stdin_block_t *block = stdin_block_wait (status_ctx, STDIN_BLOCK_READ, STDIN_BLOCK_PARSING, STDIN_BLOCK_READ);
+
+    if (block == NULL) break;
+
+    stdin_block_parse (hashcat_ctx, block, stdin_parser->iconv_ctx, stdin_parser->iconv_tmp);
+
+    stdin_block_set (stdin_pipe, block, STDIN_BLOCK_PARSED);
+  }
+
+  return 0;
+}
+
+int stdin_pipe_init (hashcat_ctx_t *hashcat_ctx)
+{
+  backend_ctx_t  *backend_ctx  = hashcat_ctx->backend_ctx;
+  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  /**
+   * a single reader pulls large blocks from stdin, a pool of parsers splits them into candidates
+   * and applies the -j/-k rule, the device threads only copy the ready candidates into their pws_buf
+   */
+
+  stdin_pipe_t *stdin_pipe = (stdin_pipe_t *) hcmalloc (sizeof (stdin_pipe_t));
+
+  stdin_pipe->parsers_cnt = MAX (1, MIN (hc_get_processor_count (), STDIN_PARSERS_MAX));
+  stdin_pipe->blocks_cnt  = (stdin_pipe->parsers_cnt * 2) + (backend_ctx->backend_devices_cnt * 2);
+
+  stdin_pipe->parsers = (stdin_parser_t *) hccalloc (stdin_pipe->parsers_cnt, sizeof (stdin_parser_t));
+
+  for (int parsers_idx = 0; parsers_idx < stdin_pipe->parsers_cnt; parsers_idx++)
+  {
+    stdin_parser_t *stdin_parser = stdin_pipe->parsers + parsers_idx;
+
+    stdin_parser->hashcat_ctx = hashcat_ctx;
+    stdin_parser->iconv_ctx   = NULL;
+    stdin_parser->iconv_tmp   = NULL;
+
+    if (strcmp (user_options->encoding_from, user_options->encoding_to) == 0) continue;
+
+    stdin_parser->iconv_ctx = iconv_open (user_options->encoding_to, user_options->encoding_from);
+
+    if (stdin_parser->iconv_ctx == (iconv_t) -1)
+    {
+      event_log_error (hashcat_ctx, "iconv_open: %s", strerror (errno));
+
+      for (int i = 0; i < parsers_idx; i++)
+      {
+        iconv_close (stdin_pipe->parsers[i].iconv_ctx);
+
+        hcfree (stdin_pipe->parsers[i].iconv_tmp);
       }
 
-      if (line_len > PW_MAX) continue;
+      hcfree (stdin_pipe->parsers);
+      hcfree (stdin_pipe);
 
-      // hmm that's always the case, or?
+      return -1;
+    }
 
-      if (attack_kern == ATTACK_KERN_STRAIGHT)
+    stdin_parser->iconv_tmp = (char *) hcmalloc (HCBUFSIZ_TINY);
+  }
+
+  stdin_pipe->blocks = (stdin_block_t *) hccalloc (stdin_pipe->blocks_cnt, sizeof (stdin_block_t));
+
+  for (int blocks_idx = 0; blocks_idx < stdin_pipe->blocks_cnt; blocks_idx++)
+  {
+    stdin_block_t *block = stdin_pipe->blocks + blocks_idx;
+
+    block->state   = STDIN_BLOCK_FREE;
+    block->raw_buf = (char *) hcmalloc (STDIN_BLOCK_SIZE + 1);
+    block->pws_buf = (u8 *)   hcmalloc (STDIN_BLOCK_SIZE);
+    block->pws_sz  = STDIN_BLOCK_SIZE;
+  }
+
+  stdin_pipe->seq         = 0;
+  stdin_pipe->reader_done = false;
+  stdin_pipe->stop        = false;
+
+  hc_thread_mutex_init (stdin_pipe->mux_stdin_pipe);
+  hc_thread_cond_init  (stdin_pipe->cond_stdin_pipe);
+
+  status_ctx->stdin_pipe = stdin_pipe;
+
+  hc_thread_create (stdin_pipe->reader_thread, thread_stdin_reader, hashcat_ctx);
+
+  stdin_pipe->parsers_threads = (hc_thread_t *) hccalloc (stdin_pipe->parsers_cnt, sizeof (hc_thread_t));
+
+  for (int parsers_idx = 0; parsers_idx < stdin_pipe->parsers_cnt; parsers_idx++)
+  {
+    hc_thread_create (stdin_pipe->parsers_threads[parsers_idx], thread_stdin_parser, stdin_pipe->parsers + parsers_idx);
+  }
+
+  return 0;
+}
+
+void stdin_pipe_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
+
+  stdin_pipe_t *stdin_pipe = status_ctx->stdin_pipe;
+
+  if (stdin_pipe == NULL) return;
+
+  // the devices are finished, if they stopped early (abort, all cracked) the reader and parsers stop too
+
+  hc_thread_mutex_lock (stdin_pipe->mux_stdin_pipe);
+
+  stdin_pipe->stop = true;
+
+  hc_thread_cond_broadcast (stdin_pipe->cond_stdin_pipe);
+
+  hc_thread_mutex_unlock (stdin_pipe->mux_stdin_pipe);
+
+  hc_thread_wait (1, &stdin_pipe->reader_thread);
+
+  hc_thread_wait (stdin_pipe->parsers_cnt, stdin_pipe->parsers_threads);
+
+  hcfree (stdin_pipe->parsers_threads);
+
+  for (int parsers_idx = 0; parsers_idx < stdin_pipe->parsers_cnt; parsers_idx++)
+  {
+    stdin_parser_t *stdin_parser = stdin_pipe->parsers + parsers_idx;
+
+    if (stdin_parser->iconv_tmp == NULL) continue;
+
+    iconv_close (stdin_parser->iconv_ctx);
+
+    hcfree (stdin_parser->iconv_tmp);
+  }
+
+  hcfree (stdin_pipe->parsers);
+
+  for (int blocks_idx = 0; blocks_idx < stdin_pipe->blocks_cnt; blocks_idx++)
+  {
+    stdin_block_t *block = stdin_pipe->blocks + blocks_idx;
+
+    hcfree (block->raw_buf);
+    hcfree (block->pws_buf);
+  }
+
+  hcfree (stdin_pipe->blocks);
+
+  hc_thread_cond_delete  (stdin_pipe->cond_stdin_pipe);
+  hc_thread_mutex_delete (stdin_pipe->mux_stdin_pipe);
+
+  hcfree (stdin_pipe);
+
+  status_ctx->stdin_pipe = NULL;
+}
+
+static int calc_stdin (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  hashes_t             *hashes             = hashcat_ctx->hashes;
+  straight_ctx_t       *straight_ctx       = hashcat_ctx->straight_ctx;
+  status_ctx_t         *status_ctx         = hashcat_ctx->status_ctx;
+
+  stdin_pipe_t *stdin_pipe = status_ctx->stdin_pipe;
+
+  stdin_block_t *block = NULL;
+
+  while (status_ctx->run_thread_level1 == true)
+  {
+    u64 words_extra_total = 0;
+
+    memset (device_param->pws_comp, 0, device_param->size_pws_comp);
+    memset (device_param->pws_idx,  0, device_param->size_pws_idx);
+
+    while (device_param->pws_cnt < device_param->kernel_power)
+    {
+      if (block == NULL)
       {
-        if ((line_len < hashconfig->pw_min) || (line_len > hashconfig->pw_max))
-        {
-          words_extra_total++;
+        block = stdin_block_wait (status_ctx, STDIN_BLOCK_PARSED, STDIN_BLOCK_CONSUMING, STDIN_BLOCK_PARSED);
+
+        if (block == NULL) break;
+
+        words_extra_total += block->rejected;
+      }
+
+      if (block->pws_pos == block->pws_len)
+      {
+        stdin_block_set (stdin_pipe, block, STDIN_BLOCK_FREE);
+
+        block = NULL;
 
-          continue;
-        }
+        continue;
       }
 
-      pw_add (device_param, (const u8 *) line_buf, (const int) line_len);
+      const u8 *ptr = block->pws_buf + block->pws_pos;
 
-      if (status_ctx->run_thread_level1 == false) break;
-    }
+      const int pw_len = (int) ptr[0] | ((int) ptr[1] << 8);
 
-    hc_thread_mutex_unlock (status_ctx->mux_dispatcher);
+      pw_add (device_param, ptr + 2, pw_len);
+
+      block->pws_pos += 2 + pw_len;
+    }
 
     if (words_extra_total > 0)
     {
@@ -312,14 +795,14 @@ static int calc_stdin (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_par
 
     if (run_copy (hashcat_ctx, device_param, device_param->pws_cnt) == -1)
     {
-      hcfree (buf);
+      if (block) stdin_block_set (stdin_pipe, block, STDIN_BLOCK_FREE);
 
       return -1;
     }
 
     if (run_cracker (hashcat_ctx, device_param, -1, device_param->pws_cnt) == -1) // no pws_pos?
     {
-      hcfree (buf);
+      if (block) stdin_block_set (stdin_pipe, block, STDIN_BLOCK_FREE);
 
       return -1;
     }
@@ -331,6 +814,8 @@ static int calc_stdin (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_par
     if (device_param->speed_only_finish == true) break;
   }
 
+  if (block) stdin_block_set (stdin_pipe, block, STDIN_BLOCK_FREE);
+
   device_param->kernel_accel_prev   = device_param->kernel_accel;
   device_param->kernel_loops_prev   = device_param->kernel_loops;
   device_param->kernel_threads_prev = device_param->kernel_threads;
@@ -339,15 +824,6 @@ static int calc_stdin (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_par
   device_param->kernel_loops   = 0;
   device_param->kernel_threads = 0;
 
-  if (iconv_enabled == true)
-  {
-    iconv_close (iconv_ctx);
-
-    hcfree (iconv_tmp);
-  }
-
-  hcfree (buf);
-
   return 0;
 }
 
@@ -413,6 +889,218 @@ HC_API_CALL void *thread_calc_stdin (void *p)
   return 0;
 }
 
+static void calc_prep (calc_prep_t *calc_prep)
+{
+  hashcat_ctx_t     *hashcat_ctx     = calc_prep->hashcat_ctx;
+  hashcat_ctx_t     *hashcat_ctx_tmp = calc_prep->hashcat_ctx_tmp;
+  hc_device_param_t *device_param    = calc_prep->device_param;
+
+  hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  status_ctx_t         *status_ctx         = hashcat_ctx->status_ctx;
+  user_options_t       *user_options       = hashcat_ctx->user_options;
+  user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  const u32 attack_mode = user_options->attack_mode;
+  const u32 attack_kern = user_options_extra->attack_kern;
+
+  /**
+   * fills the *_next buffers, so it must not touch anything the device thread
+   * uses for the batch in flight, including device_param->words_off
+   */
+
+  HCFILE *fp = calc_prep->fp;
+
+  const double trace_ts = trace_begin (hashcat_ctx);
+
+  u64 words_cur = calc_prep->words_cur;
+  u64 words_off = 0;
+  u64 words_fin = 0;
+  u64 words_extra = -1U;
+  u64 words_extra_total = 0;
+
+  device_param->pws_cnt_next = 0;
+
+  memset (device_param->pws_comp_next, 0, device_param->size_pws_comp);
+  memset (device_param->pws_idx_next,  0, device_param->size_pws_idx);
+
+  while (words_extra)
+  {
+    const u64 work = get_work_at (hashcat_ctx, device_param, words_extra, &words_off, TRACE_LANE_PREP);
+
+    if (work == 0) break;
+
+    words_extra = 0;
+
+    words_fin = words_off + work;
+
+    char *line_buf;
+    u32   line_len;
+
+    char rule_buf_out[RP_PASSWORD_SIZE];
+
+    for ( ; words_cur < words_off; words_cur++) get_next_word (hashcat_ctx_tmp, fp, &line_buf, &line_len);
+
+    for ( ; words_cur < words_fin; words_cur++)
+    {
+      get_next_word (hashcat_ctx_tmp, fp, &line_buf, &line_len);
+
+      // post-process rule engine
+
+      int   rule_jk_len = (int)    user_options_extra->rule_len_l;
+      const char *rule_jk_buf = user_options->rule_buf_l;
+
+      if (attack_mode == ATTACK_MODE_HYBRID2)
+      {
+        rule_jk_len = (int)    user_options_extra->rule_len_r;
+        rule_jk_buf = user_options->rule_buf_r;
+      }
+
+      if (run_rule_engine (rule_jk_len, rule_jk_buf))
+      {
+        if (line_len >= RP_PASSWORD_SIZE) continue;
+
+        memset (rule_buf_out, 0, sizeof (rule_buf_out));
+
+        const int rule_len_out = _old_apply_rule (rule_jk_buf, rule_jk_len, line_buf, (int) line_len, rule_buf_out);
+
+        if (rule_len_out < 0) continue;
+
+        line_buf = rule_buf_out;
+        line_len = (u32) rule_len_out;
+      }
+
+      /*
+
+      if (attack_mode == ATTACK_MODE_ASSOCIATION)
+      {
+        // we can't reject password base on length in -a 9 because it will bring the schedule out of sync
+        // therefore we render it defective so the other candidates survive
+
+        line_len = MAX (line_len, hashconfig->pw_min);
+        line_len = MIN (line_len, hashconfig->pw_max);
+      }
+
+      This strategy turns out not to work very well. If there's a candidate shorter than pw_min, this leads to situation the \n is copied, too.
+
+      To reproduce:
+
+      $ cat hash
+      WPA*01*4d4fe7aac3a2cecab195321ceb99a7d0*fc690c158264*f4747f87f9f4*686173686361742d6573736964***
+      $ cat word
+      hashcat
+      $ ./hashcat -m 22000 -a 9 hash word
+      ...
+      Candidates.#1....: $HEX[686173686361740a21] -> $HEX[686173686361740a21]
+      ...
+      */
+
+      // This is a test fix for the above situation
+
+      if (attack_kern == ATTACK_KERN_STRAIGHT)
+      {
+        if (attack_mode == ATTACK_MODE_ASSOCIATION)
+        {
+          // do nothing, test fix for above scenario
+        }
+        else
+        {
+          if ((line_len < hashconfig->pw_min) || (line_len > hashconfig->pw_max))
+          {
+            words_extra++;
+
+            continue;
+          }
+        }
+      }
+      else if (attack_kern == ATTACK_KERN_COMBI)
+      {
+        // do not check if minimum restriction is satisfied (line_len >= hashconfig->pw_min) here
+        // since we still need to combine the plains
+
+        if (line_len > hashconfig->pw_max)
+        {
+          words_extra++;
+
+          continue;
+        }
+      }
+
+      pw_add_to (device_param, device_param->pws_comp_next, device_param->pws_idx_next, &device_param->pws_cnt_next, (const u8 *) line_buf, (const int) line_len);
+
+      if (status_ctx->run_thread_level1 == false) break;
+    }
+
+    words_extra_total += words_extra;
+
+    if (status_ctx->run_thread_level1 == false) break;
+  }
+
+  calc_prep->words_cur         = words_cur;
+  calc_prep->words_off         = words_off;
+  calc_prep->words_fin         = words_fin;
+  calc_prep->words_extra_total = words_extra_total;
+
+  trace_end (hashcat_ctx, device_param, TRACE_LANE_PREP, "read_words", trace_ts);
+}
+
+#if defined (_WIN32) || defined (__WIN32__)
+static HC_API_CALL DWORD thread_calc_prep (void *p)
+#else
+static HC_API_CALL void *thread_calc_prep (void *p)
+#endif
+{
+  calc_prep_t *calc_prep_param = (calc_prep_t *) p;
+
+  hc_thread_mutex_lock (calc_prep_param->mux_prep);
+
+  while (true)
+  {
+    while ((calc_prep_param->requested == false) && (calc_prep_param->quit == false))
+    {
+      hc_thread_cond_wait (calc_prep_param->cond_prep, calc_prep_param->mux_prep);
+    }
+
+    if (calc_prep_param->quit == true) break;
+
+    hc_thread_mutex_unlock (calc_prep_param->mux_prep);
+
+    calc_prep (calc_prep_param);
+
+    hc_thread_mutex_lock (calc_prep_param->mux_prep);
+
+    calc_prep_param->requested = false;
+
+    hc_thread_cond_broadcast (calc_prep_param->cond_prep);
+  }
+
+  hc_thread_mutex_unlock (calc_prep_param->mux_prep);
+
+  return 0;
+}
+
+static void calc_prep_request (calc_prep_t *calc_prep_param)
+{
+  hc_thread_mutex_lock (calc_prep_param->mux_prep);
+
+  calc_prep_param->requested = true;
+
+  hc_thread_cond_broadcast (calc_prep_param->cond_prep);
+
+  hc_thread_mutex_unlock (calc_prep_param->mux_prep);
+}
+
+static void calc_prep_wait (calc_prep_t *calc_prep_param)
+{
+  hc_thread_mutex_lock (calc_prep_param->mux_prep);
+
+  while (calc_prep_param->requested == true)
+  {
+    hc_thread_cond_wait (calc_prep_param->cond_prep, calc_prep_param->mux_prep);
+  }
+
+  hc_thread_mutex_unlock (calc_prep_param->mux_prep);
+}
+
 static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 {
   user_options_t       *user_options       = hashcat_ctx->user_options;
@@ -515,7 +1203,7 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
         // this greatly reduces spam on hashcat console
 
-        const u64 pre_rejects_ignore = get_power (backend_ctx, device_param) / 2;
+        const u64 pre_rejects_ignore = get_power (hashcat_ctx, device_param, backend_ctx->kernel_power_final) / 2;
 
         while (pre_rejects > pre_rejects_ignore)
         {
@@ -529,6 +1217,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           device_param->pws_pre_cnt = 0;
 
+          const double trace_ts_read = trace_begin (hashcat_ctx);
+
           while (words_extra)
           {
             u64 work = get_work (hashcat_ctx, device_param, words_extra);
@@ -614,15 +1304,21 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
             if (status_ctx->run_thread_level1 == false) break;
           }
 
+          trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "read_words", trace_ts_read);
+
           #ifdef WITH_BRAIN
           if (user_options->brain_client == true)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
+              const double trace_ts = trace_begin (hashcat_ctx);
+
               if (brain_client_lookup (device_param, status_ctx) == false)
               {
                 brain_client_disconnect (device_param);
               }
+
+              trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "brain_lookup", trace_ts);
             }
 
             u64 pws_pre_cnt = device_param->pws_pre_cnt;
@@ -827,7 +1523,7 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
         // this greatly reduces spam on hashcat console
 
-        const u64 pre_rejects_ignore = get_power (backend_ctx, device_param) / 2;
+        const u64 pre_rejects_ignore = get_power (hashcat_ctx, device_param, backend_ctx->kernel_power_final) / 2;
 
         while (pre_rejects > pre_rejects_ignore)
         {
@@ -841,6 +1537,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           device_param->pws_pre_cnt = 0;
 
+          const double trace_ts_read = trace_begin (hashcat_ctx);
+
           while (words_extra)
           {
             u64 work = get_work (hashcat_ctx, device_param, words_extra);
@@ -926,15 +1624,21 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
             if (status_ctx->run_thread_level1 == false) break;
           }
 
+          trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "read_words", trace_ts_read);
+
           #ifdef WITH_BRAIN
           if (user_options->brain_client == true)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
+              const double trace_ts = trace_begin (hashcat_ctx);
+
               if (brain_client_lookup (device_param, status_ctx) == false)
               {
                 brain_client_disconnect (device_param);
               }
+
+              trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "brain_lookup", trace_ts);
             }
 
             u64 pws_pre_cnt = device_param->pws_pre_cnt;
@@ -1092,7 +1796,7 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
         // this greatly reduces spam on hashcat console
 
-        const u64 pre_rejects_ignore = get_power (backend_ctx, device_param) / 2;
+        const u64 pre_rejects_ignore = get_power (hashcat_ctx, device_param, backend_ctx->kernel_power_final) / 2;
 
         while (pre_rejects > pre_rejects_ignore)
         {
@@ -1106,6 +1810,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
           device_param->pws_pre_cnt = 0;
 
+          const double trace_ts_read = trace_begin (hashcat_ctx);
+
           while (words_extra)
           {
             u64 work = get_work (hashcat_ctx, device_param, words_extra);
@@ -1181,15 +1887,21 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
             if (status_ctx->run_thread_level1 == false) break;
           }
 
+          trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "read_words", trace_ts_read);
+
           #ifdef WITH_BRAIN
           if (user_options->brain_client == true)
           {
             if (user_options->brain_client_features & BRAIN_CLIENT_FEATURE_HASHES)
             {
+              const double trace_ts = trace_begin (hashcat_ctx);
+
               if (brain_client_lookup (device_param, status_ctx) == false)
               {
                 brain_client_disconnect (device_param);
               }
+
+              trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "brain_lookup", trace_ts);
             }
 
             u64 pws_pre_cnt = device_param->pws_pre_cnt;
@@ -1390,6 +2102,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         memset (device_param->pws_comp, 0, device_param->size_pws_comp);
         memset (device_param->pws_idx,  0, device_param->size_pws_idx);
 
+        const double trace_ts_read = trace_begin (hashcat_ctx);
+
         while (words_extra)
         {
           const u64 work_cnt = get_work (hashcat_ctx, device_param, words_extra);
@@ -1500,6 +2214,8 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           if (status_ctx->run_thread_level1 == false) break;
         }
 
+        trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "read_words", trace_ts_read);
+
         if (status_ctx->run_thread_level1 == false) break;
 
         if (words_extra_total > 0)
@@ -1624,130 +2340,52 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         return -1;
       }
 
-      u64 words_cur = 0;
-
-      while (status_ctx->run_thread_level1 == true)
-      {
-        u64 words_off = 0;
-        u64 words_fin = 0;
-        u64 words_extra = -1U;
-        u64 words_extra_total = 0;
-
-        memset (device_param->pws_comp, 0, device_param->size_pws_comp);
-        memset (device_param->pws_idx,  0, device_param->size_pws_idx);
-
-        while (words_extra)
-        {
-          const u64 work = get_work (hashcat_ctx, device_param, words_extra);
-
-          if (work == 0) break;
-
-          words_extra = 0;
-
-          words_off = device_param->words_off;
-          words_fin = words_off + work;
-
-          char *line_buf;
-          u32   line_len;
-
-          char rule_buf_out[RP_PASSWORD_SIZE];
-
-          for ( ; words_cur < words_off; words_cur++) get_next_word (hashcat_ctx_tmp, &fp, &line_buf, &line_len);
-
-          for ( ; words_cur < words_fin; words_cur++)
-          {
-            get_next_word (hashcat_ctx_tmp, &fp, &line_buf, &line_len);
-
-            // post-process rule engine
-
-            int   rule_jk_len = (int)    user_options_extra->rule_len_l;
-            const char *rule_jk_buf = user_options->rule_buf_l;
-
-            if (attack_mode == ATTACK_MODE_HYBRID2)
-            {
-              rule_jk_len = (int)    user_options_extra->rule_len_r;
-              rule_jk_buf = user_options->rule_buf_r;
-            }
-
-            if (run_rule_engine (rule_jk_len, rule_jk_buf))
-            {
-              if (line_len >= RP_PASSWORD_SIZE) continue;
-
-              memset (rule_buf_out, 0, sizeof (rule_buf_out));
-
-              const int rule_len_out = _old_apply_rule (rule_jk_buf, rule_jk_len, line_buf, (int) line_len, rule_buf_out);
-
-              if (rule_len_out < 0) continue;
-
-              line_buf = rule_buf_out;
-              line_len = (u32) rule_len_out;
-            }
-
-            /*
-
-            if (attack_mode == ATTACK_MODE_ASSOCIATION)
-            {
-              // we can't reject password base on length in -a 9 because it will bring the schedule out of sync
-              // therefore we render it defective so the other candidates survive
-
-              line_len = MAX (line_len, hashconfig->pw_min);
-              line_len = MIN (line_len, hashconfig->pw_max);
-            }
-
-            This strategy turns out not to work very well. If there's a candidate shorter than pw_min, this leads to situation the \n is copied, too.
+      /**
+       * the next batch is read, rule-processed and packed into the *_next buffers
+       * by the prep thread of this device while the current one runs on the device,
+       * then the buffers are swapped at the batch boundary
+       */
 
-            To reproduce:
+      calc_prep_t calc_prep_param;
 
-            $ cat hash
-            WPA*01*4d4fe7aac3a2cecab195321ceb99a7d0*fc690c158264*f4747f87f9f4*686173686361742d6573736964***
-            $ cat word
-            hashcat
-            $ ./hashcat -m 22000 -a 9 hash word
-            ...
-            Candidates.#1....: $HEX[686173686361740a21] -> $HEX[686173686361740a21]
-            ...
-            */
+      calc_prep_param.hashcat_ctx       = hashcat_ctx;
+      calc_prep_param.hashcat_ctx_tmp   = hashcat_ctx_tmp;
+      calc_prep_param.device_param      = device_param;
+      calc_prep_param.fp                = &fp;
+      calc_prep_param.words_cur         = 0;
+      calc_prep_param.words_off         = 0;
+      calc_prep_param.words_fin         = 0;
+      calc_prep_param.words_extra_total = 0;
+      calc_prep_param.requested         = false;
+      calc_prep_param.quit              = false;
 
-            // This is a test fix for the above situation
+      calc_prep (&calc_prep_param);
 
-            if (attack_kern == ATTACK_KERN_STRAIGHT)
-            {
-              if (attack_mode == ATTACK_MODE_ASSOCIATION)
-              {
-                // do nothing, test fix for above scenario
-              }
-              else
-              {
-                if ((line_len < hashconfig->pw_min) || (line_len > hashconfig->pw_max))
-                {
-                  words_extra++;
+      hc_thread_mutex_init (calc_prep_param.mux_prep);
+      hc_thread_cond_init  (calc_prep_param.cond_prep);
 
-                  continue;
-                }
-              }
-            }
-            else if (attack_kern == ATTACK_KERN_COMBI)
-            {
-              // do not check if minimum restriction is satisfied (line_len >= hashconfig->pw_min) here
-              // since we still need to combine the plains
+      hc_thread_create (calc_prep_param.thread, thread_calc_prep, &calc_prep_param);
 
-              if (line_len > hashconfig->pw_max)
-              {
-                words_extra++;
+      bool prep_running = false;
 
-                continue;
-              }
-            }
+      int rc = 0;
 
-            pw_add (device_param, (const u8 *) line_buf, (const int) line_len);
+      while (status_ctx->run_thread_level1 == true)
+      {
+        pw_idx_t *pws_idx  = device_param->pws_idx;
+        u32      *pws_comp = device_param->pws_comp;
 
-            if (status_ctx->run_thread_level1 == false) break;
-          }
+        device_param->pws_idx       = device_param->pws_idx_next;
+        device_param->pws_comp      = device_param->pws_comp_next;
+        device_param->pws_cnt       = device_param->pws_cnt_next;
+        device_param->pws_idx_next  = pws_idx;
+        device_param->pws_comp_next = pws_comp;
+        device_param->pws_cnt_next  = 0;
 
-          words_extra_total += words_extra;
+        device_param->words_off = calc_prep_param.words_off;
 
-          if (status_ctx->run_thread_level1 == false) break;
-        }
+        const u64 words_fin         = calc_prep_param.words_fin;
+        const u64 words_extra_total = calc_prep_param.words_extra_total;
 
         if (status_ctx->run_thread_level1 == false) break;
 
@@ -1770,6 +2408,15 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           hc_thread_mutex_unlock (status_ctx->mux_counter);
         }
 
+        // words_fin == 0 means the dispatcher ran dry, so there is nothing left to prepare
+
+        if ((words_fin > 0) && (device_param->speed_only_finish == false))
+        {
+          calc_prep_request (&calc_prep_param);
+
+          prep_running = true;
+        }
+
         //
         // flush
         //
@@ -1780,26 +2427,16 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         {
           if (run_copy (hashcat_ctx, device_param, pws_cnt) == -1)
           {
-            if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
+            rc = -1;
 
-            hc_fclose (&fp);
-
-            hcfree (hashcat_ctx_tmp->wl_data);
-            hcfree (hashcat_ctx_tmp);
-
-            return -1;
+            break;
           }
 
           if (run_cracker (hashcat_ctx, device_param, device_param->words_off, pws_cnt) == -1)
           {
-            if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
-
-            hc_fclose (&fp);
-
-            hcfree (hashcat_ctx_tmp->wl_data);
-            hcfree (hashcat_ctx_tmp);
+            rc = -1;
 
-            return -1;
+            break;
           }
 
           device_param->pws_cnt = 0;
@@ -1833,6 +2470,19 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
           */
         }
 
+        if (prep_running == true)
+        {
+          // non-zero only if the host can't keep up with the device
+
+          const double trace_ts = trace_begin (hashcat_ctx);
+
+          calc_prep_wait (&calc_prep_param);
+
+          trace_end (hashcat_ctx, device_param, TRACE_LANE_DEVICE, "prep_wait", trace_ts);
+
+          prep_running = false;
+        }
+
         if (device_param->speed_only_finish == true) break;
 
         if (status_ctx->run_thread_level2 == true)
@@ -1847,6 +2497,37 @@ static int calc (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
         if (words_fin == 0) break;
       }
 
+      // a batch prepared ahead of a stop is dropped, words_done only covers what ran
+
+      if (prep_running == true) calc_prep_wait (&calc_prep_param);
+
+      hc_thread_mutex_lock (calc_prep_param.mux_prep);
+
+      calc_prep_param.quit = true;
+
+      hc_thread_cond_broadcast (calc_prep_param.cond_prep);
+
+      hc_thread_mutex_unlock (calc_prep_param.mux_prep);
+
+      hc_thread_wait (1, &calc_prep_param.thread);
+
+      hc_thread_cond_delete  (calc_prep_param.cond_prep);
+      hc_thread_mutex_delete (calc_prep_param.mux_prep);
+
+      if (rc == -1)
+      {
+        if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
+
+        hc_fclose (&fp);
+
+        wl_data_destroy (hashcat_ctx_tmp);
+
+        hcfree (hashcat_ctx_tmp->wl_data);
+        hcfree (hashcat_ctx_tmp);
+
+        return -1;
+      }
+
       if (attack_mode == ATTACK_MODE_COMBI) hc_fclose (&device_param->combs_fp);
 
       hc_fclose (&fp);
@@ -1915,6 +2596,12 @@ HC_API_CALL void *thread_calc (void *p)
     status_ctx->devices_status = STATUS_ERROR;
   }
 
+  // no work left for this device, from here on it waits for the others to finish their last chunk
+
+  hc_timer_set (&device_param->timer_tail_idle);
+
+  device_param->tail_idle = true;
+
   if (device_param->is_cuda == true)
   {
     if (hc_cuCtxPopCurrent (hashcat_ctx, &device_param->cuda_context) == -1) return 0;
@@ -338,7 +338,8 @@ char **scan_directory (const char *path)
 
 int folder_config_init (hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const char *install_folder, MAYBE_UNUSED const char *shared_folder)
 {
-  folder_config_t *folder_config = hashcat_ctx->folder_config;
+  folder_config_t      *folder_config = hashcat_ctx->folder_config;
+  const user_options_t *user_options  = hashcat_ctx->user_options;
 
   /**
    * There's some buggy OpenCL runtime that do not support -I.
@@ -574,15 +575,23 @@ int folder_config_init (hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const char *ins
 
   /**
    * kernel cache, we need to make sure folder exist
+   * a user defined kernel cache can be shared, for instance by all agents of a cluster
    */
 
-  char *kernels_folder = NULL;
+  char *kernels_dir = NULL;
 
-  hc_asprintf (&kernels_folder, "%s/kernels", cache_dir);
+  if (user_options->kernel_cache_dir == NULL)
+  {
+    hc_asprintf (&kernels_dir, "%s/kernels", cache_dir);
 
-  hc_mkdir (kernels_folder, 0700);
+    hc_mkdir (kernels_dir, 0700);
+  }
+  else
+  {
+    kernels_dir = hcstrdup (user_options->kernel_cache_dir);
 
-  hcfree (kernels_folder);
+    hc_mkdir_rec (kernels_dir, 0700);
+  }
 
   /**
    * store for later use
@@ -594,6 +603,7 @@ int folder_config_init (hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const char *ins
   folder_config->cache_dir    = cache_dir;
   folder_config->session_dir  = session_dir;
   folder_config->shared_dir   = shared_dir;
+  folder_config->kernels_dir  = kernels_dir;
   folder_config->cpath_real   = cpath_real;
 
   return 0;
@@ -604,6 +614,7 @@ void folder_config_destroy (hashcat_ctx_t *hashcat_ctx)
   folder_config_t *folder_config = hashcat_ctx->folder_config;
 
   hcfree (folder_config->cpath_real);
+  hcfree (folder_config->kernels_dir);
   hcfree (folder_config->cwd);
   hcfree (folder_config->install_dir);
 
@@ -46,6 +46,7 @@
 #include "status.h"
 #include "generic.h"
 #include "straight.h"
+#include "trace.h"
 #include "tuningdb.h"
 #include "user_options.h"
 #include "wordlist.h"
@@ -60,6 +61,7 @@
 
 static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 {
+  combinator_ctx_t     *combinator_ctx      = hashcat_ctx->combinator_ctx;
   hashes_t             *hashes              = hashcat_ctx->hashes;
   induct_ctx_t         *induct_ctx          = hashcat_ctx->induct_ctx;
   logfile_ctx_t        *logfile_ctx         = hashcat_ctx->logfile_ctx;
@@ -202,6 +204,8 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 
   status_ctx->devices_status = STATUS_AUTOTUNE;
 
+  hc_thread_mutex_init (backend_ctx->mux_autotune_cache);
+
   for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
   {
     thread_param_t *thread_param = threads_param + backend_devices_idx;
@@ -214,6 +218,8 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 
   hc_thread_wait (backend_ctx->backend_devices_cnt, c_threads);
 
+  hc_thread_mutex_delete (backend_ctx->mux_autotune_cache);
+
   // check for any autotune failures
   // by default, skipping device on error
   // using --force, accel/loops/threads min values are used instead of skipping
@@ -329,6 +335,20 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 
   status_ctx->accessible = true;
 
+  if (user_options_extra->wordlist_mode == WL_MODE_STDIN)
+  {
+    if (stdin_pipe_init (hashcat_ctx) == -1)
+    {
+      hcfree (c_threads);
+
+      hcfree (threads_param);
+
+      return -1;
+    }
+  }
+
+  hc_thread_mutex_init (combinator_ctx->mux_combs_cache);
+
   for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
   {
     thread_param_t *thread_param = threads_param + backend_devices_idx;
@@ -348,10 +368,32 @@ static int inner2_loop (hashcat_ctx_t *hashcat_ctx)
 
   hc_thread_wait (backend_ctx->backend_devices_cnt, c_threads);
 
+  hc_thread_mutex_delete (combinator_ctx->mux_combs_cache);
+
+  if (user_options_extra->wordlist_mode == WL_MODE_STDIN)
+  {
+    stdin_pipe_destroy (hashcat_ctx);
+  }
+
   hcfree (c_threads);
 
   hcfree (threads_param);
 
+  /**
+   * account the time the devices waited for the slowest one at the end of this pass
+   */
+
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+
+    if (device_param->tail_idle == false) continue;
+
+    device_param->tail_idle_msec += hc_timer_get (device_param->timer_tail_idle);
+
+    device_param->tail_idle = false;
+  }
+
   if ((status_ctx->devices_status == STATUS_RUNNING) && (status_ctx->checkpoint_shutdown == true))
   {
     myabort_checkpoint (hashcat_ctx);
@@ -922,6 +964,40 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx, const int iteration)
 
   EVENT (EVENT_BACKEND_SESSION_POST);
 
+  /**
+   * kernel precompile, all kernels of this hash-mode are in the kernel cache now
+   */
+
+  if (user_options->kernel_precompile == true)
+  {
+    status_ctx->devices_status = STATUS_EXHAUSTED;
+
+    // finalize backend session
+
+    backend_session_destroy (hashcat_ctx);
+
+    // clean up
+
+    #ifdef WITH_BRAIN
+    brain_ctx_destroy       (hashcat_ctx);
+    #endif
+
+    bridges_salt_destroy    (hashcat_ctx);
+    bridges_destroy         (hashcat_ctx);
+    bitmap_ctx_destroy      (hashcat_ctx);
+    combinator_ctx_destroy  (hashcat_ctx);
+    cpt_ctx_destroy         (hashcat_ctx);
+    hashconfig_destroy      (hashcat_ctx);
+    hashes_destroy          (hashcat_ctx);
+    mask_ctx_destroy        (hashcat_ctx);
+    status_progress_destroy (hashcat_ctx);
+    generic_ctx_destroy     (hashcat_ctx);
+    straight_ctx_destroy    (hashcat_ctx);
+    wl_data_destroy         (hashcat_ctx);
+
+    return 0;
+  }
+
   /**
    * create self-test threads
    */
@@ -936,6 +1012,8 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx, const int iteration)
 
     status_ctx->devices_status = STATUS_SELFTEST;
 
+    hc_thread_mutex_init (backend_ctx->mux_selftest_cache);
+
     for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
     {
       thread_param_t *thread_param = threads_param + backend_devices_idx;
@@ -948,6 +1026,8 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx, const int iteration)
 
     hc_thread_wait (backend_ctx->backend_devices_cnt, selftest_threads);
 
+    hc_thread_mutex_delete (backend_ctx->mux_selftest_cache);
+
     hcfree (threads_param);
 
     hcfree (selftest_threads);
@@ -1103,6 +1183,49 @@ static int outer_loop (hashcat_ctx_t *hashcat_ctx, const int iteration)
   return 0;
 }
 
+static int precompile_loop (hashcat_ctx_t *hashcat_ctx, int *iteration)
+{
+  module_ctx_t   *module_ctx   = hashcat_ctx->module_ctx;
+  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  // modules with JIT build options build their kernels from the hashes, there's nothing to precompile
+
+  const bool jit_build_options = (hashconfig_init (hashcat_ctx) == 0) && (module_ctx->module_jit_build_options != MODULE_DEFAULT);
+
+  hashconfig_destroy (hashcat_ctx);
+
+  if (jit_build_options == true)
+  {
+    event_log_warning (hashcat_ctx, "Hash-mode %u skipped: its kernels are built with hash specific JIT options and can't be precompiled.", user_options->hash_mode);
+    event_log_warning (hashcat_ctx, NULL);
+
+    return 0;
+  }
+
+  if (user_options->attack_mode_chgd == true)
+  {
+    return outer_loop (hashcat_ctx, (*iteration)++);
+  }
+
+  // each attack mode is part of the build options, so each one has its own kernels in the cache
+
+  const u32 attack_modes[] = { ATTACK_MODE_STRAIGHT, ATTACK_MODE_COMBI, ATTACK_MODE_BF, ATTACK_MODE_HYBRID1, ATTACK_MODE_HYBRID2 };
+
+  for (size_t i = 0; i < sizeof (attack_modes) / sizeof (attack_modes[0]); i++)
+  {
+    user_options->attack_mode = attack_modes[i];
+
+    user_options_extra_init (hashcat_ctx);
+
+    if (outer_loop (hashcat_ctx, (*iteration)++) == -1) return -1;
+
+    if (status_ctx->run_main_level1 == false) break;
+  }
+
+  return 0;
+}
+
 static void event_stub (MAYBE_UNUSED const u32 id, MAYBE_UNUSED hashcat_ctx_t *hashcat_ctx, MAYBE_UNUSED const void *buf, MAYBE_UNUSED const size_t len)
 {
 
@@ -1146,6 +1269,7 @@ int hashcat_init (hashcat_ctx_t *hashcat_ctx, void (*event) (const u32, struct h
   hashcat_ctx->restore_ctx        = (restore_ctx_t *)         hcmalloc (sizeof (restore_ctx_t));
   hashcat_ctx->status_ctx         = (status_ctx_t *)          hcmalloc (sizeof (status_ctx_t));
   hashcat_ctx->straight_ctx       = (straight_ctx_t *)        hcmalloc (sizeof (straight_ctx_t));
+  hashcat_ctx->trace_ctx          = (trace_ctx_t *)           hcmalloc (sizeof (trace_ctx_t));
   hashcat_ctx->tuning_db          = (tuning_db_t *)           hcmalloc (sizeof (tuning_db_t));
   hashcat_ctx->user_options_extra = (user_options_extra_t *)  hcmalloc (sizeof (user_options_extra_t));
   hashcat_ctx->user_options       = (user_options_t *)        hcmalloc (sizeof (user_options_t));
@@ -1183,6 +1307,7 @@ void hashcat_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (hashcat_ctx->restore_ctx);
   hcfree (hashcat_ctx->status_ctx);
   hcfree (hashcat_ctx->straight_ctx);
+  hcfree (hashcat_ctx->trace_ctx);
   hcfree (hashcat_ctx->tuning_db);
   hcfree (hashcat_ctx->user_options_extra);
   hcfree (hashcat_ctx->user_options);
@@ -1345,6 +1470,12 @@ int hashcat_session_init (hashcat_ctx_t *hashcat_ctx, const char *install_folder
 
   if (debugfile_init (hashcat_ctx) == -1) return -1;
 
+  /**
+   * trace file init
+   */
+
+  if (trace_init (hashcat_ctx) == -1) return -1;
+
   /**
    * Try to detect if all the files we're going to use are accessible in the mode we want them
    */
@@ -1844,16 +1975,16 @@ int hashcat_session_execute (hashcat_ctx_t *hashcat_ctx)
 
     user_options->quiet = true;
 
+    int iteration = 0;
+
     if (user_options->hash_mode_chgd == true)
     {
-      rc_final = outer_loop (hashcat_ctx, 0);
+      rc_final = (user_options->kernel_precompile == true) ? precompile_loop (hashcat_ctx, &iteration) : outer_loop (hashcat_ctx, 0);
 
       if (rc_final == -1) myabort (hashcat_ctx);
     }
     else
     {
-      int iteration = 0;
-
       int hash_mode = 0;
 
       while ((hash_mode = benchmark_next (hashcat_ctx)) != -1)
@@ -1863,7 +1994,7 @@ int hashcat_session_execute (hashcat_ctx_t *hashcat_ctx)
 
         user_options->hash_mode = hash_mode;
 
-        rc_final = outer_loop (hashcat_ctx, iteration++);
+        rc_final = (user_options->kernel_precompile == true) ? precompile_loop (hashcat_ctx, &iteration) : outer_loop (hashcat_ctx, iteration++);
 
         if (rc_final == -1) myabort (hashcat_ctx);
 
@@ -1932,9 +2063,9 @@ int hashcat_session_execute (hashcat_ctx_t *hashcat_ctx)
     if (backend_ctx->self_test_warnings    == true)               rc_final = -11;
   }
 
-  // special case for --stdout
+  // special case for --stdout and --kernel-precompile
 
-  if (user_options->stdout_flag == true)
+  if ((user_options->stdout_flag == true) || (user_options->kernel_precompile == true))
   {
     if (status_ctx->devices_status == STATUS_EXHAUSTED)
     {
@@ -1997,6 +2128,7 @@ int hashcat_session_destroy (hashcat_ctx_t *hashcat_ctx)
   induct_ctx_destroy          (hashcat_ctx);
   logfile_destroy             (hashcat_ctx);
   loopback_destroy            (hashcat_ctx);
+  trace_destroy               (hashcat_ctx);
   backend_ctx_devices_destroy (hashcat_ctx);
   backend_ctx_destroy         (hashcat_ctx);
   outcheck_ctx_destroy        (hashcat_ctx);
@@ -2151,5 +2283,7 @@ int hashcat_get_status (hashcat_ctx_t *hashcat_ctx, hashcat_status_t *hashcat_st
   hashcat_status->exec_msec_all   = status_get_exec_msec_all   (hashcat_ctx);
   hashcat_status->speed_sec_all   = status_get_speed_sec_all   (hashcat_ctx);
 
+  hashcat_status->tail_idle_msec_all = status_get_tail_idle_msec_all (hashcat_ctx);
+
   return 0;
 }
@@ -407,6 +407,14 @@ int check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pla
     }
   }
 
+  // a multi-salt launch holds one copy of the candidates per salt, the tmps above belong to the raw GID,
+  // but everything from here on needs the candidate, see salt_batch_size()
+
+  if (device_param->salt_batch_cnt > 1)
+  {
+    plain->gidvid = (plain->gidvid % device_param->kernel_param.salt_batch_pws) % device_param->salt_batch_pws_cnt;
+  }
+
   // hash
 
   u8 *out_buf = hashes->out_buf;
@@ -582,115 +590,14 @@ int check_hash (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, pla
 }
 
 //int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u32 salt_pos)
-int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+static int check_cracked_plains (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, plain_t *cracked, const u32 num_cracked)
 {
-  cpt_ctx_t      *cpt_ctx      = hashcat_ctx->cpt_ctx;
-  hashconfig_t   *hashconfig   = hashcat_ctx->hashconfig;
-  hashes_t       *hashes       = hashcat_ctx->hashes;
-  status_ctx_t   *status_ctx   = hashcat_ctx->status_ctx;
-  user_options_t *user_options = hashcat_ctx->user_options;
-
-  u32 num_cracked = 0;
-
-  int rc = -1;
-
-  if (device_param->is_cuda == true)
-  {
-    if (hc_cuMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->cuda_d_result, sizeof (u32)) == -1) return -1;
-
-    if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
-  }
+  cpt_ctx_t    *cpt_ctx    = hashcat_ctx->cpt_ctx;
+  hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  hashes_t     *hashes     = hashcat_ctx->hashes;
+  status_ctx_t *status_ctx = hashcat_ctx->status_ctx;
 
-  if (device_param->is_hip == true)
-  {
-    if (hc_hipMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->hip_d_result, sizeof (u32)) == -1) return -1;
-
-    if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
-  }
-
-  #if defined (__APPLE__)
-  if (device_param->is_metal == true)
-  {
-    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, &num_cracked, device_param->metal_d_result, 0, sizeof (u32)) == -1) return -1;
-  }
-  #endif
-
-  if (device_param->is_opencl == true)
-  {
-    /* blocking */
-    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_result, CL_TRUE, 0, sizeof (u32), &num_cracked, 0, NULL, NULL) == -1) return -1;
-  }
-
-  if (num_cracked == 0 || user_options->speed_only == true)
-  {
-    // we want to get the num_cracked in benchmark mode because it has an influence in performance
-    // however if the benchmark cracks the artificial hash used for benchmarks we don't want to see that!
-
-    return 0;
-  }
-
-  plain_t *cracked = (plain_t *) hcmalloc (num_cracked * sizeof (plain_t));
-
-  if (device_param->is_cuda == true)
-  {
-    rc = hc_cuMemcpyDtoH (hashcat_ctx, cracked, device_param->cuda_d_plain_bufs, num_cracked * sizeof (plain_t));
-
-    if (rc == 0)
-    {
-      rc = hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream);
-    }
-
-    if (rc == -1)
-    {
-      hcfree (cracked);
-
-      return -1;
-    }
-  }
-
-  if (device_param->is_hip == true)
-  {
-    rc = hc_hipMemcpyDtoH (hashcat_ctx, cracked, device_param->hip_d_plain_bufs, num_cracked * sizeof (plain_t));
-
-    if (rc == 0)
-    {
-      rc = hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream);
-    }
-
-    if (rc == -1)
-    {
-      hcfree (cracked);
-
-      return -1;
-    }
-  }
-
-  #if defined (__APPLE__)
-  if (device_param->is_metal == true)
-  {
-    rc = hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, cracked, device_param->metal_d_plain_bufs, 0, num_cracked * sizeof (plain_t));
-
-    if (rc == -1)
-    {
-      hcfree (cracked);
-
-      return -1;
-    }
-  }
-  #endif
-
-  if (device_param->is_opencl == true)
-  {
-    /* blocking */
-    rc = hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_plain_bufs, CL_TRUE, 0, num_cracked * sizeof (plain_t), cracked, 0, NULL, NULL);
-
-    if (rc == -1)
-    {
-      hcfree (cracked);
-
-      return -1;
-    }
-  }
+  int rc = 0;
 
   u32 cpt_cracked = 0;
 
@@ -787,8 +694,6 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
 
   hc_thread_mutex_unlock (status_ctx->mux_display);
 
-  hcfree (cracked);
-
   if (rc == -1)
   {
     return -1;
@@ -810,6 +715,135 @@ int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
     hc_thread_mutex_unlock (status_ctx->mux_display);
   }
 
+  return 0;
+}
+
+int check_cracked (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  user_options_t *user_options = hashcat_ctx->user_options;
+
+  // cracks reported on the host by a bridge, see BRIDGE_TYPE_LAUNCH_COMP
+
+  if (device_param->h_result > 0)
+  {
+    const u32 num_cracked_bridge = MIN (device_param->h_result, device_param->size_plains / sizeof (plain_t));
+
+    device_param->h_result = 0;
+
+    if (user_options->speed_only == false)
+    {
+      if (check_cracked_plains (hashcat_ctx, device_param, device_param->h_plain_bufs, num_cracked_bridge) == -1) return -1;
+    }
+  }
+
+  u32 num_cracked = 0;
+
+  int rc = -1;
+
+  if (device_param->is_cuda == true)
+  {
+    if (hc_cuMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->cuda_d_result, sizeof (u32)) == -1) return -1;
+
+    if (hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream) == -1) return -1;
+  }
+
+  if (device_param->is_hip == true)
+  {
+    if (hc_hipMemcpyDtoH (hashcat_ctx, &num_cracked, device_param->hip_d_result, sizeof (u32)) == -1) return -1;
+
+    if (hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream) == -1) return -1;
+  }
+
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    if (hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, &num_cracked, device_param->metal_d_result, 0, sizeof (u32)) == -1) return -1;
+  }
+  #endif
+
+  if (device_param->is_opencl == true)
+  {
+    /* blocking */
+    if (hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_result, CL_TRUE, 0, sizeof (u32), &num_cracked, 0, NULL, NULL) == -1) return -1;
+  }
+
+  if (num_cracked == 0 || user_options->speed_only == true)
+  {
+    // we want to get the num_cracked in benchmark mode because it has an influence in performance
+    // however if the benchmark cracks the artificial hash used for benchmarks we don't want to see that!
+
+    return 0;
+  }
+
+  plain_t *cracked = (plain_t *) hcmalloc (num_cracked * sizeof (plain_t));
+
+  if (device_param->is_cuda == true)
+  {
+    rc = hc_cuMemcpyDtoH (hashcat_ctx, cracked, device_param->cuda_d_plain_bufs, num_cracked * sizeof (plain_t));
+
+    if (rc == 0)
+    {
+      rc = hc_cuStreamSynchronize (hashcat_ctx, device_param->cuda_stream);
+    }
+
+    if (rc == -1)
+    {
+      hcfree (cracked);
+
+      return -1;
+    }
+  }
+
+  if (device_param->is_hip == true)
+  {
+    rc = hc_hipMemcpyDtoH (hashcat_ctx, cracked, device_param->hip_d_plain_bufs, num_cracked * sizeof (plain_t));
+
+    if (rc == 0)
+    {
+      rc = hc_hipStreamSynchronize (hashcat_ctx, device_param->hip_stream);
+    }
+
+    if (rc == -1)
+    {
+      hcfree (cracked);
+
+      return -1;
+    }
+  }
+
+  #if defined (__APPLE__)
+  if (device_param->is_metal == true)
+  {
+    rc = hc_mtlMemcpyDtoH (hashcat_ctx, device_param->metal_device, device_param->metal_command_queue, cracked, device_param->metal_d_plain_bufs, 0, num_cracked * sizeof (plain_t));
+
+    if (rc == -1)
+    {
+      hcfree (cracked);
+
+      return -1;
+    }
+  }
+  #endif
+
+  if (device_param->is_opencl == true)
+  {
+    /* blocking */
+    rc = hc_clEnqueueReadBuffer (hashcat_ctx, device_param->opencl_command_queue, device_param->opencl_d_plain_bufs, CL_TRUE, 0, num_cracked * sizeof (plain_t), cracked, 0, NULL, NULL);
+
+    if (rc == -1)
+    {
+      hcfree (cracked);
+
+      return -1;
+    }
+  }
+
+  const int rc_plains = check_cracked_plains (hashcat_ctx, device_param, cracked, num_cracked);
+
+  hcfree (cracked);
+
+  if (rc_plains == -1) return -1;
+
   if (device_param->is_cuda == true)
   {
     if (run_cuda_kernel_bzero (hashcat_ctx, device_param, device_param->cuda_d_result, sizeof (u32)) == -1) return -1;
@@ -2567,6 +2601,12 @@ int hashes_init_selftest (hashcat_ctx_t *hashcat_ctx)
     return -1;
   }
 
+  // the self-test hash is the only digest of its salt, SALT_BATCH kernels read this from the salt
+
+  st_salts_buf->digests_cnt    = 1;
+  st_salts_buf->digests_done   = 0;
+  st_salts_buf->digests_offset = 0;
+
   hashes->st_digests_buf    = st_digests_buf;
   hashes->st_salts_buf      = st_salts_buf;
   hashes->st_esalts_buf     = st_esalts_buf;
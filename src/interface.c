@@ -516,6 +516,13 @@ int hashconfig_init (hashcat_ctx_t *hashcat_ctx)
   }
 
   // bridges have some serious impact on hashconfig
+  if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_INIT)
+  {
+    hashconfig->opts_type &= ~OPTS_TYPE_INIT;
+
+    hashconfig->bridge_type |= BRIDGE_TYPE_LAUNCH_INIT;
+  }
+
   if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_LOOP)
   {
     hashconfig->opts_type &= ~OPTS_TYPE_LOOP;
@@ -530,6 +537,13 @@ int hashconfig_init (hashcat_ctx_t *hashcat_ctx)
     hashconfig->bridge_type |= BRIDGE_TYPE_LAUNCH_LOOP2;
   }
 
+  if (hashconfig->bridge_type & BRIDGE_TYPE_REPLACE_COMP)
+  {
+    hashconfig->opts_type &= ~OPTS_TYPE_COMP;
+
+    hashconfig->bridge_type |= BRIDGE_TYPE_LAUNCH_COMP;
+  }
+
   // selftest bridge update
   if (hashconfig->bridge_type & BRIDGE_TYPE_UPDATE_SELFTEST)
   {
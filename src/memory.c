@@ -7,6 +7,11 @@
 #include "types.h"
 #include "memory.h"
 
+#if defined (__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 void *hccalloc (const size_t nmemb, const size_t sz)
 {
   void *p = calloc (nmemb, sz);
@@ -146,3 +151,91 @@ void hcfree_bridge_aligned (void *ptr)
     free (((void **) ptr)[-1]);
   }
 }
+
+/**
+ * Scratch memory for the memory-hard CPU bridges
+ *
+ * On Linux the buffer is mapped on its own, aligned to a huge page. Explicit huge pages
+ * (MAP_HUGETLB) are tried first and only succeed if the administrator reserved some,
+ * otherwise transparent huge pages are requested with madvise(). If a NUMA node is given,
+ * the pages are preferably placed on that node (mbind() with MPOL_PREFERRED), no matter
+ * which thread touches them first.
+ * The mapping length is kept in a 64 byte header, so the returned pointer is still 64 byte aligned.
+ * Other platforms fall back to hcmalloc_bridge_aligned().
+ */
+
+#define BRIDGE_HUGE_PAGE_SIZE   (2ULL * 1024 * 1024)
+#define BRIDGE_HUGE_HEADER_SIZE 64
+#define BRIDGE_MPOL_PREFERRED   1
+
+#if defined (__linux__) && defined (MAP_HUGE_SHIFT)
+#define BRIDGE_MAP_HUGETLB      (MAP_HUGETLB | (21 << MAP_HUGE_SHIFT))
+#elif defined (__linux__)
+#define BRIDGE_MAP_HUGETLB      (MAP_HUGETLB)
+#endif
+
+void *hcmalloc_bridge_huge (const size_t sz, const int numa_node)
+{
+  #if defined (__linux__)
+
+  const size_t map_len = ((sz + BRIDGE_HUGE_HEADER_SIZE + BRIDGE_HUGE_PAGE_SIZE - 1) / BRIDGE_HUGE_PAGE_SIZE) * BRIDGE_HUGE_PAGE_SIZE;
+
+  u8 *base = (u8 *) mmap (NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | BRIDGE_MAP_HUGETLB, -1, 0);
+
+  if (base == MAP_FAILED)
+  {
+    // map one huge page more than needed and trim both ends, so that the kernel can back the whole range with huge pages
+
+    u8 *raw = (u8 *) mmap (NULL, map_len + BRIDGE_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (raw == MAP_FAILED) return NULL;
+
+    base = (u8 *) (((uintptr_t) raw + BRIDGE_HUGE_PAGE_SIZE - 1) & ~((uintptr_t) BRIDGE_HUGE_PAGE_SIZE - 1));
+
+    const size_t head_len = base - raw;
+    const size_t tail_len = BRIDGE_HUGE_PAGE_SIZE - head_len;
+
+    if (head_len) munmap (raw, head_len);
+    if (tail_len) munmap (base + map_len, tail_len);
+
+    #if defined (MADV_HUGEPAGE)
+    madvise (base, map_len, MADV_HUGEPAGE);
+    #endif
+  }
+
+  // placement is a hint only, a kernel without NUMA support simply rejects it
+
+  if ((numa_node >= 0) && (numa_node < (int) (8 * sizeof (unsigned long))))
+  {
+    const unsigned long nodemask = 1UL << numa_node;
+
+    syscall (SYS_mbind, base, map_len, BRIDGE_MPOL_PREFERRED, &nodemask, 8 * sizeof (unsigned long), 0);
+  }
+
+  *((size_t *) base) = map_len;
+
+  return base + BRIDGE_HUGE_HEADER_SIZE;
+
+  #else
+
+  return hcmalloc_bridge_aligned (sz, 64);
+
+  #endif
+}
+
+void hcfree_bridge_huge (void *ptr)
+{
+  if (ptr == NULL) return;
+
+  #if defined (__linux__)
+
+  u8 *base = (u8 *) ptr - BRIDGE_HUGE_HEADER_SIZE;
+
+  munmap (base, *((size_t *) base));
+
+  #else
+
+  hcfree_bridge_aligned (ptr);
+
+  #endif
+}
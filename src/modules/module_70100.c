@@ -26,7 +26,9 @@ static const u64   OPTS_TYPE      = OPTS_TYPE_STOCK_MODULE
                                   | OPTS_TYPE_MP_MULTI_DISABLE;
 static const u32   SALT_TYPE      = SALT_TYPE_EMBEDDED;
 static const u64   BRIDGE_TYPE    = BRIDGE_TYPE_MATCH_TUNINGS // optional - improves performance
-                                  | BRIDGE_TYPE_REPLACE_LOOP;
+                                  | BRIDGE_TYPE_REPLACE_INIT
+                                  | BRIDGE_TYPE_REPLACE_LOOP
+                                  | BRIDGE_TYPE_REPLACE_COMP;
 static const char *BRIDGE_NAME    = "scrypt_jane";
 static const char *ST_PASS        = "hashcat";
 static const char *ST_HASH        = "SCRYPT:16384:8:1:OTEyNzU0ODg=:Cc8SPjRH1hFQhuIPCdF51uNGtJ2aOY/isuoMlMUsJ8c=";
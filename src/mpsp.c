@@ -15,6 +15,11 @@
 #include "shared.h"
 #include "ext_lzma.h"
 #include "mpsp.h"
+#include "xxhash.h"
+
+#if !defined (_WIN)
+#include <sys/mman.h>
+#endif
 
 static const char *const DEF_MASK = "?1?2?2?2?2?2?2?3?3?3?3?d?d?d?d";
 
@@ -672,55 +677,141 @@ static void mp_reset_usr (cs_t *mp_usr, const u32 userindex)
   memset (mp_usr[userindex].cs_buf, 0, sizeof (mp_usr[userindex].cs_buf));
 }
 
-static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
+static void sp_cache_unmap (u8 *cache_buf, MAYBE_UNUSED const size_t cache_len)
 {
-  folder_config_t *folder_config = hashcat_ctx->folder_config;
-  mask_ctx_t      *mask_ctx      = hashcat_ctx->mask_ctx;
-  user_options_t  *user_options  = hashcat_ctx->user_options;
+  #if defined (_WIN)
+  hcfree (cache_buf);
+  #else
+  munmap (cache_buf, cache_len);
+  #endif
+}
 
-  char *shared_dir = folder_config->shared_dir;
+static bool sp_cache_load (hashcat_ctx_t *hashcat_ctx, const char *cache_file, const u64 checksum)
+{
+  mask_ctx_t *mask_ctx = hashcat_ctx->mask_ctx;
 
-  char *hcstat  = user_options->markov_hcstat2;
-  u32   markov  = user_options->markov;
-  u32   classic = user_options->markov_classic;
-  bool  inverse = user_options->markov_inverse;
+  const size_t cache_len = SP_CACHE_FILESZ;
 
-  hcstat_table_t *root_table_buf   = mask_ctx->root_table_buf;
-  hcstat_table_t *markov_table_buf = mask_ctx->markov_table_buf;
+  struct stat s;
 
-  /**
-   * Initialize hcstats
-   */
+  if (stat (cache_file, &s) == -1) return false;
 
-  u64 *root_stats_buf = (u64 *) hccalloc (SP_ROOT_CNT, sizeof (u64));
+  if ((size_t) s.st_size != cache_len) return false;
 
-  u64 *root_stats_ptr = root_stats_buf;
+  #if defined (_WIN)
 
-  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+  // no mmap() here, a plain read is still much cheaper than decompressing and sorting
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+  HCFILE fp;
+
+  if (hc_fopen_raw (&fp, cache_file, "rb") == false) return false;
+
+  u8 *cache_buf = (u8 *) hcmalloc (cache_len);
+
+  const size_t nread = hc_fread (cache_buf, 1, cache_len, &fp);
+
+  hc_fclose (&fp);
+
+  if (nread != cache_len)
   {
-    root_stats_buf_by_pos[i] = root_stats_ptr;
+    hcfree (cache_buf);
 
-    root_stats_ptr += CHARSIZ;
+    return false;
   }
 
-  u64 *markov_stats_buf = (u64 *) hccalloc (SP_MARKOV_CNT, sizeof (u64));
+  #else
 
-  u64 *markov_stats_ptr = markov_stats_buf;
+  const int fd = open (cache_file, O_RDONLY);
 
-  u64 *(*markov_stats_buf_by_key)[CHARSIZ] = (u64 *(*)[CHARSIZ]) hcmalloc (SP_PW_MAX * sizeof (*markov_stats_buf_by_key));
+  if (fd == -1) return false;
 
-  for (int i = 0; i < SP_PW_MAX; i++)
+  void *map = mmap (NULL, cache_len, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  close (fd);
+
+  if (map == MAP_FAILED) return false;
+
+  u8 *cache_buf = (u8 *) map;
+
+  #endif
+
+  const u64 *hdr = (const u64 *) cache_buf;
+
+  if ((hdr[0] != SP_CACHE_VERSION) || (hdr[1] != checksum) || (hdr[2] != SP_ROOT_CNT) || (hdr[3] != SP_MARKOV_CNT))
   {
-    for (int j = 0; j < CHARSIZ; j++)
-    {
-      markov_stats_buf_by_key[i][j] = markov_stats_ptr;
+    sp_cache_unmap (cache_buf, cache_len);
 
-      markov_stats_ptr += CHARSIZ;
-    }
+    return false;
+  }
+
+  mask_ctx->hcstat_cache_buf = cache_buf;
+  mask_ctx->hcstat_cache_len = cache_len;
+
+  mask_ctx->root_table_buf   = (hcstat_table_t *) (cache_buf + SP_CACHE_HDRSZ);
+  mask_ctx->markov_table_buf = mask_ctx->root_table_buf + SP_ROOT_CNT;
+
+  return true;
+}
+
+static void sp_cache_store (const char *cache_file, const u64 checksum, const hcstat_table_t *root_table_buf, const hcstat_table_t *markov_table_buf)
+{
+  // the cache is optional, any failure here just means the next session has to rebuild the tables
+
+  #if defined (_WIN)
+  const int pid = (int) GetCurrentProcessId ();
+  #else
+  const int pid = (int) getpid ();
+  #endif
+
+  char *cache_file_tmp = NULL;
+
+  hc_asprintf (&cache_file_tmp, "%s.%d.tmp", cache_file, pid);
+
+  HCFILE fp;
+
+  if (hc_fopen_raw (&fp, cache_file_tmp, "wb") == false)
+  {
+    hcfree (cache_file_tmp);
+
+    return;
+  }
+
+  const u64 hdr[4] = { SP_CACHE_VERSION, checksum, SP_ROOT_CNT, SP_MARKOV_CNT };
+
+  bool written = true;
+
+  if (hc_fwrite (hdr,              sizeof (hdr),            1,             &fp) != 1)             written = false;
+  if (hc_fwrite (root_table_buf,   sizeof (hcstat_table_t), SP_ROOT_CNT,   &fp) != SP_ROOT_CNT)   written = false;
+  if (hc_fwrite (markov_table_buf, sizeof (hcstat_table_t), SP_MARKOV_CNT, &fp) != SP_MARKOV_CNT) written = false;
+
+  hc_fclose (&fp);
+
+  // rename() makes the finished file visible atomically to concurrent sessions
+
+  if (written == true)
+  {
+    if (rename (cache_file_tmp, cache_file) != 0) written = false;
   }
 
+  if (written == false) unlink (cache_file_tmp);
+
+  hcfree (cache_file_tmp);
+}
+
+static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
+{
+  folder_config_t *folder_config = hashcat_ctx->folder_config;
+  mask_ctx_t      *mask_ctx      = hashcat_ctx->mask_ctx;
+  user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  char *shared_dir = folder_config->shared_dir;
+  char *cache_dir  = folder_config->cache_dir;
+
+  char *hcstat  = user_options->markov_hcstat2;
+  u32   markov  = user_options->markov;
+  u32   classic = user_options->markov_classic;
+  bool  inverse = user_options->markov_inverse;
+
   /**
    * Load hcstats File
    */
@@ -740,10 +831,6 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
 
-    hcfree (root_stats_buf);
-    hcfree (markov_stats_buf);
-    hcfree (markov_stats_buf_by_key);
-
     return -1;
   }
 
@@ -753,10 +840,6 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
   {
     event_log_error (hashcat_ctx, "%s: %s", hcstat, strerror (errno));
 
-    hcfree (root_stats_buf);
-    hcfree (markov_stats_buf);
-    hcfree (markov_stats_buf_by_key);
-
     return -1;
   }
 
@@ -772,15 +855,82 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
 
     hcfree (inbuf);
 
-    hcfree (root_stats_buf);
-    hcfree (markov_stats_buf);
-    hcfree (markov_stats_buf_by_key);
-
     return -1;
   }
 
   hc_fclose (&fp);
 
+  /**
+   * The sorted tables only depend on the hcstat2 content and the markov modifiers,
+   * reuse them from the cache folder if an earlier session already produced them
+   */
+
+  XXH64_state_t *state = XXH64_createState ();
+
+  XXH64_reset (state, 0);
+
+  XXH64_update (state, inbuf, inlen);
+
+  XXH64_update (state, &markov,  sizeof (markov));
+  XXH64_update (state, &classic, sizeof (classic));
+  XXH64_update (state, &inverse, sizeof (inverse));
+
+  const u64 checksum = XXH64_digest (state);
+
+  XXH64_freeState (state);
+
+  char *cache_file = NULL;
+
+  hc_asprintf (&cache_file, "%s/hcstat2.%016" PRIx64 ".cache", cache_dir, checksum);
+
+  if (sp_cache_load (hashcat_ctx, cache_file, checksum) == true)
+  {
+    hcfree (cache_file);
+
+    hcfree (inbuf);
+
+    return 0;
+  }
+
+  /**
+   * Initialize hcstats
+   */
+
+  u64 *root_stats_buf = (u64 *) hccalloc (SP_ROOT_CNT, sizeof (u64));
+
+  u64 *root_stats_ptr = root_stats_buf;
+
+  u64 *root_stats_buf_by_pos[SP_PW_MAX];
+
+  for (int i = 0; i < SP_PW_MAX; i++)
+  {
+    root_stats_buf_by_pos[i] = root_stats_ptr;
+
+    root_stats_ptr += CHARSIZ;
+  }
+
+  u64 *markov_stats_buf = (u64 *) hccalloc (SP_MARKOV_CNT, sizeof (u64));
+
+  u64 *markov_stats_ptr = markov_stats_buf;
+
+  u64 *(*markov_stats_buf_by_key)[CHARSIZ] = (u64 *(*)[CHARSIZ]) hcmalloc (SP_PW_MAX * sizeof (*markov_stats_buf_by_key));
+
+  for (int i = 0; i < SP_PW_MAX; i++)
+  {
+    for (int j = 0; j < CHARSIZ; j++)
+    {
+      markov_stats_buf_by_key[i][j] = markov_stats_ptr;
+
+      markov_stats_ptr += CHARSIZ;
+    }
+  }
+
+  mask_ctx->root_table_buf   = (hcstat_table_t *) hccalloc (SP_ROOT_CNT,   sizeof (hcstat_table_t));
+  mask_ctx->markov_table_buf = (hcstat_table_t *) hccalloc (SP_MARKOV_CNT, sizeof (hcstat_table_t));
+
+  hcstat_table_t *root_table_buf   = mask_ctx->root_table_buf;
+  hcstat_table_t *markov_table_buf = mask_ctx->markov_table_buf;
+
   u8 *outbuf = (u8 *) hcmalloc (SP_FILESZ);
 
   SizeT outlen = SP_FILESZ;
@@ -800,6 +950,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
     hcfree (markov_stats_buf);
     hcfree (markov_stats_buf_by_key);
 
+    hcfree (cache_file);
+
     return -1;
   }
 
@@ -814,6 +966,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
     hcfree (markov_stats_buf);
     hcfree (markov_stats_buf_by_key);
 
+    hcfree (cache_file);
+
     return -1;
   }
 
@@ -860,6 +1014,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
     hcfree (markov_stats_buf);
     hcfree (markov_stats_buf_by_key);
 
+    hcfree (cache_file);
+
     return -1;
   }
 
@@ -871,6 +1027,8 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
     hcfree (markov_stats_buf);
     hcfree (markov_stats_buf_by_key);
 
+    hcfree (cache_file);
+
     return -1;
   }
 
@@ -999,6 +1157,10 @@ static int sp_setup_tbl (hashcat_ctx_t *hashcat_ctx)
 
   hcfree (markov_table_buf_by_key);
 
+  sp_cache_store (cache_file, checksum, root_table_buf, markov_table_buf);
+
+  hcfree (cache_file);
+
   return 0;
 }
 
@@ -1528,6 +1690,298 @@ int mask_ctx_update_loop (hashcat_ctx_t *hashcat_ctx)
   return 0;
 }
 
+static bool mp_cs_is_equal (const cs_t *cs1, const cs_t *cs2)
+{
+  if (cs1->cs_len != cs2->cs_len) return false;
+
+  u8 uniq[CHARSIZ] = { 0 };
+
+  for (u32 i = 0; i < cs1->cs_len; i++) uniq[cs1->cs_buf[i] & 0xff] = 1;
+
+  for (u32 i = 0; i < cs2->cs_len; i++)
+  {
+    if (uniq[cs2->cs_buf[i] & 0xff] == 0) return false;
+  }
+
+  return true;
+}
+
+static bool mp_cs_is_disjoint (const cs_t *cs1, const cs_t *cs2)
+{
+  u8 uniq[CHARSIZ] = { 0 };
+
+  for (u32 i = 0; i < cs1->cs_len; i++) uniq[cs1->cs_buf[i] & 0xff] = 1;
+
+  for (u32 i = 0; i < cs2->cs_len; i++)
+  {
+    if (uniq[cs2->cs_buf[i] & 0xff] == 1) return false;
+  }
+
+  return true;
+}
+
+static size_t mp_encode_chr (const u32 chr, const bool is_hex, char *out_buf)
+{
+  if (is_hex == true) return snprintf (out_buf, 3, "%02x", chr & 0xff);
+
+  // the line is split with mask_ctx_parse_maskfile() and expanded with mp_expand() / mp_gen_css() again
+
+  switch (chr)
+  {
+    case 0x00: return 0;
+    case '?':  out_buf[0] = '?';  out_buf[1] = '?';         return 2;
+    case ',':  out_buf[0] = '\\'; out_buf[1] = ',';         return 2;
+    case '\\': out_buf[0] = '\\'; out_buf[1] = '\\';        return 2;
+    default:   out_buf[0] = (char) chr;                     return 1;
+  }
+}
+
+static int mp_css_to_maskfile_line (hashcat_ctx_t *hashcat_ctx, const cs_t *css_buf, const u32 css_cnt, char *line_buf)
+{
+  const hashconfig_t *hashconfig = hashcat_ctx->hashconfig;
+  const mask_ctx_t   *mask_ctx   = hashcat_ctx->mask_ctx;
+
+  const bool is_hex = (hashconfig->opts_type & OPTS_TYPE_MT_HEX) ? true : false;
+
+  static const char mp_sys_names[8] = { 'l', 'u', 'd', 's', 'a', 'b', 'h', 'H' };
+
+  const cs_t *usr_css[8];
+
+  u32 usr_cnt = 0;
+
+  char *mask_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  size_t mask_len = 0;
+
+  for (u32 css_pos = 0; css_pos < css_cnt; css_pos++)
+  {
+    const cs_t *cs = css_buf + css_pos;
+
+    if (cs->cs_len == 1)
+    {
+      const size_t len = mp_encode_chr (cs->cs_buf[0], is_hex, mask_buf + mask_len);
+
+      if (len == 0)
+      {
+        hcfree (mask_buf);
+
+        return -1;
+      }
+
+      mask_len += len;
+
+      continue;
+    }
+
+    int sys_idx = -1;
+
+    for (int i = 0; i < 8; i++)
+    {
+      if (mp_cs_is_equal (cs, mask_ctx->mp_sys + i) == false) continue;
+
+      sys_idx = i;
+
+      break;
+    }
+
+    if (sys_idx != -1)
+    {
+      mask_buf[mask_len++] = '?';
+      mask_buf[mask_len++] = mp_sys_names[sys_idx];
+
+      continue;
+    }
+
+    u32 usr_idx;
+
+    for (usr_idx = 0; usr_idx < usr_cnt; usr_idx++)
+    {
+      if (mp_cs_is_equal (cs, usr_css[usr_idx]) == true) break;
+    }
+
+    if (usr_idx == usr_cnt)
+    {
+      if (usr_cnt == 8)
+      {
+        hcfree (mask_buf);
+
+        return -1;
+      }
+
+      usr_css[usr_cnt++] = cs;
+    }
+
+    mask_buf[mask_len++] = '?';
+    mask_buf[mask_len++] = (char) ('1' + usr_idx);
+  }
+
+  size_t line_len = 0;
+
+  for (u32 usr_idx = 0; usr_idx < usr_cnt; usr_idx++)
+  {
+    const cs_t *cs = usr_css[usr_idx];
+
+    for (u32 i = 0; i < cs->cs_len; i++)
+    {
+      const size_t len = mp_encode_chr (cs->cs_buf[i], is_hex, line_buf + line_len);
+
+      if (len == 0)
+      {
+        hcfree (mask_buf);
+
+        return -1;
+      }
+
+      line_len += len;
+    }
+
+    line_buf[line_len++] = ',';
+  }
+
+  memcpy (line_buf + line_len, mask_buf, mask_len);
+
+  line_len += mask_len;
+
+  line_buf[line_len] = 0;
+
+  hcfree (mask_buf);
+
+  return 0;
+}
+
+static void mask_ctx_merge_flush (hashcat_ctx_t *hashcat_ctx, char **masks_new, u32 *masks_new_cnt, const cs_t *group_css, const u32 group_cnt, const u32 group_first, const u32 group_size, char *line_buf)
+{
+  mask_ctx_t *mask_ctx = hashcat_ctx->mask_ctx;
+
+  if (group_size > 1)
+  {
+    if (mp_css_to_maskfile_line (hashcat_ctx, group_css, group_cnt, line_buf) == 0)
+    {
+      for (u32 i = group_first; i < group_first + group_size; i++)
+      {
+        hcfree (mask_ctx->masks[i]);
+
+        mask_ctx->masks[i] = NULL;
+      }
+
+      masks_new[(*masks_new_cnt)++] = hcstrdup (line_buf);
+
+      return;
+    }
+  }
+
+  // nothing merged or the merged charsets can not be expressed as a maskfile line, keep the masks as they are
+
+  for (u32 i = group_first; i < group_first + group_size; i++)
+  {
+    masks_new[(*masks_new_cnt)++] = mask_ctx->masks[i];
+
+    mask_ctx->masks[i] = NULL;
+  }
+}
+
+static void mask_ctx_merge_masks (hashcat_ctx_t *hashcat_ctx)
+{
+  mask_ctx_t *mask_ctx = hashcat_ctx->mask_ctx;
+
+  if (mask_ctx->masks_cnt < 2) return;
+
+  /**
+   * Consecutive masks of the same length that differ in exactly one position, using disjoint charsets there,
+   * describe exactly the same candidates as a single mask using the union of these charsets at that position.
+   * Running them as one mask saves the per-mask session update, autotune and the underfilled tail of each mask.
+   */
+
+  cs_t *group_css = (cs_t *) hccalloc (256, sizeof (cs_t));
+  cs_t *next_css  = (cs_t *) hccalloc (256, sizeof (cs_t));
+
+  char **masks_new = (char **) hccalloc (mask_ctx->masks_avail, sizeof (char *));
+
+  u32 masks_new_cnt = 0;
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_SMALL);
+
+  u32 group_cnt   = 0;
+  u32 group_first = 0;
+  u32 group_size  = 0;
+  int group_pos   = -1;
+
+  for (u32 masks_pos = 0; masks_pos < mask_ctx->masks_cnt; masks_pos++)
+  {
+    u32 next_cnt = 0;
+
+    mask_ctx->mask = mask_ctx->masks[masks_pos];
+
+    if ((mask_ctx_parse_maskfile (hashcat_ctx) == -1) || (mp_gen_css (hashcat_ctx, mask_ctx->mask, strlen (mask_ctx->mask), mask_ctx->mp_sys, mask_ctx->mp_usr, next_css, &next_cnt) == -1))
+    {
+      // invalid masks are left alone, they are reported and skipped once they are reached
+
+      mask_ctx_merge_flush (hashcat_ctx, masks_new, &masks_new_cnt, group_css, group_cnt, group_first, group_size, line_buf);
+
+      mask_ctx_merge_flush (hashcat_ctx, masks_new, &masks_new_cnt, next_css, next_cnt, masks_pos, 1, line_buf);
+
+      group_size = 0;
+
+      continue;
+    }
+
+    if ((group_size > 0) && (group_cnt == next_cnt))
+    {
+      int diff_pos = -1;
+      u32 diff_cnt = 0;
+
+      for (u32 css_pos = 0; css_pos < next_cnt; css_pos++)
+      {
+        if (mp_cs_is_equal (group_css + css_pos, next_css + css_pos) == true) continue;
+
+        diff_pos = (int) css_pos;
+
+        if (++diff_cnt > 1) break;
+      }
+
+      if ((diff_cnt == 1) && ((group_pos == -1) || (group_pos == diff_pos)))
+      {
+        cs_t *group_cs = group_css + diff_pos;
+        cs_t *next_cs  = next_css  + diff_pos;
+
+        if (mp_cs_is_disjoint (group_cs, next_cs) == true)
+        {
+          memcpy (group_cs->cs_buf + group_cs->cs_len, next_cs->cs_buf, next_cs->cs_len * sizeof (u32));
+
+          group_cs->cs_len += next_cs->cs_len;
+
+          group_pos = diff_pos;
+
+          group_size++;
+
+          continue;
+        }
+      }
+    }
+
+    mask_ctx_merge_flush (hashcat_ctx, masks_new, &masks_new_cnt, group_css, group_cnt, group_first, group_size, line_buf);
+
+    memcpy (group_css, next_css, 256 * sizeof (cs_t));
+
+    group_cnt   = next_cnt;
+    group_first = masks_pos;
+    group_size  = 1;
+    group_pos   = -1;
+  }
+
+  mask_ctx_merge_flush (hashcat_ctx, masks_new, &masks_new_cnt, group_css, group_cnt, group_first, group_size, line_buf);
+
+  hcfree (line_buf);
+
+  hcfree (group_css);
+  hcfree (next_css);
+
+  hcfree (mask_ctx->masks);
+
+  mask_ctx->masks     = masks_new;
+  mask_ctx->masks_cnt = masks_new_cnt;
+}
+
 int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
 {
   const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
@@ -1558,9 +2012,6 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
   mask_ctx->css_buf = (cs_t *) hccalloc (256, sizeof (cs_t));
   mask_ctx->css_cnt = 0;
 
-  mask_ctx->root_table_buf   = (hcstat_table_t *) hccalloc (SP_ROOT_CNT,   sizeof (hcstat_table_t));
-  mask_ctx->markov_table_buf = (hcstat_table_t *) hccalloc (SP_MARKOV_CNT, sizeof (hcstat_table_t));
-
   if (sp_setup_tbl (hashcat_ctx) == -1) return -1;
 
   mask_ctx->root_css_buf   = (cs_t *) hccalloc (SP_PW_MAX,           sizeof (cs_t));
@@ -1682,6 +2133,14 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
       if (mask_append (hashcat_ctx, mask, NULL) == -1) return -1;
     }
   }
+  else if (user_options->kernel_precompile == true)
+  {
+    // hybrid precompile has no mask argument, the kernels do not depend on it
+
+    const char *mask = hashconfig->benchmark_mask;
+
+    if (mask_append (hashcat_ctx, mask, NULL) == -1) return -1;
+  }
   else if (user_options->attack_mode == ATTACK_MODE_HYBRID1)
   {
     // display
@@ -1830,6 +2289,16 @@ int mask_ctx_init (hashcat_ctx_t *hashcat_ctx)
     return -1;
   }
 
+  if ((user_options->mask_merge == true) && (user_options->attack_mode == ATTACK_MODE_BF) && (mask_ctx->mask_from_file == true))
+  {
+    // markov-threshold selects the top chars per position, which differs for a merged charset
+
+    if (user_options->markov_threshold >= CHARSIZ)
+    {
+      mask_ctx_merge_masks (hashcat_ctx);
+    }
+  }
+
   mask_ctx->mask = mask_ctx->masks[0];
 
   return 0;
@@ -1849,8 +2318,15 @@ void mask_ctx_destroy (hashcat_ctx_t *hashcat_ctx)
   hcfree (mask_ctx->root_css_buf);
   hcfree (mask_ctx->markov_css_buf);
 
-  hcfree (mask_ctx->root_table_buf);
-  hcfree (mask_ctx->markov_table_buf);
+  if (mask_ctx->hcstat_cache_buf)
+  {
+    sp_cache_unmap (mask_ctx->hcstat_cache_buf, mask_ctx->hcstat_cache_len);
+  }
+  else
+  {
+    hcfree (mask_ctx->root_table_buf);
+    hcfree (mask_ctx->markov_table_buf);
+  }
 
   for (u32 mask_pos = 0; mask_pos < mask_ctx->masks_cnt; mask_pos++)
   {
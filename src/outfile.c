@@ -16,6 +16,7 @@
 #include "shared.h"
 #include "locking.h"
 #include "thread.h"
+#include "stdout.h"
 #include "outfile.h"
 
 u32 outfile_format_parse (const char *format_string)
@@ -501,6 +502,7 @@ int outfile_init (hashcat_ctx_t *hashcat_ctx)
   user_options_t *user_options = hashcat_ctx->user_options;
 
   outfile_ctx->fp.pfp          = NULL;
+  outfile_ctx->stdout_fp.pfp   = NULL;
   outfile_ctx->filename        = user_options->outfile;
   outfile_ctx->outfile_format  = user_options->outfile_format;
   outfile_ctx->outfile_autohex = user_options->outfile_autohex;
@@ -516,6 +518,8 @@ void outfile_destroy (hashcat_ctx_t *hashcat_ctx)
 {
   outfile_ctx_t *outfile_ctx = hashcat_ctx->outfile_ctx;
 
+  process_stdout_close (hashcat_ctx);
+
   hc_thread_mutex_delete (outfile_ctx->mux_outfile);
 
   if (outfile_ctx->is_fifo == true && outfile_ctx->fp.pfp != NULL)
@@ -5,11 +5,16 @@
 
 #include "common.h"
 #include "types.h"
+#include "memory.h"
 #include "event.h"
 #include "bitops.h"
 #include "convert.h"
 #include "backend.h"
 #include "thread.h"
+#include "shared.h"
+#include "filehandling.h"
+#include "interface.h"
+#include "xxhash.h"
 #include "selftest.h"
 
 static int selftest_init (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, u32 *highest_pw_len)
@@ -508,6 +513,20 @@ static int selftest_init (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_
   return 0;
 }
 
+static void selftest_bridge_hashes (const hashes_t *hashes, hashes_t *st_hashes, u32 *st_digests_shown)
+{
+  memcpy (st_hashes, hashes, sizeof (hashes_t));
+
+  st_hashes->digests_buf     = st_hashes->st_digests_buf;
+  st_hashes->salts_buf       = st_hashes->st_salts_buf;
+  st_hashes->esalts_buf      = st_hashes->st_esalts_buf;
+  st_hashes->hook_salts_buf  = st_hashes->st_hook_salts_buf;
+
+  // the self-test hash is never shown, whatever the state of the first hash of the hashlist
+
+  st_hashes->digests_shown   = st_digests_shown;
+}
+
 static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, u32 highest_pw_len)
 {
   bridge_ctx_t *bridge_ctx = hashcat_ctx->bridge_ctx;
@@ -581,6 +600,32 @@ static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *d
       if (run_kernel (hashcat_ctx, device_param, KERN_RUN_1, 0, 1, false, 0, false) == -1) return -1;
     }
 
+    device_param->bridge_tmps_on_host = false;
+
+    if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_INIT)
+    {
+      if (copy_bridge_candidates_to_host (hashcat_ctx, device_param, 1) == -1) return -1;
+
+      if (hashconfig->opts_type & OPTS_TYPE_INIT)
+      {
+        if (copy_bridge_material_to_host (hashcat_ctx, device_param, 1) == -1) return -1;
+      }
+
+      hashes_t st_hashes;
+
+      u32 st_digests_shown = 0;
+
+      selftest_bridge_hashes (hashes, &st_hashes, &st_digests_shown);
+
+      if (bridge_ctx->launch_init (bridge_ctx->platform_context, device_param, hashconfig, &st_hashes, 0, 1) == false) return -1;
+
+      // the remaining self-test stages expect tmps[] on the device
+
+      device_param->bridge_tmps_on_host = true;
+
+      if (copy_bridge_material_to_device (hashcat_ctx, device_param, 1) == -1) return -1;
+    }
+
     if (hashconfig->opts_type & OPTS_TYPE_HOOK12)
     {
       if (run_kernel (hashcat_ctx, device_param, KERN_RUN_12, 0, 1, false, 0, false) == -1) return -1;
@@ -711,12 +756,9 @@ static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *d
 
           hashes_t st_hashes;
 
-          memcpy (&st_hashes, hashes, sizeof (hashes_t));
+          u32 st_digests_shown = 0;
 
-          st_hashes.digests_buf     = st_hashes.st_digests_buf;
-          st_hashes.salts_buf       = st_hashes.st_salts_buf;
-          st_hashes.esalts_buf      = st_hashes.st_esalts_buf;
-          st_hashes.hook_salts_buf  = st_hashes.st_hook_salts_buf;
+          selftest_bridge_hashes (hashes, &st_hashes, &st_digests_shown);
 
           if (bridge_ctx->launch_loop (bridge_ctx->platform_context, device_param, hashconfig, &st_hashes, 0, 1) == false) return -1;
 
@@ -874,12 +916,9 @@ static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *d
 
             hashes_t st_hashes;
 
-            memcpy (&st_hashes, hashes, sizeof (hashes_t));
+            u32 st_digests_shown = 0;
 
-            st_hashes.digests_buf     = st_hashes.st_digests_buf;
-            st_hashes.salts_buf       = st_hashes.st_salts_buf;
-            st_hashes.esalts_buf      = st_hashes.st_esalts_buf;
-            st_hashes.hook_salts_buf  = st_hashes.st_hook_salts_buf;
+            selftest_bridge_hashes (hashes, &st_hashes, &st_digests_shown);
 
             if (bridge_ctx->launch_loop2 (bridge_ctx->platform_context, device_param, hashconfig, &st_hashes, 0, 1) == false) return -1;
 
@@ -942,6 +981,19 @@ static int selftest_run_kernel (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *d
     {
       if (run_kernel (hashcat_ctx, device_param, KERN_RUN_3, 0, 1, false, 0, false) == -1) return -1;
     }
+
+    if (hashconfig->bridge_type & BRIDGE_TYPE_LAUNCH_COMP)
+    {
+      if (copy_bridge_material_to_host (hashcat_ctx, device_param, 1) == -1) return -1;
+
+      hashes_t st_hashes;
+
+      u32 st_digests_shown = 0;
+
+      selftest_bridge_hashes (hashes, &st_hashes, &st_digests_shown);
+
+      if (bridge_ctx->launch_comp (bridge_ctx->platform_context, device_param, hashconfig, &st_hashes, 0, 1) == false) return -1;
+    }
   }
 
   device_param->spin_damp = spin_damp_sav;
@@ -1175,6 +1227,12 @@ static int selftest_cleanup (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
     if (hc_clReleaseEvent (hashcat_ctx, opencl_event) == -1) return -1;
   }
 
+  // cracks reported on the host by a bridge, see BRIDGE_TYPE_LAUNCH_COMP
+
+  *num_cracked += device_param->h_result;
+
+  device_param->h_result = 0;
+
   return 0;
 }
 
@@ -1236,6 +1294,227 @@ static int process_selftest (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *devi
   return 0;
 }
 
+/**
+ * self-test cache
+ *
+ * A passed self-test is stored in SELFTEST_CACHE_FILENAME in the kernel cache folder as "<key> <timestamp>".
+ * The key covers the main kernel (its content key includes the device and driver identity, the build options
+ * and the hashcat build), the module binary, the hash-mode and the self-test hash and password, so any change
+ * of these runs the test again. Entries older than SELFTEST_CACHE_MAX_AGE are tested again as well, which
+ * catches a device going bad over time. Every store rewrites the file without expired or superseded entries.
+ */
+
+static bool selftest_cache_key (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, char *key)
+{
+  const backend_ctx_t        *backend_ctx        = hashcat_ctx->backend_ctx;
+  const bridge_ctx_t         *bridge_ctx         = hashcat_ctx->bridge_ctx;
+  const folder_config_t      *folder_config      = hashcat_ctx->folder_config;
+  const hashconfig_t         *hashconfig         = hashcat_ctx->hashconfig;
+  const user_options_t       *user_options       = hashcat_ctx->user_options;
+  const user_options_extra_t *user_options_extra = hashcat_ctx->user_options_extra;
+
+  if (device_param->kernel_key[0] == 0) return false;
+
+  if (hashconfig->st_hash == NULL) return false;
+
+  // bridges and hooks run host code which is not covered by the kernel key
+
+  if (bridge_ctx->enabled == true) return false;
+
+  if (hashconfig->opts_type & (OPTS_TYPE_HOOK12 | OPTS_TYPE_HOOK23)) return false;
+
+  // the module is built apart from hashcat, a rebuilt module has a different size or mtime
+
+  char *module_file = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  module_filename (folder_config, hashconfig->hash_mode, module_file, HCBUFSIZ_TINY);
+
+  struct stat st;
+
+  memset (&st, 0, sizeof (struct stat));
+
+  const int rc_stat = stat (module_file, &st);
+
+  hcfree (module_file);
+
+  if (rc_stat == -1) return false;
+
+  char *identity = NULL;
+
+  const int identity_len = hc_asprintf (&identity, "%s-%d-%" PRIu64 "-%" PRIu64 "-%u-%u-%u-%u-%s-%s",
+    device_param->kernel_key,
+    backend_ctx->comptime,
+    (u64) st.st_size,
+    (u64) st.st_mtime,
+    hashconfig->hash_mode,
+    user_options_extra->attack_kern,
+    (hashconfig->opti_type & OPTI_TYPE_OPTIMIZED_KERNEL) ? 1 : 0,
+    user_options->slow_candidates,
+    hashconfig->st_hash,
+    (hashconfig->st_pass != NULL) ? hashconfig->st_pass : "");
+
+  snprintf (key, 17, "%016" PRIx64, (u64) XXH64 (identity, identity_len, 0));
+
+  hcfree (identity);
+
+  return true;
+}
+
+static bool selftest_cache_load (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+  const user_options_t  *user_options  = hashcat_ctx->user_options;
+
+  if (user_options->self_test_refresh == true) return false;
+
+  char key[32] = { 0 };
+
+  if (selftest_cache_key (hashcat_ctx, device_param, key) == false) return false;
+
+  char *cache_file = NULL;
+
+  hc_asprintf (&cache_file, "%s/%s", folder_config->kernels_dir, SELFTEST_CACHE_FILENAME);
+
+  HCFILE fp;
+
+  const bool rc_open = hc_fopen (&fp, cache_file, "rb");
+
+  hcfree (cache_file);
+
+  if (rc_open == false) return false;
+
+  const u64 now = (u64) time (NULL);
+
+  bool found = false;
+
+  char *line_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+  while (!hc_feof (&fp))
+  {
+    const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_TINY);
+
+    if (line_len == 0) continue;
+
+    char line_key[32] = { 0 };
+
+    u64 timestamp = 0;
+
+    if (sscanf (line_buf, "%16s %" SCNu64, line_key, &timestamp) != 2) continue;
+
+    if (strcmp (line_key, key) != 0) continue;
+
+    if (timestamp > now) continue;
+
+    if ((now - timestamp) > SELFTEST_CACHE_MAX_AGE) continue;
+
+    found = true;
+
+    break;
+  }
+
+  hcfree (line_buf);
+
+  hc_fclose (&fp);
+
+  return found;
+}
+
+static void selftest_cache_store (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param)
+{
+  backend_ctx_t         *backend_ctx   = hashcat_ctx->backend_ctx;
+  const folder_config_t *folder_config = hashcat_ctx->folder_config;
+
+  char key[32] = { 0 };
+
+  if (selftest_cache_key (hashcat_ctx, device_param, key) == false) return;
+
+  // the cache is optional, any failure here just means the next session runs the test again
+
+  #if defined (_WIN)
+  const int pid = (int) GetCurrentProcessId ();
+  #else
+  const int pid = (int) getpid ();
+  #endif
+
+  char *cache_file     = NULL;
+  char *cache_file_tmp = NULL;
+
+  hc_asprintf (&cache_file,     "%s/%s", folder_config->kernels_dir, SELFTEST_CACHE_FILENAME);
+  hc_asprintf (&cache_file_tmp, "%s.%d.tmp", cache_file, pid);
+
+  hc_thread_mutex_lock (backend_ctx->mux_selftest_cache);
+
+  HCFILE fp_tmp;
+
+  if (hc_fopen_raw (&fp_tmp, cache_file_tmp, "wb") == false)
+  {
+    event_log_warning (hashcat_ctx, "%s: %s", cache_file_tmp, strerror (errno));
+
+    hc_thread_mutex_unlock (backend_ctx->mux_selftest_cache);
+
+    hcfree (cache_file_tmp);
+    hcfree (cache_file);
+
+    return;
+  }
+
+  const u64 now = (u64) time (NULL);
+
+  bool written = true;
+
+  // keep the entries of other kernels which are still valid, drop expired ones and our own old one
+
+  HCFILE fp;
+
+  if (hc_fopen (&fp, cache_file, "rb") == true)
+  {
+    char *line_buf = (char *) hcmalloc (HCBUFSIZ_TINY);
+
+    while (!hc_feof (&fp))
+    {
+      const size_t line_len = fgetl (&fp, line_buf, HCBUFSIZ_TINY);
+
+      if (line_len == 0) continue;
+
+      char line_key[32] = { 0 };
+
+      u64 timestamp = 0;
+
+      if (sscanf (line_buf, "%16s %" SCNu64, line_key, &timestamp) != 2) continue;
+
+      if (strcmp (line_key, key) == 0) continue;
+
+      if (timestamp > now) continue;
+
+      if ((now - timestamp) > SELFTEST_CACHE_MAX_AGE) continue;
+
+      if (hc_fprintf (&fp_tmp, "%s %" PRIu64 "\n", line_key, timestamp) < 0) written = false;
+    }
+
+    hcfree (line_buf);
+
+    hc_fclose (&fp);
+  }
+
+  if (hc_fprintf (&fp_tmp, "%s %" PRIu64 "\n", key, now) < 0) written = false;
+
+  hc_fclose (&fp_tmp);
+
+  // rename() makes the rewritten file visible atomically to concurrent sessions
+
+  if (written == true)
+  {
+    if (rename (cache_file_tmp, cache_file) != 0) written = false;
+  }
+
+  if (written == false) unlink (cache_file_tmp);
+
+  hc_thread_mutex_unlock (backend_ctx->mux_selftest_cache);
+
+  hcfree (cache_file_tmp);
+  hcfree (cache_file);
+}
+
 #if defined (_WIN32) || defined (__WIN32__)
 HC_API_CALL DWORD thread_selftest (void *p)
 #else
@@ -1261,6 +1540,13 @@ HC_API_CALL void *thread_selftest (void *p)
   if (device_param->skipped == true) return 0;
   if (device_param->skipped_warning == true) return 0;
 
+  if (selftest_cache_load (hashcat_ctx, device_param) == true)
+  {
+    device_param->st_status = (user_options->benchmark == true) ? ST_STATUS_IGNORED : ST_STATUS_PASSED;
+
+    return 0;
+  }
+
   if (bridge_ctx->enabled == true)
   {
     if (bridge_ctx->thread_init != BRIDGE_DEFAULT)
@@ -1290,6 +1576,8 @@ HC_API_CALL void *thread_selftest (void *p)
     if (rc_selftest == 0)
     {
       device_param->st_status = ST_STATUS_PASSED;
+
+      selftest_cache_store (hashcat_ctx, device_param);
     }
     else
     {
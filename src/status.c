@@ -1664,6 +1664,31 @@ char *status_get_speed_sec_all (const hashcat_ctx_t *hashcat_ctx)
   return display;
 }
 
+double status_get_tail_idle_msec_all (const hashcat_ctx_t *hashcat_ctx)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+
+  double tail_idle_msec_all = 0;
+
+  if (backend_ctx->enabled == false) return 0;
+
+  for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+  {
+    hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+
+    if (device_param->skipped == true) continue;
+    if (device_param->skipped_warning == true) continue;
+
+    tail_idle_msec_all += device_param->tail_idle_msec;
+
+    // still waiting for the other devices in the current pass
+
+    if (device_param->tail_idle == true) tail_idle_msec_all += hc_timer_get (device_param->timer_tail_idle);
+  }
+
+  return tail_idle_msec_all;
+}
+
 char *status_get_speed_sec_dev (const hashcat_ctx_t *hashcat_ctx, const int backend_devices_idx)
 {
   const double hashes_msec_dev = status_get_hashes_msec_dev (hashcat_ctx, backend_devices_idx);
@@ -5,6 +5,7 @@
 
 #include "common.h"
 #include "types.h"
+#include "memory.h"
 #include "event.h"
 #include "locking.h"
 #include "emu_inc_rp.h"
@@ -15,11 +16,157 @@
 #include "thread.h"
 #include "stdout.h"
 
+#if defined (__linux__)
+
+static int stdout_pipe_write (const outfile_ctx_t *outfile_ctx, const char *buf, const size_t len, const bool zero_copy)
+{
+  const int fd = outfile_ctx->stdout_fp.fd;
+
+  size_t done = 0;
+
+  while (done < len)
+  {
+    ssize_t rc;
+
+    if (zero_copy == true)
+    {
+      struct iovec iov;
+
+      iov.iov_base = (void *) (buf + done);
+      iov.iov_len  = len - done;
+
+      // the pages are gifted to the pipe, the buffer is unmapped afterwards and never written again
+
+      rc = vmsplice (fd, &iov, 1, SPLICE_F_GIFT);
+    }
+    else
+    {
+      rc = write (fd, buf + done, len - done);
+    }
+
+    if (rc == -1)
+    {
+      if (errno == EINTR) continue;
+
+      return -1;
+    }
+
+    done += rc;
+  }
+
+  return 0;
+}
+
+#endif
+
+static void out_acquire (out_t *out)
+{
+  outfile_ctx_t *outfile_ctx = out->outfile_ctx;
+
+  out->len      = 0;
+  out->buf_mmap = false;
+
+  #if defined (__linux__)
+  if (outfile_ctx->stdout_is_pipe == true)
+  {
+    // a fresh mapping for every buffer handed over with vmsplice():
+    // the reader can move the pages on with splice() or tee(), so there is no safe point in time to write to them again
+
+    void *buf = mmap (NULL, STDOUT_BUFSZ, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (buf != MAP_FAILED)
+    {
+      out->buf      = (char *) buf;
+      out->buf_mmap = true;
+
+      return;
+    }
+  }
+  #endif
+
+  // no pipe, or no mapping left, use a private buffer which is written with a copy
+
+  out->buf = (char *) hcmalloc (STDOUT_BUFSZ);
+}
+
+static void out_release (out_t *out)
+{
+  #if defined (__linux__)
+  if (out->buf_mmap == true)
+  {
+    // unmapping is safe, the pipe holds its own reference to the pages
+
+    munmap (out->buf, STDOUT_BUFSZ);
+  }
+  else
+  #endif
+  {
+    hcfree (out->buf);
+  }
+
+  out->buf = NULL;
+}
+
 static void out_flush (out_t *out)
 {
   if (out->len == 0) return;
 
-  hc_fwrite (out->buf, 1, out->len, &out->fp);
+  // like ferror(), the first error sticks and is reported by process_stdout()
+
+  if (out->err != 0)
+  {
+    out->len = 0;
+
+    return;
+  }
+
+  // candidates are generated in parallel, only the write itself is serialized
+  // a flush always contains complete lines so the output of devices can not mix within a line
+
+  outfile_ctx_t *outfile_ctx = out->outfile_ctx;
+
+  hc_thread_mutex_lock (outfile_ctx->mux_outfile);
+
+  #if defined (__linux__)
+  if (outfile_ctx->stdout_is_pipe == true)
+  {
+    const bool zero_copy = out->buf_mmap;
+
+    if (stdout_pipe_write (outfile_ctx, out->buf, out->len, zero_copy) == -1)
+    {
+      out->err = errno;
+
+      hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
+
+      out->len = 0;
+
+      return;
+    }
+
+    hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
+
+    out->len = 0;
+
+    if (zero_copy == true)
+    {
+      // the pipe now references the pages of this buffer, switch to a fresh one
+
+      out_release (out);
+      out_acquire (out);
+    }
+
+    return;
+  }
+  #endif
+
+  errno = 0;
+
+  if (hc_fwrite (out->buf, 1, out->len, &outfile_ctx->stdout_fp) != (size_t) out->len)
+  {
+    out->err = (errno != 0) ? errno : EIO;
+  }
+
+  hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
 
   out->len = 0;
 }
@@ -28,82 +175,156 @@ static void out_push (out_t *out, const u8 *pw_buf, const int pw_len)
 {
   char *ptr = out->buf + out->len;
 
-  memcpy (ptr, pw_buf, pw_len);
+  if (out->binary == true)
+  {
+    // u16 little-endian length followed by the candidate, see --binary-candidates
 
-  #if defined (_WIN)
+    ptr[0] = (char) (pw_len >> 0);
+    ptr[1] = (char) (pw_len >> 8);
 
-  ptr[pw_len + 0] = '\r';
-  ptr[pw_len + 1] = '\n';
+    memcpy (ptr + 2, pw_buf, pw_len);
 
-  out->len += pw_len + 2;
+    out->len += 2 + pw_len;
+  }
+  else
+  {
+    memcpy (ptr, pw_buf, pw_len);
 
-  #else
+    #if defined (_WIN)
 
-  ptr[pw_len] = '\n';
+    ptr[pw_len + 0] = '\r';
+    ptr[pw_len + 1] = '\n';
 
-  out->len += pw_len + 1;
+    out->len += pw_len + 2;
 
-  #endif
+    #else
+
+    ptr[pw_len] = '\n';
+
+    out->len += pw_len + 1;
+
+    #endif
+  }
 
-  if (out->len >= HCBUFSIZ_SMALL - 300)
+  if (out->len >= STDOUT_BUFSZ - 300)
   {
     out_flush (out);
   }
 }
 
-int process_stdout (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt)
+static int stdout_open (hashcat_ctx_t *hashcat_ctx)
 {
-  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
-  hashconfig_t     *hashconfig     = hashcat_ctx->hashconfig;
-  mask_ctx_t       *mask_ctx       = hashcat_ctx->mask_ctx;
-  outfile_ctx_t    *outfile_ctx    = hashcat_ctx->outfile_ctx;
-  straight_ctx_t   *straight_ctx   = hashcat_ctx->straight_ctx;
-  user_options_t   *user_options   = hashcat_ctx->user_options;
+  outfile_ctx_t *outfile_ctx = hashcat_ctx->outfile_ctx;
 
-  // prevent wrong candidates in output when backend_ctx->backend_devices_active > 1
+  int rc = 0;
 
   hc_thread_mutex_lock (outfile_ctx->mux_outfile);
 
-  char *filename = outfile_ctx->filename;
-
-  out_t out;
+  HCFILE *fp = &outfile_ctx->stdout_fp;
 
-  if (filename)
+  if (fp->pfp == NULL)
   {
-    if (hc_fopen (&out.fp, filename, "ab") == false)
+    char *filename = outfile_ctx->filename;
+
+    if (filename)
     {
-      event_log_error (hashcat_ctx, "%s: %s", filename, strerror (errno));
+      if (hc_fopen (fp, filename, "ab") == false)
+      {
+        event_log_error (hashcat_ctx, "%s: %s", filename, strerror (errno));
 
-      hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
+        rc = -1;
+      }
+      else if (hc_lockfile (fp) == -1)
+      {
+        hc_fclose (fp);
 
-      return -1;
-    }
+        event_log_error (hashcat_ctx, "%s: %s", filename, strerror (errno));
 
-    if (hc_lockfile (&out.fp) == -1)
+        rc = -1;
+      }
+    }
+    else
     {
-      hc_fclose (&out.fp);
+      fp->fd       = fileno (stdout);
+      fp->pfp      = stdout;
+      fp->gfp      = NULL;
+      fp->ufp      = NULL;
+      fp->bom_size = 0;
+      fp->path     = NULL;
+      fp->mode     = NULL;
+
+      #if defined (__linux__)
+      struct stat st;
+
+      if ((fstat (fp->fd, &st) == 0) && S_ISFIFO (st.st_mode))
+      {
+        // bypass stdio from here on, so nothing buffered must be left behind
 
-      event_log_error (hashcat_ctx, "%s: %s", filename, strerror (errno));
+        fflush (stdout);
 
-      hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
+        // a larger pipe means fewer wakeups of the reader, not an error if we are not allowed to
 
-      return -1;
+        fcntl (fp->fd, F_SETPIPE_SZ, STDOUT_BUFSZ);
+
+        outfile_ctx->stdout_is_pipe = true;
+      }
+      #endif
     }
   }
+
+  hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
+
+  return rc;
+}
+
+void process_stdout_close (hashcat_ctx_t *hashcat_ctx)
+{
+  outfile_ctx_t *outfile_ctx = hashcat_ctx->outfile_ctx;
+
+  HCFILE *fp = &outfile_ctx->stdout_fp;
+
+  if (fp->pfp == NULL) return;
+
+  if (outfile_ctx->filename)
+  {
+    hc_unlockfile (fp);
+
+    hc_fclose (fp);
+  }
   else
   {
-    HCFILE *fp = &out.fp;
-
-    fp->fd       = fileno (stdout);
-    fp->pfp      = stdout;
-    fp->gfp      = NULL;
-    fp->ufp      = NULL;
-    fp->bom_size = 0;
-    fp->path     = NULL;
-    fp->mode     = NULL;
+    hc_fflush (fp);
+
+    fp->pfp = NULL;
   }
 
-  out.len = 0;
+  #if defined (__linux__)
+  outfile_ctx->stdout_is_pipe = false;
+  #endif
+}
+
+int process_stdout (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param, const u64 pws_cnt)
+{
+  combinator_ctx_t *combinator_ctx = hashcat_ctx->combinator_ctx;
+  hashconfig_t     *hashconfig     = hashcat_ctx->hashconfig;
+  mask_ctx_t       *mask_ctx       = hashcat_ctx->mask_ctx;
+  outfile_ctx_t    *outfile_ctx    = hashcat_ctx->outfile_ctx;
+  straight_ctx_t   *straight_ctx   = hashcat_ctx->straight_ctx;
+  user_options_t   *user_options   = hashcat_ctx->user_options;
+
+  if (stdout_open (hashcat_ctx) == -1) return -1;
+
+  out_t out;
+
+  out.outfile_ctx = outfile_ctx;
+  out.binary      = user_options->binary_candidates;
+  out.err         = 0;
+
+  hc_thread_mutex_lock (outfile_ctx->mux_outfile);
+
+  out_acquire (&out);
+
+  hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
 
   #define BUF_SZ (PW_MAX / sizeof(u32))
 
@@ -343,14 +564,14 @@ int process_stdout (hashcat_ctx_t *hashcat_ctx, hc_device_param_t *device_param,
 
   out_flush (&out);
 
-  if (filename)
+  out_release (&out);
+
+  if (out.err != 0)
   {
-    hc_unlockfile (&out.fp);
+    event_log_error (hashcat_ctx, "%s: %s", (outfile_ctx->filename) ? outfile_ctx->filename : "stdout", strerror (out.err));
 
-    hc_fclose (&out.fp);
+    return -1;
   }
 
-  hc_thread_mutex_unlock (outfile_ctx->mux_outfile);
-
   return rc;
 }
@@ -342,6 +342,10 @@ int straight_ctx_init (hashcat_ctx_t *hashcat_ctx)
     }
   }
 
+  // precompile only needs the rules, the kernels do not depend on the wordlists
+
+  if (user_options->kernel_precompile == true) return 0;
+
   /**
    * wordlist based work
    */
@@ -2865,6 +2865,10 @@ void status_display_machine_readable (hashcat_ctx_t *hashcat_ctx)
     }
   }
 
+  // appended after all other fields, so parsers which expect the fields above by position keep working
+
+  printf ("TAILIDLE\t%" PRIu64 "\t", (u64) hashcat_status->tail_idle_msec_all);
+
   fwrite (EOL, strlen (EOL), 1, stdout);
 
   fflush (stdout);
@@ -2975,6 +2979,7 @@ void status_display_status_json (hashcat_ctx_t *hashcat_ctx)
   printf (" \"recovered_hashes\": [%u, %u],", hashcat_status->digests_done, hashcat_status->digests_cnt);
   printf (" \"recovered_salts\": [%u, %u],", hashcat_status->salts_done, hashcat_status->salts_cnt);
   printf (" \"rejected\": %" PRIu64 ",", hashcat_status->progress_rejected);
+  printf (" \"tail_idle_msec\": %" PRIu64 ",", (u64) hashcat_status->tail_idle_msec_all);
   printf (" \"devices\": [");
 
   if (bridge_ctx->enabled == true)
@@ -3529,6 +3534,13 @@ void status_display (hashcat_ctx_t *hashcat_ctx)
     event_log_info (hashcat_ctx,
       "Speed.#*.........: %9sH/s",
       hashcat_status->speed_sec_all);
+
+    if (hashcat_status->tail_idle_msec_all > 0)
+    {
+      event_log_info (hashcat_ctx,
+        "Tail.Idle........: %0.2f sec (devices waiting for the last chunk of a pass)",
+        hashcat_status->tail_idle_msec_all / 1000);
+    }
   }
 
   if (hashcat_status->salts_cnt > 1)
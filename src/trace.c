@@ -0,0 +1,167 @@
+/**
+ * Author......: See docs/credits.txt
+ * License.....: MIT
+ */
+
+#include "common.h"
+#include "types.h"
+#include "memory.h"
+#include "event.h"
+#include "shared.h"
+#include "thread.h"
+#include "timer.h"
+#include "trace.h"
+
+/**
+ * Chrome trace event format (JSON array), loadable in chrome://tracing and ui.perfetto.dev
+ * every device gets two rows (tid): the device thread and its host-side batch preparation
+ */
+
+static u32 trace_tid (const hc_device_param_t *device_param, const trace_lane_t lane)
+{
+  return (device_param->device_id * 2) + (u32) lane;
+}
+
+static void trace_write_event (trace_ctx_t *trace_ctx, const char *buf, const int len)
+{
+  hc_thread_mutex_lock (trace_ctx->mux_trace);
+
+  if (trace_ctx->empty == false) hc_fwrite (",\n", 2, 1, &trace_ctx->fp);
+
+  hc_fwrite (buf, (size_t) len, 1, &trace_ctx->fp);
+
+  trace_ctx->empty = false;
+
+  hc_thread_mutex_unlock (trace_ctx->mux_trace);
+}
+
+static void trace_write_thread_name (trace_ctx_t *trace_ctx, const u32 tid, const char *name, const char *suffix)
+{
+  // device names come from the driver, keep only what is safe inside a JSON string
+
+  char name_safe[HCBUFSIZ_TINY];
+
+  size_t pos = 0;
+
+  for (size_t i = 0; name[i] != 0 && pos < sizeof (name_safe) - 1; i++)
+  {
+    if (name[i] == '"')  continue;
+    if (name[i] == '\\') continue;
+    if ((u8) name[i] < 0x20) continue;
+
+    name_safe[pos++] = name[i];
+  }
+
+  name_safe[pos] = 0;
+
+  char buf[HCBUFSIZ_TINY * 2];
+
+  int len = snprintf (buf, sizeof (buf), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s%s\"}}", tid, name_safe, suffix);
+
+  trace_write_event (trace_ctx, buf, len);
+
+  len = snprintf (buf, sizeof (buf), "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", tid, tid);
+
+  trace_write_event (trace_ctx, buf, len);
+}
+
+double trace_begin (const hashcat_ctx_t *hashcat_ctx)
+{
+  const trace_ctx_t *trace_ctx = hashcat_ctx->trace_ctx;
+
+  if (trace_ctx->enabled == false) return 0;
+
+  // hc_timer_get () is in milliseconds, trace timestamps are in microseconds
+
+  return hc_timer_get (trace_ctx->timer_origin) * 1000;
+}
+
+void trace_end (hashcat_ctx_t *hashcat_ctx, const hc_device_param_t *device_param, const trace_lane_t lane, const char *name, const double ts_begin)
+{
+  trace_ctx_t *trace_ctx = hashcat_ctx->trace_ctx;
+
+  if (trace_ctx->enabled == false) return;
+
+  const double ts_end = hc_timer_get (trace_ctx->timer_origin) * 1000;
+
+  char buf[256];
+
+  const int len = snprintf (buf, sizeof (buf), "{\"name\":\"%s\",\"cat\":\"hashcat\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", name, trace_tid (device_param, lane), ts_begin, ts_end - ts_begin);
+
+  trace_write_event (trace_ctx, buf, len);
+}
+
+int trace_init (hashcat_ctx_t *hashcat_ctx)
+{
+  const user_options_t *user_options = hashcat_ctx->user_options;
+        trace_ctx_t    *trace_ctx    = hashcat_ctx->trace_ctx;
+
+  trace_ctx->enabled = false;
+
+  if (user_options->trace_file == NULL) return 0;
+
+  if (user_options->usage          > 0)    return 0;
+  if (user_options->backend_info   > 0)    return 0;
+  if (user_options->hash_info      > 0)    return 0;
+
+  if (user_options->keyspace      == true) return 0;
+  if (user_options->left          == true) return 0;
+  if (user_options->show          == true) return 0;
+  if (user_options->version       == true) return 0;
+  if (user_options->identify      == true) return 0;
+
+  trace_ctx->filename = user_options->trace_file;
+
+  if (hc_fopen (&trace_ctx->fp, trace_ctx->filename, "wb") == false)
+  {
+    event_log_error (hashcat_ctx, "%s: %s", trace_ctx->filename, strerror (errno));
+
+    return -1;
+  }
+
+  hc_fwrite ("[\n", 2, 1, &trace_ctx->fp);
+
+  hc_thread_mutex_init (trace_ctx->mux_trace);
+
+  hc_timer_set (&trace_ctx->timer_origin);
+
+  trace_ctx->enabled = true;
+  trace_ctx->empty   = true;
+
+  return 0;
+}
+
+void trace_destroy (hashcat_ctx_t *hashcat_ctx)
+{
+  const backend_ctx_t *backend_ctx = hashcat_ctx->backend_ctx;
+        trace_ctx_t   *trace_ctx   = hashcat_ctx->trace_ctx;
+
+  if (trace_ctx->enabled == false) return;
+
+  // row names go last, the device list is only known once the session ran
+
+  if (backend_ctx->devices_param != NULL)
+  {
+    for (int backend_devices_idx = 0; backend_devices_idx < backend_ctx->backend_devices_cnt; backend_devices_idx++)
+    {
+      const hc_device_param_t *device_param = &backend_ctx->devices_param[backend_devices_idx];
+
+      if (device_param->skipped == true) continue;
+
+      char name[HCBUFSIZ_TINY];
+
+      snprintf (name, sizeof (name), "Device #%u: %s", device_param->device_id + 1, (device_param->device_name != NULL) ? device_param->device_name : "");
+
+      trace_write_thread_name (trace_ctx, trace_tid (device_param, TRACE_LANE_DEVICE), name, "");
+      trace_write_thread_name (trace_ctx, trace_tid (device_param, TRACE_LANE_PREP),   name, " (prep)");
+    }
+  }
+
+  hc_fwrite ("\n]\n", 3, 1, &trace_ctx->fp);
+
+  hc_fclose (&trace_ctx->fp);
+
+  hc_thread_mutex_delete (trace_ctx->mux_trace);
+
+  memset (trace_ctx, 0, sizeof (trace_ctx_t));
+}
@@ -43,12 +43,14 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   "     --machine-readable         |      | Display the status view in a machine-readable format |",
   "     --keep-guessing            |      | Keep guessing the hash after it has been cracked     |",
   "     --self-test-disable        |      | Disable self-test functionality on startup           |",
+  "     --self-test-refresh        |      | Ignore cached self-test results and test again       |",
   "     --loopback                 |      | Add new plains to induct directory                   |",
   "     --markov-hcstat2           | File | Specify hcstat2 file to use                          | --markov-hcstat2=my.hcstat2",
   "     --markov-disable           |      | Disables markov-chains, emulates classic brute-force |",
   "     --markov-classic           |      | Enables classic markov-chains, no per-position       |",
   "     --markov-inverse           |      | Enables inverse markov-chains, no per-position       |",
   " -t, --markov-threshold         | Num  | Threshold X when to stop accepting new markov-chains | -t 50",
+  "     --mask-merge               |      | Merge consecutive compatible masks of a .hcmask file |",
   "     --metal-compiler-runtime   | Num  | Abort Metal kernel build after X seconds of runtime  | --metal-compiler-runtime=180",
   "     --runtime                  | Num  | Abort session after X seconds of runtime             | --runtime=10",
   "     --session                  | Str  | Define specific session name                         | --session=mysession",
@@ -63,6 +65,7 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   "     --wordlist-autohex-disable |      | Disable the conversion of $HEX[] from the wordlist   |",
   " -p, --separator                | Char | Separator char for hashlists and outfile             | -p :",
   "     --stdout                   |      | Do not crack a hash, instead print candidates only   |",
+  "     --binary-candidates        |      | Use u16 length + data records for stdin and --stdout |",
   "     --show                     |      | Compare hashlist with potfile; show cracked hashes   |",
   "     --left                     |      | Compare hashlist with potfile; show uncracked hashes |",
   "     --username                 |      | Enable ignoring of usernames in hashfile             |",
@@ -78,6 +81,7 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   "     --induction-dir            | Dir  | Specify the induction directory to use for loopback  | --induction=inducts",
   "     --outfile-check-dir        | Dir  | Specify the directory to monitor 3rd party outfiles  | --outfile-check-dir=x",
   "     --logfile-disable          |      | Disable the logfile                                  |",
+  "     --trace-file               | File | Write per-device pipeline spans as Chrome trace JSON | --trace-file=trace.json",
   "     --hccapx-message-pair      | Num  | Load only message pairs from hccapx matching X       | --hccapx-message-pair=2",
   "     --nonce-error-corrections  | Num  | The BF size range to replace AP's nonce last bytes   | --nonce-error-corrections=16",
   "     --keyboard-layout-mapping  | File | Keyboard layout mapping table for special hash-modes | --keyb=german.hckmap",
@@ -118,6 +122,9 @@ static const char *const USAGE_BIG_PRE_HASHMODES[] =
   " -n, --kernel-accel             | Num  | Manual workload tuning, set outerloop step size to X | -n 64",
   " -u, --kernel-loops             | Num  | Manual workload tuning, set innerloop step size to X | -u 256",
   " -T, --kernel-threads           | Num  | Manual workload tuning, set thread count to X        | -T 64",
+  "     --kernel-cache-dir         | Dir  | Directory for compiled kernels, shareable by hosts   | --kernel-cache-dir=/srv/kernels",
+  "     --kernel-precompile        |      | Build the kernels for the selected modes and quit    | --kernel-precompile -m 1400",
+  "     --autotune-refresh         |      | Ignore cached autotune results and tune again        |",
   "     --backend-vector-width     | Num  | Manually override backend vector-width to X          | --backend-vector-width=4",
   "     --spin-damp                | Num  | Use CPU for device synchronization, in percent       | --spin-damp=10",
   "     --hwmon-disable            |      | Disable temperature and fanspeed reads and triggers  |",
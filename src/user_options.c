@@ -34,6 +34,7 @@ static const struct option long_options[] =
 {
   {"advice-disable",            no_argument,       NULL, IDX_ADVICE_DISABLE},
   {"attack-mode",               required_argument, NULL, IDX_ATTACK_MODE},
+  {"autotune-refresh",          no_argument,       NULL, IDX_AUTOTUNE_REFRESH},
   {"backend-devices",           required_argument, NULL, IDX_BACKEND_DEVICES},
   {"backend-devices-virtmulti", required_argument, NULL, IDX_BACKEND_DEVICES_VIRTMULTI},
   {"backend-devices-virthost",  required_argument, NULL, IDX_BACKEND_DEVICES_VIRTHOST},
@@ -52,6 +53,7 @@ static const struct option long_options[] =
   {"benchmark-max",             required_argument, NULL, IDX_BENCHMARK_MAX},
   {"benchmark-min",             required_argument, NULL, IDX_BENCHMARK_MIN},
   {"benchmark",                 no_argument,       NULL, IDX_BENCHMARK},
+  {"binary-candidates",         no_argument,       NULL, IDX_BINARY_CANDIDATES},
   {"bitmap-max",                required_argument, NULL, IDX_BITMAP_MAX},
   {"bitmap-min",                required_argument, NULL, IDX_BITMAP_MIN},
   {"bridge-parameter1",         required_argument, NULL, IDX_BRIDGE_PARAMETER1},
@@ -99,7 +101,9 @@ static const struct option long_options[] =
   {"induction-dir",             required_argument, NULL, IDX_INDUCTION_DIR},
   {"keep-guessing",             no_argument,       NULL, IDX_KEEP_GUESSING},
   {"kernel-accel",              required_argument, NULL, IDX_KERNEL_ACCEL},
+  {"kernel-cache-dir",          required_argument, NULL, IDX_KERNEL_CACHE_DIR},
   {"kernel-loops",              required_argument, NULL, IDX_KERNEL_LOOPS},
+  {"kernel-precompile",         no_argument,       NULL, IDX_KERNEL_PRECOMPILE},
   {"kernel-threads",            required_argument, NULL, IDX_KERNEL_THREADS},
   {"keyboard-layout-mapping",   required_argument, NULL, IDX_KEYBOARD_LAYOUT_MAPPING},
   {"keyspace",                  no_argument,       NULL, IDX_KEYSPACE},
@@ -114,6 +118,7 @@ static const struct option long_options[] =
   {"markov-hcstat2",            required_argument, NULL, IDX_MARKOV_HCSTAT2},
   {"markov-inverse",            no_argument,       NULL, IDX_MARKOV_INVERSE},
   {"markov-threshold",          required_argument, NULL, IDX_MARKOV_THRESHOLD},
+  {"mask-merge",                no_argument,       NULL, IDX_MASK_MERGE},
   {"metal-compiler-runtime",    required_argument, NULL, IDX_METAL_COMPILER_RUNTIME},
   {"nonce-error-corrections",   required_argument, NULL, IDX_NONCE_ERROR_CORRECTIONS},
   {"opencl-device-types",       required_argument, NULL, IDX_OPENCL_DEVICE_TYPES},
@@ -141,6 +146,7 @@ static const struct option long_options[] =
   {"scrypt-tmto",               required_argument, NULL, IDX_SCRYPT_TMTO},
   {"segment-size",              required_argument, NULL, IDX_SEGMENT_SIZE},
   {"self-test-disable",         no_argument,       NULL, IDX_SELF_TEST_DISABLE},
+  {"self-test-refresh",         no_argument,       NULL, IDX_SELF_TEST_REFRESH},
   {"separator",                 required_argument, NULL, IDX_SEPARATOR},
   {"seperator",                 required_argument, NULL, IDX_SEPARATOR},
   {"session",                   required_argument, NULL, IDX_SESSION},
@@ -154,6 +160,7 @@ static const struct option long_options[] =
   {"status-timer",              required_argument, NULL, IDX_STATUS_TIMER},
   {"stdout",                    no_argument,       NULL, IDX_STDOUT_FLAG},
   {"stdin-timeout-abort",       required_argument, NULL, IDX_STDIN_TIMEOUT_ABORT},
+  {"trace-file",                required_argument, NULL, IDX_TRACE_FILE},
   {"truecrypt-keyfiles",        required_argument, NULL, IDX_TRUECRYPT_KEYFILES},
   {"username",                  no_argument,       NULL, IDX_USERNAME},
   {"veracrypt-keyfiles",        required_argument, NULL, IDX_VERACRYPT_KEYFILES},
@@ -194,6 +201,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->advice                    = ADVICE;
   user_options->attack_mode               = ATTACK_MODE;
   user_options->autodetect                = AUTODETECT;
+  user_options->autotune_refresh          = AUTOTUNE_REFRESH;
   user_options->backend_devices           = NULL;
   user_options->backend_devices_virtmulti = BACKEND_DEVICES_VIRTMULTI;
   user_options->backend_devices_virthost  = BACKEND_DEVICES_VIRTHOST;
@@ -210,6 +218,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->benchmark_max             = BENCHMARK_MAX;
   user_options->benchmark_min             = BENCHMARK_MIN;
   user_options->benchmark                 = BENCHMARK;
+  user_options->binary_candidates         = BINARY_CANDIDATES;
   user_options->bitmap_max                = BITMAP_MAX;
   user_options->bitmap_min                = BITMAP_MIN;
   #ifdef WITH_BRAIN
@@ -260,7 +269,9 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->induction_dir             = NULL;
   user_options->keep_guessing             = KEEP_GUESSING;
   user_options->kernel_accel              = KERNEL_ACCEL;
+  user_options->kernel_cache_dir          = NULL;
   user_options->kernel_loops              = KERNEL_LOOPS;
+  user_options->kernel_precompile         = KERNEL_PRECOMPILE;
   user_options->kernel_threads            = KERNEL_THREADS;
   user_options->keyboard_layout_mapping   = NULL;
   user_options->keyspace                  = KEYSPACE;
@@ -275,6 +286,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->markov_hcstat2            = NULL;
   user_options->markov_inverse            = MARKOV_INVERSE;
   user_options->markov_threshold          = MARKOV_THRESHOLD;
+  user_options->mask_merge                = MASK_MERGE;
   user_options->metal_compiler_runtime    = METAL_COMPILER_RUNTIME;
   user_options->nonce_error_corrections   = NONCE_ERROR_CORRECTIONS;
   user_options->opencl_device_types       = NULL;
@@ -307,6 +319,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->scrypt_tmto               = SCRYPT_TMTO;
   user_options->segment_size              = SEGMENT_SIZE;
   user_options->self_test                 = SELF_TEST;
+  user_options->self_test_refresh         = SELF_TEST_REFRESH;
   user_options->separator                 = SEPARATOR;
   user_options->session                   = PROGNAME;
   user_options->show                      = SHOW;
@@ -319,6 +332,7 @@ int user_options_init (hashcat_ctx_t *hashcat_ctx)
   user_options->status_timer              = STATUS_TIMER;
   user_options->stdin_timeout_abort       = STDIN_TIMEOUT_ABORT;
   user_options->stdout_flag               = STDOUT_FLAG;
+  user_options->trace_file                = NULL;
   user_options->truecrypt_keyfiles        = NULL;
   user_options->usage                     = USAGE;
   user_options->username                  = USERNAME;
@@ -464,18 +478,23 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_HASH_INFO:                 user_options->hash_info++;                                                 break;
       case IDX_FORCE:                     user_options->force                     = true;                            break;
       case IDX_SELF_TEST_DISABLE:         user_options->self_test                 = false;                           break;
+      case IDX_SELF_TEST_REFRESH:         user_options->self_test_refresh         = true;                            break;
       case IDX_SKIP:                      user_options->skip                      = hc_strtoull (optarg, NULL, 10);
                                           user_options->skip_chgd                 = true;                            break;
       case IDX_LIMIT:                     user_options->limit                     = hc_strtoull (optarg, NULL, 10);
                                           user_options->limit_chgd                = true;                            break;
       case IDX_KEEP_GUESSING:             user_options->keep_guessing             = true;                            break;
+      case IDX_KERNEL_CACHE_DIR:          user_options->kernel_cache_dir          = optarg;                          break;
+      case IDX_KERNEL_PRECOMPILE:         user_options->kernel_precompile         = true;                            break;
       case IDX_KEYSPACE:                  user_options->keyspace                  = true;                            break;
       case IDX_TOTAL_CANDIDATES:          user_options->total_candidates          = true;                            break;
+      case IDX_AUTOTUNE_REFRESH:          user_options->autotune_refresh          = true;                            break;
       case IDX_BENCHMARK:                 user_options->benchmark                 = true;                            break;
       case IDX_BENCHMARK_ALL:             user_options->benchmark_all             = true;                            break;
       case IDX_BENCHMARK_MAX:             user_options->benchmark_max             = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_BENCHMARK_MIN:             user_options->benchmark_min             = hc_strtoul (optarg, NULL, 10);   break;
       case IDX_STDOUT_FLAG:               user_options->stdout_flag               = true;                            break;
+      case IDX_BINARY_CANDIDATES:         user_options->binary_candidates         = true;                            break;
       case IDX_STDIN_TIMEOUT_ABORT:       user_options->stdin_timeout_abort       = hc_strtoul (optarg, NULL, 10);
                                           user_options->stdin_timeout_abort_chgd  = true;                            break;
       case IDX_IDENTIFY:                  user_options->identify                  = true;                            break;
@@ -513,6 +532,7 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_MARKOV_CLASSIC:            user_options->markov_classic            = true;                            break;
       case IDX_MARKOV_INVERSE:            user_options->markov_inverse            = true;                            break;
       case IDX_MARKOV_THRESHOLD:          user_options->markov_threshold          = hc_strtoul (optarg, NULL, 10);   break;
+      case IDX_MASK_MERGE:                user_options->mask_merge                = true;                            break;
       case IDX_MARKOV_HCSTAT2:            user_options->markov_hcstat2            = optarg;                          break;
       case IDX_OUTFILE:                   user_options->outfile                   = optarg;
                                           user_options->outfile_chgd              = true;                            break;
@@ -568,6 +588,7 @@ int user_options_getopt (hashcat_ctx_t *hashcat_ctx, int argc, char **argv)
       case IDX_NONCE_ERROR_CORRECTIONS:   user_options->nonce_error_corrections   = hc_strtoul (optarg, NULL, 10);
                                           user_options->nonce_error_corrections_chgd = true;                         break;
       case IDX_KEYBOARD_LAYOUT_MAPPING:   user_options->keyboard_layout_mapping   = optarg;                          break;
+      case IDX_TRACE_FILE:                user_options->trace_file                = optarg;                          break;
       case IDX_TRUECRYPT_KEYFILES:        user_options->truecrypt_keyfiles        = optarg;                          break;
       case IDX_VERACRYPT_KEYFILES:        user_options->veracrypt_keyfiles        = optarg;                          break;
       case IDX_VERACRYPT_PIM_START:       user_options->veracrypt_pim_start       = hc_strtoul (optarg, NULL, 10);
@@ -1349,6 +1370,44 @@ int user_options_sanity (hashcat_ctx_t *hashcat_ctx)
     }
   }
 
+  if (user_options->kernel_cache_dir != NULL)
+  {
+    if (strlen (user_options->kernel_cache_dir) == 0)
+    {
+      event_log_error (hashcat_ctx, "Invalid --kernel-cache-dir value - must not be empty.");
+
+      return -1;
+    }
+  }
+
+  if (user_options->kernel_precompile == true)
+  {
+    // precompile runs through the benchmark hash-modes and attack modes and stops after the kernels are built
+
+    if (user_options->attack_mode_chgd == true)
+    {
+      if ((user_options->attack_mode != ATTACK_MODE_STRAIGHT)
+       && (user_options->attack_mode != ATTACK_MODE_COMBI)
+       && (user_options->attack_mode != ATTACK_MODE_BF)
+       && (user_options->attack_mode != ATTACK_MODE_HYBRID1)
+       && (user_options->attack_mode != ATTACK_MODE_HYBRID2))
+      {
+        event_log_error (hashcat_ctx, "Use of --kernel-precompile is only supported with attack modes 0, 1, 3, 6 and 7.");
+
+        return -1;
+      }
+    }
+
+    if (user_options->slow_candidates == true)
+    {
+      event_log_error (hashcat_ctx, "Use of --slow-candidates (-S) is not allowed with --kernel-precompile.");
+
+      return -1;
+    }
+
+    user_options->benchmark = true;
+  }
+
   if (user_options->benchmark_all == true)
   {
     user_options->benchmark = true;
@@ -1395,7 +1454,7 @@ int user_options_sanity (hashcat_ctx_t *hashcat_ctx)
       user_options->benchmark_all = true;
     }
 
-    if (user_options->attack_mode_chgd == true)
+    if ((user_options->attack_mode_chgd == true) && (user_options->kernel_precompile == false))
     {
       event_log_error (hashcat_ctx, "Can't change --attack-mode (-a) in benchmark mode.");
 
@@ -1575,6 +1634,16 @@ int user_options_sanity (hashcat_ctx_t *hashcat_ctx)
     }
   }
 
+  if (user_options->trace_file != NULL)
+  {
+    if (strlen (user_options->trace_file) == 0)
+    {
+      event_log_error (hashcat_ctx, "Invalid --trace-file value - must not be empty.");
+
+      return -1;
+    }
+  }
+
   if (user_options->session != NULL)
   {
     if (strlen (user_options->session) == 0)
@@ -1654,6 +1723,20 @@ int user_options_sanity (hashcat_ctx_t *hashcat_ctx)
     }
   }
 
+  if (user_options->binary_candidates == true)
+  {
+    // --binary-candidates changes the format of the candidates in stdin mode and of the --stdout output
+
+    const bool stdin_mode = (user_options->attack_mode == ATTACK_MODE_STRAIGHT) && (user_options->hc_argc == ((user_options->stdout_flag == true) ? 0 : 1));
+
+    if ((user_options->stdout_flag == false) && (stdin_mode == false))
+    {
+      event_log_error (hashcat_ctx, "Use of --binary-candidates is only allowed in stdin mode (pipe) or with --stdout.");
+
+      return -1;
+    }
+  }
+
   if (user_options->backend_info > 2)
   {
     event_log_error (hashcat_ctx, "Invalid --backend-info/-I value, must have a value greater or equal to 0 and lower than 3.");
@@ -2156,7 +2239,11 @@ void user_options_preprocess (hashcat_ctx_t *hashcat_ctx)
 
   if (user_options->benchmark == true)
   {
-    user_options->attack_mode         = ATTACK_MODE_BF;
+    if ((user_options->kernel_precompile == false) || (user_options->attack_mode_chgd == false))
+    {
+      user_options->attack_mode       = ATTACK_MODE_BF;
+    }
+
     user_options->hwmon_temp_abort    = 0;
     user_options->increment           = INCREMENT_NONE;
     user_options->left                = false;
@@ -2177,7 +2264,9 @@ void user_options_preprocess (hashcat_ctx_t *hashcat_ctx)
     user_options->brain_client        = false;
     #endif
 
-    if (user_options->workload_profile_chgd == false)
+    // precompile builds the same kernels as a regular session would, so it keeps -O and -w as given
+
+    if ((user_options->workload_profile_chgd == false) && (user_options->kernel_precompile == false))
     {
       user_options->optimized_kernel  = true;
       user_options->workload_profile  = 3;
@@ -3660,6 +3749,7 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_string (user_options->encoding_from);
   logfile_top_string (user_options->encoding_to);
   logfile_top_string (user_options->induction_dir);
+  logfile_top_string (user_options->kernel_cache_dir);
   logfile_top_string (user_options->keyboard_layout_mapping);
   logfile_top_string (user_options->markov_hcstat2);
   logfile_top_string (user_options->backend_devices);
@@ -3674,6 +3764,7 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_string (user_options->rule_buf_r);
   logfile_top_string (user_options->session);
   logfile_top_string (user_options->separator);
+  logfile_top_string (user_options->trace_file);
   logfile_top_string (user_options->truecrypt_keyfiles);
   logfile_top_string (user_options->veracrypt_keyfiles);
   #ifdef WITH_BRAIN
@@ -3682,10 +3773,12 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint64 (user_options->limit);
   logfile_top_uint64 (user_options->skip);
   logfile_top_uint   (user_options->attack_mode);
+  logfile_top_uint   (user_options->autotune_refresh);
   logfile_top_uint   (user_options->backend_devices_virtmulti);
   logfile_top_uint   (user_options->backend_devices_virthost);
   logfile_top_uint   (user_options->backend_devices_keepfree);
   logfile_top_uint   (user_options->benchmark);
+  logfile_top_uint   (user_options->binary_candidates);
   logfile_top_uint   (user_options->benchmark_all);
   logfile_top_uint   (user_options->benchmark_max);
   logfile_top_uint   (user_options->benchmark_min);
@@ -3709,6 +3802,7 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint   (user_options->keep_guessing);
   logfile_top_uint   (user_options->kernel_accel);
   logfile_top_uint   (user_options->kernel_loops);
+  logfile_top_uint   (user_options->kernel_precompile);
   logfile_top_uint   (user_options->kernel_threads);
   logfile_top_uint   (user_options->keyspace);
   logfile_top_uint   (user_options->total_candidates);
@@ -3720,6 +3814,7 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint   (user_options->markov);
   logfile_top_uint   (user_options->markov_inverse);
   logfile_top_uint   (user_options->markov_threshold);
+  logfile_top_uint   (user_options->mask_merge);
   logfile_top_uint   (user_options->metal_compiler_runtime);
   logfile_top_uint   (user_options->multiply_accel);
   logfile_top_uint   (user_options->backend_info);
@@ -3747,6 +3842,7 @@ void user_options_logger (hashcat_ctx_t *hashcat_ctx)
   logfile_top_uint   (user_options->scrypt_tmto);
   logfile_top_uint   (user_options->segment_size);
   logfile_top_uint   (user_options->self_test);
+  logfile_top_uint   (user_options->self_test_refresh);
   logfile_top_uint   (user_options->slow_candidates);
   logfile_top_uint   (user_options->show);
   logfile_top_uint   (user_options->speed_only);
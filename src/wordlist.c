@@ -431,11 +431,11 @@ void pw_add_zerocopy (hc_device_param_t *device_param, u8 *out_buf, const int pw
   }
 }
 
-void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len)
+void pw_add_to (hc_device_param_t *device_param, u32 *pws_comp, pw_idx_t *pws_idx, u64 *pws_cnt, const u8 *pw_buf, const int pw_len)
 {
-  if (device_param->pws_cnt < device_param->kernel_power)
+  if (*pws_cnt < device_param->kernel_power)
   {
-    pw_idx_t *pw_idx = device_param->pws_idx + device_param->pws_cnt;
+    pw_idx_t *pw_idx = pws_idx + *pws_cnt;
 
     const u32 pw_len4 = (pw_len + 3) & ~3; // round up to multiple of 4
 
@@ -444,7 +444,7 @@ void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len
     pw_idx->cnt = pw_len4_cnt;
     pw_idx->len = pw_len;
 
-    u8 *dst = (u8 *) (device_param->pws_comp + pw_idx->off);
+    u8 *dst = (u8 *) (pws_comp + pw_idx->off);
 
     memcpy (dst, pw_buf, pw_len);
 
@@ -456,7 +456,7 @@ void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len
 
     pw_idx_next->off = pw_idx->off + pw_idx->cnt;
 
-    device_param->pws_cnt++;
+    *pws_cnt += 1;
   }
   else
   {
@@ -466,6 +466,11 @@ void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len
   }
 }
 
+void pw_add (hc_device_param_t *device_param, const u8 *pw_buf, const int pw_len)
+{
+  pw_add_to (device_param, device_param->pws_comp, device_param->pws_idx, &device_param->pws_cnt, pw_buf, pw_len);
+}
+
 int count_words (hashcat_ctx_t *hashcat_ctx, HCFILE *fp, const char *dictfile, u64 *result)
 {
   combinator_ctx_t     *combinator_ctx     = hashcat_ctx->combinator_ctx;